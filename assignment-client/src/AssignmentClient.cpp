@@ -26,6 +26,8 @@
 #include <LogHandler.h>
 #include <LogUtils.h>
 #include <LimitedNodeList.h>
+#include <HTTPConnection.h>
+#include <Metrics.h>
 #include <NodeList.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
@@ -43,13 +45,14 @@ const long long ASSIGNMENT_REQUEST_INTERVAL_MSECS = 1 * 1000;
 
 AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QString assignmentPool,
                                    quint16 listenPort, QUuid walletUUID, QString assignmentServerHostname,
-                                   quint16 assignmentServerPort, quint16 assignmentMonitorPort) :
+                                   quint16 assignmentServerPort, quint16 assignmentMonitorPort, quint16 metricsPort) :
     _assignmentServerHostname(DEFAULT_ASSIGNMENT_SERVER_HOSTNAME)
 {
     LogUtils::init();
 
-    DependencyManager::set<tracing::Tracer>();
+    DependencyManager::set<tracing::Tracer>()->startSamplingFromEnvironment();
     DependencyManager::set<StatTracker>();
+    DependencyManager::set<MetricsRegistry>();
     DependencyManager::set<AccountManager>();
     DependencyManager::set<ResourceRequestObserver>();
 
@@ -117,6 +120,11 @@ AssignmentClient::AssignmentClient(Assignment::Type requestAssignmentType, QStri
         // Hook up a timer to send this child's status to the Monitor once per second
         setUpStatusToMonitor();
     }
+
+    if (metricsPort > 0) {
+        qCDebug(assignment_client) << "Serving metrics on HTTP port" << metricsPort;
+        _metricsHTTPManager.reset(new HTTPManager(QHostAddress::AnyIPv4, metricsPort, "", this));
+    }
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::CreateAssignment, this, "handleCreateAssignmentPacket");
     packetReceiver.registerListener(PacketType::StopNode, this, "handleStopNodePacket");
@@ -150,6 +158,7 @@ AssignmentClient::~AssignmentClient() {
 void AssignmentClient::aboutToQuit() {
     crash::annotations::setShutdownState(true);
     stopAssignmentClient();
+    DependencyManager::get<tracing::Tracer>()->finishSampling();
 }
 
 void AssignmentClient::setUpStatusToMonitor() {
@@ -176,6 +185,22 @@ void AssignmentClient::sendStatusPacketToACM() {
     nodeList->sendPacket(std::move(statusPacket), _assignmentClientMonitorSocket);
 }
 
+bool AssignmentClient::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
+    if (url.path() != "/metrics") {
+        connection->respond(HTTPConnection::StatusCode404);
+        return true;
+    }
+
+    QString assignmentType = _currentAssignment ? _currentAssignment->getTypeName() : "unassigned";
+    QByteArray labels = "assignment=\"" + metrics::escapeLabelValue(assignmentType) + "\"";
+    auto snapshot = DependencyManager::get<MetricsRegistry>()->snapshot();
+
+    const char PROMETHEUS_TEXT_CONTENT_TYPE[] = "text/plain; version=0.0.4";
+    connection->respond(HTTPConnection::StatusCode200, metrics::toPrometheusText({ { labels, snapshot } }),
+                        PROMETHEUS_TEXT_CONTENT_TYPE);
+    return true;
+}
+
 void AssignmentClient::sendAssignmentRequest() {
     if (!_currentAssignment && !_isAssigned) {
         crash::annotations::setShutdownState(false);
@@ -27,6 +27,7 @@ const QString ASSIGNMENT_MIN_FORKS_OPTION = "min";
 const QString ASSIGNMENT_MAX_FORKS_OPTION = "max";
 const QString ASSIGNMENT_CLIENT_MONITOR_PORT_OPTION = "monitor-port";
 const QString ASSIGNMENT_HTTP_STATUS_PORT = "http-status-port";
+const QString ASSIGNMENT_METRICS_PORT_OPTION = "metrics-port";
 const QString ASSIGNMENT_LOG_DIRECTORY = "log-directory";
 
 class AssignmentClientApp : public QCoreApplication {
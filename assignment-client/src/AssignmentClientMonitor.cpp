@@ -41,7 +41,8 @@ AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmen
                                                  const unsigned int maxAssignmentClientForks,
                                                  Assignment::Type requestAssignmentType, QString assignmentPool,
                                                  quint16 listenPort, quint16 childMinListenPort, QUuid walletUUID, QString assignmentServerHostname,
-                                                 quint16 assignmentServerPort, quint16 httpStatusServerPort, QString logDirectory) :
+                                                 quint16 assignmentServerPort, quint16 httpStatusServerPort,
+                                                 quint16 childMinMetricsPort, QString logDirectory) :
     _httpManager(QHostAddress::LocalHost, httpStatusServerPort, "", this),
     _numAssignmentClientForks(numAssignmentClientForks),
     _minAssignmentClientForks(minAssignmentClientForks),
@@ -51,7 +52,8 @@ AssignmentClientMonitor::AssignmentClientMonitor(const unsigned int numAssignmen
     _walletUUID(walletUUID),
     _assignmentServerHostname(assignmentServerHostname),
     _assignmentServerPort(assignmentServerPort),
-    _childMinListenPort(childMinListenPort)
+    _childMinListenPort(childMinListenPort),
+    _childMinMetricsPort(childMinMetricsPort)
 {
     qDebug() << "_requestAssignmentType =" << _requestAssignmentType;
 
@@ -100,13 +102,17 @@ void AssignmentClientMonitor::simultaneousWaitOnChildren(int waitMsecs) {
     }
 }
 
-void AssignmentClientMonitor::childProcessFinished(qint64 pid, quint16 listenPort, int exitCode, QProcess::ExitStatus exitStatus) {
+void AssignmentClientMonitor::childProcessFinished(qint64 pid, quint16 listenPort, quint16 metricsPort,
+                                                   int exitCode, QProcess::ExitStatus exitStatus) {
     auto message = "Child process " + QString::number(pid) + " on port " + QString::number(listenPort) +
                    "has %1 with exit code " + QString::number(exitCode) + ".";
 
     if (listenPort) {
         _childListenPorts.remove(listenPort);
     }
+    if (metricsPort) {
+        _childMetricsPorts.remove(metricsPort);
+    }
 
     if (_childProcesses.remove(pid)) {
         message.append(" Removed from internal map.");
@@ -158,22 +164,9 @@ void AssignmentClientMonitor::aboutToQuit() {
 void AssignmentClientMonitor::spawnChildClient() {
     QProcess* assignmentClient = new QProcess(this);
 
-    quint16 listenPort = 0;
-    // allocate a port
-
-    if (_childMinListenPort) {
-        for (listenPort = _childMinListenPort; _childListenPorts.contains(listenPort); listenPort++) {
-            if (_maxAssignmentClientForks &&
-                (listenPort >= _maxAssignmentClientForks + _childMinListenPort)) {
-                listenPort = 0;
-                qDebug() << "Insufficient listen ports";
-                break;
-            }
-        }
-    }
-    if (listenPort) {
-        _childListenPorts.insert(listenPort);
-    }
+    // allocate the ports
+    quint16 listenPort = allocateChildPort(_childMinListenPort, _childListenPorts);
+    quint16 metricsPort = allocateChildPort(_childMinMetricsPort, _childMetricsPorts);
 
     // unparse the parts of the command-line that the child cares about
     QStringList _childArguments;
@@ -203,6 +196,11 @@ void AssignmentClientMonitor::spawnChildClient() {
         _childArguments.append(QString::number(listenPort));
     }
 
+    if (metricsPort) {
+        _childArguments.append("--" + ASSIGNMENT_METRICS_PORT_OPTION);
+        _childArguments.append(QString::number(metricsPort));
+    }
+
     // tell children which assignment monitor port to use
     // for now they simply talk to us on localhost
     _childArguments.append("--" + ASSIGNMENT_CLIENT_MONITOR_PORT_OPTION);
@@ -274,8 +272,8 @@ void AssignmentClientMonitor::spawnChildClient() {
         auto pid = assignmentClient->processId();
         // make sure we hear that this process has finished when it does
         connect(assignmentClient, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-                this, [this, listenPort, pid](int exitCode, QProcess::ExitStatus exitStatus) {
-                    childProcessFinished(pid, listenPort, exitCode, exitStatus);
+                this, [this, listenPort, metricsPort, pid](int exitCode, QProcess::ExitStatus exitStatus) {
+                    childProcessFinished(pid, listenPort, metricsPort, exitCode, exitStatus);
             });
 
         qDebug() << "Spawned a child client with PID" << assignmentClient->processId();
@@ -284,6 +282,26 @@ void AssignmentClientMonitor::spawnChildClient() {
     }
 }
 
+quint16 AssignmentClientMonitor::allocateChildPort(quint16 minPort, QSet<quint16>& ports) const {
+    quint16 port = 0;
+
+    if (minPort) {
+        for (port = minPort; ports.contains(port); port++) {
+            if (_maxAssignmentClientForks &&
+                (port >= _maxAssignmentClientForks + minPort)) {
+                port = 0;
+                qDebug() << "Insufficient ports from" << minPort;
+                break;
+            }
+        }
+    }
+    if (port) {
+        ports.insert(port);
+    }
+
+    return port;
+}
+
 void AssignmentClientMonitor::checkSpares() {
     auto nodeList = DependencyManager::get<NodeList>();
     QUuid aSpareId = "";
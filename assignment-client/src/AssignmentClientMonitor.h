@@ -39,13 +39,13 @@ public:
                             const unsigned int maxAssignmentClientForks, Assignment::Type requestAssignmentType,
                             QString assignmentPool, quint16 listenPort, quint16 childMinListenPort, QUuid walletUUID,
                             QString assignmentServerHostname, quint16 assignmentServerPort, quint16 httpStatusServerPort,
-                            QString logDirectory);
+                            quint16 childMinMetricsPort, QString logDirectory);
     ~AssignmentClientMonitor();
 
     void stopChildProcesses();
 private slots:
     void checkSpares();
-    void childProcessFinished(qint64 pid, quint16 port, int exitCode, QProcess::ExitStatus exitStatus);
+    void childProcessFinished(qint64 pid, quint16 port, quint16 metricsPort, int exitCode, QProcess::ExitStatus exitStatus);
     void handleChildStatusPacket(QSharedPointer<ReceivedMessage> message);
 
     bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
@@ -55,6 +55,7 @@ public slots:
 
 private:
     void spawnChildClient();
+    quint16 allocateChildPort(quint16 minPort, QSet<quint16>& ports) const;
     void simultaneousWaitOnChildren(int waitMsecs);
     void adjustOSResources(unsigned int numForks) const;
 
@@ -79,6 +80,9 @@ private:
     quint16 _childMinListenPort;
     QSet<quint16> _childListenPorts;
 
+    quint16 _childMinMetricsPort;
+    QSet<quint16> _childMetricsPorts;
+
     bool _wantsChildFileLogging { false };
 };
 
@@ -59,7 +59,15 @@ vector<AudioMixer::ZoneSettings> AudioMixer::_zoneSettings;
 vector<AudioMixer::ReverbSettings> AudioMixer::_zoneReverbSettings;
 
 AudioMixer::AudioMixer(ReceivedMessage& message) :
-    ThreadedAssignment(message)
+    ThreadedAssignment(message),
+    _frameUsecsMetric(DependencyManager::get<MetricsRegistry>()->histogram("audio_mixer_frame_usecs",
+        "Time to process the packets of a frame and mix it for every listener")),
+    _mixesMetric(DependencyManager::get<MetricsRegistry>()->counter("audio_mixer_mixes_total",
+        "Streams mixed into the mix of a listener")),
+    _listenersMetric(DependencyManager::get<MetricsRegistry>()->gauge("audio_mixer_listeners",
+        "Listeners mixed for in the last frame")),
+    _throttlingRatioMetric(DependencyManager::get<MetricsRegistry>()->gauge("audio_mixer_throttling_ratio",
+        "Ratio of the streams left out of the mixes to keep up with the frame rate"))
 {
 
     // Always clear settings first
@@ -326,6 +334,8 @@ void AudioMixer::sendStatsPacket() {
     mixStats["1_hrtf_renders"] = (int)(_stats.hrtfRenders / (float)_numStatFrames);
     mixStats["1_hrtf_resets"] = (int)(_stats.hrtfResets / (float)_numStatFrames);
     mixStats["1_hrtf_updates"] = (int)(_stats.hrtfUpdates / (float)_numStatFrames);
+    mixStats["1_ambient_bed_mixes"] = (int)(_stats.ambientBedMixes / (float)_numStatFrames);
+    mixStats["1_ambient_bed_renders"] = (int)(_stats.ambientBedRenders / (float)_numStatFrames);
 
     mixStats["2_skipped_streams"] = (int)(_stats.skipped / (float)_numStatFrames);
     mixStats["2_inactive_streams"] = (int)(_stats.inactive / (float)_numStatFrames);
@@ -453,6 +463,11 @@ void AudioMixer::start() {
             QCoreApplication::processEvents();
         }
 
+        // pre-sum the stationary injectors of each zone, now that their frames are popped
+        nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
+            _workerSharedData.ambientBeds.prepare(cbegin, cend);
+        });
+
         int numToRetain = -1;
         assert(_throttlingRatio >= 0.0f && _throttlingRatio <= 1.0f);
         if (_throttlingRatio > EPSILON) {
@@ -465,10 +480,17 @@ void AudioMixer::start() {
         });
 
         // gather stats
+        int numListeners = 0;
         _slavePool.each([&](AudioMixerSlave& slave) {
+            _mixesMetric.increment(slave.stats.totalMixes);
+            numListeners += slave.stats.sumListeners;
             _stats.accumulate(slave.stats);
             slave.stats.reset();
         });
+        _listenersMetric.set(numListeners);
+        _throttlingRatioMetric.set(_throttlingRatio);
+        _frameUsecsMetric.record(std::chrono::duration_cast<std::chrono::microseconds>(
+            p_high_resolution_clock::now() - _startFrameTimestamp).count());
 
         ++frame;
         ++_numStatFrames;
@@ -549,6 +571,7 @@ void AudioMixer::clearDomainSettings() {
     _numStaticJitterFrames = DISABLE_STATIC_JITTER_FRAMES;
     _attenuationPerDoublingInDistance = DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE;
     _noiseMutingThreshold = DEFAULT_NOISE_MUTING_THRESHOLD;
+    _workerSharedData.ambientBeds.setEnabled(false);
     _codecPreferenceOrder.clear();
     _audioZones.clear();
     _zoneSettings.clear();
@@ -684,6 +707,12 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             }
         }
 
+        const QString AMBIENT_BEDS = "ambient_beds";
+        if (audioEnvGroupObject[AMBIENT_BEDS].isBool()) {
+            _workerSharedData.ambientBeds.setEnabled(audioEnvGroupObject[AMBIENT_BEDS].toBool());
+            qCDebug(audio) << "Ambient beds" << (_workerSharedData.ambientBeds.isEnabled() ? "enabled" : "disabled");
+        }
+
         const QString AUDIO_ZONES = "zones";
         if (audioEnvGroupObject[AUDIO_ZONES].isObject()) {
             const QJsonObject& zones = audioEnvGroupObject[AUDIO_ZONES].toObject();
@@ -15,6 +15,7 @@
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
+#include <Metrics.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 
@@ -107,6 +108,12 @@ private:
 
     AudioMixerSlavePool _slavePool { _workerSharedData };
 
+    // metrics
+    metrics::Histogram& _frameUsecsMetric;
+    metrics::Counter& _mixesMetric;
+    metrics::Gauge& _listenersMetric;
+    metrics::Gauge& _throttlingRatioMetric;
+
     class Timer {
     public:
         class Timing{
@@ -0,0 +1,159 @@
+//
+//  AudioMixerAmbientBeds.cpp
+//  assignment-client/src/audio
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerAmbientBeds.h"
+
+#include <AudioConstants.h>
+#include <InjectedAudioStream.h>
+#include <NumericalConstants.h>
+
+#include "AudioMixer.h"
+#include "AudioMixerClientData.h"
+#include "AudioMixerSlave.h"
+#include "AvatarAudioStream.h"
+
+// the first audio zone that contains a position, as for reverb
+static int findZone(const glm::vec3& position) {
+    auto& audioZones = AudioMixer::getAudioZones();
+    for (size_t i = 0; i < audioZones.size(); i++) {
+        if (audioZones[i].area.contains(position)) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+template <class Container>
+static bool contains(const Container& cont, typename Container::value_type value) {
+    return std::find(cont.cbegin(), cont.cend(), value) != cont.cend();
+}
+
+void AudioMixerAmbientBeds::prepare(ConstIter begin, ConstIter end) {
+    auto& audioZones = AudioMixer::getAudioZones();
+
+    if (!_isEnabled || audioZones.empty()) {
+        _beds.clear();
+        _streamStates.clear();
+        return;
+    }
+
+    if (_beds.size() != audioZones.size()) {
+        _beds.clear();
+        _beds.resize(audioZones.size());
+    }
+    for (size_t i = 0; i < _beds.size(); i++) {
+        Bed& bed = _beds[i];
+        bed.bed.setCenter(audioZones[i].area.calcCenter());
+        bed.bed.clear();
+        bed.streams.clear();
+        bed.sourceNodeIDs.clear();
+        bed.sourceLocalIDs.clear();
+    }
+
+    // only the streams of this frame are kept
+    decltype(_streamStates) streamStates;
+    streamStates.reserve(_streamStates.size());
+
+    int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+
+    std::for_each(begin, end, [&](const SharedNodePointer& node) {
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (!nodeData) {
+            return;
+        }
+
+        for (auto& stream : nodeData->getAudioStreams()) {
+            // stereo injectors skip the HRTF, and boxed ones are heard differently by each listener
+            if (stream->getType() != PositionalAudioStream::Injector || stream->isStereo() || stream->isIgnoreBoxEnabled()) {
+                continue;
+            }
+
+            // count the frames it has not moved
+            const glm::vec3& position = stream->getPosition();
+            auto it = _streamStates.find(stream.get());
+            bool hasMoved = (it == _streamStates.end() || it->second.position != position);
+            int stationaryFrames = hasMoved ? 0 : it->second.stationaryFrames + 1;
+            streamStates[stream.get()] = { position, stationaryFrames };
+
+            if (stationaryFrames < STATIONARY_FRAMES) {
+                continue;
+            }
+
+            int zone = findZone(position);
+            if (zone < 0) {
+                continue;
+            }
+
+            // join the bed of its zone
+            Bed& bed = _beds[zone];
+            bed.streams.push_back(stream.get());
+            if (!contains(bed.sourceNodeIDs, node->getUUID())) {
+                bed.sourceNodeIDs.push_back(node->getUUID());
+                bed.sourceLocalIDs.push_back(node->getLocalID());
+            }
+
+            if (stream->lastPopSucceeded() && stream->getLastPopOutputLoudness() > 0.0f) {
+
+                // attenuated as if heard from the center of the zone
+                const glm::vec3& center = bed.bed.getCenter();
+                float distance = glm::max(glm::length(position - center), EPSILON);
+                float attenuation = AudioMixerSlave::findAttenuationPerDoublingInDistance(position, center);
+                float gain = static_cast<const InjectedAudioStream*>(stream.get())->getAttenuationRatio();
+                gain = AudioMixerSlave::applyDistanceAttenuation(gain, attenuation, distance);
+
+                AudioRingBuffer::ConstIterator streamPopOutput = stream->getLastPopOutput();
+                streamPopOutput.readSamples(samples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+                bed.bed.addSource(samples, position, gain);
+            }
+        }
+    });
+
+    _streamStates.swap(streamStates);
+
+    for (Bed& bed : _beds) {
+        std::sort(bed.streams.begin(), bed.streams.end());
+        bed.bed.finish();
+    }
+}
+
+const AudioMixerAmbientBeds::Bed* AudioMixerAmbientBeds::findBed(const Node& listener,
+                                                                  const AvatarAudioStream& listenerStream,
+                                                                  const AudioMixerClientData& listenerData,
+                                                                  int& zone) const {
+    zone = -1;
+    if (_beds.empty()) {
+        return nullptr;
+    }
+
+    zone = findZone(listenerStream.getPosition());
+    if (zone < 0 || _beds[zone].streams.empty()) {
+        return nullptr;
+    }
+
+    // the listener must hear every stream of the bed
+    if (!listenerData.getSoloedNodes().empty() || listenerStream.isIgnoreBoxEnabled()) {
+        return nullptr;
+    }
+
+    const Bed& bed = _beds[zone];
+    for (size_t i = 0; i < bed.sourceNodeIDs.size(); i++) {
+        // its own injectors are only heard on request
+        if (bed.sourceLocalIDs[i] == listener.getLocalID()) {
+            return nullptr;
+        }
+        if (contains(listener.getIgnoredNodeIDs(), bed.sourceNodeIDs[i]) ||
+            contains(listenerData.getIgnoringNodeIDs(), bed.sourceNodeIDs[i])) {
+            return nullptr;
+        }
+    }
+
+    return &bed;
+}
@@ -0,0 +1,71 @@
+//
+//  AudioMixerAmbientBeds.h
+//  assignment-client/src/audio
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerAmbientBeds_h
+#define hifi_AudioMixerAmbientBeds_h
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <AudioAmbientBed.h>
+#include <NodeList.h>
+#include <PositionalAudioStream.h>
+
+class AudioMixerClientData;
+class AvatarAudioStream;
+
+//
+// Injectors that have stopped moving, pre-summed into an AudioAmbientBed for each audio zone, once a frame.
+//
+// A listener in a zone hears the stationary injectors of the zone through its bed, rendered with a handful of
+// HRTFs in place of one for each injector, as long as it would hear every one of them: the listener is not
+// soloing, ignoring or ignored by the node of an injector, or using an ignore box.  Other listeners mix the
+// injectors one by one, as before.
+//
+class AudioMixerAmbientBeds {
+public:
+    using ConstIter = NodeList::const_iterator;
+
+    static const int STATIONARY_FRAMES = 100;   // that an injector has not moved, before it joins a bed
+
+    struct Bed {
+        AudioAmbientBed bed;
+        std::vector<const PositionalAudioStream*> streams;  // sorted
+        std::vector<QUuid> sourceNodeIDs;                   // of the nodes of the streams
+        std::vector<Node::LocalID> sourceLocalIDs;
+
+        bool covers(const PositionalAudioStream* stream) const {
+            return std::binary_search(streams.cbegin(), streams.cend(), stream);
+        }
+    };
+
+    void setEnabled(bool enabled) { _isEnabled = enabled; }
+    bool isEnabled() const { return _isEnabled; }
+
+    // build the beds of a frame, once the streams have popped it, and before it is mixed
+    void prepare(ConstIter begin, ConstIter end);
+
+    // return the bed that the listener hears, if any
+    const Bed* findBed(const Node& listener, const AvatarAudioStream& listenerStream,
+                       const AudioMixerClientData& listenerData, int& zone) const;
+
+private:
+    struct StreamState {
+        glm::vec3 position;
+        int stationaryFrames;
+    };
+
+    std::unordered_map<const PositionalAudioStream*, StreamState> _streamStates;
+    std::vector<Bed> _beds;     // of each audio zone
+    bool _isEnabled { false };
+};
+
+#endif // hifi_AudioMixerAmbientBeds_h
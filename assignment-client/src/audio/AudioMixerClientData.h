@@ -19,6 +19,7 @@
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
+#include <AudioAmbientBed.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
 #include <UUIDHasher.h>
@@ -89,6 +90,10 @@ public:
 
     AudioLimiter audioLimiter;
 
+    // the HRTF state of the ambient bed of the zone the listener is in
+    AudioAmbientBed::Listener ambientBedListener;
+    int ambientBedZone { -1 };
+
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
     void cleanupCodec();
     void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
@@ -120,6 +125,7 @@ public:
         PositionalAudioStream* positionalStream;
         bool ignoredByListener { false };
         bool ignoringListener { false };
+        bool isInAmbientBed { false };
 
         MixableStream(NodeIDStreamID nodeIDStreamID, PositionalAudioStream* positionalStream) :
             nodeStreamID(nodeIDStreamID), hrtf(new AudioHRTF), positionalStream(positionalStream) {};
@@ -48,6 +48,8 @@ void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data)
 void sendMutePacket(const SharedNodePointer& node, AudioMixerClientData&);
 void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
 
+static const int HRTF_DATASET_INDEX = 1;
+
 // mix helpers
 inline float approximateGain(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd);
 inline float computeGain(float masterAvatarGain, float masterInjectorGain, const AvatarAudioStream& listeningNodeStream,
@@ -55,6 +57,17 @@ inline float computeGain(float masterAvatarGain, float masterInjectorGain, const
 inline float computeAzimuth(const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         const glm::vec3& relativePosition);
 
+AudioMixerSlave::AudioMixerSlave(SharedData& sharedData) :
+    _sharedData(sharedData),
+    _listenerMixUsecs(DependencyManager::get<MetricsRegistry>()->histogram("audio_mixer_listener_mix_usecs",
+        "Time to mix, encode and send the audio of a listener")),
+    _mixedPacketsSent(DependencyManager::get<MetricsRegistry>()->counter("audio_mixer_mixed_packets_total",
+        "Mixed audio packets sent to listeners")),
+    _silentPacketsSent(DependencyManager::get<MetricsRegistry>()->counter("audio_mixer_silent_packets_total",
+        "Silent audio packets sent to listeners"))
+{
+}
+
 void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
     if (data) {
@@ -95,6 +108,7 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
     // send audio packets, if necessary
     if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
         ++stats.sumListeners;
+        auto mixStart = p_high_resolution_clock::now();
 
         // mix the audio
         bool mixHasAudio = prepareMix(node);
@@ -112,11 +126,16 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
             }
 
             sendMixPacket(node, *data, encodedBuffer);
+            _mixedPacketsSent.increment();
         } else {
             ++stats.sumListenersSilent;
             sendSilentPacket(node, *data);
+            _silentPacketsSent.increment();
         }
 
+        auto mixTime = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now() - mixStart);
+        _listenerMixUsecs.record(mixTime.count());
+
         // send environment packet
         sendEnvironmentPacket(node, *data);
 
@@ -320,6 +339,17 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
 
     addStreams(*listener, *listenerData);
 
+    // find the ambient bed the listener hears, and start its HRTFs over in a new zone
+    int ambientBedZone;
+    _ambientBed = _sharedData.ambientBeds.findBed(*listener, *listenerAudioStream, *listenerData, ambientBedZone);
+    if (!_ambientBed) {
+        ambientBedZone = -1;
+    }
+    if (ambientBedZone != listenerData->ambientBedZone) {
+        listenerData->ambientBedListener.reset();
+        listenerData->ambientBedZone = ambientBedZone;
+    }
+
     // Process skipped streams
     erase_if(streams.skipped, [&](MixableStream& stream) {
         if (shouldBeRemoved(stream, _sharedData)) {
@@ -460,6 +490,14 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         });
     }
 
+    if (_ambientBed) {
+        stats.ambientBedRenders += _ambientBed->bed.render(listenerData->ambientBedListener,
+                                                           listenerAudioStream->getPosition(),
+                                                           listenerAudioStream->getOrientation(), HRTF_DATASET_INDEX,
+                                                           listenerData->getMasterInjectorGain(), _mixSamples);
+        _ambientBed = nullptr;
+    }
+
     stats.skipped += (int)streams.skipped.size();
     stats.inactive += (int)streams.inactive.size();
     stats.active += (int)streams.active.size();
@@ -494,6 +532,17 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
                                 float masterAvatarGain,
                                 float masterInjectorGain,
                                 bool isSoloing) {
+    // stationary injectors in the ambient bed of the listener are heard through it
+    if (_ambientBed && _ambientBed->covers(mixableStream.positionalStream)) {
+        if (!mixableStream.isInAmbientBed) {
+            resetHRTFState(mixableStream);
+            mixableStream.isInAmbientBed = true;
+        }
+        ++stats.ambientBedMixes;
+        return;
+    }
+    mixableStream.isInAmbientBed = false;
+
     ++stats.totalMixes;
 
     auto streamToAdd = mixableStream.positionalStream;
@@ -510,8 +559,6 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
                                                    relativePosition, distance));
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
 
-    const int HRTF_DATASET_INDEX = 1;
-
     if (!streamToAdd->lastPopSucceeded()) {
         bool forceSilentBlock = true;
 
@@ -758,19 +805,31 @@ float computeGain(float masterAvatarGain,
         gain *= masterAvatarGain;
     }
 
+    float attenuationPerDoublingInDistance =
+        AudioMixerSlave::findAttenuationPerDoublingInDistance(streamToAdd.getPosition(), listeningNodeStream.getPosition());
+
+    return AudioMixerSlave::applyDistanceAttenuation(gain, attenuationPerDoublingInDistance, distance);
+}
+
+float AudioMixerSlave::findAttenuationPerDoublingInDistance(const glm::vec3& sourcePosition,
+                                                            const glm::vec3& listenerPosition) {
     auto& audioZones = AudioMixer::getAudioZones();
     auto& zoneSettings = AudioMixer::getZoneSettings();
 
     // find distance attenuation coefficient
     float attenuationPerDoublingInDistance = AudioMixer::getAttenuationPerDoublingInDistance();
     for (const auto& settings : zoneSettings) {
-        if (audioZones[settings.source].area.contains(streamToAdd.getPosition()) &&
-            audioZones[settings.listener].area.contains(listeningNodeStream.getPosition())) {
+        if (audioZones[settings.source].area.contains(sourcePosition) &&
+            audioZones[settings.listener].area.contains(listenerPosition)) {
             attenuationPerDoublingInDistance = settings.coefficient;
             break;
         }
     }
 
+    return attenuationPerDoublingInDistance;
+}
+
+float AudioMixerSlave::applyDistanceAttenuation(float gain, float attenuationPerDoublingInDistance, float distance) {
     if (attenuationPerDoublingInDistance < 0.0f) {
         // translate a negative zone setting to distance limit
         const float MIN_DISTANCE_LIMIT = ATTN_DISTANCE_REF + 1.0f;  // silent after 1m
@@ -17,11 +17,13 @@
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioRingBuffer.h>
+#include <Metrics.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
 #include <NodeList.h>
 #include <PositionalAudioStream.h>
 
+#include "AudioMixerAmbientBeds.h"
 #include "AudioMixerClientData.h"
 #include "AudioMixerStats.h"
 
@@ -36,9 +38,10 @@ public:
         AudioMixerClientData::ConcurrentAddedStreams addedStreams;
         std::vector<Node::LocalID> removedNodes;
         std::vector<NodeIDStreamID> removedStreams;
+        AudioMixerAmbientBeds ambientBeds;
     };
 
-    AudioMixerSlave(SharedData& sharedData) : _sharedData(sharedData) {};
+    AudioMixerSlave(SharedData& sharedData);
 
     // process packets for a given node (requires no configuration)
     void processPackets(const SharedNodePointer& node);
@@ -52,6 +55,10 @@ public:
 
     AudioMixerStats stats;
 
+    // distance attenuation, for a source heard from a listener position
+    static float findAttenuationPerDoublingInDistance(const glm::vec3& sourcePosition, const glm::vec3& listenerPosition);
+    static float applyDistanceAttenuation(float gain, float attenuationPerDoublingInDistance, float distance);
+
 private:
     // create mix, returns true if mix has audio
     bool prepareMix(const SharedNodePointer& listener);
@@ -79,6 +86,14 @@ private:
     int _numToRetain { -1 };
 
     SharedData& _sharedData;
+
+    // the ambient bed that the current listener hears
+    const AudioMixerAmbientBeds::Bed* _ambientBed { nullptr };
+
+    // metrics, recorded by every slave
+    metrics::Histogram& _listenerMixUsecs;
+    metrics::Counter& _mixedPacketsSent;
+    metrics::Counter& _silentPacketsSent;
 };
 
 #endif // hifi_AudioMixerSlave_h
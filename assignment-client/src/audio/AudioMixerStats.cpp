@@ -22,6 +22,9 @@ void AudioMixerStats::reset() {
     hrtfResets = 0;
     hrtfUpdates = 0;
 
+    ambientBedMixes = 0;
+    ambientBedRenders = 0;
+
     manualStereoMixes = 0;
     manualEchoMixes = 0;
 
@@ -52,6 +55,9 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     hrtfResets += otherStats.hrtfResets;
     hrtfUpdates += otherStats.hrtfUpdates;
 
+    ambientBedMixes += otherStats.ambientBedMixes;
+    ambientBedRenders += otherStats.ambientBedRenders;
+
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
 
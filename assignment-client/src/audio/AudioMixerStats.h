@@ -27,6 +27,9 @@ struct AudioMixerStats {
     int hrtfResets { 0 };
     int hrtfUpdates { 0 };
 
+    int ambientBedMixes { 0 };
+    int ambientBedRenders { 0 };
+
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
@@ -40,9 +40,9 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
 
         // if isStereo value has changed, restart the ring buffer with new frame size
         if (isStereo != _isStereo) {
-            _ringBuffer.resizeForFrameSize(isStereo
-                                           ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
-                                           : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+            resizeForFrameSize(isStereo ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
+                                        : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL,
+                               isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
             // restart the codec
             if (_codec) {
                 QMutexLocker lock(&_decoderMutex);
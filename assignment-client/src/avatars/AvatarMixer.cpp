@@ -813,12 +813,21 @@ void AvatarMixer::sendStatsPacket() {
 
 
     AvatarMixerSlaveStats aggregateStats;
+    QJsonObject slavesObject;
 
     // gather stats
+    int slaveIndex = 0;
     _slavePool.each([&](AvatarMixerSlave& slave) {
         AvatarMixerSlaveStats stats;
         slave.harvestStats(stats);
         aggregateStats += stats;
+
+        // show how evenly the work of a frame was spread
+        QJsonObject slaveObject;
+        slaveObject["1_busy"] = TIGHT_LOOP_STAT_UINT64(stats.busyElapsedTime);
+        slaveObject["2_idle"] = TIGHT_LOOP_STAT_UINT64(stats.idleElapsedTime);
+        slaveObject["3_nodesStolen"] = TIGHT_LOOP_STAT(stats.nodesStolen);
+        slavesObject[QString("slave_%1").arg(slaveIndex++)] = slaveObject;
     });
 
     QJsonObject slavesAggregatObject;
@@ -839,14 +848,21 @@ void AvatarMixer::sendStatsPacket() {
     slavesAggregatObject["sent_6_averageIdentityBytes"] = TIGHT_LOOP_STAT(aggregateStats.numIdentityBytesSent);
     slavesAggregatObject["sent_7_averageHeroAvatars"] = TIGHT_LOOP_STAT(aggregateStats.numHeroesIncluded);
 
+    float averageHeldBackByRegion = averageNodes ? aggregateStats.numOthersHeldBackByRegion / averageNodes : 0.0f;
+    slavesAggregatObject["sent_8_averageHeldBackByRegion"] = TIGHT_LOOP_STAT(averageHeldBackByRegion);
+
     slavesAggregatObject["timing_1_processIncomingPackets"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.processIncomingPacketsElapsedTime);
     slavesAggregatObject["timing_2_ignoreCalculation"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.ignoreCalculationElapsedTime);
     slavesAggregatObject["timing_3_toByteArray"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.toByteArrayElapsedTime);
     slavesAggregatObject["timing_4_avatarDataPacking"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.avatarDataPackingElapsedTime);
     slavesAggregatObject["timing_5_packetSending"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.packetSendingElapsedTime);
     slavesAggregatObject["timing_6_jobElapsedTime"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.jobElapsedTime);
+    slavesAggregatObject["timing_7_busy"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.busyElapsedTime);
+    slavesAggregatObject["timing_8_idle"] = TIGHT_LOOP_STAT_UINT64(aggregateStats.idleElapsedTime);
+    slavesAggregatObject["jobs_1_nodesStolen"] = TIGHT_LOOP_STAT(aggregateStats.nodesStolen);
 
     statsObject["slaves_aggregate (per frame)"] = slavesAggregatObject;
+    statsObject["slaves (per frame)"] = slavesObject;
 
     _handleViewFrustumPacketElapsedTime = 0;
     _handleAvatarIdentityPacketElapsedTime = 0;
@@ -1029,6 +1045,12 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
         }
     }
 
+    {
+        static const QString REGION_THROTTLE_KEY = "region_throttle";
+        _slaveSharedData.regionThrottleEnabled = avatarMixerGroupObject[REGION_THROTTLE_KEY].toBool(true);
+        qCDebug(avatars) << "Avatar mixer region throttle is" << (_slaveSharedData.regionThrottleEnabled ? "on" : "off");
+    }
+
     const QString AVATARS_SETTINGS_KEY = "avatars";
 
     static const QString MIN_HEIGHT_OPTION = "min_avatar_height";
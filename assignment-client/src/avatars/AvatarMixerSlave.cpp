@@ -329,6 +329,7 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
     const AvatarData& avatar = destinationNodeData->getAvatar();
     glm::vec3 destinationPosition = avatar.getClientGlobalPosition();
+    uint64_t frameStart = usecTimestampNow();
 
     // reset the internal state for correct random number distribution
     distribution.reset();
@@ -464,12 +465,28 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
         _stats.ignoreCalculationElapsedTime += (endIgnoreCalculation - startIgnoreCalculation);
 
         if (sendAvatar) {
-            // sort this one for later
             const MixerAvatar* avatarNodeData = sourceAvatarNodeData->getConstAvatarData();
             auto lastEncodeTime = destinationNodeData->getLastOtherAvatarEncodeTime(sourceAvatarNode->getLocalID());
 
-            avatarPriorityQueues[avatarNodeData->getHasPriority() ? kHero : kNonhero].push(
-                SortableAvatar(avatarNodeData, sourceAvatarNode, lastEncodeTime));
+            // avatars far from this listener can wait for the interval of their region before being sent again,
+            // except heroes, and everyone while the PAL shows them
+            if (_sharedData->regionThrottleEnabled && !PALIsOpen && !avatarNodeData->getHasPriority()) {
+                glm::vec3 sourceBoxScale = avatarNodeData->getGlobalBoundingBox().getScale();
+                float sourceRadius = 0.5f * glm::max(sourceBoxScale.x, glm::max(sourceBoxScale.y, sourceBoxScale.z));
+                workload::Sphere sourceSphere(avatarNodeData->getClientGlobalPosition(), sourceRadius);
+                const auto& regionThrottle = _sharedData->regionThrottle;
+                uint8_t region = regionThrottle.evalRegion(destinationPosition, sourceSphere);
+                if (!regionThrottle.isDue(region, lastEncodeTime, frameStart)) {
+                    ++_stats.numOthersHeldBackByRegion;
+                    sendAvatar = false;
+                }
+            }
+
+            if (sendAvatar) {
+                // sort this one for later
+                avatarPriorityQueues[avatarNodeData->getHasPriority() ? kHero : kNonhero].push(
+                    SortableAvatar(avatarNodeData, sourceAvatarNode, lastEncodeTime));
+            }
         }
         
         // If Node A's PAL WAS open but is no longer open, AND
@@ -571,16 +588,16 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
 
             do {
                 auto startSerialize = chrono::high_resolution_clock::now();
-                QByteArray bytes = sourceAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
-                    sendStatus, dropFaceTracking, distanceAdjust, destinationPosition,
+                int numBytes = sourceAvatar->writeToBuffer(_avatarDataBuffer, detail, lastEncodeForOther,
+                    lastSentJointsForOther, sendStatus, dropFaceTracking, distanceAdjust, destinationPosition,
                     &lastSentJointsForOther, avatarSpaceAvailable);
                 auto endSerialize = chrono::high_resolution_clock::now();
                 _stats.toByteArrayElapsedTime +=
                     (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
 
-                avatarPacket->write(bytes);
-                avatarSpaceAvailable -= bytes.size();
-                numAvatarDataBytes += bytes.size();
+                avatarPacket->write(_avatarDataBuffer.constData(), numBytes);
+                avatarSpaceAvailable -= numBytes;
+                numAvatarDataBytes += numBytes;
                 if (!sendStatus || avatarSpaceAvailable < (int)AvatarDataPacket::MIN_BULK_PACKET_SIZE) {
                     // Weren't able to fit everything.
                     nodeList->sendPacket(std::move(avatarPacket), *destinationNode);
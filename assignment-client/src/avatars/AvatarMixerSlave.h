@@ -13,6 +13,7 @@
 #define hifi_AvatarMixerSlave_h
 
 #include <NodeList.h>
+#include <workload/RegionThrottle.h>
 
 class AvatarMixerClientData;
 
@@ -33,6 +34,7 @@ public:
     int numOthersIncluded { 0 };
     int overBudgetAvatars { 0 };
     int numHeroesIncluded { 0 };
+    int numOthersHeldBackByRegion { 0 };
 
     quint64 ignoreCalculationElapsedTime { 0 };
     quint64 avatarDataPackingElapsedTime { 0 };
@@ -40,6 +42,11 @@ public:
     quint64 toByteArrayElapsedTime { 0 };
     quint64 jobElapsedTime { 0 };
 
+    // time on the jobs of the pool, working or waiting for the other slaves to finish
+    quint64 busyElapsedTime { 0 };
+    quint64 idleElapsedTime { 0 };
+    int nodesStolen { 0 };
+
     void reset() {
         // receiving job stats
         nodesProcessed = 0;
@@ -59,12 +66,17 @@ public:
         numOthersIncluded = 0;
         overBudgetAvatars = 0;
         numHeroesIncluded = 0;
+        numOthersHeldBackByRegion = 0;
 
         ignoreCalculationElapsedTime = 0;
         avatarDataPackingElapsedTime = 0;
         packetSendingElapsedTime = 0;
         toByteArrayElapsedTime = 0;
         jobElapsedTime = 0;
+
+        busyElapsedTime = 0;
+        idleElapsedTime = 0;
+        nodesStolen = 0;
     }
 
     AvatarMixerSlaveStats& operator+=(const AvatarMixerSlaveStats& rhs) {
@@ -83,12 +95,17 @@ public:
         numOthersIncluded += rhs.numOthersIncluded;
         overBudgetAvatars += rhs.overBudgetAvatars;
         numHeroesIncluded += rhs.numHeroesIncluded;
+        numOthersHeldBackByRegion += rhs.numOthersHeldBackByRegion;
 
         ignoreCalculationElapsedTime += rhs.ignoreCalculationElapsedTime;
         avatarDataPackingElapsedTime += rhs.avatarDataPackingElapsedTime;
         packetSendingElapsedTime += rhs.packetSendingElapsedTime;
         toByteArrayElapsedTime += rhs.toByteArrayElapsedTime;
         jobElapsedTime += rhs.jobElapsedTime;
+
+        busyElapsedTime += rhs.busyElapsedTime;
+        idleElapsedTime += rhs.idleElapsedTime;
+        nodesStolen += rhs.nodesStolen;
         return *this;
     }
 };
@@ -100,6 +117,9 @@ struct SlaveSharedData {
     QStringList skeletonURLWhitelist;
     QUrl skeletonReplacementURL;
     EntityTreePointer entityTree;
+    // avatars in R3 or R4 of a listener are sent to it at the intervals of the region throttle
+    workload::RegionThrottle regionThrottle;
+    bool regionThrottleEnabled { true };
 };
 
 class AvatarMixerSlave {
@@ -118,6 +138,13 @@ public:
 
     void harvestStats(AvatarMixerSlaveStats& stats);
 
+    // record a job of the pool
+    void recordJobTimes(quint64 busyTime, quint64 idleTime, int numNodesStolen) {
+        _stats.busyElapsedTime += busyTime;
+        _stats.idleElapsedTime += idleTime;
+        _stats.nodesStolen += numNodesStolen;
+    }
+
 private:
     int sendIdentityPacket(NLPacketList& packet, const AvatarMixerClientData* nodeData, const Node& destinationNode);
     int sendReplicatedIdentityPacket(const Node& agentNode, const AvatarMixerClientData* nodeData, const Node& destinationNode);
@@ -143,6 +170,9 @@ private:
     float _throttlingRatio { 0.0f };
     float _avatarHeroFraction { 0.4f };
 
+    // the avatar data of each other avatar is serialized into this, rather than into a new array for each listener
+    QByteArray _avatarDataBuffer;
+
     AvatarMixerSlaveStats _stats;
     SlaveSharedData* _sharedData;
 };
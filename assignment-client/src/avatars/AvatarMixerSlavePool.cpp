@@ -14,15 +14,27 @@
 #include <assert.h>
 #include <algorithm>
 
+#include <SharedUtil.h>
+
 void AvatarMixerSlaveThread::run() {
     while (true) {
         wait();
 
-        // iterate over all available nodes
-        SharedNodePointer node;
-        while (try_pop(node)) {
-            (this->*_function)(node);
+        // iterate over the nodes of our range, then over those left in the others
+        auto start = usecTimestampNow();
+        int numNodesStolen = 0;
+        int begin, end;
+        bool isStolen;
+        while (claim(begin, end, isStolen)) {
+            for (int i = begin; i < end; ++i) {
+                (this->*_function)(*(_nodes + i));
+            }
+            if (isStolen) {
+                numNodesStolen += end - begin;
+            }
         }
+        _busyTime = usecTimestampNow() - start;
+        _numNodesStolen = numNodesStolen;
 
         bool stopping = _stop;
         notify(stopping);
@@ -45,6 +57,7 @@ void AvatarMixerSlaveThread::wait() {
         _pool._configure(*this);
     }
     _function = _pool._function;
+    _nodes = _pool._begin;
 }
 
 void AvatarMixerSlaveThread::notify(bool stopping) {
@@ -59,8 +72,8 @@ void AvatarMixerSlaveThread::notify(bool stopping) {
     _pool._poolCondition.notify_one();
 }
 
-bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node) {
-    return _pool._queue.try_pop(node);
+bool AvatarMixerSlaveThread::claim(int& begin, int& end, bool& isStolen) {
+    return _pool._ranges.claim(_index, begin, end, isStolen);
 }
 
 void AvatarMixerSlavePool::processIncomingPackets(ConstIter begin, ConstIter end) {
@@ -86,15 +99,15 @@ void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end) {
     _begin = begin;
     _end = end;
 
-    // fill the queue
-    std::for_each(_begin, _end, [&](const SharedNodePointer& node) {
-        _queue.push(node);
-    });
+    // split the nodes between the slaves
+    _ranges.reset((int)(_end - _begin), _numThreads);
 
+    quint64 start;
     {
         Lock lock(_mutex);
 
         // run
+        start = usecTimestampNow();
         _numStarted = _numFinished = 0;
         _slaveCondition.notify_all();
 
@@ -107,7 +120,12 @@ void AvatarMixerSlavePool::run(ConstIter begin, ConstIter end) {
         assert(_numStarted == _numThreads);
     }
 
-    assert(_queue.empty());
+    // a slave is idle for the rest of the job, waking up or waiting on the others
+    quint64 jobTime = usecTimestampNow() - start;
+    for (auto& slave : _slaves) {
+        quint64 busyTime = std::min(slave->_busyTime, jobTime);
+        slave->recordJobTimes(busyTime, jobTime - busyTime, slave->_numNodesStolen);
+    }
 }
 
 
@@ -160,7 +178,7 @@ void AvatarMixerSlavePool::resize(int numThreads) {
     if (numThreads > _numThreads) {
         // start new slaves
         for (int i = 0; i < numThreads - _numThreads; ++i) {
-            auto slave = new AvatarMixerSlaveThread(*this, _slaveSharedData);
+            auto slave = new AvatarMixerSlaveThread(*this, _slaveSharedData, (int)_slaves.size());
             slave->start();
             _slaves.emplace_back(slave);
         }
@@ -175,6 +193,7 @@ void AvatarMixerSlavePool::resize(int numThreads) {
         }
 
         // ...cycle them until they do stop...
+        _ranges.reset(0, _numThreads);
         _numStopped = 0;
         while (_numStopped != (_numThreads - numThreads)) {
             _numStarted = _numFinished = _numStopped;
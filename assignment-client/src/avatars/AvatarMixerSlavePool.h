@@ -18,8 +18,8 @@
 
 #include <QThread>
 
-#include <TBBHelpers.h>
 #include <NodeList.h>
+#include <WorkStealingRanges.h>
 #include <shared/QtHelpers.h>
 
 #include "AvatarMixerSlave.h"
@@ -34,8 +34,8 @@ class AvatarMixerSlaveThread : public QThread, public AvatarMixerSlave {
     using Lock = std::unique_lock<Mutex>;
 
 public:
-    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool, SlaveSharedData* slaveSharedData) :
-        AvatarMixerSlave(slaveSharedData), _pool(pool) {};
+    AvatarMixerSlaveThread(AvatarMixerSlavePool& pool, SlaveSharedData* slaveSharedData, int index) :
+        AvatarMixerSlave(slaveSharedData), _pool(pool), _index(index) {};
 
     void run() override final;
 
@@ -44,17 +44,22 @@ private:
 
     void wait();
     void notify(bool stopping);
-    bool try_pop(SharedNodePointer& node);
+    bool claim(int& begin, int& end, bool& isStolen);
 
     AvatarMixerSlavePool& _pool;
+    const int _index;   // of its range of the nodes
+    ConstIter _nodes;
     void (AvatarMixerSlave::*_function)(const SharedNodePointer& node) { nullptr };
     bool _stop { false };
+
+    // of the last job, read by the pool once the job is done
+    quint64 _busyTime { 0 };
+    int _numNodesStolen { 0 };
 };
 
 // Slave pool for avatar mixers
 //   AvatarMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
 class AvatarMixerSlavePool {
-    using Queue = tbb::concurrent_queue<SharedNodePointer>;
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
     using ConditionVariable = std::condition_variable;
@@ -92,7 +97,7 @@ private:
 
     friend void AvatarMixerSlaveThread::wait();
     friend void AvatarMixerSlaveThread::notify(bool stopping);
-    friend bool AvatarMixerSlaveThread::try_pop(SharedNodePointer& node);
+    friend bool AvatarMixerSlaveThread::claim(int& begin, int& end, bool& isStolen);
 
     // synchronization state
     Mutex _mutex;
@@ -110,7 +115,7 @@ private:
     int _numStopped { 0 }; // guarded by _mutex
 
     // frame state
-    Queue _queue;
+    WorkStealingRanges _ranges;     // of the nodes, for each slave
     ConstIter _begin;
     ConstIter _end;
 
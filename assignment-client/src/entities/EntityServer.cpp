@@ -70,6 +70,10 @@ EntityServer::~EntityServer() {
         _pruneDeletedEntitiesTimer->stop();
         _pruneDeletedEntitiesTimer->deleteLater();
     }
+    if (_updateAgentPositionsTimer) {
+        _updateAgentPositionsTimer->stop();
+        _updateAgentPositionsTimer->deleteLater();
+    }
 
     EntityTreePointer tree = std::static_pointer_cast<EntityTree>(_tree);
     tree->removeNewlyCreatedHook(this);
@@ -121,6 +125,11 @@ void EntityServer::beforeRun() {
     const int PRUNE_DELETED_MODELS_INTERVAL_MSECS = 1 * 1000; // once every second
     _pruneDeletedEntitiesTimer->start(PRUNE_DELETED_MODELS_INTERVAL_MSECS);
 
+    _updateAgentPositionsTimer = new QTimer();
+    connect(_updateAgentPositionsTimer, &QTimer::timeout, this, &EntityServer::updateAgentPositions);
+    const int UPDATE_AGENT_POSITIONS_INTERVAL_MSECS = 100; // agents do not cross a region in that time
+    _updateAgentPositionsTimer->start(UPDATE_AGENT_POSITIONS_INTERVAL_MSECS);
+
     DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
     connect(&domainHandler, &DomainHandler::settingsReceiveFail, this, &EntityServer::domainSettingsRequestFailed);
 }
@@ -306,6 +315,23 @@ void EntityServer::pruneDeletedEntities() {
     }
 }
 
+void EntityServer::updateAgentPositions() {
+    if (!_entitySimulation || !_entitySimulation->isRegionThrottleEnabled()) {
+        return;
+    }
+    // the regions of the entities are relative to wherever the agents are looking from
+    std::vector<glm::vec3> agentPositions;
+    DependencyManager::get<NodeList>()->eachNode([&agentPositions](const SharedNodePointer& node) {
+        if (node->getType() == NodeType::Agent && node->getLinkedData()) {
+            EntityNodeData* nodeData = static_cast<EntityNodeData*>(node->getLinkedData());
+            for (const auto& view : nodeData->getConicalViews()) {
+                agentPositions.push_back(view.getPosition());
+            }
+        }
+    });
+    _entitySimulation->setAgentPositions(std::move(agentPositions));
+}
+
 void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectionObject) {
     bool wantEditLogging = false;
     readOptionBool(QString("wantEditLogging"), settingsSectionObject, wantEditLogging);
@@ -339,6 +365,13 @@ void EntityServer::readAdditionalConfiguration(const QJsonObject& settingsSectio
     tree->setWantEditLogging(wantEditLogging);
     tree->setWantTerseEditLogging(wantTerseEditLogging);
 
+    bool regionThrottle;
+    if (!readOptionBool(QString("regionThrottle"), settingsSectionObject, regionThrottle)) {
+        regionThrottle = true;
+    }
+    qDebug("regionThrottle=%s", debug::valueOf(regionThrottle));
+    _entitySimulation->setRegionThrottleEnabled(regionThrottle);
+
     QString entityScriptSourceWhitelist;
     if (readOptionString("entityScriptSourceWhitelist", settingsSectionObject, entityScriptSourceWhitelist)) {
         tree->setEntityScriptSourceWhitelist(entityScriptSourceWhitelist);
@@ -414,6 +447,15 @@ QString EntityServer::serverSubclassStats() {
     statsString += QString().sprintf("       EntityItem size... %ld bytes\r\n", sizeof(EntityItem));
     statsString += "\r\n\r\n";
 
+    statsString += "<b>Entity Server Simulation Statistics</b>\r\n";
+    statsString += QString("           Region throttle... %1\r\n")
+        .arg(_entitySimulation->isRegionThrottleEnabled() ? "enabled" : "disabled");
+    statsString += QString("           Kinematic steps... %1\r\n")
+        .arg(locale.toString((qulonglong)_entitySimulation->getNumKinematicSteps()));
+    statsString += QString("Kinematic steps held back... %1\r\n")
+        .arg(locale.toString((qulonglong)_entitySimulation->getNumKinematicStepsHeldBack()));
+    statsString += "\r\n\r\n";
+
     statsString += "<b>Entity Server Sending to Viewer Statistics</b>\r\n";
     statsString += "----- Viewer Node ID -----------------    ----- Entity ID ----------------------    "
                    "---------- Last Sent To ----------    ---------- Last Edited -----------\r\n";
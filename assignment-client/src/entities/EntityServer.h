@@ -63,6 +63,7 @@ public slots:
     virtual void nodeAdded(SharedNodePointer node) override;
     virtual void nodeKilled(SharedNodePointer node) override;
     void pruneDeletedEntities();
+    void updateAgentPositions();
     void entityFilterAdded(EntityItemID id, bool success);
 
 protected:
@@ -76,6 +77,7 @@ private slots:
 private:
     SimpleEntitySimulationPointer _entitySimulation;
     QTimer* _pruneDeletedEntitiesTimer = nullptr;
+    QTimer* _updateAgentPositionsTimer = nullptr;
 
     QReadWriteLock _viewerSendingStatsLock;
     QMap<QUuid, QMap<QUuid, ViewerSendingStats>> _viewerSendingStats;
@@ -17,6 +17,13 @@ macro(TARGET_BULLET)
         list(APPEND BULLET_LIBRARIES ${LIB_DIR}/libBulletSoftBody.a)
     else()
         find_package(Bullet REQUIRED)
+        # the vcpkg port is built with BULLET2_MULTITHREADING, so everything that sees the Bullet headers must agree on
+        # BT_THREADSAFE: it is defined once, on a target that carries it to each user of Bullet and to whatever links them
+        if (NOT TARGET hifi::Bullet)
+            add_library(hifi::Bullet INTERFACE IMPORTED GLOBAL)
+            set_target_properties(hifi::Bullet PROPERTIES INTERFACE_COMPILE_DEFINITIONS BT_THREADSAFE=1)
+        endif()
+        target_link_libraries(${TARGET_NAME} hifi::Bullet)
    endif()
     # perform the system include hack for OS X to ignore warnings
     if (APPLE)
@@ -321,6 +321,9 @@ void DomainGatekeeper::updateNodePermissions() {
         }
     });
 
+    // the permissions of any node may have changed, each node gets the full list on its next check in
+    _server->_nodeDirectory.invalidate();
+
     foreach (auto node, nodesToKill) {
         emit killNode(node);
     }
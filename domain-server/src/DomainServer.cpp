@@ -170,9 +170,15 @@ DomainServer::DomainServer(int argc, char* argv[]) :
 
     PathUtils::removeTemporaryApplicationDirs();
 
-    DependencyManager::set<tracing::Tracer>();
+    DependencyManager::set<tracing::Tracer>()->startSamplingFromEnvironment();
     DependencyManager::set<StatTracker>();
 
+    auto metricsRegistry = DependencyManager::set<MetricsRegistry>();
+    _domainListsSent = &metricsRegistry->counter("domain_server_domain_lists_total", "DomainLists sent to nodes");
+    _fullDomainListsSent = &metricsRegistry->counter("domain_server_full_domain_lists_total",
+                                                     "DomainLists sent with every node rather than with the changes");
+    _domainListNodes = &metricsRegistry->histogram("domain_server_domain_list_nodes", "Nodes listed per DomainList");
+
     LogUtils::init();
 
     LogHandler::getInstance().moveToThread(thread());
@@ -436,6 +442,7 @@ DomainServer::~DomainServer() {
 
 void DomainServer::aboutToQuit() {
     crash::annotations::setShutdownState(true);
+    DependencyManager::get<tracing::Tracer>()->finishSampling();
 }
 
 void DomainServer::queuedQuit(QString quitMessage, int exitCode) {
@@ -765,6 +772,7 @@ void DomainServer::setupNodeListAndAssignments() {
     packetReceiver.registerListener(PacketType::DomainListRequest, this, "processListRequestPacket");
     packetReceiver.registerListener(PacketType::DomainServerPathQuery, this, "processPathQueryPacket");
     packetReceiver.registerListener(PacketType::NodeJsonStats, this, "processNodeJSONStatsPacket");
+    packetReceiver.registerListener(PacketType::NodeMetrics, this, "processNodeMetricsPacket");
     packetReceiver.registerListener(PacketType::DomainDisconnectRequest, this, "processNodeDisconnectRequestPacket");
     packetReceiver.registerListener(PacketType::AvatarZonePresence, this, "processAvatarZonePresencePacket");
 
@@ -1072,8 +1080,12 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, message->getSenderSockAddr(), false);
 
     // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr
+        || sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+        sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+        sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+        _nodeDirectory.nodeChanged(sendingNode->getUUID());
+    }
 
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
 
@@ -1091,7 +1103,15 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     }
 
     // update the NodeInterestSet in case there have been any changes
-    nodeData->setNodeInterestSet(safeInterestSet);
+    if (safeInterestSet != nodeData->getNodeInterestSet()) {
+        nodeData->setNodeInterestSet(safeInterestSet);
+
+        // the lists this node got so far were for other types of nodes, it needs the full list again
+        nodeData->setMinimumDomainListVersion(_nodeDirectory.newVersion());
+    }
+
+    // the node gets what changed since the last list it got in full
+    nodeData->setAcknowledgedDomainListVersion(nodeRequestData.domainListVersion);
 
     // update the connecting hostname in case it has changed
     nodeData->setPlaceName(nodeRequestData.placeName);
@@ -1177,11 +1197,56 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode, quint64 reques
         newNode->setIsReplicated(true);
     }
 
-    // send out this node to our other connected nodes
+    // the other nodes get this node on their next check in, but send it out to them right away
+    _nodeDirectory.nodeChanged(newNode->getUUID());
     broadcastNewNode(newNode);
 }
 
 void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 requestPacketReceiveTime, const HifiSockAddr &senderSockAddr, bool newConnection) {
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
+    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+
+    // gather the other nodes first, the extended header says how many there are
+    std::vector<SharedNodePointer> listedNodes;
+
+    // a node that was never sent any node can't acknowledge a version
+    NodeDirectory::Version listVersion = NodeDirectory::NO_VERSION;
+
+    // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+    if (nodeData->isAuthenticated()) {
+        listVersion = _nodeDirectory.getVersion();
+
+        if (nodeInterestSet.size() > 0) {
+            auto isListed = [this, &node](const SharedNodePointer& otherNode) {
+                // don't send avatar nodes to other avatars, that will come from avatar mixer
+                return otherNode && otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode);
+            };
+
+            NodeDirectory::Version acknowledgedVersion = nodeData->getAcknowledgedDomainListVersion();
+            if (!newConnection && acknowledgedVersion >= nodeData->getMinimumDomainListVersion()
+                && _nodeDirectory.hasChangesSince(acknowledgedVersion)) {
+                // this node already has a list, send it what changed since
+                _nodeDirectory.forEachChangeSince(acknowledgedVersion, [&](const QUuid& otherNodeUUID) {
+                    SharedNodePointer otherNode = limitedNodeList->nodeWithUUID(otherNodeUUID);
+                    if (isListed(otherNode)) {
+                        listedNodes.push_back(otherNode);
+                    }
+                });
+            } else {
+                // if this authenticated node has any interest types, send back those nodes as well
+                limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
+                    if (isListed(otherNode)) {
+                        listedNodes.push_back(otherNode);
+                    }
+                });
+                _fullDomainListsSent->increment();
+            }
+        }
+    }
+
     const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID +
         NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID + 4;
 
@@ -1189,8 +1254,6 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 r
     // this data is at the beginning of each of the domain list packets
     QByteArray extendedHeader(NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES, 0);
     QDataStream extendedHeaderStream(&extendedHeader, QIODevice::WriteOnly);
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
 
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << limitedNodeList->getSessionLocalID();
@@ -1202,60 +1265,40 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, quint64 r
     extendedHeaderStream << quint64(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
     extendedHeaderStream << quint64(duration_cast<microseconds>(p_high_resolution_clock::now().time_since_epoch()).count()) - requestPacketReceiveTime;
     extendedHeaderStream << newConnection;
+    extendedHeaderStream << listVersion;
+    extendedHeaderStream << _domainListNumber++;
+    extendedHeaderStream << quint32(listedNodes.size());
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
-    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+    for (const auto& otherNode : listedNodes) {
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
 
-    if (nodeInterestSet.size() > 0) {
+        domainListStream << *otherNode.data();
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([this, node, &domainListPackets, &domainListStream](const SharedNodePointer& otherNode) {
-                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+        // pack the secret that these two nodes will use to communicate with each other
+        domainListStream << connectionSecretForNodes(node, otherNode);
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
-
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
-
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
-                }
-            });
-        }
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
     }
 
     // send an empty list to the node, in case there were no other nodes
     domainListPackets->closeCurrentPacket(true);
 
+    _domainListsSent->increment();
+    _domainListNodes->record(listedNodes.size());
+
     // write the PacketList to this node
     limitedNodeList->sendPacketList(std::move(domainListPackets), *node);
 }
 
 QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
-    DomainServerNodeData* nodeAData = static_cast<DomainServerNodeData*>(nodeA->getLinkedData());
-    DomainServerNodeData* nodeBData = static_cast<DomainServerNodeData*>(nodeB->getLinkedData());
-
-    if (nodeAData && nodeBData) {
-        QUuid& secretUUID = nodeAData->getSessionSecretHash()[nodeB->getUUID()];
-
-        if (secretUUID.isNull()) {
-            // generate a new secret UUID these two nodes can use
-            secretUUID = QUuid::createUuid();
-
-            // set it on the other Node's sessionSecretHash
-            static_cast<DomainServerNodeData*>(nodeBData)->getSessionSecretHash().insert(nodeA->getUUID(), secretUUID);
-        }
-
-        return secretUUID;
+    if (nodeA->getLinkedData() && nodeB->getLinkedData()) {
+        return _nodeDirectory.getConnectionSecret(nodeA->getLocalID(), nodeB->getLocalID());
     }
 
     return QUuid();
@@ -1864,6 +1907,13 @@ void DomainServer::processNodeJSONStatsPacket(QSharedPointer<ReceivedMessage> pa
     }
 }
 
+void DomainServer::processNodeMetricsPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode) {
+    auto nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
+    if (nodeData) {
+        nodeData->setMetricsSnapshot(packetList->getMessage());
+    }
+}
+
 QJsonObject DomainServer::jsonForSocket(const HifiSockAddr& socket) {
     QJsonObject socketJSON;
 
@@ -1965,6 +2015,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
     const QString URI_ASSIGNMENT = "/assignment";
     const QString URI_NODES = "/nodes";
+    const QString URI_METRICS = "/metrics";
     const QString URI_SETTINGS = "/settings";
     const QString URI_CONTENT_UPLOAD = "/content/upload";
     const QString URI_RESTART = "/restart";
@@ -2148,6 +2199,30 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             connection->respond(HTTPConnection::StatusCode200, transactionsDocument.toJson(), qPrintable(JSON_MIME_TYPE));
 
             return true;
+        } else if (url.path() == URI_METRICS) {
+            // the metrics of the domain-server and of every node that sent some, for Prometheus to scrape
+            std::vector<metrics::LabeledSnapshot> snapshots;
+            snapshots.emplace_back("assignment=\"domain-server\"", DependencyManager::get<MetricsRegistry>()->snapshot());
+
+            nodeList->eachNode([&snapshots](const SharedNodePointer& node) {
+                auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+                if (!nodeData || nodeData->getMetricsSnapshot().isEmpty()) {
+                    return;
+                }
+
+                metrics::Snapshot snapshot;
+                if (snapshot.fromByteArray(nodeData->getMetricsSnapshot())) {
+                    QString assignmentType = Assignment::typeToString(Assignment::typeForNodeType(node->getType()));
+                    QByteArray labels = "assignment=\"" + metrics::escapeLabelValue(assignmentType) + "\",node=\""
+                        + metrics::escapeLabelValue(uuidStringWithoutCurlyBraces(node->getUUID())) + "\"";
+                    snapshots.emplace_back(labels, std::move(snapshot));
+                }
+            });
+
+            const char PROMETHEUS_TEXT_CONTENT_TYPE[] = "text/plain; version=0.0.4";
+            connection->respond(HTTPConnection::StatusCode200, metrics::toPrometheusText(snapshots),
+                                PROMETHEUS_TEXT_CONTENT_TYPE);
+            return true;
         } else if (url.path() == QString("%1.json").arg(URI_NODES)) {
             // setup the JSON
             QJsonObject rootJSON;
@@ -3065,7 +3140,10 @@ void DomainServer::updateReplicatedNodes() {
                 qDebug() << "Setting node to replicated:"
                     << otherNode->getPermissions().getVerifiedUserName() << otherNode->getUUID();
             }
-            otherNode->setIsReplicated(shouldReplicate);
+            if (isReplicated != shouldReplicate) {
+                otherNode->setIsReplicated(shouldReplicate);
+                _nodeDirectory.nodeChanged(otherNode->getUUID());
+            }
         }
     );
 }
@@ -3110,13 +3188,8 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
             }
         }
 
-        // cleanup the connection secrets that we set up for this node (on the other nodes)
-        foreach (const QUuid& otherNodeSessionUUID, nodeData->getSessionSecretHash().keys()) {
-            SharedNodePointer otherNode = DependencyManager::get<LimitedNodeList>()->nodeWithUUID(otherNodeSessionUUID);
-            if (otherNode) {
-                static_cast<DomainServerNodeData*>(otherNode->getLinkedData())->getSessionSecretHash().remove(node->getUUID());
-            }
-        }
+        // drop this node from the directory, with the connection secrets that we set up for it
+        _nodeDirectory.nodeRemoved(node->getUUID(), node->getLocalID());
 
         if (node->getType() == NodeType::Agent) {
             // if this node was an Agent ask DomainServerNodeData to remove the interpolation we potentially stored
@@ -26,6 +26,8 @@
 #include <Assignment.h>
 #include <HTTPSConnection.h>
 #include <LimitedNodeList.h>
+#include <Metrics.h>
+#include <NodeDirectory.h>
 
 #include "AssetsBackupHandler.h"
 #include "DomainGatekeeper.h"
@@ -94,6 +96,7 @@ private slots:
     void processRequestAssignmentPacket(QSharedPointer<ReceivedMessage> packet);
     void processListRequestPacket(QSharedPointer<ReceivedMessage> packet, SharedNodePointer sendingNode);
     void processNodeJSONStatsPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode);
+    void processNodeMetricsPacket(QSharedPointer<ReceivedMessage> packetList, SharedNodePointer sendingNode);
     void processPathQueryPacket(QSharedPointer<ReceivedMessage> packet);
     void processNodeDisconnectRequestPacket(QSharedPointer<ReceivedMessage> message);
     void processICEServerHeartbeatDenialPacket(QSharedPointer<ReceivedMessage> message);
@@ -278,6 +281,13 @@ private:
 
     DomainType _type { DomainType::NonMetaverse };
 
+    NodeDirectory _nodeDirectory;
+    quint32 _domainListNumber { 0 };
+
+    metrics::Counter* _domainListsSent { nullptr };
+    metrics::Counter* _fullDomainListsSent { nullptr };
+    metrics::Histogram* _domainListNodes { nullptr };
+
     friend class DomainGatekeeper;
     friend class DomainMetadata;
 
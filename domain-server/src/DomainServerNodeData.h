@@ -30,6 +30,10 @@ public:
 
     void updateJSONStats(QByteArray statsByteArray);
 
+    // the last metrics::Snapshot the node sent, read when the metrics are scraped
+    const QByteArray& getMetricsSnapshot() const { return _metricsSnapshot; }
+    void setMetricsSnapshot(const QByteArray& metricsSnapshot) { _metricsSnapshot = metricsSnapshot; }
+
     void setAssignmentUUID(const QUuid& assignmentUUID) { _assignmentUUID = assignmentUUID; }
     const QUuid& getAssignmentUUID() const { return _assignmentUUID; }
 
@@ -47,10 +51,16 @@ public:
     void setIsAuthenticated(bool isAuthenticated) { _isAuthenticated = isAuthenticated; }
     bool isAuthenticated() const { return _isAuthenticated; }
 
-    QHash<QUuid, QUuid>& getSessionSecretHash() { return _sessionSecretHash; }
-
     const NodeSet& getNodeInterestSet() const { return _nodeInterestSet; }
     void setNodeInterestSet(const NodeSet& nodeInterestSet) { _nodeInterestSet = nodeInterestSet; }
+
+    // the version of the last domain list the node got in full, as of its last check in
+    void setAcknowledgedDomainListVersion(quint64 version) { _acknowledgedDomainListVersion = version; }
+    quint64 getAcknowledgedDomainListVersion() const { return _acknowledgedDomainListVersion; }
+
+    // acknowledgements of versions before this one were for another interest set
+    void setMinimumDomainListVersion(quint64 version) { _minimumDomainListVersion = version; }
+    quint64 getMinimumDomainListVersion() const { return _minimumDomainListVersion; }
     
     void setNodeVersion(const QString& nodeVersion) { _nodeVersion = nodeVersion; }
     const QString& getNodeVersion() { return _nodeVersion; }
@@ -80,7 +90,6 @@ private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
     QJsonArray overrideValuesIfNeeded(const QJsonArray& newStats);
     
-    QHash<QUuid, QUuid> _sessionSecretHash;
     QUuid _assignmentUUID;
     QUuid _walletUUID;
     QString _username;
@@ -88,11 +97,14 @@ private:
     
     using StringPairHash = QHash<QPair<QString, QString>, QString>;
     QJsonObject _statsJSONObject;
+    QByteArray _metricsSnapshot;
     static StringPairHash _overrideHash;
     
     HifiSockAddr _sendingSockAddr;
     bool _isAuthenticated = true;
     NodeSet _nodeInterestSet;
+    quint64 _acknowledgedDomainListVersion { 0 };
+    quint64 _minimumDomainListVersion { 0 };
     QString _nodeVersion;
     QString _hardwareAddress;
     QUuid   _machineFingerprint;
@@ -29,6 +29,7 @@ public:
     HifiSockAddr senderSockAddr;
     QList<NodeType_t> interestList;
     QString placeName;
+    quint64 domainListVersion { 0 }; // the version of the last domain list the node got in full
     QString hardwareAddress;
     QUuid machineFingerprint;
     QString SystemInfo;
@@ -906,6 +906,7 @@ bool setupEssentials(int& argc, char** argv, bool runningMarkerExisted) {
     DependencyManager::set<StandAloneJSConsole>();
     DependencyManager::set<DialogsManager>();
     DependencyManager::set<ResourceCacheSharedItems>();
+    DependencyManager::get<ResourceCacheSharedItems>()->enableDiskCache();
     DependencyManager::set<DesktopScriptingInterface>();
     DependencyManager::set<EntityScriptingInterface>(true);
     DependencyManager::set<GraphicsScriptingInterface>();
@@ -5571,6 +5572,7 @@ void Application::init() {
     });
 
     ObjectMotionState::setShapeManager(&_shapeManager);
+    _shapeManager.enableDiskCache();
     _physicsEngine->init();
 
     EntityTreePointer tree = getEntities()->getTree();
@@ -35,6 +35,7 @@
 #include <RegisteredMetaTypes.h>
 #include <Rig.h>
 #include <SettingHandle.h>
+#include <TBBHelpers.h>
 #include <UsersScriptingInterface.h>
 #include <UUID.h>
 #include <shared/ConicalViewFrustum.h>
@@ -296,40 +297,47 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     render::Transaction renderTransaction;
     workload::Transaction workloadTransaction;
 
+    struct AvatarSimulation {
+        OtherAvatarPointer avatar;
+        bool inView;
+        bool jointsChanged;
+    };
+    std::vector<AvatarSimulation> batch;
+    batch.reserve(SimulationBatcher::MAX_BATCH_SIZE);
+
     for (int p = kHero; p < NumVariants; p++) {
         auto& priorityQueue = avatarPriorityQueues[p];
         // Sorting the current queue HERE as part of the measured timing.
         const auto& sortedAvatarVector = priorityQueue.getSortedVector();
 
-        auto passExpiry = updatePriorityExpiries[p];
-
-        for (auto it = sortedAvatarVector.begin(); it != sortedAvatarVector.end(); ++it) {
-            const SortableAvatar& sortData = *it;
-            const auto avatar = std::static_pointer_cast<OtherAvatar>(sortData.getAvatar());
-            if (!avatar->_isClientAvatar) {
-                avatar->setIsClientAvatar(true);
-            }
-            // TODO: to help us scale to more avatars it would be nice to not have to poll this stuff every update
-            if (avatar->getSkeletonModel()->isLoaded()) {
-                // remove the orb if it is there
-                avatar->removeOrb();
-                if (avatar->needsPhysicsUpdate()) {
-                    _otherAvatarsToChangeInPhysics.insert(avatar);
+        // other avatars are simulated in batches, in priority order, whose joint work and skinning run concurrently
+        size_t numSimulated = _avatarSimulationBatcher.simulate(sortedAvatarVector.size(), updatePriorityExpiries[p],
+                [&](size_t begin, size_t end) {
+            batch.clear();
+            for (size_t i = begin; i < end; ++i) {
+                const SortableAvatar& sortData = sortedAvatarVector[i];
+                const auto avatar = std::static_pointer_cast<OtherAvatar>(sortData.getAvatar());
+                if (!avatar->_isClientAvatar) {
+                    avatar->setIsClientAvatar(true);
+                }
+                // TODO: to help us scale to more avatars it would be nice to not have to poll this stuff every update
+                if (avatar->getSkeletonModel()->isLoaded()) {
+                    // remove the orb if it is there
+                    avatar->removeOrb();
+                    if (avatar->needsPhysicsUpdate()) {
+                        _otherAvatarsToChangeInPhysics.insert(avatar);
+                    }
+                } else {
+                    avatar->updateOrbPosition();
                 }
-            } else {
-                avatar->updateOrbPosition();
-            }
 
-            // for ALL avatars...
-            if (_shouldRender) {
-                avatar->ensureInScene(avatar, qApp->getMain3DScene());
-            }
+                // for ALL avatars...
+                if (_shouldRender) {
+                    avatar->ensureInScene(avatar, qApp->getMain3DScene());
+                }
 
-            avatar->animateScaleChanges(deltaTime);
+                avatar->animateScaleChanges(deltaTime);
 
-            uint64_t now = usecTimestampNow();
-            if (now < passExpiry) {
-                // we're within budget
                 bool inView = sortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
                 if (inView && avatar->hasNewJointData()) {
                     numAvatarsUpdated++;
@@ -340,7 +348,22 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
                     avatar->_transit.reset();
                     avatar->setIsNewAvatar(false);
                 }
-                avatar->simulate(deltaTime, inView);
+                batch.push_back({ avatar, inView, false });
+            }
+
+            // the joint work of an avatar only touches its own rig, so the whole batch is done concurrently
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, batch.size()), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); i++) {
+                    batch[i].jointsChanged = batch[i].avatar->computeJointPoses(batch[i].inView);
+                }
+            });
+
+            // The rest stays here and in priority order: the skeleton model builds its joint states from the network
+            // geometry on first use and its rig calls out to the animation state handlers of scripts, and the head,
+            // attachments, entities and grabs reach into the scene, the entity tree, flow and physics.
+            for (const auto& simulation : batch) {
+                const auto& avatar = simulation.avatar;
+                avatar->simulate(deltaTime, simulation.inView, simulation.jointsChanged);
                 if (avatar->getSkeletonModel()->isLoaded() && avatar->getWorkloadRegion() == workload::Region::R1) {
                     _myAvatar->addAvatarHandsToFlow(avatar);
                 }
@@ -351,33 +374,39 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
                 avatar->updateRenderItem(renderTransaction);
                 avatar->updateSpaceProxy(workloadTransaction);
                 avatar->setLastRenderUpdateTime(startTime);
+            }
 
-            } else {
-                // we've spent our time budget for this priority bucket
-                // let's deal with the reminding avatars if this pass and BREAK from the for loop
-
-                if (p == kHero) {
-                    // Hero,
-                    // --> put them back in the non hero queue
-
-                    auto& crowdQueue = avatarPriorityQueues[kNonHero];
-                    while (it != sortedAvatarVector.end()) {
-                        crowdQueue.push(SortableAvatar((*it).getAvatar()));
-                        ++it;
-                    }
-                } else {
-                    // Non Hero
-                    // --> bail on the rest of the avatar updates
-                    // --> more avatars may freeze until their priority trickles up
-                    // --> some scale animations may glitch
-                    // --> some avatar velocity measurements may be a little off
-
-                    // no time to simulate, but we take the time to count how many were tragically missed
-                    numAvatarsNotUpdated = sortedAvatarVector.end() - it;
+            // the skinning of an avatar only reads its own rig, so its cluster matrices are computed concurrently here
+            // rather than one avatar at a time in the post update lambdas, which then find them up to date
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, batch.size()), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); i++) {
+                    batch[i].avatar->getSkeletonModel()->updateClusterMatrices();
                 }
+            });
+        });
 
-                // We had to cut short this pass, we must break out of the for loop here
-                break;
+        auto it = sortedAvatarVector.begin() + numSimulated;
+        if (it != sortedAvatarVector.end()) {
+            // we've spent our time budget for this priority bucket
+            // let's deal with the reminding avatars if this pass
+            if (p == kHero) {
+                // Hero,
+                // --> put them back in the non hero queue
+
+                auto& crowdQueue = avatarPriorityQueues[kNonHero];
+                while (it != sortedAvatarVector.end()) {
+                    crowdQueue.push(SortableAvatar((*it).getAvatar()));
+                    ++it;
+                }
+            } else {
+                // Non Hero
+                // --> bail on the rest of the avatar updates
+                // --> more avatars may freeze until their priority trickles up
+                // --> some scale animations may glitch
+                // --> some avatar velocity measurements may be a little off
+
+                // no time to simulate, but we take the time to count how many were tragically missed
+                numAvatarsNotUpdated = sortedAvatarVector.end() - it;
             }
         }
 
@@ -22,6 +22,7 @@
 #include <PhysicsEngine.h>
 #include <PIDController.h>
 #include <SimpleMovingAverage.h>
+#include <SimulationBatcher.h>
 #include <shared/RateCounter.h>
 #include <avatars-renderer/ScriptAvatar.h>
 #include <AudioInjectorManager.h>
@@ -305,6 +306,7 @@ private:
     int _numHeroAvatars{ 0 };
     int _numHeroAvatarsUpdated{ 0 };
     float _avatarSimulationTime { 0.0f };
+    SimulationBatcher _avatarSimulationBatcher;
     bool _shouldRender { true };
     bool _myAvatarDataPacketsPaused { false };
 
@@ -243,7 +243,33 @@ void OtherAvatar::setCollisionWithOtherAvatarsFlags() {
     }
 }
 
+bool OtherAvatar::computeJointPoses(bool inView) {
+    if (!inView) {
+        return false;
+    }
+    Rig& rig = _skeletonModel->getRig();
+    {
+        // may run off the main thread, so don't race the network thread for the joint data, and take the flag with
+        // the data it flags: joint data that arrives after the copy sets it again for the next frame
+        QWriteLocker writeLock(&_jointDataLock);
+        bool hasNewJointData = _hasNewJointData;
+        _hasNewJointData = false;
+        if (!hasNewJointData && !_transit.isActive()) {
+            return false;
+        }
+        PROFILE_RANGE(simulation, "computeJointPoses");
+        rig.copyJointsFromJointData(_jointData);
+    }
+    glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
+    rig.computeExternalPoses(rootTransform);
+    return true;
+}
+
 void OtherAvatar::simulate(float deltaTime, bool inView) {
+    simulate(deltaTime, inView, computeJointPoses(inView));
+}
+
+void OtherAvatar::simulate(float deltaTime, bool inView, bool jointsChanged) {
     PROFILE_RANGE(simulation, "simulate");
 
     _globalPosition = _transit.isActive() ? _transit.getCurrentPosition() : _serverPosition;
@@ -261,17 +287,13 @@ void OtherAvatar::simulate(float deltaTime, bool inView) {
         PROFILE_RANGE(simulation, "updateJoints");
         if (inView) {
             Head* head = getHead();
-            if (_hasNewJointData || _transit.isActive()) {
-                _skeletonModel->getRig().copyJointsFromJointData(_jointData);
-                glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
-                _skeletonModel->getRig().computeExternalPoses(rootTransform);
+            if (jointsChanged) {
                 _jointDataSimulationRate.increment();
 
                 head->simulate(deltaTime);
                 _skeletonModel->simulate(deltaTime, true);
 
                 locationChanged(); // joints changed, so if there are any children, update them.
-                _hasNewJointData = false;
 
                 glm::vec3 headPosition = getWorldPosition();
                 if (!_skeletonModel->getHeadPosition(headPosition)) {
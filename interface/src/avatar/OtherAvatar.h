@@ -63,7 +63,13 @@ public:
 
     void setCollisionWithOtherAvatarsFlags() override;
 
+    // Copies freshly received joint data into the rig and publishes the resulting poses for rendering, and returns
+    // whether the joints changed.  It only touches this avatar's Rig, so AvatarManager runs it for a whole batch of
+    // avatars on worker threads ahead of simulate(), and hands it the result.
+    bool computeJointPoses(bool inView);
+
     void simulate(float deltaTime, bool inView) override;
+    void simulate(float deltaTime, bool inView, bool jointsChanged);
     void debugJointData() const;
     friend AvatarManager;
 
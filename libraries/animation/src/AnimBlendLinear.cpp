@@ -87,8 +87,8 @@ void AnimBlendLinear::evaluateAndBlendChildren(const AnimVariantMap& animVars, c
         _poses = _children[prevPoseIndex]->evaluate(animVars, context, dt, triggersOut);
     } else {
         // need to eval and blend between two children.
-        auto prevPoses = _children[prevPoseIndex]->evaluate(animVars, context, dt, triggersOut);
-        auto nextPoses = _children[nextPoseIndex]->evaluate(animVars, context, dt, triggersOut);
+        const auto& prevPoses = _children[prevPoseIndex]->evaluate(animVars, context, dt, triggersOut);
+        const auto& nextPoses = _children[nextPoseIndex]->evaluate(animVars, context, dt, triggersOut);
 
         if (prevPoses.size() > 0 && prevPoses.size() == nextPoses.size()) {
             _poses.resize(prevPoses.size());
@@ -15,6 +15,7 @@
 #include <GLMHelpers.h>
 
 #include "AnimationLogging.h"
+#include "AnimUtil.h"
 
 AnimSkeleton::AnimSkeleton(const HFMModel& hfmModel) {
 
@@ -147,6 +148,14 @@ void AnimSkeleton::convertAbsolutePosesToRelative(AnimPoseVec& poses) const {
 
 void AnimSkeleton::convertRelativeRotationsToAbsolute(std::vector<glm::quat>& rotations) const {
     // rotations start off relative and leave in absolute frame
+    if ((int)rotations.size() >= _jointsSize) {
+        for (size_t level = 0; level + 1 < _depthLevelOffsets.size(); ++level) {
+            int offset = _depthLevelOffsets[level];
+            int numJoints = _depthLevelOffsets[level + 1] - offset;
+            accumulateRotations(rotations.data(), &_depthOrderedJoints[offset], &_depthOrderedParents[offset], numJoints);
+        }
+        return;
+    }
     int lastIndex = std::min((int)rotations.size(), _jointsSize);
     for (int i = 0; i < lastIndex; ++i) {
         int parentIndex = _parentIndices[i];
@@ -208,6 +217,30 @@ void AnimSkeleton::buildSkeletonFromJoints(const std::vector<HFMJoint>& joints,
     }
 
     _jointsSize = (int)joints.size();
+
+    // bucket the non-root joints by depth
+    std::vector<std::vector<int>> levels;
+    for (int i = 0; i < _jointsSize; i++) {
+        if (_parentIndices[i] != -1) {
+            size_t level = (size_t)getChainDepth(i) - 2;
+            if (level >= levels.size()) {
+                levels.resize(level + 1);
+            }
+            levels[level].push_back(i);
+        }
+    }
+    _depthOrderedJoints.clear();
+    _depthOrderedParents.clear();
+    _depthLevelOffsets.clear();
+    for (auto& level : levels) {
+        _depthLevelOffsets.push_back((int)_depthOrderedJoints.size());
+        for (int jointIndex : level) {
+            _depthOrderedJoints.push_back(jointIndex);
+            _depthOrderedParents.push_back(_parentIndices[jointIndex]);
+        }
+    }
+    _depthLevelOffsets.push_back((int)_depthOrderedJoints.size());
+
     // build a cache of bind poses
 
     // build a chache of default poses
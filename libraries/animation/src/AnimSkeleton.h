@@ -75,6 +75,12 @@ protected:
 
     std::vector<HFMJoint> _joints;
     std::vector<int> _parentIndices;
+
+    // non-root joints ordered by chain depth, with the offset of each depth level,
+    // so the joints of a level can be converted to absolute frame in parallel
+    std::vector<int> _depthOrderedJoints;
+    std::vector<int> _depthOrderedParents;
+    std::vector<int> _depthLevelOffsets;
     int _jointsSize { 0 };
     AnimPoseVec _relativeDefaultPoses;
     AnimPoseVec _absoluteDefaultPoses;
@@ -9,13 +9,12 @@
 //
 
 #include "AnimUtil.h"
+#include <cstddef>
 #include <GLMHelpers.h>
 #include <NumericalConstants.h>
 #include <DebugDraw.h>
 
-// TODO: use restrict keyword
-// TODO: excellent candidate for simd vectorization.
-void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+static void blend_ref(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
         const AnimPose& bPose = b[i];
@@ -26,6 +25,81 @@ void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, A
     }
 }
 
+static void blendWeighted_ref(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* weights, float alpha, AnimPose* result) {
+    for (size_t i = 0; i < numPoses; i++) {
+        blend_ref(1, &a[i], &b[i], weights[i] * alpha, &result[i]);
+    }
+}
+
+static void accumulateRotations_ref(glm::quat* rotations, const int* joints, const int* parents, int numJoints) {
+    for (int i = 0; i < numJoints; i++) {
+        rotations[joints[i]] = rotations[parents[i]] * rotations[joints[i]];
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+//
+// Runtime CPU dispatch
+//
+#include <CPUDetect.h>
+
+void blend_AVX2(size_t numPoses, const float* a, const float* b, float alpha, float* result);
+void blendWeighted_AVX2(size_t numPoses, const float* a, const float* b, const float* weights, float alpha, float* result);
+void accumulateRotations_AVX2(float* rotations, const int* joints, const int* parents, int numJoints);
+
+static_assert(sizeof(AnimPose) == 10 * sizeof(float), "AnimPose layout doesn't match the AVX2 kernels.");
+static_assert(sizeof(glm::quat) == 4 * sizeof(float) && offsetof(glm::quat, w) == 3 * sizeof(float),
+              "glm::quat layout doesn't match the AVX2 kernels.");
+
+// the AVX2 kernels work on blocks of 8 joints, the remainder is done here
+static const size_t BLOCK_MASK = ~(size_t)7;
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+    size_t numBlocked = 0;
+    if (_cpuSupportsAVX2) {
+        numBlocked = numPoses & BLOCK_MASK;
+        blend_AVX2(numBlocked, (const float*)a, (const float*)b, alpha, (float*)result);
+    }
+    blend_ref(numPoses - numBlocked, a + numBlocked, b + numBlocked, alpha, result + numBlocked);
+}
+
+void blendWeighted(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* weights, float alpha, AnimPose* result) {
+    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+    size_t numBlocked = 0;
+    if (_cpuSupportsAVX2) {
+        numBlocked = numPoses & BLOCK_MASK;
+        blendWeighted_AVX2(numBlocked, (const float*)a, (const float*)b, weights, alpha, (float*)result);
+    }
+    blendWeighted_ref(numPoses - numBlocked, a + numBlocked, b + numBlocked, weights + numBlocked, alpha, result + numBlocked);
+}
+
+void accumulateRotations(glm::quat* rotations, const int* joints, const int* parents, int numJoints) {
+    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+    int numBlocked = 0;
+    if (_cpuSupportsAVX2) {
+        numBlocked = numJoints & (int)BLOCK_MASK;
+        accumulateRotations_AVX2((float*)rotations, joints, parents, numBlocked);
+    }
+    accumulateRotations_ref(rotations, joints + numBlocked, parents + numBlocked, numJoints - numBlocked);
+}
+
+#else   // portable reference code
+
+void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result) {
+    blend_ref(numPoses, a, b, alpha, result);
+}
+
+void blendWeighted(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* weights, float alpha, AnimPose* result) {
+    blendWeighted_ref(numPoses, a, b, weights, alpha, result);
+}
+
+void accumulateRotations(glm::quat* rotations, const int* joints, const int* parents, int numJoints) {
+    accumulateRotations_ref(rotations, joints, parents, numJoints);
+}
+
+#endif
+
 void blend3(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, float* alphas, AnimPose* result) {
     for (size_t i = 0; i < numPoses; i++) {
         const AnimPose& aPose = a[i];
@@ -16,6 +16,13 @@
 // this is where the magic happens
 void blend(size_t numPoses, const AnimPose* a, const AnimPose* b, float alpha, AnimPose* result);
 
+// blend with a per joint alpha of weights[i] * alpha
+void blendWeighted(size_t numPoses, const AnimPose* a, const AnimPose* b, const float* weights, float alpha, AnimPose* result);
+
+// rotations[joints[i]] = rotations[parents[i]] * rotations[joints[i]]
+// none of the parents may appear in joints, so that all joints can be processed in parallel.
+void accumulateRotations(glm::quat* rotations, const int* joints, const int* parents, int numJoints);
+
 // blend between three sets of poses
 void blend3(size_t numPoses, const AnimPose* a, const AnimPose* b, const AnimPose* c, float* alphas, AnimPose* result);
 
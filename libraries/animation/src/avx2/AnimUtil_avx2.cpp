@@ -0,0 +1,171 @@
+//
+//  AnimUtil_avx2.cpp
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <stddef.h>
+#include <immintrin.h>
+
+//
+// AnimPose is 10 floats: scale.xyz, rot.xyzw, trans.xyz
+// Poses are processed in blocks of 8, transposed so that each register holds one component of 8 joints.
+//
+static const int POSE_FLOATS = 10;
+enum { SX, SY, SZ, QX, QY, QZ, QW, TX, TY, TZ };
+
+static inline void transpose8x8(__m256& r0, __m256& r1, __m256& r2, __m256& r3,
+                                __m256& r4, __m256& r5, __m256& r6, __m256& r7) {
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1,0,1,0));
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3,2,3,2));
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1,0,1,0));
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3,2,3,2));
+
+    r0 = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r1 = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r2 = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r3 = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r4 = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r5 = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r6 = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r7 = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// deinterleave 8 poses into 10 component registers
+static inline void loadPoses(const float* src, __m256 (&p)[POSE_FLOATS]) {
+    for (int j = 0; j < 8; j++) {
+        p[j] = _mm256_loadu_ps(src + j * POSE_FLOATS);
+    }
+    transpose8x8(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+
+    const __m256i index = _mm256_setr_epi32(0, 10, 20, 30, 40, 50, 60, 70);
+    p[TY] = _mm256_i32gather_ps(src + TY, index, sizeof(float));
+    p[TZ] = _mm256_i32gather_ps(src + TZ, index, sizeof(float));
+}
+
+// interleave 10 component registers into 8 poses
+static inline void storePoses(__m256 (&p)[POSE_FLOATS], float* dst) {
+    float ty[8], tz[8];
+    _mm256_storeu_ps(ty, p[TY]);
+    _mm256_storeu_ps(tz, p[TZ]);
+
+    transpose8x8(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+    for (int j = 0; j < 8; j++) {
+        _mm256_storeu_ps(dst + j * POSE_FLOATS, p[j]);
+        dst[j * POSE_FLOATS + TY] = ty[j];
+        dst[j * POSE_FLOATS + TZ] = tz[j];
+    }
+}
+
+// normalize 8 quaternions, degenerate ones become identity (like glm::normalize)
+static inline void normalizeQuats(__m256& x, __m256& y, __m256& z, __m256& w) {
+    __m256 len2 = _mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_fmadd_ps(z, z, _mm256_mul_ps(w, w))));
+    __m256 valid = _mm256_cmp_ps(len2, _mm256_setzero_ps(), _CMP_GT_OQ);
+    __m256 invLen = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(len2));
+    x = _mm256_and_ps(valid, _mm256_mul_ps(x, invLen));
+    y = _mm256_and_ps(valid, _mm256_mul_ps(y, invLen));
+    z = _mm256_and_ps(valid, _mm256_mul_ps(z, invLen));
+    w = _mm256_blendv_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(w, invLen), valid);
+}
+
+// result = a + alpha * (b - a) for every component, with b's rotation flipped into a's hemisphere
+static inline void blendPoses(__m256 (&a)[POSE_FLOATS], __m256 (&b)[POSE_FLOATS], __m256 alpha) {
+    __m256 dot = _mm256_fmadd_ps(a[QX], b[QX], _mm256_fmadd_ps(a[QY], b[QY],
+                 _mm256_fmadd_ps(a[QZ], b[QZ], _mm256_mul_ps(a[QW], b[QW]))));
+    __m256 sign = _mm256_and_ps(_mm256_cmp_ps(dot, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(-0.0f));
+    for (int k = QX; k <= QW; k++) {
+        b[k] = _mm256_xor_ps(b[k], sign);
+    }
+    for (int k = 0; k < POSE_FLOATS; k++) {
+        a[k] = _mm256_fmadd_ps(alpha, _mm256_sub_ps(b[k], a[k]), a[k]);
+    }
+    normalizeQuats(a[QX], a[QY], a[QZ], a[QW]);
+}
+
+void blend_AVX2(size_t numPoses, const float* a, const float* b, float alpha, float* result) {
+    __m256 alphas = _mm256_set1_ps(alpha);
+    for (size_t i = 0; i + 8 <= numPoses; i += 8) {
+        __m256 pa[POSE_FLOATS], pb[POSE_FLOATS];
+        loadPoses(a + i * POSE_FLOATS, pa);
+        loadPoses(b + i * POSE_FLOATS, pb);
+        blendPoses(pa, pb, alphas);
+        storePoses(pa, result + i * POSE_FLOATS);
+    }
+}
+
+void blendWeighted_AVX2(size_t numPoses, const float* a, const float* b, const float* weights, float alpha, float* result) {
+    for (size_t i = 0; i + 8 <= numPoses; i += 8) {
+        __m256 alphas = _mm256_mul_ps(_mm256_loadu_ps(weights + i), _mm256_set1_ps(alpha));
+        __m256 pa[POSE_FLOATS], pb[POSE_FLOATS];
+        loadPoses(a + i * POSE_FLOATS, pa);
+        loadPoses(b + i * POSE_FLOATS, pb);
+        blendPoses(pa, pb, alphas);
+        storePoses(pa, result + i * POSE_FLOATS);
+    }
+}
+
+//
+// rotations[joint] = rotations[parent] * rotations[joint] for 8 joints at a time.
+// No joint in a block may be the parent of another joint in the same block.
+//
+void accumulateRotations_AVX2(float* rotations, const int* joints, const int* parents, int numJoints) {
+    for (int i = 0; i + 8 <= numJoints; i += 8) {
+        __m256i jointIndex = _mm256_slli_epi32(_mm256_loadu_si256((const __m256i*)(joints + i)), 2);
+        __m256i parentIndex = _mm256_slli_epi32(_mm256_loadu_si256((const __m256i*)(parents + i)), 2);
+
+        __m256 qx = _mm256_i32gather_ps(rotations + 0, jointIndex, sizeof(float));
+        __m256 qy = _mm256_i32gather_ps(rotations + 1, jointIndex, sizeof(float));
+        __m256 qz = _mm256_i32gather_ps(rotations + 2, jointIndex, sizeof(float));
+        __m256 qw = _mm256_i32gather_ps(rotations + 3, jointIndex, sizeof(float));
+        __m256 px = _mm256_i32gather_ps(rotations + 0, parentIndex, sizeof(float));
+        __m256 py = _mm256_i32gather_ps(rotations + 1, parentIndex, sizeof(float));
+        __m256 pz = _mm256_i32gather_ps(rotations + 2, parentIndex, sizeof(float));
+        __m256 pw = _mm256_i32gather_ps(rotations + 3, parentIndex, sizeof(float));
+
+        // Hamilton product p * q
+        __m256 rw = _mm256_fnmadd_ps(pz, qz, _mm256_fnmadd_ps(py, qy, _mm256_fnmadd_ps(px, qx, _mm256_mul_ps(pw, qw))));
+        __m256 rx = _mm256_fnmadd_ps(pz, qy, _mm256_fmadd_ps(py, qz, _mm256_fmadd_ps(px, qw, _mm256_mul_ps(pw, qx))));
+        __m256 ry = _mm256_fnmadd_ps(px, qz, _mm256_fmadd_ps(pz, qx, _mm256_fmadd_ps(py, qw, _mm256_mul_ps(pw, qy))));
+        __m256 rz = _mm256_fnmadd_ps(py, qx, _mm256_fmadd_ps(px, qy, _mm256_fmadd_ps(pz, qw, _mm256_mul_ps(pw, qz))));
+
+        // no scatter in AVX2, interleave back to xyzw in two halves
+        __m256 xy0 = _mm256_unpacklo_ps(rx, ry);    // x0 y0 x1 y1 | x4 y4 x5 y5
+        __m256 xy1 = _mm256_unpackhi_ps(rx, ry);    // x2 y2 x3 y3 | x6 y6 x7 y7
+        __m256 zw0 = _mm256_unpacklo_ps(rz, rw);
+        __m256 zw1 = _mm256_unpackhi_ps(rz, rw);
+        __m256 q04 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1,0,1,0));
+        __m256 q15 = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3,2,3,2));
+        __m256 q26 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1,0,1,0));
+        __m256 q37 = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3,2,3,2));
+
+        const int* j = joints + i;
+        _mm_storeu_ps(rotations + 4 * j[0], _mm256_castps256_ps128(q04));
+        _mm_storeu_ps(rotations + 4 * j[1], _mm256_castps256_ps128(q15));
+        _mm_storeu_ps(rotations + 4 * j[2], _mm256_castps256_ps128(q26));
+        _mm_storeu_ps(rotations + 4 * j[3], _mm256_castps256_ps128(q37));
+        _mm_storeu_ps(rotations + 4 * j[4], _mm256_extractf128_ps(q04, 1));
+        _mm_storeu_ps(rotations + 4 * j[5], _mm256_extractf128_ps(q15, 1));
+        _mm_storeu_ps(rotations + 4 * j[6], _mm256_extractf128_ps(q26, 1));
+        _mm_storeu_ps(rotations + 4 * j[7], _mm256_extractf128_ps(q37, 1));
+    }
+}
+
+#endif
@@ -0,0 +1,288 @@
+//
+//  AudioADPCM.cpp
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioADPCM.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "AudioDynamics.h"
+
+static const int HEADER_BYTES = 2;                                      // the last sample of the frame before
+static const int BLOCK_BYTES = 1 + AudioADPCM::BLOCK_SAMPLES / 2;       // predictor and step, then 4-bit codes
+static const int HISTORY = AudioADPCM::NUM_PREDICTORS - 1;
+static const int MAX_STEP_RETRIES = 4;
+
+//
+// Quantizer steps, from 1 to 32768 in 64 geometric steps (1.4dB apart)
+//
+class StepTable {
+public:
+    int32_t step[AudioADPCM::NUM_STEPS];
+    int32_t inverse[AudioADPCM::NUM_STEPS];     // Q16
+    int32_t capacity[AudioADPCM::NUM_STEPS];    // the largest residual coded without clipping
+
+    StepTable() {
+        for (int i = 0; i < AudioADPCM::NUM_STEPS; i++) {
+            int32_t s = (int32_t)lrint(pow(2.0, i * 15.0 / (AudioADPCM::NUM_STEPS - 1)));
+            step[i] = (i > 0) ? MAX(s, step[i - 1] + 1) : s;
+            inverse[i] = ((1 << 16) + step[i] / 2) / step[i];
+            capacity[i] = (15 * step[i]) / 2;
+        }
+    }
+};
+
+static const StepTable stepTable;
+
+static inline int32_t clamp16(int32_t x) {
+    return MIN(MAX(x, -32768), 32767);
+}
+
+// fixed polynomial predictors, from the last samples h1, h2, h3
+static inline int32_t predict(int order, int32_t h1, int32_t h2, int32_t h3) {
+    switch (order) {
+        case 0:
+            return 0;
+        case 1:
+            return h1;
+        case 2:
+            return 2 * h1 - h2;
+        default:
+            return 3 * h1 - 3 * h2 + h3;
+    }
+}
+
+int AudioADPCM::getEncodedSize(int numFrames, int numChannels) {
+    int numBlocks = (numFrames + BLOCK_SAMPLES - 1) / BLOCK_SAMPLES;
+    return numChannels * (HEADER_BYTES + numBlocks * BLOCK_BYTES);
+}
+
+//
+// Open-loop analysis of a block: the peak residual of each predictor.
+// x[0..HISTORY-1] holds the samples before the block.
+//
+static void analyzeBlock(const int32_t* x, int numSamples, int32_t peaks[AudioADPCM::NUM_PREDICTORS]) {
+
+    int32_t peak0 = 0, peak1 = 0, peak2 = 0, peak3 = 0;
+
+    for (int n = 0; n < numSamples; n++) {
+
+        int32_t s0 = x[n + 3];
+        int32_t s1 = x[n + 2];
+        int32_t s2 = x[n + 1];
+        int32_t s3 = x[n + 0];
+
+        int32_t r0 = s0;
+        int32_t r1 = s0 - s1;
+        int32_t r2 = s0 - 2 * s1 + s2;
+        int32_t r3 = s0 - 3 * s1 + 3 * s2 - s3;
+
+        peak0 = MAX(peak0, abs(r0));
+        peak1 = MAX(peak1, abs(r1));
+        peak2 = MAX(peak2, abs(r2));
+        peak3 = MAX(peak3, abs(r3));
+    }
+
+    peaks[0] = peak0;
+    peaks[1] = peak1;
+    peaks[2] = peak2;
+    peaks[3] = peak3;
+}
+
+//
+// Closed-loop coding of a block, from the decoded history h[0..2] (h[0] most recent), which is updated.
+// Returns false if a residual was clipped.
+//
+static bool encodeBlock(const int32_t* x, int numSamples, int order, int stepIndex, int32_t h[HISTORY], uint8_t* codes) {
+
+    int32_t step = stepTable.step[stepIndex];
+    int32_t inverse = stepTable.inverse[stepIndex];
+    int32_t h1 = h[0], h2 = h[1], h3 = h[2];
+    bool isClipped = false;
+
+    memset(codes, 0, AudioADPCM::BLOCK_SAMPLES / 2);
+
+    for (int n = 0; n < numSamples; n++) {
+
+        int32_t prediction = predict(order, h1, h2, h3);
+        int32_t residual = x[n + 3] - prediction;
+
+        // keep the product in range, what is past the codes clips anyway
+        residual = MIN(MAX(residual, -9 * step), 9 * step);
+        int32_t q = (residual * inverse + (1 << 15)) >> 16;
+        isClipped |= (q < -8) | (q > 7);
+        q = MIN(MAX(q, -8), 7);
+
+        int32_t decoded = clamp16(prediction + q * step);
+
+        codes[n >> 1] |= (uint8_t)((q & 0xf) << ((n & 1) * 4));
+
+        h3 = h2;
+        h2 = h1;
+        h1 = decoded;
+    }
+
+    h[0] = h1;
+    h[1] = h2;
+    h[2] = h3;
+    return !isClipped;
+}
+
+AudioADPCMEncoder::AudioADPCMEncoder(int numChannels) : _numChannels(numChannels), _lastSamples(numChannels, 0) {
+}
+
+void AudioADPCMEncoder::process(const int16_t* input, uint8_t* encoded, int numFrames) {
+
+    // the samples of the block, after those before it
+    int32_t x[HISTORY + AudioADPCM::BLOCK_SAMPLES];
+
+    for (int ch = 0; ch < _numChannels; ch++) {
+
+        int32_t lastSample = _lastSamples[ch];
+        encoded[0] = (uint8_t)(lastSample & 0xff);
+        encoded[1] = (uint8_t)((lastSample >> 8) & 0xff);
+        encoded += HEADER_BYTES;
+
+        // the frame starts from a flat history, as the decoder does
+        int32_t h[HISTORY] = { lastSample, lastSample, lastSample };
+        x[0] = x[1] = x[2] = lastSample;
+
+        for (int i = 0; i < numFrames; i += AudioADPCM::BLOCK_SAMPLES) {
+
+            int numSamples = MIN(AudioADPCM::BLOCK_SAMPLES, numFrames - i);
+            for (int n = 0; n < numSamples; n++) {
+                x[HISTORY + n] = input[(i + n) * _numChannels + ch];
+            }
+
+            // the predictor of the smallest peak, and the smallest step that codes it
+            int32_t peaks[AudioADPCM::NUM_PREDICTORS];
+            analyzeBlock(x, numSamples, peaks);
+            int order = (int)(std::min_element(peaks, peaks + AudioADPCM::NUM_PREDICTORS) - peaks);
+            int stepIndex = (int)(std::lower_bound(stepTable.capacity, stepTable.capacity + AudioADPCM::NUM_STEPS,
+                peaks[order]) - stepTable.capacity);
+            stepIndex = MIN(stepIndex, AudioADPCM::NUM_STEPS - 1);
+
+            // the decoded history differs from the input, which can take a larger step
+            int32_t blockHistory[HISTORY];
+            for (int retry = 0; ; retry++) {
+                memcpy(blockHistory, h, sizeof(h));
+                bool isCoded = encodeBlock(x, numSamples, order, stepIndex, blockHistory, encoded + 1);
+                if (isCoded || retry == MAX_STEP_RETRIES || stepIndex == AudioADPCM::NUM_STEPS - 1) {
+                    break;
+                }
+                stepIndex++;
+            }
+            memcpy(h, blockHistory, sizeof(h));
+
+            encoded[0] = (uint8_t)((order << 6) | stepIndex);
+            encoded += BLOCK_BYTES;
+
+            // the last samples of the block precede the next one
+            for (int n = 0; n < HISTORY; n++) {
+                x[n] = x[numSamples + n];
+            }
+        }
+
+        _lastSamples[ch] = (int16_t)h[0];
+    }
+}
+
+AudioADPCMDecoder::AudioADPCMDecoder(int numChannels) : _numChannels(numChannels) {
+}
+
+bool AudioADPCMDecoder::process(const uint8_t* encoded, int encodedSize, int16_t* output, int numFrames) {
+
+    if (encodedSize != AudioADPCM::getEncodedSize(numFrames, _numChannels)) {
+        return false;
+    }
+
+    _history.resize(_numChannels * numFrames);
+    _channel.resize(numFrames);
+
+    for (int ch = 0; ch < _numChannels; ch++) {
+
+        int32_t lastSample = (int16_t)(encoded[0] | (encoded[1] << 8));
+        encoded += HEADER_BYTES;
+
+        int32_t h1 = lastSample, h2 = lastSample, h3 = lastSample;
+
+        for (int i = 0; i < numFrames; i += AudioADPCM::BLOCK_SAMPLES) {
+
+            int numSamples = MIN(AudioADPCM::BLOCK_SAMPLES, numFrames - i);
+            int order = encoded[0] >> 6;
+            int32_t step = stepTable.step[encoded[0] & 0x3f];
+            const uint8_t* codes = encoded + 1;
+
+            for (int n = 0; n < numSamples; n++) {
+
+                int32_t code = (codes[n >> 1] >> ((n & 1) * 4)) & 0xf;
+                int32_t q = (code ^ 8) - 8;     // sign-extend
+
+                int32_t decoded = clamp16(predict(order, h1, h2, h3) + q * step);
+                _channel[i + n] = (int16_t)decoded;
+
+                h3 = h2;
+                h2 = h1;
+                h1 = decoded;
+            }
+            encoded += BLOCK_BYTES;
+        }
+
+        int16_t* history = &_history[ch * numFrames];
+
+        // fade from where the concealment would have continued
+        if (_wasConcealed) {
+            int numCrossfade = MIN(CROSSFADE_SAMPLES, numFrames);
+            for (int n = 0; n < numCrossfade; n++) {
+                float concealed = history[numFrames - 1 - n] * _concealGain;
+                float w = (n + 1) / (float)(numCrossfade + 1);
+                _channel[n] = (int16_t)clamp16((int32_t)lrintf(concealed + w * (_channel[n] - concealed)));
+            }
+        }
+
+        for (int n = 0; n < numFrames; n++) {
+            history[n] = _channel[n];
+            output[n * _numChannels + ch] = _channel[n];
+        }
+    }
+
+    _wasConcealed = false;
+    _concealGain = 1.0f;
+    return true;
+}
+
+void AudioADPCMDecoder::conceal(int16_t* output, int numFrames) {
+
+    if ((int)_history.size() != _numChannels * numFrames) {
+        _history.assign(_numChannels * numFrames, 0);
+    }
+
+    float startGain = _concealGain;
+    float endGain = MAX(startGain - 1.0f / CONCEALED_FRAMES, 0.0f);
+
+    for (int ch = 0; ch < _numChannels; ch++) {
+
+        int16_t* history = &_history[ch * numFrames];
+
+        // play the last frame backwards, which starts where it ended
+        std::reverse(history, history + numFrames);
+
+        for (int n = 0; n < numFrames; n++) {
+            float gain = startGain + (endGain - startGain) * (n + 1) / (float)numFrames;
+            output[n * _numChannels + ch] = (int16_t)lrintf(history[n] * gain);
+        }
+    }
+
+    _concealGain = endGain;
+    _wasConcealed = true;
+}
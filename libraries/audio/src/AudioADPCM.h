@@ -0,0 +1,78 @@
+//
+//  AudioADPCM.h
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioADPCM_h
+#define hifi_AudioADPCM_h
+
+#include <stdint.h>
+#include <vector>
+
+//
+// Block-adaptive ADPCM of int16_t audio, at a fixed 4.5 bits per sample.
+//
+// Each channel of a frame is coded in blocks of BLOCK_SAMPLES: a header byte holds the fixed polynomial predictor
+// (of order 0 to 3) and the quantizer step of the block, followed by a 4-bit code of the prediction residual of each
+// sample.  The encoder picks the predictor and step of a block from the peak of its open-loop residuals, which is
+// branch-free and vectorizes, so that a mixer can encode a mix per listener for a fraction of the cost of the other
+// codecs.  Every frame starts from the last sample of the frame before, stored in the frame, so that frames decode
+// on their own and a lost frame only costs what the decoder conceals of it.
+//
+class AudioADPCM {
+public:
+    static const int BLOCK_SAMPLES = 16;
+    static const int NUM_PREDICTORS = 4;
+    static const int NUM_STEPS = 64;
+
+    // the bytes of an encoded frame of numFrames samples per channel
+    static int getEncodedSize(int numFrames, int numChannels);
+};
+
+class AudioADPCMEncoder {
+public:
+    AudioADPCMEncoder(int numChannels);
+
+    //
+    // Encode interleaved int16_t input, of AudioADPCM::getEncodedSize(numFrames, numChannels) bytes.
+    //
+    void process(const int16_t* input, uint8_t* encoded, int numFrames);
+
+private:
+    int _numChannels;
+    std::vector<int16_t> _lastSamples;  // of each channel, as decoded
+    std::vector<int16_t> _channel;      // the samples of a channel of the frame
+};
+
+class AudioADPCMDecoder {
+public:
+    static const int CONCEALED_FRAMES = 3;      // frames faded to silence when they are lost in a row
+    static const int CROSSFADE_SAMPLES = 48;    // from what was concealed, to the next frame decoded
+
+    AudioADPCMDecoder(int numChannels);
+
+    //
+    // Decode to interleaved int16_t output.
+    // Returns false, with nothing decoded, if the encoded frame is not of the expected size.
+    //
+    bool process(const uint8_t* encoded, int encodedSize, int16_t* output, int numFrames);
+
+    //
+    // Conceal a lost frame, from the frames decoded before it.
+    //
+    void conceal(int16_t* output, int numFrames);
+
+private:
+    int _numChannels;
+    std::vector<int16_t> _history;  // the last frame of each channel, before it was faded
+    std::vector<int16_t> _channel;  // the samples of a channel of the frame
+    float _concealGain = 1.0f;      // where the last concealed frame faded to
+    bool _wasConcealed = false;
+};
+
+#endif // hifi_AudioADPCM_h
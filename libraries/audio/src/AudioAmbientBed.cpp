@@ -0,0 +1,149 @@
+//
+//  AudioAmbientBed.cpp
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioAmbientBed.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include <glm/gtx/norm.hpp>
+
+#include <AudioHelpers.h>
+#include <NumericalConstants.h>
+
+// the sector of an offset from the center, clockwise from forward (-z) as the azimuth of AudioHRTF
+static int sectorOf(const glm::vec3& offset) {
+    const int NUM_SECTORS = AudioAmbientBed::NUM_SECTORS;
+
+    float angle = atan2f(offset.x, -offset.z);
+    int sector = (int)floorf(angle * (NUM_SECTORS / TWO_PI) + 0.5f);
+    return (sector + NUM_SECTORS) % NUM_SECTORS;
+}
+
+// as the mixer computes it for a source
+static float computeAzimuth(const glm::quat& listenerOrientation, const glm::vec3& relativePosition) {
+    glm::vec3 rotatedSourcePosition = glm::inverse(listenerOrientation) * relativePosition;
+
+    // project the rotated source position vector onto the XZ plane
+    rotatedSourcePosition.y = 0.0f;
+
+    const float SOURCE_DISTANCE_THRESHOLD = 1e-30f;
+
+    float rotatedSourcePositionLength2 = glm::length2(rotatedSourcePosition);
+    if (rotatedSourcePositionLength2 > SOURCE_DISTANCE_THRESHOLD) {
+
+        // produce an oriented angle about the y-axis
+        glm::vec3 direction = rotatedSourcePosition * (1.0f / fastSqrtf(rotatedSourcePositionLength2));
+        float angle = fastAcosf(glm::clamp(-direction.z, -1.0f, 1.0f)); // UNIT_NEG_Z is "forward"
+        return (direction.x < 0.0f) ? -angle : angle;
+
+    } else {
+        // no azimuth if they are in same spot
+        return 0.0f;
+    }
+}
+
+void AudioAmbientBed::Listener::reset() {
+    for (int i = 0; i < NUM_SECTORS; i++) {
+        _hrtfs[i].reset();
+        _isRendering[i] = false;
+    }
+}
+
+AudioAmbientBed::AudioAmbientBed(const glm::vec3& center) : _center(center) {
+    clear();
+}
+
+void AudioAmbientBed::clear() {
+    for (Sector& sector : _sectors) {
+        memset(sector.mix, 0, sizeof(sector.mix));
+        sector.weightedPosition = glm::vec3(0.0f);
+        sector.position = glm::vec3(0.0f);
+        sector.weight = 0.0f;
+        sector.numSources = 0;
+    }
+    _numSources = 0;
+}
+
+void AudioAmbientBed::addSource(const int16_t* samples, const glm::vec3& position, float gain) {
+    Sector& sector = _sectors[sectorOf(position - _center)];
+
+    for (int i = 0; i < HRTF_BLOCK; i++) {
+        sector.mix[i] += samples[i] * gain;
+    }
+    sector.weightedPosition += position * gain;
+    sector.position += position;
+    sector.weight += gain;
+
+    ++sector.numSources;
+    ++_numSources;
+}
+
+void AudioAmbientBed::finish() {
+    for (Sector& sector : _sectors) {
+        if (sector.numSources == 0) {
+            continue;
+        }
+
+        // heard from the centroid of its sources, or of their positions when they are all silent
+        if (sector.weight > 0.0f) {
+            sector.position = sector.weightedPosition / sector.weight;
+        } else {
+            sector.position /= (float)sector.numSources;
+        }
+
+        // scale the mix to fit, and make it up in the gain of the render
+        float peak = 0.0f;
+        for (int i = 0; i < HRTF_BLOCK; i++) {
+            peak = std::max(peak, fabsf(sector.mix[i]));
+        }
+        sector.scale = std::max(peak / 32767.0f, 1.0f);
+
+        float invScale = 1.0f / sector.scale;
+        for (int i = 0; i < HRTF_BLOCK; i++) {
+            sector.samples[i] = (int16_t)lrintf(sector.mix[i] * invScale);
+        }
+    }
+}
+
+int AudioAmbientBed::render(Listener& listener, const glm::vec3& listenerPosition, const glm::quat& listenerOrientation,
+                            int index, float gain, float* output) const {
+    int numRenders = 0;
+
+    for (int i = 0; i < NUM_SECTORS; i++) {
+        const Sector& sector = _sectors[i];
+
+        if (sector.numSources > 0) {
+            glm::vec3 relativePosition = sector.position - listenerPosition;
+
+            listener._azimuths[i] = computeAzimuth(listenerOrientation, relativePosition);
+            listener._distances[i] = glm::max(glm::length(relativePosition), EPSILON);
+            listener._gains[i] = gain * sector.scale;
+            listener._isRendering[i] = true;
+
+            // AudioHRTF only reads its input
+            listener._hrtfs[i].render(const_cast<int16_t*>(sector.samples), output, index, listener._azimuths[i],
+                                      listener._distances[i], listener._gains[i], HRTF_BLOCK);
+            ++numRenders;
+
+        } else if (listener._isRendering[i]) {
+            listener._isRendering[i] = false;
+
+            // render a silent block, to flush the tail of the last one
+            static int16_t silentBlock[HRTF_BLOCK] = {};
+            listener._hrtfs[i].render(silentBlock, output, index, listener._azimuths[i], listener._distances[i],
+                                      listener._gains[i], HRTF_BLOCK);
+            ++numRenders;
+        }
+    }
+
+    return numRenders;
+}
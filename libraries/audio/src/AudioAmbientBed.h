@@ -0,0 +1,90 @@
+//
+//  AudioAmbientBed.h
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioAmbientBed_h
+#define hifi_AudioAmbientBed_h
+
+#include <stdint.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "AudioHRTF.h"
+
+//
+// Stationary sources around a center, pre-summed into a bed of NUM_SECTORS directions, so that a listener renders
+// the bed with one HRTF per direction rather than one per source.
+//
+// Each source is summed into the sector of its azimuth around the center, with a gain for its distance from the
+// center, and a sector is heard from the centroid of its sources (weighted by gain).  The HRTF state, for each
+// sector, is kept by each listener.
+//
+class AudioAmbientBed {
+public:
+    static const int NUM_SECTORS = 8;
+
+    // the HRTF state of a listener, for each sector of a bed
+    class Listener {
+    public:
+        void reset();
+
+    private:
+        friend class AudioAmbientBed;
+
+        AudioHRTF _hrtfs[NUM_SECTORS];
+
+        // of the last render, to flush the tail of a sector that goes silent
+        bool _isRendering[NUM_SECTORS] {};
+        float _azimuths[NUM_SECTORS] {};
+        float _distances[NUM_SECTORS] {};
+        float _gains[NUM_SECTORS] {};
+    };
+
+    AudioAmbientBed(const glm::vec3& center = glm::vec3(0.0f));
+
+    void setCenter(const glm::vec3& center) { _center = center; }
+    const glm::vec3& getCenter() const { return _center; }
+
+    // start a frame
+    void clear();
+
+    // add a frame of HRTF_BLOCK mono samples
+    void addSource(const int16_t* samples, const glm::vec3& position, float gain);
+
+    // end a frame, once its sources are added
+    void finish();
+
+    bool isEmpty() const { return _numSources == 0; }
+    int getNumSources() const { return _numSources; }
+
+    //
+    // Render the frame, for a listener, into an interleaved stereo mix buffer (accumulates as AudioHRTF does).
+    // Returns the number of HRTF renders.
+    //
+    int render(Listener& listener, const glm::vec3& listenerPosition, const glm::quat& listenerOrientation,
+               int index, float gain, float* output) const;
+
+private:
+    struct Sector {
+        float mix[HRTF_BLOCK];
+        int16_t samples[HRTF_BLOCK];    // the mix, scaled to fit
+        float scale;                    // of the samples, to the mix
+        glm::vec3 weightedPosition;
+        glm::vec3 position;
+        float weight;
+        int numSources;
+    };
+
+    glm::vec3 _center;
+    Sector _sectors[NUM_SECTORS];
+    int _numSources { 0 };
+};
+
+#endif // hifi_AudioAmbientBed_h
@@ -0,0 +1,167 @@
+//
+//  AudioJitterBuffer.cpp
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioJitterBuffer.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+
+const float AudioJitterBuffer::MAX_STRETCH = 0.03f;
+const float AudioJitterBuffer::MAX_RESCUE_STRETCH = 0.5f;
+
+static const int64_t NO_FLOOR = std::numeric_limits<int64_t>::max();
+
+static int msecsToFrames(int msecs, int sampleRate) {
+    return (int)((int64_t)msecs * sampleRate / 1000);
+}
+
+AudioJitterBuffer::AudioJitterBuffer(int numChannels, int sampleRate, int capacityMsecs) :
+    _ringBuffer(msecsToFrames(capacityMsecs, sampleRate) * numChannels),
+    _numChannels(numChannels),
+    _safetyFrames(msecsToFrames(SAFETY_MSECS, sampleRate)),
+    _maxExcessFrames(msecsToFrames(MAX_EXCESS_MSECS, sampleRate)),
+    _blockFrames(msecsToFrames(BLOCK_MSECS, sampleRate)),
+    _starveHoldFrames(msecsToFrames(STARVE_HOLD_MSECS, sampleRate)),
+    _blockFloors(WINDOW_MSECS / BLOCK_MSECS, NO_FLOOR),
+    _windowFloor(NO_FLOOR),
+    _currentFloor(NO_FLOOR),
+    _starveFloor(NO_FLOOR)
+{
+}
+
+int AudioJitterBuffer::write(const int16_t* input, int numFrames) {
+    return _ringBuffer.writeSamples(input, numFrames * _numChannels) / _numChannels;
+}
+
+int AudioJitterBuffer::writeSilence(int numFrames) {
+    return _ringBuffer.addSilentSamples(numFrames * _numChannels) / _numChannels;
+}
+
+int AudioJitterBuffer::peek(int16_t* output, int numFrames) const {
+    return _ringBuffer.peekSamples(output, numFrames * _numChannels) / _numChannels;
+}
+
+void AudioJitterBuffer::reset() {
+    _ringBuffer.clear();
+    _isStarved = true;
+    _hasStarted = false;
+    _shift = 0;
+    std::fill(_blockFloors.begin(), _blockFloors.end(), NO_FLOOR);
+    _blockIndex = 0;
+    _windowFloor = NO_FLOOR;
+    _currentFloor = NO_FLOOR;
+    _currentFrames = 0;
+    _starveFloor = NO_FLOOR;
+    _starveFramesLeft = 0;
+    _targetFrames.store(0, std::memory_order_relaxed);
+    _starveCount.store(0, std::memory_order_relaxed);
+    _droppedFrames.store(0, std::memory_order_relaxed);
+}
+
+void AudioJitterBuffer::updateFloor(int64_t residual, int numFrames) {
+    _currentFloor = std::min(_currentFloor, residual + _shift);
+    _currentFrames += numFrames;
+
+    _starveFramesLeft -= numFrames;
+    if (_starveFramesLeft <= 0) {
+        _starveFloor = NO_FLOOR;
+    }
+
+    if (_currentFrames >= _blockFrames) {
+        _currentFrames -= _blockFrames;
+        _blockFloors[_blockIndex] = _currentFloor;
+        _blockIndex = (_blockIndex + 1) % (int)_blockFloors.size();
+        _windowFloor = *std::min_element(_blockFloors.begin(), _blockFloors.end());
+        _currentFloor = NO_FLOOR;
+    }
+}
+
+bool AudioJitterBuffer::read(int16_t* output, int numFrames) {
+    int available = getFramesAvailable();
+    int safetyFrames = getSafetyFrames();
+    int maxStretchFrames = (numFrames > 1) ? (int)(numFrames * MAX_STRETCH) : 0;
+    int maxRescueFrames = (numFrames > 1) ? (int)(numFrames * MAX_RESCUE_STRETCH) : 0;
+
+    // start, or restart after a starve, once a read and the safety are buffered
+    if (_isStarved && available >= numFrames + safetyFrames) {
+        _isStarved = false;
+        _hasStarted = true;
+    } else if (!_isStarved && available < numFrames - maxRescueFrames) {
+        _isStarved = true;
+        _starveCount.fetch_add(1, std::memory_order_relaxed);
+
+        // hold on to what the starve needed for longer than the window
+        _starveFloor = std::min(_starveFloor, available - numFrames + _shift);
+        _starveFramesLeft = _starveHoldFrames;
+    }
+
+    if (_hasStarted) {
+        updateFloor(available - numFrames, numFrames);
+    }
+
+    if (_isStarved) {
+        memset(output, 0, numFrames * _numChannels * sizeof(int16_t));
+        // the silence is played in place of frames that are still to arrive
+        _shift -= numFrames;
+        return false;
+    }
+
+    int64_t excess = std::min(std::min(_windowFloor, _currentFloor), _starveFloor) - _shift - safetyFrames;
+
+    // shed a large excess at once, rather than over seconds of compression
+    if (excess > _maxExcessFrames) {
+        int droppedFrames = _ringBuffer.skipSamples((int)excess * _numChannels) / _numChannels;
+        _droppedFrames.fetch_add(droppedFrames, std::memory_order_relaxed);
+        _shift += droppedFrames;
+        available -= droppedFrames;
+        excess -= droppedFrames;
+    }
+
+    // compress above the safety, and expand below half of it
+    int stretchFrames = 0;
+    if (excess > 0 || 2 * excess < -safetyFrames) {
+        stretchFrames = (int)std::max(std::min(excess, (int64_t)maxStretchFrames), (int64_t)-maxStretchFrames);
+    }
+    _targetFrames.store((int)std::max(available - excess, (int64_t)0), std::memory_order_relaxed);
+
+    // and expand what there is, rather than starve, when a read comes up short
+    stretchFrames = std::min(stretchFrames, available - numFrames);
+    _shift += stretchFrames;
+
+    stretch(output, numFrames, numFrames + stretchFrames);
+    return true;
+}
+
+void AudioJitterBuffer::stretch(int16_t* output, int numFrames, int numConsumedFrames) {
+    if (numConsumedFrames == numFrames) {
+        _ringBuffer.readSamples(output, numFrames * _numChannels);
+        return;
+    }
+
+    _scratch.resize(numConsumedFrames * _numChannels);
+    _ringBuffer.readSamples(_scratch.data(), numConsumedFrames * _numChannels);
+
+    // interpolate from the first frame consumed to the last, so that consecutive reads join up
+    float step = (numConsumedFrames - 1) / (float)(numFrames - 1);
+    for (int i = 0; i < numFrames; i++) {
+        float position = i * step;
+        int j = (int)position;
+        int k = std::min(j + 1, numConsumedFrames - 1);
+        float fraction = position - j;
+
+        const int16_t* a = &_scratch[j * _numChannels];
+        const int16_t* b = &_scratch[k * _numChannels];
+        for (int ch = 0; ch < _numChannels; ch++) {
+            output[i * _numChannels + ch] = (int16_t)lrintf(a[ch] + fraction * (b[ch] - a[ch]));
+        }
+    }
+}
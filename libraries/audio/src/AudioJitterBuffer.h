@@ -0,0 +1,126 @@
+//
+//  AudioJitterBuffer.h
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioJitterBuffer_h
+#define hifi_AudioJitterBuffer_h
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+#include "AudioRingBufferSPSC.h"
+
+//
+// An adaptive jitter buffer, between a network thread that writes frames as they arrive and an audio thread that
+// reads them a device period at a time.  The samples pass through an AudioRingBufferSPSC, and everything else is
+// owned by the reader, so that neither side ever takes a lock.
+//
+// Rather than a target counted in network frames, the reader tracks the floor of the buffer: the least it held,
+// beyond what each read took, over the last WINDOW_MSECS.  While the floor is above SAFETY_MSECS the buffer holds
+// more latency than the network needs, and reads time-compress, consuming up to MAX_STRETCH more frames than they
+// output; while it is below half of it, reads time-expand.  A read that comes up short expands what there is, up to
+// MAX_RESCUE_STRETCH, and only a packet later than that starves the buffer: it is covered by silence, which raises
+// the level by what the network needed, and the floor of the starve is held for STARVE_HOLD_MSECS before the latency
+// it added is compressed away.  Stretching interpolates linearly over each read, a pitch change of at most
+// MAX_STRETCH that goes unnoticed on voice.
+//
+class AudioJitterBuffer {
+public:
+    static const float MAX_STRETCH;             // of the frames of a read, that a read adds or removes
+    static const float MAX_RESCUE_STRETCH;      // of the frames of a read, that a read short of frames adds
+    static const int SAFETY_MSECS = 4;          // of the floor to keep, over the window
+    static const int WINDOW_MSECS = 10000;      // that the floor is tracked over
+    static const int BLOCK_MSECS = 100;         // of the window, that the floor is kept of
+    static const int STARVE_HOLD_MSECS = 30000; // that the floor of a starve is held for
+    static const int MAX_EXCESS_MSECS = 200;    // of the floor over the safety, past which it is dropped at once
+    static const int DEFAULT_CAPACITY_MSECS = 1000;
+
+    AudioJitterBuffer(int numChannels, int sampleRate, int capacityMsecs = DEFAULT_CAPACITY_MSECS);
+
+    // Network thread
+
+    //
+    // Write interleaved frames, as they arrive (or are concealed).
+    // Returns the frames written; what did not fit is dropped, and counted as an overflow.
+    //
+    int write(const int16_t* input, int numFrames);
+    int writeSilence(int numFrames);
+
+    // Audio thread
+
+    //
+    // Read interleaved frames, time-stretched toward the latency that the network needs.
+    // Returns false, with silence in output, while starved.
+    //
+    bool read(int16_t* output, int numFrames);
+
+    //
+    // Copy the frames that the next read starts from, without reading them.
+    // Returns the frames copied.
+    //
+    int peek(int16_t* output, int numFrames) const;
+
+    /// Discard any frames in the buffer, and start over
+    void reset();
+
+    bool isStarved() const { return _isStarved; }
+
+    // Any thread
+
+    int getFramesAvailable() const { return _ringBuffer.samplesAvailable() / _numChannels; }
+    int getNumChannels() const { return _numChannels; }
+
+    /// Set the floor to keep, SAFETY_MSECS by default
+    void setSafetyFrames(int safetyFrames) { _safetyFrames.store(safetyFrames, std::memory_order_relaxed); }
+    int getSafetyFrames() const { return _safetyFrames.load(std::memory_order_relaxed); }
+
+    /// Return the frames that reads steer the buffer toward, as of the last read
+    int getTargetFrames() const { return _targetFrames.load(std::memory_order_relaxed); }
+
+    /// Return times the buffer ran out, since it started
+    int getStarveCount() const { return _starveCount.load(std::memory_order_relaxed); }
+    /// Return frames dropped to shed an excess of latency at once
+    int getDroppedFrames() const { return _droppedFrames.load(std::memory_order_relaxed); }
+    /// Return times a write did not fit
+    int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
+
+private:
+    void updateFloor(int64_t residual, int numFrames);
+    void stretch(int16_t* output, int numFrames, int numConsumedFrames);
+
+    AudioRingBufferSPSC<int16_t> _ringBuffer;
+    int _numChannels;
+    std::atomic<int> _safetyFrames;
+    int _maxExcessFrames;
+    int _blockFrames;
+    int _starveHoldFrames;
+
+    bool _isStarved { true };
+    bool _hasStarted { false };
+
+    // the floor is kept as the residual plus _shift, what reads took beyond what they output, so that the floor of
+    // past blocks stays comparable as stretching moves the level
+    int64_t _shift { 0 };
+    std::vector<int64_t> _blockFloors;  // of the blocks of the window
+    int _blockIndex { 0 };
+    int64_t _windowFloor;               // of the blocks before the current one
+    int64_t _currentFloor;              // of the current block
+    int _currentFrames { 0 };           // output in the current block
+    int64_t _starveFloor;               // of the last starves
+    int _starveFramesLeft { 0 };        // until the floor of the last starves is let go
+
+    std::vector<int16_t> _scratch;      // the frames consumed by a read
+
+    std::atomic<int> _targetFrames { 0 };
+    std::atomic<int> _starveCount { 0 };
+    std::atomic<int> _droppedFrames { 0 };
+};
+
+#endif // hifi_AudioJitterBuffer_h
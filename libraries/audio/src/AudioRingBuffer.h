@@ -49,7 +49,7 @@ public:
     // in cases that avoid overwriting the buffer, a single producer/consumer
     // may use this as a lock-free pipe (see audio-client/src/AudioClient.cpp).
     // IMPORTANT: Avoid changes to the implementation that touch shared data unless you can
-    // maintain this behavior.
+    // maintain this behavior.  For a pipe that never overwrites, see AudioRingBufferSPSC.
 
     /// Read up to maxSamples into destination (will only read up to samplesAvailable())
     /// Returns number of read samples
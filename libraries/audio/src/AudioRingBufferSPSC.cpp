@@ -0,0 +1,133 @@
+//
+//  AudioRingBufferSPSC.cpp
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioRingBufferSPSC.h"
+
+#include <string.h>
+#include <algorithm>
+
+template <class T>
+AudioRingBufferSPSC<T>::AudioRingBufferSPSC(int sampleCapacity) :
+    _sampleCapacity(std::max(sampleCapacity, 1))
+{
+    uint32_t bufferLength = 1;
+    while (bufferLength < (uint32_t)_sampleCapacity) {
+        bufferLength <<= 1;
+    }
+    _mask = bufferLength - 1;
+    _buffer = new Sample[bufferLength];
+    memset(_buffer, 0, bufferLength * sizeof(Sample));
+}
+
+template <class T>
+AudioRingBufferSPSC<T>::~AudioRingBufferSPSC() {
+    delete[] _buffer;
+}
+
+template <class T>
+template <typename F>
+int AudioRingBufferSPSC<T>::write(int maxSamples, F copy) {
+    uint32_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+    int space = _sampleCapacity - (int)(writeIndex - _cachedReadIndex);
+    if (space < maxSamples) {
+        // only look at the consumer's index when the last one seen is not enough
+        _cachedReadIndex = _readIndex.load(std::memory_order_acquire);
+        space = _sampleCapacity - (int)(writeIndex - _cachedReadIndex);
+    }
+
+    int numWriteSamples = std::min(maxSamples, space);
+    if (numWriteSamples < maxSamples) {
+        _overflowCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t offset = writeIndex & _mask;
+    int numSamplesToEnd = std::min(numWriteSamples, (int)(_mask + 1 - offset));
+    copy(_buffer + offset, 0, numSamplesToEnd);
+    copy(_buffer, numSamplesToEnd, numWriteSamples - numSamplesToEnd);
+
+    _writeIndex.store(writeIndex + numWriteSamples, std::memory_order_release);
+    return numWriteSamples;
+}
+
+template <class T>
+int AudioRingBufferSPSC<T>::writeSamples(const Sample* source, int maxSamples) {
+    return write(maxSamples, [source](Sample* destination, int sourceOffset, int numSamples) {
+        memcpy(destination, source + sourceOffset, numSamples * sizeof(Sample));
+    });
+}
+
+template <class T>
+int AudioRingBufferSPSC<T>::addSilentSamples(int maxSamples) {
+    return write(maxSamples, [](Sample* destination, int sourceOffset, int numSamples) {
+        memset(destination, 0, numSamples * sizeof(Sample));
+    });
+}
+
+template <class T>
+int AudioRingBufferSPSC<T>::spaceAvailable() const {
+    uint32_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+    return _sampleCapacity - (int)(writeIndex - _readIndex.load(std::memory_order_acquire));
+}
+
+template <class T>
+int AudioRingBufferSPSC<T>::peekSamples(Sample* destination, int maxSamples) const {
+    uint32_t readIndex = _readIndex.load(std::memory_order_relaxed);
+    int numReadSamples = std::min(maxSamples, samplesAvailable(readIndex, maxSamples));
+
+    uint32_t offset = readIndex & _mask;
+    int numSamplesToEnd = std::min(numReadSamples, (int)(_mask + 1 - offset));
+    memcpy(destination, _buffer + offset, numSamplesToEnd * sizeof(Sample));
+    memcpy(destination + numSamplesToEnd, _buffer, (numReadSamples - numSamplesToEnd) * sizeof(Sample));
+    return numReadSamples;
+}
+
+template <class T>
+int AudioRingBufferSPSC<T>::readSamples(Sample* destination, int maxSamples) {
+    uint32_t readIndex = _readIndex.load(std::memory_order_relaxed);
+    int numReadSamples = peekSamples(destination, maxSamples);
+    _readIndex.store(readIndex + numReadSamples, std::memory_order_release);
+    return numReadSamples;
+}
+
+template <class T>
+int AudioRingBufferSPSC<T>::skipSamples(int maxSamples) {
+    uint32_t readIndex = _readIndex.load(std::memory_order_relaxed);
+    int numSkipSamples = std::min(maxSamples, samplesAvailable(readIndex, maxSamples));
+    _readIndex.store(readIndex + numSkipSamples, std::memory_order_release);
+    return numSkipSamples;
+}
+
+template <class T>
+void AudioRingBufferSPSC<T>::clear() {
+    _cachedWriteIndex = _writeIndex.load(std::memory_order_acquire);
+    _readIndex.store(_cachedWriteIndex, std::memory_order_release);
+}
+
+template <class T>
+int AudioRingBufferSPSC<T>::samplesAvailable() const {
+    // leaves the consumer's cached index alone, so that any thread may ask
+    uint32_t readIndex = _readIndex.load(std::memory_order_acquire);
+    return (int)(_writeIndex.load(std::memory_order_acquire) - readIndex);
+}
+
+template <class T>
+int AudioRingBufferSPSC<T>::samplesAvailable(uint32_t readIndex, int numSamplesWanted) const {
+    // only look at the producer's index when the last one seen is not enough
+    int available = (int)(_cachedWriteIndex - readIndex);
+    if (available < numSamplesWanted) {
+        _cachedWriteIndex = _writeIndex.load(std::memory_order_acquire);
+        available = (int)(_cachedWriteIndex - readIndex);
+    }
+    return available;
+}
+
+// explicit instantiations for scratch/mix buffers
+template class AudioRingBufferSPSC<int16_t>;
+template class AudioRingBufferSPSC<float>;
@@ -0,0 +1,96 @@
+//
+//  AudioRingBufferSPSC.h
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioRingBufferSPSC_h
+#define hifi_AudioRingBufferSPSC_h
+
+#include <stdint.h>
+#include <atomic>
+
+//
+// A lock-free ring buffer of samples, between exactly one producer thread and one consumer thread.
+//
+// Unlike AudioRingBufferTemplate, a write never overwrites unread samples (which would move the read position
+// from under the consumer): what does not fit is dropped, and counted as an overflow.  Each side owns its index
+// and keeps a cached copy of the other one, on a cache line of its own, so that the two threads only share a
+// line when the cached index runs out.
+//
+template <class T>
+class AudioRingBufferSPSC {
+    using Sample = T;
+
+public:
+    AudioRingBufferSPSC(int sampleCapacity);
+    ~AudioRingBufferSPSC();
+
+    // disallow copying
+    AudioRingBufferSPSC(const AudioRingBufferSPSC&) = delete;
+    AudioRingBufferSPSC(AudioRingBufferSPSC&&) = delete;
+    AudioRingBufferSPSC& operator=(const AudioRingBufferSPSC&) = delete;
+
+    int getSampleCapacity() const { return _sampleCapacity; }
+
+    /// Return times a write did not fit (from any thread)
+    int getOverflowCount() const { return _overflowCount.load(std::memory_order_relaxed); }
+
+    // Producer
+
+    /// Write up to maxSamples from source (will only write up to spaceAvailable())
+    /// Returns number of written samples
+    int writeSamples(const Sample* source, int maxSamples);
+
+    /// Write up to maxSamples silent samples (will only write up to spaceAvailable())
+    /// Returns number of written samples
+    int addSilentSamples(int maxSamples);
+
+    int spaceAvailable() const;
+
+    // Consumer
+
+    /// Read up to maxSamples into destination (will only read up to samplesAvailable())
+    /// Returns number of read samples
+    int readSamples(Sample* destination, int maxSamples);
+
+    /// Copy up to maxSamples into destination, without reading them (will only copy up to samplesAvailable())
+    /// Returns number of copied samples
+    int peekSamples(Sample* destination, int maxSamples) const;
+
+    /// Skip up to maxSamples (will only skip up to samplesAvailable())
+    /// Returns number of skipped samples
+    int skipSamples(int maxSamples);
+
+    /// Discard any data in the buffer
+    void clear();
+
+    // Any thread
+
+    int samplesAvailable() const;
+
+private:
+    template <typename F>
+    int write(int maxSamples, F copy);
+    int samplesAvailable(uint32_t readIndex, int numSamplesWanted) const;
+
+    Sample* _buffer;
+    int _sampleCapacity;
+    uint32_t _mask;     // of the buffer length, the power of two above the capacity
+
+    char _producerPadding[64]; // keeps the producer and the consumer off each other's cache line
+    std::atomic<uint32_t> _writeIndex { 0 };
+    uint32_t _cachedReadIndex { 0 };
+    std::atomic<int> _overflowCount { 0 };
+
+    char _consumerPadding[64];
+    std::atomic<uint32_t> _readIndex { 0 };
+    mutable uint32_t _cachedWriteIndex { 0 };
+    char _endPadding[64];
+};
+
+#endif // hifi_AudioRingBufferSPSC_h
@@ -426,6 +426,81 @@ int AudioSRC::multirateFilter4_ref(const float* input0, const float* input1, con
     return outputFrames;
 }
 
+//
+// scalar reference version, of many streams side by side
+//
+int AudioSRCBatch::multirateFilter_ref(const float* input, float* output, int inputFrames) {
+    int outputFrames = 0;
+
+    if (_step == 0) {   // rational
+
+        int32_t i = HI32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            float* acc = &output[_stride * outputFrames];
+            memset(acc, 0, _stride * sizeof(float));
+
+            for (int j = 0; j < _numTaps; j++) {
+
+                float coef = c0[j];
+                const float* x = &input[_stride * (i + j)];
+
+                for (int k = 0; k < _stride; k++) {
+                    acc[k] += x[k] * coef;
+                }
+            }
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (HI32(_offset) < inputFrames) {
+
+            int32_t i = HI32(_offset);
+            uint32_t f = LO32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            float frac = (f & SRC_FRACMASK) * QFRAC_TO_FLOAT;
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            // interpolate the coefficients once, for all the streams
+            for (int j = 0; j < _numTaps; j++) {
+                _coefs[j] = c0[j] + frac * (c1[j] - c0[j]);
+            }
+
+            float* acc = &output[_stride * outputFrames];
+            memset(acc, 0, _stride * sizeof(float));
+
+            for (int j = 0; j < _numTaps; j++) {
+
+                float coef = _coefs[j];
+                const float* x = &input[_stride * (i + j)];
+
+                for (int k = 0; k < _stride; k++) {
+                    acc[k] += x[k] * coef;
+                }
+            }
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+
+    return outputFrames;
+}
+
 #if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
 
 //
@@ -450,6 +525,12 @@ int AudioSRC::multirateFilter4(const float* input0, const float* input1, const f
     return (this->*f)(input0, input1, input2, input3, output0, output1, output2, output3, inputFrames); // dispatch
 }
 
+int AudioSRCBatch::multirateFilter(const float* input, float* output, int inputFrames) {
+    static auto f = cpuSupportsAVX512() ? &AudioSRCBatch::multirateFilter_AVX512 : 
+                   (cpuSupportsAVX2() ? &AudioSRCBatch::multirateFilter_AVX2 : &AudioSRCBatch::multirateFilter_ref);
+    return (this->*f)(input, output, inputFrames);  // dispatch
+}
+
 #elif defined(__ARM_NEON__) || defined(__ARM_NEON)
 
 #include <arm_neon.h>
@@ -786,6 +867,15 @@ int AudioSRC::multirateFilter4(const float* input0, const float* input1, const f
 
 #endif
 
+#if !(defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
+
+// portable reference code, whose loop over the streams is left to the compiler to vectorize
+int AudioSRCBatch::multirateFilter(const float* input, float* output, int inputFrames) {
+    return multirateFilter_ref(input, output, inputFrames);
+}
+
+#endif
+
 //
 // on x86 architecture, assume that SSE2 is present
 //
@@ -1583,3 +1673,203 @@ int AudioSRC::getMaxInput(int outputFrames) {
         return (int)(((int64_t)outputFrames * _step) >> 32);
     }
 }
+
+AudioSRCBatch::AudioSRCBatch(int inputSampleRate, int outputSampleRate, const int* numChannels, int numStreams,
+                             AudioSRC::Quality quality) :
+    _src(inputSampleRate, outputSampleRate, 1, quality),
+    _numChannels(numChannels, numChannels + numStreams) {
+
+    assert(numStreams > 0);
+
+    // give each stream a lane per channel
+    int numLanes = 0;
+    for (int stream = 0; stream < numStreams; stream++) {
+        assert(_numChannels[stream] > 0);
+        assert(_numChannels[stream] <= SRC_MAX_CHANNELS);
+
+        _lanes.push_back(numLanes);
+        numLanes += _numChannels[stream];
+    }
+    _stride = (numLanes + 15) & ~15;    // SIMD16
+
+    // share the filter of the single stream
+    _polyphaseFilter = _src._polyphaseFilter;
+    _stepTable = _src._stepTable;
+    _inputBlock = _src._inputBlock;
+    _upFactor = _src._upFactor;
+    _numTaps = _src._numTaps;
+    _numHistory = _src._numHistory;
+    _step = _src._step;
+
+    // allocate buffers
+    int bufferSize = _stride * (_numHistory + _inputBlock);
+    _buffer = (float*)aligned_malloc(bufferSize * sizeof(float), 64);           // SIMD16
+    memset(_buffer, 0, bufferSize * sizeof(float));
+
+    _output = (float*)aligned_malloc(_stride * SRC_BLOCK * sizeof(float), 64);  // SIMD16
+    _coefs = (float*)aligned_malloc(_numTaps * sizeof(float), 64);              // SIMD16
+
+    // reset the state
+    _offset = 0;
+    _phase = 0;
+}
+
+AudioSRCBatch::~AudioSRCBatch() {
+    aligned_free(_buffer);
+    aligned_free(_output);
+    aligned_free(_coefs);
+}
+
+void AudioSRCBatch::clearStream(int stream) {
+    assert(stream >= 0 && stream < getNumStreams());
+
+    for (int i = 0; i < _numHistory; i++) {
+        memset(&_buffer[_stride * i + _lanes[stream]], 0, _numChannels[stream] * sizeof(float));
+    }
+}
+
+// convert int16_t to float, and spread each stream into its lanes
+void AudioSRCBatch::convertInput(const int16_t* const* inputs, int offset, int numFrames) {
+    const float scale = 1/32768.0f;
+
+    for (int stream = 0; stream < getNumStreams(); stream++) {
+
+        int numChannels = _numChannels[stream];
+        float* lanes = &_buffer[_stride * _numHistory + _lanes[stream]];
+
+        if (inputs[stream]) {
+            const int16_t* input = inputs[stream] + numChannels * offset;
+            for (int i = 0; i < numFrames; i++) {
+                for (int ch = 0; ch < numChannels; ch++) {
+                    lanes[_stride * i + ch] = (float)input[numChannels * i + ch] * scale;
+                }
+            }
+        } else {
+            for (int i = 0; i < numFrames; i++) {
+                memset(&lanes[_stride * i], 0, numChannels * sizeof(float));
+            }
+        }
+    }
+}
+
+// fast TPDF dither in [-1.0f, 1.0f]
+static inline float batchDither() {
+    static uint32_t rz = 0;
+    rz = rz * 69069 + 1;
+    int32_t r0 = rz & 0xffff;
+    int32_t r1 = rz >> 16;
+    return (r0 - r1) * (1/65536.0f);
+}
+
+// convert float to int16_t with dither, and gather each stream from its lanes
+void AudioSRCBatch::convertOutput(int16_t** outputs, int offset, int numFrames) {
+    const float scale = 32768.0f;
+
+    for (int stream = 0; stream < getNumStreams(); stream++) {
+
+        if (!outputs[stream]) {
+            continue;
+        }
+
+        int numChannels = _numChannels[stream];
+        const float* lanes = &_output[_lanes[stream]];
+        int16_t* output = outputs[stream] + numChannels * offset;
+
+        for (int i = 0; i < numFrames; i++) {
+
+            float d = batchDither();
+
+            for (int ch = 0; ch < numChannels; ch++) {
+
+                float f = lanes[_stride * i + ch] * scale + d;
+
+                // round and saturate
+                f += (f < 0.0f ? -0.5f : +0.5f);
+                f = MAX(MIN(f, 32767.0f), -32768.0f);
+
+                output[numChannels * i + ch] = (int16_t)f;
+            }
+        }
+    }
+}
+
+// spread each stream into its lanes
+void AudioSRCBatch::convertInput(const float* const* inputs, int offset, int numFrames) {
+
+    for (int stream = 0; stream < getNumStreams(); stream++) {
+
+        int numChannels = _numChannels[stream];
+        float* lanes = &_buffer[_stride * _numHistory + _lanes[stream]];
+
+        if (inputs[stream]) {
+            const float* input = inputs[stream] + numChannels * offset;
+            for (int i = 0; i < numFrames; i++) {
+                memcpy(&lanes[_stride * i], &input[numChannels * i], numChannels * sizeof(float));
+            }
+        } else {
+            for (int i = 0; i < numFrames; i++) {
+                memset(&lanes[_stride * i], 0, numChannels * sizeof(float));
+            }
+        }
+    }
+}
+
+// gather each stream from its lanes
+void AudioSRCBatch::convertOutput(float** outputs, int offset, int numFrames) {
+
+    for (int stream = 0; stream < getNumStreams(); stream++) {
+
+        if (!outputs[stream]) {
+            continue;
+        }
+
+        int numChannels = _numChannels[stream];
+        const float* lanes = &_output[_lanes[stream]];
+        float* output = outputs[stream] + numChannels * offset;
+
+        for (int i = 0; i < numFrames; i++) {
+            memcpy(&output[numChannels * i], &lanes[_stride * i], numChannels * sizeof(float));
+        }
+    }
+}
+
+template <typename T>
+int AudioSRCBatch::renderBlocks(const T* const* inputs, T** outputs, int inputFrames) {
+    int inputOffset = 0;
+    int outputFrames = 0;
+
+    while (inputFrames) {
+        int ni = MIN(inputFrames, _inputBlock);
+
+        // fill the buffer after the history
+        convertInput(inputs, inputOffset, ni);
+
+        int no = multirateFilter(_buffer, _output, ni);
+        assert(no <= SRC_BLOCK);
+
+        convertOutput(outputs, outputFrames, no);
+
+        // shift the history
+        memmove(_buffer, &_buffer[_stride * ni], _stride * _numHistory * sizeof(float));
+
+        inputOffset += ni;
+        inputFrames -= ni;
+        outputFrames += no;
+    }
+
+    return outputFrames;
+}
+
+//
+// This version handles input/output as interleaved int16_t, per stream
+//
+int AudioSRCBatch::render(const int16_t* const* inputs, int16_t** outputs, int inputFrames) {
+    return renderBlocks(inputs, outputs, inputFrames);
+}
+
+//
+// This version handles input/output as interleaved float, per stream
+//
+int AudioSRCBatch::render(const float* const* inputs, float** outputs, int inputFrames) {
+    return renderBlocks(inputs, outputs, inputFrames);
+}
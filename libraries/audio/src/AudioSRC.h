@@ -13,6 +13,7 @@
 #define hifi_AudioSRC_h
 
 #include <stdint.h>
+#include <vector>
 
 static const int SRC_MAX_CHANNELS = 4;
 
@@ -55,6 +56,8 @@ public:
     int getMaxInput(int outputFrames);
 
 private:
+    friend class AudioSRCBatch;
+
     float* _polyphaseFilter;
     int* _stepTable;
 
@@ -101,4 +104,72 @@ private:
     void convertOutput(float** inputs, float* output, int numFrames);
 };
 
+//
+// Resamples many streams that share a sample rate conversion, such as injected sounds, in one pass.
+//
+// The streams share the filter and the phase of a single AudioSRC, and are kept side by side as the lanes of
+// one buffer, so that each filter coefficient is computed once and applied to every stream by a single SIMD
+// multiply-add.  Mono and stereo streams can be mixed, and streams are rendered in lockstep: a stream whose input
+// is null renders silence, and clearStream() readies its slot for a new sound.
+//
+class AudioSRCBatch {
+
+public:
+    AudioSRCBatch(int inputSampleRate, int outputSampleRate, const int* numChannels, int numStreams,
+                  AudioSRC::Quality quality = AudioSRC::MEDIUM_QUALITY);
+    ~AudioSRCBatch();
+
+    // interleaved int16_t input/output, per stream
+    int render(const int16_t* const* inputs, int16_t** outputs, int inputFrames);
+
+    // interleaved float input/output, per stream
+    int render(const float* const* inputs, float** outputs, int inputFrames);
+
+    // discard the history of a stream
+    void clearStream(int stream);
+
+    int getNumStreams() const { return (int)_numChannels.size(); }
+
+    int getMinOutput(int inputFrames) { return _src.getMinOutput(inputFrames); }
+    int getMaxOutput(int inputFrames) { return _src.getMaxOutput(inputFrames); }
+    int getMinInput(int outputFrames) { return _src.getMinInput(outputFrames); }
+    int getMaxInput(int outputFrames) { return _src.getMaxInput(outputFrames); }
+
+private:
+    AudioSRC _src;  // of the shared filter
+
+    std::vector<int> _numChannels;  // of each stream
+    std::vector<int> _lanes;        // of the first channel of each stream
+    int _stride;                    // of a frame of lanes, padded to SIMD16
+
+    float* _buffer;     // history, then input, as frames of lanes
+    float* _output;     // as frames of lanes
+    float* _coefs;      // interpolated, of an irrational output frame
+
+    const float* _polyphaseFilter;
+    const int* _stepTable;
+    int _inputBlock;
+    int _upFactor;
+    int _numTaps;
+    int _numHistory;
+
+    int _phase;
+    int64_t _offset;
+    int64_t _step;
+
+    template <typename T>
+    int renderBlocks(const T* const* inputs, T** outputs, int inputFrames);
+
+    int multirateFilter(const float* input, float* output, int inputFrames);
+    int multirateFilter_ref(const float* input, float* output, int inputFrames);
+    int multirateFilter_AVX2(const float* input, float* output, int inputFrames);
+    int multirateFilter_AVX512(const float* input, float* output, int inputFrames);
+
+    void convertInput(const int16_t* const* inputs, int offset, int numFrames);
+    void convertOutput(int16_t** outputs, int offset, int numFrames);
+
+    void convertInput(const float* const* inputs, int offset, int numFrames);
+    void convertOutput(float** outputs, int offset, int numFrames);
+};
+
 #endif // AudioSRC_h
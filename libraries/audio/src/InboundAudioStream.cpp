@@ -29,39 +29,43 @@ const int InboundAudioStream::WINDOW_SECONDS_FOR_DESIRED_REDUCTION = 10;
 const bool InboundAudioStream::USE_STDEV_FOR_JITTER = false;
 const bool InboundAudioStream::REPETITION_WITH_FADE = true;
 
-static const int STARVE_HISTORY_CAPACITY = 50;
-
 // This is called 1x/s, and we want it to log the last 5s
 static const int UNPLAYED_MS_WINDOW_SECS = 5;
 
-// This adds some number of frames to the desired jitter buffer frames target we use when we're dropping frames.
+// This adds some number of frames to the desired jitter buffer frames target we use when we're dropping silent frames.
 // The larger this value is, the less frames we drop when attempting to reduce the jitter buffer length.
-// Setting this to 0 will try to get the jitter buffer to be exactly _desiredJitterBufferFrames when dropping frames,
+// Setting this to 0 will try to get the jitter buffer to be exactly what it needs when dropping frames,
 // which could lead to a starve soon after.
 static const int DESIRED_JITTER_BUFFER_FRAMES_PADDING = 1;
 
-// this controls the length of the window for stats used in the stats packet (not the stats used in
-// _desiredJitterBufferFrames calculation)
+// this controls the length of the window for stats used in the stats packet
 static const int STATS_FOR_STATS_PACKET_WINDOW_SECONDS = 30;
 
 // this controls the window size of the time-weighted avg of frames available.  Every time the window fills up,
-// _currentJitterBufferFrames is updated with the time-weighted avg and the running time-weighted avg is reset.
+// the running time-weighted avg is reset.
 static const quint64 FRAMES_AVAILABLE_STAT_WINDOW_USECS = 10 * USECS_PER_SECOND;
 
+// the frames that a pop can take at once, into the buffer of what was popped last
+static const int MAX_POPPED_FRAMES = 10;
+
 // When the audio codec is switched, temporary codec mismatch is expected due to packets in-flight.
 // A SelectedAudioFormat packet is not sent until this threshold is exceeded.
 static const int MAX_MISMATCHED_AUDIO_CODEC_COUNT = 10;
 
 InboundAudioStream::InboundAudioStream(int numChannels, int numFrames, int numBlocks, int numStaticJitterBlocks) :
-    _ringBuffer(numChannels * numFrames, numBlocks),
+    _jitterBuffer(new AudioJitterBuffer(numChannels, AudioConstants::SAMPLE_RATE,
+                                        (int)(numBlocks * AudioConstants::NETWORK_FRAME_MSECS))),
+    _jitterBufferCapacityMsecs((int)(numBlocks * AudioConstants::NETWORK_FRAME_MSECS)),
+    _frameCapacity(numBlocks),
+    _ringBuffer(numChannels * numFrames, MAX_POPPED_FRAMES),
     _numChannels(numChannels),
     _dynamicJitterBufferEnabled(numStaticJitterBlocks == -1),
     _staticJitterBufferFrames(std::max(numStaticJitterBlocks, DEFAULT_STATIC_JITTER_FRAMES)),
-    _desiredJitterBufferFrames(_dynamicJitterBufferEnabled ? 1 : _staticJitterBufferFrames),
     _incomingSequenceNumberStats(STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
-    _starveHistory(STARVE_HISTORY_CAPACITY),
     _unplayedMs(0, UNPLAYED_MS_WINDOW_SECS),
-    _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS) {}
+    _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS) {
+    updateSafetyFrames();
+}
 
 InboundAudioStream::~InboundAudioStream() {
     cleanupCodec();
@@ -69,9 +73,9 @@ InboundAudioStream::~InboundAudioStream() {
 
 void InboundAudioStream::reset() {
     _ringBuffer.reset();
+    resetJitterBuffer();
     _lastPopSucceeded = false;
     _lastPopOutput = AudioRingBuffer::ConstIterator();
-    _isStarved = true;
     _hasStarted = false;
     resetStats();
     // FIXME: calling cleanupCodec() seems to be the cause of the buzzsaw -- we get an assert
@@ -80,28 +84,52 @@ void InboundAudioStream::reset() {
 }
 
 void InboundAudioStream::resetStats() {
-    if (_dynamicJitterBufferEnabled) {
-        _desiredJitterBufferFrames = 1;
-    }
     _consecutiveNotMixedCount = 0;
     _starveCount = 0;
     _silentFramesDropped = 0;
-    _oldFramesDropped = 0;
+    _oldSamplesDropped = 0;
     _incomingSequenceNumberStats.reset();
     _lastPacketReceivedTime = 0;
-    _timeGapStatsForDesiredCalcOnTooManyStarves.reset();
-    _timeGapStatsForDesiredReduction.reset();
-    _starveHistory.clear();
     _framesAvailableStat.reset();
-    _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
     _unplayedMs.reset();
 }
 
 void InboundAudioStream::clearBuffer() {
-    _ringBuffer.clear();
+    resetJitterBuffer();
     _framesAvailableStat.reset();
-    _currentJitterBufferFrames = 0;
+}
+
+void InboundAudioStream::resetJitterBuffer() {
+    _jitterBuffer->reset();
+    _jitterBufferStarveCount = 0;
+    _jitterBufferDroppedFrames = 0;
+}
+
+void InboundAudioStream::resizeForFrameSize(int numFrameSamples, int numChannels, int sampleRate) {
+    _ringBuffer.resizeForFrameSize(numFrameSamples);
+    _lastPopOutput = AudioRingBuffer::ConstIterator();
+    _numChannels = numChannels;
+    _sampleRate = sampleRate;
+
+    // what was buffered is in the previous format, so the jitter buffer starts over
+    _jitterBuffer.reset(new AudioJitterBuffer(numChannels, sampleRate, _jitterBufferCapacityMsecs));
+    _jitterBufferStarveCount = 0;
+    _jitterBufferDroppedFrames = 0;
+    updateSafetyFrames();
+}
+
+int InboundAudioStream::writeData(const char* data, int numBytes) {
+    int numFrames = numBytes / (int)(sizeof(int16_t) * _numChannels);
+    return _jitterBuffer->write(reinterpret_cast<const int16_t*>(data), numFrames) * _numChannels * (int)sizeof(int16_t);
+}
+
+int InboundAudioStream::addSilentSamples(int numSamples) {
+    return _jitterBuffer->writeSilence(numSamples / _numChannels) * _numChannels;
+}
+
+int InboundAudioStream::peekSamples(int16_t* samples, int maxSamples) const {
+    return _jitterBuffer->peek(samples, maxSamples / _numChannels) * _numChannels;
 }
 
 void InboundAudioStream::setReverb(float reverbTime, float wetLevel) {
@@ -112,8 +140,6 @@ void InboundAudioStream::setReverb(float reverbTime, float wetLevel) {
 
 void InboundAudioStream::perSecondCallbackForUpdatingStats() {
     _incomingSequenceNumberStats.pushStatsToHistory();
-    _timeGapStatsForDesiredCalcOnTooManyStarves.currentIntervalComplete();
-    _timeGapStatsForDesiredReduction.currentIntervalComplete();
     _timeGapStatsForStatsPacket.currentIntervalComplete();
     _unplayedMs.currentIntervalComplete();
 }
@@ -176,7 +202,7 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
                     if (packetPCM) {
                         // If there are PCM packets in-flight after the codec is changed, use them.
                         auto afterProperties = message.readWithoutCopy(message.getBytesLeftToRead());
-                        _ringBuffer.writeData(afterProperties.data(), afterProperties.size());
+                        writeData(afterProperties.data(), afterProperties.size());
                     } else {
                         // Since the data in the stream is using a codec that we aren't prepared for,
                         // we need to let the codec know that we don't have data for it, this will
@@ -206,28 +232,7 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
         }
     }
 
-    int framesAvailable = _ringBuffer.framesAvailable();
-    // if this stream was starved, check if we're still starved.
-    if (_isStarved && framesAvailable >= _desiredJitterBufferFrames) {
-        _isStarved = false;
-    }
-    // if the ringbuffer exceeds the desired size by more than the threshold specified,
-    // drop the oldest frames so the ringbuffer is down to the desired size.
-    if (framesAvailable > _desiredJitterBufferFrames + MAX_FRAMES_OVER_DESIRED) {
-        int framesToDrop = framesAvailable - (_desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING);
-        _ringBuffer.shiftReadPosition(framesToDrop * _ringBuffer.getNumFrameSamples());
-
-        _framesAvailableStat.reset();
-        _currentJitterBufferFrames = 0;
-
-        _oldFramesDropped += framesToDrop;
-
-        qCInfo(audiostream, "Dropped %d frames", framesToDrop);
-        qCInfo(audiostream, "Reset current jitter frames");
-    }
-
-    framesAvailableChanged();
-
+    // the jitter buffer refills after a starve, and sheds an excess of latency, as it is read
     return message.getPosition();
 }
 
@@ -262,7 +267,7 @@ int InboundAudioStream::lostAudioData(int numPackets) {
             decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL * _numChannels);
             memset(decodedBuffer.data(), 0, decodedBuffer.size());
         }
-        _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size());
+        writeData(decodedBuffer.data(), decodedBuffer.size());
     }
     return 0;
 }
@@ -281,7 +286,7 @@ int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packet
         decodedBuffer = packetAfterStreamProperties;
     }
     auto actualSize = decodedBuffer.size();
-    return _ringBuffer.writeData(decodedBuffer.data(), actualSize);
+    return writeData(decodedBuffer.data(), actualSize);
 }
 
 int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -315,79 +320,74 @@ int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
     // calculate how many silent frames we should drop.
     int silentSamples = silentFrames * _numChannels;
     int samplesPerFrame = _ringBuffer.getNumFrameSamples();
-    int desiredJitterBufferFramesPlusPadding = _desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING;
+    int desiredJitterBufferFramesPlusPadding = getDesiredJitterBufferFrames() + DESIRED_JITTER_BUFFER_FRAMES_PADDING;
+    int framesAvailable = getFramesAvailable();
     int numSilentFramesToDrop = 0;
 
-    if (silentSamples >= samplesPerFrame && _currentJitterBufferFrames > desiredJitterBufferFramesPlusPadding) {
+    if (silentSamples >= samplesPerFrame && framesAvailable > desiredJitterBufferFramesPlusPadding) {
 
-        // our avg jitter buffer size exceeds its desired value, so ignore some silent
-        // frames to get that size as close to desired as possible
-        int numSilentFramesToDropDesired = _currentJitterBufferFrames - desiredJitterBufferFramesPlusPadding;
+        // the jitter buffer holds more than it needs, so ignore some silent frames rather than
+        // compress the excess away over the next seconds
+        int numSilentFramesToDropDesired = framesAvailable - desiredJitterBufferFramesPlusPadding;
         int numSilentFramesReceived = silentSamples / samplesPerFrame;
         numSilentFramesToDrop = std::min(numSilentFramesToDropDesired, numSilentFramesReceived);
 
-        // dont reset _currentJitterBufferFrames here; we want to be able to drop further silent frames
-        // without waiting for _framesAvailableStat to fill up to 10s of samples.
-        _currentJitterBufferFrames -= numSilentFramesToDrop;
         _silentFramesDropped += numSilentFramesToDrop;
 
         qCInfo(audiostream, "Dropped %d silent frames", numSilentFramesToDrop);
-        qCInfo(audiostream, "Set current jitter frames to %d (dropped)", _currentJitterBufferFrames);
-
-        _framesAvailableStat.reset();
     }
 
-    int ret = _ringBuffer.addSilentSamples(silentSamples - numSilentFramesToDrop * samplesPerFrame);
-    
-    return ret;
+    return addSilentSamples(silentSamples - numSilentFramesToDrop * samplesPerFrame);
 }
 
 int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
-    int samplesPopped = 0;
-    int samplesAvailable = _ringBuffer.samplesAvailable();
-    if (_isStarved) {
-        // we're still refilling; don't pop
+    // the jitter buffer stretches a read that comes up short rather than returning part of it, so a pop is all or
+    // nothing either way
+    Q_UNUSED(allOrNothing);
+
+    int numFrameSamples = _ringBuffer.getNumFrameSamples();
+    int numFrames = std::min(maxSamples, MAX_POPPED_FRAMES * numFrameSamples) / _numChannels;
+    if (numFrames == 0) {
+        return 0;
+    }
+    int samplesPopped = numFrames * _numChannels;
+
+    float unplayedMs = (getSamplesAvailable() / (float)numFrameSamples) * AudioConstants::NETWORK_FRAME_MSECS;
+    _unplayedMs.update(unplayedMs);
+
+    _popBuffer.resize(samplesPopped);
+    bool popped = _jitterBuffer->read(_popBuffer.data(), numFrames);
+
+    // count what the jitter buffer did in this read
+    int starveCount = _jitterBuffer->getStarveCount();
+    if (starveCount != _jitterBufferStarveCount) {
+        _starveCount += starveCount - _jitterBufferStarveCount;
+        _jitterBufferStarveCount = starveCount;
+        _consecutiveNotMixedCount = 0;
+    }
+    int droppedFrames = _jitterBuffer->getDroppedFrames();
+    if (droppedFrames != _jitterBufferDroppedFrames) {
+        int numDroppedSamples = (droppedFrames - _jitterBufferDroppedFrames) * _numChannels;
+        _oldSamplesDropped += numDroppedSamples;
+        _jitterBufferDroppedFrames = droppedFrames;
+        qCInfo(audiostream, "Dropped %d samples", numDroppedSamples);
+    }
+
+    framesAvailableChanged();
+
+    if (!popped) {
+        // we're still refilling; use the last pop, which the mixer repeats with a fade
         _consecutiveNotMixedCount++;
         _lastPopSucceeded = false;
-    } else {
-        if (samplesAvailable >= maxSamples) {
-            // we have enough samples to pop, so we're good to pop
-            popSamplesNoCheck(maxSamples);
-            samplesPopped = maxSamples;
-        } else if (!allOrNothing && samplesAvailable > 0) {
-            // we don't have the requested number of samples, but we do have some
-            // samples available, so pop all those (except in all-or-nothing mode)
-            popSamplesNoCheck(samplesAvailable);
-            samplesPopped = samplesAvailable;
-        } else {
-            // we can't pop any samples, set this stream to starved for jitter 
-            // buffer calculations.
-            setToStarved();
-            _consecutiveNotMixedCount++;
-
-            // use PLC to generate extrapolated audio data, to reduce clicking
-            if (allOrNothing) {
-                int samplesNeeded = maxSamples - samplesAvailable;
-                int packetsNeeded = (samplesNeeded + _ringBuffer.getNumFrameSamples() - 1) / _ringBuffer.getNumFrameSamples();
-                lostAudioData(packetsNeeded);
-            } else {
-                lostAudioData(1);
-            }
-            samplesAvailable = _ringBuffer.samplesAvailable();
-
-            if (samplesAvailable > 0) {
-                samplesPopped = std::min(samplesAvailable, maxSamples);
-                popSamplesNoCheck(samplesPopped);
-            } else {
-                // No samples available means a packet is currently being
-                // processed, so we don't generate lost audio data, and instead
-                // just wait for the packet to come in.  This prevents locking
-                // the real-time audio thread at the cost of a potential (but rare)
-                // 'click'
-                _lastPopSucceeded = false;
-            }
-        }
+        return 0;
     }
+
+    _ringBuffer.writeSamples(_popBuffer.data(), samplesPopped);
+    _lastPopOutput = _ringBuffer.nextOutput();
+    _ringBuffer.shiftReadPosition(samplesPopped);
+
+    _hasStarted = true;
+    _lastPopSucceeded = true;
     return samplesPopped;
 }
 
@@ -397,126 +397,47 @@ int InboundAudioStream::popFrames(int maxFrames, bool allOrNothing) {
     return samplesPopped / numFrameSamples;
 }
 
-void InboundAudioStream::popSamplesNoCheck(int samples) {
-    float unplayedMs = (_ringBuffer.samplesAvailable() / (float)_ringBuffer.getNumFrameSamples()) * AudioConstants::NETWORK_FRAME_MSECS;
-    _unplayedMs.update(unplayedMs);
-
-    _lastPopOutput = _ringBuffer.nextOutput();
-    _ringBuffer.shiftReadPosition(samples);
-    framesAvailableChanged();
-
-    _hasStarted = true;
-    _lastPopSucceeded = true;
-}
-
 void InboundAudioStream::framesAvailableChanged() {
-    _framesAvailableStat.updateWithSample(_ringBuffer.framesAvailable());
+    _framesAvailableStat.updateWithSample(getFramesAvailable());
 
     if (_framesAvailableStat.getElapsedUsecs() >= FRAMES_AVAILABLE_STAT_WINDOW_USECS) {
-        _currentJitterBufferFrames = (int)ceil(_framesAvailableStat.getAverage());
-        qCInfo(audiostream, "Set current jitter frames to %d (changed)", _currentJitterBufferFrames);
-
         _framesAvailableStat.reset();
     }
 }
 
-void InboundAudioStream::setToStarved() {
-    _consecutiveNotMixedCount = 0;
-    _starveCount++;
-    // if we have more than the desired frames when setToStarved() is called, then we'll immediately
-    // be considered refilled. in that case, there's no need to set _isStarved to true.
-    _isStarved = (_ringBuffer.framesAvailable() < _desiredJitterBufferFrames);
-
-    // record the time of this starve in the starve history
-    quint64 now = usecTimestampNow();
-    _starveHistory.insert(now);
+int InboundAudioStream::getDesiredJitterBufferFrames() const {
+    int numFrameSamples = getNumFrameSamples();
+    int desiredSamples = _jitterBuffer->getTargetFrames() * _jitterBuffer->getNumChannels();
+    return (desiredSamples + numFrameSamples - 1) / numFrameSamples;
+}
 
+void InboundAudioStream::updateSafetyFrames() {
     if (_dynamicJitterBufferEnabled) {
-        // dynamic jitter buffers are enabled. check if this starve put us over the window
-        // starve threshold
-        quint64 windowEnd = now - WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES * USECS_PER_SECOND;
-        RingBufferHistory<quint64>::Iterator starvesIterator = _starveHistory.begin();
-        RingBufferHistory<quint64>::Iterator end = _starveHistory.end();
-        int starvesInWindow = 1;
-        do {
-            ++starvesIterator;
-            if (*starvesIterator < windowEnd) {
-                break;
-            }
-            starvesInWindow++;
-        } while (starvesIterator != end);
-
-        // this starve put us over the starve threshold. update _desiredJitterBufferFrames to
-        // value determined by window A.
-        if (starvesInWindow >= WINDOW_STARVE_THRESHOLD) {
-            int calculatedJitterBufferFrames;
-            // we don't know when the next packet will arrive, so it's possible the gap between the last packet and the
-            // next packet will exceed the max time gap in the window.  If the time since the last packet has already exceeded
-            // the window max gap, then we should use that value to calculate desired frames.
-            int framesSinceLastPacket = ceilf((float)(now - _lastPacketReceivedTime)
-                                              / (float)AudioConstants::NETWORK_FRAME_USECS);
-            calculatedJitterBufferFrames = std::max(_calculatedJitterBufferFrames, framesSinceLastPacket);
-            // make sure _desiredJitterBufferFrames does not become lower here
-            if (calculatedJitterBufferFrames >= _desiredJitterBufferFrames) {
-                _desiredJitterBufferFrames = calculatedJitterBufferFrames;
-                qCInfo(audiostream, "Set desired jitter frames to %d (starved)", _desiredJitterBufferFrames);
-            }
-        }
+        _jitterBuffer->setSafetyFrames((int)(AudioJitterBuffer::SAFETY_MSECS * _sampleRate / MSECS_PER_SECOND));
+    } else {
+        _jitterBuffer->setSafetyFrames(_staticJitterBufferFrames * getNumFrameSamples() / _numChannels);
     }
 }
 
 void InboundAudioStream::setDynamicJitterBufferEnabled(bool enable) {
-    if (!enable) {
-        _desiredJitterBufferFrames = _staticJitterBufferFrames;
-    } else {
-        if (!_dynamicJitterBufferEnabled) {
-            // if we're enabling dynamic jitter buffer frames, start desired frames at 1
-            _desiredJitterBufferFrames = 1;
-        }
-    }
     _dynamicJitterBufferEnabled = enable;
+    updateSafetyFrames();
 }
 
 void InboundAudioStream::setStaticJitterBufferFrames(int staticJitterBufferFrames) {
     _staticJitterBufferFrames = staticJitterBufferFrames;
-    if (!_dynamicJitterBufferEnabled) {
-        _desiredJitterBufferFrames = _staticJitterBufferFrames;
-    }
+    updateSafetyFrames();
 }
 
 void InboundAudioStream::packetReceivedUpdateTimingStats() {
     
-    // update our timegap stats and desired jitter buffer frames if necessary
+    // update our timegap stats
     // discard the first few packets we receive since they usually have gaps that aren't represensative of normal jitter
     const quint32 NUM_INITIAL_PACKETS_DISCARD = 1000; // 10s
     quint64 now = usecTimestampNow();
     if (_incomingSequenceNumberStats.getReceived() > NUM_INITIAL_PACKETS_DISCARD) {
         quint64 gap = now - _lastPacketReceivedTime;
         _timeGapStatsForStatsPacket.update(gap);
-
-        // update all stats used for desired frames calculations under dynamic jitter buffer mode
-        _timeGapStatsForDesiredCalcOnTooManyStarves.update(gap);
-        _timeGapStatsForDesiredReduction.update(gap);
-
-        if (_timeGapStatsForDesiredCalcOnTooManyStarves.getNewStatsAvailableFlag()) {
-            _calculatedJitterBufferFrames = ceilf((float)_timeGapStatsForDesiredCalcOnTooManyStarves.getWindowMax()
-                                                             / (float) AudioConstants::NETWORK_FRAME_USECS);
-            _timeGapStatsForDesiredCalcOnTooManyStarves.clearNewStatsAvailableFlag();
-        }
-
-        if (_dynamicJitterBufferEnabled) {
-            // if the max gap in window B (_timeGapStatsForDesiredReduction) corresponds to a smaller number of frames than _desiredJitterBufferFrames,
-            // then reduce _desiredJitterBufferFrames to that number of frames.
-            if (_timeGapStatsForDesiredReduction.getNewStatsAvailableFlag() && _timeGapStatsForDesiredReduction.isWindowFilled()) {
-                int calculatedJitterBufferFrames = ceilf((float)_timeGapStatsForDesiredReduction.getWindowMax()
-                                                         / (float)AudioConstants::NETWORK_FRAME_USECS);
-                if (calculatedJitterBufferFrames < _desiredJitterBufferFrames) {
-                    _desiredJitterBufferFrames = calculatedJitterBufferFrames;
-                    qCInfo(audiostream, "Set desired jitter frames to %d (reduced)", _desiredJitterBufferFrames);
-                }
-                _timeGapStatsForDesiredReduction.clearNewStatsAvailableFlag();
-            }
-        }
     }
 
     _lastPacketReceivedTime = now;
@@ -532,14 +453,15 @@ AudioStreamStats InboundAudioStream::getAudioStreamStats() const {
     streamStats._timeGapWindowMax = _timeGapStatsForStatsPacket.getWindowMax();
     streamStats._timeGapWindowAverage = _timeGapStatsForStatsPacket.getWindowAverage();
 
-    streamStats._framesAvailable = _ringBuffer.framesAvailable();
+    streamStats._framesAvailable = getFramesAvailable();
     streamStats._framesAvailableAverage = _framesAvailableStat.getAverage();
     streamStats._unplayedMs = (quint16)_unplayedMs.getWindowMax();
-    streamStats._desiredJitterBufferFrames = _desiredJitterBufferFrames;
+    streamStats._desiredJitterBufferFrames = getDesiredJitterBufferFrames();
     streamStats._starveCount = _starveCount;
     streamStats._consecutiveNotMixedCount = _consecutiveNotMixedCount;
-    streamStats._overflowCount = _ringBuffer.getOverflowCount();
-    streamStats._framesDropped = _silentFramesDropped + _oldFramesDropped;    // TODO: add separate stat for old frames dropped
+    streamStats._overflowCount = getOverflowCount();
+    // TODO: add separate stat for old frames dropped
+    streamStats._framesDropped = _silentFramesDropped + _oldSamplesDropped / getNumFrameSamples();
 
     streamStats._packetStreamStats = _incomingSequenceNumberStats.getStats();
     streamStats._packetStreamWindowStats = _incomingSequenceNumberStats.getStatsForHistoryWindow();
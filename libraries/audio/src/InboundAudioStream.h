@@ -21,6 +21,10 @@
 
 #include <plugins/CodecPlugin.h>
 
+#include <memory>
+#include <vector>
+
+#include "AudioJitterBuffer.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
@@ -39,7 +43,7 @@ public:
     // settings
     static const bool DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED;
     static const int DEFAULT_STATIC_JITTER_FRAMES;
-    // legacy (now static) settings
+    // legacy settings, replaced by the AudioJitterBuffer and only kept for their deprecation notices
     static const int MAX_FRAMES_OVER_DESIRED;
     static const int WINDOW_STARVE_THRESHOLD;
     static const int WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES;
@@ -66,33 +70,32 @@ public:
 
     quint64 usecsSinceLastPacket() { return usecTimestampNow() - _lastPacketReceivedTime; }
 
-    void setToStarved();
-
+    /// a static jitter buffer keeps at least its static frames buffered, and a dynamic one a few msecs
     void setDynamicJitterBufferEnabled(bool enable);
     void setStaticJitterBufferFrames(int staticJitterBufferFrames);
 
     virtual AudioStreamStats getAudioStreamStats() const;
 
-    /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
-    int getCalculatedJitterBufferFrames() const { return _calculatedJitterBufferFrames; }
-    
+    /// returns the frames that the jitter buffer needs, as of its last read
+    int getCalculatedJitterBufferFrames() const { return getDesiredJitterBufferFrames(); }
+
     bool dynamicJitterBufferEnabled() const { return _dynamicJitterBufferEnabled; }
     int getStaticJitterBufferFrames() { return _staticJitterBufferFrames; }
-    int getDesiredJitterBufferFrames() { return _desiredJitterBufferFrames; }
+    int getDesiredJitterBufferFrames() const;
 
     int getNumFrameSamples() const { return _ringBuffer.getNumFrameSamples(); }
-    int getFrameCapacity() const { return _ringBuffer.getFrameCapacity(); }
-    int getFramesAvailable() const { return _ringBuffer.framesAvailable(); }
+    int getFrameCapacity() const { return _frameCapacity; }
+    int getFramesAvailable() const { return getSamplesAvailable() / getNumFrameSamples(); }
     double getFramesAvailableAverage() const { return _framesAvailableStat.getAverage(); }
-    int getSamplesAvailable() const { return _ringBuffer.samplesAvailable(); }
+    int getSamplesAvailable() const { return _jitterBuffer->getFramesAvailable() * _jitterBuffer->getNumChannels(); }
 
-    bool isStarved() const { return _isStarved; }
+    bool isStarved() const { return _jitterBuffer->isStarved(); }
     bool hasStarted() const { return _hasStarted; }
 
     int getConsecutiveNotMixedCount() const { return _consecutiveNotMixedCount; }
     int getStarveCount() const { return _starveCount; }
     int getSilentFramesDropped() const { return _silentFramesDropped; }
-    int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
+    int getOverflowCount() const { return _jitterBuffer->getOverflowCount(); }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
     
@@ -109,15 +112,15 @@ signals:
     void mismatchedAudioCodec(SharedNodePointer sendingNode, const QString& currentCodec, const QString& recievedCodec);
 
 public slots:
-    /// This function should be called every second for all the stats to function properly. If dynamic jitter buffers
-    /// is enabled, those stats are used to calculate _desiredJitterBufferFrames.
-    /// If the stats are not used and dynamic jitter buffers is disabled, it's not necessary to call this function.
+    /// This function should be called every second for all the stats to function properly.
+    /// If the stats are not used, it's not necessary to call this function.
     void perSecondCallbackForUpdatingStats();
 
 private:
     void packetReceivedUpdateTimingStats();
 
-    void popSamplesNoCheck(int samples);
+    void resetJitterBuffer();
+    void updateSafetyFrames();
     void framesAvailableChanged();
 
 protected:
@@ -139,20 +142,36 @@ protected:
 
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
-    
+
+    /// writes audio to the jitter buffer, from the thread that parses the packets
+    int writeData(const char* data, int numBytes);
+    int addSilentSamples(int numSamples);
+
+    /// copies the samples that the next pop starts from, without popping them
+    int peekSamples(int16_t* samples, int maxSamples) const;
+
+    /// changes the frame size (restarting the jitter buffer), from the thread that parses the packets
+    void resizeForFrameSize(int numFrameSamples, int numChannels, int sampleRate = AudioConstants::SAMPLE_RATE);
+
 protected:
 
+    // what arrived, written as it is parsed and read, time-stretched, as it is popped
+    std::unique_ptr<AudioJitterBuffer> _jitterBuffer;
+    int _jitterBufferCapacityMsecs;
+    int _frameCapacity;
+
+    // what was popped last, for getLastPopOutput()
     AudioRingBuffer _ringBuffer;
+    std::vector<int16_t> _popBuffer;
     int _numChannels;
+    int _sampleRate { AudioConstants::SAMPLE_RATE };
 
     bool _lastPopSucceeded { false };
     AudioRingBuffer::ConstIterator _lastPopOutput;
     
     bool _dynamicJitterBufferEnabled { DEFAULT_DYNAMIC_JITTER_BUFFER_ENABLED };
     int _staticJitterBufferFrames { DEFAULT_STATIC_JITTER_FRAMES };
-    int _desiredJitterBufferFrames;
 
-    bool _isStarved { true };
     bool _hasStarted { false };
 
     // stats
@@ -160,24 +179,19 @@ protected:
     int _consecutiveNotMixedCount { 0 };
     int _starveCount { 0 };
     int _silentFramesDropped { 0 };
-    int _oldFramesDropped { 0 };
+    int _oldSamplesDropped { 0 };
+
+    // the counts of the jitter buffer, as of the last pop
+    int _jitterBufferStarveCount { 0 };
+    int _jitterBufferDroppedFrames { 0 };
 
     SequenceNumberStats _incomingSequenceNumberStats;
 
     quint64 _lastPacketReceivedTime { 0 };
-    MovingMinMaxAvg<quint64> _timeGapStatsForDesiredCalcOnTooManyStarves { 0, WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES };
-    int _calculatedJitterBufferFrames { 0 };
-    MovingMinMaxAvg<quint64> _timeGapStatsForDesiredReduction { 0, WINDOW_SECONDS_FOR_DESIRED_REDUCTION };
-
-    RingBufferHistory<quint64> _starveHistory;
 
     TimeWeightedAvg<int> _framesAvailableStat;
     MovingMinMaxAvg<float> _unplayedMs;
 
-    // this value is periodically updated with the time-weighted avg from _framesAvailableStat. it is only used for
-    // dropping silent frames right now.
-    int _currentJitterBufferFrames { 0 };
-
     MovingMinMaxAvg<quint64> _timeGapStatsForStatsPacket;
 
     // Reverb properties
@@ -43,9 +43,9 @@ int InjectedAudioStream::parseStreamProperties(PacketType type,
     
     // if isStereo value has changed, restart the ring buffer with new frame size
     if (isStereo != _isStereo) {
-        _ringBuffer.resizeForFrameSize(isStereo
-                                       ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
-                                       : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        resizeForFrameSize(isStereo ? AudioConstants::NETWORK_FRAME_SAMPLES_STEREO
+                                    : AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL,
+                           isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
         _isStereo = isStereo;
     }
 
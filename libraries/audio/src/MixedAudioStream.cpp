@@ -11,8 +11,25 @@
 
 #include "MixedAudioStream.h"
 
+#include <cstdlib>
+
 #include "AudioConstants.h"
 
 MixedAudioStream::MixedAudioStream(int numFramesCapacity, int numStaticJitterFrames) :
     InboundAudioStream(AudioConstants::STEREO, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL,
         numFramesCapacity, numStaticJitterFrames) {}
+
+float MixedAudioStream::getNextOutputFrameLoudness() const {
+    int16_t frame[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    int numSamples = peekSamples(frame, getNumFrameSamples());
+
+    // FIXME: This is a bad measure of loudness - normal estimation uses sqrt(sum(x*x))
+    float loudness = 0.0f;
+    for (int i = 0; i < numSamples; ++i) {
+        loudness += (float)std::abs(frame[i]);
+    }
+    loudness /= getNumFrameSamples();
+    loudness /= AudioConstants::MAX_SAMPLE_VALUE;
+
+    return loudness;
+}
@@ -18,7 +18,7 @@ class MixedAudioStream : public InboundAudioStream {
 public:
     MixedAudioStream(int numFramesCapacity, int numStaticJitterFrames = -1);
 
-    float getNextOutputFrameLoudness() const { return _ringBuffer.getNextOutputFrameLoudness(); }
+    float getNextOutputFrameLoudness() const;
 };
 
 #endif // hifi_MixedAudioStream_h
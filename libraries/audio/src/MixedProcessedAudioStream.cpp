@@ -22,7 +22,7 @@ void MixedProcessedAudioStream::outputFormatChanged(int sampleRate, int channelC
     _outputChannelCount = channelCount;
     int deviceOutputFrameFrames = networkToDeviceFrames(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / AudioConstants::STEREO);
     int deviceOutputFrameSamples = deviceOutputFrameFrames * AudioConstants::STEREO;
-    _ringBuffer.resizeForFrameSize(deviceOutputFrameSamples);
+    resizeForFrameSize(deviceOutputFrameSamples, AudioConstants::STEREO, sampleRate);
 }
 
 int MixedProcessedAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -55,7 +55,7 @@ int MixedProcessedAudioStream::lostAudioData(int numPackets) {
 
         emit processSamples(decodedBuffer, outputBuffer);
 
-        _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+        writeData(outputBuffer.data(), outputBuffer.size());
         qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
     }
     return 0;
@@ -80,7 +80,7 @@ int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray&
     QByteArray outputBuffer;
     emit processSamples(decodedBuffer, outputBuffer);
 
-    _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+    writeData(outputBuffer.data(), outputBuffer.size());
     qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
 
     return packetAfterStreamProperties.size();
@@ -89,7 +89,7 @@ int PositionalAudioStream::parsePositionalData(const QByteArray& positionalByteA
     // if this node sent us a NaN for first float in orientation then don't consider this good audio and bail
     if (glm::isnan(_orientation.x)) {
         // NOTE: why would we reset the ring buffer here?
-        _ringBuffer.reset();
+        clearBuffer();
         return 0;
     }
 
@@ -82,6 +82,22 @@ void Sound::downloadFinished(const QByteArray& data) {
     QThreadPool::globalInstance()->start(soundProcessor);
 }
 
+bool Sound::loadFromDiskCache(const char* data, size_t length) {
+    uint32_t numChannels = 0;
+    if (length < sizeof(numChannels)) {
+        return false;
+    }
+    memcpy(&numChannels, data, sizeof(numChannels));
+    size_t numBytes = length - sizeof(numChannels);
+    if (numChannels == 0 || numBytes % (numChannels * AudioConstants::SAMPLE_SIZE) != 0) {
+        return false;
+    }
+
+    uint32_t numSamples = (uint32_t)(numBytes / AudioConstants::SAMPLE_SIZE);
+    soundProcessSuccess(AudioData::make(numSamples, numChannels, (const AudioSample*)(data + sizeof(numChannels))));
+    return true;
+}
+
 void Sound::soundProcessSuccess(AudioDataPointer audioData) {
     qCDebug(audio) << "Setting ready state for sound file" << _url.fileName();
 
@@ -160,6 +176,13 @@ void SoundProcessor::run() {
     int numSamples = data.size() / AudioConstants::SAMPLE_SIZE;
     auto audioData = AudioData::make(numSamples, properties.numChannels,
                                      (const AudioSample*)data.constData());
+
+    // keep the decoded samples around so the next session can skip decoding and resampling
+    uint32_t numChannels = properties.numChannels;
+    QByteArray payload(reinterpret_cast<const char*>(&numChannels), sizeof(numChannels));
+    payload.append(audioData->rawData(), audioData->getNumBytes());
+    sound->writeToDiskCache(payload);
+
     emit onSuccess(audioData);
 }
 
@@ -73,6 +73,9 @@ public:
 
     int getNumChannels() const { return _numChannels; }
 
+    QString getType() const override { return "Sound"; }
+    int getDiskCacheVersion() const override { return DISK_CACHE_VERSION; }
+
 signals:
     void ready();
 
@@ -81,7 +84,11 @@ protected slots:
     void soundProcessError(int error, QString str);
     
 private:
+    // decoded payload: the channel count followed by the resampled 24kHz samples
+    static const int DISK_CACHE_VERSION { 1 };
+
     virtual void downloadFinished(const QByteArray& data) override;
+    virtual bool loadFromDiskCache(const char* data, size_t length) override;
 
     AudioDataPointer _audioData;
 
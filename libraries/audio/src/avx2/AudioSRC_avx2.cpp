@@ -327,4 +327,137 @@ int AudioSRC::multirateFilter4_AVX2(const float* input0, const float* input1, co
     return outputFrames;
 }
 
+// multiply-add the taps of a frame of lanes, 64 lanes at a time
+static void filterLanes_AVX2(const float* input, const float* coef, float* output, int numTaps, int stride) {
+
+    int k = 0;
+    for (; k < stride - 63; k += 64) {
+
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps();
+        __m256 acc3 = _mm256_setzero_ps();
+        __m256 acc4 = _mm256_setzero_ps();
+        __m256 acc5 = _mm256_setzero_ps();
+        __m256 acc6 = _mm256_setzero_ps();
+        __m256 acc7 = _mm256_setzero_ps();
+
+        const float* x = &input[k];
+
+        for (int j = 0; j < numTaps; j++) {
+
+            __m256 coef0 = _mm256_broadcast_ss(&coef[j]);
+
+            //acc[k] += input[i + j][k] * coef;
+            acc0 = _mm256_fmadd_ps(_mm256_load_ps(&x[0]), coef0, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_load_ps(&x[8]), coef0, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_load_ps(&x[16]), coef0, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_load_ps(&x[24]), coef0, acc3);
+            acc4 = _mm256_fmadd_ps(_mm256_load_ps(&x[32]), coef0, acc4);
+            acc5 = _mm256_fmadd_ps(_mm256_load_ps(&x[40]), coef0, acc5);
+            acc6 = _mm256_fmadd_ps(_mm256_load_ps(&x[48]), coef0, acc6);
+            acc7 = _mm256_fmadd_ps(_mm256_load_ps(&x[56]), coef0, acc7);
+
+            x += stride;
+        }
+
+        _mm256_store_ps(&output[k + 0], acc0);
+        _mm256_store_ps(&output[k + 8], acc1);
+        _mm256_store_ps(&output[k + 16], acc2);
+        _mm256_store_ps(&output[k + 24], acc3);
+        _mm256_store_ps(&output[k + 32], acc4);
+        _mm256_store_ps(&output[k + 40], acc5);
+        _mm256_store_ps(&output[k + 48], acc6);
+        _mm256_store_ps(&output[k + 56], acc7);
+    }
+    for (; k < stride; k += 16) {
+
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps();
+        __m256 acc3 = _mm256_setzero_ps();
+
+        const float* x = &input[k];
+
+        for (int j = 0; j < numTaps; j += 2) {  // unrolled x 2
+
+            __m256 coef0 = _mm256_broadcast_ss(&coef[j + 0]);
+            __m256 coef1 = _mm256_broadcast_ss(&coef[j + 1]);
+
+            acc0 = _mm256_fmadd_ps(_mm256_load_ps(&x[0]), coef0, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_load_ps(&x[8]), coef0, acc1);
+            acc2 = _mm256_fmadd_ps(_mm256_load_ps(&x[stride + 0]), coef1, acc2);
+            acc3 = _mm256_fmadd_ps(_mm256_load_ps(&x[stride + 8]), coef1, acc3);
+
+            x += 2 * stride;
+        }
+
+        _mm256_store_ps(&output[k + 0], _mm256_add_ps(acc0, acc2));
+        _mm256_store_ps(&output[k + 8], _mm256_add_ps(acc1, acc3));
+    }
+}
+
+int AudioSRCBatch::multirateFilter_AVX2(const float* input, float* output, int inputFrames) {
+    int outputFrames = 0;
+
+    assert(_numTaps % 8 == 0);  // SIMD8
+    assert(_stride % 16 == 0);  // SIMD16
+
+    if (_step == 0) {   // rational
+
+        int32_t i = HI32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            filterLanes_AVX2(&input[_stride * i], c0, &output[_stride * outputFrames], _numTaps, _stride);
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (HI32(_offset) < inputFrames) {
+
+            int32_t i = HI32(_offset);
+            uint32_t f = LO32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            float ftmp = (f & SRC_FRACMASK) * QFRAC_TO_FLOAT;
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m256 frac = _mm256_broadcast_ss(&ftmp);
+
+            // interpolate the coefficients once, for all the streams
+            for (int j = 0; j < _numTaps; j += 8) {
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+                __m256 coef1 = _mm256_loadu_ps(&c1[j]);
+                coef1 = _mm256_sub_ps(coef1, coef0);
+                coef0 = _mm256_fmadd_ps(coef1, frac, coef0);
+
+                _mm256_store_ps(&_coefs[j], coef0);
+            }
+
+            filterLanes_AVX2(&input[_stride * i], _coefs, &output[_stride * outputFrames], _numTaps, _stride);
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+    _mm256_zeroupper();
+
+    return outputFrames;
+}
+
 #endif
@@ -0,0 +1,147 @@
+//
+//  AudioSRC_avx512.cpp
+//  libraries/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX512F__
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "../AudioSRC.h"
+
+// high/low part of int64_t
+#define LO32(a)   ((uint32_t)(a))
+#define HI32(a)   ((int32_t)((a) >> 32))
+
+// multiply-add the taps of a frame of lanes, 64 lanes at a time
+static void filterLanes_AVX512(const float* input, const float* coef, float* output, int numTaps, int stride) {
+
+    int k = 0;
+    for (; k < stride - 63; k += 64) {
+
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+        __m512 acc2 = _mm512_setzero_ps();
+        __m512 acc3 = _mm512_setzero_ps();
+        __m512 acc4 = _mm512_setzero_ps();
+        __m512 acc5 = _mm512_setzero_ps();
+        __m512 acc6 = _mm512_setzero_ps();
+        __m512 acc7 = _mm512_setzero_ps();
+
+        const float* x = &input[k];
+
+        for (int j = 0; j < numTaps; j += 2) {  // unrolled x 2
+
+            __m512 coef0 = _mm512_set1_ps(coef[j + 0]);
+            __m512 coef1 = _mm512_set1_ps(coef[j + 1]);
+
+            //acc[k] += input[i + j][k] * coef;
+            acc0 = _mm512_fmadd_ps(_mm512_load_ps(&x[0]), coef0, acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_load_ps(&x[16]), coef0, acc1);
+            acc2 = _mm512_fmadd_ps(_mm512_load_ps(&x[32]), coef0, acc2);
+            acc3 = _mm512_fmadd_ps(_mm512_load_ps(&x[48]), coef0, acc3);
+            acc4 = _mm512_fmadd_ps(_mm512_load_ps(&x[stride + 0]), coef1, acc4);
+            acc5 = _mm512_fmadd_ps(_mm512_load_ps(&x[stride + 16]), coef1, acc5);
+            acc6 = _mm512_fmadd_ps(_mm512_load_ps(&x[stride + 32]), coef1, acc6);
+            acc7 = _mm512_fmadd_ps(_mm512_load_ps(&x[stride + 48]), coef1, acc7);
+
+            x += 2 * stride;
+        }
+
+        _mm512_store_ps(&output[k + 0], _mm512_add_ps(acc0, acc4));
+        _mm512_store_ps(&output[k + 16], _mm512_add_ps(acc1, acc5));
+        _mm512_store_ps(&output[k + 32], _mm512_add_ps(acc2, acc6));
+        _mm512_store_ps(&output[k + 48], _mm512_add_ps(acc3, acc7));
+    }
+    for (; k < stride; k += 16) {
+
+        __m512 acc0 = _mm512_setzero_ps();
+        __m512 acc1 = _mm512_setzero_ps();
+
+        const float* x = &input[k];
+
+        for (int j = 0; j < numTaps; j += 2) {  // unrolled x 2
+
+            acc0 = _mm512_fmadd_ps(_mm512_load_ps(&x[0]), _mm512_set1_ps(coef[j + 0]), acc0);
+            acc1 = _mm512_fmadd_ps(_mm512_load_ps(&x[stride]), _mm512_set1_ps(coef[j + 1]), acc1);
+
+            x += 2 * stride;
+        }
+
+        _mm512_store_ps(&output[k], _mm512_add_ps(acc0, acc1));
+    }
+}
+
+int AudioSRCBatch::multirateFilter_AVX512(const float* input, float* output, int inputFrames) {
+    int outputFrames = 0;
+
+    assert(_numTaps % 8 == 0);  // SIMD8
+    assert(_stride % 16 == 0);  // SIMD16
+
+    if (_step == 0) {   // rational
+
+        int32_t i = HI32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            filterLanes_AVX512(&input[_stride * i], c0, &output[_stride * outputFrames], _numTaps, _stride);
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (HI32(_offset) < inputFrames) {
+
+            int32_t i = HI32(_offset);
+            uint32_t f = LO32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            float ftmp = (f & SRC_FRACMASK) * QFRAC_TO_FLOAT;
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m512 frac = _mm512_set1_ps(ftmp);
+
+            // interpolate the coefficients once, for all the streams
+            for (int j = 0; j < _numTaps; j += 16) {
+
+                // the taps are a multiple of 8, so mask off the last 8 when odd
+                __mmask16 mask = (_numTaps - j < 16) ? 0x00ff : 0xffff;
+
+                //float coef = c0[j] + frac * (c1[j] - c0[j]);
+                __m512 coef0 = _mm512_maskz_loadu_ps(mask, &c0[j]);
+                __m512 coef1 = _mm512_maskz_loadu_ps(mask, &c1[j]);
+                coef1 = _mm512_sub_ps(coef1, coef0);
+                coef0 = _mm512_fmadd_ps(coef1, frac, coef0);
+
+                _mm512_mask_storeu_ps(&_coefs[j], mask, coef0);
+            }
+
+            filterLanes_AVX512(&input[_stride * i], _coefs, &output[_stride * outputFrames], _numTaps, _stride);
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+    _mm256_zeroupper();
+
+    return outputFrames;
+}
+
+#endif
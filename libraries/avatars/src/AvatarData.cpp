@@ -287,6 +287,19 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
                                    bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
                                    QVector<JointData>* sentJointDataOut,
                                    int maxDataSize, AvatarDataRate* outboundDataRateOut) const {
+    QByteArray avatarDataByteArray;
+    int avatarDataSize = writeToBuffer(avatarDataByteArray, dataDetail, lastSentTime, lastSentJointData, sendStatus,
+                                       dropFaceTracking, distanceAdjust, viewerPosition, sentJointDataOut, maxDataSize,
+                                       outboundDataRateOut);
+    avatarDataByteArray.truncate(avatarDataSize);
+    return avatarDataByteArray;
+}
+
+int AvatarData::writeToBuffer(QByteArray& buffer, AvatarDataDetail dataDetail, quint64 lastSentTime,
+                              const QVector<JointData>& lastSentJointData, AvatarDataPacket::SendStatus& sendStatus,
+                              bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
+                              QVector<JointData>* sentJointDataOut,
+                              int maxDataSize, AvatarDataRate* outboundDataRateOut) const {
 
     bool cullSmallChanges = (dataDetail == CullSmallData);
     bool sendAll = (dataDetail == SendAllData);
@@ -305,13 +318,18 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
     if (dataDetail == NoData) {
         sendStatus.itemFlags = wantedFlags;
 
-        QByteArray avatarDataByteArray;
-        if (sendStatus.sendUUID) {
-            avatarDataByteArray.append(getSessionUUID().toRfc4122().data(), NUM_BYTES_RFC4122_UUID);
+        const int noDataSize = (sendStatus.sendUUID ? NUM_BYTES_RFC4122_UUID : 0) + (int)sizeof(wantedFlags);
+        if (buffer.size() < noDataSize) {
+            buffer.resize(noDataSize);
         }
 
-        avatarDataByteArray.append((char*) &wantedFlags, sizeof wantedFlags);
-        return avatarDataByteArray;
+        char* destination = buffer.data();
+        if (sendStatus.sendUUID) {
+            memcpy(destination, getSessionUUID().toRfc4122().constData(), NUM_BYTES_RFC4122_UUID);
+            destination += NUM_BYTES_RFC4122_UUID;
+        }
+        memcpy(destination, &wantedFlags, sizeof(wantedFlags));
+        return noDataSize;
     }
 
     // FIXME -
@@ -444,8 +462,12 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         maxDataSize = (int)byteArraySize;
     }
 
-    QByteArray avatarDataByteArray((int)byteArraySize, 0);
-    unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(avatarDataByteArray.data());
+    // the buffer only grows, so that a caller reusing it does not allocate for each avatar
+    if (buffer.size() < (int)byteArraySize) {
+        buffer.resize((int)byteArraySize);
+    }
+    memset(buffer.data(), 0, byteArraySize);
+    unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(buffer.data());
     const unsigned char* const startPosition = destinationBuffer;
     const unsigned char* const packetEnd = destinationBuffer + maxDataSize;
 
@@ -895,7 +917,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         ASSERT(false);
     }
 
-    return avatarDataByteArray.left(avatarDataSize);
+    return avatarDataSize;
 
 #undef AVATAR_MEMCPY
 #undef IF_AVATAR_SPACE
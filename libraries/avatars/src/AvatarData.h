@@ -627,6 +627,13 @@ public:
         AvatarDataPacket::SendStatus& sendStatus, bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
         QVector<JointData>* sentJointDataOut, int maxDataSize = 0, AvatarDataRate* outboundDataRateOut = nullptr) const;
 
+    // as toByteArray, into the front of a buffer that is grown as needed, and may be reused by the caller across
+    // avatars to save the allocations; returns the number of bytes written
+    int writeToBuffer(QByteArray& buffer, AvatarDataDetail dataDetail, quint64 lastSentTime,
+        const QVector<JointData>& lastSentJointData, AvatarDataPacket::SendStatus& sendStatus, bool dropFaceTracking,
+        bool distanceAdjust, glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut, int maxDataSize = 0,
+        AvatarDataRate* outboundDataRateOut = nullptr) const;
+
     virtual void doneEncoding(bool cullSmallChanges);
 
     /// \return true if an error should be logged
@@ -0,0 +1,86 @@
+//
+//  DenseEntitySet.h
+//  libraries/entities/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_DenseEntitySet_h
+#define hifi_DenseEntitySet_h
+
+#include <vector>
+
+#include "EntityItem.h"
+
+// A set of entities kept contiguous in a vector, for the lists the EntitySimulation walks every frame.
+//
+// Each entity remembers its own position in the set (one slot per EntityItem::SimulationList), so that insert, remove
+// and contains are O(1) without hashing, and removal swaps the last entity into the hole.  Order is not preserved,
+// and an entity can belong to at most one set per list.
+class DenseEntitySet {
+public:
+    using const_iterator = std::vector<EntityItemPointer>::const_iterator;
+
+    DenseEntitySet(EntityItem::SimulationList list) : _list(list) { }
+    ~DenseEntitySet() { clear(); }
+
+    DenseEntitySet(const DenseEntitySet&) = delete;
+    DenseEntitySet& operator=(const DenseEntitySet&) = delete;
+
+    bool contains(const EntityItemPointer& entity) const { return entity->_simulationListSlots[_list] != 0; }
+
+    // returns true if the entity was not already in the set
+    bool insert(const EntityItemPointer& entity) {
+        uint32_t& slot = entity->_simulationListSlots[_list];
+        if (slot != 0) {
+            return false;
+        }
+        _entities.push_back(entity);
+        slot = (uint32_t)_entities.size();
+        return true;
+    }
+
+    // returns true if the entity was in the set
+    bool remove(const EntityItemPointer& entity) {
+        uint32_t slot = entity->_simulationListSlots[_list];
+        if (slot == 0) {
+            return false;
+        }
+        removeAt(slot - 1);
+        return true;
+    }
+
+    // moves the last entity into index, so when removing while walking the set do not advance past index
+    void removeAt(size_t index) {
+        assert(index < _entities.size());
+        _entities[index]->_simulationListSlots[_list] = 0;
+        if (index + 1 < _entities.size()) {
+            _entities[index] = std::move(_entities.back());
+            _entities[index]->_simulationListSlots[_list] = (uint32_t)index + 1;
+        }
+        _entities.pop_back();
+    }
+
+    void clear() {
+        for (auto& entity : _entities) {
+            entity->_simulationListSlots[_list] = 0;
+        }
+        _entities.clear();
+    }
+
+    const EntityItemPointer& operator[](size_t index) const { return _entities[index]; }
+    size_t size() const { return _entities.size(); }
+    bool empty() const { return _entities.empty(); }
+
+    const_iterator begin() const { return _entities.cbegin(); }
+    const_iterator end() const { return _entities.cend(); }
+
+private:
+    std::vector<EntityItemPointer> _entities;
+    const EntityItem::SimulationList _list;
+};
+
+#endif // hifi_DenseEntitySet_h
@@ -0,0 +1,118 @@
+//
+//  EntityExpiryWheel.cpp
+//  libraries/entities/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityExpiryWheel.h"
+
+#include <algorithm>
+
+const uint64_t SLOT_MASK = EntityExpiryWheel::NUM_SLOTS - 1;
+const uint64_t WHEEL_SPAN = (uint64_t)1 << (EntityExpiryWheel::SLOT_BITS * EntityExpiryWheel::NUM_LEVELS);
+
+uint64_t EntityExpiryWheel::getExpiryTick(const EntityItem& entity) {
+    // round up, so that an entity is never due before its expiry
+    return (entity.getExpiry() + TICK_USECS - 1) / TICK_USECS;
+}
+
+void EntityExpiryWheel::insert(const EntityItemPointer& entity, uint64_t now) {
+    remove(entity);
+    if (_size == 0) {
+        _currentTick = std::max(_currentTick, now / TICK_USECS);
+    }
+    // the bucket of the current tick has already been emptied
+    schedule(entity, std::max(getExpiryTick(*entity), _currentTick + 1));
+}
+
+bool EntityExpiryWheel::remove(const EntityItemPointer& entity) {
+    if (entity->_expiryBucket == 0) {
+        return false;
+    }
+    auto& bucket = _buckets[entity->_expiryBucket - 1];
+    uint32_t slot = entity->_expirySlot;
+    entity->_expiryBucket = 0;
+    if (slot + 1 < bucket.size()) {
+        bucket[slot] = std::move(bucket.back());
+        bucket[slot]->_expirySlot = slot;
+    }
+    bucket.pop_back();
+    --_size;
+    return true;
+}
+
+void EntityExpiryWheel::schedule(const EntityItemPointer& entity, uint64_t tick) {
+    // tick is never behind _currentTick: it is either the bucket about to be emptied or a later one
+    uint64_t delta = tick - _currentTick;
+    if (delta >= WHEEL_SPAN) {
+        // too far out for the wheel: park it in the furthest bucket and it gets rescheduled when that comes around
+        delta = WHEEL_SPAN - 1;
+        tick = _currentTick + delta;
+    }
+    int level = 0;
+    while (level < NUM_LEVELS - 1 && (delta >> (SLOT_BITS * (level + 1))) != 0) {
+        ++level;
+    }
+    int bucketIndex = level * NUM_SLOTS + (int)((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+    auto& bucket = _buckets[bucketIndex];
+    entity->_expiryBucket = (uint32_t)bucketIndex + 1;
+    entity->_expirySlot = (uint32_t)bucket.size();
+    bucket.push_back(entity);
+    ++_size;
+}
+
+void EntityExpiryWheel::takeBucket(int bucketIndex) {
+    _takenEntities.clear();
+    _takenEntities.swap(_buckets[bucketIndex]);
+    for (auto& entity : _takenEntities) {
+        entity->_expiryBucket = 0;
+    }
+    _size -= _takenEntities.size();
+}
+
+void EntityExpiryWheel::advance(uint64_t now, std::vector<EntityItemPointer>& expired) {
+    uint64_t nowTick = now / TICK_USECS;
+    while (_currentTick < nowTick) {
+        if (_size == 0) {
+            _currentTick = nowTick;
+            break;
+        }
+        ++_currentTick;
+
+        // at the start of each of its spans, move a level's bucket for that span down into the levels below
+        for (int level = 1; level < NUM_LEVELS; ++level) {
+            if ((_currentTick & (((uint64_t)1 << (SLOT_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            takeBucket(level * NUM_SLOTS + (int)((_currentTick >> (SLOT_BITS * level)) & SLOT_MASK));
+            for (auto& entity : _takenEntities) {
+                schedule(entity, std::max(getExpiryTick(*entity), _currentTick));
+            }
+        }
+
+        takeBucket((int)(_currentTick & SLOT_MASK));
+        for (auto& entity : _takenEntities) {
+            if (entity->getExpiry() < now) {
+                expired.push_back(entity);
+            } else {
+                // its lifetime was extended, or it was parked beyond the span of the wheel
+                schedule(entity, std::max(getExpiryTick(*entity), _currentTick + 1));
+            }
+        }
+    }
+    _takenEntities.clear();
+}
+
+void EntityExpiryWheel::clear() {
+    for (auto& bucket : _buckets) {
+        for (auto& entity : bucket) {
+            entity->_expiryBucket = 0;
+        }
+        bucket.clear();
+    }
+    _size = 0;
+}
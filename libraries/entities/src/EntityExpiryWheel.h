@@ -0,0 +1,58 @@
+//
+//  EntityExpiryWheel.h
+//  libraries/entities/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityExpiryWheel_h
+#define hifi_EntityExpiryWheel_h
+
+#include <vector>
+
+#include "EntityItem.h"
+
+// Hierarchical timer wheel holding the mortal entities of an EntitySimulation.
+//
+// Level 0 has one bucket per tick, each level above it one bucket per NUM_SLOTS ticks of the level below.  An entity
+// goes into the coarsest level its expiry needs and is moved down a level each time the wheel reaches its bucket, so
+// advancing only ever touches the entities that are (nearly) due, however many mortal entities there are.  The
+// entity's own expiry is checked again before it is reported, so rounding to ticks never expires it early.
+class EntityExpiryWheel {
+public:
+    static const int SLOT_BITS = 6;
+    static const int NUM_SLOTS = 1 << SLOT_BITS;
+    static const int NUM_LEVELS = 4;
+    static const uint64_t TICK_USECS = 1 << 14; // about a frame at 60Hz, so the levels span 1 sec, 1 min, 1 hour, 3 days
+
+    ~EntityExpiryWheel() { clear(); }
+
+    // (re)schedules the entity for its current expiry
+    void insert(const EntityItemPointer& entity, uint64_t now);
+    // returns true if the entity was in the wheel
+    bool remove(const EntityItemPointer& entity);
+    bool contains(const EntityItemPointer& entity) const { return entity->_expiryBucket != 0; }
+
+    // advances the wheel to now and appends the entities that have expired, which are no longer in the wheel
+    void advance(uint64_t now, std::vector<EntityItemPointer>& expired);
+
+    void clear();
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+private:
+    static uint64_t getExpiryTick(const EntityItem& entity);
+
+    void schedule(const EntityItemPointer& entity, uint64_t tick);
+    void takeBucket(int bucket);
+
+    std::vector<EntityItemPointer> _buckets[NUM_LEVELS * NUM_SLOTS];
+    std::vector<EntityItemPointer> _takenEntities;
+    uint64_t _currentTick { 0 };
+    size_t _size { 0 };
+};
+
+#endif // hifi_EntityExpiryWheel_h
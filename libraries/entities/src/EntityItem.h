@@ -81,16 +81,29 @@ enum class HostType {
 /// one directly, instead you must only construct one of it's derived classes with additional features.
 class EntityItem : public QObject, public SpatiallyNestable, public ReadWriteLockable {
     Q_OBJECT
-    // These two classes manage lists of EntityItem pointers and must be able to cleanup pointers when an EntityItem is deleted.
+    // These classes manage lists of EntityItem pointers and must be able to cleanup pointers when an EntityItem is deleted.
     // To make the cleanup robust each EntityItem has backpointers to its manager classes (which are only ever set/cleared by
     // the managers themselves, hence they are fiends) whose NULL status can be used to determine which managers still need to
     // do cleanup.
     friend class EntityTreeElement;
     friend class EntitySimulation;
+    friend class DenseEntitySet;
+    friend class EntityExpiryWheel;
+    friend class EntitySpatialIndex;
 public:
 
     DONT_ALLOW_INSTANTIATION // This class can not be instantiated directly
 
+    // the dense lists an EntitySimulation can hold an entity in, each one keeps its slot in _simulationListSlots
+    enum SimulationList {
+        SIMULATION_LIST_ALL = 0,
+        SIMULATION_LIST_TO_UPDATE,
+        SIMULATION_LIST_TO_SORT,
+        SIMULATION_LIST_SIMPLE_KINEMATIC,
+        SIMULATION_LIST_IN_SPACE,
+        NUM_SIMULATION_LISTS
+    };
+
     EntityItem(const EntityItemID& entityItemID);
     virtual ~EntityItem();
 
@@ -548,6 +561,7 @@ public:
     float getBoundingRadius() const { return _boundingRadius; }
     void setSpaceIndex(int32_t index);
     int32_t getSpaceIndex() const { return _spaceIndex; }
+    void clearSpaceIndex() { _spaceIndex = -1; }
 
     virtual void preDelete();
     virtual void postParentFixup() {}
@@ -694,6 +708,10 @@ protected:
     EntityTreeElementPointer _element; // set by EntityTreeElement
     void* _physicsInfo { nullptr }; // set by EntitySimulation
     bool _simulated { false }; // set by EntitySimulation
+    uint32_t _simulationListSlots[NUM_SIMULATION_LISTS] {}; // set by DenseEntitySet, 0 when not in the list
+    uint32_t _expiryBucket { 0 }; // set by EntityExpiryWheel, 0 when not in the wheel
+    uint32_t _expirySlot { 0 }; // set by EntityExpiryWheel
+    uint32_t _spatialIndexSlot { 0 }; // set by EntitySpatialIndex, 0 when never indexed
     bool _visuallyReady { true };
 
     void enableNoBootstrap();
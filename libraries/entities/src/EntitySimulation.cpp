@@ -24,7 +24,6 @@ void EntitySimulation::setEntityTree(EntityTreePointer tree) {
         _changedEntities.clear();
         _entitiesToUpdate.clear();
         _mortalEntities.clear();
-        _nextExpiry = std::numeric_limits<uint64_t>::max();
     }
     _entityTree = tree;
 }
@@ -68,47 +67,31 @@ void EntitySimulation::prepareEntityForDelete(EntityItemPointer entity) {
 
 // protected
 void EntitySimulation::expireMortalEntities(uint64_t now) {
-    if (now > _nextExpiry) {
-        PROFILE_RANGE_EX(simulation_physics, "ExpireMortals", 0xffff00ff, (uint64_t)_mortalEntities.size());
-        // only search for expired entities if we expect to find one
-        _nextExpiry = std::numeric_limits<uint64_t>::max();
-        QMutexLocker lock(&_mutex);
-        SetOfEntities::iterator itemItr = _mortalEntities.begin();
-        while (itemItr != _mortalEntities.end()) {
-            EntityItemPointer entity = *itemItr;
-            uint64_t expiry = entity->getExpiry();
-            if (expiry < now) {
-                itemItr = _mortalEntities.erase(itemItr);
-                entity->die();
-                prepareEntityForDelete(entity);
-            } else {
-                if (expiry < _nextExpiry) {
-                    // remember the smallest _nextExpiry so we know when to start the next search
-                    _nextExpiry = expiry;
-                }
-                ++itemItr;
-            }
-        }
-        if (_mortalEntities.size() < 1) {
-            _nextExpiry = -1;
-        }
+    PROFILE_RANGE_EX(simulation_physics, "ExpireMortals", 0xffff00ff, (uint64_t)_mortalEntities.size());
+    QMutexLocker lock(&_mutex);
+    // the wheel only visits the entities that are due, the others cost nothing here
+    _mortalEntities.advance(now, _expiredEntities);
+    for (auto& entity : _expiredEntities) {
+        entity->die();
+        prepareEntityForDelete(entity);
     }
+    _expiredEntities.clear();
 }
 
 // protected
 void EntitySimulation::callUpdateOnEntitiesThatNeedIt(uint64_t now) {
     PerformanceTimer perfTimer("updatingEntities");
     QMutexLocker lock(&_mutex);
-    SetOfEntities::iterator itemItr = _entitiesToUpdate.begin();
-    while (itemItr != _entitiesToUpdate.end()) {
-        EntityItemPointer entity = *itemItr;
+    size_t i = 0;
+    while (i < _entitiesToUpdate.size()) {
+        const EntityItemPointer& entity = _entitiesToUpdate[i];
         // TODO: catch transition from needing update to not as a "change"
         // so we don't have to scan for it here.
         if (!entity->needsToCallUpdate()) {
-            itemItr = _entitiesToUpdate.erase(itemItr);
+            _entitiesToUpdate.removeAt(i);
         } else {
             entity->update(now);
-            ++itemItr;
+            ++i;
         }
     }
 }
@@ -120,25 +103,31 @@ void EntitySimulation::sortEntitiesThatMoved() {
     // External changes to entity position/shape are expected to be sorted outside of the EntitySimulation.
     MovingEntitiesOperator moveOperator;
     AACube domainBounds(glm::vec3((float)-HALF_TREE_SCALE), (float)TREE_SCALE);
-    SetOfEntities::iterator itemItr = _entitiesToSort.begin();
-    while (itemItr != _entitiesToSort.end()) {
-        EntityItemPointer entity = *itemItr;
+    size_t i = 0;
+    while (i < _entitiesToSort.size()) {
+        EntityItemPointer entity = _entitiesToSort[i];
         // check to see if this movement has sent the entity outside of the domain.
         bool success;
         AACube newCube = entity->getQueryAACube(success);
         if (success && !domainBounds.touches(newCube)) {
             qCDebug(entities) << "Entity " << entity->getEntityItemID() << " moved out of domain bounds.";
-            itemItr = _entitiesToSort.erase(itemItr);
+            _entitiesToSort.removeAt(i);
             entity->die();
             prepareEntityForDelete(entity);
         } else {
             moveOperator.addEntityToMoveList(entity, newCube);
-            ++itemItr;
+            ++i;
         }
     }
     if (moveOperator.hasMovingEntities()) {
         PerformanceTimer perfTimer("recurseTreeWithOperator");
         _entityTree->recurseTreeWithOperator(&moveOperator);
+        PROFILE_COUNTER(simulation_physics, "SortTreeElements", {
+            { "moved", moveOperator.getNumEntitiesMoved() },
+            { "visited", moveOperator.getNumElementsVisited() },
+            { "created", moveOperator.getNumElementsCreated() },
+            { "pruned", moveOperator.getNumElementsPruned() }
+        });
     }
 
     _entitiesToSort.clear();
@@ -147,11 +136,7 @@ void EntitySimulation::sortEntitiesThatMoved() {
 void EntitySimulation::addEntityToInternalLists(EntityItemPointer entity) {
     // protected: _mutex lock is guaranteed
     if (entity->isMortal()) {
-        _mortalEntities.insert(entity);
-        uint64_t expiry = entity->getExpiry();
-        if (expiry < _nextExpiry) {
-            _nextExpiry = expiry;
-        }
+        _mortalEntities.insert(entity, usecTimestampNow());
     }
     if (entity->needsToCallUpdate()) {
         _entitiesToUpdate.insert(entity);
@@ -193,11 +178,8 @@ void EntitySimulation::processChangedEntity(const EntityItemPointer& entity) {
     if (dirtyFlags & (Simulation::DIRTY_LIFETIME | Simulation::DIRTY_UPDATEABLE)) {
         if (dirtyFlags & Simulation::DIRTY_LIFETIME) {
             if (entity->isMortal()) {
-                _mortalEntities.insert(entity);
-                uint64_t expiry = entity->getExpiry();
-                if (expiry < _nextExpiry) {
-                    _nextExpiry = expiry;
-                }
+                // reschedules it when it was already mortal
+                _mortalEntities.insert(entity, usecTimestampNow());
             } else {
                 _mortalEntities.remove(entity);
             }
@@ -222,14 +204,13 @@ void EntitySimulation::clearEntities() {
     _deadEntitiesToRemoveFromTree.clear();
     _entitiesToUpdate.clear();
     _mortalEntities.clear();
-    _nextExpiry = std::numeric_limits<uint64_t>::max();
 }
 
 void EntitySimulation::moveSimpleKinematics(uint64_t now) {
     PROFILE_RANGE_EX(simulation_physics, "MoveSimples", 0xffff00ff, (uint64_t)_simpleKinematicEntities.size());
-    SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
-    while (itemItr != _simpleKinematicEntities.end()) {
-        EntityItemPointer entity = *itemItr;
+    size_t i = 0;
+    while (i < _simpleKinematicEntities.size()) {
+        EntityItemPointer entity = _simpleKinematicEntities[i];
 
         // The entity-server doesn't know where avatars are, so don't attempt to do simple extrapolation for
         // children of avatars.  See related code in EntityMotionState::remoteSimulationOutOfSync.
@@ -239,12 +220,13 @@ void EntitySimulation::moveSimpleKinematics(uint64_t now) {
 
         bool isMoving = entity->isMovingRelativeToParent();
         if (isMoving && !entity->getPhysicsInfo() && ancestryIsKnown && !hasAvatarAncestor) {
-            entity->simulate(now);
-            if (ancestryIsKnown && !hasAvatarAncestor) {
+            // a step held back integrates over the whole time since the entity was last simulated when it comes
+            if (isDueForKinematicStep(entity, now)) {
+                entity->simulate(now);
                 entity->updateQueryAACube();
+                _entitiesToSort.insert(entity);
             }
-            _entitiesToSort.insert(entity);
-            ++itemItr;
+            ++i;
         } else {
             if (!isMoving && ancestryIsKnown && !hasAvatarAncestor) {
                 // HACK: This catches most cases where the entity's QueryAACube (and spatial sorting in the EntityTree)
@@ -253,7 +235,7 @@ void EntitySimulation::moveSimpleKinematics(uint64_t now) {
                 _entitiesToSort.insert(entity);
             }
             // the entity is no longer non-physical-kinematic
-            itemItr = _simpleKinematicEntities.erase(itemItr);
+            _simpleKinematicEntities.removeAt(i);
         }
     }
 }
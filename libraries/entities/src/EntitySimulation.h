@@ -12,7 +12,7 @@
 #ifndef hifi_EntitySimulation_h
 #define hifi_EntitySimulation_h
 
-#include <limits>
+#include <vector>
 #include <unordered_set>
 
 #include <QtCore/QObject>
@@ -20,6 +20,8 @@
 
 #include <PerfStat.h>
 
+#include "DenseEntitySet.h"
+#include "EntityExpiryWheel.h"
 #include "EntityItem.h"
 #include "EntityTree.h"
 
@@ -44,7 +46,7 @@ const int DIRTY_SIMULATION_FLAGS =
 
 class EntitySimulation : public QObject, public std::enable_shared_from_this<EntitySimulation> {
 public:
-    EntitySimulation() : _mutex(QMutex::Recursive), _nextExpiry(std::numeric_limits<uint64_t>::max()), _entityTree(nullptr) { }
+    EntitySimulation() : _mutex(QMutex::Recursive), _entityTree(nullptr) { }
     virtual ~EntitySimulation() { setEntityTree(nullptr); }
 
     inline EntitySimulationPointer getThisPointer() const {
@@ -90,10 +92,13 @@ protected:
     void callUpdateOnEntitiesThatNeedIt(uint64_t now);
     virtual void sortEntitiesThatMoved();
 
+    // whether a moving simple kinematic entity is stepped this frame, rather than left to catch up later
+    virtual bool isDueForKinematicStep(const EntityItemPointer& entity, uint64_t now) { return true; }
+
     QMutex _mutex{ QMutex::Recursive };
 
-    SetOfEntities _entitiesToSort; // entities moved by simulation (and might need resort in EntityTree)
-    SetOfEntities _simpleKinematicEntities; // entities undergoing non-colliding kinematic motion
+    DenseEntitySet _entitiesToSort { EntityItem::SIMULATION_LIST_TO_SORT }; // entities moved by simulation (and might need resort in EntityTree)
+    DenseEntitySet _simpleKinematicEntities { EntityItem::SIMULATION_LIST_SIMPLE_KINEMATIC }; // entities undergoing non-colliding kinematic motion
     SetOfEntities _deadEntitiesToRemoveFromTree;
 
 private:
@@ -102,10 +107,10 @@ private:
     // We maintain multiple lists, each for its distinct purpose.
     // An entity may be in more than one list.
     std::unordered_set<EntityItemPointer> _changedEntities; // all changes this frame
-    SetOfEntities _allEntities; // tracks all entities added the simulation
-    SetOfEntities _entitiesToUpdate; // entities that need to call EntityItem::update()
-    SetOfEntities _mortalEntities; // entities that have an expiry
-    uint64_t _nextExpiry;
+    DenseEntitySet _allEntities { EntityItem::SIMULATION_LIST_ALL }; // tracks all entities added the simulation
+    DenseEntitySet _entitiesToUpdate { EntityItem::SIMULATION_LIST_TO_UPDATE }; // entities that need to call EntityItem::update()
+    EntityExpiryWheel _mortalEntities; // entities that have an expiry
+    std::vector<EntityItemPointer> _expiredEntities;
 
     // back pointer to EntityTree structure
     EntityTreePointer _entityTree;
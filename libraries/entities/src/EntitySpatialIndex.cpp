@@ -0,0 +1,200 @@
+//
+//  EntitySpatialIndex.cpp
+//  libraries/entities/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySpatialIndex.h"
+
+#include <cmath>
+
+#include <OctreeConstants.h>
+
+const int MORTON_BITS = 19; // per axis
+const int LEVEL_SHIFT = 3 * MORTON_BITS;
+const int MAX_LEVEL = (1 << (64 - LEVEL_SHIFT)) - 1;
+const size_t MIN_CHANGES_BEFORE_SORT = 256;
+
+// spreads the low 21 bits of value to every third bit
+static uint64_t spreadBits(uint32_t value) {
+    uint64_t bits = value & 0x1fffff;
+    bits = (bits | bits << 32) & 0x1f00000000ffffULL;
+    bits = (bits | bits << 16) & 0x1f0000ff0000ffULL;
+    bits = (bits | bits << 8) & 0x100f00f00f00f00fULL;
+    bits = (bits | bits << 4) & 0x10c30c30c30c30c3ULL;
+    bits = (bits | bits << 2) & 0x1249249249249249ULL;
+    return bits;
+}
+
+static void expand(EntitySpatialIndex::Bounds& bounds, const EntitySpatialIndex::Bounds& other) {
+    bounds.minimum = glm::min(bounds.minimum, other.minimum);
+    bounds.maximum = glm::max(bounds.maximum, other.maximum);
+}
+
+uint64_t EntitySpatialIndex::computeSortKey(const Bounds& bounds) {
+    // elements are cubes of TREE_SCALE / 2^level: sort the coarse ones first so that the few large ones share
+    // nodes, rather than each widening a path of nodes through the middle of the index
+    float scale = std::max(bounds.maximum.x - bounds.minimum.x, (float)TREE_SCALE / (1 << MORTON_BITS));
+    int level = glm::clamp((int)std::round(std::log2((float)TREE_SCALE / scale)), 0, MAX_LEVEL);
+
+    const float NUM_CELLS = (float)((1 << MORTON_BITS) - 1);
+    glm::vec3 center = 0.5f * (bounds.minimum + bounds.maximum);
+    glm::vec3 cell = glm::clamp((center + (float)HALF_TREE_SCALE) / (float)TREE_SCALE, 0.0f, 1.0f) * NUM_CELLS;
+    uint64_t morton = spreadBits((uint32_t)cell.x) | (spreadBits((uint32_t)cell.y) << 1) | (spreadBits((uint32_t)cell.z) << 2);
+    return ((uint64_t)level << LEVEL_SHIFT) | morton;
+}
+
+void EntitySpatialIndex::setEnabled(bool enabled) {
+    if (!enabled) {
+        clear();
+    }
+    _enabled = enabled;
+}
+
+void EntitySpatialIndex::addEntity(const EntityItemPointer& entity, const AACube& cube) {
+    if (!_enabled) {
+        return;
+    }
+    Bounds bounds { cube.getMinimumPoint(), cube.getMaximumPoint() };
+    countChange();
+
+    size_t slot = entity->_spatialIndexSlot;
+    if (slot != 0 && slot <= _owners.size() && _owners[slot - 1] == entity.get()) {
+        // moving between elements: the entry is still there, take it back and widen the nodes above it
+        size_t index = slot - 1;
+        if (!_entities[index]) {
+            _entities[index] = entity;
+            ++_numEntities;
+        }
+        _bounds[index] = bounds;
+        if (index < _numSorted) {
+            widenNodes(index);
+        }
+        return;
+    }
+
+    entity->_spatialIndexSlot = (uint32_t)_entities.size() + 1;
+    _bounds.push_back(bounds);
+    _entities.push_back(entity);
+    _owners.push_back(entity.get());
+    ++_numEntities;
+}
+
+void EntitySpatialIndex::removeEntity(const EntityItemPointer& entity) {
+    if (!_enabled) {
+        return;
+    }
+    // the entity keeps its slot, so that it can get its entry back if it is only moving to another element
+    size_t slot = entity->_spatialIndexSlot;
+    if (slot != 0 && slot <= _owners.size() && _owners[slot - 1] == entity.get() && _entities[slot - 1]) {
+        _entities[slot - 1].reset();
+        --_numEntities;
+        countChange();
+    }
+}
+
+void EntitySpatialIndex::clear() {
+    for (auto& entity : _entities) {
+        if (entity) {
+            entity->_spatialIndexSlot = 0;
+        }
+    }
+    _bounds.clear();
+    _entities.clear();
+    _owners.clear();
+    _levels.clear();
+    _numSorted = 0;
+    _numEntities = 0;
+    _numChanges = 0;
+    _needsMaintenance.store(false, std::memory_order_relaxed);
+}
+
+void EntitySpatialIndex::countChange() {
+    ++_numChanges;
+    if (_numChanges > std::max(MIN_CHANGES_BEFORE_SORT, _numEntities / 4)) {
+        _needsMaintenance.store(true, std::memory_order_relaxed);
+    }
+}
+
+void EntitySpatialIndex::maintain() {
+    if (_enabled && _needsMaintenance.load(std::memory_order_relaxed)) {
+        rebuild();
+    }
+}
+
+void EntitySpatialIndex::rebuild() {
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+    order.reserve(_numEntities);
+    for (size_t i = 0; i < _entities.size(); i++) {
+        if (_entities[i]) {
+            order.emplace_back(computeSortKey(_bounds[i]), (uint32_t)i);
+        }
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<Bounds> bounds;
+    std::vector<EntityItemPointer> entities;
+    std::vector<const EntityItem*> owners;
+    bounds.reserve(order.size());
+    entities.reserve(order.size());
+    owners.reserve(order.size());
+    for (auto& entry : order) {
+        EntityItemPointer& entity = _entities[entry.second];
+        entity->_spatialIndexSlot = (uint32_t)entities.size() + 1;
+        bounds.push_back(_bounds[entry.second]);
+        owners.push_back(entity.get());
+        entities.push_back(std::move(entity));
+    }
+    _bounds.swap(bounds);
+    _entities.swap(entities);
+    _owners.swap(owners);
+
+    _numSorted = _entities.size();
+    _numChanges = 0;
+    _needsMaintenance.store(false, std::memory_order_relaxed);
+    buildNodes();
+}
+
+void EntitySpatialIndex::buildNodes() {
+    _levels.clear();
+    if (_numSorted == 0) {
+        return;
+    }
+    const std::vector<Bounds>* children = &_bounds;
+    size_t numChildren = _numSorted;
+    do {
+        std::vector<Bounds> level((numChildren + BRANCHING - 1) / BRANCHING);
+        for (size_t i = 0; i < level.size(); i++) {
+            size_t first = i * BRANCHING;
+            size_t last = std::min(first + BRANCHING, numChildren);
+            level[i] = (*children)[first];
+            for (size_t j = first + 1; j < last; j++) {
+                expand(level[i], (*children)[j]);
+            }
+        }
+        _levels.push_back(std::move(level));
+        children = &_levels.back();
+        numChildren = children->size();
+    } while (numChildren > 1);
+}
+
+void EntitySpatialIndex::widenNodes(size_t slot) {
+    size_t index = slot;
+    for (auto& level : _levels) {
+        index /= BRANCHING;
+        expand(level[index], _bounds[slot]);
+    }
+}
+
+size_t EntitySpatialIndex::getMemoryUsage() const {
+    size_t usage = sizeof(EntitySpatialIndex) + _bounds.capacity() * sizeof(Bounds) +
+        _entities.capacity() * sizeof(EntityItemPointer) + _owners.capacity() * sizeof(const EntityItem*);
+    for (auto& level : _levels) {
+        usage += level.capacity() * sizeof(Bounds);
+    }
+    return usage;
+}
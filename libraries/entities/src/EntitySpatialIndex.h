@@ -0,0 +1,128 @@
+//
+//  EntitySpatialIndex.h
+//  libraries/entities/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndex_h
+#define hifi_EntitySpatialIndex_h
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AACube.h>
+
+#include "EntityItem.h"
+
+// Flat index of the entities of an EntityTree, for the spatial queries, kept next to the octree.
+//
+// Each entity is indexed with the bounds of the element that holds it, so a query over the index considers exactly the
+// entities a traversal of the octree would.  Entries are sorted by the Morton code of their bounds (coarsest elements
+// first) into contiguous arrays, over which a packed BVH of BRANCHING-wide nodes is built level by level, so a query
+// walks a few cache-friendly arrays rather than chasing element pointers.
+//
+// The index follows the tree incrementally: an entity moving to another element has its entry updated in place and
+// the nodes above it widened, new entities are appended to an unsorted tail that queries scan linearly, and removed
+// entities leave a hole.  maintain() sorts and rebuilds everything once enough has changed that way.
+//
+// The index is changed by the EntityTreeElements as they gain and lose entities, so like them it relies on the tree
+// being locked for writing while it changes, and for reading while it is queried.
+class EntitySpatialIndex {
+public:
+    static const int BRANCHING = 8;
+
+    class Bounds {
+    public:
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+    };
+
+    bool isEnabled() const { return _enabled; }
+    void setEnabled(bool enabled);
+
+    void addEntity(const EntityItemPointer& entity, const AACube& bounds);
+    void removeEntity(const EntityItemPointer& entity);
+    void clear();
+
+    // re-sorts the index if enough has changed since it was last sorted
+    void maintain();
+
+    // whether maintain() has work to do; unlike the rest, this may be checked without holding the tree lock
+    bool needsMaintenance() const { return _needsMaintenance.load(std::memory_order_relaxed); }
+
+    // calls visit(entity) for each indexed entity whose bounds satisfy overlaps(bounds); overlaps is also used to
+    // cull the nodes of the index, so it must hold for any bounds that contain bounds it holds for
+    template <typename Overlaps, typename Visit>
+    void forEachEntity(Overlaps overlaps, Visit visit) const;
+
+    size_t getNumEntities() const { return _numEntities; }
+    size_t getMemoryUsage() const;
+
+private:
+    static uint64_t computeSortKey(const Bounds& bounds);
+
+    void rebuild();
+    void buildNodes();
+    void widenNodes(size_t slot);
+    void countChange();
+
+    std::vector<Bounds> _bounds;
+    std::vector<EntityItemPointer> _entities; // null where an entity was removed
+    std::vector<const EntityItem*> _owners; // which entity each entry was made for, even once removed
+    std::vector<std::vector<Bounds>> _levels; // _levels[0] bounds BRANCHING entries each, the last level is the root
+
+    size_t _numSorted { 0 }; // the entries covered by the nodes, the rest is the unsorted tail
+    size_t _numEntities { 0 };
+    size_t _numChanges { 0 }; // holes, widened nodes and tail entries since the last sort
+    std::atomic<bool> _needsMaintenance { false };
+    bool _enabled { true };
+};
+
+template <typename Overlaps, typename Visit>
+void EntitySpatialIndex::forEachEntity(Overlaps overlaps, Visit visit) const {
+    if (_numSorted > 0) {
+        // depth first from the root, which never holds more than BRANCHING nodes per level on the stack
+        struct Node {
+            int level;
+            size_t index;
+        };
+        const int MAX_STACK_SIZE = 32 * BRANCHING;
+        Node stack[MAX_STACK_SIZE];
+        int stackSize = 0;
+        stack[stackSize++] = { (int)_levels.size() - 1, 0 };
+        while (stackSize > 0) {
+            Node node = stack[--stackSize];
+            if (!overlaps(_levels[node.level][node.index])) {
+                continue;
+            }
+            size_t first = node.index * BRANCHING;
+            if (node.level == 0) {
+                size_t last = std::min(first + BRANCHING, _numSorted);
+                for (size_t i = first; i < last; i++) {
+                    if (_entities[i] && overlaps(_bounds[i])) {
+                        visit(_entities[i]);
+                    }
+                }
+            } else {
+                size_t last = std::min(first + BRANCHING, _levels[node.level - 1].size());
+                for (size_t i = last; i > first; i--) {
+                    stack[stackSize++] = { node.level - 1, i - 1 };
+                }
+            }
+        }
+    }
+    for (size_t i = _numSorted; i < _entities.size(); i++) {
+        if (_entities[i] && overlaps(_bounds[i])) {
+            visit(_entities[i]);
+        }
+    }
+}
+
+#endif // hifi_EntitySpatialIndex_h
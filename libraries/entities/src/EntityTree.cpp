@@ -23,7 +23,10 @@
 
 #include <QtScript/QScriptEngine>
 
+#include <glm/gtx/norm.hpp>
+
 #include <Extents.h>
+#include <GLMHelpers.h>
 #include <PerfStat.h>
 #include <Profile.h>
 #include <AddressManager.h>
@@ -155,6 +158,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
         }
     });
     localMap.clear();
+    _spatialIndex.clear();
     Octree::eraseAllOctreeElements(createNewRoot);
 
     resetClientEditStats();
@@ -788,6 +792,41 @@ void EntityTree::processRemovedEntities(const DeleteEntityOperator& theOperator)
     }
 }
 
+static bool boundsTouchSphere(const EntitySpatialIndex::Bounds& bounds, const glm::vec3& center, float radius) {
+    glm::vec3 offset = glm::max(bounds.minimum - center, Vectors::ZERO) + glm::max(center - bounds.maximum, Vectors::ZERO);
+    return glm::length2(offset) <= radius * radius;
+}
+
+static bool boundsTouchBox(const EntitySpatialIndex::Bounds& bounds, const glm::vec3& minimum, const glm::vec3& maximum) {
+    return glm::all(glm::lessThanEqual(bounds.minimum, maximum)) && glm::all(glm::lessThanEqual(minimum, bounds.maximum));
+}
+
+// whether the ray enters bounds before maxDistance, or starts inside them
+static bool rayHitsBounds(const EntitySpatialIndex::Bounds& bounds, const glm::vec3& origin, const glm::vec3& direction,
+                          const glm::vec3& invDirection, float maxDistance) {
+    float enter = 0.0f;
+    float exit = maxDistance;
+    for (int i = 0; i < 3; i++) {
+        if (direction[i] == 0.0f) {
+            if (origin[i] < bounds.minimum[i] || origin[i] > bounds.maximum[i]) {
+                return false;
+            }
+            continue;
+        }
+        float near = (bounds.minimum[i] - origin[i]) * invDirection[i];
+        float far = (bounds.maximum[i] - origin[i]) * invDirection[i];
+        if (near > far) {
+            std::swap(near, far);
+        }
+        enter = std::max(enter, near);
+        exit = std::min(exit, far);
+        if (enter > exit) {
+            return false;
+        }
+    }
+    return true;
+}
+
 class RayArgs {
 public:
     // Inputs
@@ -859,7 +898,19 @@ EntityItemID EntityTree::evalRayIntersection(const glm::vec3& origin, const glm:
 
     bool requireLock = lockType == Octree::Lock;
     bool lockResult = withReadLock([&]{
-        recurseTreeWithOperationSorted(evalRayIntersectionOp, evalRayIntersectionSortingOp, &args);
+        if (_spatialIndex.isEnabled()) {
+            // everything whose element the ray crosses before the closest hit so far is a candidate
+            _spatialIndex.forEachEntity([&](const EntitySpatialIndex::Bounds& bounds) {
+                return rayHitsBounds(bounds, origin, direction, dirReciprocal, distance);
+            }, [&](const EntityItemPointer& entity) {
+                if (EntityTreeElement::evalEntityRayIntersection(entity, origin, direction, element, distance, face,
+                        surfaceNormal, entityIdsToInclude, entityIdsToDiscard, searchFilter, extraInfo)) {
+                    args.entityID = entity->getEntityItemID();
+                }
+            });
+        } else {
+            recurseTreeWithOperationSorted(evalRayIntersectionOp, evalRayIntersectionSortingOp, &args);
+        }
     }, requireLock);
 
     if (accurateResult) {
@@ -1002,6 +1053,21 @@ bool evalClosestEntityOperation(const OctreeElementPointer& element, void* extra
 // NOTE: assumes caller has handled locking
 QUuid EntityTree::evalClosestEntity(const glm::vec3& position, float targetRadius, PickFilter searchFilter) {
     FindClosestEntityArgs args = { position, targetRadius, searchFilter, QUuid(), FLT_MAX };
+    if (_spatialIndex.isEnabled()) {
+        float closestDistanceSquared = targetRadius * targetRadius;
+        _spatialIndex.forEachEntity([&](const EntitySpatialIndex::Bounds& bounds) {
+            return boundsTouchSphere(bounds, position, targetRadius);
+        }, [&](const EntityItemPointer& entity) {
+            if (EntityTreeElement::checkFilterSettings(entity, searchFilter)) {
+                float distanceSquared = glm::distance2(position, entity->getWorldPosition());
+                if (distanceSquared <= closestDistanceSquared) {
+                    args.closestEntity = entity->getID();
+                    closestDistanceSquared = distanceSquared;
+                }
+            }
+        });
+        return args.closestEntity;
+    }
     recurseTreeWithOperation(evalClosestEntityOperation, &args);
     return args.closestEntity;
 }
@@ -1036,7 +1102,18 @@ bool evalInSphereOperation(const OctreeElementPointer& element, void* extraData)
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInSphere(const glm::vec3& center, float radius, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
     FindEntitiesInSphereArgs args = { center, radius, searchFilter, QVector<QUuid>() };
-    recurseTreeWithOperation(evalInSphereOperation, &args);
+    if (_spatialIndex.isEnabled()) {
+        _spatialIndex.forEachEntity([&](const EntitySpatialIndex::Bounds& bounds) {
+            return boundsTouchSphere(bounds, center, radius);
+        }, [&](const EntityItemPointer& entity) {
+            if (EntityTreeElement::checkFilterSettings(entity, searchFilter) &&
+                EntityTreeElement::isEntityInSphere(entity, center, radius)) {
+                args.entities.push_back(entity->getID());
+            }
+        });
+    } else {
+        recurseTreeWithOperation(evalInSphereOperation, &args);
+    }
     foundEntities.swap(args.entities);
 }
 
@@ -1071,7 +1148,18 @@ bool evalInSphereWithTypeOperation(const OctreeElementPointer& element, void* ex
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
     FindEntitiesInSphereWithTypeArgs args = { center, radius, type, searchFilter, QVector<QUuid>() };
-    recurseTreeWithOperation(evalInSphereWithTypeOperation, &args);
+    if (_spatialIndex.isEnabled()) {
+        _spatialIndex.forEachEntity([&](const EntitySpatialIndex::Bounds& bounds) {
+            return boundsTouchSphere(bounds, center, radius);
+        }, [&](const EntityItemPointer& entity) {
+            if (EntityTreeElement::checkFilterSettings(entity, searchFilter) && type == entity->getType() &&
+                EntityTreeElement::isEntityInSphere(entity, center, radius)) {
+                args.entities.push_back(entity->getID());
+            }
+        });
+    } else {
+        recurseTreeWithOperation(evalInSphereWithTypeOperation, &args);
+    }
     foundEntities.swap(args.entities);
 }
 
@@ -1107,7 +1195,24 @@ bool evalInSphereWithNameOperation(const OctreeElementPointer& element, void* ex
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInSphereWithName(const glm::vec3& center, float radius, const QString& name, bool caseSensitive, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
     FindEntitiesInSphereWithNameArgs args = { center, radius, name, caseSensitive, searchFilter, QVector<QUuid>() };
-    recurseTreeWithOperation(evalInSphereWithNameOperation, &args);
+    if (_spatialIndex.isEnabled()) {
+        _spatialIndex.forEachEntity([&](const EntitySpatialIndex::Bounds& bounds) {
+            return boundsTouchSphere(bounds, center, radius);
+        }, [&](const EntityItemPointer& entity) {
+            if (!EntityTreeElement::checkFilterSettings(entity, searchFilter)) {
+                return;
+            }
+            QString entityName = entity->getName();
+            if ((caseSensitive && name != entityName) || (!caseSensitive && name.toLower() != entityName.toLower())) {
+                return;
+            }
+            if (EntityTreeElement::isEntityInSphere(entity, center, radius)) {
+                args.entities.push_back(entity->getID());
+            }
+        });
+    } else {
+        recurseTreeWithOperation(evalInSphereWithNameOperation, &args);
+    }
     foundEntities.swap(args.entities);
 }
 
@@ -1134,7 +1239,19 @@ bool findInCubeOperation(const OctreeElementPointer& element, void* extraData) {
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInCube(const AACube& cube, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
     FindEntitiesInCubeArgs args { cube, searchFilter, QVector<QUuid>() };
-    recurseTreeWithOperation(findInCubeOperation, &args);
+    if (_spatialIndex.isEnabled()) {
+        _spatialIndex.forEachEntity([&](const EntitySpatialIndex::Bounds& bounds) {
+            return boundsTouchBox(bounds, cube.getMinimumPoint(), cube.getMaximumPoint());
+        }, [&](const EntityItemPointer& entity) {
+            bool success;
+            AABox entityBox = entity->getAABox(success);
+            if (success && EntityTreeElement::checkFilterSettings(entity, searchFilter) && entityBox.touches(cube)) {
+                args.entities.push_back(entity->getID());
+            }
+        });
+    } else {
+        recurseTreeWithOperation(findInCubeOperation, &args);
+    }
     foundEntities.swap(args.entities);
 }
 
@@ -1161,8 +1278,20 @@ bool findInBoxOperation(const OctreeElementPointer& element, void* extraData) {
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
     FindEntitiesInBoxArgs args { box, searchFilter, QVector<QUuid>() };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInBoxOperation, &args);
+    if (_spatialIndex.isEnabled()) {
+        _spatialIndex.forEachEntity([&](const EntitySpatialIndex::Bounds& bounds) {
+            return boundsTouchBox(bounds, box.getMinimumPoint(), box.getMaximumPoint());
+        }, [&](const EntityItemPointer& entity) {
+            bool success;
+            AABox entityBox = entity->getAABox(success);
+            if (success && EntityTreeElement::checkFilterSettings(entity, searchFilter) && entityBox.touches(box)) {
+                args.entities.push_back(entity->getID());
+            }
+        });
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInBoxOperation, &args);
+    }
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args.entities);
 }
@@ -1190,8 +1319,22 @@ bool findInFrustumOperation(const OctreeElementPointer& element, void* extraData
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInFrustum(const ViewFrustum& frustum, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
     FindEntitiesInFrustumArgs args = { frustum, searchFilter, QVector<QUuid>() };
-    // NOTE: This should use recursion, since this is a spatial operation
-    recurseTreeWithOperation(findInFrustumOperation, &args);
+    if (_spatialIndex.isEnabled()) {
+        _spatialIndex.forEachEntity([&](const EntitySpatialIndex::Bounds& bounds) {
+            AABox box(bounds.minimum, bounds.maximum - bounds.minimum);
+            return frustum.boxIntersectsFrustum(box) || frustum.boxIntersectsKeyhole(box);
+        }, [&](const EntityItemPointer& entity) {
+            bool success;
+            AABox entityBox = entity->getAABox(success);
+            if (success && EntityTreeElement::checkFilterSettings(entity, searchFilter) &&
+                (frustum.boxIntersectsFrustum(entityBox) || frustum.boxIntersectsKeyhole(entityBox))) {
+                args.entities.push_back(entity->getID());
+            }
+        });
+    } else {
+        // NOTE: This should use recursion, since this is a spatial operation
+        recurseTreeWithOperation(findInFrustumOperation, &args);
+    }
     // swap the two lists of entity pointers instead of copy
     foundEntities.swap(args.entities);
 }
@@ -2282,10 +2425,35 @@ void EntityTree::update(bool simulate) {
     if (simulate && _simulation) {
         withWriteLock([&] {
             _simulation->updateEntities();
+            _spatialIndex.maintain();
+        });
+    } else if (_spatialIndex.needsMaintenance()) {
+        // don't hold up the readers of the tree every frame for a re-sort that is rarely due
+        withWriteLock([&] {
+            _spatialIndex.maintain();
         });
     }
 }
 
+void EntityTree::setSpatialIndexEnabled(bool enabled) {
+    withWriteLock([&] {
+        if (enabled == _spatialIndex.isEnabled()) {
+            return;
+        }
+        _spatialIndex.setEnabled(enabled);
+        if (enabled) {
+            QReadLocker locker(&_entityMapLock);
+            foreach(EntityItemPointer entity, _entityMap) {
+                EntityTreeElementPointer element = entity->getElement();
+                if (element) {
+                    _spatialIndex.addEntity(entity, element->getAACube());
+                }
+            }
+            _spatialIndex.maintain();
+        }
+    });
+}
+
 quint64 EntityTree::getAdjustedConsiderSince(quint64 sinceTime) {
     return (sinceTime - DELETED_ENTITIES_EXTRA_USECS_TO_CONSIDER);
 }
@@ -21,6 +21,7 @@
 #include "AddEntityOperator.h"
 #include "EntityTreeElement.h"
 #include "DeleteEntityOperator.h"
+#include "EntitySpatialIndex.h"
 #include "MovingEntitiesOperator.h"
 
 class EntityTree;
@@ -187,6 +188,12 @@ public:
     void setSimulation(EntitySimulationPointer simulation);
     EntitySimulationPointer getSimulation() const { return _simulation; }
 
+    // while enabled, the spatial queries and ray picks search the flat index instead of traversing the octree
+    bool isSpatialIndexEnabled() const { return _spatialIndex.isEnabled(); }
+    void setSpatialIndexEnabled(bool enabled);
+    EntitySpatialIndex& getSpatialIndex() { return _spatialIndex; }
+    const EntitySpatialIndex& getSpatialIndex() const { return _spatialIndex; }
+
     bool wantEditLogging() const { return _wantEditLogging; }
     void setWantEditLogging(bool value) { _wantEditLogging = value; }
 
@@ -333,6 +340,7 @@ protected:
     QHash<EntityItemID, QPair<QUuid, QString>> _entityNonceMap;
 
     EntitySimulationPointer _simulation;
+    EntitySpatialIndex _spatialIndex;
 
     bool _wantEditLogging = false;
     bool _wantTerseEditLogging = false;
@@ -197,78 +197,89 @@ EntityItemID EntityTreeElement::evalDetailedRayIntersection(const glm::vec3& ori
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
     EntityItemID entityID;
     forEachEntity([&](EntityItemPointer entity) {
-        if (entity->getIgnorePickIntersection() && !searchFilter.bypassIgnore()) {
-            return;
+        if (evalEntityRayIntersection(entity, origin, direction, element, distance, face, surfaceNormal,
+                                      entityIdsToInclude, entityIDsToDiscard, searchFilter, extraInfo)) {
+            entityID = entity->getEntityItemID();
         }
+    });
+    return entityID;
+}
 
-        // use simple line-sphere for broadphase check
-        // (this is faster and more likely to cull results than the filter check below so we do it first)
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        if (!success) {
-            return;
-        }
-        if (!entityBox.rayHitsBoundingSphere(origin, direction)) {
-            return;
-        }
+bool EntityTreeElement::evalEntityRayIntersection(const EntityItemPointer& entity, const glm::vec3& origin,
+                                    const glm::vec3& direction, OctreeElementPointer& element, float& distance, BoxFace& face,
+                                    glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
+                                    const QVector<EntityItemID>& entityIDsToDiscard, PickFilter searchFilter, QVariantMap& extraInfo) {
+    if (entity->getIgnorePickIntersection() && !searchFilter.bypassIgnore()) {
+        return false;
+    }
 
-        if (!checkFilterSettings(entity, searchFilter) ||
-            (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID())) ||
-            (entityIDsToDiscard.size() > 0 && entityIDsToDiscard.contains(entity->getID())) ) {
-            return;
-        }
+    // use simple line-sphere for broadphase check
+    // (this is faster and more likely to cull results than the filter check below so we do it first)
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    if (!success) {
+        return false;
+    }
+    if (!entityBox.rayHitsBoundingSphere(origin, direction)) {
+        return false;
+    }
 
-        // extents is the entity relative, scaled, centered extents of the entity
-        glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
-        glm::mat4 translation = glm::translate(entity->getWorldPosition());
-        glm::mat4 entityToWorldMatrix = translation * rotation;
-        glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+    if (!checkFilterSettings(entity, searchFilter) ||
+        (entityIdsToInclude.size() > 0 && !entityIdsToInclude.contains(entity->getID())) ||
+        (entityIDsToDiscard.size() > 0 && entityIDsToDiscard.contains(entity->getID())) ) {
+        return false;
+    }
 
-        glm::vec3 dimensions = entity->getRaycastDimensions();
-        glm::vec3 registrationPoint = entity->getRegistrationPoint();
-        glm::vec3 corner = -(dimensions * registrationPoint);
+    // extents is the entity relative, scaled, centered extents of the entity
+    glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
+    glm::mat4 translation = glm::translate(entity->getWorldPosition());
+    glm::mat4 entityToWorldMatrix = translation * rotation;
+    glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
 
-        AABox entityFrameBox(corner, dimensions);
+    glm::vec3 dimensions = entity->getRaycastDimensions();
+    glm::vec3 registrationPoint = entity->getRegistrationPoint();
+    glm::vec3 corner = -(dimensions * registrationPoint);
 
-        glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
-        glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
+    AABox entityFrameBox(corner, dimensions);
 
-        // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
-        // and testing intersection there.
-        float localDistance;
-        BoxFace localFace { UNKNOWN_FACE };
-        glm::vec3 localSurfaceNormal;
-        if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, 1.0f / entityFrameDirection, localDistance,
-                                                localFace, localSurfaceNormal)) {
-            if (entityFrameBox.contains(entityFrameOrigin) || localDistance < distance) {
-                // now ask the entity if we actually intersect
-                if (entity->supportsDetailedIntersection()) {
-                    QVariantMap localExtraInfo;
-                    if (entity->findDetailedRayIntersection(origin, direction, element, localDistance,
-                            localFace, localSurfaceNormal, localExtraInfo, searchFilter.isPrecise())) {
-                        if (localDistance < distance) {
-                            distance = localDistance;
-                            face = localFace;
-                            surfaceNormal = localSurfaceNormal;
-                            extraInfo = localExtraInfo;
-                            entityID = entity->getEntityItemID();
-                        }
-                    }
-                } else {
-                    // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
-                    // Never intersect with particle entities
-                    if (localDistance < distance && entity->getType() != EntityTypes::ParticleEffect) {
+    glm::vec3 entityFrameOrigin = glm::vec3(worldToEntityMatrix * glm::vec4(origin, 1.0f));
+    glm::vec3 entityFrameDirection = glm::vec3(worldToEntityMatrix * glm::vec4(direction, 0.0f));
+
+    // we can use the AABox's ray intersection by mapping our origin and direction into the entity frame
+    // and testing intersection there.
+    float localDistance;
+    BoxFace localFace { UNKNOWN_FACE };
+    glm::vec3 localSurfaceNormal;
+    if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, 1.0f / entityFrameDirection, localDistance,
+                                            localFace, localSurfaceNormal)) {
+        if (entityFrameBox.contains(entityFrameOrigin) || localDistance < distance) {
+            // now ask the entity if we actually intersect
+            if (entity->supportsDetailedIntersection()) {
+                QVariantMap localExtraInfo;
+                if (entity->findDetailedRayIntersection(origin, direction, element, localDistance,
+                        localFace, localSurfaceNormal, localExtraInfo, searchFilter.isPrecise())) {
+                    if (localDistance < distance) {
                         distance = localDistance;
                         face = localFace;
-                        surfaceNormal = glm::vec3(rotation * glm::vec4(localSurfaceNormal, 0.0f));
-                        extraInfo = QVariantMap();
-                        entityID = entity->getEntityItemID();
+                        surfaceNormal = localSurfaceNormal;
+                        extraInfo = localExtraInfo;
+                        return true;
                     }
                 }
+            } else {
+                // if the entity type doesn't support a detailed intersection, then just return the non-AABox results
+                // Never intersect with particle entities
+                if (localDistance < distance && entity->getType() != EntityTypes::ParticleEffect) {
+                    distance = localDistance;
+                    face = localFace;
+                    surfaceNormal = glm::vec3(rotation * glm::vec4(localSurfaceNormal, 0.0f));
+                    extraInfo = QVariantMap();
+                    return true;
+                }
             }
         }
-    });
-    return entityID;
+    }
+    return false;
 }
 
 // TODO: change this to use better bounding shape for entity than sphere
@@ -437,57 +448,62 @@ QUuid EntityTreeElement::evalClosetEntity(const glm::vec3& position, PickFilter
     return closestEntity;
 }
 
-void EntityTreeElement::evalEntitiesInSphere(const glm::vec3& position, float radius, PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
-    forEachEntity([&](EntityItemPointer entity) {
-        if (!checkFilterSettings(entity, searchFilter)) {
-            return;
-        }
-
-        bool success;
-        AABox entityBox = entity->getAABox(success);
+bool EntityTreeElement::isEntityInSphere(const EntityItemPointer& entity, const glm::vec3& position, float radius) {
+    bool success;
+    AABox entityBox = entity->getAABox(success);
 
-        // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
-        glm::vec3 penetration;
-        if (success && entityBox.findSpherePenetration(position, radius, penetration)) {
+    // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
+    glm::vec3 penetration;
+    if (success && entityBox.findSpherePenetration(position, radius, penetration)) {
 
-            glm::vec3 dimensions = entity->getRaycastDimensions();
+        glm::vec3 dimensions = entity->getRaycastDimensions();
 
-            // FIXME - consider allowing the entity to determine penetration so that
-            //         entities could presumably do actual hull testing if they wanted to
-            // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
-            //         can we handle the ellipsoid case better? We only currently handle perfect spheres
-            //         with centered registration points
-            if (entity->getShapeType() == SHAPE_TYPE_SPHERE && (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
+        // FIXME - consider allowing the entity to determine penetration so that
+        //         entities could presumably do actual hull testing if they wanted to
+        // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
+        //         can we handle the ellipsoid case better? We only currently handle perfect spheres
+        //         with centered registration points
+        if (entity->getShapeType() == SHAPE_TYPE_SPHERE && (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
 
-                // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
-                //       maximum bounding sphere, which is actually larger than our actual radius
-                float entityTrueRadius = dimensions.x / 2.0f;
+            // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
+            //       maximum bounding sphere, which is actually larger than our actual radius
+            float entityTrueRadius = dimensions.x / 2.0f;
 
-                bool success;
-                if (findSphereSpherePenetration(position, radius, entity->getCenterPosition(success), entityTrueRadius, penetration)) {
-                    if (success) {
-                        foundEntities.push_back(entity->getID());
-                    }
-                }
-            } else {
-                // determine the worldToEntityMatrix that doesn't include scale because
-                // we're going to use the registration aware aa box in the entity frame
-                glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
-                glm::mat4 translation = glm::translate(entity->getWorldPosition());
-                glm::mat4 entityToWorldMatrix = translation * rotation;
-                glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+            bool success;
+            if (findSphereSpherePenetration(position, radius, entity->getCenterPosition(success), entityTrueRadius, penetration)) {
+                return success;
+            }
+        } else {
+            // determine the worldToEntityMatrix that doesn't include scale because
+            // we're going to use the registration aware aa box in the entity frame
+            glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
+            glm::mat4 translation = glm::translate(entity->getWorldPosition());
+            glm::mat4 entityToWorldMatrix = translation * rotation;
+            glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
 
-                glm::vec3 registrationPoint = entity->getRegistrationPoint();
-                glm::vec3 corner = -(dimensions * registrationPoint);
+            glm::vec3 registrationPoint = entity->getRegistrationPoint();
+            glm::vec3 corner = -(dimensions * registrationPoint);
 
-                AABox entityFrameBox(corner, dimensions);
+            AABox entityFrameBox(corner, dimensions);
 
-                glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(position, 1.0f));
-                if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, radius, penetration)) {
-                    foundEntities.push_back(entity->getID());
-                }
+            glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(position, 1.0f));
+            if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, radius, penetration)) {
+                return true;
             }
         }
+    }
+    return false;
+}
+
+void EntityTreeElement::evalEntitiesInSphere(const glm::vec3& position, float radius, PickFilter searchFilter, QVector<QUuid>& foundEntities) const {
+    forEachEntity([&](EntityItemPointer entity) {
+        if (!checkFilterSettings(entity, searchFilter)) {
+            return;
+        }
+
+        if (isEntityInSphere(entity, position, radius)) {
+            foundEntities.push_back(entity->getID());
+        }
     });
 }
 
@@ -497,50 +513,8 @@ void EntityTreeElement::evalEntitiesInSphereWithType(const glm::vec3& position,
             return;
         }
 
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-
-        // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
-        glm::vec3 penetration;
-        if (success && entityBox.findSpherePenetration(position, radius, penetration)) {
-
-            glm::vec3 dimensions = entity->getRaycastDimensions();
-
-            // FIXME - consider allowing the entity to determine penetration so that
-            //         entities could presumably do actual hull testing if they wanted to
-            // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
-            //         can we handle the ellipsoid case better? We only currently handle perfect spheres
-            //         with centered registration points
-            if (entity->getShapeType() == SHAPE_TYPE_SPHERE && (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
-
-                // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
-                //       maximum bounding sphere, which is actually larger than our actual radius
-                float entityTrueRadius = dimensions.x / 2.0f;
-
-                bool success;
-                if (findSphereSpherePenetration(position, radius, entity->getCenterPosition(success), entityTrueRadius, penetration)) {
-                    if (success) {
-                        foundEntities.push_back(entity->getID());
-                    }
-                }
-            } else {
-                // determine the worldToEntityMatrix that doesn't include scale because
-                // we're going to use the registration aware aa box in the entity frame
-                glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
-                glm::mat4 translation = glm::translate(entity->getWorldPosition());
-                glm::mat4 entityToWorldMatrix = translation * rotation;
-                glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
-
-                glm::vec3 registrationPoint = entity->getRegistrationPoint();
-                glm::vec3 corner = -(dimensions * registrationPoint);
-
-                AABox entityFrameBox(corner, dimensions);
-
-                glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(position, 1.0f));
-                if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, radius, penetration)) {
-                    foundEntities.push_back(entity->getID());
-                }
-            }
+        if (isEntityInSphere(entity, position, radius)) {
+            foundEntities.push_back(entity->getID());
         }
     });
 }
@@ -556,50 +530,8 @@ void EntityTreeElement::evalEntitiesInSphereWithName(const glm::vec3& position,
             return;
         }
 
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-
-        // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
-        glm::vec3 penetration;
-        if (success && entityBox.findSpherePenetration(position, radius, penetration)) {
-
-            glm::vec3 dimensions = entity->getRaycastDimensions();
-
-            // FIXME - consider allowing the entity to determine penetration so that
-            //         entities could presumably do actual hull testing if they wanted to
-            // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
-            //         can we handle the ellipsoid case better? We only currently handle perfect spheres
-            //         with centered registration points
-            if (entity->getShapeType() == SHAPE_TYPE_SPHERE && (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
-
-                // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
-                //       maximum bounding sphere, which is actually larger than our actual radius
-                float entityTrueRadius = dimensions.x / 2.0f;
-
-                bool success;
-                if (findSphereSpherePenetration(position, radius, entity->getCenterPosition(success), entityTrueRadius, penetration)) {
-                    if (success) {
-                        foundEntities.push_back(entity->getID());
-                    }
-                }
-            } else {
-                // determine the worldToEntityMatrix that doesn't include scale because
-                // we're going to use the registration aware aa box in the entity frame
-                glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
-                glm::mat4 translation = glm::translate(entity->getWorldPosition());
-                glm::mat4 entityToWorldMatrix = translation * rotation;
-                glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
-
-                glm::vec3 registrationPoint = entity->getRegistrationPoint();
-                glm::vec3 corner = -(dimensions * registrationPoint);
-
-                AABox entityFrameBox(corner, dimensions);
-
-                glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(position, 1.0f));
-                if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, radius, penetration)) {
-                    foundEntities.push_back(entity->getID());
-                }
-            }
+        if (isEntityInSphere(entity, position, radius)) {
+            foundEntities.push_back(entity->getID());
         }
     });
 }
@@ -708,6 +640,9 @@ void EntityTreeElement::cleanupDomainAndNonOwnedEntities() {
             if (!(entity->isLocalEntity() || entity->isMyAvatarEntity())) {
                 entity->preDelete();
                 entity->_element = NULL;
+                if (_myTree) {
+                    _myTree->getSpatialIndex().removeEntity(entity);
+                }
             } else {
                 savedEntities.push_back(entity);
             }
@@ -727,6 +662,9 @@ void EntityTreeElement::cleanupEntities() {
             // access it by smart pointers, when we remove it from the _entityItems
             // we know that it will be deleted.
             entity->_element = NULL;
+            if (_myTree) {
+                _myTree->getSpatialIndex().removeEntity(entity);
+            }
         }
         _entityItems.clear();
     });
@@ -745,6 +683,9 @@ bool EntityTreeElement::removeEntityItem(EntityItemPointer entity, bool deletion
         // NOTE: only EntityTreeElement should ever be changing the value of entity->_element
         assert(entity->_element.get() == this);
         entity->_element = NULL;
+        if (_myTree) {
+            _myTree->getSpatialIndex().removeEntity(entity);
+        }
         bumpChangedContent();
         return true;
     }
@@ -765,6 +706,9 @@ void EntityTreeElement::addEntityItem(EntityItemPointer entity) {
     });
     bumpChangedContent();
     entity->_element = getThisPointer();
+    if (_myTree) {
+        _myTree->getSpatialIndex().addEntity(entity, _cube);
+    }
 }
 
 // will average a "common reduced LOD view" from the the child elements...
@@ -75,8 +75,15 @@ void MovingEntitiesOperator::addEntityToMoveList(EntityItemPointer entity, const
         details.newFound = false;
         details.newCube = newCube;
         details.newCubeClamped = newCubeClamped;
-        _entitiesToMove << details;
-        _lookingCount++;
+        auto itr = _detailsIndices.find(entity.get());
+        if (itr != _detailsIndices.end()) {
+            // moved again before the tree was re-sorted: only the latest cube matters
+            _entitiesToMove[itr->second] = details;
+        } else {
+            _detailsIndices[entity.get()] = _entitiesToMove.size();
+            _entitiesToMove.push_back(details);
+            _lookingCount++;
+        }
 
         if (_wantDebug) {
             qCDebug(entities) << "MovingEntitiesOperator::addEntityToMoveList() -----------------------------";
@@ -98,155 +105,96 @@ void MovingEntitiesOperator::addEntityToMoveList(EntityItemPointer entity, const
     }
 }
 
-// does this entity tree element contain the old entity
-bool MovingEntitiesOperator::shouldRecurseSubTree(const OctreeElementPointer& element) {
-    bool containsEntity = false;
-
-    // If we don't have an old entity, then we don't contain the entity, otherwise
-    // check the bounds
-    if (_entitiesToMove.size() > 0) {
-        const AACube& elementCube = element->getAACube();
-        int detailIndex = 0;
-        foreach(const EntityToMoveDetails& details, _entitiesToMove) {
-
-            if (_wantDebug) {
-                qCDebug(entities) << "MovingEntitiesOperator::shouldRecurseSubTree() details["<< detailIndex <<"]-----------------------------";
-                qCDebug(entities) << "    element:" << element->getAACube();
-                qCDebug(entities) << "    details.entity:" << details.entity->getEntityItemID();
-                qCDebug(entities) << "    details.oldContainingElementCube:" << details.oldContainingElementCube;
-                qCDebug(entities) << "    details.newCube:" << details.newCube;
-                qCDebug(entities) << "    details.newCubeClamped:" << details.newCubeClamped;
-                qCDebug(entities) << "    elementCube.contains(details.newCube)" << elementCube.contains(details.newCube);
-                qCDebug(entities) << "    elementCube.contains(details.newCubeClamped)" << elementCube.contains(details.newCubeClamped);
-                qCDebug(entities) << "--------------------------------------------------------------------------";
-            }
-
-            if (elementCube.contains(details.oldContainingElementCube) || elementCube.contains(details.newCubeClamped)) {
-                containsEntity = true;
-                break; // if it contains at least one, we're good to go
-            }
-            detailIndex++;
-        }
-    }
-    return containsEntity;
-}
-
 bool MovingEntitiesOperator::preRecursion(const OctreeElementPointer& element) {
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-    
+    _elementsVisited++;
+
     // In Pre-recursion, we're generally deciding whether or not we want to recurse this
     // path of the tree. For this operation, we want to recurse the branch of the tree if
-    // any of the following are true:
-    //   * We have not yet found the old entity, and this branch contains our old entity
-    //   * We have not yet found the new entity, and this branch contains our new entity
+    // for any of our entities either of the following is true:
+    //   * We have not yet found its old element, and this branch contains it
+    //   * We have not yet found its new element, and this branch contains its new cube
     //
-    // Note: it's often the case that the branch in question contains both the old entity
-    // and the new entity.
-    
-    bool keepSearching = (_foundOldCount < _lookingCount) || (_foundNewCount < _lookingCount);
-
-    // If we haven't yet found all the entities, and this sub tree contains at least one of our
-    // entities, then we need to keep searching.
-    if (keepSearching && shouldRecurseSubTree(element)) {
+    // Only the moves kept by our parent can be under this element, so those are the only ones we check, and the ones
+    // we keep are the only ones our children will check.
+    // Note: it's often the case that the branch in question contains both the old and the new location.
+    size_t parentStart = _pathStarts.empty() ? 0 : _pathStarts.back();
+    size_t parentEnd = _pathMoves.size();
+    bool isRoot = _pathStarts.empty();
+    _pathStarts.push_back(parentEnd);
+
+    const AACube& elementCube = element->getAACube();
+    int numStillSearching = 0;
+    size_t numCandidates = isRoot ? _entitiesToMove.size() : parentEnd - parentStart;
+    for (size_t i = 0; i < numCandidates; i++) {
+        uint32_t detailsIndex = isRoot ? (uint32_t)i : _pathMoves[parentStart + i];
+        EntityToMoveDetails& details = _entitiesToMove[detailsIndex];
+        bool containsOld = !details.oldFound && elementCube.contains(details.oldContainingElementCube);
+        bool containsNew = !details.newFound && elementCube.contains(details.newCubeClamped);
+        if (!containsOld && !containsNew) {
+            continue;
+        }
 
-        // check against each of our search entities
-        int detailIndex = 0;
-        foreach(const EntityToMoveDetails& details, _entitiesToMove) {
-        
-            if (_wantDebug) {
-                qCDebug(entities) << "MovingEntitiesOperator::preRecursion() details["<< detailIndex <<"]-----------------------------";
-                qCDebug(entities) << "    entityTreeElement:" << entityTreeElement->getAACube();
-                qCDebug(entities) << "    entityTreeElement->bestFitBounds(details.newCube):" << entityTreeElement->bestFitBounds(details.newCube);
-                qCDebug(entities) << "    details.entity:" << details.entity->getEntityItemID();
-                qCDebug(entities) << "    details.oldContainingElementCube:" << details.oldContainingElementCube;
-                qCDebug(entities) << "    entityTreeElement:" << entityTreeElement.get();
-                qCDebug(entities) << "    details.newCube:" << details.newCube;
-                qCDebug(entities) << "    details.newCubeClamped:" << details.newCubeClamped;
-                qCDebug(entities) << "    _lookingCount:" << _lookingCount;
-                qCDebug(entities) << "    _foundOldCount:" << _foundOldCount;
-                qCDebug(entities) << "--------------------------------------------------------------------------";
-            }
-        
+        // If this is the old element of the entity we're looking for, we're done looking for it.
+        if (containsOld && entityTreeElement == details.oldContainingElement) {
+            // DO NOT remove the entity here.  It will be removed when added to the destination element.
+            details.oldFound = true;
+            _foundOldCount++;
+        }
 
-            // If this is one of the old elements we're looking for, then ask it to remove the old entity
-            if (!details.oldFound && entityTreeElement == details.oldContainingElement) {
-                // DO NOT remove the entity here.  It will be removed when added to the destination element.
-                _foundOldCount++;
-                //details.oldFound = true; // TODO: would be nice to add this optimization
-                if (_wantDebug) {
-                    qCDebug(entities) << "MovingEntitiesOperator::preRecursion() -----------------------------";
-                    qCDebug(entities) << "    FOUND OLD - REMOVING";
-                    qCDebug(entities) << "    entityTreeElement == details.oldContainingElement";
-                    qCDebug(entities) << "--------------------------------------------------------------------------";
+        // If this element is the best fit for the new bounds of this entity then add the entity to the element
+        if (containsNew && entityTreeElement->bestFitBounds(details.newCube)) {
+            // remove from the old before adding
+            EntityTreeElementPointer oldElement = details.entity->getElement();
+            if (oldElement != entityTreeElement) {
+                if (oldElement) {
+                    oldElement->removeEntityItem(details.entity);
                 }
+                entityTreeElement->addEntityItem(details.entity);
+            } else {
+                entityTreeElement->bumpChangedContent();
             }
+            details.newFound = true;
+            _foundNewCount++;
+        }
 
-            // If this element is the best fit for the new bounds of this entity then add the entity to the element
-            if (!details.newFound && entityTreeElement->bestFitBounds(details.newCube)) {
-                // remove from the old before adding
-                EntityTreeElementPointer oldElement = details.entity->getElement();
-                if (oldElement != entityTreeElement) {
-                    if (oldElement) {
-                        oldElement->removeEntityItem(details.entity);
-                    }
-                    entityTreeElement->addEntityItem(details.entity);
-                } else {
-                    entityTreeElement->bumpChangedContent();
-                }
-                _foundNewCount++;
-                //details.newFound = true; // TODO: would be nice to add this optimization
-                if (_wantDebug) {
-                    qCDebug(entities) << "MovingEntitiesOperator::preRecursion() -----------------------------";
-                    qCDebug(entities) << "    FOUND NEW - ADDING";
-                    qCDebug(entities) << "    entityTreeElement->bestFitBounds(details.newCube)";
-                    qCDebug(entities) << "--------------------------------------------------------------------------";
-                }
-            }
-            detailIndex++;
+        // keep it even when it's done, this element is on its path
+        _pathMoves.push_back(detailsIndex);
+        if (!details.oldFound || !details.newFound) {
+            numStillSearching++;
         }
-        // if we haven't found all of our search for entities, then keep looking
-        keepSearching = (_foundOldCount < _lookingCount) || (_foundNewCount < _lookingCount);
     }
 
-    return keepSearching; // if we haven't yet found it, keep looking
+    if (_wantDebug) {
+        qCDebug(entities) << "MovingEntitiesOperator::preRecursion() element:" << elementCube
+            << "moves below:" << numStillSearching
+            << "found old:" << _foundOldCount << "found new:" << _foundNewCount << "of" << _lookingCount;
+    }
+
+    // recurse only into the branches that still have moves of ours in them
+    return numStillSearching > 0;
 }
 
 bool MovingEntitiesOperator::postRecursion(const OctreeElementPointer& element) {
     // Post-recursion is the unwinding process. For this operation, while we
-    // unwind we want to mark the path as being dirty if we changed it below.
-    // We might have two paths, one for the old entity and one for the new entity.
-    bool keepSearching = (_foundOldCount < _lookingCount) || (_foundNewCount < _lookingCount);
-
-    // As we unwind, if we're in either of these two paths, we mark our element
-    // as dirty.
-    if ((shouldRecurseSubTree(element))) {
+    // unwind we want to mark the path as being dirty if we changed it below,
+    // and remember it so that its empty leaves can be pruned once we're done.
+    size_t start = _pathStarts.back();
+    _pathStarts.pop_back();
+    bool isOnPath = _pathMoves.size() > start;
+    _pathMoves.resize(start);
+
+    if (isOnPath) {
         element->markWithChangedTime();
+        _elementsToPrune.push_back(std::static_pointer_cast<EntityTreeElement>(element));
     }
 
-    // It's not OK to prune if we have the potential of deleting the original containing element
-    // because if we prune the containing element then new might end up reallocating the same memory later 
-    // and that will confuse our logic.
-    // 
-    // it's ok to prune if:
-    // 2) this subtree doesn't contain any old elements
-    // 3) this subtree contains an old element, but this element isn't a direct parent of any old containing element
-
-    bool elementSubTreeContainsOldElements = false;
-    bool elementIsDirectParentOfOldElment = false;
-    foreach(const EntityToMoveDetails& details, _entitiesToMove) {
-        if (element->getAACube().contains(details.oldContainingElementCube)) {
-            elementSubTreeContainsOldElements = true;
-        }
-        if (element->isParentOf(details.oldContainingElement)) {
-            elementIsDirectParentOfOldElment = true;
-        }
+    if (_pathStarts.empty()) {
+        // It's not OK to prune while still moving entities, since we might delete an old containing element we
+        // have yet to visit (or one we are about to add an entity to), so all the pruning waits until the end.
+        pruneVisitedElements();
     }
-    if (!elementSubTreeContainsOldElements || !elementIsDirectParentOfOldElment) {
-        EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->pruneChildren(); // take this opportunity to prune any empty leaves
-    }
-
-    return keepSearching; // if we haven't yet found it, keep looking
+    return isStillSearching(); // if we haven't yet found them all, keep looking
 }
 
 OctreeElementPointer MovingEntitiesOperator::possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex) {
@@ -255,30 +203,51 @@ OctreeElementPointer MovingEntitiesOperator::possiblyCreateChildAt(const OctreeE
     if (_foundNewCount < _lookingCount) {
 
         float childElementScale = element->getAACube().getScale() / 2.0f; // all of our children will be half our scale
-    
-        // check against each of our entities
-        foreach(const EntityToMoveDetails& details, _entitiesToMove) {
+
+        // check against each of the moves under this element
+        for (size_t i = _pathStarts.back(); i < _pathMoves.size(); i++) {
+            const EntityToMoveDetails& details = _entitiesToMove[_pathMoves[i]];
 
             // if the scale of our desired cube is smaller than our children, then consider making a child
-            if (details.newCubeClamped.getLargestDimension() <= childElementScale) {
+            if (!details.newFound && details.newCubeClamped.getLargestDimension() <= childElementScale) {
 
                 int indexOfChildContainingNewEntity = element->getMyChildContaining(details.newCubeClamped);
-            
+
                 // If the childIndex we were asked if we wanted to create contains this newCube,
                 // then we will create this branch and continue. We can exit this loop immediately
                 // because if we need this branch for any one entity then it doesn't matter if it's
                 // needed for more entities.
                 if (childIndex == indexOfChildContainingNewEntity) {
+                    _elementsCreated++;
                     return element->addChildAtIndex(childIndex);
                 }
             }
         }
     }
-    return NULL; 
+    return NULL;
+}
+
+void MovingEntitiesOperator::pruneVisitedElements() {
+    // the elements were collected on the way back up, so children come before their parents and whole empty
+    // branches fold away leaf by leaf
+    for (auto& element : _elementsToPrune) {
+        int childCount = element->getChildCount();
+        if (element->pruneChildren()) {
+            _elementsPruned += childCount - element->getChildCount();
+        }
+    }
+    _elementsToPrune.clear();
 }
 
 void MovingEntitiesOperator::reset() {
     _entitiesToMove.clear();
+    _detailsIndices.clear();
+    _pathMoves.clear();
+    _pathStarts.clear();
+    _elementsToPrune.clear();
+    _elementsVisited = 0;
+    _elementsCreated = 0;
+    _elementsPruned = 0;
     _foundOldCount = 0;
     _foundNewCount = 0;
     _lookingCount = 0;
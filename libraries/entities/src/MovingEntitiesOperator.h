@@ -12,7 +12,8 @@
 #ifndef hifi_MovingEntitiesOperator_h
 #define hifi_MovingEntitiesOperator_h
 
-#include <QSet>
+#include <unordered_map>
+#include <vector>
 
 #include "EntityItem.h"
 
@@ -28,14 +29,12 @@ public:
     bool newFound;
 };
 
-inline uint qHash(const EntityToMoveDetails& a, uint seed) {
-    return qHash(a.entity->getEntityItemID(), seed);
-}
-
-inline bool operator==(const EntityToMoveDetails& a, const EntityToMoveDetails& b) {
-    return a.entity->getEntityItemID() == b.entity->getEntityItemID();
-}
-
+// Re-sorts a batch of moved entities into the tree in a single traversal.
+//
+// Each element visited only considers the moves whose old element or new cube lies inside it: the batch is split
+// among the children on the way down, so the entities bound for the same cell travel down its path together and the
+// cost grows with entities * depth rather than entities * elements visited.  Empty leaves are pruned once every entity
+// has been placed.
 class MovingEntitiesOperator : public RecurseOctreeOperator {
 public:
     MovingEntitiesOperator();
@@ -47,10 +46,28 @@ public:
     virtual OctreeElementPointer possiblyCreateChildAt(const OctreeElementPointer& element, int childIndex) override;
     bool hasMovingEntities() const { return _entitiesToMove.size() > 0; }
     void reset();
+
+    // what the last traversal cost
+    int getNumEntitiesMoved() const { return (int)_entitiesToMove.size(); }
+    int getNumElementsVisited() const { return _elementsVisited; }
+    int getNumElementsCreated() const { return _elementsCreated; }
+    int getNumElementsPruned() const { return _elementsPruned; }
+
 private:
-    bool shouldRecurseSubTree(const OctreeElementPointer& element);
+    bool isStillSearching() const { return (_foundOldCount < _lookingCount) || (_foundNewCount < _lookingCount); }
+    void pruneVisitedElements();
+
+    std::vector<EntityToMoveDetails> _entitiesToMove;
+    std::unordered_map<EntityItem*, size_t> _detailsIndices;
+
+    // the moves under each element on the current path, stacked: the ones of the deepest element start at _pathStarts.back()
+    std::vector<uint32_t> _pathMoves;
+    std::vector<size_t> _pathStarts;
+    std::vector<EntityTreeElementPointer> _elementsToPrune;
 
-    QSet<EntityToMoveDetails> _entitiesToMove;
+    int _elementsVisited { 0 };
+    int _elementsCreated { 0 };
+    int _elementsPruned { 0 };
     int _foundOldCount { 0 };
     int _foundNewCount { 0 };
     int _lookingCount { 0 };
@@ -12,6 +12,7 @@
 #include "SimpleEntitySimulation.h"
 
 #include <DirtyOctreeElementOperator.h>
+#include <Profile.h>
 
 #include "EntityItem.h"
 #include "EntitiesLogging.h"
@@ -48,6 +49,10 @@ void SimpleEntitySimulation::clearOwnership(const QUuid& ownerID) {
 }
 
 void SimpleEntitySimulation::updateEntities() {
+    if (_regionThrottleEnabled) {
+        QMutexLocker lock(&_mutex);
+        categorizeRegions();
+    }
     EntitySimulation::updateEntities();
     QMutexLocker lock(&_mutex);
     uint64_t now = usecTimestampNow();
@@ -61,9 +66,7 @@ void SimpleEntitySimulation::addEntityToInternalLists(EntityItemPointer entity)
         if (entity->getDynamic()) {
             // we don't allow dynamic objects to move without an owner so nothing to do here
         } else if (entity->isMovingRelativeToParent()) {
-            SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-            if (itr != _simpleKinematicEntities.end()) {
-                _simpleKinematicEntities.insert(entity);
+            if (_simpleKinematicEntities.insert(entity)) {
                 entity->setLastSimulated(usecTimestampNow());
             }
         }
@@ -72,9 +75,7 @@ void SimpleEntitySimulation::addEntityToInternalLists(EntityItemPointer entity)
         _nextStaleOwnershipExpiry = glm::min(_nextStaleOwnershipExpiry, entity->getSimulationOwnershipExpiry());
 
         if (entity->isMovingRelativeToParent()) {
-            SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-            if (itr != _simpleKinematicEntities.end()) {
-                _simpleKinematicEntities.insert(entity);
+            if (_simpleKinematicEntities.insert(entity)) {
                 entity->setLastSimulated(usecTimestampNow());
             }
         }
@@ -84,6 +85,9 @@ void SimpleEntitySimulation::addEntityToInternalLists(EntityItemPointer entity)
 void SimpleEntitySimulation::removeEntityFromInternalLists(EntityItemPointer entity) {
     _entitiesWithSimulationOwner.remove(entity);
     _entitiesThatNeedSimulationOwner.remove(entity);
+    if (_entitiesInSpace.remove(entity)) {
+        removeProxy(entity);
+    }
     EntitySimulation::removeEntityFromInternalLists(entity);
 }
 
@@ -98,21 +102,13 @@ void SimpleEntitySimulation::processChangedEntity(const EntityItemPointer& entit
 
             if (entity->getDynamic()) {
                 // we don't allow dynamic objects to move without an owner
-                SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                if (itr != _simpleKinematicEntities.end()) {
-                    _simpleKinematicEntities.erase(itr);
-                }
+                _simpleKinematicEntities.remove(entity);
             } else if (entity->isMovingRelativeToParent()) {
-                SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                if (itr == _simpleKinematicEntities.end()) {
-                    _simpleKinematicEntities.insert(entity);
+                if (_simpleKinematicEntities.insert(entity)) {
                     entity->setLastSimulated(usecTimestampNow());
                 }
             } else {
-                SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                if (itr != _simpleKinematicEntities.end()) {
-                    _simpleKinematicEntities.erase(itr);
-                }
+                _simpleKinematicEntities.remove(entity);
             }
         } else {
             QMutexLocker lock(&_mutex);
@@ -121,19 +117,18 @@ void SimpleEntitySimulation::processChangedEntity(const EntityItemPointer& entit
             _entitiesThatNeedSimulationOwner.remove(entity);
 
             if (entity->isMovingRelativeToParent()) {
-                SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                if (itr == _simpleKinematicEntities.end()) {
-                    _simpleKinematicEntities.insert(entity);
+                if (_simpleKinematicEntities.insert(entity)) {
                     entity->setLastSimulated(usecTimestampNow());
                 }
             } else {
-                SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                if (itr != _simpleKinematicEntities.end()) {
-                    _simpleKinematicEntities.erase(itr);
-                }
+                _simpleKinematicEntities.remove(entity);
             }
         }
     }
+    if ((flags & Simulation::DIRTY_POSITION) && _entitiesInSpace.contains(entity)) {
+        QMutexLocker lock(&_mutex);
+        updateProxy(entity);
+    }
     entity->clearDirtyFlags();
 }
 
@@ -141,19 +136,123 @@ void SimpleEntitySimulation::clearEntities() {
     QMutexLocker lock(&_mutex);
     _entitiesWithSimulationOwner.clear();
     _entitiesThatNeedSimulationOwner.clear();
+    clearProxies();
     EntitySimulation::clearEntities();
 }
 
 void SimpleEntitySimulation::sortEntitiesThatMoved() {
-    SetOfEntities::iterator itemItr = _entitiesToSort.begin();
-    while (itemItr != _entitiesToSort.end()) {
-        EntityItemPointer entity = *itemItr;
+    for (auto& entity : _entitiesToSort) {
         entity->updateQueryAACube();
-        ++itemItr;
+        if (_entitiesInSpace.contains(entity)) {
+            updateProxy(entity);
+        }
     }
     EntitySimulation::sortEntitiesThatMoved();
 }
 
+bool SimpleEntitySimulation::isDueForKinematicStep(const EntityItemPointer& entity, uint64_t now) {
+    // protected: _mutex lock is guaranteed
+    bool isDue = true;
+    if (_regionThrottleEnabled) {
+        if (_entitiesInSpace.insert(entity)) {
+            // it is UNKNOWN until the next categorization, meanwhile it steps every frame
+            int32_t proxyID = _space->allocateID();
+            SpatiallyNestablePointer nestable = std::static_pointer_cast<SpatiallyNestable>(entity);
+            _spaceTransaction.reset(proxyID, workload::Sphere(entity->getWorldPosition(), entity->getBoundingRadius()),
+                                    workload::Owner(nestable));
+            entity->setSpaceIndex(proxyID);
+        } else {
+            isDue = _regionThrottle.isDue(_space->getRegion(entity->getSpaceIndex()), entity->getLastSimulated(), now);
+        }
+    }
+    if (isDue) {
+        ++_numKinematicSteps;
+    } else {
+        ++_numKinematicStepsHeldBack;
+    }
+    return isDue;
+}
+
+void SimpleEntitySimulation::setRegionThrottleEnabled(bool enabled) {
+    QMutexLocker lock(&_mutex);
+    if (enabled == _regionThrottleEnabled) {
+        return;
+    }
+    if (enabled) {
+        if (!_space) {
+            _space = std::make_shared<workload::Space>();
+        }
+        // the views are remade from the positions already known
+        std::lock_guard<std::mutex> positionsLock(_agentPositionsMutex);
+        _agentPositionsChanged = true;
+    } else {
+        clearProxies();
+    }
+    _regionThrottleEnabled = enabled;
+}
+
+void SimpleEntitySimulation::setAgentPositions(std::vector<glm::vec3> agentPositions) {
+    std::lock_guard<std::mutex> lock(_agentPositionsMutex);
+    _agentPositions.swap(agentPositions);
+    _agentPositionsChanged = true;
+}
+
+void SimpleEntitySimulation::categorizeRegions() {
+    // protected: _mutex lock is guaranteed
+    PROFILE_RANGE_EX(simulation_physics, "CategorizeRegions", 0xffff00ff, (uint64_t)_entitiesInSpace.size());
+
+    // only the moving entities keep a proxy, it is made again if they move again
+    size_t i = 0;
+    while (i < _entitiesInSpace.size()) {
+        EntityItemPointer entity = _entitiesInSpace[i];
+        if (_simpleKinematicEntities.contains(entity)) {
+            ++i;
+        } else {
+            _entitiesInSpace.removeAt(i);
+            removeProxy(entity);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_agentPositionsMutex);
+        if (_agentPositionsChanged) {
+            _regionThrottle.evalViews(_agentPositions, _views);
+            _space->setViews(_views);
+            _agentPositionsChanged = false;
+        }
+    }
+    _space->enqueueTransaction(std::move(_spaceTransaction));
+    _spaceTransaction.clear();
+    _space->enqueueFrame();
+    _space->processTransactionQueue();
+    _space->categorizeAndGetChanges(_regionChanges);
+    _regionChanges.clear();
+}
+
+void SimpleEntitySimulation::updateProxy(const EntityItemPointer& entity) {
+    _spaceTransaction.update(entity->getSpaceIndex(),
+                             workload::Sphere(entity->getWorldPosition(), entity->getBoundingRadius()));
+}
+
+void SimpleEntitySimulation::removeProxy(const EntityItemPointer& entity) {
+    _spaceTransaction.remove(entity->getSpaceIndex());
+    entity->clearSpaceIndex();
+}
+
+void SimpleEntitySimulation::clearProxies() {
+    for (auto& entity : _entitiesInSpace) {
+        entity->clearSpaceIndex();
+    }
+    _entitiesInSpace.clear();
+    _spaceTransaction.clear();
+    if (_space) {
+        // which also forgets the views
+        _space->clear();
+        std::lock_guard<std::mutex> lock(_agentPositionsMutex);
+        _agentPositionsChanged = true;
+    }
+}
+
 void SimpleEntitySimulation::expireStaleOwnerships(uint64_t now) {
     if (now > _nextStaleOwnershipExpiry) {
         _nextStaleOwnershipExpiry = (uint64_t)(-1);
@@ -164,10 +263,7 @@ void SimpleEntitySimulation::expireStaleOwnerships(uint64_t now) {
             if (now > expiry) {
                 itemItr = _entitiesWithSimulationOwner.erase(itemItr);
                 if (entity->getDynamic()) {
-                    SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                    if (itr != _simpleKinematicEntities.end()) {
-                        _simpleKinematicEntities.erase(itr);
-                    }
+                    _simpleKinematicEntities.remove(entity);
                 }
 
                 // remove ownership and dirty all the tree elements that contain the it
@@ -12,6 +12,11 @@
 #ifndef hifi_SimpleEntitySimulation_h
 #define hifi_SimpleEntitySimulation_h
 
+#include <mutex>
+
+#include <workload/RegionThrottle.h>
+#include <workload/Space.h>
+
 #include "EntitySimulation.h"
 
 class SimpleEntitySimulation;
@@ -29,20 +34,54 @@ public:
     void clearEntities() override;
     void updateEntities() override;
 
+    // When throttled by region, the moving entities are categorized by a workload::Space against views centered on
+    // the agents, and those only in R3 or R4 are stepped at the intervals of the region throttle rather than every
+    // frame.  Off until enabled, which the entity server does unless its regionThrottle setting is turned off.
+    void setRegionThrottleEnabled(bool enabled);
+    bool isRegionThrottleEnabled() const { return _regionThrottleEnabled; }
+    workload::RegionThrottle& getRegionThrottle() { return _regionThrottle; }
+
+    // can be called from any thread, the views follow on the next updateEntities
+    void setAgentPositions(std::vector<glm::vec3> agentPositions);
+
+    uint64_t getNumKinematicSteps() const { return _numKinematicSteps; }
+    uint64_t getNumKinematicStepsHeldBack() const { return _numKinematicStepsHeldBack; }
+
 protected:
     void addEntityToInternalLists(EntityItemPointer entity) override;
     void removeEntityFromInternalLists(EntityItemPointer entity) override;
     void processChangedEntity(const EntityItemPointer& entity) override;
 
     void sortEntitiesThatMoved() override;
+    bool isDueForKinematicStep(const EntityItemPointer& entity, uint64_t now) override;
 
     void expireStaleOwnerships(uint64_t now);
     void stopOwnerlessEntities(uint64_t now);
 
+    void categorizeRegions();
+    void updateProxy(const EntityItemPointer& entity);
+    void removeProxy(const EntityItemPointer& entity);
+    void clearProxies();
+
     SetOfEntities _entitiesWithSimulationOwner;
     SetOfEntities _entitiesThatNeedSimulationOwner;
     uint64_t _nextOwnerlessExpiry { 0 };
     uint64_t _nextStaleOwnershipExpiry { (uint64_t)(-1) };
+
+    workload::SpacePointer _space;
+    workload::RegionThrottle _regionThrottle;
+    workload::Transaction _spaceTransaction; // proxy changes made since the space was last categorized
+    workload::Views _views;
+    workload::Changes _regionChanges;
+    DenseEntitySet _entitiesInSpace { EntityItem::SIMULATION_LIST_IN_SPACE }; // the entities with a proxy
+
+    std::mutex _agentPositionsMutex;
+    std::vector<glm::vec3> _agentPositions;
+    bool _agentPositionsChanged { false };
+
+    uint64_t _numKinematicSteps { 0 };
+    uint64_t _numKinematicStepsHeldBack { 0 };
+    bool _regionThrottleEnabled { false };
 };
 
 #endif // hifi_SimpleEntitySimulation_h
@@ -124,6 +124,9 @@ public:
 
     FBXNode _rootNode;
     static FBXNode parseFBX(QIODevice* device);
+    /// Parses an FBX document held in memory.  Binary documents are read in place, without an intermediate stream.
+    /// \exception QString if the document is corrupt
+    static FBXNode parseFBX(const hifi::ByteArray& data);
 
     HFMModel* extractHFMModel(const hifi::VariantHash& mapping, const QString& url);
 
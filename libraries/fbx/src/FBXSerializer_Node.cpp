@@ -11,199 +11,157 @@
 
 #include "FBXSerializer.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+
+#include <zlib.h>
+
 #include <QtCore/QBuffer>
-#include <QtCore/QDataStream>
 #include <QtCore/QIODevice>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
 #include <QtCore/QDebug>
-#include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
 
 #include <shared/NsightHelpers.h>
 #include <hfm/ModelFormatLogging.h>
 
-template<class T>
-int streamSize() {
-    return sizeof(T);
-}
+// Reads an FBX binary document in place.  Every read is bounds checked against the end of the data,
+// so a truncated or corrupt file throws instead of running off the end of the buffer.
+class FBXBinaryReader {
+public:
+    FBXBinaryReader(const char* data, size_t size) : _begin(data), _cursor(data), _end(data + size) { }
 
-template<bool>
-int streamSize() {
-    return 1;
-}
+    size_t getPosition() const { return _cursor - _begin; }
+    size_t getBytesAvailable() const { return _end - _cursor; }
 
-template<class T>
-QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
+    const char* take(size_t length) {
+        if (length > getBytesAvailable()) {
+            throw QString("FBX file most likely corrupt: unexpected end of data");
+        }
+        const char* data = _cursor;
+        _cursor += length;
+        return data;
+    }
 
-    in >> arrayLength;
+    template<class T>
+    T read() {
+        T value;
+        memcpy(&value, take(sizeof(T)), sizeof(T));
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        std::reverse((char*)&value, (char*)&value + sizeof(T));
+#endif
+        return value;
+    }
+
+private:
+    const char* _begin;
+    const char* _cursor;
+    const char* _end;
+};
+
+template<class T>
+QVariant readBinaryArray(FBXBinaryReader& in) {
+    quint32 arrayLength = in.read<quint32>();
     if (arrayLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
         throw QString("FBX file most likely corrupt: binary data exceeds data limits");
     }
-    in >> encoding;
-    in >> compressedLength;
-    if (compressedLength > std::numeric_limits<int>::max() / sizeof(T)) { // Upcoming byte containers are limited to max signed int
-        throw QString("FBX file most likely corrupt: compressed binary data exceeds data limits");
-    }
-    position += sizeof(quint32) * 3;
+    quint32 encoding = in.read<quint32>();
+    quint32 compressedLength = in.read<quint32>();
 
+    // the array is inflated, or copied, straight into its final storage
     QVector<T> values;
-    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
-        values.resize(arrayLength);
-        hifi::ByteArray arrayData;
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            hifi::ByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            arrayData = qUncompress(compressed);
-            if (arrayData.isEmpty() ||
-                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
+    values.resize(arrayLength);
+    uLongf byteLength = sizeof(T) * arrayLength;
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        const char* compressed = in.take(compressedLength);
+        if (arrayLength > 0) {
+            uLongf uncompressedLength = byteLength;
+            if (uncompress(reinterpret_cast<Bytef*>(values.data()), &uncompressedLength,
+                           reinterpret_cast<const Bytef*>(compressed), compressedLength) != Z_OK ||
+                uncompressedLength != byteLength) {
                 throw QString("corrupt fbx file");
             }
-        } else {
-            arrayData.resize(sizeof(T) * arrayLength);
-            position += sizeof(T) * arrayLength;
-            in.readRawData(arrayData.data(), arrayData.size());
         }
+    } else if (arrayLength > 0) {
+        memcpy(values.data(), in.take(byteLength), byteLength);
+    }
 
-        if (arrayData.size() > 0) {
-            memcpy(&values[0], arrayData.constData(), arrayData.size());
-        }
-    } else {
-        values.reserve(arrayLength);
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            hifi::ByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            hifi::ByteArray uncompressed = qUncompress(compressed);
-            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-            QDataStream uncompressedIn(uncompressed);
-            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                uncompressedIn >> value;
-                values.append(value);
-            }
-        } else {
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                in >> value;
-                position += streamSize<T>();
-                values.append(value);
-            }
-        }
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    for (T& value : values) {
+        std::reverse((char*)&value, (char*)&value + sizeof(T));
     }
+#endif
     return QVariant::fromValue(values);
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
+QVariant parseBinaryFBXProperty(FBXBinaryReader& in) {
+    char ch = in.read<char>();
     switch (ch) {
         case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint16>());
         }
         case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<quint8>() != 0);
         }
         case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint32>());
         }
         case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<float>());
         }
         case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<double>());
         }
         case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
+            return QVariant::fromValue(in.read<qint64>());
         }
         case 'f': {
-            return readBinaryArray<float>(in, position);
+            return readBinaryArray<float>(in);
         }
         case 'd': {
-            return readBinaryArray<double>(in, position);
+            return readBinaryArray<double>(in);
         }
         case 'l': {
-            return readBinaryArray<qint64>(in, position);
+            return readBinaryArray<qint64>(in);
         }
         case 'i': {
-            return readBinaryArray<qint32>(in, position);
+            return readBinaryArray<qint32>(in);
         }
         case 'b': {
-            return readBinaryArray<bool>(in, position);
+            return readBinaryArray<bool>(in);
         }
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            // strings and raw data are copied out, the node tree outlives the source data
+            quint32 length = in.read<quint32>();
+            return QVariant::fromValue(hifi::ByteArray(in.take(length), length));
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+FBXNode parseBinaryFBXNode(FBXBinaryReader& in, bool has64BitPositions = false) {
     qint64 endOffset;
     quint64 propertyCount;
     quint64 propertyListLength;
-    quint8 nameLength;
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
     // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
-    // values and then assign to our actual 64bit values.
+    // from here on out, but if the file is an older format we read the 32bit values and widen them.
     if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+        endOffset = in.read<qint64>();
+        propertyCount = in.read<quint64>();
+        propertyListLength = in.read<quint64>();
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = in.read<qint32>();
+        propertyCount = in.read<quint32>();
+        propertyListLength = in.read<quint32>();
+    }
+    Q_UNUSED(propertyListLength);
+    quint8 nameLength = in.read<quint8>();
 
     FBXNode node;
     const int MIN_VALID_OFFSET = 40;
@@ -211,15 +169,14 @@ FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPosition
         // use a null name to indicate a null node
         return node;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = hifi::ByteArray(in.take(nameLength), nameLength);
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseBinaryFBXProperty(in));
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (endOffset > (qint64)in.getPosition()) {
+        FBXNode child = parseBinaryFBXNode(in, has64BitPositions);
         if (!child.name.isNull()) {
             node.children.append(child);
         }
@@ -369,9 +326,20 @@ FBXNode FBXSerializer::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
+
+    // the binary parser works on the whole document in memory
+    return parseFBX(device->readAll());
+}
+
+FBXNode FBXSerializer::parseFBX(const hifi::ByteArray& data) {
+    if (!data.startsWith(FBX_BINARY_PROLOG)) {
+        QBuffer buffer(const_cast<hifi::ByteArray*>(&data));
+        buffer.open(QIODevice::ReadOnly);
+        return parseFBX(&buffer);
+    }
+    PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, data.size());
+
+    FBXBinaryReader in(data.constData(), data.size());
 
     // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
     // of the FBX binary format
@@ -380,17 +348,14 @@ FBXNode FBXSerializer::parseFBX(QIODevice* device) {
     //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
     //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
     //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
-    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
+    in.take(FBX_HEADER_BYTES_BEFORE_VERSION);
+    quint32 fileVersion = in.read<quint32>();
     bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
 
     // parse the top-level node
     FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
+    while (in.getBytesAvailable()) {
+        FBXNode next = parseBinaryFBXNode(in, has64BitPositions);
         if (next.name.isNull()) {
             return top;
 
@@ -410,6 +375,7 @@ glm::vec3 FBXSerializer::getVec3(const QVariantList& properties, int index) {
 
 QVector<glm::vec4> FBXSerializer::createVec4Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec4> values;
+    values.reserve(doubleVector.size() / 4);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 4) * 4); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -423,6 +389,7 @@ QVector<glm::vec4> FBXSerializer::createVec4Vector(const QVector<double>& double
 
 QVector<glm::vec4> FBXSerializer::createVec4VectorRGBA(const QVector<double>& doubleVector, glm::vec4& average) {
     QVector<glm::vec4> values;
+    values.reserve(doubleVector.size() / 4);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 4) * 4); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -440,6 +407,7 @@ QVector<glm::vec4> FBXSerializer::createVec4VectorRGBA(const QVector<double>& do
 
 QVector<glm::vec3> FBXSerializer::createVec3Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec3> values;
+    values.reserve(doubleVector.size() / 3);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 3) * 3); it != end; ) {
         float x = *it++;
         float y = *it++;
@@ -451,6 +419,7 @@ QVector<glm::vec3> FBXSerializer::createVec3Vector(const QVector<double>& double
 
 QVector<glm::vec2> FBXSerializer::createVec2Vector(const QVector<double>& doubleVector) {
     QVector<glm::vec2> values;
+    values.reserve(doubleVector.size() / 2);
     for (const double* it = doubleVector.constData(), *end = it + ((doubleVector.size() / 2) * 2); it != end; ) {
         float s = *it++;
         float t = *it++;
@@ -0,0 +1,830 @@
+//
+//  BakedModelCodec.cpp
+//  model-baker/src/model-baker
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakedModelCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QDataStream>
+
+#include <gpu/Stream.h>
+
+#include "ModelBakerLogging.h"
+
+using namespace baker;
+
+const int BakedModelCodec::VERSION = 1;
+
+static const uint32_t BAKED_MODEL_MAGIC = 0x424d4648; // "HFMB"
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// build options that change the contents of the graphics meshes
+static const uint32_t LAYOUT_FLAGS = (HFM_PACK_NORMALS ? 1 : 0) | (HFM_PACK_COLORS ? 2 : 0);
+
+// variants are only stored for the flow configuration, pin the stream version so a Qt update doesn't invalidate the cache
+static const QDataStream::Version VARIANT_STREAM_VERSION = QDataStream::Qt_5_6;
+
+struct BakedModelHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t layoutFlags;
+    uint32_t sizeofMat4;
+    uint32_t sizeofQuat;
+};
+
+static BakedModelHeader makeHeader() {
+    return { BAKED_MODEL_MAGIC, (uint32_t)BakedModelCodec::VERSION, BYTE_ORDER_MARK, LAYOUT_FLAGS,
+             (uint32_t)sizeof(glm::mat4), (uint32_t)sizeof(glm::quat) };
+}
+
+namespace {
+
+class Writer {
+public:
+    const hifi::ByteArray& getData() const { return _data; }
+
+    template<class T>
+    void write(const T& value) {
+        _data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeBool(bool value) { write<uint8_t>(value ? 1 : 0); }
+
+    template<class T>
+    void writeArray(const T* values, size_t count) {
+        write<uint64_t>(count);
+        if (count > 0) {
+            _data.append(reinterpret_cast<const char*>(values), (int)(count * sizeof(T)));
+        }
+    }
+
+    // QVector and std::vector alike
+    template<class C>
+    void writeVector(const C& values) { writeArray(values.data(), (size_t)values.size()); }
+
+    void writeBytes(const hifi::ByteArray& bytes) { writeArray(bytes.constData(), (size_t)bytes.size()); }
+    void writeString(const QString& string) { writeBytes(string.toUtf8()); }
+    void writeString(const std::string& string) { writeArray(string.data(), string.size()); }
+
+    void writeExtents(const Extents& extents) {
+        write(extents.minimum);
+        write(extents.maximum);
+    }
+
+    void writeTransform(const Transform& transform) {
+        write(transform.getRotation());
+        write(transform.getScale());
+        write(transform.getTranslation());
+    }
+
+    void writeElement(const gpu::Element& element) {
+        write<uint8_t>(element.getDimension());
+        write<uint8_t>(element.getType());
+        write<uint8_t>(element.getSemantic());
+    }
+
+    void writeVariant(const QVariant& variant) {
+        hifi::ByteArray bytes;
+        QDataStream stream(&bytes, QIODevice::WriteOnly);
+        stream.setVersion(VARIANT_STREAM_VERSION);
+        stream << variant;
+        writeBytes(bytes);
+    }
+
+private:
+    hifi::ByteArray _data;
+};
+
+class Reader {
+public:
+    Reader(const char* data, size_t length) : _cursor(data), _end(data + length) { }
+
+    bool atEnd() const { return _cursor == _end; }
+
+    const char* take(size_t length) {
+        if (length > (size_t)(_end - _cursor)) {
+            throw QString("baked model payload is truncated");
+        }
+        const char* data = _cursor;
+        _cursor += length;
+        return data;
+    }
+
+    template<class T>
+    T read() {
+        T value;
+        memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template<class T>
+    void read(T& value) { memcpy(&value, take(sizeof(T)), sizeof(T)); }
+
+    bool readBool() { return read<uint8_t>() != 0; }
+
+    // a count that can't possibly fit in what's left of the payload is rejected before anything is allocated for it
+    size_t readCount(size_t elementSize) {
+        uint64_t count = read<uint64_t>();
+        if (count > (uint64_t)(_end - _cursor) / elementSize) {
+            throw QString("baked model payload is truncated");
+        }
+        return (size_t)count;
+    }
+
+    // QVector and std::vector alike
+    template<class C>
+    void readVector(C& values) {
+        using T = typename C::value_type;
+        size_t count = readCount(sizeof(T));
+        values.resize(static_cast<decltype(values.size())>(count));
+        if (count > 0) {
+            memcpy(values.data(), take(count * sizeof(T)), count * sizeof(T));
+        }
+    }
+
+    hifi::ByteArray readBytes() {
+        size_t length = readCount(1);
+        return hifi::ByteArray(take(length), (int)length);
+    }
+
+    QString readString() { return QString::fromUtf8(readBytes()); }
+
+    std::string readStdString() {
+        size_t length = readCount(1);
+        return std::string(take(length), length);
+    }
+
+    Extents readExtents() {
+        Extents extents;
+        read(extents.minimum);
+        read(extents.maximum);
+        return extents;
+    }
+
+    Transform readTransform() {
+        auto rotation = read<glm::quat>();
+        auto scale = read<glm::vec3>();
+        auto translation = read<glm::vec3>();
+        return Transform(rotation, scale, translation);
+    }
+
+    gpu::Element readElement() {
+        auto dimension = read<uint8_t>();
+        auto type = read<uint8_t>();
+        auto semantic = read<uint8_t>();
+        if (dimension >= gpu::NUM_DIMENSIONS || type >= gpu::NUM_TYPES || semantic >= gpu::NUM_SEMANTICS) {
+            throw QString("invalid gpu element in baked model payload");
+        }
+        return gpu::Element((gpu::Dimension)dimension, (gpu::Type)type, (gpu::Semantic)semantic);
+    }
+
+    QVariant readVariant() {
+        hifi::ByteArray bytes = readBytes();
+        QDataStream stream(bytes);
+        stream.setVersion(VARIANT_STREAM_VERSION);
+        QVariant variant;
+        stream >> variant;
+        if (stream.status() != QDataStream::Ok) {
+            throw QString("invalid variant in baked model payload");
+        }
+        return variant;
+    }
+
+private:
+    const char* _cursor;
+    const char* _end;
+};
+
+}
+
+//
+// graphics
+//
+
+static void writeGraphicsMaterial(Writer& out, const graphics::MaterialPointer& material) {
+    out.writeBool((bool)material);
+    if (!material) {
+        return;
+    }
+    out.write<uint64_t>(material->getKey()._flags.to_ullong());
+    out.writeString(material->getName());
+    out.writeString(material->getModel());
+    out.write(material->getEmissive(false));
+    out.write(material->getAlbedo(false));
+    out.write(material->getOpacity());
+    out.write(material->getRoughness());
+    out.write(material->getMetallic());
+    out.write(material->getScattering());
+    out.write(material->getOpacityCutoff());
+}
+
+// The serializers only ever set these properties, so replaying them through the setters restores the material.  The
+// key doubles as a check: anything else would show up as a flag the setters didn't reproduce.
+static graphics::MaterialPointer readGraphicsMaterial(Reader& in) {
+    if (!in.readBool()) {
+        return nullptr;
+    }
+    graphics::MaterialKey key((graphics::MaterialKey::Flags(in.read<uint64_t>())));
+    auto material = std::make_shared<graphics::Material>();
+    material->setName(in.readStdString());
+    material->setModel(in.readStdString());
+    material->setEmissive(in.read<glm::vec3>(), false);
+    auto albedo = in.read<glm::vec3>();
+    if (key.isAlbedo()) {
+        material->setAlbedo(albedo, false);
+    }
+    material->setOpacity(in.read<float>());
+    material->setRoughness(in.read<float>());
+    material->setMetallic(in.read<float>());
+    material->setScattering(in.read<float>());
+    material->setOpacityCutoff(in.read<float>());
+    material->setUnlit(key.isUnlit());
+    material->setOpacityMapMode(key.getOpacityMapMode());
+    if (material->getKey()._flags != key._flags) {
+        throw QString("material in baked model payload can't be restored");
+    }
+    return material;
+}
+
+static int32_t findBuffer(std::vector<gpu::BufferPointer>& buffers, const gpu::BufferPointer& buffer) {
+    if (!buffer) {
+        return -1;
+    }
+    auto it = std::find(buffers.begin(), buffers.end(), buffer);
+    if (it == buffers.end()) {
+        buffers.push_back(buffer);
+        return (int32_t)buffers.size() - 1;
+    }
+    return (int32_t)(it - buffers.begin());
+}
+
+static void writeBufferView(Writer& out, const gpu::BufferView& view, int32_t buffer) {
+    out.write(buffer);
+    out.write<uint64_t>(view._offset);
+    out.write<uint64_t>(view._size);
+    out.write<uint16_t>(view._stride);
+    out.writeElement(view._element);
+}
+
+static const gpu::BufferPointer& getBuffer(const std::vector<gpu::BufferPointer>& buffers, int32_t buffer) {
+    if (buffer < 0 || buffer >= (int32_t)buffers.size()) {
+        throw QString("invalid buffer in baked model payload");
+    }
+    return buffers[buffer];
+}
+
+static gpu::BufferView readBufferView(Reader& in, const std::vector<gpu::BufferPointer>& buffers) {
+    auto buffer = in.read<int32_t>();
+    auto offset = in.read<uint64_t>();
+    auto size = in.read<uint64_t>();
+    auto stride = in.read<uint16_t>();
+    auto element = in.readElement();
+    if (buffer < 0) {
+        return gpu::BufferView();
+    }
+    const auto& bufferPointer = getBuffer(buffers, buffer);
+    if (stride == 0 || offset > bufferPointer->getSize() || size > bufferPointer->getSize() - offset) {
+        throw QString("invalid buffer view in baked model payload");
+    }
+    return gpu::BufferView(bufferPointer, offset, size, stride, element);
+}
+
+// Meshes are stored as BuildGraphicsMeshTask makes them: a vertex format and stream, an index buffer and a part buffer.
+static void writeGraphicsMesh(Writer& out, const graphics::MeshPointer& mesh) {
+    out.writeBool((bool)mesh);
+    if (!mesh) {
+        return;
+    }
+    out.writeString(mesh->modelName);
+    out.writeString(mesh->displayName);
+
+    // the channels and views usually share buffers, each is stored once
+    std::vector<gpu::BufferPointer> buffers;
+    const auto& stream = mesh->getVertexStream();
+    std::vector<int32_t> channelBuffers;
+    for (const auto& buffer : stream.getBuffers()) {
+        channelBuffers.push_back(findBuffer(buffers, buffer));
+    }
+    int32_t indexBuffer = findBuffer(buffers, mesh->getIndexBuffer()._buffer);
+    int32_t partBuffer = findBuffer(buffers, mesh->getPartBuffer()._buffer);
+
+    out.write<uint32_t>((uint32_t)buffers.size());
+    for (const auto& buffer : buffers) {
+        out.writeArray(buffer->getData(), buffer->getSize());
+    }
+
+    const auto& format = mesh->getVertexFormat();
+    out.write<uint32_t>(format ? (uint32_t)format->getAttributes().size() : 0);
+    if (format) {
+        for (const auto& attribute : format->getAttributes()) {
+            out.write<uint8_t>(attribute.second._slot);
+            out.write<uint8_t>(attribute.second._channel);
+            out.writeElement(attribute.second._element);
+            out.write<uint64_t>(attribute.second._offset);
+            out.write<uint32_t>(attribute.second._frequency);
+        }
+    }
+    out.write<uint32_t>((uint32_t)channelBuffers.size());
+    for (size_t i = 0; i < channelBuffers.size(); i++) {
+        out.write(channelBuffers[i]);
+        out.write<uint64_t>(stream.getOffsets()[i]);
+        out.write<uint64_t>(stream.getStrides()[i]);
+    }
+
+    writeBufferView(out, mesh->getIndexBuffer(), indexBuffer);
+    writeBufferView(out, mesh->getPartBuffer(), partBuffer);
+}
+
+static graphics::MeshPointer readGraphicsMesh(Reader& in) {
+    if (!in.readBool()) {
+        return nullptr;
+    }
+    auto mesh = std::make_shared<graphics::Mesh>();
+    mesh->modelName = in.readStdString();
+    mesh->displayName = in.readStdString();
+
+    std::vector<gpu::BufferPointer> buffers(in.read<uint32_t>());
+    for (auto& buffer : buffers) {
+        size_t size = in.readCount(1);
+        buffer = std::make_shared<gpu::Buffer>(size, reinterpret_cast<const gpu::Byte*>(in.take(size)));
+    }
+
+    auto vertexFormat = std::make_shared<gpu::Stream::Format>();
+    uint32_t numAttributes = in.read<uint32_t>();
+    for (uint32_t i = 0; i < numAttributes; i++) {
+        auto slot = in.read<uint8_t>();
+        auto channel = in.read<uint8_t>();
+        auto element = in.readElement();
+        auto offset = in.read<uint64_t>();
+        auto frequency = in.read<uint32_t>();
+        vertexFormat->setAttribute(slot, channel, element, offset, (gpu::Stream::Frequency)frequency);
+    }
+    auto vertexStream = std::make_shared<gpu::BufferStream>();
+    uint32_t numChannels = in.read<uint32_t>();
+    for (uint32_t i = 0; i < numChannels; i++) {
+        const auto& buffer = getBuffer(buffers, in.read<int32_t>());
+        auto offset = in.read<uint64_t>();
+        auto stride = in.read<uint64_t>();
+        vertexStream->addBuffer(buffer, offset, stride);
+    }
+    if (numAttributes > 0) {
+        if (!vertexFormat->hasAttribute(gpu::Stream::POSITION) ||
+            vertexFormat->getAttribute(gpu::Stream::POSITION)._channel >= numChannels) {
+            throw QString("invalid vertex format in baked model payload");
+        }
+        mesh->setVertexFormatAndStream(vertexFormat, vertexStream);
+    }
+
+    auto indexBuffer = readBufferView(in, buffers);
+    if (indexBuffer._buffer) {
+        mesh->setIndexBuffer(indexBuffer);
+    }
+    auto partBuffer = readBufferView(in, buffers);
+    if (partBuffer._buffer) {
+        mesh->setPartBuffer(partBuffer);
+    }
+    return mesh;
+}
+
+//
+// hfm
+//
+
+static void writeTexture(Writer& out, const hfm::Texture& texture) {
+    out.writeString(texture.id);
+    out.writeString(texture.name);
+    out.writeBytes(texture.filename);
+    out.writeBytes(texture.content);
+    out.write<uint8_t>((uint8_t)texture.sourceChannel);
+    out.writeTransform(texture.transform);
+    out.write<int32_t>(texture.maxNumPixels);
+    out.write<int32_t>(texture.texcoordSet);
+    out.writeString(texture.texcoordSetName);
+    out.writeBool(texture.isBumpmap);
+}
+
+static void readTexture(Reader& in, hfm::Texture& texture) {
+    texture.id = in.readString();
+    texture.name = in.readString();
+    texture.filename = in.readBytes();
+    texture.content = in.readBytes();
+    texture.sourceChannel = (image::ColorChannel)in.read<uint8_t>();
+    texture.transform = in.readTransform();
+    texture.maxNumPixels = in.read<int32_t>();
+    texture.texcoordSet = in.read<int32_t>();
+    texture.texcoordSetName = in.readString();
+    texture.isBumpmap = in.readBool();
+}
+
+#define FOR_EACH_MATERIAL_TEXTURE(APPLY) \
+    APPLY(normalTexture) APPLY(albedoTexture) APPLY(opacityTexture) APPLY(glossTexture) APPLY(roughnessTexture) \
+    APPLY(specularTexture) APPLY(metallicTexture) APPLY(emissiveTexture) APPLY(occlusionTexture) \
+    APPLY(scatteringTexture) APPLY(lightmapTexture)
+
+#define FOR_EACH_MATERIAL_FLAG(APPLY) \
+    APPLY(isPBSMaterial) APPLY(useNormalMap) APPLY(useAlbedoMap) APPLY(useOpacityMap) APPLY(useRoughnessMap) \
+    APPLY(useSpecularMap) APPLY(useMetallicMap) APPLY(useEmissiveMap) APPLY(useOcclusionMap)
+
+static void writeMaterial(Writer& out, const hfm::Material& material) {
+    out.write(material.diffuseColor);
+    out.write(material.diffuseFactor);
+    out.write(material.specularColor);
+    out.write(material.specularFactor);
+    out.write(material.emissiveColor);
+    out.write(material.emissiveFactor);
+    out.write(material.shininess);
+    out.write(material.opacity);
+    out.write(material.metallic);
+    out.write(material.roughness);
+    out.write(material.emissiveIntensity);
+    out.write(material.ambientFactor);
+    out.write(material.bumpMultiplier);
+    out.writeString(material.materialID);
+    out.writeString(material.name);
+    out.writeString(material.shadingModel);
+    writeGraphicsMaterial(out, material._material);
+#define WRITE_TEXTURE(TEXTURE) writeTexture(out, material.TEXTURE);
+    FOR_EACH_MATERIAL_TEXTURE(WRITE_TEXTURE)
+#undef WRITE_TEXTURE
+    out.write(material.lightmapParams);
+#define WRITE_FLAG(FLAG) out.writeBool(material.FLAG);
+    FOR_EACH_MATERIAL_FLAG(WRITE_FLAG)
+#undef WRITE_FLAG
+}
+
+static void readMaterial(Reader& in, hfm::Material& material) {
+    in.read(material.diffuseColor);
+    in.read(material.diffuseFactor);
+    in.read(material.specularColor);
+    in.read(material.specularFactor);
+    in.read(material.emissiveColor);
+    in.read(material.emissiveFactor);
+    in.read(material.shininess);
+    in.read(material.opacity);
+    in.read(material.metallic);
+    in.read(material.roughness);
+    in.read(material.emissiveIntensity);
+    in.read(material.ambientFactor);
+    in.read(material.bumpMultiplier);
+    material.materialID = in.readString();
+    material.name = in.readString();
+    material.shadingModel = in.readString();
+    material._material = readGraphicsMaterial(in);
+#define READ_TEXTURE(TEXTURE) readTexture(in, material.TEXTURE);
+    FOR_EACH_MATERIAL_TEXTURE(READ_TEXTURE)
+#undef READ_TEXTURE
+    in.read(material.lightmapParams);
+#define READ_FLAG(FLAG) material.FLAG = in.readBool();
+    FOR_EACH_MATERIAL_FLAG(READ_FLAG)
+#undef READ_FLAG
+}
+
+static void writeMesh(Writer& out, const hfm::Mesh& mesh) {
+    out.write<uint64_t>(mesh.parts.size());
+    for (const auto& part : mesh.parts) {
+        out.writeVector(part.quadIndices);
+        out.writeVector(part.quadTrianglesIndices);
+        out.writeVector(part.triangleIndices);
+    }
+    out.writeVector(mesh.vertices);
+    out.writeVector(mesh.normals);
+    out.writeVector(mesh.tangents);
+    out.writeVector(mesh.colors);
+    out.writeVector(mesh.texCoords);
+    out.writeVector(mesh.texCoords1);
+    out.writeExtents(mesh.meshExtents);
+    out.write(mesh.modelTransform);
+    out.writeVector(mesh.clusterIndices);
+    out.writeVector(mesh.clusterWeights);
+    out.write(mesh.clusterWeightsPerVertex);
+
+    out.write<uint64_t>(mesh.blendshapes.size());
+    for (const auto& blendshape : mesh.blendshapes) {
+        out.writeVector(blendshape.indices);
+        out.writeVector(blendshape.vertices);
+        out.writeVector(blendshape.normals);
+        out.writeVector(blendshape.tangents);
+    }
+
+    out.writeVector(mesh.triangleListMesh.vertices);
+    out.writeVector(mesh.triangleListMesh.indices);
+    out.writeVector(mesh.triangleListMesh.parts);
+    out.write<uint64_t>(mesh.triangleListMesh.partExtents.size());
+    for (const auto& extents : mesh.triangleListMesh.partExtents) {
+        out.writeExtents(extents);
+    }
+
+    out.writeVector(mesh.originalIndices);
+    out.write<uint32_t>(mesh.meshIndex);
+    writeGraphicsMesh(out, mesh._mesh);
+    out.writeBool(mesh.wasCompressed);
+}
+
+static void readMesh(Reader& in, hfm::Mesh& mesh) {
+    mesh.parts.resize(in.readCount(1));
+    for (auto& part : mesh.parts) {
+        in.readVector(part.quadIndices);
+        in.readVector(part.quadTrianglesIndices);
+        in.readVector(part.triangleIndices);
+    }
+    in.readVector(mesh.vertices);
+    in.readVector(mesh.normals);
+    in.readVector(mesh.tangents);
+    in.readVector(mesh.colors);
+    in.readVector(mesh.texCoords);
+    in.readVector(mesh.texCoords1);
+    mesh.meshExtents = in.readExtents();
+    in.read(mesh.modelTransform);
+    in.readVector(mesh.clusterIndices);
+    in.readVector(mesh.clusterWeights);
+    in.read(mesh.clusterWeightsPerVertex);
+
+    mesh.blendshapes.resize((int)in.readCount(1));
+    for (auto& blendshape : mesh.blendshapes) {
+        in.readVector(blendshape.indices);
+        in.readVector(blendshape.vertices);
+        in.readVector(blendshape.normals);
+        in.readVector(blendshape.tangents);
+    }
+
+    in.readVector(mesh.triangleListMesh.vertices);
+    in.readVector(mesh.triangleListMesh.indices);
+    in.readVector(mesh.triangleListMesh.parts);
+    mesh.triangleListMesh.partExtents.resize(in.readCount(sizeof(Extents)));
+    for (auto& extents : mesh.triangleListMesh.partExtents) {
+        extents = in.readExtents();
+    }
+
+    in.readVector(mesh.originalIndices);
+    mesh.meshIndex = in.read<uint32_t>();
+    mesh._mesh = readGraphicsMesh(in);
+    mesh.wasCompressed = in.readBool();
+}
+
+static void writeJoint(Writer& out, const hfm::Joint& joint) {
+    out.write(joint.shapeInfo.avgPoint);
+    out.writeVector(joint.shapeInfo.dots);
+    out.writeVector(joint.shapeInfo.points);
+    out.writeVector(joint.shapeInfo.debugLines);
+    out.write<int32_t>(joint.parentIndex);
+    out.write(joint.distanceToParent);
+    out.write(joint.translation);
+    out.write(joint.preTransform);
+    out.write(joint.preRotation);
+    out.write(joint.rotation);
+    out.write(joint.postRotation);
+    out.write(joint.postTransform);
+    out.write(joint.transform);
+    out.write(joint.rotationMin);
+    out.write(joint.rotationMax);
+    out.write(joint.inverseDefaultRotation);
+    out.write(joint.inverseBindRotation);
+    out.write(joint.bindTransform);
+    out.writeString(joint.name);
+    out.writeBool(joint.isSkeletonJoint);
+    out.writeBool(joint.bindTransformFoundInCluster);
+    out.write(joint.geometricOffset);
+    out.write(joint.localTransform);
+    out.write(joint.globalTransform);
+}
+
+static void readJoint(Reader& in, hfm::Joint& joint) {
+    in.read(joint.shapeInfo.avgPoint);
+    in.readVector(joint.shapeInfo.dots);
+    in.readVector(joint.shapeInfo.points);
+    in.readVector(joint.shapeInfo.debugLines);
+    joint.parentIndex = in.read<int32_t>();
+    in.read(joint.distanceToParent);
+    in.read(joint.translation);
+    in.read(joint.preTransform);
+    in.read(joint.preRotation);
+    in.read(joint.rotation);
+    in.read(joint.postRotation);
+    in.read(joint.postTransform);
+    in.read(joint.transform);
+    in.read(joint.rotationMin);
+    in.read(joint.rotationMax);
+    in.read(joint.inverseDefaultRotation);
+    in.read(joint.inverseBindRotation);
+    in.read(joint.bindTransform);
+    joint.name = in.readString();
+    joint.isSkeletonJoint = in.readBool();
+    joint.bindTransformFoundInCluster = in.readBool();
+    in.read(joint.geometricOffset);
+    in.read(joint.localTransform);
+    in.read(joint.globalTransform);
+}
+
+static void writeShape(Writer& out, const hfm::Shape& shape) {
+    out.write(shape.mesh);
+    out.write(shape.meshPart);
+    out.write(shape.material);
+    out.write(shape.joint);
+    out.writeExtents(shape.transformedExtents);
+    out.write(shape.skinDeformer);
+}
+
+static void readShape(Reader& in, hfm::Shape& shape) {
+    in.read(shape.mesh);
+    in.read(shape.meshPart);
+    in.read(shape.material);
+    in.read(shape.joint);
+    shape.transformedExtents = in.readExtents();
+    in.read(shape.skinDeformer);
+}
+
+hifi::ByteArray BakedModelCodec::encode(const hfm::Model& hfmModel) {
+    Writer out;
+    out.write(makeHeader());
+
+    out.writeString(hfmModel.originalURL);
+    out.writeString(hfmModel.author);
+    out.writeString(hfmModel.applicationName);
+
+    out.write<uint64_t>(hfmModel.shapes.size());
+    for (const auto& shape : hfmModel.shapes) {
+        writeShape(out, shape);
+    }
+    out.write<uint64_t>(hfmModel.meshes.size());
+    for (const auto& mesh : hfmModel.meshes) {
+        writeMesh(out, mesh);
+    }
+    out.write<uint64_t>(hfmModel.materials.size());
+    for (const auto& material : hfmModel.materials) {
+        writeMaterial(out, material);
+    }
+    out.write<uint64_t>(hfmModel.skinDeformers.size());
+    for (const auto& skinDeformer : hfmModel.skinDeformers) {
+        out.write<uint64_t>(skinDeformer.clusters.size());
+        for (const auto& cluster : skinDeformer.clusters) {
+            out.write(cluster.jointIndex);
+            out.write(cluster.inverseBindMatrix);
+            out.writeTransform(cluster.inverseBindTransform);
+        }
+    }
+    out.write<uint64_t>(hfmModel.joints.size());
+    for (const auto& joint : hfmModel.joints) {
+        writeJoint(out, joint);
+    }
+
+    // hashes are written in key order, so that the same model always encodes the same way
+    auto jointNames = hfmModel.jointIndices.keys();
+    std::sort(jointNames.begin(), jointNames.end());
+    out.write<uint64_t>(jointNames.size());
+    for (const auto& name : jointNames) {
+        out.writeString(name);
+        out.write<int32_t>(hfmModel.jointIndices.value(name));
+    }
+    out.writeBool(hfmModel.hasSkeletonJoints);
+    out.write<uint64_t>(hfmModel.scripts.size());
+    for (const auto& script : hfmModel.scripts) {
+        out.writeString(script);
+    }
+
+    out.write(hfmModel.offset);
+    out.write(hfmModel.neckPivot);
+    out.writeExtents(hfmModel.bindExtents);
+    out.writeExtents(hfmModel.meshExtents);
+
+    out.write<uint64_t>(hfmModel.animationFrames.size());
+    for (const auto& frame : hfmModel.animationFrames) {
+        out.writeVector(frame.rotations);
+        out.writeVector(frame.translations);
+    }
+
+    auto meshIndices = hfmModel.meshIndicesToModelNames.keys();
+    std::sort(meshIndices.begin(), meshIndices.end());
+    out.write<uint64_t>(meshIndices.size());
+    for (int meshIndex : meshIndices) {
+        out.write<int32_t>(meshIndex);
+        out.writeString(hfmModel.meshIndicesToModelNames.value(meshIndex));
+    }
+
+    out.write<uint64_t>(hfmModel.blendshapeChannelNames.size());
+    for (const auto& name : hfmModel.blendshapeChannelNames) {
+        out.writeString(name);
+    }
+
+    out.write<uint64_t>(hfmModel.jointRotationOffsets.size());
+    for (auto it = hfmModel.jointRotationOffsets.cbegin(); it != hfmModel.jointRotationOffsets.cend(); ++it) {
+        out.write<int32_t>(it.key());
+        out.write(it.value());
+    }
+
+    out.write<uint64_t>(hfmModel.shapeVertices.size());
+    for (const auto& vertices : hfmModel.shapeVertices) {
+        out.writeVector(vertices);
+    }
+
+    out.writeVariant(hfmModel.flowData._physicsConfig);
+    out.writeVariant(hfmModel.flowData._collisionsConfig);
+
+    return out.getData();
+}
+
+hfm::Model::Pointer BakedModelCodec::decode(const char* data, size_t length) {
+    auto hfmModel = std::make_shared<hfm::Model>();
+    try {
+        Reader in(data, length);
+
+        BakedModelHeader expectedHeader = makeHeader();
+        BakedModelHeader header = in.read<BakedModelHeader>();
+        if (memcmp(&header, &expectedHeader, sizeof(BakedModelHeader)) != 0) {
+            throw QString("baked model payload was written by an incompatible build");
+        }
+
+        hfmModel->originalURL = in.readString();
+        hfmModel->author = in.readString();
+        hfmModel->applicationName = in.readString();
+
+        hfmModel->shapes.resize(in.readCount(1));
+        for (auto& shape : hfmModel->shapes) {
+            readShape(in, shape);
+        }
+        hfmModel->meshes.resize(in.readCount(1));
+        for (auto& mesh : hfmModel->meshes) {
+            readMesh(in, mesh);
+        }
+        hfmModel->materials.resize(in.readCount(1));
+        for (auto& material : hfmModel->materials) {
+            readMaterial(in, material);
+        }
+        hfmModel->skinDeformers.resize(in.readCount(1));
+        for (auto& skinDeformer : hfmModel->skinDeformers) {
+            skinDeformer.clusters.resize(in.readCount(1));
+            for (auto& cluster : skinDeformer.clusters) {
+                in.read(cluster.jointIndex);
+                in.read(cluster.inverseBindMatrix);
+                cluster.inverseBindTransform = in.readTransform();
+            }
+        }
+        hfmModel->joints.resize(in.readCount(1));
+        for (auto& joint : hfmModel->joints) {
+            readJoint(in, joint);
+        }
+
+        size_t numJointIndices = in.readCount(1);
+        for (size_t i = 0; i < numJointIndices; i++) {
+            QString name = in.readString();
+            hfmModel->jointIndices.insert(name, in.read<int32_t>());
+        }
+        hfmModel->hasSkeletonJoints = in.readBool();
+        hfmModel->scripts.resize((int)in.readCount(1));
+        for (auto& script : hfmModel->scripts) {
+            script = in.readString();
+        }
+
+        in.read(hfmModel->offset);
+        in.read(hfmModel->neckPivot);
+        hfmModel->bindExtents = in.readExtents();
+        hfmModel->meshExtents = in.readExtents();
+
+        hfmModel->animationFrames.resize((int)in.readCount(1));
+        for (auto& frame : hfmModel->animationFrames) {
+            in.readVector(frame.rotations);
+            in.readVector(frame.translations);
+        }
+
+        size_t numModelNames = in.readCount(1);
+        for (size_t i = 0; i < numModelNames; i++) {
+            int meshIndex = in.read<int32_t>();
+            hfmModel->meshIndicesToModelNames.insert(meshIndex, in.readString());
+        }
+
+        size_t numChannelNames = in.readCount(1);
+        for (size_t i = 0; i < numChannelNames; i++) {
+            hfmModel->blendshapeChannelNames.push_back(in.readString());
+        }
+
+        size_t numRotationOffsets = in.readCount(1);
+        for (size_t i = 0; i < numRotationOffsets; i++) {
+            int jointIndex = in.read<int32_t>();
+            hfmModel->jointRotationOffsets.insert(jointIndex, in.read<glm::quat>());
+        }
+
+        hfmModel->shapeVertices.resize(in.readCount(1));
+        for (auto& vertices : hfmModel->shapeVertices) {
+            in.readVector(vertices);
+        }
+
+        hfmModel->flowData._physicsConfig = in.readVariant().toMap();
+        hfmModel->flowData._collisionsConfig = in.readVariant().toMap();
+
+        if (!in.atEnd()) {
+            throw QString("baked model payload has trailing data");
+        }
+    } catch (const QString& error) {
+        qCWarning(model_baker) << "Failed to decode baked model --" << error;
+        return nullptr;
+    }
+    return hfmModel;
+}
@@ -0,0 +1,36 @@
+//
+//  BakedModelCodec.h
+//  model-baker/src/model-baker
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_baker_BakedModelCodec_h
+#define hifi_baker_BakedModelCodec_h
+
+#include <shared/HifiTypes.h>
+#include <hfm/HFM.h>
+
+namespace baker {
+    // Binary form of a model the Baker has run on, including the graphics meshes, so that it can be restored from a
+    // local cache without running the serializer or the baker again.
+    //
+    // The layout is the host's own: a header guards against payloads written by another build, every container is
+    // stored as a length followed by its raw elements, and decoding copies each of them straight out of the
+    // (typically mapped) payload into its final storage.
+    class BakedModelCodec {
+    public:
+        // Whenever the layout changes, or hfm::Model or the baker outputs gain a field, this value must be incremented
+        static const int VERSION;
+
+        static hifi::ByteArray encode(const hfm::Model& hfmModel);
+
+        // Returns nullptr if the payload is corrupt or was written by an incompatible build
+        static hfm::Model::Pointer decode(const char* data, size_t length);
+    };
+};
+
+#endif // hifi_baker_BakedModelCodec_h
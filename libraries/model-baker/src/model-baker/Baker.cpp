@@ -63,11 +63,11 @@ namespace baker {
             indexedTrianglesMeshOut.clear();
             indexedTrianglesMeshOut.resize(meshesIn.size());
 
-            for (size_t i = 0; i < meshesIn.size(); i++) {
+            parallelFor(context, meshesIn.size(), [&](size_t i) {
                 auto& mesh = meshesIn[i];
                 const auto verticesStd = mesh.vertices.toStdVector();
                 indexedTrianglesMeshOut[i] = hfm::generateTriangleListMesh(verticesStd, mesh.parts);
-            }
+            });
         }
     };
 
@@ -238,7 +238,8 @@ namespace baker {
     };
 
     Baker::Baker(const hfm::Model::Pointer& hfmModel, const hifi::VariantHash& mapping, const hifi::URL& materialMappingBaseURL) :
-        _engine(std::make_shared<Engine>(BakerEngineBuilder::JobModel::create("Baker"), std::make_shared<BakeContext>())) {
+        _context(std::make_shared<BakeContext>()),
+        _engine(std::make_shared<Engine>(BakerEngineBuilder::JobModel::create("Baker"), _context)) {
         _engine->feedInput<BakerEngineBuilder::Input>(0, hfmModel);
         _engine->feedInput<BakerEngineBuilder::Input>(1, mapping);
         _engine->feedInput<BakerEngineBuilder::Input>(2, materialMappingBaseURL);
@@ -248,6 +249,10 @@ namespace baker {
         return _engine->getConfiguration();
     }
 
+    void Baker::setMaxConcurrency(int maxConcurrency) {
+        _context->maxConcurrency = maxConcurrency;
+    }
+
     void Baker::run() {
         _engine->run();
     }
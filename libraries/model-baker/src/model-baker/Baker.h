@@ -27,6 +27,9 @@ namespace baker {
 
         std::shared_ptr<TaskConfig> getConfiguration();
 
+        // See BakeContext::maxConcurrency
+        void setMaxConcurrency(int maxConcurrency);
+
         void run();
 
         // Outputs, available after run() is called
@@ -38,6 +41,7 @@ namespace baker {
         std::vector<std::vector<hifi::ByteArray>> getDracoMaterialLists() const;
 
     protected:
+        BakeContextPointer _context;
         EnginePointer _engine;
     };
 };
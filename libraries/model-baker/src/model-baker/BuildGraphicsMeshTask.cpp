@@ -391,9 +391,8 @@ void BuildGraphicsMeshTask::run(const baker::BakeContextPointer& context, const
 
     auto& graphicsMeshes = output;
 
-    int n = (int)meshes.size();
-    for (int i = 0; i < n; i++) {
-        graphicsMeshes.emplace_back();
+    graphicsMeshes.resize(meshes.size());
+    baker::parallelFor(context, meshes.size(), [&](size_t i) {
         auto& graphicsMesh = graphicsMeshes[i];
 
         uint16_t numDeformerControllers = 0;
@@ -409,9 +408,10 @@ void BuildGraphicsMeshTask::run(const baker::BakeContextPointer& context, const
         // Choose a name for the mesh
         if (graphicsMesh) {
             graphicsMesh->displayName = url.toString().toStdString() + "#/mesh/" + std::to_string(i);
-            if (meshIndicesToModelNames.find(i) != meshIndicesToModelNames.cend()) {
-                graphicsMesh->modelName = meshIndicesToModelNames[i].toStdString();
+            auto modelName = meshIndicesToModelNames.find((int)i);
+            if (modelName != meshIndicesToModelNames.cend()) {
+                graphicsMesh->modelName = modelName.value().toStdString();
             }
         }
-    }
+    });
 }
@@ -17,11 +17,10 @@ void CalculateMeshNormalsTask::run(const baker::BakeContextPointer& context, con
     const auto& meshes = input;
     auto& normalsPerMeshOut = output;
 
-    normalsPerMeshOut.reserve(meshes.size());
-    for (int i = 0; i < (int)meshes.size(); i++) {
+    normalsPerMeshOut.resize(meshes.size());
+    baker::parallelFor(context, meshes.size(), [&](size_t i) {
         const auto& mesh = meshes[i];
-        normalsPerMeshOut.emplace_back();
-        auto& normalsOut = normalsPerMeshOut[normalsPerMeshOut.size()-1];
+        auto& normalsOut = normalsPerMeshOut[i];
         // Only calculate normals if this mesh doesn't already have them
         if (!mesh.normals.empty()) {
             normalsOut = mesh.normals.toStdVector();
@@ -36,5 +35,5 @@ void CalculateMeshNormalsTask::run(const baker::BakeContextPointer& context, con
                 }
             );
         }
-    }
+    });
 }
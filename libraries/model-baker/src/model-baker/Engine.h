@@ -18,7 +18,11 @@ namespace baker {
 
     class BakeContext : public task::JobContext {
     public:
-        // No context settings yet for model prep
+        // Meshes, and the blendshapes within them, are baked independently of each other, so the heavier tasks spread
+        // them over up to this many threads (see baker::parallelFor).  Results are always gathered in mesh order, so
+        // the output doesn't depend on it.  AUTOMATIC_CONCURRENCY lets TBB decide, 1 bakes on the calling thread.
+        static const int AUTOMATIC_CONCURRENCY = 0;
+        int maxConcurrency { AUTOMATIC_CONCURRENCY };
     };
     using BakeContextPointer = std::shared_ptr<BakeContext>;
 
@@ -12,9 +12,32 @@
 #include "ModelMath.h"
 
 #include <LogHandler.h>
+#include <TBBHelpers.h>
+#include <tbb/task_arena.h>
+
 #include "ModelBakerLogging.h"
 
 namespace baker {
+    void parallelFor(const BakeContextPointer& context, size_t count, const std::function<void(size_t index)>& function) {
+        int maxConcurrency = context ? context->maxConcurrency : 1;
+        if (maxConcurrency == 1 || count < 2) {
+            for (size_t i = 0; i < count; i++) {
+                function(i);
+            }
+            return;
+        }
+
+        tbb::task_arena arena(maxConcurrency > 1 ? maxConcurrency : (int)tbb::task_arena::automatic);
+        arena.execute([&] {
+            // one index is a whole mesh or blendshape, plenty of work for a task of its own
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, count, 1), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); i++) {
+                    function(i);
+                }
+            });
+        });
+    }
+
     template<class T>
     const T& checkedAt(const QVector<T>& vector, int i) {
         if (i < 0 || i >= vector.size()) {
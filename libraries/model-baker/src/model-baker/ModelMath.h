@@ -12,8 +12,13 @@
 #include <hfm/HFM.h>
 
 #include "BakerTypes.h"
+#include "Engine.h"
 
 namespace baker {
+    // Calls function once for each index in [0, count), spread over up to context->maxConcurrency threads.
+    // Returns once every call has; calls must only write to what belongs to their own index.
+    void parallelFor(const BakeContextPointer& context, size_t count, const std::function<void(size_t index)>& function);
+
     template<typename T>
     const T& safeGet(const std::vector<T>& data, size_t i) {
         static T t;
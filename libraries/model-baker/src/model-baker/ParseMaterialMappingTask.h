@@ -26,6 +26,9 @@ public:
     using Output = MaterialMapping;
     using JobModel = baker::Job::ModelIO<ParseMaterialMappingTask, Input, Output>;
 
+    // Also used on its own when a baked model is restored without running the baker
+    static MaterialMapping parseMaterialMapping(const hifi::VariantHash& mapping, const hifi::URL& url);
+
     void run(const baker::BakeContextPointer& context, const Input& input, Output& output);
 };
 
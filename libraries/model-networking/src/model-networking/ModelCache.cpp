@@ -10,6 +10,10 @@
 //
 
 #include "ModelCache.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include <Finally.h>
 #include <FSTReader.h>
 
@@ -17,6 +21,10 @@
 #include <gpu/Stream.h>
 
 #include <QThreadPool>
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 
 #include <Gzip.h>
 
@@ -28,6 +36,8 @@
 #include <OBJSerializer.h>
 #include <GLTFSerializer.h>
 #include <model-baker/Baker.h>
+#include <model-baker/BakedModelCodec.h>
+#include <model-baker/ParseMaterialMappingTask.h>
 
 Q_LOGGING_CATEGORY(trace_resource_parse_geometry, "trace.resource.parse.geometry")
 
@@ -40,6 +50,44 @@ public:
 
 int geometryMappingPairTypeId = qRegisterMetaType<GeometryMappingPair>("GeometryMappingPair");
 
+static const QString GLB_MEDIA_TYPE = "model/gltf-binary";
+
+// Only models whose file holds all of their geometry are kept in the disk cache: the key covers the bytes of the file,
+// so it can't tell when a .bin buffer of a .gltf or the .mtl library of an .obj changes, or failed to load
+static bool isSelfContainedFormat(const QUrl& url, const QString& webMediaType) {
+    QString path = url.path().toLower();
+    if (path.endsWith(".gz")) {
+        path.chop(3);
+    }
+    return path.endsWith(".fbx") || path.endsWith(".glb") || webMediaType == GLB_MEDIA_TYPE;
+}
+
+// A .glb may still point its buffers at other files, in which case its geometry isn't all in data
+static bool hasExternalBuffers(const QByteArray& data) {
+    const int GLB_HEADER_SIZE = 12;
+    const int CHUNK_HEADER_SIZE = 8;
+    const quint32 JSON_CHUNK_TYPE = 0x4E4F534A; // "JSON"
+    if (data.size() < GLB_HEADER_SIZE + CHUNK_HEADER_SIZE || !data.startsWith("glTF")) {
+        return false;
+    }
+    quint32 chunkLength;
+    quint32 chunkType;
+    memcpy(&chunkLength, data.constData() + GLB_HEADER_SIZE, sizeof(chunkLength));
+    memcpy(&chunkType, data.constData() + GLB_HEADER_SIZE + sizeof(chunkLength), sizeof(chunkType));
+    if (chunkType != JSON_CHUNK_TYPE || chunkLength > (quint32)(data.size() - GLB_HEADER_SIZE - CHUNK_HEADER_SIZE)) {
+        return true;
+    }
+
+    auto json = QJsonDocument::fromJson(data.mid(GLB_HEADER_SIZE + CHUNK_HEADER_SIZE, chunkLength)).object();
+    for (const auto& buffer : json.value("buffers").toArray()) {
+        QString uri = buffer.toObject().value("uri").toString();
+        if (!uri.isEmpty() && !uri.startsWith("data:")) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // From: https://stackoverflow.com/questions/41145012/how-to-hash-qvariant
 class QVariantHasher {
 public:
@@ -140,12 +188,12 @@ void GeometryReader::run() {
         }
 
         HFMModel::Pointer hfmModel;
+        QByteArray uncompressedData;
         QVariantHash serializerMapping = _mapping.second;
         serializerMapping["combineParts"] = _combineParts;
         serializerMapping["deduplicateIndices"] = true;
 
         if (_url.path().toLower().endsWith(".gz")) {
-            QByteArray uncompressedData;
             if (!gunzip(_data, uncompressedData)) {
                 throw QString("failed to decompress .gz model");
             }
@@ -181,6 +229,11 @@ void GeometryReader::run() {
         auto processedHFMModel = modelBaker.getHFMModel();
         auto materialMapping = modelBaker.getMaterialMapping();
 
+        if (resource->wantsDiskCachePayload() && !hasExternalBuffers(uncompressedData.isEmpty() ? _data : uncompressedData)) {
+            PROFILE_RANGE_EX(resource_parse_geometry, "BakedModelCodec::encode", 0xFF00FF00, 0, { { "url", _url.toString() } });
+            resource->writeToDiskCache(baker::BakedModelCodec::encode(*processedHFMModel));
+        }
+
         QMetaObject::invokeMethod(resource.data(), "setGeometryDefinition",
                 Q_ARG(HFMModel::Pointer, processedHFMModel), Q_ARG(MaterialMapping, materialMapping));
     } catch (const std::exception&) {
@@ -283,14 +336,97 @@ void ModelResource::downloadFinished(const QByteArray& data) {
             }
         }
     } else {
-        if (_url != _effectiveBaseURL) {
-            _url = _effectiveBaseURL;
-            _textureBaseURL = _effectiveBaseURL;
-        }
+        useEffectiveBaseURL();
         QThreadPool::globalInstance()->start(new GeometryReader(_modelLoader, _self, _effectiveBaseURL, _mappingPair, data, _combineParts, _request->getWebMediaType()));
     }
 }
 
+void ModelResource::useEffectiveBaseURL() {
+    if (_url != _effectiveBaseURL) {
+        _url = _effectiveBaseURL;
+        _textureBaseURL = _effectiveBaseURL;
+    }
+}
+
+int ModelResource::getDiskCacheVersion() const {
+    // .fst files only hold a mapping, and the model it points to is cached on its own
+    if (!isSelfContainedFormat(_effectiveBaseURL, _request ? _request->getWebMediaType() : QString())) {
+        return 0;
+    }
+    return baker::BakedModelCodec::VERSION;
+}
+
+// Hashes are written in key order, with every value of repeated keys, so that equal mappings always hash the same
+static void writeCanonicalVariant(QDataStream& stream, const QVariant& variant) {
+    switch (variant.type()) {
+        case QVariant::Hash: {
+            auto hash = variant.toHash();
+            auto keys = hash.uniqueKeys();
+            std::sort(keys.begin(), keys.end());
+            stream << (quint32)QVariant::Hash << (quint32)keys.size();
+            for (const auto& key : keys) {
+                auto values = hash.values(key);
+                stream << key << (quint32)values.size();
+                for (const auto& value : values) {
+                    writeCanonicalVariant(stream, value);
+                }
+            }
+            break;
+        }
+        case QVariant::Map: {
+            auto map = variant.toMap();
+            auto keys = map.uniqueKeys();
+            stream << (quint32)QVariant::Map << (quint32)keys.size();
+            for (const auto& key : keys) {
+                auto values = map.values(key);
+                stream << key << (quint32)values.size();
+                for (const auto& value : values) {
+                    writeCanonicalVariant(stream, value);
+                }
+            }
+            break;
+        }
+        case QVariant::List: {
+            auto list = variant.toList();
+            stream << (quint32)QVariant::List << (quint32)list.size();
+            for (const auto& value : list) {
+                writeCanonicalVariant(stream, value);
+            }
+            break;
+        }
+        default:
+            stream << variant;
+            break;
+    }
+}
+
+QByteArray ModelResource::getDiskCacheContext() const {
+    // everything GeometryReader hands the serializer and the baker besides the data
+    QByteArray context;
+    QDataStream stream(&context, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << _effectiveBaseURL << _combineParts << _mappingPair.first;
+    stream << (_request ? _request->getWebMediaType() : QString());
+    writeCanonicalVariant(stream, _mappingPair.second);
+    return context;
+}
+
+bool ModelResource::loadFromDiskCache(const char* data, size_t length) {
+    PROFILE_RANGE_EX(resource_parse_geometry, "ModelResource::loadFromDiskCache", 0xFF00FF00, 0, { { "url", _url.toString() } });
+
+    auto hfmModel = baker::BakedModelCodec::decode(data, length);
+    if (!hfmModel) {
+        return false;
+    }
+
+    // the material mapping holds network resources, so it is derived again rather than stored
+    auto materialMapping = ParseMaterialMappingTask::parseMaterialMapping(_mappingPair.second, _mappingPair.first);
+
+    useEffectiveBaseURL();
+    setGeometryDefinition(hfmModel, materialMapping);
+    return true;
+}
+
 void ModelResource::onGeometryMappingLoaded(bool success) {
     if (success && _modelResource) {
         _hfmModel = _modelResource->_hfmModel;
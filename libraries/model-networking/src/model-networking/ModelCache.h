@@ -87,11 +87,17 @@ public:
     virtual void downloadFinished(const QByteArray& data) override;
     void setExtra(void* extra) override;
 
+    int getDiskCacheVersion() const override;
+    QByteArray getDiskCacheContext() const override;
+
     virtual bool areTexturesLoaded() const override { return isLoaded() && NetworkModel::areTexturesLoaded(); }
 
 private slots:
     void onGeometryMappingLoaded(bool success);
 
+private:
+    void useEffectiveBaseURL();
+
 protected:
     friend class ModelCache;
 
@@ -105,6 +111,8 @@ protected:
 
     virtual bool isCacheable() const override { return _loaded && _isCacheable; }
 
+    virtual bool loadFromDiskCache(const char* data, size_t length) override;
+
 private:
     ModelLoader _modelLoader;
     GeometryMappingPair _mappingPair;
@@ -0,0 +1,47 @@
+//
+//  NodeDirectory.cpp
+//  libraries/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeDirectory.h"
+
+void NodeDirectory::nodeChanged(const QUuid& nodeUUID) {
+    auto it = _nodeVersions.find(nodeUUID);
+    if (it != _nodeVersions.end()) {
+        _changes.erase(it.value());
+        it.value() = ++_version;
+    } else {
+        _nodeVersions.insert(nodeUUID, ++_version);
+    }
+    _changes.emplace(_version, nodeUUID);
+}
+
+void NodeDirectory::nodeRemoved(const QUuid& nodeUUID, LocalID localID) {
+    auto it = _nodeVersions.find(nodeUUID);
+    if (it != _nodeVersions.end()) {
+        _changes.erase(it.value());
+        _nodeVersions.erase(it);
+    }
+
+    // local IDs outlive their nodes, a node coming back gets new secrets
+    for (auto secretIt = _connectionSecrets.begin(); secretIt != _connectionSecrets.end();) {
+        if ((secretIt.key() >> 16) == localID || (secretIt.key() & 0xFFFF) == localID) {
+            secretIt = _connectionSecrets.erase(secretIt);
+        } else {
+            ++secretIt;
+        }
+    }
+}
+
+QUuid NodeDirectory::getConnectionSecret(LocalID nodeA, LocalID nodeB) {
+    QUuid& secret = _connectionSecrets[pairKey(nodeA, nodeB)];
+    if (secret.isNull()) {
+        secret = QUuid::createUuid();
+    }
+    return secret;
+}
@@ -0,0 +1,84 @@
+//
+//  NodeDirectory.h
+//  libraries/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeDirectory_h
+#define hifi_NodeDirectory_h
+
+#include <map>
+
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+
+#include <UUID.h>
+
+// Versioned directory of the nodes of a domain, kept by the domain-server.
+//
+// Every change to what a DomainList says of a node (the node being added, its sockets, permissions or replication
+// changing) gets the next version of the directory, and only the last change of each node is remembered.  A node that
+// acknowledged the list of some version is then answered with the nodes changed since, rather than with every other node.
+// Removed nodes are forgotten: the nodes are told of removals as they happen, with a DomainServerRemovedNode.
+//
+// The directory also holds the connection secrets of the pairs of nodes, by the pair of their local IDs.
+class NodeDirectory {
+public:
+    using Version = quint64;
+    using LocalID = NetworkLocalID;
+
+    static const Version NO_VERSION = 0;
+
+    Version getVersion() const { return _version; }
+
+    // records that the node was added, or that what the DomainList says of it changed
+    void nodeChanged(const QUuid& nodeUUID);
+
+    // forgets the node and the connection secrets it had with other nodes
+    void nodeRemoved(const QUuid& nodeUUID, LocalID localID);
+
+    // records that every node changed, so that every node gets the full list on its next check in
+    void invalidate() { _invalidatedVersion = ++_version; }
+
+    // a version no change is recorded at, for a node to discard what it acknowledged before
+    Version newVersion() { return ++_version; }
+
+    // whether what changed since version is known, so that it can be sent in place of the full list
+    bool hasChangesSince(Version version) const {
+        return version != NO_VERSION && version >= _invalidatedVersion && version <= _version;
+    }
+
+    // calls visit(nodeUUID) for each node changed since version, in the order of their last change
+    template <typename Visit>
+    void forEachChangeSince(Version version, Visit visit) const;
+
+    // the secret two nodes use to talk to each other, created the first time it is asked for
+    QUuid getConnectionSecret(LocalID nodeA, LocalID nodeB);
+
+    int getNumNodes() const { return _nodeVersions.size(); }
+    int getNumConnectionSecrets() const { return _connectionSecrets.size(); }
+
+private:
+    static quint32 pairKey(LocalID nodeA, LocalID nodeB) {
+        return nodeA < nodeB ? ((quint32)nodeA << 16) | nodeB : ((quint32)nodeB << 16) | nodeA;
+    }
+
+    Version _version { NO_VERSION };
+    Version _invalidatedVersion { NO_VERSION };
+    std::map<Version, QUuid> _changes; // the last change of each node
+    QHash<QUuid, Version> _nodeVersions;
+    QHash<quint32, QUuid> _connectionSecrets;
+};
+
+template <typename Visit>
+void NodeDirectory::forEachChangeSince(Version version, Visit visit) const {
+    for (auto it = _changes.upper_bound(version); it != _changes.end(); ++it) {
+        visit(it->second);
+    }
+}
+
+#endif // hifi_NodeDirectory_h
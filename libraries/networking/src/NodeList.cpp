@@ -110,6 +110,10 @@ NodeList::NodeList(char newOwnerType, int socketListenPort, int dtlsListenPort)
     // anytime we get a new node we may need to re-send our set of ignored node IDs to it
     connect(this, &LimitedNodeList::nodeActivated, this, &NodeList::maybeSendIgnoreSetToNode);
 
+    // a node we drop on our own (gone silent, or restarted) is one the domain-server still lists for us,
+    // so the next check in asks for the full list rather than for what changed since the last one
+    connect(this, &LimitedNodeList::nodeKilled, this, [this] { _domainListVersion = 0; });
+
     // setup our timer to send keepalive pings (it's started and stopped on domain connect/disconnect)
     _keepAlivePingTimer.setInterval(KEEPALIVE_PING_INTERVAL_MS); // 1s, Qt::CoarseTimer acceptable
     connect(&_keepAlivePingTimer, &QTimer::timeout, this, &NodeList::sendKeepAlivePings);
@@ -173,6 +177,19 @@ qint64 NodeList::sendStatsToDomainServer(QJsonObject statsObject) {
     return sendStats(statsObject, _domainHandler.getSockAddr());
 }
 
+void NodeList::sendMetricsToDomainServer(QByteArray metricsSnapshot) {
+    if (thread() != QThread::currentThread()) {
+        QMetaObject::invokeMethod(this, "sendMetricsToDomainServer", Qt::QueuedConnection,
+                                  Q_ARG(QByteArray, metricsSnapshot));
+        return;
+    }
+
+    auto metricsPacketList = NLPacketList::create(PacketType::NodeMetrics, QByteArray(), true, true);
+    metricsPacketList->write(metricsSnapshot);
+
+    sendPacketList(std::move(metricsPacketList), _domainHandler.getSockAddr());
+}
+
 void NodeList::timePingReply(ReceivedMessage& message, const SharedNodePointer& sendingNode) {
     PingType_t pingType;
 
@@ -284,6 +301,10 @@ void NodeList::reset(QString reason, bool skipDomainHandlerReset) {
         _domainHandler.softReset(reason);
     }
 
+    _domainListVersion = 0;
+    _pendingDomainListNumber = 0;
+    _numPendingDomainListNodes = 0;
+
     // refresh the owner UUID to the NULL UUID
     setSessionUUID(QUuid());
     setSessionLocalID(Node::NULL_LOCAL_ID);
@@ -466,7 +487,10 @@ void NodeList::sendDomainServerCheckIn() {
         packetStream << _ownerType.load() << publicSockAddr << localSockAddr << _nodeTypesOfInterest.toList();
         packetStream << DependencyManager::get<AddressManager>()->getPlaceName();
 
-        if (!domainIsConnected) {
+        if (domainIsConnected) {
+            // the version of the last complete domain list, the domain-server answers with what changed since
+            packetStream << _domainListVersion.load();
+        } else {
             DataServerAccountInfo& accountInfo = accountManager->getAccountInfo();
             packetStream << accountInfo.getUsername();
 
@@ -707,6 +731,17 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     bool newConnection;
     packetStream >> newConnection;
 
+    // the version of the domain-server's node directory the list was made at, the number of the list
+    // and how many nodes it holds, over all of its packets
+    quint64 domainListVersion;
+    packetStream >> domainListVersion;
+
+    quint32 domainListNumber;
+    packetStream >> domainListNumber;
+
+    quint32 numNodesInDomainList;
+    packetStream >> numNodesInDomainList;
+
     if (newConnection) {
         _nodeConnectTimestamp = usecTimestampNow();
         _connectReason = Connect;
@@ -787,8 +822,20 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     setAuthenticatePackets(isAuthenticated);
 
     // pull each node in the packet
+    quint32 numNodesInPacket = 0;
     while (packetStream.device()->pos() < message->getSize()) {
         parseNodeFromPacketStream(packetStream);
+        ++numNodesInPacket;
+    }
+
+    // each packet of the list arrives on its own, the list is acknowledged once all of its nodes were
+    if (domainListNumber != _pendingDomainListNumber) {
+        _pendingDomainListNumber = domainListNumber;
+        _numPendingDomainListNodes = 0;
+    }
+    _numPendingDomainListNodes += numNodesInPacket;
+    if (_numPendingDomainListNodes == numNodesInDomainList) {
+        _domainListVersion = domainListVersion;
     }
 }
 
@@ -804,7 +851,11 @@ void NodeList::processDomainServerRemovedNode(QSharedPointer<ReceivedMessage> me
     // read the UUID from the packet, remove it if it exists
     QUuid nodeUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
     qCDebug(networking) << "Received packet from domain-server to remove node with UUID" << uuidStringWithoutCurlyBraces(nodeUUID);
+
+    // the domain-server no longer lists this node, so what we acknowledged of its list still holds
+    quint64 domainListVersion = _domainListVersion;
     killNodeWithUUID(nodeUUID);
+    _domainListVersion = domainListVersion;
     removeDelayedAdd(nodeUUID);
 }
 
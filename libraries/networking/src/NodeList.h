@@ -59,6 +59,7 @@ public:
 
     Q_INVOKABLE qint64 sendStats(QJsonObject statsObject, HifiSockAddr destination);
     Q_INVOKABLE qint64 sendStatsToDomainServer(QJsonObject statsObject);
+    Q_INVOKABLE void sendMetricsToDomainServer(QByteArray metricsSnapshot);
 
     DomainHandler& getDomainHandler() { return _domainHandler; }
 
@@ -176,6 +177,10 @@ private:
 
     bool _sendDomainServerCheckInEnabled { true };
 
+    std::atomic<quint64> _domainListVersion { 0 }; // read by the check ins of assignment clients, on their own thread
+    quint32 _pendingDomainListNumber { 0 };
+    quint32 _numPendingDomainListNodes { 0 };
+
     mutable QReadWriteLock _ignoredSetLock;
     tbb::concurrent_unordered_set<QUuid, UUIDHasher> _ignoredNodeIDs;
     mutable QReadWriteLock _personalMutedSetLock;
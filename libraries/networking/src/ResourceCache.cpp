@@ -30,7 +30,7 @@
 
 bool ResourceCacheSharedItems::appendRequest(QWeakPointer<Resource> resource) {
     Lock lock(_mutex);
-    if ((uint32_t)_loadingRequests.size() < _requestLimit) {
+    if ((uint32_t)_loadingRequests.size() < _requestLimit && hasBandwidthFor(resource.lock())) {
         _loadingRequests.append(resource);
         return true;
     } else {
@@ -39,6 +39,21 @@ bool ResourceCacheSharedItems::appendRequest(QWeakPointer<Resource> resource) {
     }
 }
 
+bool ResourceCacheSharedItems::hasBandwidthFor(const QSharedPointer<Resource>& resource) const {
+    if (_maxBytesInFlight <= 0 || _loadingRequests.isEmpty() || !resource) {
+        return true;
+    }
+
+    qint64 bytesInFlight = resource->getEstimatedBytes();
+    foreach (QWeakPointer<Resource> request, _loadingRequests) {
+        auto locked = request.lock();
+        if (locked) {
+            bytesInFlight += locked->getEstimatedBytes();
+        }
+    }
+    return bytesInFlight <= _maxBytesInFlight;
+}
+
 void ResourceCacheSharedItems::setRequestLimit(uint32_t limit) {
     Lock lock(_mutex);
     _requestLimit = limit;
@@ -121,8 +136,8 @@ QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest() {
             continue;
         }
 
-        // Check load priority
-        float priority = resource->getLoadPriority();
+        // Check load priority, weighed against the expected transfer size
+        float priority = getSchedulingScore(resource);
         bool isFile = resource->getURL().scheme() == HIFI_URL_SCHEME_FILE;
         if (priority >= highestPriority && (isFile || !currentHighestIsFile)) {
             highestPriority = priority;
@@ -146,6 +161,154 @@ void ResourceCacheSharedItems::clear() {
     _loadingRequests.clear();
 }
 
+QSharedPointer<Resource> ResourceCacheSharedItems::takePreemptedRequest(QSharedPointer<Resource> newRequest) {
+    // only preempt requests that are clearly less important and haven't transferred much yet,
+    // as whatever they received so far is thrown away
+    const float PREEMPTION_MARGIN = 1.0f;
+    const float MAX_PREEMPTED_PROGRESS = 0.25f;
+    const qint64 MAX_PREEMPTED_BYTES = 256 * 1024;    // for transfers of unknown size
+
+    Lock lock(_mutex);
+    if (!_preemptionEnabled) {
+        return QSharedPointer<Resource>();
+    }
+
+    int pendingIndex = -1;
+    for (int i = 0; i < _pendingRequests.size(); i++) {
+        if (_pendingRequests.at(i).data() == newRequest.data()) {
+            pendingIndex = i;
+            break;
+        }
+    }
+    if (pendingIndex < 0) {
+        return QSharedPointer<Resource>();
+    }
+
+    const float threshold = getSchedulingScore(newRequest) - PREEMPTION_MARGIN;
+    int lowestIndex = -1;
+    float lowestScore = FLT_MAX;
+    QSharedPointer<Resource> lowestResource;
+    for (int i = 0; i < _loadingRequests.size(); i++) {
+        auto resource = _loadingRequests.at(i).lock();
+        if (!resource || !resource->isPreemptible()) {
+            continue;
+        }
+        qint64 bytesReceived = resource->getBytesReceived();
+        qint64 bytesExpected = resource->getEstimatedBytes();
+        if (bytesExpected > 0 ? bytesReceived > MAX_PREEMPTED_PROGRESS * bytesExpected : bytesReceived > MAX_PREEMPTED_BYTES) {
+            continue;
+        }
+        float score = getSchedulingScore(resource);
+        if (score < threshold && score < lowestScore) {
+            lowestScore = score;
+            lowestIndex = i;
+            lowestResource = resource;
+        }
+    }
+
+    if (lowestIndex >= 0) {
+        _loadingRequests.removeAt(lowestIndex);
+        _pendingRequests.removeAt(pendingIndex);
+        _loadingRequests.append(newRequest);
+        _numPreemptedRequests++;
+    }
+    return lowestResource;
+}
+
+bool ResourceCacheSharedItems::isRequestQueued(QWeakPointer<Resource> resource) const {
+    Lock lock(_mutex);
+    foreach (QWeakPointer<Resource> request, _loadingRequests) {
+        if (request.data() == resource.data()) {
+            return true;
+        }
+    }
+    foreach (QWeakPointer<Resource> request, _pendingRequests) {
+        if (request.data() == resource.data()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResourceCacheSharedItems::appendPendingRequest(QWeakPointer<Resource> resource) {
+    Lock lock(_mutex);
+    _pendingRequests.append(resource);
+}
+
+void ResourceCacheSharedItems::setByteCostWeight(float weight) {
+    Lock lock(_mutex);
+    _byteCostWeight = weight;
+}
+
+float ResourceCacheSharedItems::getByteCostWeight() const {
+    Lock lock(_mutex);
+    return _byteCostWeight;
+}
+
+void ResourceCacheSharedItems::setPreemptionEnabled(bool enabled) {
+    Lock lock(_mutex);
+    _preemptionEnabled = enabled;
+}
+
+bool ResourceCacheSharedItems::isPreemptionEnabled() const {
+    Lock lock(_mutex);
+    return _preemptionEnabled;
+}
+
+void ResourceCacheSharedItems::setMaxBytesInFlight(qint64 maxBytes) {
+    Lock lock(_mutex);
+    _maxBytesInFlight = maxBytes;
+}
+
+qint64 ResourceCacheSharedItems::getMaxBytesInFlight() const {
+    Lock lock(_mutex);
+    return _maxBytesInFlight;
+}
+
+float ResourceCacheSharedItems::getSchedulingScore(const QSharedPointer<Resource>& resource) const {
+    // sizes at or below this don't pay any cost
+    const float MIN_BYTE_COST = 64.0f * 1024.0f;
+
+    float score = resource->getLoadPriority();
+    qint64 bytes = resource->getEstimatedBytes();
+    Lock lock(_mutex);
+    if (bytes > 0 && _byteCostWeight > 0.0f) {
+        score -= _byteCostWeight * log2f(std::max((float)bytes, MIN_BYTE_COST) / MIN_BYTE_COST);
+    }
+    return score;
+}
+
+void ResourceCacheSharedItems::recordLoadTime(quint64 usecs) {
+    _numLoadTimes++;
+    _totalLoadTime += usecs;
+    uint64_t maxLoadTime = _maxLoadTime;
+    while (usecs > maxLoadTime && !_maxLoadTime.compare_exchange_weak(maxLoadTime, usecs)) {}
+}
+
+quint64 ResourceCacheSharedItems::getAverageLoadTime() const {
+    uint64_t count = _numLoadTimes;
+    return count > 0 ? _totalLoadTime / count : 0;
+}
+
+quint64 ResourceCacheSharedItems::getMaxLoadTime() const {
+    return _maxLoadTime;
+}
+
+void ResourceCacheSharedItems::enableDiskCache(const std::string& dirname) {
+    Lock lock(_mutex);
+    if (_diskCache) {
+        return;
+    }
+    auto diskCache = std::make_shared<ResourceDiskCache>(dirname);
+    diskCache->initialize();
+    _diskCache = diskCache;
+}
+
+ResourceDiskCachePointer ResourceCacheSharedItems::getDiskCache() const {
+    Lock lock(_mutex);
+    return _diskCache;
+}
+
 ScriptableResourceCache::ScriptableResourceCache(QSharedPointer<ResourceCache> resourceCache) {
     _resourceCache = resourceCache;
     connect(&(*_resourceCache), &ResourceCache::dirty,
@@ -537,6 +700,18 @@ bool ResourceCache::attemptRequest(QSharedPointer<Resource> resource) {
         resource->makeRequest();
         return true;
     }
+
+    // every slot is taken, see if this request deserves one more than a request that is already loading
+    auto preempted = sharedItems->takePreemptedRequest(resource);
+    if (preempted) {
+        if (QThread::currentThread() != preempted->thread()) {
+            QMetaObject::invokeMethod(preempted.data(), "handlePreemption");
+        } else {
+            preempted->handlePreemption();
+        }
+        resource->makeRequest();
+        return true;
+    }
     return false;
 }
 
@@ -545,12 +720,22 @@ void ResourceCache::requestCompleted(QWeakPointer<Resource> resource) {
 
     sharedItems->removeRequest(resource);
 
-    // Now go fill any new request spots
+    // Now go fill any new request spots, until the byte budget stops us
     while (sharedItems->getLoadingRequestsCount() < sharedItems->getRequestLimit() && sharedItems->getPendingRequestsCount() > 0) {
-        attemptHighestPriorityRequest();
+        if (!attemptHighestPriorityRequest()) {
+            break;
+        }
     }
 }
 
+uint32_t ResourceCache::getPreemptedRequestCount() {
+    return DependencyManager::get<ResourceCacheSharedItems>()->getPreemptedRequestsCount();
+}
+
+quint64 ResourceCache::getAverageLoadTime() {
+    return DependencyManager::get<ResourceCacheSharedItems>()->getAverageLoadTime();
+}
+
 bool ResourceCache::attemptHighestPriorityRequest() {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
     auto resource = sharedItems->getHighestPendingRequest();
@@ -570,8 +755,8 @@ Resource::Resource(const Resource& other) :
     _failedToLoad(other._failedToLoad),
     _loaded(other._loaded),
     _loadPriorities(other._loadPriorities),
-    _bytesReceived(other._bytesReceived),
-    _bytesTotal(other._bytesTotal),
+    _bytesReceived(other._bytesReceived.load()),
+    _bytesTotal(other._bytesTotal.load()),
     _bytes(other._bytes),
     _requestID(++requestID),
     _extraHash(other._extraHash) {
@@ -642,6 +827,15 @@ float Resource::getLoadPriority() {
     return highestPriority;
 }
 
+qint64 Resource::getEstimatedBytes() const {
+    qint64 requestedBytes = _requestedBytes;
+    if (requestedBytes > 0) {
+        return requestedBytes;
+    }
+    qint64 bytesTotal = _bytesTotal;
+    return (bytesTotal > 0) ? bytesTotal : _estimatedBytes.load();
+}
+
 void Resource::refresh() {
     if (_request && !(_loaded || _failedToLoad)) {
         return;
@@ -701,8 +895,41 @@ void Resource::init(bool resetLoaded) {
     }
 }
 
+void Resource::handlePreemption() {
+    // this may be queued, and the transfer finish or the resource be requested again before it runs
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    if (!isPreemptible() || sharedItems->isRequestQueued(_self)) {
+        return;
+    }
+    preempt();
+    sharedItems->appendPendingRequest(_self);
+}
+
+void Resource::preempt() {
+    if (!_request) {
+        return;
+    }
+
+    PROFILE_ASYNC_END(resource, "Resource:" + getType(), QString::number(_requestID), { { "preempted", true } });
+    _request->disconnect(this);
+    _request->deleteLater();
+    _request = nullptr;
+
+    // keep the size we learned about for the next time this resource is scheduled
+    qint64 bytesTotal = _bytesTotal;
+    if (bytesTotal > 0) {
+        _estimatedBytes = bytesTotal;
+    }
+    _bytesReceived = 0;
+}
+
 void Resource::attemptRequest() {
     _startedLoading = true;
+    _requestedBytes = (_requestByteRange.fromInclusive >= 0 && _requestByteRange.toExclusive > _requestByteRange.fromInclusive) ?
+        _requestByteRange.size() : 0;
+    if (_queuedTimestamp == 0) {
+        _queuedTimestamp = usecTimestampNow();
+    }
 
     if (_attempts > 0) {
         qCDebug(networking).noquote() << "Server unavailable "
@@ -719,9 +946,13 @@ void Resource::finishedLoading(bool success) {
     if (success) {
         _loadPriorities.clear();
         _loaded = true;
+        if (_queuedTimestamp != 0) {
+            DependencyManager::get<ResourceCacheSharedItems>()->recordLoadTime(usecTimestampNow() - _queuedTimestamp);
+        }
     } else {
         _failedToLoad = true;
     }
+    _queuedTimestamp = 0;
     emit finished(success);
 }
 
@@ -809,7 +1040,9 @@ void Resource::handleReplyFinished() {
 
         auto data = _request->getData();
         emit loaded(data);
-        downloadFinished(data);
+        if (!restoreFromDiskCache(data)) {
+            downloadFinished(data);
+        }
     } else {
         handleFailedRequest(result);
     }
@@ -819,6 +1052,40 @@ void Resource::handleReplyFinished() {
     _request = nullptr;
 }
 
+bool Resource::restoreFromDiskCache(const QByteArray& data) {
+    _diskCacheKey.clear();
+
+    int version = getDiskCacheVersion();
+    if (version == 0) {
+        return false;
+    }
+    auto diskCache = DependencyManager::get<ResourceCacheSharedItems>()->getDiskCache();
+    if (!diskCache) {
+        return false;
+    }
+
+    auto key = ResourceDiskCache::computeKey(getType(), version, data, getDiskCacheContext());
+    auto entry = diskCache->readPayload(key);
+    if (entry && loadFromDiskCache(entry->data(), entry->size())) {
+        PROFILE_INSTANT(resource, "Resource:" + getType() + ":diskCacheHit", "t", { { "url", _url.toString() } });
+        return true;
+    }
+
+    // remember where the processed result belongs
+    _diskCacheKey = key;
+    return false;
+}
+
+void Resource::writeToDiskCache(const QByteArray& payload) const {
+    if (_diskCacheKey.empty() || payload.isEmpty()) {
+        return;
+    }
+    auto diskCache = DependencyManager::get<ResourceCacheSharedItems>()->getDiskCache();
+    if (diskCache) {
+        diskCache->writePayload(_diskCacheKey, payload);
+    }
+}
+
 bool Resource::handleFailedRequest(ResourceRequest::Result result) {
     bool willRetry = false;
     switch (result) {
@@ -32,6 +32,7 @@
 
 #include <DependencyManager.h>
 
+#include "ResourceDiskCache.h"
 #include "ResourceManager.h"
 
 Q_DECLARE_METATYPE(size_t)
@@ -77,14 +78,58 @@ public:
     uint32_t getLoadingRequestsCount() const;
     void clear();
 
+    /// If newRequest is pending and outranks a loading request by enough of a margin, gives newRequest the loading
+    /// request's slot and returns the loading request, which the caller must preempt.  The preempted request goes
+    /// back to the pending queue once its transfer is aborted.
+    QSharedPointer<Resource> takePreemptedRequest(QSharedPointer<Resource> newRequest);
+
+    /// Checks whether the resource is loading or pending.
+    bool isRequestQueued(QWeakPointer<Resource> resource) const;
+    void appendPendingRequest(QWeakPointer<Resource> resource);
+
+    /// Ranks requests by load priority, penalized by the log of their estimated size, so that when priorities are close
+    /// small resources load ahead of large ones.  A weight of zero schedules by priority alone.
+    void setByteCostWeight(float weight);
+    float getByteCostWeight() const;
+    void setPreemptionEnabled(bool enabled);
+    bool isPreemptionEnabled() const;
+
+    /// Caps the estimated bytes of all loading requests combined, zero for no cap.
+    /// A single request is always allowed to load, however large.
+    void setMaxBytesInFlight(qint64 maxBytes);
+    qint64 getMaxBytesInFlight() const;
+    float getSchedulingScore(const QSharedPointer<Resource>& resource) const;
+
+    void recordLoadTime(quint64 usecs);
+    quint64 getAverageLoadTime() const;
+    quint64 getMaxLoadTime() const;
+    uint32_t getPreemptedRequestsCount() const { return _numPreemptedRequests; }
+
+    /// Creates and initializes the disk cache of processed payloads shared by all ResourceCaches.
+    void enableDiskCache(const std::string& dirname = ResourceDiskCache::DEFAULT_DIRNAME);
+    ResourceDiskCachePointer getDiskCache() const;
+
 private:
     ResourceCacheSharedItems() = default;
 
+    bool hasBandwidthFor(const QSharedPointer<Resource>& resource) const;
+
     mutable Mutex _mutex;
     QList<QWeakPointer<Resource>> _pendingRequests;
     QList<QWeakPointer<Resource>> _loadingRequests;
     const uint32_t DEFAULT_REQUEST_LIMIT = 10;
     uint32_t _requestLimit { DEFAULT_REQUEST_LIMIT };
+    ResourceDiskCachePointer _diskCache;
+
+    const float DEFAULT_BYTE_COST_WEIGHT = 0.05f;
+    float _byteCostWeight { DEFAULT_BYTE_COST_WEIGHT };
+    bool _preemptionEnabled { true };
+    qint64 _maxBytesInFlight { 0 };
+
+    std::atomic<uint32_t> _numPreemptedRequests { 0 };
+    std::atomic<uint64_t> _numLoadTimes { 0 };
+    std::atomic<uint64_t> _totalLoadTime { 0 };
+    std::atomic<uint64_t> _maxLoadTime { 0 };
 };
 
 /// Wrapper to expose resources to JS/QML
@@ -218,6 +263,8 @@ public:
     static QList<QSharedPointer<Resource>> getLoadingRequests();
     static uint32_t getPendingRequestCount();
     static uint32_t getLoadingRequestCount();
+    static uint32_t getPreemptedRequestCount();
+    static quint64 getAverageLoadTime();
 
     ResourceCache(QObject* parent = nullptr);
     virtual ~ResourceCache();
@@ -326,6 +373,15 @@ class ScriptableResourceCache : public QObject {
     Q_PROPERTY(size_t numGlobalQueriesPending READ getNumGlobalQueriesPending NOTIFY dirty)
     Q_PROPERTY(size_t numGlobalQueriesLoading READ getNumGlobalQueriesLoading NOTIFY dirty)
 
+    /**jsdoc
+     * @property {number} numGlobalQueriesPreempted - Total number of loading queries that were sent back to the queue to make
+     *     room for more important ones (across all resource cache managers). <em>Read-only.</em>
+     * @property {number} averageLoadTime - Average time in microseconds from a resource being requested to it being loaded
+     *     (across all resource cache managers). <em>Read-only.</em>
+     */
+    Q_PROPERTY(size_t numGlobalQueriesPreempted READ getNumGlobalQueriesPreempted NOTIFY dirty)
+    Q_PROPERTY(quint64 averageLoadTime READ getAverageLoadTime NOTIFY dirty)
+
 public:
     ScriptableResourceCache(QSharedPointer<ResourceCache> resourceCache);
 
@@ -402,6 +458,8 @@ private:
 
     size_t getNumGlobalQueriesPending() const { return ResourceCache::getPendingRequestCount(); }
     size_t getNumGlobalQueriesLoading() const { return ResourceCache::getLoadingRequestCount(); }
+    size_t getNumGlobalQueriesPreempted() const { return ResourceCache::getPreemptedRequestCount(); }
+    quint64 getAverageLoadTime() const { return ResourceCache::getAverageLoadTime(); }
 };
 
 /// Base class for resources.
@@ -434,6 +492,15 @@ public:
     /// Returns the highest load priority across all owners.
     float getLoadPriority();
 
+    /// Returns the expected size of the next transfer for this resource, or zero if it isn't known yet.
+    qint64 getEstimatedBytes() const;
+
+    /// Provides a size hint for scheduling before any bytes have been received.
+    void setEstimatedBytes(qint64 bytes) { _estimatedBytes = bytes; }
+
+    /// Checks whether the resource has a plain request in flight that can be aborted and retried later.
+    virtual bool isPreemptible() const { return _request != nullptr && !_loaded; }
+
     /// Checks whether the resource has loaded.
     virtual bool isLoaded() const { return _loaded; }
 
@@ -470,6 +537,22 @@ public:
     void setExtraHash(size_t extraHash) { _extraHash = extraHash; }
     size_t getExtraHash() const { return _extraHash; }
 
+    /// Returns the version of the processed payload format stored in the shared disk cache, or zero if this
+    /// resource type doesn't use the disk cache.  Bump it whenever the payload layout changes.
+    virtual int getDiskCacheVersion() const { return 0; }
+
+    /// Returns the settings, other than the downloaded data, that the processed payload depends on.  They become part
+    /// of the disk cache key, so that the same data processed differently is stored separately.
+    virtual QByteArray getDiskCacheContext() const { return QByteArray(); }
+
+    /// Whether a processed payload for the data last downloaded should be passed to writeToDiskCache.
+    /// Lets subclasses skip serializing a payload that would be dropped anyway.
+    bool wantsDiskCachePayload() const { return !_diskCacheKey.empty(); }
+
+    /// Stores the processed form of the data last downloaded, so it can be restored without processing in later sessions.
+    /// Safe to call from worker threads.
+    void writeToDiskCache(const QByteArray& payload) const;
+
 signals:
     /// Fired when the resource begins downloading.
     void loading();
@@ -511,6 +594,11 @@ protected:
     /// This should be overridden by subclasses that need to process the data once it is downloaded.
     virtual void downloadFinished(const QByteArray& data) { finishedLoading(true); }
 
+    /// Called instead of downloadFinished when a processed payload for the downloaded data is found in the disk cache.
+    /// Subclasses that report a disk cache version must override this and call finishedLoading on success.
+    /// \return false if the payload couldn't be restored, in which case the downloaded data is processed as usual
+    virtual bool loadFromDiskCache(const char* data, size_t length) { return false; }
+
     /// Called when the download is finished and processed, sets the number of actual bytes.
     void setSize(const qint64& bytes);
 
@@ -520,6 +608,11 @@ protected:
 
     Q_INVOKABLE void allReferencesCleared();
 
+    /// Aborts the active request so a more important resource can take its place.
+    /// The scheduler has already given its slot away, and moves it back to the pending queue afterwards.
+    /// Subclasses that override makeRequest with their own transfers must override this and isPreemptible together.
+    virtual void preempt();
+
     /// Return true if the resource will be retried
     virtual bool handleFailedRequest(ResourceRequest::Result result);
 
@@ -540,8 +633,9 @@ protected:
     QWeakPointer<Resource> _self;
     QPointer<ResourceCache> _cache;
 
-    qint64 _bytesReceived { 0 };
-    qint64 _bytesTotal { 0 };
+    // read by the scheduler from whichever thread completes a request
+    std::atomic<qint64> _bytesReceived { 0 };
+    std::atomic<qint64> _bytesTotal { 0 };
     qint64 _bytes { 0 };
 
     int _requestID;
@@ -562,6 +656,11 @@ private:
     void retry();
     void reinsert();
 
+    bool restoreFromDiskCache(const QByteArray& data);
+
+    // preempts the request scheduled for preemption, unless it finished or was requested again in the meantime
+    Q_INVOKABLE void handlePreemption();
+
     bool isInScript() const { return _isInScript; }
     void setInScript(bool isInScript) { _isInScript = isInScript; }
     
@@ -571,6 +670,10 @@ private:
     static const int MAX_ATTEMPTS = 8;
     unsigned int _attemptsRemaining { MAX_ATTEMPTS };
     bool _isInScript{ false };
+    cache::FileCache::Key _diskCacheKey;
+    std::atomic<qint64> _estimatedBytes { 0 };
+    std::atomic<qint64> _requestedBytes { 0 };    // the size of _requestByteRange, for the scheduler
+    quint64 _queuedTimestamp { 0 };
 };
 
 uint qHash(const QPointer<QObject>& value, uint seed = 0);
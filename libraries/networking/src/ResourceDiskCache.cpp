@@ -0,0 +1,217 @@
+//
+//  ResourceDiskCache.cpp
+//  libraries/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceDiskCache.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QSaveFile>
+
+#include "NetworkLogging.h"
+
+using Key = cache::FileCache::Key;
+
+// Whenever a change is made to the on-disk layout of the cache that isn't backward compatible,
+// this value should be incremented.  Entries written with another version are evicted on initialization
+const int ResourceDiskCache::CURRENT_VERSION = 0x01;
+
+const std::string ResourceDiskCache::DEFAULT_DIRNAME { "resource_cache" };
+const std::string ResourceDiskCache::DEFAULT_EXT { "hrc" };
+
+static const char* INDEX_FILENAME = "index";
+static const uint32_t ENTRY_MAGIC = 0x43524648; // "HFRC"
+
+struct EntryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t length;
+    uint64_t checksum;
+};
+
+// Keys are hex encoded SHA-256 digests
+static const int KEY_LENGTH = 64;
+
+struct IndexRecord {
+    char key[KEY_LENGTH];
+    uint64_t length;
+    uint64_t checksum;
+};
+
+// FNV-1a, cheap enough to verify every payload as it is mapped
+static uint64_t computeChecksum(const char* data, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+ResourceDiskCacheEntry::~ResourceDiskCacheEntry() {
+    if (_mapped) {
+        _qfile.unmap(_mapped);
+    }
+}
+
+ResourceDiskCache::ResourceDiskCache(const std::string& dirname, const std::string& ext) :
+    FileCache(dirname, ext) { }
+
+void ResourceDiskCache::initialize() {
+    FileCache::initialize();
+    loadIndex();
+}
+
+Key ResourceDiskCache::computeKey(const QString& type, int typeVersion, const QByteArray& source, const QByteArray& context) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(type.toUtf8());
+    hash.addData(reinterpret_cast<const char*>(&typeVersion), sizeof(typeVersion));
+    hash.addData(source);
+    hash.addData(context);
+    return hash.result().toHex().toStdString();
+}
+
+bool ResourceDiskCache::writePayload(const Key& key, const QByteArray& payload) {
+    if (key.size() != KEY_LENGTH) {
+        qCWarning(resourceLog) << "Invalid resource disk cache key" << key.c_str();
+        return false;
+    }
+
+    EntryHeader header;
+    header.magic = ENTRY_MAGIC;
+    header.version = CURRENT_VERSION;
+    header.length = payload.size();
+    header.checksum = computeChecksum(payload.constData(), payload.size());
+
+    QByteArray data;
+    data.reserve(sizeof(EntryHeader) + payload.size());
+    data.append(reinterpret_cast<const char*>(&header), sizeof(EntryHeader));
+    data.append(payload);
+
+    auto file = writeFile(data.constData(), Metadata(key, data.size()));
+    if (!file) {
+        return false;
+    }
+    appendIndexRecord(key, header.length, header.checksum);
+    return true;
+}
+
+ResourceDiskCacheEntryPointer ResourceDiskCache::readPayload(const Key& key) {
+    auto file = getFile(key);
+    if (!file) {
+        ++_numMisses;
+        return nullptr;
+    }
+
+    ResourceDiskCacheEntryPointer entry(new ResourceDiskCacheEntry(file));
+    auto& qfile = entry->_qfile;
+    if (qfile.open(QIODevice::ReadOnly) && qfile.size() >= (qint64)sizeof(EntryHeader)) {
+        entry->_mapped = qfile.map(0, qfile.size());
+    }
+
+    bool valid = false;
+    if (entry->_mapped) {
+        EntryHeader header;
+        memcpy(&header, entry->_mapped, sizeof(EntryHeader));
+        const char* payload = reinterpret_cast<const char*>(entry->_mapped + sizeof(EntryHeader));
+        valid = header.magic == ENTRY_MAGIC && header.version == (uint32_t)CURRENT_VERSION &&
+            header.length == (uint64_t)(qfile.size() - sizeof(EntryHeader)) &&
+            header.checksum == computeChecksum(payload, header.length);
+        if (valid) {
+            entry->_data = payload;
+            entry->_size = header.length;
+        }
+    }
+
+    if (!valid) {
+        qCWarning(resourceLog) << "Dropping corrupt resource disk cache entry" << key.c_str();
+        entry.reset();
+        file.reset();
+        evict(key);
+        ++_numMisses;
+        return nullptr;
+    }
+
+    ++_numHits;
+    return entry;
+}
+
+std::string ResourceDiskCache::getIndexPath() const {
+    return QDir(getDirpath().c_str()).filePath(INDEX_FILENAME).toStdString();
+}
+
+void ResourceDiskCache::appendIndexRecord(const Key& key, uint64_t length, uint64_t checksum) {
+    IndexRecord record;
+    memcpy(record.key, key.data(), KEY_LENGTH);
+    record.length = length;
+    record.checksum = checksum;
+
+    std::unique_lock<std::mutex> lock(_indexMutex);
+    QFile index(getIndexPath().c_str());
+    if (!index.open(QIODevice::WriteOnly | QIODevice::Append) ||
+        index.write(reinterpret_cast<const char*>(&record), sizeof(IndexRecord)) != sizeof(IndexRecord)) {
+        qCWarning(resourceLog) << "Failed to update resource disk cache index";
+    }
+}
+
+void ResourceDiskCache::loadIndex() {
+    std::unique_lock<std::mutex> lock(_indexMutex);
+
+    // the last record written for a key wins
+    std::unordered_map<Key, IndexRecord> records;
+    {
+        QFile index(getIndexPath().c_str());
+        if (index.open(QIODevice::ReadOnly)) {
+            IndexRecord record;
+            while (index.read(reinterpret_cast<char*>(&record), sizeof(IndexRecord)) == sizeof(IndexRecord)) {
+                records[Key(record.key, KEY_LENGTH)] = record;
+            }
+        }
+    }
+
+    // drop any persisted entry the index doesn't vouch for
+    QDir dir(getDirpath().c_str());
+    auto nameFilters = QStringList(("*." + getExt()).c_str());
+    auto files = dir.entryList(nameFilters, QDir::Filters(QDir::NoDotAndDotDot | QDir::Files));
+    std::unordered_map<Key, IndexRecord> survivors;
+    foreach(QString filename, files) {
+        const Key key = filename.section('.', 0, 0).toStdString();
+        auto it = records.find(key);
+        bool valid = false;
+        if (it != records.end()) {
+            QFile file(dir.filePath(filename));
+            EntryHeader header;
+            valid = file.open(QIODevice::ReadOnly) &&
+                file.read(reinterpret_cast<char*>(&header), sizeof(EntryHeader)) == sizeof(EntryHeader) &&
+                header.magic == ENTRY_MAGIC && header.version == (uint32_t)CURRENT_VERSION &&
+                header.length == it->second.length && header.checksum == it->second.checksum &&
+                file.size() == (qint64)(sizeof(EntryHeader) + header.length);
+        }
+        if (valid) {
+            survivors[key] = it->second;
+        } else {
+            qCDebug(resourceLog) << "Evicting unindexed resource disk cache entry" << filename;
+            evict(key);
+        }
+    }
+
+    // compact the index down to the surviving entries
+    QSaveFile index(getIndexPath().c_str());
+    if (index.open(QIODevice::WriteOnly)) {
+        for (const auto& survivor : survivors) {
+            index.write(reinterpret_cast<const char*>(&survivor.second), sizeof(IndexRecord));
+        }
+        index.commit();
+    }
+
+    qCDebug(resourceLog) << "Resource disk cache holds" << (int)survivors.size() << "entries";
+}
@@ -0,0 +1,99 @@
+//
+//  ResourceDiskCache.h
+//  libraries/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceDiskCache_h
+#define hifi_ResourceDiskCache_h
+
+#include <atomic>
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <shared/FileCache.h>
+
+class ResourceDiskCacheTests;
+
+// A mapped, integrity checked view of a processed payload stored in the ResourceDiskCache.
+// The payload stays valid for as long as the entry is alive.
+class ResourceDiskCacheEntry {
+public:
+    ~ResourceDiskCacheEntry();
+
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    friend class ResourceDiskCache;
+
+    ResourceDiskCacheEntry(const cache::FilePointer& file) : _file(file), _qfile(file->getFilepath().c_str()) {}
+
+    cache::FilePointer _file;
+    QFile _qfile;
+    uchar* _mapped { nullptr };
+    const char* _data { nullptr };
+    size_t _size { 0 };
+};
+
+using ResourceDiskCacheEntryPointer = std::shared_ptr<ResourceDiskCacheEntry>;
+
+// Content addressed cache of post-processed (decoded, baked) resource payloads, shared by all ResourceCaches.
+//
+// Entries are keyed by a hash of the resource type, the type's payload format version and the raw downloaded
+// bytes, so a payload can never be stale relative to its source.  Each file carries a header with the payload
+// length and checksum, and an append-only index records the same for every write so that torn or tampered
+// files are dropped when the cache is initialized.  Eviction is LRU, inherited from cache::FileCache.
+class ResourceDiskCache : public cache::FileCache {
+    Q_OBJECT
+    Q_PROPERTY(size_t numHits READ getNumHits NOTIFY dirty)
+    Q_PROPERTY(size_t numMisses READ getNumMisses NOTIFY dirty)
+
+    friend class ::ResourceDiskCacheTests;
+
+public:
+    // Whenever a change is made to the on-disk layout of the cache that isn't backward compatible,
+    // this value should be incremented.  Entries written with another version are evicted on initialization
+    static const int CURRENT_VERSION;
+
+    static const std::string DEFAULT_DIRNAME;
+    static const std::string DEFAULT_EXT;
+
+    ResourceDiskCache(const std::string& dirname = DEFAULT_DIRNAME, const std::string& ext = DEFAULT_EXT);
+
+    void initialize() override;
+
+    // Computes the content address of a processed payload from the raw source bytes it was produced from, and from any
+    // other inputs (context) the processing depends on
+    static Key computeKey(const QString& type, int typeVersion, const QByteArray& source,
+                          const QByteArray& context = QByteArray());
+
+    // Stores a processed payload, returns false if the write failed
+    bool writePayload(const Key& key, const QByteArray& payload);
+
+    // Returns the mapped payload, or nullptr on a miss or if the entry failed its integrity check
+    ResourceDiskCacheEntryPointer readPayload(const Key& key);
+
+    size_t getNumHits() const { return _numHits; }
+    size_t getNumMisses() const { return _numMisses; }
+
+private:
+    void loadIndex();
+    void appendIndexRecord(const Key& key, uint64_t length, uint64_t checksum);
+    std::string getIndexPath() const;
+
+    std::atomic<size_t> _numHits { 0 };
+    std::atomic<size_t> _numMisses { 0 };
+    std::mutex _indexMutex;
+};
+
+using ResourceDiskCachePointer = std::shared_ptr<ResourceDiskCache>;
+
+#endif // hifi_ResourceDiskCache_h
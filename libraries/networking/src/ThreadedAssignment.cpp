@@ -18,6 +18,7 @@
 #include <QtCore/QTimer>
 
 #include <LogHandler.h>
+#include <Metrics.h>
 #include <shared/QtHelpers.h>
 
 #include <platform/Platform.h>
@@ -35,6 +36,7 @@ ThreadedAssignment::ThreadedAssignment(ReceivedMessage& message) :
     static const int STATS_TIMEOUT_MS = 1000;
     _statsTimer.setInterval(STATS_TIMEOUT_MS); // 1s, Qt::CoarseTimer acceptable
     connect(&_statsTimer, &QTimer::timeout, this, &ThreadedAssignment::sendStatsPacket);
+    connect(&_statsTimer, &QTimer::timeout, this, &ThreadedAssignment::sendMetricsPacket);
 
     connect(&_domainServerTimer, &QTimer::timeout, this, &ThreadedAssignment::checkInWithDomainServerOrExit);
     _domainServerTimer.setInterval(DOMAIN_SERVER_CHECK_IN_MSECS); // 1s, Qt::CoarseTimer acceptable
@@ -134,6 +136,13 @@ void ThreadedAssignment::sendStatsPacket() {
     addPacketStatsAndSendStatsPacket(statsObject);
 }
 
+void ThreadedAssignment::sendMetricsPacket() {
+    if (DependencyManager::isSet<MetricsRegistry>()) {
+        auto snapshot = DependencyManager::get<MetricsRegistry>()->snapshot();
+        DependencyManager::get<NodeList>()->sendMetricsToDomainServer(snapshot.toByteArray());
+    }
+}
+
 void ThreadedAssignment::checkInWithDomainServerOrExit() {
     // verify that the number of queued check-ins is not >= our max
     // the number of queued check-ins is cleared anytime we get a response from the domain-server
@@ -54,6 +54,7 @@ protected slots:
 
 private slots:
     void checkInWithDomainServerOrExit();
+    void sendMetricsPacket();
 };
 
 typedef QSharedPointer<ThreadedAssignment> SharedAssignmentPointer;
@@ -136,6 +136,7 @@ public:
         BulkAvatarTraitsAck,
         StopInjector,
         AvatarZonePresence,
+        NodeMetrics,
         NUM_PACKET_TYPE
     };
 
@@ -155,6 +156,7 @@ public:
     const static QSet<PacketTypeEnum::Value> getNonVerifiedPackets() {
         const static QSet<PacketTypeEnum::Value> NON_VERIFIED_PACKETS = QSet<PacketTypeEnum::Value>()
             << PacketTypeEnum::Value::NodeJsonStats
+            << PacketTypeEnum::Value::NodeMetrics
             << PacketTypeEnum::Value::EntityQuery
             << PacketTypeEnum::Value::OctreeDataNack
             << PacketTypeEnum::Value::EntityEditNack
@@ -377,7 +379,13 @@ enum class DomainListVersion : PacketVersion {
     GetMachineFingerprintFromUUIDSupport,
     AuthenticationOptional,
     HasTimestamp,
-    HasConnectReason
+    HasConnectReason,
+    HasDirectoryVersion
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreDirectoryVersion = 22,
+    HasDirectoryVersion
 };
 
 enum class AudioVersion : PacketVersion {
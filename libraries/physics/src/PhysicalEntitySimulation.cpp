@@ -54,10 +54,7 @@ void PhysicalEntitySimulation::addEntityToInternalLists(EntityItemPointer entity
             _entitiesToAddToPhysics.insert(entity);
         }
     } else if (canBeKinematic && entity->isMovingRelativeToParent()) {
-        SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-        if (itr == _simpleKinematicEntities.end()) {
-            _simpleKinematicEntities.insert(entity);
-        }
+        _simpleKinematicEntities.insert(entity);
     }
 }
 
@@ -140,10 +137,7 @@ void PhysicalEntitySimulation::processChangedEntity(const EntityItemPointer& ent
             removeOwnershipData(motionState);
             _entitiesToRemoveFromPhysics.insert(entity);
             if (canBeKinematic && entity->isMovingRelativeToParent()) {
-                SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                if (itr == _simpleKinematicEntities.end()) {
-                    _simpleKinematicEntities.insert(entity);
-                }
+                _simpleKinematicEntities.insert(entity);
             }
         } else {
             _incomingChanges.insert(motionState);
@@ -153,20 +147,11 @@ void PhysicalEntitySimulation::processChangedEntity(const EntityItemPointer& ent
         // The intent is for this object to be in the PhysicsEngine, but it has no MotionState yet.
         // Perhaps it's shape has changed and it can now be added?
         _entitiesToAddToPhysics.insert(entity);
-        SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-        if (itr != _simpleKinematicEntities.end()) {
-            _simpleKinematicEntities.erase(itr);
-        }
+        _simpleKinematicEntities.remove(entity);
     } else if (canBeKinematic && entity->isMovingRelativeToParent()) {
-        SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-        if (itr == _simpleKinematicEntities.end()) {
-            _simpleKinematicEntities.insert(entity);
-        }
+        _simpleKinematicEntities.insert(entity);
     } else {
-        SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-        if (itr != _simpleKinematicEntities.end()) {
-            _simpleKinematicEntities.erase(itr);
-        }
+        _simpleKinematicEntities.remove(entity);
     }
 }
 
@@ -298,7 +283,7 @@ void PhysicalEntitySimulation::buildMotionStatesForEntitiesThatNeedThem() {
                         // bummer, the hashes are different and we no longer want the shape we've received
                         ObjectMotionState::getShapeManager()->releaseShape(shape);
                         // try again
-                        shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
+                        shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo, true));
                         if (shape) {
                             buildMotionState(shape, entity);
                             requestItr = _shapeRequests.erase(requestItr);
@@ -343,10 +328,7 @@ void PhysicalEntitySimulation::buildMotionStatesForEntitiesThatNeedThem() {
         if (!entity->shouldBePhysical()) {
             // this entity should no longer be on _entitiesToAddToPhysics
             if (entity->isMovingRelativeToParent()) {
-                SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-                if (itr == _simpleKinematicEntities.end()) {
-                    _simpleKinematicEntities.insert(entity);
-                }
+                _simpleKinematicEntities.insert(entity);
             }
             entityItr = _entitiesToAddToPhysics.erase(entityItr);
             continue;
@@ -372,7 +354,7 @@ void PhysicalEntitySimulation::buildMotionStatesForEntitiesThatNeedThem() {
                 ShapeInfo shapeInfo;
                 entity->computeShapeInfo(shapeInfo);
                 uint32_t requestCount = ObjectMotionState::getShapeManager()->getWorkRequestCount();
-                btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
+                btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo, true));
                 if (shape) {
                     buildMotionState(shape, entity);
                 } else if (requestCount != ObjectMotionState::getShapeManager()->getWorkRequestCount()) {
@@ -428,14 +410,14 @@ void PhysicalEntitySimulation::buildPhysicsTransaction(PhysicsEngine::Transactio
         bool needsNewShape = object->needsNewShape();
         if (needsNewShape) {
             ShapeType shapeType = object->getShapeType();
-            if (shapeType == SHAPE_TYPE_STATIC_MESH) {
+            if (ShapeManager::isAsyncShapeType(shapeType)) {
                 ShapeRequest shapeRequest(object->_entity);
                 ShapeRequests::iterator  requestItr = _shapeRequests.find(shapeRequest);
                 if (requestItr == _shapeRequests.end()) {
                     ShapeInfo shapeInfo;
                     object->_entity->computeShapeInfo(shapeInfo);
                     uint32_t requestCount = ObjectMotionState::getShapeManager()->getWorkRequestCount();
-                    btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
+                    btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo, true));
                     if (shape) {
                         object->setShape(shape);
                         handledFlags |= Simulation::DIRTY_SHAPE;
@@ -11,14 +11,23 @@
 
 #include "PhysicsEngine.h"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <mutex>
+#include <thread>
 
 #include <QFile>
+#include <QProcessEnvironment>
 
 #include <PerfStat.h>
 #include <PhysicsCollisionGroups.h>
 #include <Profile.h>
 #include <BulletCollision/CollisionShapes/btTriangleShape.h>
+#if BT_THREADSAFE
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#endif
 
 #include "CharacterController.h"
 #include "ObjectMotionState.h"
@@ -38,17 +47,96 @@ PhysicsEngine::~PhysicsEngine() {
     delete _collisionDispatcher;
     delete _broadphaseFilter;
     delete _constraintSolver;
+#if BT_THREADSAFE
+    delete _constraintSolverPool;
+#endif
     delete _dynamicsWorld;
     delete _ghostPairCallback;
 }
 
+static const QString NUM_SIMULATION_THREADS_STRING { "HIFI_PHYSICS_THREADS" };
+
+// leaves the rest of the cores to the main, render, audio and network threads
+static const uint32_t MAX_DEFAULT_NUM_SIMULATION_THREADS = 4;
+
+static std::atomic<bool> numSimulationThreadsWereSet { false };
+
+#if BT_THREADSAFE
+static btITaskScheduler* getTaskScheduler() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        // the default scheduler owns a pool of worker threads; start out using only the calling thread
+        // until PhysicsEngine::init() or the application asks for more
+        btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+        if (scheduler) {
+            scheduler->setNumThreadsUsed(1);
+            btSetTaskScheduler(scheduler);
+        }
+    });
+    return btGetTaskScheduler();
+}
+#endif
+
+uint32_t PhysicsEngine::setNumSimulationThreads(uint32_t numThreads) {
+    numSimulationThreadsWereSet = true;
+#if BT_THREADSAFE
+    btITaskScheduler* scheduler = getTaskScheduler();
+    if (scheduler) {
+        scheduler->setNumThreadsUsed(glm::clamp((int)numThreads, 1, scheduler->getMaxNumThreads()));
+    }
+#endif
+    return getNumSimulationThreads();
+}
+
+uint32_t PhysicsEngine::getNumSimulationThreads() {
+#if BT_THREADSAFE
+    btITaskScheduler* scheduler = getTaskScheduler();
+    return scheduler ? (uint32_t)scheduler->getNumThreadsUsed() : 1;
+#else
+    return 1;
+#endif
+}
+
+uint32_t PhysicsEngine::getMaxNumSimulationThreads() {
+#if BT_THREADSAFE
+    btITaskScheduler* scheduler = getTaskScheduler();
+    return scheduler ? (uint32_t)scheduler->getMaxNumThreads() : 1;
+#else
+    return 1;
+#endif
+}
+
+uint32_t PhysicsEngine::getDefaultNumSimulationThreads() {
+    bool ok;
+    uint32_t numThreads = QProcessEnvironment::systemEnvironment().value(NUM_SIMULATION_THREADS_STRING).toUInt(&ok);
+    if (!ok) {
+        numThreads = std::min(std::thread::hardware_concurrency() / 2, MAX_DEFAULT_NUM_SIMULATION_THREADS);
+    }
+    return glm::clamp(numThreads, (uint32_t)1, getMaxNumSimulationThreads());
+}
+
 void PhysicsEngine::init() {
+    if (!numSimulationThreadsWereSet) {
+        setNumSimulationThreads(getDefaultNumSimulationThreads());
+    }
     if (!_dynamicsWorld) {
         _collisionConfig = new btDefaultCollisionConfiguration();
-        _collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
         _broadphaseFilter = new btDbvtBroadphase();
+#if BT_THREADSAFE
+        // narrowphase is dispatched in parallel and each island gets a solver from the pool,
+        // while the broadphase, motion state harvesting and substep callbacks stay on the physics thread
+        btITaskScheduler* scheduler = getTaskScheduler();
+        int numSolvers = scheduler ? scheduler->getMaxNumThreads() : 1;
+        _collisionDispatcher = new btCollisionDispatcherMt(_collisionConfig);
+        _constraintSolverPool = new btConstraintSolverPoolMt(numSolvers);
+        _constraintSolver = new btSequentialImpulseConstraintSolverMt();
+        _dynamicsWorld = new ThreadSafeDynamicsWorld(_collisionDispatcher, _broadphaseFilter, _constraintSolverPool,
+                                                     _constraintSolver, _collisionConfig);
+#else
+        _collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
         _constraintSolver = new btSequentialImpulseConstraintSolver;
         _dynamicsWorld = new ThreadSafeDynamicsWorld(_collisionDispatcher, _broadphaseFilter, _constraintSolver, _collisionConfig);
+#endif
         _physicsDebugDraw.reset(new PhysicsDebugDraw());
 
         // hook up debug draw renderer
@@ -415,6 +503,24 @@ void PhysicsEngine::harvestPerformanceStats() {
             itr->Next();
         }
     }
+
+    // shape construction happens outside of stepSimulation so it is reported separately
+    ShapeManager* shapeManager = ObjectMotionState::getShapeManager();
+    if (shapeManager) {
+        ShapeManager::Stats shapeStats = shapeManager->getStats();
+        uint32_t numBuilt = shapeStats.numBuilt - _lastShapeStats.numBuilt;
+        if (numBuilt > 0) {
+            PerformanceTimer::addTimerRecord("physics/shapes/build", shapeStats.buildTime - _lastShapeStats.buildTime);
+            PerformanceTimer::addTimerRecord("physics/shapes/stall", shapeStats.stallTime - _lastShapeStats.stallTime);
+        }
+        uint32_t numLookups = shapeStats.numCacheHits + shapeStats.numCacheMisses;
+        float hitRate = numLookups > 0 ? (float)shapeStats.numCacheHits / (float)numLookups : 0.0f;
+        PROFILE_COUNTER(simulation_physics, "ShapeCache", {
+            { "built", (int)shapeStats.numBuilt },
+            { "hitRate", hitRate }
+        });
+        _lastShapeStats = shapeStats;
+    }
 }
 
 void PhysicsEngine::printPerformanceStatsToFile(const QString& filename) {
@@ -26,6 +26,7 @@
 #include "ThreadSafeDynamicsWorld.h"
 #include "ObjectAction.h"
 #include "ObjectConstraint.h"
+#include "ShapeManager.h"
 
 const float HALF_SIMULATION_EXTENT = 512.0f; // meters
 
@@ -94,8 +95,20 @@ public:
 
     PhysicsEngine(const glm::vec3& offset);
     ~PhysicsEngine();
+    /// also sets the number of simulation threads to the default, unless it was set already
     void init();
 
+    /// \brief sets how many threads Bullet's task scheduler may use for collision dispatch and constraint solving
+    /// Has no effect unless Bullet was built with BULLET2_MULTITHREADING.  The scheduler is shared by all engines.
+    /// \return the number of threads that will actually be used
+    static uint32_t setNumSimulationThreads(uint32_t numThreads);
+
+    /// the HIFI_PHYSICS_THREADS environment variable if it is set, otherwise half of the cores up to four, clamped to
+    /// what the scheduler can provide
+    static uint32_t getDefaultNumSimulationThreads();
+    static uint32_t getNumSimulationThreads();
+    static uint32_t getMaxNumSimulationThreads();
+
     uint32_t getNumSubsteps() const;
     int32_t getNumCollisionObjects() const;
 
@@ -173,6 +186,9 @@ private:
     btCollisionDispatcher* _collisionDispatcher = NULL;
     btBroadphaseInterface* _broadphaseFilter = NULL;
     btSequentialImpulseConstraintSolver* _constraintSolver = NULL;
+#if BT_THREADSAFE
+    btConstraintSolverPoolMt* _constraintSolverPool = NULL;
+#endif
     ThreadSafeDynamicsWorld* _dynamicsWorld = NULL;
     btGhostPairCallback* _ghostPairCallback = NULL;
     std::unique_ptr<PhysicsDebugDraw> _physicsDebugDraw;
@@ -183,6 +199,7 @@ private:
     QHash<btRigidBody*, QSet<QUuid>> _objectDynamicsByBody;
     std::set<btRigidBody*> _activeStaticBodies;
     QString _statsFilename;
+    ShapeManager::Stats _lastShapeStats;
 
     glm::vec3 _originOffset;
 
@@ -0,0 +1,120 @@
+//
+//  ShapeCache.cpp
+//  libraries/physics/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ShapeCache.h"
+
+#include <cstring>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+
+#include "PhysicsLogging.h"
+#include "ShapeFactory.h"
+
+const int ShapeCache::CURRENT_VERSION = 0x01;
+
+const std::string ShapeCache::DEFAULT_DIRNAME { "shape_cache" };
+const std::string ShapeCache::DEFAULT_EXT { "hsc" };
+
+static const uint32_t SHAPE_MAGIC = 0x43534648; // "HFSC"
+
+struct ShapeHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t bulletVersion;
+    uint32_t length;
+    uint64_t checksum;
+};
+
+// FNV-1a
+static uint64_t computeChecksum(const char* data, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+ShapeCache::ShapeCache(const std::string& dirname, const std::string& ext) :
+    FileCache(dirname, ext) { }
+
+cache::FileCache::Key ShapeCache::computeKey(const ShapeInfo& info) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    auto addData = [&](const void* data, size_t size) {
+        hash.addData(reinterpret_cast<const char*>(data), (int)size);
+    };
+
+    uint64_t infoHash = info.getHash();
+    addData(&infoHash, sizeof(infoHash));
+    for (const auto& points : info.getPointCollection()) {
+        uint64_t numPoints = points.size();
+        addData(&numPoints, sizeof(numPoints));
+        addData(points.data(), points.size() * sizeof(glm::vec3));
+    }
+    const auto& triangleIndices = info.getTriangleIndices();
+    addData(triangleIndices.data(), triangleIndices.size() * sizeof(int32_t));
+    return hash.result().toHex().toStdString();
+}
+
+const btCollisionShape* ShapeCache::loadShape(const Key& key) {
+    auto file = getFile(key);
+    if (!file) {
+        ++_numMisses;
+        return nullptr;
+    }
+
+    const btCollisionShape* shape = nullptr;
+    QFile qfile(file->getFilepath().c_str());
+    if (qfile.open(QIODevice::ReadOnly)) {
+        QByteArray data = qfile.readAll();
+        ShapeHeader header;
+        if (data.size() >= (int)sizeof(ShapeHeader)) {
+            memcpy(&header, data.constData(), sizeof(ShapeHeader));
+            const char* payload = data.constData() + sizeof(ShapeHeader);
+            if (header.magic == SHAPE_MAGIC && header.version == (uint32_t)CURRENT_VERSION &&
+                    header.bulletVersion == (uint32_t)btGetVersion() &&
+                    header.length == (uint32_t)(data.size() - sizeof(ShapeHeader)) &&
+                    header.checksum == computeChecksum(payload, header.length)) {
+                shape = ShapeFactory::deserializeShape(payload, header.length);
+            }
+        }
+    }
+
+    if (!shape) {
+        qCWarning(physics) << "Dropping unreadable shape cache entry" << key.c_str();
+        file.reset();
+        evict(key);
+        ++_numMisses;
+        return nullptr;
+    }
+    ++_numHits;
+    return shape;
+}
+
+bool ShapeCache::saveShape(const Key& key, const btCollisionShape* shape) {
+    QByteArray payload;
+    if (!ShapeFactory::serializeShape(shape, payload)) {
+        return false;
+    }
+
+    ShapeHeader header;
+    header.magic = SHAPE_MAGIC;
+    header.version = CURRENT_VERSION;
+    header.bulletVersion = btGetVersion();
+    header.length = payload.size();
+    header.checksum = computeChecksum(payload.constData(), payload.size());
+
+    QByteArray data;
+    data.reserve(sizeof(ShapeHeader) + payload.size());
+    data.append(reinterpret_cast<const char*>(&header), sizeof(ShapeHeader));
+    data.append(payload);
+    return (bool)writeFile(data.constData(), Metadata(key, data.size()));
+}
@@ -0,0 +1,57 @@
+//
+//  ShapeCache.h
+//  libraries/physics/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ShapeCache_h
+#define hifi_ShapeCache_h
+
+#include <atomic>
+#include <memory>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <shared/FileCache.h>
+#include <ShapeInfo.h>
+
+// Persists the expensive btCollisionShapes (hulls, compounds of hulls and static meshes, including their bvh)
+// across sessions, keyed by a digest of everything in the ShapeInfo they were built from.  Files carry the Bullet version and
+// a checksum so entries written by another build, or torn on disk, are simply treated as misses.
+// Reads and writes are thread-safe so ShapeFactory::Workers can use the cache directly.
+class ShapeCache : public cache::FileCache {
+    Q_OBJECT
+public:
+    // Whenever a change is made to the serialized form of the shapes this value should be incremented
+    static const int CURRENT_VERSION;
+
+    static const std::string DEFAULT_DIRNAME;
+    static const std::string DEFAULT_EXT;
+
+    ShapeCache(const std::string& dirname = DEFAULT_DIRNAME, const std::string& ext = DEFAULT_EXT);
+
+    /// \return the key of the shape built from info.  Unlike ShapeInfo::getHash() it covers the points and triangles
+    /// of meshes, which can change from one session to the next while the model URL stays the same.
+    static Key computeKey(const ShapeInfo& info);
+
+    /// \return new shape owned by the caller (delete with ShapeFactory::deleteShape) or nullptr on a miss
+    const btCollisionShape* loadShape(const Key& key);
+
+    /// \return false if the shape type is not cached or the write failed
+    bool saveShape(const Key& key, const btCollisionShape* shape);
+
+    uint32_t getNumHits() const { return _numHits; }
+    uint32_t getNumMisses() const { return _numMisses; }
+
+private:
+    std::atomic_uint _numHits { 0 };
+    std::atomic_uint _numMisses { 0 };
+};
+
+using ShapeCachePointer = std::shared_ptr<ShapeCache>;
+
+#endif // hifi_ShapeCache_h
@@ -11,12 +11,47 @@
 
 #include "ShapeFactory.h"
 
+#include <cstring>
+
 #include <glm/gtx/norm.hpp>
 
 #include <SharedUtil.h> // for MILLIMETERS_PER_METER
 
 #include "BulletUtil.h"
+#include "ShapeCache.h"
+
 
+namespace {
+
+// helpers for the flat binary form of a shape tree used by the ShapeCache
+class ShapeWriter {
+public:
+    ShapeWriter(QByteArray& buffer) : _buffer(buffer) {}
+    template <typename T> void write(const T& value) { write(&value, sizeof(T)); }
+    void write(const void* data, size_t size) { _buffer.append(static_cast<const char*>(data), (int)size); }
+private:
+    QByteArray& _buffer;
+};
+
+class ShapeReader {
+public:
+    ShapeReader(const char* data, size_t size) : _data(data), _end(data + size) {}
+    template <typename T> bool read(T& value) { return read(&value, sizeof(T)); }
+    bool read(void* data, size_t size) {
+        if ((size_t)(_end - _data) < size) {
+            return false;
+        }
+        memcpy(data, _data, size);
+        _data += size;
+        return true;
+    }
+    bool atEnd() const { return _data == _end; }
+private:
+    const char* _data;
+    const char* _end;
+};
+
+} // anonymous namespace
 
 class StaticMeshShape : public btBvhTriangleMeshShape {
 public:
@@ -27,7 +62,21 @@ public:
         assert(_dataArray);
     }
 
+    // adopts a bvh that was deserialized in place inside bvhBuffer rather than building a new one
+    StaticMeshShape(btTriangleIndexVertexArray* dataArray, btOptimizedBvh* bvh, void* bvhBuffer)
+    :   btBvhTriangleMeshShape(dataArray, true, false), _dataArray(dataArray), _bvh(bvh), _bvhBuffer(bvhBuffer) {
+        assert(_dataArray);
+        setOptimizedBvh(_bvh);
+    }
+
     ~StaticMeshShape() {
+        if (_bvhBuffer) {
+            // the base class does not own an adopted bvh
+            _bvh->~btOptimizedBvh();
+            btAlignedFree(_bvhBuffer);
+            _bvh = nullptr;
+            _bvhBuffer = nullptr;
+        }
         assert(_dataArray);
         IndexedMeshArray& meshes = _dataArray->getIndexedMeshArray();
         for (int32_t i = 0; i < meshes.size(); ++i) {
@@ -44,9 +93,86 @@ public:
         _dataArray = nullptr;
     }
 
+    bool writeTo(ShapeWriter& writer) const {
+        const IndexedMeshArray& meshes = _dataArray->getIndexedMeshArray();
+        if (meshes.size() != 1) {
+            return false;
+        }
+        const btIndexedMesh& mesh = meshes[0];
+        writer.write((int32_t)mesh.m_indexType);
+        writer.write((int32_t)mesh.m_numTriangles);
+        writer.write((int32_t)mesh.m_numVertices);
+        writer.write(mesh.m_triangleIndexBase, (size_t)mesh.m_numTriangles * mesh.m_triangleIndexStride);
+        writer.write(mesh.m_vertexBase, (size_t)mesh.m_numVertices * mesh.m_vertexStride);
+
+        // the bvh is the expensive part of a mesh shape so we keep it too
+        btOptimizedBvh* bvh = const_cast<StaticMeshShape*>(this)->getOptimizedBvh();
+        uint32_t bvhSize = bvh ? bvh->calculateSerializeBufferSize() : 0;
+        writer.write(bvhSize);
+        if (bvhSize > 0) {
+            const uint32_t BVH_ALIGNMENT = 16;
+            void* buffer = btAlignedAlloc(bvhSize, BVH_ALIGNMENT);
+            bool serialized = bvh->serializeInPlace(buffer, bvhSize, false);
+            if (serialized) {
+                writer.write(buffer, bvhSize);
+            }
+            btAlignedFree(buffer);
+            return serialized;
+        }
+        return true;
+    }
+
+    static btCollisionShape* readFrom(ShapeReader& reader) {
+        const int32_t VERTICES_PER_TRIANGLE = 3;
+        int32_t indexType, numTriangles, numVertices;
+        if (!reader.read(indexType) || !reader.read(numTriangles) || !reader.read(numVertices) ||
+                (indexType != PHY_SHORT && indexType != PHY_INTEGER) || numTriangles < 1 || numVertices < 3) {
+            return nullptr;
+        }
+
+        btIndexedMesh mesh;
+        mesh.m_indexType = (PHY_ScalarType)indexType;
+        mesh.m_numTriangles = numTriangles;
+        mesh.m_triangleIndexStride = VERTICES_PER_TRIANGLE * (indexType == PHY_SHORT ? sizeof(int16_t) : sizeof(int32_t));
+        mesh.m_numVertices = numVertices;
+        mesh.m_vertexStride = VERTICES_PER_TRIANGLE * sizeof(btScalar);
+        mesh.m_vertexType = PHY_FLOAT;
+        size_t indexBytes = (size_t)numTriangles * mesh.m_triangleIndexStride;
+        size_t vertexBytes = (size_t)numVertices * mesh.m_vertexStride;
+        unsigned char* indices = new unsigned char[indexBytes];
+        unsigned char* vertices = new unsigned char[vertexBytes];
+        uint32_t bvhSize = 0;
+        if (!reader.read(indices, indexBytes) || !reader.read(vertices, vertexBytes) || !reader.read(bvhSize)) {
+            delete [] indices;
+            delete [] vertices;
+            return nullptr;
+        }
+        mesh.m_triangleIndexBase = indices;
+        mesh.m_vertexBase = vertices;
+        btTriangleIndexVertexArray* dataArray = new btTriangleIndexVertexArray;
+        dataArray->addIndexedMesh(mesh, mesh.m_indexType);
+
+        if (bvhSize > 0) {
+            const uint32_t BVH_ALIGNMENT = 16;
+            void* buffer = btAlignedAlloc(bvhSize, BVH_ALIGNMENT);
+            btOptimizedBvh* bvh = nullptr;
+            if (reader.read(buffer, bvhSize)) {
+                bvh = btOptimizedBvh::deSerializeInPlace(buffer, bvhSize, false);
+            }
+            if (bvh) {
+                return new StaticMeshShape(dataArray, bvh, buffer);
+            }
+            // fall through and rebuild the bvh
+            btAlignedFree(buffer);
+        }
+        return new StaticMeshShape(dataArray);
+    }
+
 private:
     // the StaticMeshShape owns its vertex/index data
     btTriangleIndexVertexArray* _dataArray;
+    btOptimizedBvh* _bvh { nullptr };
+    void* _bvhBuffer { nullptr };
 };
 
 // the dataArray must be created before we create the StaticMeshShape
@@ -488,7 +614,136 @@ void ShapeFactory::deleteShape(const btCollisionShape* shape) {
     delete nonConstShape;
 }
 
+static bool serializeNode(const btCollisionShape* shape, ShapeWriter& writer) {
+    int32_t type = shape->getShapeType();
+    writer.write(type);
+    switch (type) {
+        case CONVEX_HULL_SHAPE_PROXYTYPE: {
+            const btConvexHullShape* hull = static_cast<const btConvexHullShape*>(shape);
+            writer.write((float)hull->getMargin());
+            int32_t numPoints = hull->getNumPoints();
+            writer.write(numPoints);
+            const btVector3* points = hull->getUnscaledPoints();
+            for (int32_t i = 0; i < numPoints; ++i) {
+                glm::vec3 point = bulletToGLM(points[i]);
+                writer.write(point);
+            }
+            return true;
+        }
+        case COMPOUND_SHAPE_PROXYTYPE: {
+            const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+            int32_t numChildren = compound->getNumChildShapes();
+            writer.write(numChildren);
+            for (int32_t i = 0; i < numChildren; ++i) {
+                const btTransform& transform = compound->getChildTransform(i);
+                writer.write(bulletToGLM(transform.getOrigin()));
+                writer.write(bulletToGLM(transform.getRotation()));
+                if (!serializeNode(compound->getChildShape(i), writer)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case TRIANGLE_MESH_SHAPE_PROXYTYPE:
+            // ShapeFactory only makes triangle meshes as StaticMeshShapes
+            return static_cast<const StaticMeshShape*>(shape)->writeTo(writer);
+        default:
+            // primitives are cheaper to rebuild than to load
+            return false;
+    }
+}
+
+static btCollisionShape* deserializeNode(ShapeReader& reader) {
+    int32_t type;
+    if (!reader.read(type)) {
+        return nullptr;
+    }
+    switch (type) {
+        case CONVEX_HULL_SHAPE_PROXYTYPE: {
+            float margin;
+            int32_t numPoints;
+            if (!reader.read(margin) || !reader.read(numPoints) || numPoints < 1) {
+                return nullptr;
+            }
+            btConvexHullShape* hull = new btConvexHullShape();
+            for (int32_t i = 0; i < numPoints; ++i) {
+                glm::vec3 point;
+                if (!reader.read(point)) {
+                    delete hull;
+                    return nullptr;
+                }
+                hull->addPoint(glmToBullet(point), false);
+            }
+            hull->setMargin(margin);
+            hull->recalcLocalAabb();
+            return hull;
+        }
+        case COMPOUND_SHAPE_PROXYTYPE: {
+            int32_t numChildren;
+            if (!reader.read(numChildren) || numChildren < 1) {
+                return nullptr;
+            }
+            btCompoundShape* compound = new btCompoundShape();
+            for (int32_t i = 0; i < numChildren; ++i) {
+                glm::vec3 origin;
+                glm::quat rotation;
+                btCollisionShape* child = nullptr;
+                if (reader.read(origin) && reader.read(rotation)) {
+                    child = deserializeNode(reader);
+                }
+                if (!child) {
+                    ShapeFactory::deleteShape(compound);
+                    return nullptr;
+                }
+                compound->addChildShape(btTransform(glmToBullet(rotation), glmToBullet(origin)), child);
+            }
+            return compound;
+        }
+        case TRIANGLE_MESH_SHAPE_PROXYTYPE:
+            return StaticMeshShape::readFrom(reader);
+        default:
+            return nullptr;
+    }
+}
+
+bool ShapeFactory::serializeShape(const btCollisionShape* shape, QByteArray& buffer) {
+    assert(shape);
+    buffer.clear();
+    ShapeWriter writer(buffer);
+    if (!serializeNode(shape, writer)) {
+        buffer.clear();
+        return false;
+    }
+    return true;
+}
+
+const btCollisionShape* ShapeFactory::deserializeShape(const char* data, size_t size) {
+    ShapeReader reader(data, size);
+    btCollisionShape* shape = deserializeNode(reader);
+    if (shape && !reader.atEnd()) {
+        // trailing garbage means we misread something along the way
+        ShapeFactory::deleteShape(shape);
+        shape = nullptr;
+    }
+    return shape;
+}
+
 void ShapeFactory::Worker::run() {
-    shape = ShapeFactory::createShapeFromInfo(shapeInfo);
+    uint64_t start = usecTimestampNow();
+    fromCache = false;
+    shape = nullptr;
+    ShapeCache::Key key;
+    if (cache) {
+        key = ShapeCache::computeKey(shapeInfo);
+        shape = cache->loadShape(key);
+        fromCache = (shape != nullptr);
+    }
+    if (!shape) {
+        shape = ShapeFactory::createShapeFromInfo(shapeInfo);
+        if (shape && cache) {
+            cache->saveShape(key, shape);
+        }
+    }
+    buildTime = usecTimestampNow() - start;
     emit submitWork(this);
 }
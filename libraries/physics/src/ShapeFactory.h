@@ -12,19 +12,29 @@
 #ifndef hifi_ShapeFactory_h
 #define hifi_ShapeFactory_h
 
+#include <memory>
+
 #include <btBulletDynamicsCommon.h>
 #include <glm/glm.hpp>
 #include <QObject>
+#include <QtCore/QByteArray>
 #include <QtCore/QRunnable>
 
 #include <ShapeInfo.h>
 
+class ShapeCache;
+
 // The ShapeFactory assembles and correctly disassembles btCollisionShapes.
 
 namespace ShapeFactory {
     const btCollisionShape* createShapeFromInfo(const ShapeInfo& info);
     void deleteShape(const btCollisionShape* shape);
 
+    // Only the expensive shapes (hulls, compounds of hulls and static meshes) can be serialized.
+    // serializeShape() returns false for anything else.
+    bool serializeShape(const btCollisionShape* shape, QByteArray& buffer);
+    const btCollisionShape* deserializeShape(const char* data, size_t size);
+
     class Worker : public QObject, public QRunnable {
         Q_OBJECT
     public:
@@ -32,6 +42,9 @@ namespace ShapeFactory {
         void run() override;
         ShapeInfo shapeInfo;
         const btCollisionShape* shape;
+        std::shared_ptr<ShapeCache> cache;
+        uint64_t buildTime { 0 }; // usec
+        bool fromCache { false };
     signals:
         void submitWork(Worker*);
     };
@@ -15,6 +15,7 @@
 #include <QThreadPool>
 
 #include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 const int MAX_RING_SIZE = 256;
 
@@ -36,7 +37,38 @@ ShapeManager::~ShapeManager() {
     }
 }
 
-const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
+bool ShapeManager::isAsyncShapeType(ShapeType type) {
+    switch (type) {
+        case SHAPE_TYPE_COMPOUND:
+        case SHAPE_TYPE_SIMPLE_HULL:
+        case SHAPE_TYPE_SIMPLE_COMPOUND:
+        case SHAPE_TYPE_STATIC_MESH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void ShapeManager::enableDiskCache(const std::string& dirname) {
+    if (!_diskCache) {
+        _diskCache = std::make_shared<ShapeCache>(dirname);
+        _diskCache->initialize();
+    }
+}
+
+ShapeManager::Stats ShapeManager::getStats() const {
+    Stats stats;
+    stats.buildTime = _buildTime;
+    stats.stallTime = _stallTime;
+    stats.numBuilt = _numBuilt;
+    if (_diskCache) {
+        stats.numCacheHits = _diskCache->getNumHits();
+        stats.numCacheMisses = _diskCache->getNumMisses();
+    }
+    return stats;
+}
+
+const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info, bool allowAsync) {
     if (info.getType() == SHAPE_TYPE_NONE) {
         return nullptr;
     }
@@ -47,7 +79,8 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         return shapeRef->shape;
     }
     const btCollisionShape* shape = nullptr;
-    if (info.getType() == SHAPE_TYPE_STATIC_MESH) {
+    bool expensive = isAsyncShapeType(info.getType());
+    if (info.getType() == SHAPE_TYPE_STATIC_MESH || (expensive && allowAsync)) {
         uint64_t hash = info.getHash();
 
         // bump the request count to the caller knows we're 
@@ -66,6 +99,7 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
                 worker->shapeInfo = info;
                 _deadWorker = nullptr;
             }
+            worker->cache = _diskCache;
             // we will delete worker manually later
             worker->setAutoDelete(false);
             QObject::connect(worker, &ShapeFactory::Worker::submitWork, this, &ShapeManager::acceptWork);
@@ -73,7 +107,18 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
         }
         // else we're still waiting for the shape to be created on another thread
     } else {
-        shape = ShapeFactory::createShapeFromInfo(info);
+        uint64_t start = usecTimestampNow();
+        if (expensive && _diskCache) {
+            // only workers write to the cache, so a synchronous miss never also pays for the write
+            shape = _diskCache->loadShape(ShapeCache::computeKey(info));
+        }
+        if (!shape) {
+            shape = ShapeFactory::createShapeFromInfo(info);
+        }
+        uint64_t elapsed = usecTimestampNow() - start;
+        _buildTime += elapsed;
+        _stallTime += elapsed;
+        ++_numBuilt;
         if (shape) {
             ShapeReference newRef;
             newRef.refCount = 1;
@@ -274,9 +319,15 @@ void ShapeManager::acceptWork(ShapeFactory::Worker* worker) {
         // delete the previous deadWorker manually
         delete _deadWorker;
     }
+    _buildTime += worker->buildTime;
+    ++_numBuilt;
+
     // save this dead worker for later
     worker->shapeInfo.clear();
     worker->shape = nullptr;
+    worker->cache.reset();
+    worker->buildTime = 0;
+    worker->fromCache = false;
     _deadWorker = worker;
     ++_workDeliveryCount;
 }
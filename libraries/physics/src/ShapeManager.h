@@ -22,6 +22,7 @@
 
 #include <ShapeInfo.h>
 
+#include "ShapeCache.h"
 #include "ShapeFactory.h"
 #include "HashKey.h"
 
@@ -46,6 +47,10 @@
 // doesn't delete it right away.  Instead it puts the shape's key on a list delete
 // later.  When that list grows big enough the ShapeManager will remove any matching
 // entries that still have zero ref-count.
+//
+// Hulls, compounds of hulls and static meshes are expensive to build so they may be
+// built on worker threads (see getShape()) and, when a ShapeCache is enabled, are
+// persisted to disk so they load instead of being rebuilt on later visits.
 
 
 class ShapeManager : public QObject {
@@ -55,8 +60,14 @@ public:
     ShapeManager();
     ~ShapeManager();
 
+    /// \return true for the shape types that are built on worker threads when allowed
+    static bool isAsyncShapeType(ShapeType type);
+
+    /// \param allowAsync when true expensive shapes are built on a worker thread: nullptr is returned, the
+    /// work request count is bumped and the shape becomes available via getShapeByKey() once delivered.
+    /// Static meshes are always built asynchronously.
     /// \return pointer to shape
-    const btCollisionShape* getShape(const ShapeInfo& info);
+    const btCollisionShape* getShape(const ShapeInfo& info, bool allowAsync = false);
     const btCollisionShape* getShapeByKey(uint64_t key);
     bool hasShapeWithKey(uint64_t key) const;
 
@@ -74,6 +85,21 @@ public:
     uint32_t getWorkRequestCount() const { return _workRequestCount; }
     uint32_t getWorkDeliveryCount() const { return _workDeliveryCount; }
 
+    /// load expensive shapes from, and save them to, a persistent cache on disk
+    void enableDiskCache(const std::string& dirname = ShapeCache::DEFAULT_DIRNAME);
+    const ShapeCachePointer& getDiskCache() const { return _diskCache; }
+
+    // accumulated totals, so consumers can report the change between samples
+    class Stats {
+    public:
+        uint64_t buildTime { 0 }; // usec spent building or loading shapes, on any thread
+        uint64_t stallTime { 0 }; // usec spent building or loading shapes on the calling thread
+        uint32_t numBuilt { 0 };
+        uint32_t numCacheHits { 0 };
+        uint32_t numCacheMisses { 0 };
+    };
+    Stats getStats() const;
+
 protected slots:
     void acceptWork(ShapeFactory::Worker* worker);
 
@@ -102,11 +128,15 @@ private:
     std::vector<uint64_t> _garbageRing;
     std::vector<uint64_t> _pendingMeshShapes;
     std::vector<KeyExpiry> _orphans;
+    ShapeCachePointer _diskCache;
     ShapeFactory::Worker* _deadWorker { nullptr };
     TimePoint _nextOrphanExpiry;
     uint32_t _ringIndex { 0 };
     std::atomic_uint _workRequestCount { 0 };
     std::atomic_uint _workDeliveryCount { 0 };
+    std::atomic<uint64_t> _buildTime { 0 };
+    std::atomic<uint64_t> _stallTime { 0 };
+    std::atomic_uint _numBuilt { 0 };
 };
 
 #endif // hifi_ShapeManager_h
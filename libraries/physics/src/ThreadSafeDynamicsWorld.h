@@ -21,21 +21,39 @@
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 
+// When Bullet is built with BULLET2_MULTITHREADING the world derives from btDiscreteDynamicsWorldMt,
+// which parallelizes constraint solving and transform integration over Bullet's task scheduler.
+#if BT_THREADSAFE
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+using DynamicsWorldBase = btDiscreteDynamicsWorldMt;
+#else
+using DynamicsWorldBase = btDiscreteDynamicsWorld;
+#endif
+
 #include "ObjectMotionState.h"
 
 #include <functional>
 
 using SubStepCallback = std::function<void()>;
 
-ATTRIBUTE_ALIGNED16(class) ThreadSafeDynamicsWorld : public btDiscreteDynamicsWorld {
+ATTRIBUTE_ALIGNED16(class) ThreadSafeDynamicsWorld : public DynamicsWorldBase {
 public:
     BT_DECLARE_ALIGNED_ALLOCATOR();
 
+#if BT_THREADSAFE
+    ThreadSafeDynamicsWorld(
+            btDispatcher* dispatcher,
+            btBroadphaseInterface* pairCache,
+            btConstraintSolverPoolMt* solverPool,
+            btConstraintSolver* constraintSolverMt,
+            btCollisionConfiguration* collisionConfiguration);
+#else
     ThreadSafeDynamicsWorld(
             btDispatcher* dispatcher,
             btBroadphaseInterface* pairCache,
             btConstraintSolver* constraintSolver,
             btCollisionConfiguration* collisionConfiguration);
+#endif
 
     int getNumSubsteps() const { return _numSubsteps; }
     int stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps = 1,
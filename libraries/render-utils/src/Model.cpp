@@ -1689,54 +1689,6 @@ public:
     }
 };
 
-static void packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10(glm::uvec4& packed, const BlendshapeOffsetUnpacked& unpacked) {
-    float len = glm::compMax(glm::abs(unpacked.positionOffset));
-    glm::vec3 normalizedPos(unpacked.positionOffset);
-    if (len > 0.0f) {
-        normalizedPos /= len;
-    } else {
-        len = 1.0f;
-    }
-
-    packed = glm::uvec4(
-        glm::floatBitsToUint(len),
-        glm_packSnorm3x10_1x2(glm::vec4(normalizedPos, 0.0f)),
-        glm_packSnorm3x10_1x2(glm::vec4(unpacked.normalOffset, 0.0f)),
-        glm_packSnorm3x10_1x2(glm::vec4(unpacked.tangentOffset, 0.0f))
-    );
-}
-
-static void packBlendshapeOffsets_ref(BlendshapeOffsetUnpacked* unpacked, BlendshapeOffsetPacked* packed, int size) {
-    for (int i = 0; i < size; ++i) {
-        packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10((*packed).packedPosNorTan, (*unpacked));
-        ++unpacked;
-        ++packed;
-    }
-}
-
-#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
-//
-// Runtime CPU dispatch
-//
-#include <CPUDetect.h>
-
-void packBlendshapeOffsets_AVX2(float (*unpacked)[9], uint32_t (*packed)[4], int size);
-
-static void packBlendshapeOffsets(BlendshapeOffsetUnpacked* unpacked, BlendshapeOffsetPacked* packed, int size) {
-    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
-    if (_cpuSupportsAVX2) {
-        static_assert(sizeof(BlendshapeOffsetUnpacked) == 9 * sizeof(float), "struct BlendshapeOffsetUnpacked size doesn't match.");
-        static_assert(sizeof(BlendshapeOffsetPacked) == 4 * sizeof(uint32_t), "struct BlendshapeOffsetPacked size doesn't match.");
-        packBlendshapeOffsets_AVX2((float(*)[9])unpacked, (uint32_t(*)[4])packed, size);
-    } else {
-        packBlendshapeOffsets_ref(unpacked, packed, size);
-    }
-}
-
-#else   // portable reference code
-static auto& packBlendshapeOffsets = packBlendshapeOffsets_ref;
-#endif
-
 class Blender : public QRunnable {
 public:
 
@@ -1760,75 +1712,59 @@ Blender::Blender(ModelPointer model, HFMModel::ConstPointer hfmModel, int blendN
 
 void Blender::run() {
     DETAILED_PROFILE_RANGE_EX(simulation_animation, __FUNCTION__, 0xFFFF0000, 0, { { "url", _model->getURL().toString() } });
-    int numBlendshapeOffsets = 0;  // number of offsets required for all meshes.
-    int maxBlendshapeOffsets = 0;  // number of offsets in the largest mesh.
-    int numMeshes = 0;  // number of meshes in this model.
-    for (auto meshIter = _hfmModel->meshes.cbegin(); meshIter != _hfmModel->meshes.cend(); ++meshIter) {
-        numMeshes++;
-        if (meshIter->blendshapes.isEmpty()) {
-            continue;
-        }
-        int numVertsInMesh = meshIter->vertices.size();
-        numBlendshapeOffsets += numVertsInMesh;
-        maxBlendshapeOffsets = std::max(maxBlendshapeOffsets, numVertsInMesh);
-    }
+    auto modelBlender = DependencyManager::get<ModelBlender>();
 
-    // allocate the required sizes
     QVector<int> blendedMeshSizes;
-    blendedMeshSizes.reserve(numMeshes);
-
     QVector<BlendshapeOffset> packedBlendshapeOffsets;
-    packedBlendshapeOffsets.resize(numBlendshapeOffsets);
+    if (!modelBlender->findSharedBlend(_hfmModel, _blendshapeCoefficients, packedBlendshapeOffsets, blendedMeshSizes)) {
+        auto bakedBlendshapes = modelBlender->getBakedBlendshapes(_hfmModel);
 
-    QVector<BlendshapeOffsetUnpacked> unpackedBlendshapeOffsets;
-    unpackedBlendshapeOffsets.resize(maxBlendshapeOffsets);    // reuse for all meshes
-
-    int offset = 0;
-    for (auto meshIter = _hfmModel->meshes.cbegin(); meshIter != _hfmModel->meshes.cend(); ++meshIter) {
-        if (meshIter->blendshapes.isEmpty()) {
-            blendedMeshSizes.push_back(0);
-            continue;
-        }
-        int numVertsInMesh = meshIter->vertices.size();
-        blendedMeshSizes.push_back(numVertsInMesh);
-
-        // initialize offsets to zero
-        memset(unpackedBlendshapeOffsets.data(), 0, numVertsInMesh * sizeof(BlendshapeOffsetUnpacked));
-
-        // for each blendshape in this mesh, accumulate the offsets into unpackedBlendshapeOffsets.
-        const float NORMAL_COEFFICIENT_SCALE = 0.01f;
-        for (int i = 0, n = qMin(_blendshapeCoefficients.size(), meshIter->blendshapes.size()); i < n; i++) {
-            float vertexCoefficient = _blendshapeCoefficients.at(i);
-            const float EPSILON = 0.0001f;
-            if (vertexCoefficient < EPSILON) {
+        int numBlendshapeOffsets = 0;  // number of offsets required for all meshes.
+        int maxStride = 0;  // length of the accumulated planes for the largest mesh.
+        for (const auto& baked : *bakedBlendshapes) {
+            if (baked.getNumBlendshapes() == 0) {
                 continue;
             }
+            numBlendshapeOffsets += baked.getNumVertices();
+            maxStride = std::max(maxStride, baked.getStride());
+        }
 
-            float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
-            const HFMBlendshape& blendshape = meshIter->blendshapes.at(i);
-            for (int j = 0; j < blendshape.indices.size(); ++j) {
-                int index = blendshape.indices.at(j);
+        // allocate the required sizes
+        blendedMeshSizes.reserve((int)bakedBlendshapes->size());
+        packedBlendshapeOffsets.resize(numBlendshapeOffsets);
+        std::vector<float> unpackedBlendshapeOffsets(BakedBlendshapes::NUM_COMPONENTS * maxStride);    // reuse for all meshes
 
-                auto& currentBlendshapeOffset = unpackedBlendshapeOffsets[index];
-                currentBlendshapeOffset.positionOffset += blendshape.vertices.at(j) * vertexCoefficient;
-                currentBlendshapeOffset.normalOffset += blendshape.normals.at(j) * normalCoefficient;
-                if (j < blendshape.tangents.size()) {
-                    currentBlendshapeOffset.tangentOffset += blendshape.tangents.at(j) * normalCoefficient;
-                }
+        static_assert(sizeof(BlendshapeOffsetPacked) == 4 * sizeof(uint32_t), "struct BlendshapeOffsetPacked size doesn't match.");
+        const BlendshapeOffsetPacked ZERO_BLENDSHAPE_OFFSET { glm::uvec4(glm::floatBitsToUint(1.0f), 0, 0, 0) };
+
+        int offset = 0;
+        for (const auto& baked : *bakedBlendshapes) {
+            if (baked.getNumBlendshapes() == 0) {
+                blendedMeshSizes.push_back(0);
+                continue;
+            }
+            int numVertsInMesh = baked.getNumVertices();
+            blendedMeshSizes.push_back(numVertsInMesh);
+
+            // accumulate the offsets of the active blendshapes, then pack them for the gpu.
+            const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+            auto unpacked = unpackedBlendshapeOffsets.data();
+            auto packed = packedBlendshapeOffsets.data() + offset;
+            if (baked.accumulate(_blendshapeCoefficients.constData(), _blendshapeCoefficients.size(), NORMAL_COEFFICIENT_SCALE, unpacked) > 0) {
+                packBlendshapeOffsets(unpacked, baked.getStride(), (uint32_t(*)[4])packed, numVertsInMesh);
+            } else {
+                std::fill(packed, packed + numVertsInMesh, ZERO_BLENDSHAPE_OFFSET);
             }
-        }
 
-        // convert unpackedBlendshapeOffsets into packedBlendshapeOffsets for the gpu.
-        auto unpacked = unpackedBlendshapeOffsets.data();
-        auto packed = packedBlendshapeOffsets.data() + offset;
-        packBlendshapeOffsets(unpacked, packed, numVertsInMesh);
+            offset += numVertsInMesh;
+        }
+        Q_ASSERT(offset == numBlendshapeOffsets);
 
-        offset += numVertsInMesh;
+        modelBlender->shareBlend(_hfmModel, _blendshapeCoefficients, packedBlendshapeOffsets, blendedMeshSizes);
     }
-    Q_ASSERT(offset == numBlendshapeOffsets);
 
     // post the result to the ModelBlender, which will dispatch to the model if still alive
-    QMetaObject::invokeMethod(DependencyManager::get<ModelBlender>().data(), "setBlendedVertices",
+    QMetaObject::invokeMethod(modelBlender.data(), "setBlendedVertices",
                               Q_ARG(ModelPointer, _model), Q_ARG(int, _blendNumber),
                               Q_ARG(QVector<BlendshapeOffset>, packedBlendshapeOffsets),
                               Q_ARG(QVector<int>, blendedMeshSizes));
@@ -1871,6 +1807,66 @@ void ModelBlender::noteRequiresBlend(ModelPointer model) {
     }
 }
 
+ModelBlender::BakedBlendshapesPointer ModelBlender::getBakedBlendshapes(const HFMModel::ConstPointer& hfmModel) {
+    {
+        Lock lock(_bakedMutex);
+        auto itr = _bakedModels.find(hfmModel.get());
+        if (itr != _bakedModels.end() && itr->second.hfmModel.lock() == hfmModel) {
+            return itr->second.blendshapes;
+        }
+    }
+
+    // bake outside of the lock, at worst two blenders bake the same model once
+    auto blendshapes = std::make_shared<std::vector<BakedBlendshapes>>();
+    blendshapes->reserve(hfmModel->meshes.size());
+    for (const auto& mesh : hfmModel->meshes) {
+        blendshapes->emplace_back(mesh.blendshapes.isEmpty() ? 0 : mesh.vertices.size());
+        auto& baked = blendshapes->back();
+        for (const auto& blendshape : mesh.blendshapes) {
+            int numOffsets = std::min(blendshape.indices.size(), std::min(blendshape.vertices.size(), blendshape.normals.size()));
+            baked.addBlendshape(numOffsets, blendshape.indices.constData(), blendshape.vertices.constData(),
+                                blendshape.normals.constData(), blendshape.tangents.size(), blendshape.tangents.constData());
+        }
+    }
+
+    Lock lock(_bakedMutex);
+    for (auto itr = _bakedModels.begin(); itr != _bakedModels.end();) {
+        if (itr->second.hfmModel.expired()) {
+            itr = _bakedModels.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    _bakedModels[hfmModel.get()] = { hfmModel, blendshapes };
+    return blendshapes;
+}
+
+bool ModelBlender::findSharedBlend(const HFMModel::ConstPointer& hfmModel, const QVector<float>& blendshapeCoefficients,
+                                   QVector<BlendshapeOffset>& blendshapeOffsets, QVector<int>& blendedMeshSizes) {
+    Lock lock(_bakedMutex);
+    for (auto itr = _sharedBlends.begin(); itr != _sharedBlends.end(); ++itr) {
+        if (itr->hfmModel.lock() == hfmModel && itr->blendshapeCoefficients == blendshapeCoefficients) {
+            blendshapeOffsets = itr->blendshapeOffsets;
+            blendedMeshSizes = itr->blendedMeshSizes;
+            _sharedBlends.splice(_sharedBlends.begin(), _sharedBlends, itr);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ModelBlender::shareBlend(const HFMModel::ConstPointer& hfmModel, const QVector<float>& blendshapeCoefficients,
+                              const QVector<BlendshapeOffset>& blendshapeOffsets, const QVector<int>& blendedMeshSizes) {
+    // enough for the distinct expressions of a crowd, small enough to search on every blend
+    const size_t MAX_SHARED_BLENDS = 32;
+
+    Lock lock(_bakedMutex);
+    _sharedBlends.push_front({ hfmModel, blendshapeCoefficients, blendshapeOffsets, blendedMeshSizes });
+    while (_sharedBlends.size() > MAX_SHARED_BLENDS) {
+        _sharedBlends.pop_back();
+    }
+}
+
 void ModelBlender::setBlendedVertices(ModelPointer model, int blendNumber, QVector<BlendshapeOffset> blendshapeOffsets, QVector<int> blendedMeshSizes) {
     if (model) {
         auto blendshapeOperator = model->getModelBlendshapeOperator();
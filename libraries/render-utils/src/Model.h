@@ -20,8 +20,10 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <list>
 
 #include <AABox.h>
+#include <BakedBlendshapes.h>
 #include <DependencyManager.h>
 #include <GeometryUtil.h>
 #include <gpu/Batch.h>
@@ -80,12 +82,6 @@ struct BlendshapeOffsetPacked {
     glm::uvec4 packedPosNorTan;
 };
 
-struct BlendshapeOffsetUnpacked {
-    glm::vec3 positionOffset;
-    glm::vec3 normalOffset;
-    glm::vec3 tangentOffset;
-};
-
 using BlendshapeOffset = BlendshapeOffsetPacked;
 using BlendShapeOperator = std::function<void(int, const QVector<BlendshapeOffset>&, const QVector<int>&, const render::ItemIDs&)>;
 
@@ -544,6 +540,17 @@ public:
 
     bool shouldComputeBlendshapes() { return _computeBlendshapes; }
 
+    using BakedBlendshapesPointer = std::shared_ptr<const std::vector<BakedBlendshapes>>;
+
+    /// Returns the blendshapes of each mesh of the model baked for accumulation, baking them on first use.
+    BakedBlendshapesPointer getBakedBlendshapes(const HFMModel::ConstPointer& hfmModel);
+
+    /// Models with the same geometry and coefficients, such as a crowd of idle avatars, share their blends.
+    bool findSharedBlend(const HFMModel::ConstPointer& hfmModel, const QVector<float>& blendshapeCoefficients,
+                         QVector<BlendshapeOffset>& blendshapeOffsets, QVector<int>& blendedMeshSizes);
+    void shareBlend(const HFMModel::ConstPointer& hfmModel, const QVector<float>& blendshapeCoefficients,
+                    const QVector<BlendshapeOffset>& blendshapeOffsets, const QVector<int>& blendedMeshSizes);
+
 public slots:
     void setBlendedVertices(ModelPointer model, int blendNumber, QVector<BlendshapeOffset> blendshapeOffsets, QVector<int> blendedMeshSizes);
     void setComputeBlendshapes(bool computeBlendshapes) { _computeBlendshapes = computeBlendshapes; }
@@ -560,6 +567,21 @@ private:
     int _pendingBlenders;
     Mutex _mutex;
 
+    struct BakedModel {
+        std::weak_ptr<const HFMModel> hfmModel;
+        BakedBlendshapesPointer blendshapes;
+    };
+    std::unordered_map<const HFMModel*, BakedModel> _bakedModels;
+
+    struct SharedBlend {
+        std::weak_ptr<const HFMModel> hfmModel;
+        QVector<float> blendshapeCoefficients;
+        QVector<BlendshapeOffset> blendshapeOffsets;
+        QVector<int> blendedMeshSizes;
+    };
+    std::list<SharedBlend> _sharedBlends; // most recently used first
+    Mutex _bakedMutex;
+
     bool _computeBlendshapes { true };
 };
 
@@ -0,0 +1,239 @@
+//
+//  BakedBlendshapes.cpp
+//  libraries/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakedBlendshapes.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "GLMHelpers.h"
+
+const float BakedBlendshapes::MIN_COEFFICIENT = 0.0001f;
+
+// a run of consecutive vertices becomes a dense block when the blendshape touches at least this many of them
+static const int MIN_DENSE_BLOCK_FILL = BakedBlendshapes::BLOCK_SIZE / 2;
+
+static const int BLOCK_FLOATS = BakedBlendshapes::NUM_COMPONENTS * BakedBlendshapes::BLOCK_SIZE;
+
+static void accumulateDenseBlocks_ref(const int32_t* indices, const float* blocks, int numBlocks,
+                                      float positionCoefficient, float normalCoefficient, float* offsets, int stride) {
+    for (int b = 0; b < numBlocks; b++) {
+        for (int k = 0; k < BakedBlendshapes::NUM_COMPONENTS; k++) {
+            float coefficient = k < 3 ? positionCoefficient : normalCoefficient;
+            const float* src = blocks + b * BLOCK_FLOATS + k * BakedBlendshapes::BLOCK_SIZE;
+            float* dst = offsets + k * stride + indices[b];
+            for (int lane = 0; lane < BakedBlendshapes::BLOCK_SIZE; lane++) {
+                dst[lane] += src[lane] * coefficient;
+            }
+        }
+    }
+}
+
+static void accumulateSparseBlocks_ref(const int32_t* indices, const float* blocks, int numBlocks,
+                                       float positionCoefficient, float normalCoefficient, float* offsets, int stride) {
+    for (int b = 0; b < numBlocks; b++) {
+        const int32_t* blockIndices = indices + b * BakedBlendshapes::BLOCK_SIZE;
+        for (int k = 0; k < BakedBlendshapes::NUM_COMPONENTS; k++) {
+            float coefficient = k < 3 ? positionCoefficient : normalCoefficient;
+            const float* src = blocks + b * BLOCK_FLOATS + k * BakedBlendshapes::BLOCK_SIZE;
+            float* plane = offsets + k * stride;
+            for (int lane = 0; lane < BakedBlendshapes::BLOCK_SIZE; lane++) {
+                plane[blockIndices[lane]] += src[lane] * coefficient;
+            }
+        }
+    }
+}
+
+static void packBlendshapeOffsets_ref(const float* offsets, int stride, uint32_t (*packed)[4], int numVertices) {
+    for (int i = 0; i < numVertices; i++) {
+        glm::vec3 position(offsets[i], offsets[stride + i], offsets[2 * stride + i]);
+        glm::vec3 normal(offsets[3 * stride + i], offsets[4 * stride + i], offsets[5 * stride + i]);
+        glm::vec3 tangent(offsets[6 * stride + i], offsets[7 * stride + i], offsets[8 * stride + i]);
+
+        float len = glm::compMax(glm::abs(position));
+        if (len > 0.0f) {
+            position /= len;
+        } else {
+            len = 1.0f;
+        }
+
+        packed[i][0] = glm::floatBitsToUint(len);
+        packed[i][1] = glm_packSnorm3x10_1x2(glm::vec4(position, 0.0f));
+        packed[i][2] = glm_packSnorm3x10_1x2(glm::vec4(normal, 0.0f));
+        packed[i][3] = glm_packSnorm3x10_1x2(glm::vec4(tangent, 0.0f));
+    }
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+//
+// Runtime CPU dispatch
+//
+#include <CPUDetect.h>
+
+void accumulateDenseBlendshapeBlocks_AVX2(const int32_t* indices, const float* blocks, int numBlocks,
+                                          float positionCoefficient, float normalCoefficient, float* offsets, int stride);
+void accumulateSparseBlendshapeBlocks_AVX2(const int32_t* indices, const float* blocks, int numBlocks,
+                                           float positionCoefficient, float normalCoefficient, float* offsets, int stride);
+void packBlendshapeOffsetPlanes_AVX2(const float* offsets, int stride, uint32_t (*packed)[4], int numVertices);
+
+static void accumulateDenseBlocks(const int32_t* indices, const float* blocks, int numBlocks,
+                                  float positionCoefficient, float normalCoefficient, float* offsets, int stride) {
+    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+    if (_cpuSupportsAVX2) {
+        accumulateDenseBlendshapeBlocks_AVX2(indices, blocks, numBlocks, positionCoefficient, normalCoefficient, offsets, stride);
+    } else {
+        accumulateDenseBlocks_ref(indices, blocks, numBlocks, positionCoefficient, normalCoefficient, offsets, stride);
+    }
+}
+
+static void accumulateSparseBlocks(const int32_t* indices, const float* blocks, int numBlocks,
+                                   float positionCoefficient, float normalCoefficient, float* offsets, int stride) {
+    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+    if (_cpuSupportsAVX2) {
+        accumulateSparseBlendshapeBlocks_AVX2(indices, blocks, numBlocks, positionCoefficient, normalCoefficient, offsets, stride);
+    } else {
+        accumulateSparseBlocks_ref(indices, blocks, numBlocks, positionCoefficient, normalCoefficient, offsets, stride);
+    }
+}
+
+void packBlendshapeOffsets(const float* offsets, int stride, uint32_t (*packed)[4], int numVertices) {
+    static bool _cpuSupportsAVX2 = cpuSupportsAVX2();
+    if (_cpuSupportsAVX2) {
+        packBlendshapeOffsetPlanes_AVX2(offsets, stride, packed, numVertices);
+    } else {
+        packBlendshapeOffsets_ref(offsets, stride, packed, numVertices);
+    }
+}
+
+#else   // portable reference code
+
+static auto& accumulateDenseBlocks = accumulateDenseBlocks_ref;
+static auto& accumulateSparseBlocks = accumulateSparseBlocks_ref;
+
+void packBlendshapeOffsets(const float* offsets, int stride, uint32_t (*packed)[4], int numVertices) {
+    packBlendshapeOffsets_ref(offsets, stride, packed, numVertices);
+}
+
+#endif
+
+BakedBlendshapes::BakedBlendshapes(int numVertices) :
+    _numVertices(numVertices),
+    // a dense block may start at the last vertex and the padding lanes of sparse blocks point just past it
+    _stride((numVertices + 2 * BLOCK_SIZE - 1) & ~(BLOCK_SIZE - 1)) {
+}
+
+void BakedBlendshapes::addBlendshape(int numOffsets, const int* indices, const glm::vec3* positions, const glm::vec3* normals,
+                                     int numTangents, const glm::vec3* tangents) {
+    struct Offset {
+        int index;
+        float components[NUM_COMPONENTS];
+    };
+
+    std::vector<Offset> sorted;
+    sorted.reserve(numOffsets);
+    for (int j = 0; j < numOffsets; j++) {
+        if (indices[j] < 0 || indices[j] >= _numVertices) {
+            continue;
+        }
+        glm::vec3 tangent = j < numTangents ? tangents[j] : glm::vec3(0.0f);
+        sorted.push_back({ indices[j], { positions[j].x, positions[j].y, positions[j].z,
+                                         normals[j].x, normals[j].y, normals[j].z,
+                                         tangent.x, tangent.y, tangent.z } });
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Offset& a, const Offset& b) {
+        return a.index < b.index;
+    });
+
+    // merge repeated vertices, so that no two lanes of a sparse block ever point at the same one
+    std::vector<Offset> merged;
+    merged.reserve(sorted.size());
+    for (const auto& offset : sorted) {
+        if (!merged.empty() && merged.back().index == offset.index) {
+            for (int k = 0; k < NUM_COMPONENTS; k++) {
+                merged.back().components[k] += offset.components[k];
+            }
+        } else {
+            merged.push_back(offset);
+        }
+    }
+
+    Blendshape blendshape { getNumDenseBlocks(), 0, getNumSparseBlocks(), 0 };
+    std::vector<const Offset*> scattered;
+    size_t i = 0;
+    while (i < merged.size()) {
+        int firstIndex = merged[i].index;
+        size_t end = i;
+        while (end < merged.size() && merged[end].index < firstIndex + BLOCK_SIZE) {
+            end++;
+        }
+        if ((int)(end - i) >= MIN_DENSE_BLOCK_FILL) {
+            size_t base = _denseOffsets.size();
+            _denseIndices.push_back(firstIndex);
+            _denseOffsets.resize(base + BLOCK_FLOATS, 0.0f);
+            for (; i < end; i++) {
+                int lane = merged[i].index - firstIndex;
+                for (int k = 0; k < NUM_COMPONENTS; k++) {
+                    _denseOffsets[base + k * BLOCK_SIZE + lane] = merged[i].components[k];
+                }
+            }
+            blendshape.numDenseBlocks++;
+        } else {
+            scattered.push_back(&merged[i]);
+            i++;
+        }
+    }
+
+    for (size_t first = 0; first < scattered.size(); first += BLOCK_SIZE) {
+        size_t base = _sparseOffsets.size();
+        _sparseOffsets.resize(base + BLOCK_FLOATS, 0.0f);
+        for (int lane = 0; lane < BLOCK_SIZE; lane++) {
+            if (first + lane < scattered.size()) {
+                const Offset& offset = *scattered[first + lane];
+                _sparseIndices.push_back(offset.index);
+                for (int k = 0; k < NUM_COMPONENTS; k++) {
+                    _sparseOffsets[base + k * BLOCK_SIZE + lane] = offset.components[k];
+                }
+            } else {
+                // padding lanes add nothing, past the end of the mesh
+                _sparseIndices.push_back(_numVertices);
+            }
+        }
+        blendshape.numSparseBlocks++;
+    }
+
+    _blendshapes.push_back(blendshape);
+}
+
+int BakedBlendshapes::accumulate(const float* coefficients, int numCoefficients, float normalCoefficientScale, float* offsets) const {
+    memset(offsets, 0, NUM_COMPONENTS * _stride * sizeof(float));
+
+    int numApplied = 0;
+    for (int i = 0, n = std::min(numCoefficients, getNumBlendshapes()); i < n; i++) {
+        float positionCoefficient = coefficients[i];
+        if (positionCoefficient < MIN_COEFFICIENT) {
+            continue;
+        }
+        float normalCoefficient = positionCoefficient * normalCoefficientScale;
+
+        const Blendshape& blendshape = _blendshapes[i];
+        if (blendshape.numDenseBlocks > 0) {
+            accumulateDenseBlocks(_denseIndices.data() + blendshape.firstDenseBlock,
+                                  _denseOffsets.data() + blendshape.firstDenseBlock * BLOCK_FLOATS, blendshape.numDenseBlocks,
+                                  positionCoefficient, normalCoefficient, offsets, _stride);
+        }
+        if (blendshape.numSparseBlocks > 0) {
+            accumulateSparseBlocks(_sparseIndices.data() + blendshape.firstSparseBlock * BLOCK_SIZE,
+                                   _sparseOffsets.data() + blendshape.firstSparseBlock * BLOCK_FLOATS, blendshape.numSparseBlocks,
+                                   positionCoefficient, normalCoefficient, offsets, _stride);
+        }
+        numApplied++;
+    }
+    return numApplied;
+}
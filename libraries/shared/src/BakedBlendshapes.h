@@ -0,0 +1,75 @@
+//
+//  BakedBlendshapes.h
+//  libraries/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakedBlendshapes_h
+#define hifi_BakedBlendshapes_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// The blendshapes of one mesh, baked for fast accumulation.
+//
+// Each blendshape is split into blocks of BLOCK_SIZE vertices stored as structure of arrays.  Dense blocks cover
+// a run of consecutive vertices, mostly touched by the blendshape, and are accumulated with plain vector loads and
+// stores.  The scattered remainder goes into sparse blocks that carry a vertex index per lane.
+//
+// The accumulated offsets are planar: position xyz, normal xyz and tangent xyz, each getStride() floats long.
+class BakedBlendshapes {
+public:
+    static const int BLOCK_SIZE = 8;
+    static const int NUM_COMPONENTS = 9;
+
+    // blendshapes with a smaller coefficient are skipped
+    static const float MIN_COEFFICIENT;
+
+    BakedBlendshapes(int numVertices = 0);
+
+    // Bakes the next blendshape.  Missing tangents count as zero, indices outside the mesh are ignored.
+    void addBlendshape(int numOffsets, const int* indices, const glm::vec3* positions, const glm::vec3* normals,
+                       int numTangents, const glm::vec3* tangents);
+
+    int getNumVertices() const { return _numVertices; }
+    int getNumBlendshapes() const { return (int)_blendshapes.size(); }
+    int getNumDenseBlocks() const { return (int)_denseIndices.size(); }
+    int getNumSparseBlocks() const { return (int)_sparseIndices.size() / BLOCK_SIZE; }
+
+    // Length of each plane of accumulated offsets, the vertices plus room for the kernels to run over the end
+    int getStride() const { return _stride; }
+
+    // Overwrites offsets, NUM_COMPONENTS * getStride() floats, with the sum of the blendshapes weighted by their
+    // coefficients, the normals and tangents additionally by normalCoefficientScale.  Returns the number of
+    // blendshapes that contributed.
+    int accumulate(const float* coefficients, int numCoefficients, float normalCoefficientScale, float* offsets) const;
+
+private:
+    struct Blendshape {
+        int firstDenseBlock;
+        int numDenseBlocks;
+        int firstSparseBlock;
+        int numSparseBlocks;
+    };
+
+    int _numVertices { 0 };
+    int _stride { 0 };
+    std::vector<Blendshape> _blendshapes;
+
+    std::vector<int32_t> _denseIndices;     // first vertex of each dense block
+    std::vector<float> _denseOffsets;       // NUM_COMPONENTS planes of BLOCK_SIZE floats per block
+    std::vector<int32_t> _sparseIndices;    // BLOCK_SIZE vertices per block
+    std::vector<float> _sparseOffsets;      // NUM_COMPONENTS planes of BLOCK_SIZE floats per block
+};
+
+// Packs planar offsets, as accumulated by BakedBlendshapes, for the gpu: the position as its largest component and
+// a 3xSN10 direction, the normal and tangent as 3xSN10.
+void packBlendshapeOffsets(const float* offsets, int stride, uint32_t (*packed)[4], int numVertices);
+
+#endif // hifi_BakedBlendshapes_h
@@ -12,6 +12,8 @@
 
 #include "LogHandler.h"
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 
 #ifdef Q_OS_WIN
@@ -21,17 +23,86 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtCore/QDebug>
-#include <QtCore/QMutexLocker>
+#include <QtCore/QHash>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
 
-QMutex LogHandler::_mutex(QMutex::Recursive);
+#include "SharedUtil.h"
+
+std::mutex LogHandler::_mutex;
+
+static const int WRITER_IDLE_MSECS = 100;
+
+// The queue of the messages of a thread: only that thread pushes, only the writer pops.
+class LogHandler::ThreadQueue {
+public:
+    static const uint32_t MASK = MAX_QUEUED_MESSAGES_PER_THREAD - 1;
+
+    class Entry {
+    public:
+        uint64_t sequenceNumber { 0 };
+        QString message;
+    };
+
+    bool push(uint64_t sequenceNumber, const QString& message) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= MAX_QUEUED_MESSAGES_PER_THREAD) {
+            return false;
+        }
+        Entry& entry = _entries[head & MASK];
+        entry.sequenceNumber = sequenceNumber;
+        entry.message = message;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // the writer's side
+    uint32_t getHead() const { return _head.load(std::memory_order_acquire); }
+    uint32_t getTail() const { return _tail.load(std::memory_order_relaxed); }
+    const Entry& front() const { return _entries[_tail.load(std::memory_order_relaxed) & MASK]; }
+    QString pop() {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        QString message;
+        // the queue does not keep what was written
+        message.swap(_entries[tail & MASK].message);
+        _tail.store(tail + 1, std::memory_order_release);
+        return message;
+    }
+    bool isEmpty() const { return getHead() == getTail(); }
+
+private:
+    std::atomic<uint32_t> _head { 0 };
+    char _padding[64]; // keeps the thread and the writer off each other's cache line
+    std::atomic<uint32_t> _tail { 0 };
+    std::array<Entry, MAX_QUEUED_MESSAGES_PER_THREAD> _entries;
+};
+
+class LogHandler::RepeatedMessageRecord {
+public:
+    std::atomic<int> repeatCount { 0 };
+    std::atomic_flag isWritingRepeatString = ATOMIC_FLAG_INIT;
+    QString repeatString;
+};
 
 LogHandler& LogHandler::getInstance() {
     static LogHandler staticInstance;
     return staticInstance;
 }
 
+LogHandler::~LogHandler() {
+    if (_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(_writerMutex);
+            _stopWriter = true;
+        }
+        _writerCondition.notify_one();
+        _writer.join();
+    }
+    for (auto& chunk : _repeatedMessageRecords) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
 const char* stringForLogType(LogMsgType msgType) {
     switch (msgType) {
         case LogInfo:
@@ -58,47 +129,58 @@ const QString DATE_STRING_FORMAT = "MM/dd hh:mm:ss";
 const QString DATE_STRING_FORMAT_WITH_MILLISECONDS = "MM/dd hh:mm:ss.zzz";
 
 void LogHandler::setTargetName(const QString& targetName) {
-    QMutexLocker lock(&_mutex);
+    std::lock_guard<std::mutex> guard(_mutex);
     _targetName = targetName;
+    ++_targetNameVersion;
 }
 
 void LogHandler::setShouldOutputProcessID(bool shouldOutputProcessID) {
-    QMutexLocker lock(&_mutex);
     _shouldOutputProcessID = shouldOutputProcessID;
 }
 
 void LogHandler::setShouldOutputThreadID(bool shouldOutputThreadID) {
-    QMutexLocker lock(&_mutex);
     _shouldOutputThreadID = shouldOutputThreadID;
 }
 
 void LogHandler::setShouldDisplayMilliseconds(bool shouldDisplayMilliseconds) {
-    QMutexLocker lock(&_mutex);
     _shouldDisplayMilliseconds = shouldDisplayMilliseconds;
 }
 
+void LogHandler::setOutputFile(FILE* outputFile) {
+    flush();
+    _outputFile = outputFile;
+}
 
 void LogHandler::flushRepeatedMessages() {
-    QMutexLocker lock(&_mutex);
-
     // New repeat-suppress scheme:
-    for (int m = 0; m < (int)_repeatedMessageRecords.size(); ++m) {
-        int repeatCount = _repeatedMessageRecords[m].repeatCount;
-        if (repeatCount > 1) {
-            QString repeatLogMessage = QString().setNum(repeatCount) + " repeated log entries - Last entry: \"" 
-                    + _repeatedMessageRecords[m].repeatString + "\"";
-            printMessage(LogSuppressed, QMessageLogContext(), repeatLogMessage);
-            _repeatedMessageRecords[m].repeatCount = 0;
-            _repeatedMessageRecords[m].repeatString = QString();
+    int numMessageIDs = _currentMessageID.load(std::memory_order_acquire);
+    for (int m = 0; m < numMessageIDs; ++m) {
+        RepeatedMessageRecord* record = getRepeatedMessageRecord(m);
+        if (!record || record->repeatCount.load(std::memory_order_relaxed) <= 1) {
+            continue;
         }
+        int repeatCount = record->repeatCount.exchange(0, std::memory_order_relaxed);
+        while (record->isWritingRepeatString.test_and_set(std::memory_order_acquire)) {
+        }
+        QString repeatString;
+        repeatString.swap(record->repeatString);
+        record->isWritingRepeatString.clear(std::memory_order_release);
+
+        QString repeatLogMessage = QString().setNum(repeatCount) + " repeated log entries - Last entry: \""
+                + repeatString + "\"";
+        printMessage(LogSuppressed, QMessageLogContext(), repeatLogMessage);
     }
 }
 
-QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
-    if (message.isEmpty()) {
-        return QString();
+QString LogHandler::formatMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
+    // the target name of this thread, as it was last set
+    thread_local int targetNameVersion = -1;
+    thread_local QString targetName;
+    if (targetNameVersion != _targetNameVersion.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        targetName = _targetName;
+        targetNameVersion = _targetNameVersion;
     }
-    QMutexLocker lock(&_mutex);
 
     // log prefix is in the following format
     // [TIMESTAMP] [DEBUG] [PID] [TID] [TARGET] logged string
@@ -120,8 +202,8 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
         prefixString.append(QString(" [%1]").arg(threadID));
     }
 
-    if (!_targetName.isEmpty()) {
-        prefixString.append(QString(" [%1]").arg(_targetName));
+    if (!targetName.isEmpty()) {
+        prefixString.append(QString(" [%1]").arg(targetName));
     }
 
     // for [qml] console.* messages include an abbreviated source filename
@@ -131,14 +213,234 @@ QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& cont
         }
     }
 
-    QString logMessage = QString("%1 %2\n").arg(prefixString, message.split('\n').join('\n' + prefixString + " "));
+    return QString("%1 %2\n").arg(prefixString, message.split('\n').join('\n' + prefixString + " "));
+}
+
+// the script print() and qml console.* output, which all comes through a few lines of C++ whatever the script
+static bool isScriptCategory(const char* category) {
+    return category && (!strcmp(category, "hifi.scriptengine.script") || !strcmp(category, "qml"));
+}
+
+bool LogHandler::isRateLimited(const QMessageLogContext& context, const QString& message) {
+    // the file names and categories are literals, known by their address
+    size_t siteHash;
+    bool isScript = isScriptCategory(context.category);
+    if (context.file && !isScript) {
+        siteHash = std::hash<const void*>()(context.file) * 31 + (size_t)context.line;
+    } else {
+        // built without QT_MESSAGELOGCONTEXT, or logged for a script whose name starts the message (or is the file of a
+        // qml message), so a site is known by the shape of its message, its numbers left out
+        siteHash = std::hash<const void*>()(context.category);
+        if (context.file) {
+            siteHash = siteHash * 31 + qHash(QByteArray::fromRawData(context.file, (int)strlen(context.file)));
+        }
+        bool inNumber = false;
+        for (const QChar& character : message) {
+            bool isDigit = character.isDigit();
+            if (!isDigit || !inNumber) {
+                siteHash = siteHash * 31 + (isDigit ? '#' : character.unicode());
+            }
+            inNumber = isDigit;
+        }
+    }
+    std::atomic<uint64_t>& siteMessageCount = _siteMessageCounts[siteHash & (NUM_RATE_LIMITED_SITES - 1)];
+
+    uint32_t second = (uint32_t)(usecTimestampNow() / USECS_PER_SECOND);
+    uint64_t value = siteMessageCount.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t count = (uint32_t)(value >> 32) == second ? (uint32_t)value : 0;
+        if (count >= MAX_MESSAGES_PER_SECOND_PER_SITE) {
+            return true;
+        }
+        uint64_t newValue = ((uint64_t)second << 32) | (count + 1);
+        if (siteMessageCount.compare_exchange_weak(value, newValue, std::memory_order_relaxed)) {
+            return false;
+        }
+    }
+}
+
+QString LogHandler::printMessage(LogMsgType type, const QMessageLogContext& context, const QString& message) {
+    if (message.isEmpty()) {
+        return QString();
+    }
+
+    // what goes wrong last, and the reports of what was suppressed, are never dropped
+    if (type != LogFatal && type != LogSuppressed && isRateLimited(context, message)) {
+        _numDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return QString();
+    }
+
+    QString logMessage = formatMessage(type, context, message);
+    if (!queueMessage(logMessage)) {
+        return QString();
+    }
+    if (type == LogFatal) {
+        // Qt aborts once this returns
+        flush();
+    }
+    return logMessage;
+}
+
+LogHandler::ThreadQueue& LogHandler::getThreadQueue() {
+    // the queue outlives its thread until the writer drained it
+    thread_local std::shared_ptr<ThreadQueue> threadQueue;
+    if (!threadQueue) {
+        threadQueue = std::make_shared<ThreadQueue>();
+        std::lock_guard<std::mutex> guard(_mutex);
+        _threadQueues.push_back(threadQueue);
+        ++_threadQueuesVersion;
+    }
+    return *threadQueue;
+}
+
+bool LogHandler::queueMessage(const QString& logMessage) {
+    if (_isWriterStopped.load(std::memory_order_acquire)) {
+        // logged on the way out, after the writer
+        writeMessage(_outputFile, logMessage);
+        fflush(_outputFile);
+        return true;
+    }
+
+    std::call_once(_writerStarted, [this] {
+        std::lock_guard<std::mutex> guard(_writerMutex);
+        _writer = std::thread([this] { runWriter(); });
+    });
+
+    uint64_t sequenceNumber = _nextSequenceNumber.fetch_add(1, std::memory_order_relaxed);
+    if (!getThreadQueue().push(sequenceNumber, logMessage)) {
+        _numDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // the writer either sees the message before it waits, or is seen waiting here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_isWriterWaiting.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> guard(_writerMutex);
+        _writerCondition.notify_one();
+    }
+    return true;
+}
 
-    fprintf(stdout, "%s", qPrintable(logMessage));
+void LogHandler::writeMessage(FILE* outputFile, const QString& logMessage) {
+    QByteArray localMessage = logMessage.toLocal8Bit();
+    fwrite(localMessage.constData(), 1, localMessage.size(), outputFile);
 #ifdef Q_OS_WIN
     // On windows, this will output log lines into the Visual Studio "output" tab
-    OutputDebugStringA(qPrintable(logMessage));
+    OutputDebugStringA(localMessage.constData());
 #endif
-    return logMessage;
+}
+
+void LogHandler::runWriter() {
+    std::vector<std::shared_ptr<ThreadQueue>> threadQueues;
+    std::vector<uint32_t> passHeads;
+    int threadQueuesVersion = -1;
+    uint64_t numReportedDrops = 0;
+
+    auto hasQueuedMessages = [&] {
+        if (threadQueuesVersion != _threadQueuesVersion.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        return std::any_of(threadQueues.begin(), threadQueues.end(), [](const std::shared_ptr<ThreadQueue>& threadQueue) {
+            return !threadQueue->isEmpty();
+        });
+    };
+
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (true) {
+        bool stopping = _stopWriter;
+        lock.unlock();
+
+        if (threadQueuesVersion != _threadQueuesVersion.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> guard(_mutex);
+            // forget the queues of the threads that ended, once they are drained
+            threadQueues.clear();
+            _threadQueues.erase(std::remove_if(_threadQueues.begin(), _threadQueues.end(),
+                [](const std::shared_ptr<ThreadQueue>& threadQueue) {
+                    return threadQueue.use_count() == 1 && threadQueue->isEmpty();
+                }), _threadQueues.end());
+            threadQueues = _threadQueues;
+            threadQueuesVersion = _threadQueuesVersion;
+        }
+
+        // writes what was queued when the pass started, in the order it was logged in
+        FILE* outputFile = _outputFile;
+        passHeads.resize(threadQueues.size());
+        for (size_t i = 0; i < threadQueues.size(); ++i) {
+            passHeads[i] = threadQueues[i]->getHead();
+        }
+        int numWritten = 0;
+        while (true) {
+            ThreadQueue* nextQueue = nullptr;
+            uint64_t nextSequenceNumber = 0;
+            for (size_t i = 0; i < threadQueues.size(); ++i) {
+                ThreadQueue* threadQueue = threadQueues[i].get();
+                if (threadQueue->getTail() != passHeads[i]) {
+                    uint64_t sequenceNumber = threadQueue->front().sequenceNumber;
+                    if (!nextQueue || sequenceNumber < nextSequenceNumber) {
+                        nextQueue = threadQueue;
+                        nextSequenceNumber = sequenceNumber;
+                    }
+                }
+            }
+            if (!nextQueue) {
+                break;
+            }
+            writeMessage(outputFile, nextQueue->pop());
+            ++numWritten;
+        }
+
+        uint64_t numDroppedMessages = _numDroppedMessages.load(std::memory_order_relaxed);
+        if (numDroppedMessages != numReportedDrops) {
+            QString dropsMessage = QString::number(numDroppedMessages - numReportedDrops)
+                + " log entries were dropped, over the rate of their call site or past full queues";
+            writeMessage(outputFile, formatMessage(LogSuppressed, QMessageLogContext(), dropsMessage));
+            numReportedDrops = numDroppedMessages;
+            ++numWritten;
+        }
+        if (numWritten > 0) {
+            fflush(outputFile);
+        }
+
+        lock.lock();
+        ++_numWriterPasses;
+        _writtenCondition.notify_all();
+        if (stopping) {
+            break;
+        }
+        if (numWritten == 0) {
+            _isWriterWaiting = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            _writerCondition.wait_for(lock, std::chrono::milliseconds(WRITER_IDLE_MSECS), [&] {
+                return _stopWriter || _flushedWriterPass > _numWriterPasses || hasQueuedMessages();
+            });
+            _isWriterWaiting = false;
+        }
+    }
+
+    // what is logged from now on is written right away
+    _isWriterStopped = true;
+    lock.unlock();
+    std::lock_guard<std::mutex> guard(_mutex);
+    for (auto& threadQueue : _threadQueues) {
+        while (!threadQueue->isEmpty()) {
+            writeMessage(_outputFile, threadQueue->pop());
+        }
+    }
+    fflush(_outputFile);
+}
+
+void LogHandler::flush() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    if (!_writer.joinable() || _isWriterStopped) {
+        return;
+    }
+    // the pass that started after this call
+    uint64_t flushedWriterPass = _numWriterPasses + 2;
+    _flushedWriterPass = std::max(_flushedWriterPass, flushedWriterPass);
+    _writerCondition.notify_one();
+    _writtenCondition.wait(lock, [&] {
+        return _numWriterPasses >= flushedWriterPass || _isWriterStopped;
+    });
 }
 
 void LogHandler::verboseMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message) {
@@ -155,27 +457,42 @@ void LogHandler::setupRepeatedMessageFlusher() {
     });
 }
 
+LogHandler::RepeatedMessageRecord* LogHandler::getRepeatedMessageRecord(int messageID) {
+    int chunkIndex = messageID / REPEATED_MESSAGES_PER_CHUNK;
+    if (chunkIndex >= MAX_REPEATED_MESSAGE_CHUNKS) {
+        return nullptr;
+    }
+    RepeatedMessageRecord* chunk = _repeatedMessageRecords[chunkIndex].load(std::memory_order_acquire);
+    return &chunk[messageID % REPEATED_MESSAGES_PER_CHUNK];
+}
+
 int LogHandler::newRepeatedMessageID() {
-    QMutexLocker lock(&_mutex);
-    int newMessageId = _currentMessageID;
-    ++_currentMessageID;
-    RepeatedMessageRecord newRecord { 0, QString() };
-    _repeatedMessageRecords.push_back(newRecord);
+    std::lock_guard<std::mutex> guard(_mutex);
+    int newMessageId = _currentMessageID.load(std::memory_order_relaxed);
+    int chunkIndex = newMessageId / REPEATED_MESSAGES_PER_CHUNK;
+    if (chunkIndex < MAX_REPEATED_MESSAGE_CHUNKS && !_repeatedMessageRecords[chunkIndex].load(std::memory_order_relaxed)) {
+        _repeatedMessageRecords[chunkIndex].store(new RepeatedMessageRecord[REPEATED_MESSAGES_PER_CHUNK],
+            std::memory_order_release);
+    }
+    _currentMessageID.store(newMessageId + 1, std::memory_order_release);
     return newMessageId;
 }
 
 void LogHandler::printRepeatedMessage(int messageID, LogMsgType type, const QMessageLogContext& context,
                                       const QString& message) {
-    QMutexLocker lock(&_mutex);
-    if (messageID >= _currentMessageID) {
+    if (messageID >= _currentMessageID.load(std::memory_order_acquire)) {
         return;
     }
 
-    if (_repeatedMessageRecords[messageID].repeatCount == 0) {
+    RepeatedMessageRecord* record = getRepeatedMessageRecord(messageID);
+    if (!record) {
+        // past the records, only rate limited
         printMessage(type, context, message);
-    } else {
-        _repeatedMessageRecords[messageID].repeatString = message;
+    } else if (record->repeatCount.fetch_add(1, std::memory_order_relaxed) == 0) {
+        printMessage(type, context, message);
+    } else if (!record->isWritingRepeatString.test_and_set(std::memory_order_acquire)) {
+        // the last entry another thread is not writing already
+        record->repeatString = message;
+        record->isWritingRepeatString.clear(std::memory_order_release);
     }
- 
-    ++_repeatedMessageRecords[messageID].repeatCount;
 }
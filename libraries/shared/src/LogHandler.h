@@ -16,7 +16,12 @@
 #include <QObject>
 #include <QString>
 #include <QRegExp>
-#include <QMutex>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <memory>
 
@@ -32,9 +37,19 @@ enum LogMsgType {
 };
 
 /// Handles custom message handling and sending of stats/logs to Logstash instance
+///
+/// Messages are formatted on the thread that logs them and queued for a writer thread, in a bounded queue of that
+/// thread, so that logging never waits on another thread nor on the output.  Each call site (the file and line of the
+/// message, or its category and the text of the message without its numbers when they are not known or the message
+/// was printed by a script, which it names) logs at most MAX_MESSAGES_PER_SECOND_PER_SITE, and the messages over that
+/// or past a full queue are dropped, counted and reported by the writer.
 class LogHandler : public QObject {
     Q_OBJECT
 public:
+    static const uint32_t MAX_QUEUED_MESSAGES_PER_THREAD = 1024; // a power of two
+    static const uint32_t MAX_MESSAGES_PER_SECOND_PER_SITE = 100;
+    static const int NUM_RATE_LIMITED_SITES = 1024; // a power of two, sites past that share their limits
+
     static LogHandler& getInstance();
 
     /// sets the target name to output via the verboseMessageHandler, called once before logging begins
@@ -45,6 +60,10 @@ public:
     void setShouldOutputThreadID(bool shouldOutputThreadID);
     void setShouldDisplayMilliseconds(bool shouldDisplayMilliseconds);
 
+    /// where the writer writes the messages, stdout by default
+    void setOutputFile(FILE* outputFile);
+
+    /// queues the message for the writer, returns it as it will be written, or an empty string if it was dropped
     QString printMessage(LogMsgType type, const QMessageLogContext& context, const QString &message);
 
     /// a qtMessageHandler that can be hooked up to a target that links to Qt
@@ -56,24 +75,63 @@ public:
 
     void setupRepeatedMessageFlusher();
 
+    /// prints how many times each repeated message was suppressed, every VERBOSE_LOG_INTERVAL_SECONDS once set up
+    void flushRepeatedMessages();
+
+    /// waits for the writer to write the messages queued so far
+    void flush();
+
+    uint64_t getNumDroppedMessages() const { return _numDroppedMessages.load(std::memory_order_relaxed); }
+
 private:
-    LogHandler() = default;
-    ~LogHandler() = default;
+    class ThreadQueue;
+    class RepeatedMessageRecord;
 
-    void flushRepeatedMessages();
+    static const int REPEATED_MESSAGES_PER_CHUNK = 256;
+    static const int MAX_REPEATED_MESSAGE_CHUNKS = 64;
 
-    QString _targetName;
-    bool _shouldOutputProcessID { false };
-    bool _shouldOutputThreadID { false };
-    bool _shouldDisplayMilliseconds { false };
-
-    int _currentMessageID { 0 };
-    struct RepeatedMessageRecord {
-        int repeatCount;
-        QString repeatString;
-    };
-    std::vector<RepeatedMessageRecord> _repeatedMessageRecords;
-    static QMutex _mutex;
+    LogHandler() = default;
+    ~LogHandler();
+
+    QString formatMessage(LogMsgType type, const QMessageLogContext& context, const QString& message);
+    bool isRateLimited(const QMessageLogContext& context, const QString& message);
+    bool queueMessage(const QString& logMessage);
+    ThreadQueue& getThreadQueue();
+    void runWriter();
+    void writeMessage(FILE* outputFile, const QString& logMessage);
+
+    RepeatedMessageRecord* getRepeatedMessageRecord(int messageID);
+
+    QString _targetName; // guarded by _mutex
+    std::atomic<int> _targetNameVersion { 0 };
+    std::atomic<bool> _shouldOutputProcessID { false };
+    std::atomic<bool> _shouldOutputThreadID { false };
+    std::atomic<bool> _shouldDisplayMilliseconds { false };
+    std::atomic<FILE*> _outputFile { stdout };
+
+    std::atomic<int> _currentMessageID { 0 };
+    std::array<std::atomic<RepeatedMessageRecord*>, MAX_REPEATED_MESSAGE_CHUNKS> _repeatedMessageRecords {};
+
+    // the second and the number of messages logged in it, by the hash of their site
+    std::array<std::atomic<uint64_t>, NUM_RATE_LIMITED_SITES> _siteMessageCounts {};
+    std::atomic<uint64_t> _nextSequenceNumber { 0 };
+    std::atomic<uint64_t> _numDroppedMessages { 0 };
+
+    std::vector<std::shared_ptr<ThreadQueue>> _threadQueues; // guarded by _mutex
+    std::atomic<int> _threadQueuesVersion { 0 };
+
+    std::once_flag _writerStarted;
+    std::thread _writer;
+    std::mutex _writerMutex;
+    std::condition_variable _writerCondition;
+    std::condition_variable _writtenCondition;
+    std::atomic<bool> _isWriterWaiting { false };
+    std::atomic<bool> _isWriterStopped { false };
+    bool _stopWriter { false }; // guarded by _writerMutex
+    uint64_t _numWriterPasses { 0 }; // guarded by _writerMutex
+    uint64_t _flushedWriterPass { 0 }; // guarded by _writerMutex
+
+    static std::mutex _mutex;
 };
 
 #define HIFI_FCDEBUG(category, message) \
@@ -0,0 +1,361 @@
+//
+//  Metrics.cpp
+//  libraries/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+
+using namespace metrics;
+
+static const quint8 SNAPSHOT_VERSION = 1;
+
+void Gauge::add(double delta) {
+    double value = _value.load(std::memory_order_relaxed);
+    while (!_value.compare_exchange_weak(value, value + delta, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t Histogram::bucketLowerBound(int index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int shift = (index - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+    uint64_t subBucket = (uint64_t)((index - 2 * SUB_BUCKETS) % SUB_BUCKETS);
+    return (SUB_BUCKETS + subBucket) << shift;
+}
+
+uint64_t Histogram::bucketUpperBound(int index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int shift = (index - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+    uint64_t subBucket = (uint64_t)((index - 2 * SUB_BUCKETS) % SUB_BUCKETS);
+    // wraps to the largest value for the last bucket
+    return ((SUB_BUCKETS + subBucket + 1) << shift) - 1;
+}
+
+uint64_t Snapshot::Metric::getHistogramCount() const {
+    uint64_t total = 0;
+    for (auto& bucket : buckets) {
+        total += bucket.second;
+    }
+    return total;
+}
+
+uint64_t Snapshot::Metric::getQuantile(double quantile) const {
+    uint64_t total = getHistogramCount();
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max((uint64_t)1, (uint64_t)std::ceil(quantile * (double)total));
+    uint64_t seen = 0;
+    for (auto& bucket : buckets) {
+        seen += bucket.second;
+        if (seen >= rank) {
+            uint64_t lower = Histogram::bucketLowerBound(bucket.first);
+            uint64_t upper = Histogram::bucketUpperBound(bucket.first);
+            return lower + (upper - lower) / 2;
+        }
+    }
+    return Histogram::bucketUpperBound(buckets.back().first);
+}
+
+void Snapshot::Metric::merge(const Metric& other) {
+    count += other.count;
+    value += other.value;
+    sum += other.sum;
+
+    std::vector<std::pair<uint16_t, uint64_t>> merged;
+    merged.reserve(buckets.size() + other.buckets.size());
+    auto it = buckets.begin();
+    auto otherIt = other.buckets.begin();
+    while (it != buckets.end() || otherIt != other.buckets.end()) {
+        if (otherIt == other.buckets.end() || (it != buckets.end() && it->first < otherIt->first)) {
+            merged.push_back(*it++);
+        } else if (it == buckets.end() || otherIt->first < it->first) {
+            merged.push_back(*otherIt++);
+        } else {
+            merged.emplace_back(it->first, it->second + otherIt->second);
+            ++it;
+            ++otherIt;
+        }
+    }
+    buckets.swap(merged);
+}
+
+const Snapshot::Metric* Snapshot::find(const QString& name) const {
+    for (auto& metric : metrics) {
+        if (metric.name == name) {
+            return &metric;
+        }
+    }
+    return nullptr;
+}
+
+QByteArray Snapshot::toByteArray() const {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << SNAPSHOT_VERSION << (quint32)metrics.size();
+    for (auto& metric : metrics) {
+        stream << (quint8)metric.type << metric.name << metric.help;
+        switch (metric.type) {
+            case Type::Counter:
+                stream << (quint64)metric.count;
+                break;
+            case Type::Gauge:
+                stream << metric.value;
+                break;
+            case Type::Histogram:
+                stream << (quint64)metric.sum << (quint32)metric.buckets.size();
+                for (auto& bucket : metric.buckets) {
+                    stream << (quint16)bucket.first << (quint64)bucket.second;
+                }
+                break;
+        }
+    }
+    return data;
+}
+
+bool Snapshot::fromByteArray(const QByteArray& data) {
+    metrics.clear();
+
+    QDataStream stream(data);
+    quint8 version;
+    quint32 numMetrics;
+    stream >> version >> numMetrics;
+    if (stream.status() != QDataStream::Ok || version != SNAPSHOT_VERSION) {
+        return false;
+    }
+
+    for (quint32 i = 0; i < numMetrics && stream.status() == QDataStream::Ok; ++i) {
+        Metric metric;
+        quint8 type;
+        stream >> type >> metric.name >> metric.help;
+        if (type > (quint8)Type::Histogram) {
+            return false;
+        }
+        metric.type = (Type)type;
+        switch (metric.type) {
+            case Type::Counter: {
+                quint64 count;
+                stream >> count;
+                metric.count = count;
+                break;
+            }
+            case Type::Gauge:
+                stream >> metric.value;
+                break;
+            case Type::Histogram: {
+                quint64 sum;
+                quint32 numBuckets;
+                stream >> sum >> numBuckets;
+                metric.sum = sum;
+                if (numBuckets > (quint32)Histogram::NUM_BUCKETS) {
+                    return false;
+                }
+                metric.buckets.reserve(numBuckets);
+                for (quint32 j = 0; j < numBuckets; ++j) {
+                    quint16 index;
+                    quint64 bucketCount;
+                    stream >> index >> bucketCount;
+                    if (index >= Histogram::NUM_BUCKETS || (!metric.buckets.empty() && index <= metric.buckets.back().first)) {
+                        return false;
+                    }
+                    metric.buckets.emplace_back(index, bucketCount);
+                }
+                break;
+            }
+        }
+        metrics.push_back(std::move(metric));
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+QByteArray metrics::escapeLabelValue(const QString& value) {
+    QByteArray escaped = value.toUtf8();
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    escaped.replace('\n', "\\n");
+    return escaped;
+}
+
+static void writeSample(QByteArray& out, const QByteArray& name, const QByteArray& labels, const QByteArray& value) {
+    out += name;
+    if (!labels.isEmpty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+QByteArray metrics::toPrometheusText(const std::vector<LabeledSnapshot>& snapshots) {
+    static const double QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+
+    // the metrics in the order they are first seen, with where they are in each snapshot
+    std::vector<QString> names;
+    QHash<QString, std::vector<const Snapshot::Metric*>> metricsByName;
+    for (size_t i = 0; i < snapshots.size(); ++i) {
+        for (auto& metric : snapshots[i].second.metrics) {
+            auto& bySnapshot = metricsByName[metric.name];
+            if (bySnapshot.empty()) {
+                names.push_back(metric.name);
+                bySnapshot.resize(snapshots.size(), nullptr);
+            }
+            bySnapshot[i] = &metric;
+        }
+    }
+
+    QByteArray out;
+    for (auto& name : names) {
+        auto& bySnapshot = metricsByName[name];
+        const Snapshot::Metric* first = nullptr;
+        for (auto metric : bySnapshot) {
+            if (metric) {
+                first = metric;
+                break;
+            }
+        }
+
+        QByteArray utf8Name = name.toUtf8();
+        out += "# HELP " + utf8Name + ' ' + first->help.toUtf8().replace('\n', "\\n") + '\n';
+        switch (first->type) {
+            case Type::Counter:
+                out += "# TYPE " + utf8Name + " counter\n";
+                break;
+            case Type::Gauge:
+                out += "# TYPE " + utf8Name + " gauge\n";
+                break;
+            case Type::Histogram:
+                out += "# TYPE " + utf8Name + " summary\n";
+                break;
+        }
+
+        for (size_t i = 0; i < snapshots.size(); ++i) {
+            auto metric = bySnapshot[i];
+            if (!metric || metric->type != first->type) {
+                continue;
+            }
+            const QByteArray& labels = snapshots[i].first;
+            switch (metric->type) {
+                case Type::Counter:
+                    writeSample(out, utf8Name, labels, QByteArray::number((qulonglong)metric->count));
+                    break;
+                case Type::Gauge:
+                    writeSample(out, utf8Name, labels, QByteArray::number(metric->value, 'g', 10));
+                    break;
+                case Type::Histogram: {
+                    for (double quantile : QUANTILES) {
+                        QByteArray quantileLabels = labels;
+                        if (!quantileLabels.isEmpty()) {
+                            quantileLabels += ',';
+                        }
+                        quantileLabels += "quantile=\"" + QByteArray::number(quantile) + '"';
+                        writeSample(out, utf8Name, quantileLabels, QByteArray::number((qulonglong)metric->getQuantile(quantile)));
+                    }
+                    writeSample(out, utf8Name + "_sum", labels, QByteArray::number((qulonglong)metric->sum));
+                    writeSample(out, utf8Name + "_count", labels, QByteArray::number((qulonglong)metric->getHistogramCount()));
+                    break;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::findOrAdd(Type type, const QString& name, const QString& help) {
+    Lock lock(_mutex);
+    auto it = _entriesByName.find(name);
+    if (it != _entriesByName.end()) {
+        if (it.value()->type == type) {
+            return *it.value();
+        }
+        qWarning() << "Metric" << name << "is already registered with another type, it will not be reported";
+    }
+
+    std::unique_ptr<Entry> entry(new Entry());
+    entry->type = type;
+    entry->name = name;
+    entry->help = help;
+    switch (type) {
+        case Type::Counter:
+            entry->counter.reset(new Counter());
+            break;
+        case Type::Gauge:
+            entry->gauge.reset(new Gauge());
+            break;
+        case Type::Histogram:
+            entry->histogram.reset(new Histogram());
+            break;
+    }
+
+    Entry& added = *entry;
+    if (it != _entriesByName.end()) {
+        _mismatchedEntries.push_back(std::move(entry));
+    } else {
+        _entriesByName.insert(name, entry.get());
+        _entries.push_back(std::move(entry));
+    }
+    return added;
+}
+
+Counter& MetricsRegistry::counter(const QString& name, const QString& help) {
+    return *findOrAdd(Type::Counter, name, help).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const QString& name, const QString& help) {
+    return *findOrAdd(Type::Gauge, name, help).gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const QString& name, const QString& help) {
+    return *findOrAdd(Type::Histogram, name, help).histogram;
+}
+
+Snapshot MetricsRegistry::snapshot() const {
+    Snapshot snapshot;
+    Lock lock(_mutex);
+    snapshot.metrics.resize(_entries.size());
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        const Entry& entry = *_entries[i];
+        Snapshot::Metric& metric = snapshot.metrics[i];
+        metric.type = entry.type;
+        metric.name = entry.name;
+        metric.help = entry.help;
+        switch (entry.type) {
+            case Type::Counter:
+                metric.count = entry.counter->get();
+                break;
+            case Type::Gauge:
+                metric.value = entry.gauge->get();
+                break;
+            case Type::Histogram:
+                metric.sum = entry.histogram->getSum();
+                for (int index = 0; index < Histogram::NUM_BUCKETS; ++index) {
+                    uint64_t bucketCount = entry.histogram->getBucketCount(index);
+                    if (bucketCount > 0) {
+                        metric.buckets.emplace_back((uint16_t)index, bucketCount);
+                    }
+                }
+                break;
+        }
+    }
+    return snapshot;
+}
+
+int MetricsRegistry::getNumMetrics() const {
+    Lock lock(_mutex);
+    return (int)_entries.size();
+}
@@ -0,0 +1,188 @@
+//
+//  Metrics.h
+//  libraries/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_Metrics_h
+#define hifi_Metrics_h
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include "DependencyManager.h"
+
+// Typed metrics of a server: counters, gauges and latency histograms.
+//
+// Metrics are registered once, by name, and the references kept by the code recording them: recording is a relaxed
+// atomic operation, without locks nor allocations, so that it can be done from the hot loops of the mixers.  The
+// registry takes a Snapshot of every metric for a scrape, which is written in the Prometheus text format or sent to
+// the domain-server in a compact binary form.
+namespace metrics {
+
+enum class Type : uint8_t {
+    Counter = 0,
+    Gauge,
+    Histogram
+};
+
+// a count that only goes up, like the packets sent
+class Counter {
+public:
+    void increment(uint64_t count = 1) { _value.fetch_add(count, std::memory_order_relaxed); }
+    uint64_t get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> _value { 0 };
+};
+
+// a value that goes up and down, like the number of streams
+class Gauge {
+public:
+    void set(double value) { _value.store(value, std::memory_order_relaxed); }
+    void add(double delta);
+    double get() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> _value { 0.0 };
+};
+
+// A histogram of integer values (like durations in usecs) with log-linear buckets, as in an HDR histogram: values
+// below 2 * SUB_BUCKETS are counted exactly, and every power of two above is split in SUB_BUCKETS buckets, so that
+// any value is known to about 6% over the whole 64 bit range.
+class Histogram {
+public:
+    static const int SUB_BUCKET_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int NUM_BUCKETS = 2 * SUB_BUCKETS + (64 - SUB_BUCKET_BITS - 1) * SUB_BUCKETS;
+
+    static int bucketIndex(uint64_t value) {
+        if (value < 2 * SUB_BUCKETS) {
+            return (int)value;
+        }
+        int msb = findMSB(value);
+        int shift = msb - SUB_BUCKET_BITS;
+        return 2 * SUB_BUCKETS + (msb - SUB_BUCKET_BITS - 1) * SUB_BUCKETS + (int)(value >> shift) - SUB_BUCKETS;
+    }
+
+    // the smallest value counted in the bucket
+    static uint64_t bucketLowerBound(int index);
+    // the largest value counted in the bucket
+    static uint64_t bucketUpperBound(int index);
+
+    void record(uint64_t value) {
+        _buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t getSum() const { return _sum.load(std::memory_order_relaxed); }
+    uint64_t getBucketCount(int index) const { return _buckets[index].load(std::memory_order_relaxed); }
+
+private:
+    static int findMSB(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return (int)index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    std::atomic<uint64_t> _sum { 0 };
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> _buckets {};
+};
+
+// The values of the metrics of a registry at some point in time.
+class Snapshot {
+public:
+    class Metric {
+    public:
+        Type type { Type::Counter };
+        QString name;
+        QString help;
+        uint64_t count { 0 }; // counters
+        double value { 0.0 }; // gauges
+        uint64_t sum { 0 }; // histograms
+        std::vector<std::pair<uint16_t, uint64_t>> buckets; // histograms: the non empty buckets, by index
+
+        uint64_t getHistogramCount() const;
+
+        // the value at quantile (0..1) of a histogram, as the middle of the bucket it falls in
+        uint64_t getQuantile(double quantile) const;
+
+        // adds the values of another snapshot of the same metric, to aggregate the metrics of several servers
+        void merge(const Metric& other);
+    };
+
+    std::vector<Metric> metrics;
+
+    const Metric* find(const QString& name) const;
+
+    QByteArray toByteArray() const;
+    // returns false if the data is not a whole snapshot
+    bool fromByteArray(const QByteArray& data);
+};
+
+// a snapshot with the labels of the server it came from, like `node_type="audio-mixer"`
+using LabeledSnapshot = std::pair<QByteArray, Snapshot>;
+
+// Writes snapshots in the Prometheus text exposition format, each metric with its HELP and TYPE once, followed by its
+// samples in every snapshot.  Histograms are written as summaries, with their 0.5, 0.9, 0.99 and 0.999 quantiles.
+QByteArray toPrometheusText(const std::vector<LabeledSnapshot>& snapshots);
+
+QByteArray escapeLabelValue(const QString& value);
+
+}
+
+class MetricsRegistry : public Dependency {
+    SINGLETON_DEPENDENCY
+
+public:
+    // return the metric of that name, registering it the first time it is asked for
+    metrics::Counter& counter(const QString& name, const QString& help);
+    metrics::Gauge& gauge(const QString& name, const QString& help);
+    metrics::Histogram& histogram(const QString& name, const QString& help);
+
+    metrics::Snapshot snapshot() const;
+
+    int getNumMetrics() const;
+
+private:
+    class Entry {
+    public:
+        metrics::Type type;
+        QString name;
+        QString help;
+        std::unique_ptr<metrics::Counter> counter;
+        std::unique_ptr<metrics::Gauge> gauge;
+        std::unique_ptr<metrics::Histogram> histogram;
+    };
+
+    Entry& findOrAdd(metrics::Type type, const QString& name, const QString& help);
+
+    using Mutex = std::mutex;
+    using Lock = std::lock_guard<Mutex>;
+    mutable Mutex _mutex;
+    std::vector<std::unique_ptr<Entry>> _entries;
+    QHash<QString, Entry*> _entriesByName;
+    std::vector<std::unique_ptr<Entry>> _mismatchedEntries; // recorded to, but not part of snapshots
+};
+
+#endif // hifi_Metrics_h
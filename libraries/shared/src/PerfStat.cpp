@@ -11,12 +11,18 @@
 
 #include "PerfStat.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdio>
+#include <cstring>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <QDebug>
-#include <QThread>
+#include <QHash>
 
 #include "NumericalConstants.h"
 #include "SharedLogging.h"
@@ -81,30 +87,185 @@ void PerformanceTimerRecord::tallyResult(const quint64& now) {
 
 std::atomic<bool> PerformanceTimer::_isActive(false);
 std::mutex PerformanceTimer::_mutex;
-QHash<QThread*, QString> PerformanceTimer::_fullNames;
 QMap<QString, PerformanceTimerRecord> PerformanceTimer::_records;
 
+static const int SLOTS_PER_CHUNK = 256;
+static const int MAX_SLOT_CHUNKS = 64; // the paths past MAX_SLOT_CHUNKS * SLOTS_PER_CHUNK are not timed
+
+// guarded by PerformanceTimer::_mutex
+static QHash<QString, PerformanceTimer::NameID> nameIDs;
+static std::vector<QString> names;
+static QHash<quint64, int> pathIDs; // by the ID of the parent path and the name
+static std::vector<QString> pathNames { QString() }; // path 0 is the root, outside of any timer
+
+static quint64 getPathKey(int parentPathID, PerformanceTimer::NameID nameID) {
+    return ((quint64)parentPathID << 32) | (quint32)nameID;
+}
+
+class TimerSlot {
+public:
+    std::atomic<quint64> elapsed { 0 };
+    std::atomic<quint64> count { 0 };
+};
+
+// The time of the timers of a thread, by path.  The slots are only written by their thread, and read when merging.
+class PerformanceTimer::ThreadSlots {
+public:
+    ~ThreadSlots() {
+        for (auto& chunk : chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    // the slot of a path, allocated the first time the thread times it
+    TimerSlot* getSlot(int pathID) {
+        int chunkIndex = pathID / SLOTS_PER_CHUNK;
+        if (chunkIndex >= MAX_SLOT_CHUNKS) {
+            return nullptr;
+        }
+        TimerSlot* chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new TimerSlot[SLOTS_PER_CHUNK];
+            chunks[chunkIndex].store(chunk, std::memory_order_release);
+        }
+        return &chunk[pathID % SLOTS_PER_CHUNK];
+    }
+
+    std::array<std::atomic<TimerSlot*>, MAX_SLOT_CHUNKS> chunks {};
+
+    // only used by the thread
+    int currentPathID { 0 };
+    QHash<QByteArray, NameID> nameIDsByName;
+    std::unordered_map<quint64, int> pathIDsByKey;
+
+    // only used when merging: the elapsed time and count of each path merged so far
+    std::vector<std::pair<quint64, quint64>> merged;
+
+    // the slots of every thread that timed something, kept until they are merged after their thread finished
+    static std::vector<std::shared_ptr<ThreadSlots>> all; // guarded by PerformanceTimer::_mutex
+    static thread_local std::shared_ptr<ThreadSlots> current;
+};
+
+std::vector<std::shared_ptr<PerformanceTimer::ThreadSlots>> PerformanceTimer::ThreadSlots::all;
+thread_local std::shared_ptr<PerformanceTimer::ThreadSlots> PerformanceTimer::ThreadSlots::current;
+
+// static
+PerformanceTimer::ThreadSlots& PerformanceTimer::getThreadSlots() {
+    if (!ThreadSlots::current) {
+        ThreadSlots::current = std::make_shared<ThreadSlots>();
+        std::lock_guard<std::mutex> guard(_mutex);
+        ThreadSlots::all.push_back(ThreadSlots::current);
+    }
+    return *ThreadSlots::current;
+}
+
+// static
+PerformanceTimer::NameID PerformanceTimer::registerName(const QString& name) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto it = nameIDs.find(name);
+    if (it == nameIDs.end()) {
+        it = nameIDs.insert(name, (NameID)names.size());
+        names.push_back(name);
+    }
+    return it.value();
+}
+
+PerformanceTimer::PerformanceTimer(NameID nameID) {
+    if (_isActive) {
+        start(nameID);
+    }
+}
+
+PerformanceTimer::PerformanceTimer(const char* name) {
+    if (_isActive) {
+        // looked up by its characters, as the name may be a temporary whose buffer is later reused for another
+        ThreadSlots& threadSlots = getThreadSlots();
+        auto it = threadSlots.nameIDsByName.constFind(QByteArray::fromRawData(name, (int)strlen(name)));
+        if (it == threadSlots.nameIDsByName.constEnd()) {
+            it = threadSlots.nameIDsByName.insert(QByteArray(name), registerName(name));
+        }
+        start(it.value());
+    }
+}
+
 PerformanceTimer::PerformanceTimer(const QString& name) {
     if (_isActive) {
-        _name = name;
+        start(registerName(name));
+    }
+}
+
+void PerformanceTimer::start(NameID nameID) {
+    ThreadSlots& threadSlots = getThreadSlots();
+    _parentPathID = threadSlots.currentPathID;
+
+    quint64 pathKey = getPathKey(_parentPathID, nameID);
+    auto it = threadSlots.pathIDsByKey.find(pathKey);
+    if (it != threadSlots.pathIDsByKey.end()) {
+        _pathID = it->second;
+    } else {
         {
             std::lock_guard<std::mutex> guard(_mutex);
-            QString& fullName = _fullNames[QThread::currentThread()];
-            fullName.append("/");
-            fullName.append(_name);
+            auto pathIt = pathIDs.find(pathKey);
+            if (pathIt == pathIDs.end()) {
+                pathIt = pathIDs.insert(pathKey, (int)pathNames.size());
+                pathNames.push_back(pathNames[_parentPathID] + "/" + names[nameID]);
+            }
+            _pathID = pathIt.value();
         }
-        _start = usecTimestampNow();
+        threadSlots.pathIDsByKey.emplace(pathKey, _pathID);
     }
+
+    threadSlots.currentPathID = _pathID;
+    _start = usecTimestampNow();
 }
 
 PerformanceTimer::~PerformanceTimer() {
-    if (_isActive && _start != 0) {
-        quint64 elapsedUsec = (usecTimestampNow() - _start);
-        std::lock_guard<std::mutex> guard(_mutex);
-        QString& fullName = _fullNames[QThread::currentThread()];
-        PerformanceTimerRecord& namedRecord = _records[fullName];
-        namedRecord.accumulateResult(elapsedUsec);
-        fullName.resize(fullName.size() - (_name.size() + 1));
+    if (_start != 0) {
+        ThreadSlots& threadSlots = *ThreadSlots::current;
+        if (_isActive) {
+            quint64 elapsedUsec = (usecTimestampNow() - _start);
+            TimerSlot* slot = threadSlots.getSlot(_pathID);
+            if (slot) {
+                // only this thread writes to its slots: the count is stored last, so that the time merged with it is there
+                slot->elapsed.store(slot->elapsed.load(std::memory_order_relaxed) + elapsedUsec, std::memory_order_relaxed);
+                slot->count.store(slot->count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+        }
+        threadSlots.currentPathID = _parentPathID;
+    }
+}
+
+// static
+void PerformanceTimer::mergeThreadSlots() {
+    int numPaths = (int)pathNames.size();
+    auto threadIt = ThreadSlots::all.begin();
+    while (threadIt != ThreadSlots::all.end()) {
+        ThreadSlots& threadSlots = **threadIt;
+        threadSlots.merged.resize(numPaths);
+        for (int chunkIndex = 0; chunkIndex < MAX_SLOT_CHUNKS; ++chunkIndex) {
+            TimerSlot* chunk = threadSlots.chunks[chunkIndex].load(std::memory_order_acquire);
+            if (!chunk) {
+                continue;
+            }
+            int numChunkPaths = std::min(SLOTS_PER_CHUNK, numPaths - chunkIndex * SLOTS_PER_CHUNK);
+            for (int i = 0; i < numChunkPaths; ++i) {
+                int pathID = chunkIndex * SLOTS_PER_CHUNK + i;
+                auto& merged = threadSlots.merged[pathID];
+                quint64 count = chunk[i].count.load(std::memory_order_acquire);
+                if (count != merged.second) {
+                    quint64 elapsed = chunk[i].elapsed.load(std::memory_order_relaxed);
+                    _records[pathNames[pathID]].accumulateResults(elapsed - merged.first, count - merged.second);
+                    merged = { elapsed, count };
+                }
+            }
+        }
+
+        // the thread finished, and nothing else will be added to its slots
+        if (threadIt->use_count() == 1) {
+            threadIt = ThreadSlots::all.erase(threadIt);
+        } else {
+            ++threadIt;
+        }
     }
 }
 
@@ -115,8 +276,9 @@ bool PerformanceTimer::isActive() {
 
 // static
 QString PerformanceTimer::getContextName() {
+    int pathID = ThreadSlots::current ? ThreadSlots::current->currentPathID : 0;
     std::lock_guard<std::mutex> guard(_mutex);
-    return _fullNames[QThread::currentThread()];
+    return pathNames[pathID];
 }
 
 // static
@@ -132,7 +294,8 @@ void PerformanceTimer::setActive(bool active) {
         _isActive.store(active);
         if (!active) {
             std::lock_guard<std::mutex> guard(_mutex);
-            _fullNames.clear();
+            // what the threads timed so far is merged to be dropped
+            mergeThreadSlots();
             _records.clear();
         }
 
@@ -143,12 +306,14 @@ void PerformanceTimer::setActive(bool active) {
 // static
 QMap<QString, PerformanceTimerRecord> PerformanceTimer::getAllTimerRecords() {
     std::lock_guard<std::mutex> guard(_mutex);
+    mergeThreadSlots();
     return _records;
 };
 
 // static
 void PerformanceTimer::tallyAllTimerRecords() {
     std::lock_guard<std::mutex> guard(_mutex);
+    mergeThreadSlots();
     QMap<QString, PerformanceTimerRecord>::iterator recordsItr = _records.begin();
     QMap<QString, PerformanceTimerRecord>::const_iterator recordsEnd = _records.end();
     quint64 now = usecTimestampNow();
@@ -165,6 +330,7 @@ void PerformanceTimer::tallyAllTimerRecords() {
 
 void PerformanceTimer::dumpAllTimerRecords() {
     std::lock_guard<std::mutex> guard(_mutex);
+    mergeThreadSlots();
     QMapIterator<QString, PerformanceTimerRecord> i(_records);
     while (i.hasNext()) {
         i.next();
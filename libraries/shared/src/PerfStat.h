@@ -57,12 +57,14 @@ class PerformanceTimerRecord {
 public:
     PerformanceTimerRecord() : _runningTotal(0), _lastTotal(0), _numAccumulations(0), _numTallies(0), _expiry(0) {}
 
-    void accumulateResult(const quint64& elapsed) { _runningTotal += elapsed; ++_numAccumulations; }
+    void accumulateResult(const quint64& elapsed) { accumulateResults(elapsed, 1); }
+    void accumulateResults(quint64 elapsed, quint64 numResults) { _runningTotal += elapsed; _numAccumulations += numResults; }
     void tallyResult(const quint64& now);
     bool isStale(const quint64& now) const { return now > _expiry; }
     quint64 getAverage() const { return (_numTallies == 0) ? 0 : _runningTotal / _numTallies; }
     quint64 getMovingAverage() const { return (_numTallies == 0) ? 0 : _movingAverage.getAverage(); }
     quint64 getCount() const { return _numTallies; }
+    quint64 getNumAccumulations() const { return _numAccumulations; } // since the last tally
 
 private:
     quint64 _runningTotal;
@@ -73,9 +75,21 @@ private:
     SimpleMovingAverage _movingAverage;
 };
 
+// Times scopes by their name and the names of the timers they are nested in on their thread, like "/idle/update".
+//
+// The names are registered once and the nesting of the timers kept per thread, as the IDs of their paths.  A timer
+// adds its time to a slot of its thread, without locking, and the slots of every thread are merged into the records
+// when they are read or tallied.
 class PerformanceTimer {
 public:
+    using NameID = int;
+
+    // the ID of a name, to make the timers of that name without looking it up
+    static NameID registerName(const QString& name);
 
+    PerformanceTimer(NameID nameID);
+    // the name is registered once per thread, and then found without locking
+    PerformanceTimer(const char* name);
     PerformanceTimer(const QString& name);
     ~PerformanceTimer();
 
@@ -89,19 +103,31 @@ public:
     static void dumpAllTimerRecords();
 
 private:
+    class ThreadSlots;
+
+    // the slots of the current thread, added to those merged the first time
+    static ThreadSlots& getThreadSlots();
+
+    void start(NameID nameID);
+
+    // merges the time accumulated by every thread into the records, requires the mutex
+    static void mergeThreadSlots();
+
     quint64 _start = 0;
-    QString _name;
+    int _pathID = 0;
+    int _parentPathID = 0;
     static std::atomic<bool> _isActive;
 
-    static std::mutex _mutex;  // used to guard multi-threaded access to _fullNames and _records
-    static QHash<QThread*, QString> _fullNames;
+    static std::mutex _mutex;  // used to guard multi-threaded access to the names, paths, thread slots and _records
     static QMap<QString, PerformanceTimerRecord> _records;
 };
 
 // uncomment WANT_DETAILED_PERFORMANCE_TIMERS definition to enable performance timers in high-frequency contexts
 //#define WANT_DETAILED_PERFORMANCE_TIMERS
 #ifdef WANT_DETAILED_PERFORMANCE_TIMERS
-    #define DETAILED_PERFORMANCE_TIMER(name) PerformanceTimer detailedPerformanceTimer(name);
+    #define DETAILED_PERFORMANCE_TIMER(name) \
+        static const PerformanceTimer::NameID detailedPerformanceTimerNameID = PerformanceTimer::registerName(name); \
+        PerformanceTimer detailedPerformanceTimer(detailedPerformanceTimerNameID);
 #else // WANT_DETAILED_PERFORMANCE_TIMERS
     #define DETAILED_PERFORMANCE_TIMER(name) ; // no-op
 #endif // WANT_DETAILED_PERFORMANCE_TIMERS
@@ -45,7 +45,7 @@ static bool tracingEnabled() {
 
     // Cheers, love! The cavalry's here!
     auto tracer = DependencyManager::get<tracing::Tracer>();
-    return (tracer && tracer->isEnabled());
+    return (tracer && tracer->isRecording());
 }
 
 DurationBase::DurationBase(const QLoggingCategory& category, const QString& name) : _name(name), _category(category) {
@@ -0,0 +1,36 @@
+//
+//  SimulationBatcher.cpp
+//  libraries/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SimulationBatcher.h"
+
+#include <algorithm>
+
+#include "SharedUtil.h"
+
+size_t SimulationBatcher::simulate(size_t numItems, uint64_t expiry, const SimulateBatch& simulateBatch) {
+    size_t next = 0;
+    while (next < numItems) {
+        uint64_t now = usecTimestampNow();
+        if (now >= expiry) {
+            break;
+        }
+
+        float numExpectedToFit = (float)(expiry - now) / std::max(_cost, 1.0f);
+        size_t batchSize = (size_t)std::min(std::max(numExpectedToFit, (float)MIN_BATCH_SIZE), (float)MAX_BATCH_SIZE);
+        batchSize = std::min(batchSize, numItems - next);
+        simulateBatch(next, next + batchSize);
+        next += batchSize;
+
+        const float COST_TIMESCALE = 0.1f;
+        float batchCost = (float)(usecTimestampNow() - now) / (float)batchSize;
+        _cost += COST_TIMESCALE * (batchCost - _cost);
+    }
+    return next;
+}
@@ -0,0 +1,41 @@
+//
+//  SimulationBatcher.h
+//  libraries/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_SimulationBatcher_h
+#define hifi_SimulationBatcher_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/// Simulates a range of items, sorted by priority, a batch at a time until a time budget runs out.  Each batch is
+/// sized from the smoothed cost of an item to what is expected to fit in the rest of the budget: small batches keep
+/// the budget honest, large ones keep the worker threads busy for the parts of a batch that run concurrently.
+class SimulationBatcher {
+public:
+    static const size_t MIN_BATCH_SIZE = 4;
+    static const size_t MAX_BATCH_SIZE = 64;
+
+    /// simulates the items from begin up to end
+    using SimulateBatch = std::function<void(size_t begin, size_t end)>;
+
+    /// simulates the first of numItems in order, until they are done or expiry (in usecs) has passed
+    /// \return the number of items simulated
+    size_t simulate(size_t numItems, uint64_t expiry, const SimulateBatch& simulateBatch);
+
+    /// usecs per item, smoothed
+    float getCost() const { return _cost; }
+
+private:
+    float _cost { 100.0f };
+};
+
+#endif // hifi_SimulationBatcher_h
@@ -8,13 +8,17 @@
 
 #include "Trace.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 
 #include <QtCore/QDebug>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QThread>
 #include <QtCore/QFileInfo>
 #include <QtCore/QDir>
+#include <QtCore/QProcessEnvironment>
 #include <QtCore/QStandardPaths>
 
 #include <QtCore/QFile>
@@ -36,73 +40,506 @@
 
 using namespace tracing;
 
+namespace tracing {
+
+// The ring buffer of a thread: only that thread pushes, only the flusher drains, under the tracer's records lock.
+class TraceBuffer {
+public:
+    static const size_t MASK = Tracer::THREAD_BUFFER_SIZE - 1;
+    static const int MAX_CACHED_STRINGS = 4096;
+
+    TraceBuffer(int64_t id) : threadID(id), _records(new TraceRecord[Tracer::THREAD_BUFFER_SIZE]) {}
+
+    bool push(const TraceRecord& record) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= Tracer::THREAD_BUFFER_SIZE) {
+            return false;
+        }
+        _records[head & MASK] = record;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename F>
+    void drain(F f) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t head = _head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            f(_records[tail & MASK]);
+        }
+        _tail.store(tail, std::memory_order_release);
+    }
+
+    bool isEmpty() const { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire); }
+
+    const int64_t threadID;
+
+    // what this thread interned already, so that it rarely needs the tracer's strings lock
+    QHash<QString, uint32_t> stringIDs;
+    QHash<const QLoggingCategory*, uint32_t> categoryIDs;
+    uint32_t stringsGeneration { 0 }; // of the tracer's string table when they were cached
+
+private:
+    std::atomic<size_t> _head { 0 };
+    char _padding[64]; // keeps the thread and the flusher off each other's cache line
+    std::atomic<size_t> _tail { 0 };
+    std::unique_ptr<TraceRecord[]> _records;
+};
+
+}
+
+namespace {
+
+class ThreadBuffer {
+public:
+    std::shared_ptr<TraceBuffer> buffer;
+    uint32_t tracerSerial { 0 };
+};
+
+// the buffer outlives its thread until the tracer drained it
+thread_local ThreadBuffer threadBuffer;
+
+std::atomic<uint32_t> nextTracerSerial { 1 };
+
+const char BINARY_MAGIC[8] = "HFTRACE";
+const quint32 BINARY_VERSION = 1;
+
+void writeJsonString(QTextStream& out, const QString& string) {
+    out << '"';
+    for (const QChar& c : string) {
+        switch (c.unicode()) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (c.unicode() < 0x20) {
+                    out << QString("\\u%1").arg((int)c.unicode(), 4, 16, QLatin1Char('0'));
+                } else {
+                    out << c;
+                }
+                break;
+        }
+    }
+    out << '"';
+}
+
+void writeJsonNumber(QTextStream& out, double number) {
+    const double MAX_EXACT_INTEGER = 9007199254740992.0; // 2^53
+    if (number == std::floor(number) && std::abs(number) < MAX_EXACT_INTEGER) {
+        out << (qint64)number;
+    } else if (std::isfinite(number)) {
+        out << QString::number(number, 'g', 17);
+    } else {
+        out << "null";
+    }
+}
+
+void writeJsonArg(QTextStream& out, const TraceArg& arg, const std::vector<QString>& strings) {
+    writeJsonString(out, strings[arg.key]);
+    out << ':';
+    switch (arg.kind) {
+        case TraceArg::Number:
+            writeJsonNumber(out, arg.number);
+            break;
+        case TraceArg::Bool:
+            out << (arg.number != 0.0 ? "true" : "false");
+            break;
+        case TraceArg::String:
+            writeJsonString(out, strings[arg.string]);
+            break;
+    }
+}
+
+}
+
+const QString TraceData::BINARY_EXTENSION = ".hftrace";
+
+QByteArray TraceData::toJson() const {
+    QByteArray data;
+    QTextStream out(&data);
+    out.setCodec("UTF-8");
+    out << "[\n";
+    bool first = true;
+    for (const auto& record : records) {
+        if (first) {
+            first = false;
+        } else {
+            out << ",\n";
+        }
+        out << "{\"name\":";
+        writeJsonString(out, strings[record.name]);
+        out << ",\"cat\":";
+        writeJsonString(out, strings[record.category]);
+        out << ",\"ph\":\"" << QLatin1Char(record.type) << '"';
+        out << ",\"ts\":" << (qint64)record.timestamp;
+        out << ",\"pid\":" << processID;
+        out << ",\"tid\":" << (qint64)record.threadID;
+        if (record.id != 0) {
+            out << ",\"id\":";
+            writeJsonString(out, strings[record.id]);
+        }
+        bool hasArgs = false;
+        for (int i = 0; i < record.numArgs; ++i) {
+            const TraceArg& arg = record.args[i];
+            if (arg.isExtra) {
+                out << ',';
+                writeJsonArg(out, arg, strings);
+            } else {
+                out << (hasArgs ? "," : ",\"args\":{");
+                hasArgs = true;
+                writeJsonArg(out, arg, strings);
+            }
+        }
+        if (hasArgs) {
+            out << '}';
+        }
+        out << '}';
+    }
+    out << "\n]";
+    out.flush();
+    return data;
+}
+
+QByteArray TraceData::toBinary() const {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.writeRawData(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    out << BINARY_VERSION << processID;
+    out << (quint32)strings.size();
+    for (const auto& string : strings) {
+        out << string.toUtf8();
+    }
+    out << (quint32)records.size();
+    for (const auto& record : records) {
+        out << (qint64)record.timestamp << (qint64)record.threadID << record.name << record.id << record.category;
+        out << (quint8)record.type << record.numArgs;
+        for (int i = 0; i < record.numArgs; ++i) {
+            const TraceArg& arg = record.args[i];
+            out << arg.key << (quint8)arg.kind << (quint8)arg.isExtra;
+            if (arg.kind == TraceArg::String) {
+                out << arg.string;
+            } else {
+                out << arg.number;
+            }
+        }
+    }
+    return data;
+}
+
+bool TraceData::fromBinary(const QByteArray& binary) {
+    QDataStream in(binary);
+    char magic[sizeof(BINARY_MAGIC)];
+    quint32 version;
+    if (in.readRawData(magic, sizeof(magic)) != (int)sizeof(magic) || memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+    in >> version;
+    if (version != BINARY_VERSION) {
+        return false;
+    }
+    in >> processID;
+
+    quint32 numStrings;
+    in >> numStrings;
+    strings.clear();
+    for (quint32 i = 0; i < numStrings && in.status() == QDataStream::Ok; ++i) {
+        QByteArray string;
+        in >> string;
+        strings.push_back(QString::fromUtf8(string));
+    }
+
+    quint32 numRecords;
+    in >> numRecords;
+    records.clear();
+    auto isString = [&](uint32_t id) { return id < strings.size(); };
+    for (quint32 i = 0; i < numRecords && in.status() == QDataStream::Ok; ++i) {
+        TraceRecord record;
+        qint64 timestamp;
+        qint64 threadID;
+        quint8 type;
+        in >> timestamp >> threadID >> record.name >> record.id >> record.category >> type >> record.numArgs;
+        record.timestamp = timestamp;
+        record.threadID = threadID;
+        record.generation = 0;
+        record.type = (EventType)type;
+        if (record.numArgs > TraceRecord::MAX_ARGS || !isString(record.name) || !isString(record.id) ||
+            !isString(record.category)) {
+            return false;
+        }
+        for (int j = 0; j < record.numArgs; ++j) {
+            TraceArg& arg = record.args[j];
+            quint8 kind;
+            quint8 isExtra;
+            in >> arg.key >> kind >> isExtra;
+            arg.kind = (TraceArg::Kind)kind;
+            arg.isExtra = isExtra != 0;
+            if (arg.kind == TraceArg::String) {
+                in >> arg.string;
+                if (!isString(arg.string)) {
+                    return false;
+                }
+            } else if (arg.kind == TraceArg::Number || arg.kind == TraceArg::Bool) {
+                in >> arg.number;
+            } else {
+                return false;
+            }
+            if (!isString(arg.key)) {
+                return false;
+            }
+        }
+        records.push_back(record);
+    }
+    return in.status() == QDataStream::Ok && records.size() == numRecords;
+}
+
 bool tracing::enabled() {
     return DependencyManager::get<Tracer>()->isEnabled();
 }
 
+Tracer::Tracer() : _serial(nextTracerSerial++) {
+    // ID 0 is the empty string, for the events without an ID
+    _strings.push_back(QString());
+    _stringIDs.insert(QString(), 0);
+}
+
+Tracer::~Tracer() {
+    if (_flusher.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(_flusherMutex);
+            _stopFlusher = true;
+        }
+        _flusherCondition.notify_one();
+        _flusher.join();
+    }
+}
+
 void Tracer::startTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
+    start(false, 1.0f);
+}
+
+void Tracer::startSampling(float rate) {
+    start(true, rate);
+}
+
+void Tracer::startSamplingFromEnvironment() {
+    static const QString TRACE_SAMPLE_RATE_ENV = "HIFI_TRACE_SAMPLE_RATE";
+    bool ok;
+    float rate = QProcessEnvironment::systemEnvironment().value(TRACE_SAMPLE_RATE_ENV).toFloat(&ok);
+    if (ok && rate > 0.0f) {
+        qCDebug(shared) << "Sampling traces" << rate * 100.0f << "% of the time";
+        startSampling(rate);
+    }
+}
+
+void Tracer::finishSampling() {
+    static const QString TRACE_FILE_ENV = "HIFI_TRACE_FILE";
+    if (!_enabled || !_sampling) {
+        return;
+    }
+    stopTracing();
+
+    QString filename = QProcessEnvironment::systemEnvironment().value(TRACE_FILE_ENV);
+    if (filename.isEmpty()) {
+        filename = QString("traces/{DATE}_{TIME}_%1_%2%3").arg(QCoreApplication::applicationName())
+            .arg(QCoreApplication::applicationPid()).arg(TraceData::BINARY_EXTENSION);
+    }
+    serialize(filename);
+}
+
+void Tracer::start(bool sampling, float rate) {
     if (_enabled) {
         qWarning() << "Tried to enable tracer, but already enabled";
         return;
     }
 
-    _events.clear();
+    // drop what the threads still hold from before
+    flush();
+    {
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        _records.clear();
+    }
+
+    _sampling = sampling;
+    _sampleRate = rate;
     _enabled = true;
+    _recording = !sampling;
+
+    _stopFlusher = false;
+    _flusher = std::thread([this] { runFlusher(); });
 }
 
 void Tracer::stopTracing() {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
     if (!_enabled) {
         qWarning() << "Cannot stop tracing, already disabled";
         return;
     }
+    _recording = false;
     _enabled = false;
+
+    {
+        std::lock_guard<std::mutex> guard(_flusherMutex);
+        _stopFlusher = true;
+    }
+    _flusherCondition.notify_one();
+    _flusher.join();
+    flush();
+}
+
+void Tracer::runFlusher() {
+    float samplingCredit = 0.0f;
+    std::unique_lock<std::mutex> lock(_flusherMutex);
+    while (!_stopFlusher) {
+        _flusherCondition.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MSECS));
+        if (_sampling) {
+            // record for the next interval if that keeps us under the sample rate
+            samplingCredit += _sampleRate;
+            bool record = samplingCredit >= 1.0f;
+            if (record) {
+                samplingCredit -= 1.0f;
+            }
+            _recording = record && !_stopFlusher;
+        }
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
 }
 
-void TraceEvent::writeJson(QTextStream& out) const {
-#if 0
-    // FIXME QJsonObject serialization is very slow, so we should be using manual JSON serialization
-    out << "{";
-    out << "\"name\":\"" << name << "\",";
-    out << "\"cat\":\"" << category.categoryName() << "\",";
-    out << "\"ph\":\"" << QString(type) << "\",";
-    out << "\"ts\":\"" << timestamp << "\",";
-    out << "\"pid\":\"" << processID << "\",";
-    out << "\"tid\":\"" << threadID << "\"";
-    //if (!extra.empty()) {
-    //    auto it = extra.begin();
-    //    for (; it != extra.end(); it++) {
-    //        ev[it.key()] = QJsonValue::fromVariant(it.value());
-    //    }
-    //}
-    //if (!args.empty()) {
-    //    out << ",\"args\":'
-    //}
-    out << '}';
-#else
-    QJsonObject ev {
-        { "name", QJsonValue(name) },
-        { "cat", category.categoryName() },
-        { "ph", QString(type) },
-        { "ts", timestamp },
-        { "pid", processID },
-        { "tid", threadID }
+void Tracer::flush() {
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> guard(_buffersMutex);
+        // forget the buffers of the threads that ended, once they are drained
+        _buffers.erase(std::remove_if(_buffers.begin(), _buffers.end(), [](const std::shared_ptr<TraceBuffer>& buffer) {
+            return buffer.use_count() == 1 && buffer->isEmpty();
+        }), _buffers.end());
+        buffers = _buffers;
+    }
+
+    std::lock_guard<std::mutex> guard(_recordsMutex);
+    uint32_t generation = _stringsGeneration.load(std::memory_order_acquire);
+    for (auto& buffer : buffers) {
+        buffer->drain([&](const TraceRecord& record) {
+            _records.push_back(record);
+            if (record.generation != generation && !updateStrings(_records.back())) {
+                _records.pop_back();
+                ++_numDroppedEvents;
+            }
+        });
+    }
+    if (_sampling) {
+        while (_records.size() > MAX_SAMPLED_RECORDS) {
+            _records.pop_front();
+        }
+        // the IDs and arguments of the events trimmed, of requests long done, would otherwise stay interned
+        trimStrings();
+    }
+}
+
+void Tracer::trimStrings() {
+    std::lock_guard<std::mutex> guard(_stringsMutex);
+    if (_strings.size() <= 2 * std::max(_numKeptStrings, MAX_SAMPLED_RECORDS)) {
+        return;
+    }
+
+    const uint32_t NOT_KEPT = (uint32_t)-1;
+    std::vector<uint32_t> newIDs(_strings.size(), NOT_KEPT);
+    std::vector<QString> strings;
+    QHash<QString, uint32_t> stringIDs;
+    uint32_t generation = _stringsGeneration.load(std::memory_order_relaxed) + 1;
+    auto keep = [&](uint32_t& id) {
+        uint32_t& newID = newIDs[id];
+        if (newID == NOT_KEPT) {
+            newID = (uint32_t)strings.size();
+            strings.push_back(_strings[id]);
+            stringIDs.insert(_strings[id], newID);
+        }
+        id = newID;
+    };
+    auto keepRecord = [&](TraceRecord& record) {
+        keep(record.name);
+        keep(record.id);
+        keep(record.category);
+        for (int i = 0; i < record.numArgs; ++i) {
+            TraceArg& arg = record.args[i];
+            keep(arg.key);
+            if (arg.kind == TraceArg::String) {
+                keep(arg.string);
+            }
+        }
+        record.generation = generation;
     };
-    if (!id.isEmpty()) {
-        ev["id"] = id;
+
+    // ID 0 stays the empty string
+    uint32_t emptyID = 0;
+    keep(emptyID);
+    for (auto& record : _metadataRecords) {
+        keepRecord(record);
+    }
+    for (auto& record : _records) {
+        keepRecord(record);
     }
-    if (!args.empty()) {
-        ev["args"] = QJsonObject::fromVariantMap(args);
+
+    _previousStrings = std::move(_strings);
+    _strings = std::move(strings);
+    _stringIDs = std::move(stringIDs);
+    _numKeptStrings = _strings.size();
+    _stringsGeneration.store(generation, std::memory_order_release);
+}
+
+bool Tracer::updateStrings(TraceRecord& record) {
+    // recorded with the strings from before the last compaction, which are interned again
+    std::lock_guard<std::mutex> guard(_stringsMutex);
+    uint32_t generation = _stringsGeneration.load(std::memory_order_relaxed);
+    if (record.generation + 1 != generation) {
+        return false;
     }
-    if (!extra.empty()) {
-        auto it = extra.begin();
-        for (; it != extra.end(); it++) {
-            ev[it.key()] = QJsonValue::fromVariant(it.value());
+    auto update = [&](uint32_t& id) {
+        id = internLocked(_previousStrings[id]);
+    };
+    update(record.name);
+    update(record.id);
+    update(record.category);
+    for (int i = 0; i < record.numArgs; ++i) {
+        TraceArg& arg = record.args[i];
+        update(arg.key);
+        if (arg.kind == TraceArg::String) {
+            update(arg.string);
         }
     }
-    out << QJsonDocument(ev).toJson(QJsonDocument::Compact);
-#endif
+    record.generation = generation;
+    return true;
+}
+
+TraceData Tracer::takeTraceData() {
+    flush();
+
+    TraceData traceData;
+    traceData.processID = QCoreApplication::applicationPid();
+    {
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        traceData.records.reserve(_records.size() + _metadataRecords.size());
+        traceData.records.insert(traceData.records.end(), _records.begin(), _records.end());
+        traceData.records.insert(traceData.records.end(), _metadataRecords.begin(), _metadataRecords.end());
+        _records.clear();
+
+        // with the records, before the flusher compacts the strings again
+        std::lock_guard<std::mutex> stringsGuard(_stringsMutex);
+        traceData.strings = _strings;
+    }
+    return traceData;
 }
 
 void Tracer::serialize(const QString& filename) {
@@ -112,33 +549,13 @@ void Tracer::serialize(const QString& filename) {
         return;
     }
 
-    std::list<TraceEvent> currentEvents;
-    {
-        std::lock_guard<std::mutex> guard(_eventsMutex);
-        currentEvents.swap(_events);
-        for (auto& event : _metadataEvents) {
-            currentEvents.push_back(event);
-        }
-    }
+    TraceData traceData = takeTraceData();
 
-    // If we can't open a temp file for writing, fail early
-    QByteArray data;
-    {
-        QTextStream out(&data);
-        out << "[\n";
-        bool first = true;
-        for (const auto& event : currentEvents) {
-            if (first) {
-                first = false;
-            } else {
-                out << ",\n";
-            }
-            event.writeJson(out);
-        }
-        out << "\n]";
-    }
+    bool isCompressed = fullPath.endsWith(".gz");
+    QString uncompressedPath = isCompressed ? fullPath.left(fullPath.size() - 3) : fullPath;
+    QByteArray data = uncompressedPath.endsWith(TraceData::BINARY_EXTENSION) ? traceData.toBinary() : traceData.toJson();
 
-    if (fullPath.endsWith(".gz")) {
+    if (isCompressed) {
         QByteArray compressed;
         gzip(data, compressed);
         data = compressed;
@@ -153,80 +570,176 @@ void Tracer::serialize(const QString& filename) {
         file.write(data);
         file.close();
     }
+}
 
-#if 0
-    QByteArray data;
-    {
+int64_t Tracer::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+}
 
-        // "traceEvents":[
-        // {"args":{"nv_payload":0},"cat":"hifi.render","name":"render::Scene::processTransactionQueue","ph":"B","pid":14796,"tid":21636,"ts":68795933487}
+uint32_t Tracer::intern(const QString& string) {
+    std::lock_guard<std::mutex> guard(_stringsMutex);
+    return internLocked(string);
+}
 
-        QJsonArray traceEvents;
+uint32_t Tracer::internLocked(const QString& string) {
+    auto it = _stringIDs.find(string);
+    if (it != _stringIDs.end()) {
+        return it.value();
+    }
+    uint32_t id = (uint32_t)_strings.size();
+    _strings.push_back(string);
+    _stringIDs.insert(string, id);
+    return id;
+}
 
-        QJsonDocument document {
-            QJsonObject {
-                { "traceEvents", traceEvents },
-                { "otherData", QJsonObject {
-                    { "version", QString { "High Fidelity Interface v1.0" } +BuildInfo::VERSION }
-                } }
-            }
-        };
-        data = document.toJson(QJsonDocument::Compact);
+uint32_t Tracer::intern(TraceBuffer* buffer, const QString& string) {
+    if (string.isEmpty()) {
+        return 0;
     }
-#endif
+    if (!buffer) {
+        return intern(string);
+    }
+    auto it = buffer->stringIDs.find(string);
+    if (it != buffer->stringIDs.end()) {
+        return it.value();
+    }
+    if (buffer->stringIDs.size() >= TraceBuffer::MAX_CACHED_STRINGS) {
+        // many distinct IDs or arguments, don't let the cache grow with them
+        buffer->stringIDs.clear();
+    }
+    uint32_t id = intern(string);
+    buffer->stringIDs.insert(string, id);
+    return id;
 }
 
-int64_t Tracer::now() {
-    return std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now().time_since_epoch()).count();
+bool Tracer::addArgs(TraceRecord& record, TraceBuffer* buffer, const QVariantMap& args, bool isExtra) {
+    for (auto it = args.begin(); it != args.end(); ++it) {
+        if (record.numArgs == TraceRecord::MAX_ARGS) {
+            return false;
+        }
+        TraceArg& arg = record.args[record.numArgs++];
+        arg.key = intern(buffer, it.key());
+        arg.isExtra = isExtra;
+
+        const QVariant& value = it.value();
+        switch (value.userType()) {
+            case QMetaType::Bool:
+                arg.kind = TraceArg::Bool;
+                arg.number = value.toBool() ? 1.0 : 0.0;
+                break;
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::Long:
+            case QMetaType::ULong:
+            case QMetaType::LongLong:
+            case QMetaType::ULongLong:
+            case QMetaType::Short:
+            case QMetaType::UShort:
+            case QMetaType::Float:
+            case QMetaType::Double:
+                arg.kind = TraceArg::Number;
+                arg.number = value.toDouble();
+                break;
+            case QMetaType::QVariantMap:
+            case QMetaType::QVariantList:
+                arg.kind = TraceArg::String;
+                arg.string = intern(buffer, QString(QJsonDocument::fromVariant(value).toJson(QJsonDocument::Compact)));
+                break;
+            default:
+                arg.kind = TraceArg::String;
+                arg.string = intern(buffer, value.toString());
+                break;
+        }
+    }
+    return true;
+}
+
+TraceBuffer* Tracer::getThreadBuffer() {
+    if (threadBuffer.tracerSerial != _serial) {
+        auto buffer = std::make_shared<TraceBuffer>(int64_t(QThread::currentThreadId()));
+        {
+            std::lock_guard<std::mutex> guard(_buffersMutex);
+            _buffers.push_back(buffer);
+        }
+        threadBuffer.buffer = buffer;
+        threadBuffer.tracerSerial = _serial;
+    }
+    return threadBuffer.buffer.get();
 }
 
 void Tracer::traceEvent(const QLoggingCategory& category,
     const QString& name, EventType type,
-    qint64 timestamp, qint64 processID, qint64 threadID,
+    qint64 timestamp, qint64 threadID,
     const QString& id,
     const QVariantMap& args, const QVariantMap& extra) {
-    std::lock_guard<std::mutex> guard(_eventsMutex);
 
     // We always want to store metadata events even if tracing is not enabled so that when
     // tracing is enabled we will be able to associate that metadata with that trace.
     // Metadata events should be used sparingly - as of 12/30/16 the Chrome Tracing
     // spec only supports thread+process metadata, so we should only expect to see metadata
     // events created when a new thread or process is created.
-    if (!_enabled && type != Metadata) {
+    if (type == Metadata) {
+        // interned under the records lock, so that the strings are not compacted meanwhile
+        std::lock_guard<std::mutex> guard(_recordsMutex);
+        TraceRecord record;
+        record.timestamp = timestamp;
+        record.threadID = threadID;
+        record.name = intern(name);
+        record.id = intern(nullptr, id);
+        record.category = intern(QString(category.categoryName()));
+        record.generation = _stringsGeneration.load(std::memory_order_relaxed);
+        record.type = type;
+        record.numArgs = 0;
+        addArgs(record, nullptr, args, false);
+        addArgs(record, nullptr, extra, true);
+        _metadataRecords.push_back(record);
         return;
     }
 
-    if (type == Metadata) {
-        _metadataEvents.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
+    if (!isRecording()) {
+        return;
+    }
+
+    TraceBuffer* buffer = getThreadBuffer();
+    uint32_t generation = _stringsGeneration.load(std::memory_order_acquire);
+    if (buffer->stringsGeneration != generation) {
+        // the string table was compacted, and what this thread cached is stale
+        buffer->stringIDs.clear();
+        buffer->categoryIDs.clear();
+        buffer->stringsGeneration = generation;
+    }
+
+    TraceRecord record;
+    record.timestamp = timestamp;
+    record.threadID = threadID;
+    record.name = intern(buffer, name);
+    record.id = intern(buffer, id);
+    auto categoryIt = buffer->categoryIDs.find(&category);
+    if (categoryIt != buffer->categoryIDs.end()) {
+        record.category = categoryIt.value();
     } else {
-        _events.push_back({
-            id,
-            name,
-            type,
-            timestamp,
-            processID,
-            threadID,
-            category,
-            args,
-            extra
-        });
+        record.category = intern(QString(category.categoryName()));
+        buffer->categoryIDs.insert(&category, record.category);
+    }
+    record.generation = generation;
+    record.type = type;
+    record.numArgs = 0;
+
+    // only the first MAX_ARGS arguments are kept
+    if (addArgs(record, buffer, args, false)) {
+        addArgs(record, buffer, extra, true);
+    }
+
+    // compacted while interning, some of the strings may be from either table
+    if (_stringsGeneration.load(std::memory_order_acquire) != generation || !buffer->push(record)) {
+        ++_numDroppedEvents;
     }
 }
 
 void Tracer::traceEvent(const QLoggingCategory& category, 
     const QString& name, EventType type, const QString& id, 
     const QVariantMap& args, const QVariantMap& extra) {
-    if (!_enabled && type != Metadata) {
+    if (!isRecording() && type != Metadata) {
         return;
     }
 
@@ -236,11 +749,10 @@ void Tracer::traceEvent(const QLoggingCategory& category,
 void Tracer::traceEvent(const QLoggingCategory& category, 
     const QString& name, EventType type, int64_t timestamp, const QString& id, 
     const QVariantMap& args, const QVariantMap& extra) {
-    if (!_enabled && type != Metadata) {
+    if (!isRecording() && type != Metadata) {
         return;
     }
 
-    auto processID = QCoreApplication::applicationPid();
     auto threadID = int64_t(QThread::currentThreadId());
-    traceEvent(category, name, type, timestamp, processID, threadID, id, args, extra);
+    traceEvent(category, name, type, timestamp, threadID, id, args, extra);
 }
@@ -10,8 +10,14 @@
 #ifndef hifi_Trace_h
 #define hifi_Trace_h
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <QtCore/QString>
 #include <QtCore/QVariantMap>
@@ -62,22 +68,71 @@ enum EventType : char {
     ContextLeave = ')'
 };
 
-struct TraceEvent {
-    QString id;
-    QString name;
+// An argument of a recorded event, reduced to a number or to an interned string.
+struct TraceArg {
+    enum Kind : uint8_t {
+        Number = 0,
+        Bool,
+        String
+    };
+
+    uint32_t key; // interned
+    Kind kind;
+    bool isExtra; // written next to the fields of the event rather than in its args
+    union {
+        double number;
+        uint32_t string; // interned
+    };
+};
+
+// An event as the Tracer records it: fixed size, with its strings interned in the tracer's string table.
+struct TraceRecord {
+    static const int MAX_ARGS = 4;
+
+    int64_t timestamp;
+    int64_t threadID;
+    uint32_t name; // interned, as are the id and the category
+    uint32_t id; // the empty string when the event has none
+    uint32_t category;
+    uint32_t generation; // of the string table, which sampling compacts now and then
     EventType type;
-    qint64 timestamp;
-    qint64 processID;
-    qint64 threadID;
-    const QLoggingCategory& category;
-    QVariantMap args;
-    QVariantMap extra;
-
-    void writeJson(QTextStream& out) const;
+    uint8_t numArgs;
+    TraceArg args[MAX_ARGS];
+};
+
+// A trace as it is serialized: the interned strings, by ID, and the events that refer to them.
+class TraceData {
+public:
+    // the compact binary format, which can be turned into Chrome trace JSON later
+    static const QString BINARY_EXTENSION;
+
+    qint64 processID { 0 };
+    std::vector<QString> strings;
+    std::vector<TraceRecord> records;
+
+    QByteArray toJson() const;
+    QByteArray toBinary() const;
+    bool fromBinary(const QByteArray& binary);
 };
 
+class TraceBuffer;
+
+// Records trace events from any thread without locking: each thread appends fixed size records to a ring buffer of its
+// own, which a flusher thread drains every FLUSH_INTERVAL_MSECS.  A thread whose buffer is full drops its events rather
+// than wait, they are counted in getNumDroppedEvents().
+//
+// startSampling() records in windows of FLUSH_INTERVAL_MSECS, for the given fraction of the time, and keeps only the
+// most recent MAX_SAMPLED_RECORDS, so that it can be left on in servers.  The string table is then compacted to the
+// strings of those records once it has grown to twice what they use, or to twice MAX_SAMPLED_RECORDS.
 class Tracer : public Dependency {
 public:
+    static const size_t THREAD_BUFFER_SIZE = 4096; // a power of two
+    static const int FLUSH_INTERVAL_MSECS = 50;
+    static const size_t MAX_SAMPLED_RECORDS = 1 << 17;
+
+    Tracer();
+    ~Tracer();
+
     static int64_t now();
     void traceEvent(const QLoggingCategory& category, 
         const QString& name, EventType type,
@@ -91,21 +146,72 @@ public:
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
     void startTracing();
+    void startSampling(float rate);
     void stopTracing();
+
+    // for servers: samples at the rate in the HIFI_TRACE_SAMPLE_RATE environment variable, if it is set, and writes
+    // the samples to HIFI_TRACE_FILE, or to a binary trace named after the process, on finishSampling()
+    void startSamplingFromEnvironment();
+    void finishSampling();
+
+    // writes Chrome trace JSON, gzipped if the file name ends with .gz, or the binary format if it ends with
+    // TraceData::BINARY_EXTENSION
     void serialize(const QString& file);
+
+    // takes what was recorded so far
+    TraceData takeTraceData();
+
     bool isEnabled() const { return _enabled; }
+    bool isSampling() const { return _sampling; }
+
+    // whether events are recorded right now, which sampling turns on and off
+    bool isRecording() const { return _recording.load(std::memory_order_relaxed); }
+
+    uint64_t getNumDroppedEvents() const { return _numDroppedEvents; }
 
 private:
-    void traceEvent(const QLoggingCategory& category, 
+    void traceEvent(const QLoggingCategory& category,
         const QString& name, EventType type,
-        qint64 timestamp, qint64 processID, qint64 threadID,
+        qint64 timestamp, qint64 threadID,
         const QString& id = "",
         const QVariantMap& args = QVariantMap(), const QVariantMap& extra = QVariantMap());
 
-    bool _enabled { false };
-    std::list<TraceEvent> _events;
-    std::list<TraceEvent> _metadataEvents;
-    std::mutex _eventsMutex;
+    void start(bool sampling, float rate);
+    uint32_t intern(const QString& string);
+    uint32_t internLocked(const QString& string);
+    uint32_t intern(TraceBuffer* buffer, const QString& string);
+    bool addArgs(TraceRecord& record, TraceBuffer* buffer, const QVariantMap& args, bool isExtra);
+    TraceBuffer* getThreadBuffer();
+    void flush();
+    void trimStrings();
+    bool updateStrings(TraceRecord& record);
+    void runFlusher();
+
+    const uint32_t _serial;
+    std::atomic<bool> _enabled { false };
+    std::atomic<bool> _sampling { false };
+    std::atomic<bool> _recording { false };
+    float _sampleRate { 0.0f };
+    std::atomic<uint64_t> _numDroppedEvents { 0 };
+
+    std::mutex _stringsMutex;
+    std::vector<QString> _strings;
+    QHash<QString, uint32_t> _stringIDs;
+    std::vector<QString> _previousStrings; // before the last compaction, for the records made while it ran
+    size_t _numKeptStrings { 0 }; // by the last compaction
+    std::atomic<uint32_t> _stringsGeneration { 0 };
+
+    std::mutex _buffersMutex;
+    std::vector<std::shared_ptr<TraceBuffer>> _buffers;
+
+    std::mutex _recordsMutex;
+    std::deque<TraceRecord> _records;
+    std::vector<TraceRecord> _metadataRecords;
+
+    std::mutex _flusherMutex;
+    std::condition_variable _flusherCondition;
+    std::thread _flusher;
+    bool _stopFlusher { false };
 };
 
 inline void traceEvent(const QLoggingCategory& category, int64_t timestamp, const QString& name, EventType type, const QString& id = "", const QVariantMap& args = {}, const QVariantMap& extra = {}) {
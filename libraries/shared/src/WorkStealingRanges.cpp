@@ -0,0 +1,78 @@
+//
+//  WorkStealingRanges.cpp
+//  libraries/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WorkStealingRanges.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+
+void WorkStealingRanges::reset(int size, int numWorkers) {
+    assert(size >= 0 && numWorkers >= 0);
+
+    if (numWorkers > _capacity) {
+        _ranges.reset(new Range[numWorkers]);
+        _capacity = numWorkers;
+    }
+    _numWorkers = numWorkers;
+
+    // split evenly, the remainder spread over the first ranges
+    for (int i = 0; i < _numWorkers; ++i) {
+        _ranges[i].next.store((int)((int64_t)size * i / _numWorkers), std::memory_order_relaxed);
+        _ranges[i].end = (int)((int64_t)size * (i + 1) / _numWorkers);
+    }
+}
+
+bool WorkStealingRanges::claimFrom(Range& range, int& begin, int& end) {
+    int remaining = range.end - range.next.load(std::memory_order_relaxed);
+    if (remaining <= 0) {
+        return false;
+    }
+
+    // others may have claimed since, so the chunk is clamped to what is actually left
+    int chunk = std::max(remaining / CHUNK_FRACTION, 1);
+    begin = range.next.fetch_add(chunk, std::memory_order_relaxed);
+    if (begin >= range.end) {
+        return false;
+    }
+    end = std::min(begin + chunk, range.end);
+    return true;
+}
+
+bool WorkStealingRanges::claim(int worker, int& begin, int& end, bool& isStolen) {
+    assert(worker >= 0 && worker < _numWorkers);
+
+    if (claimFrom(_ranges[worker], begin, end)) {
+        isStolen = false;
+        return true;
+    }
+
+    // steal from the range with the most left; a claim only fails on a range that is done, so this ends
+    while (true) {
+        int victim = -1;
+        int mostRemaining = 0;
+        for (int i = 0; i < _numWorkers; ++i) {
+            int remaining = _ranges[i].end - _ranges[i].next.load(std::memory_order_relaxed);
+            if (remaining > mostRemaining) {
+                mostRemaining = remaining;
+                victim = i;
+            }
+        }
+
+        if (victim == -1) {
+            return false;
+        }
+
+        if (claimFrom(_ranges[victim], begin, end)) {
+            isStolen = (victim != worker);
+            return true;
+        }
+    }
+}
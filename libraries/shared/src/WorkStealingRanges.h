@@ -0,0 +1,54 @@
+//
+//  WorkStealingRanges.h
+//  libraries/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_WorkStealingRanges_h
+#define hifi_WorkStealingRanges_h
+
+#include <atomic>
+#include <memory>
+
+//
+// The items [0, size) of a job, split into a range for each worker of a pool.
+//
+// A worker claims chunks from the front of its own range, and once that is done, steals them from the front of the
+// range with the most left, until every range is done.  Chunks are a fraction of what is left in a range, so they
+// start large and end as single items: a worker that drew expensive items sheds the rest of its range to the others,
+// and the job ends on small claims.  Claims are a single atomic add, without locks.
+//
+// reset() must not race with claim(): a pool resets the ranges before it starts the workers on a job.
+//
+class WorkStealingRanges {
+public:
+    static const int CHUNK_FRACTION = 4;    // of what is left in a range, for a claim
+
+    // start a job of size items, over numWorkers
+    void reset(int size, int numWorkers);
+
+    // claim the next chunk of items [begin, end) for a worker, or return false once the job is done
+    bool claim(int worker, int& begin, int& end, bool& isStolen);
+
+    int getNumWorkers() const { return _numWorkers; }
+
+private:
+    // padded, so that workers claiming from different ranges do not share a cache line
+    struct Range {
+        std::atomic<int> next { 0 };
+        int end { 0 };
+        char padding[128 - sizeof(std::atomic<int>) - sizeof(int)];
+    };
+
+    static bool claimFrom(Range& range, int& begin, int& end);
+
+    std::unique_ptr<Range[]> _ranges;
+    int _capacity { 0 };
+    int _numWorkers { 0 };
+};
+
+#endif // hifi_WorkStealingRanges_h
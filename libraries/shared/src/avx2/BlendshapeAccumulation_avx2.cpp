@@ -0,0 +1,210 @@
+//
+//  BlendshapeAccumulation_avx2.cpp
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <stdint.h>
+#include <immintrin.h>
+
+static const int BLOCK_SIZE = 8;
+static const int NUM_COMPONENTS = 9;    // position xyz, normal xyz, tangent xyz
+
+void accumulateDenseBlendshapeBlocks_AVX2(const int32_t* indices, const float* blocks, int numBlocks,
+                                          float positionCoefficient, float normalCoefficient, float* offsets, int stride) {
+
+    __m256 pc = _mm256_set1_ps(positionCoefficient);
+    __m256 nc = _mm256_set1_ps(normalCoefficient);
+
+    for (int b = 0; b < numBlocks; b++) {
+        const float* src = blocks + b * NUM_COMPONENTS * BLOCK_SIZE;
+        float* dst = offsets + indices[b];
+
+        // offsets += block * coefficient, one plane at a time
+        for (int k = 0; k < 3; k++) {
+            __m256 acc = _mm256_loadu_ps(dst + k * stride);
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(src + k * BLOCK_SIZE), pc, acc);
+            _mm256_storeu_ps(dst + k * stride, acc);
+        }
+        for (int k = 3; k < NUM_COMPONENTS; k++) {
+            __m256 acc = _mm256_loadu_ps(dst + k * stride);
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(src + k * BLOCK_SIZE), nc, acc);
+            _mm256_storeu_ps(dst + k * stride, acc);
+        }
+    }
+
+    _mm256_zeroupper();
+}
+
+void accumulateSparseBlendshapeBlocks_AVX2(const int32_t* indices, const float* blocks, int numBlocks,
+                                           float positionCoefficient, float normalCoefficient, float* offsets, int stride) {
+
+    __m256 pc = _mm256_set1_ps(positionCoefficient);
+    __m256 nc = _mm256_set1_ps(normalCoefficient);
+    alignas(32) float result[BLOCK_SIZE];
+
+    for (int b = 0; b < numBlocks; b++) {
+        const int32_t* blockIndices = indices + b * BLOCK_SIZE;
+        const float* src = blocks + b * NUM_COMPONENTS * BLOCK_SIZE;
+        __m256i index = _mm256_loadu_si256((const __m256i*)blockIndices);
+
+        for (int k = 0; k < NUM_COMPONENTS; k++) {
+            float* plane = offsets + k * stride;
+
+            // gather, accumulate, then scatter by hand (the lanes of a block never share a vertex)
+            __m256 acc = _mm256_i32gather_ps(plane, index, sizeof(float));
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(src + k * BLOCK_SIZE), k < 3 ? pc : nc, acc);
+            _mm256_store_ps(result, acc);
+
+            plane[blockIndices[0]] = result[0];
+            plane[blockIndices[1]] = result[1];
+            plane[blockIndices[2]] = result[2];
+            plane[blockIndices[3]] = result[3];
+            plane[blockIndices[4]] = result[4];
+            plane[blockIndices[5]] = result[5];
+            plane[blockIndices[6]] = result[6];
+            plane[blockIndices[7]] = result[7];
+        }
+    }
+
+    _mm256_zeroupper();
+}
+
+// Packs 8 vertices from their planes.  The results are interleaved 2 vertices per register, in the order
+// { 0,4 } { 1,5 } { 2,6 } { 3,7 } for the low and high lanes of v0..v3.
+static inline void packBlock(const float* offsets, int stride, __m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3) {
+
+    __m256 px = _mm256_loadu_ps(offsets + 0 * stride);
+    __m256 py = _mm256_loadu_ps(offsets + 1 * stride);
+    __m256 pz = _mm256_loadu_ps(offsets + 2 * stride);
+    __m256 nx = _mm256_loadu_ps(offsets + 3 * stride);
+    __m256 ny = _mm256_loadu_ps(offsets + 4 * stride);
+    __m256 nz = _mm256_loadu_ps(offsets + 5 * stride);
+    __m256 tx = _mm256_loadu_ps(offsets + 6 * stride);
+    __m256 ty = _mm256_loadu_ps(offsets + 7 * stride);
+    __m256 tz = _mm256_loadu_ps(offsets + 8 * stride);
+
+    // abs(pos)
+    __m256 apx = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), px);
+    __m256 apy = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), py);
+    __m256 apz = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), pz);
+
+    // len = compMax(abs(pos))
+    __m256 len = _mm256_max_ps(_mm256_max_ps(apx, apy), apz);
+
+    // detect zeros
+    __m256 mask = _mm256_cmp_ps(len, _mm256_setzero_ps(), _CMP_EQ_OQ);
+
+    // rcp = 1.0f / len
+    __m256 rcp = _mm256_div_ps(_mm256_set1_ps(1.0f), len);
+
+    // replace +inf with 1.0f
+    rcp = _mm256_blendv_ps(rcp, _mm256_set1_ps(1.0f), mask);
+    len = _mm256_blendv_ps(len, _mm256_set1_ps(1.0f), mask);
+
+    // pos *= 1.0f / len
+    px = _mm256_mul_ps(px, rcp);
+    py = _mm256_mul_ps(py, rcp);
+    pz = _mm256_mul_ps(pz, rcp);
+
+    // clamp(vec, -1.0f, 1.0f)
+    px = _mm256_min_ps(_mm256_max_ps(px, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    py = _mm256_min_ps(_mm256_max_ps(py, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    pz = _mm256_min_ps(_mm256_max_ps(pz, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    nx = _mm256_min_ps(_mm256_max_ps(nx, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    ny = _mm256_min_ps(_mm256_max_ps(ny, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    nz = _mm256_min_ps(_mm256_max_ps(nz, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    tx = _mm256_min_ps(_mm256_max_ps(tx, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    ty = _mm256_min_ps(_mm256_max_ps(ty, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+    tz = _mm256_min_ps(_mm256_max_ps(tz, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+
+    // vec *= 511.0f
+    px = _mm256_mul_ps(px, _mm256_set1_ps(511.0f));
+    py = _mm256_mul_ps(py, _mm256_set1_ps(511.0f));
+    pz = _mm256_mul_ps(pz, _mm256_set1_ps(511.0f));
+    nx = _mm256_mul_ps(nx, _mm256_set1_ps(511.0f));
+    ny = _mm256_mul_ps(ny, _mm256_set1_ps(511.0f));
+    nz = _mm256_mul_ps(nz, _mm256_set1_ps(511.0f));
+    tx = _mm256_mul_ps(tx, _mm256_set1_ps(511.0f));
+    ty = _mm256_mul_ps(ty, _mm256_set1_ps(511.0f));
+    tz = _mm256_mul_ps(tz, _mm256_set1_ps(511.0f));
+
+    // veci = lrint(vec) & 03ff
+    __m256i pxi = _mm256_and_si256(_mm256_cvtps_epi32(px), _mm256_set1_epi32(0x3ff));
+    __m256i pyi = _mm256_and_si256(_mm256_cvtps_epi32(py), _mm256_set1_epi32(0x3ff));
+    __m256i pzi = _mm256_and_si256(_mm256_cvtps_epi32(pz), _mm256_set1_epi32(0x3ff));
+    __m256i nxi = _mm256_and_si256(_mm256_cvtps_epi32(nx), _mm256_set1_epi32(0x3ff));
+    __m256i nyi = _mm256_and_si256(_mm256_cvtps_epi32(ny), _mm256_set1_epi32(0x3ff));
+    __m256i nzi = _mm256_and_si256(_mm256_cvtps_epi32(nz), _mm256_set1_epi32(0x3ff));
+    __m256i txi = _mm256_and_si256(_mm256_cvtps_epi32(tx), _mm256_set1_epi32(0x3ff));
+    __m256i tyi = _mm256_and_si256(_mm256_cvtps_epi32(ty), _mm256_set1_epi32(0x3ff));
+    __m256i tzi = _mm256_and_si256(_mm256_cvtps_epi32(tz), _mm256_set1_epi32(0x3ff));
+
+    // pack = (xi << 0) | (yi << 10) | (zi << 20);
+    __m256i li = _mm256_castps_si256(len);                                                                      // length
+    __m256i pi = _mm256_or_si256(_mm256_or_si256(pxi, _mm256_slli_epi32(pyi, 10)), _mm256_slli_epi32(pzi, 20)); // position
+    __m256i ni = _mm256_or_si256(_mm256_or_si256(nxi, _mm256_slli_epi32(nyi, 10)), _mm256_slli_epi32(nzi, 20)); // normal
+    __m256i ti = _mm256_or_si256(_mm256_or_si256(txi, _mm256_slli_epi32(tyi, 10)), _mm256_slli_epi32(tzi, 20)); // tangent
+
+    //
+    // interleave (4x4 matrix transpose)
+    //
+    __m256i u0 = _mm256_unpacklo_epi32(li, pi);
+    __m256i u1 = _mm256_unpackhi_epi32(li, pi);
+    __m256i u2 = _mm256_unpacklo_epi32(ni, ti);
+    __m256i u3 = _mm256_unpackhi_epi32(ni, ti);
+
+    v0 = _mm256_unpacklo_epi64(u0, u2);
+    v1 = _mm256_unpackhi_epi64(u0, u2);
+    v2 = _mm256_unpacklo_epi64(u1, u3);
+    v3 = _mm256_unpackhi_epi64(u1, u3);
+}
+
+// Same encoding as packBlendshapeOffsets_AVX2, from planes rather than interleaved offsets, which saves the
+// deinterleave.  The planes must be readable for a full block past numVertices.
+void packBlendshapeOffsetPlanes_AVX2(const float* offsets, int stride, uint32_t (*packed)[4], int numVertices) {
+
+    __m256i v0, v1, v2, v3;
+
+    int i = 0;
+    for (; i < numVertices - 7; i += 8) {  // blocks of 8
+
+        packBlock(offsets + i, stride, v0, v1, v2, v3);
+
+        __m256i w0 = _mm256_permute2f128_si256(v0, v1, 0x20);
+        __m256i w1 = _mm256_permute2f128_si256(v2, v3, 0x20);
+        __m256i w2 = _mm256_permute2f128_si256(v0, v1, 0x31);
+        __m256i w3 = _mm256_permute2f128_si256(v2, v3, 0x31);
+
+        // store pack x 8
+        _mm256_storeu_si256((__m256i*)packed[i+0], w0);
+        _mm256_storeu_si256((__m256i*)packed[i+2], w1);
+        _mm256_storeu_si256((__m256i*)packed[i+4], w2);
+        _mm256_storeu_si256((__m256i*)packed[i+6], w3);
+    }
+
+    if (i < numVertices) { // remainder
+        int rem = numVertices - i;
+
+        packBlock(offsets + i, stride, v0, v1, v2, v3);
+
+        switch (rem) {
+            case 7: _mm_storeu_si128((__m128i*)packed[i+6], _mm256_extractf128_si256(v2, 1));
+            case 6: _mm_storeu_si128((__m128i*)packed[i+5], _mm256_extractf128_si256(v1, 1));
+            case 5: _mm_storeu_si128((__m128i*)packed[i+4], _mm256_extractf128_si256(v0, 1));
+            case 4: _mm_storeu_si128((__m128i*)packed[i+3], _mm256_castsi256_si128(v3));
+            case 3: _mm_storeu_si128((__m128i*)packed[i+2], _mm256_castsi256_si128(v2));
+            case 2: _mm_storeu_si128((__m128i*)packed[i+1], _mm256_castsi256_si128(v1));
+            case 1: _mm_storeu_si128((__m128i*)packed[i+0], _mm256_castsi256_si128(v0));
+        }
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
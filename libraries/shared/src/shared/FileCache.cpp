@@ -274,6 +274,20 @@ void FileCache::eject(FilePointer file) {
     }
 }
 
+void FileCache::evict(const Key& key) {
+    Lock lock(_mutex);
+    const auto it = _files.find(key);
+    if (it == _files.cend()) {
+        return;
+    }
+    FilePointer file = it->second.lock();
+    if (file) {
+        eject(file);
+    } else {
+        _files.erase(it);
+    }
+}
+
 void FileCache::clean() {
     size_t overbudgetAmount = getOverbudgetAmount();
 
@@ -102,6 +102,13 @@ public:
     /// create a file
     virtual std::unique_ptr<File> createFile(Metadata&& metadata, const std::string& filepath);
 
+protected:
+    // Remove a file from the cache by key, deleting it from disk once it is no longer in use
+    void evict(const Key& key);
+
+    const std::string& getDirpath() const { return _dirpath; }
+    const std::string& getExt() const { return _ext; }
+
 private:
     using Mutex = std::recursive_mutex;
     using Lock = std::unique_lock<Mutex>;
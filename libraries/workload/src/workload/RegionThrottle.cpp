@@ -0,0 +1,54 @@
+//
+//  RegionThrottle.cpp
+//  libraries/workload/src/workload
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RegionThrottle.h"
+
+#include <NumericalConstants.h>
+
+using namespace workload;
+
+// an avatar's hearing and sight of fine motion, what is still worth noticing, and the rest of the neighborhood
+const float RegionThrottle::DEFAULT_REGION_RADII[Region::NUM_TRACKED_REGIONS] = { 16.0f, 64.0f, 256.0f };
+
+const uint64_t RegionThrottle::DEFAULT_REGION_INTERVALS[Region::NUM_KNOWN_REGIONS] = {
+    0,                        // R1
+    0,                        // R2
+    USECS_PER_SECOND / 10,    // R3
+    USECS_PER_SECOND / 2      // R4
+};
+
+RegionThrottle::RegionThrottle() {
+    for (uint32_t i = 0; i < Region::NUM_TRACKED_REGIONS; ++i) {
+        _regionRadii[i] = DEFAULT_REGION_RADII[i];
+    }
+    for (uint32_t i = 0; i < Region::NUM_KNOWN_REGIONS; ++i) {
+        _regionIntervals[i] = DEFAULT_REGION_INTERVALS[i];
+    }
+}
+
+void RegionThrottle::evalViews(const std::vector<glm::vec3>& agentPositions, Views& views) const {
+    views.clear();
+    views.reserve(agentPositions.size());
+    for (const auto& position : agentPositions) {
+        views.push_back(View::evalFromPosition(position, _regionRadii));
+    }
+}
+
+uint8_t RegionThrottle::evalRegion(const glm::vec3& agentPosition, const Sphere& sphere) const {
+    glm::vec3 offset = glm::vec3(sphere) - agentPosition;
+    float distanceSquared = glm::dot(offset, offset);
+    for (uint32_t k = 0; k < Region::NUM_TRACKED_REGIONS; ++k) {
+        float touchDistance = sphere.w + _regionRadii[k];
+        if (distanceSquared < touchDistance * touchDistance) {
+            return (uint8_t)k;
+        }
+    }
+    return Region::R4;
+}
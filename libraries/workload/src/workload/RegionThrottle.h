@@ -0,0 +1,62 @@
+//
+//  RegionThrottle.h
+//  libraries/workload/src/workload
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_workload_RegionThrottle_h
+#define hifi_workload_RegionThrottle_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "View.h"
+
+namespace workload {
+
+// How often a server refreshes what it owns, by the region of each thing relative to the agents connected to it.
+//
+// A server has no camera to follow: each agent is a View whose region spheres are centered on the agent, of the
+// given radii.  Things in R1 and R2 of some agent are refreshed every frame by default, things only in R3 and things
+// in R4 (near nobody) at most once per interval of their region.
+class RegionThrottle {
+public:
+    static const float DEFAULT_REGION_RADII[Region::NUM_TRACKED_REGIONS];
+    static const uint64_t DEFAULT_REGION_INTERVALS[Region::NUM_KNOWN_REGIONS];
+
+    RegionThrottle();
+
+    // the radii are expected to grow from R1 to R3
+    void setRegionRadius(uint8_t region, float radius) { _regionRadii[region] = radius; }
+    float getRegionRadius(uint8_t region) const { return _regionRadii[region]; }
+
+    void setRegionInterval(uint8_t region, uint64_t interval) { _regionIntervals[region] = interval; }
+    uint64_t getRegionInterval(uint8_t region) const { return _regionIntervals[region]; }
+
+    // the views of agents at these positions, for a Space to categorize its proxies against
+    void evalViews(const std::vector<glm::vec3>& agentPositions, Views& views) const;
+
+    // the region of a sphere relative to the agent at agentPosition alone, as a Space with that single view would
+    // categorize it
+    uint8_t evalRegion(const glm::vec3& agentPosition, const Sphere& sphere) const;
+
+    // whether something in region, last refreshed at lastRefresh, is due for a refresh at now;
+    // UNKNOWN and INVALID are always due, so that nothing is held back before it has been categorized
+    bool isDue(uint8_t region, uint64_t lastRefresh, uint64_t now) const {
+        return region >= Region::NUM_KNOWN_REGIONS || now < lastRefresh || now - lastRefresh >= _regionIntervals[region];
+    }
+
+private:
+    float _regionRadii[Region::NUM_TRACKED_REGIONS];
+    uint64_t _regionIntervals[Region::NUM_KNOWN_REGIONS];
+};
+
+} // namespace workload
+
+#endif // hifi_workload_RegionThrottle_h
@@ -18,8 +18,18 @@
 
 #include <glm/gtx/quaternion.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 using namespace workload;
 
+// proxies are categorized in batches of BATCH_SIZE, whose loops the compiler turns into SIMD, and the arrays are
+// padded to a whole number of batches so that every batch is full
+const uint32_t BATCH_SIZE = 16;
+
+// blocks of proxies categorized by one task, big enough to amortize the task and the merge of its changes
+const uint32_t BLOCK_SIZE = 64 * BATCH_SIZE;
+
 Space::Space() : Collection() {
 }
 
@@ -28,9 +38,8 @@ void Space::processTransactionFrame(const Transaction& transaction) {
     // Here we should be able to check the value of last ProxyID allocated
     // and allocate new proxies accordingly
     ProxyID maxID = _IDAllocator.getNumAllocatedIndices();
-    if (maxID > (Index) _proxies.size()) {
-        _proxies.resize(maxID + 100); // allocate the maxId and more
-        _owners.resize(maxID + 100);
+    if (maxID > (Index)_regions.size()) {
+        resizeProxies(maxID + 100); // allocate the maxId and more
     }
     // Now we know for sure that we have enough items in the array to
     // capture anything coming from the transaction
@@ -49,11 +58,9 @@ void Space::processResets(const Transaction::Resets& transactions) {
         if (!_IDAllocator.checkIndex(proxyID)) {
             continue;
         }
-        auto& item = _proxies[proxyID];
-
         // Reset the item with a new payload
-        item.sphere = (std::get<1>(reset));
-        item.prevRegion = item.region = Region::UNKNOWN;
+        setProxySphere(proxyID, std::get<1>(reset));
+        _prevRegions[proxyID] = _regions[proxyID] = Region::UNKNOWN;
 
         _owners[proxyID] = (std::get<2>(reset));
     }
@@ -66,11 +73,8 @@ void Space::processRemoves(const Transaction::Removes& transactions) {
         }
         _IDAllocator.freeIndex(removedID);
 
-        // Access the true item
-        auto& item = _proxies[removedID];
-
         // Kill it
-        item.prevRegion = item.region = Region::INVALID;
+        _prevRegions[removedID] = _regions[removedID] = Region::INVALID;
         _owners[removedID] = Owner();
     }
 }
@@ -82,48 +86,113 @@ void Space::processUpdates(const Transaction::Updates& transactions) {
             continue;
         }
 
-        // Access the true item
-        auto& item = _proxies[updateID];
-
         // Update the item
-        item.sphere = (std::get<1>(update));
+        setProxySphere(updateID, std::get<1>(update));
     }
 }
 
-void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
-    std::unique_lock<std::mutex> lock(_proxiesMutex);
-    uint32_t numProxies = (uint32_t)_proxies.size();
+void Space::resizeProxies(uint32_t numProxies) {
+    numProxies = BATCH_SIZE * ((numProxies + BATCH_SIZE - 1) / BATCH_SIZE);
+    _proxyX.resize(numProxies, 0.0f);
+    _proxyY.resize(numProxies, 0.0f);
+    _proxyZ.resize(numProxies, 0.0f);
+    _proxyRadius.resize(numProxies, 0.0f);
+    _regions.resize(numProxies, Region::INVALID);
+    _prevRegions.resize(numProxies, Region::INVALID);
+    _owners.resize(numProxies);
+}
+
+void Space::setProxySphere(int32_t proxyID, const Sphere& sphere) {
+    _proxyX[proxyID] = sphere.x;
+    _proxyY[proxyID] = sphere.y;
+    _proxyZ[proxyID] = sphere.z;
+    _proxyRadius[proxyID] = sphere.w;
+}
+
+Proxy Space::getProxy(int32_t proxyID) const {
+    Proxy proxy(Sphere(_proxyX[proxyID], _proxyY[proxyID], _proxyZ[proxyID], _proxyRadius[proxyID]));
+    proxy.region = _regions[proxyID];
+    proxy.prevRegion = _prevRegions[proxyID];
+    return proxy;
+}
+
+void Space::categorizeBlock(uint32_t blockIndex) {
+    auto& changes = _blockChanges[blockIndex];
+    changes.clear();
+
     uint32_t numViews = (uint32_t)_views.size();
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        Proxy& proxy = _proxies[i];
-        if (proxy.region < Region::INVALID) {
-            glm::vec3 proxyCenter = glm::vec3(proxy.sphere);
-            float proxyRadius = proxy.sphere.w;
-            uint8_t region = Region::R4;
-            for (uint32_t j = 0; j < numViews; ++j) {
-                auto& view = _views[j];
-                // for each 'view' we need only increment 'k' below the current value of 'region'
-                for (uint8_t k = 0; k < region; ++k) {
-                    float touchDistance = proxyRadius + view.regions[k].w;
-                    if (distance2(proxyCenter, glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
-                        region = k;
-                        break;
-                    }
+    uint32_t blockEnd = std::min((blockIndex + 1) * BLOCK_SIZE, (uint32_t)_regions.size());
+    for (uint32_t first = blockIndex * BLOCK_SIZE; first < blockEnd; first += BATCH_SIZE) {
+        const float* x = _proxyX.data() + first;
+        const float* y = _proxyY.data() + first;
+        const float* z = _proxyZ.data() + first;
+        const float* radius = _proxyRadius.data() + first;
+
+        // a proxy is in the lowest region it touches in any view: rather than stopping at the first region each
+        // proxy touches, test them all so that the loop over the batch has no branches
+        int32_t regions[BATCH_SIZE];
+        for (uint32_t i = 0; i < BATCH_SIZE; ++i) {
+            regions[i] = Region::R4;
+        }
+        for (uint32_t j = 0; j < numViews; ++j) {
+            for (int32_t k = (int32_t)Region::NUM_TRACKED_REGIONS - 1; k >= 0; --k) {
+                const Sphere& regionSphere = _views[j].regions[k];
+                for (uint32_t i = 0; i < BATCH_SIZE; ++i) {
+                    float dx = x[i] - regionSphere.x;
+                    float dy = y[i] - regionSphere.y;
+                    float dz = z[i] - regionSphere.z;
+                    float touchDistance = radius[i] + regionSphere.w;
+                    bool touches = dx * dx + dy * dy + dz * dz < touchDistance * touchDistance;
+                    regions[i] = (touches && k < regions[i]) ? k : regions[i];
                 }
             }
-            proxy.prevRegion = proxy.region;
-            proxy.region = region;
-            if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+        }
+
+        for (uint32_t i = 0; i < BATCH_SIZE; ++i) {
+            uint32_t index = first + i;
+            if (_regions[index] < Region::INVALID) {
+                _prevRegions[index] = _regions[index];
+                _regions[index] = (uint8_t)regions[i];
+                if (_regions[index] != _prevRegions[index]) {
+                    changes.emplace_back(Space::Change((int32_t)index, _regions[index], _prevRegions[index]));
+                }
             }
         }
     }
 }
 
+void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
+    std::unique_lock<std::mutex> lock(_proxiesMutex);
+    uint32_t numProxies = (uint32_t)_regions.size();
+    uint32_t numBlocks = (numProxies + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    _blockChanges.resize(numBlocks);
+    if (numBlocks > 1) {
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, numBlocks), [&](const tbb::blocked_range<uint32_t>& range) {
+            for (uint32_t i = range.begin(); i < range.end(); ++i) {
+                categorizeBlock(i);
+            }
+        });
+    } else if (numBlocks == 1) {
+        categorizeBlock(0);
+    }
+
+    // merge the changes of the blocks in order, so that they come out sorted by proxy as they did serially
+    size_t numChanges = changes.size();
+    for (auto& blockChanges : _blockChanges) {
+        numChanges += blockChanges.size();
+    }
+    changes.reserve(numChanges);
+    for (auto& blockChanges : _blockChanges) {
+        changes.insert(changes.end(), blockChanges.begin(), blockChanges.end());
+    }
+}
+
 uint32_t Space::copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    auto numCopied = std::min(numDestProxies, (uint32_t)_proxies.size());
-    memcpy(proxies, _proxies.data(), numCopied * sizeof(Proxy));
+    auto numCopied = std::min(numDestProxies, (uint32_t)_regions.size());
+    for (uint32_t i = 0; i < numCopied; ++i) {
+        proxies[i] = getProxy(i);
+    }
     return numCopied;
 }
 
@@ -131,8 +200,8 @@ uint32_t Space::copySelectedProxyValues(Proxy::Vector& proxies, const workload::
     std::unique_lock<std::mutex> lock(_proxiesMutex);
     uint32_t numCopied = 0;
     for (auto index : indices) {
-        if (isAllocatedID(index) && (index < (Index)_proxies.size())) {
-            proxies.push_back(_proxies[index]);
+        if (isAllocatedID(index) && (index < (Index)_regions.size())) {
+            proxies.push_back(getProxy(index));
             ++numCopied;
         }
     }
@@ -141,7 +210,7 @@ uint32_t Space::copySelectedProxyValues(Proxy::Vector& proxies, const workload::
 
 const Owner Space::getOwner(int32_t proxyID) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    if (isAllocatedID(proxyID) && (proxyID < (Index)_proxies.size())) {
+    if (isAllocatedID(proxyID) && (proxyID < (Index)_regions.size())) {
         return _owners[proxyID];
     }
     return Owner();
@@ -149,8 +218,8 @@ const Owner Space::getOwner(int32_t proxyID) const {
 
 uint8_t Space::getRegion(int32_t proxyID) const {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
-    if (isAllocatedID(proxyID) && (proxyID < (Index)_proxies.size())) {
-        return _proxies[proxyID].region;
+    if (isAllocatedID(proxyID) && (proxyID < (Index)_regions.size())) {
+        return _regions[proxyID];
     }
     return (uint8_t)Region::INVALID;
 }
@@ -159,8 +228,14 @@ void Space::clear() {
     Collection::clear();
     std::unique_lock<std::mutex> lock(_proxiesMutex);
     _IDAllocator.clear();
-    _proxies.clear();
+    _proxyX.clear();
+    _proxyY.clear();
+    _proxyZ.clear();
+    _proxyRadius.clear();
+    _regions.clear();
+    _prevRegions.clear();
     _owners.clear();
+    _blockChanges.clear();
     _views.clear();
 }
 
@@ -60,11 +60,27 @@ private:
     void processRemoves(const Transaction::Removes& transactions);
     void processUpdates(const Transaction::Updates& transactions);
 
+    void resizeProxies(uint32_t numProxies);
+    void setProxySphere(int32_t proxyID, const Sphere& sphere);
+    Proxy getProxy(int32_t proxyID) const;
+    void categorizeBlock(uint32_t blockIndex);
+
     // The database of proxies is protected for editing by a mutex
     mutable std::mutex _proxiesMutex;
-    Proxy::Vector _proxies;
+
+    // Proxies are stored as one array per component rather than as Proxy::Vector, so that categorizing them streams
+    // through packed floats and tests a batch of proxies against each region sphere at once
+    std::vector<float> _proxyX;
+    std::vector<float> _proxyY;
+    std::vector<float> _proxyZ;
+    std::vector<float> _proxyRadius;
+    std::vector<uint8_t> _regions;
+    std::vector<uint8_t> _prevRegions;
     std::vector<Owner> _owners;
 
+    // changes found by each block of proxies, categorized in parallel, merged in proxy order
+    std::vector<std::vector<Change>> _blockChanges;
+
     Views _views;
 };
 
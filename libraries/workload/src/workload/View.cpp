@@ -35,6 +35,17 @@ View View::evalFromFrustum(const ViewFrustum& frustum, const glm::vec3& offset)
     return view;
 }
 
+View View::evalFromPosition(const glm::vec3& position, const float* regionRadii) {
+    View view;
+    view.origin = position;
+    for (int i = 0; i < (int)Region::NUM_TRACKED_REGIONS; i++) {
+        // back and front at the same distance center the region sphere on the origin
+        view.regionBackFronts[i] = glm::vec2(regionRadii[i]);
+    }
+    updateRegionsFromBackFronts(view);
+    return view;
+}
+
 Sphere View::evalRegionSphere(const View& view, float originRadius, float maxDistance) {
     float radius = (maxDistance + originRadius) / 2.0f;
     float distanceToCenter = radius - originRadius;
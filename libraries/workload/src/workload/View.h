@@ -60,6 +60,9 @@ public:
     void makeHorizontal();
 
     static View evalFromFrustum(const ViewFrustum& frustum, const glm::vec3& offset = glm::vec3());
+    // view of an agent that matters in every direction, as seen from a server: the regions are spheres centered on
+    // position, of the NUM_TRACKED_REGIONS radii given
+    static View evalFromPosition(const glm::vec3& position, const float* regionRadii);
     static Sphere evalRegionSphere(const View& view, float originRadius, float maxDistance);
 
     static void updateRegionsDefault(View& view);
@@ -0,0 +1,90 @@
+//
+//  ADPCMCodec.cpp
+//  plugins/adpcmCodec/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ADPCMCodec.h"
+
+#include <AudioADPCM.h>
+#include <AudioConstants.h>
+
+const char* ADPCMCodec::NAME { "adpcm" };
+
+void ADPCMCodec::init() {
+}
+
+void ADPCMCodec::deinit() {
+}
+
+bool ADPCMCodec::activate() {
+    CodecPlugin::activate();
+    return true;
+}
+
+void ADPCMCodec::deactivate() {
+    CodecPlugin::deactivate();
+}
+
+bool ADPCMCodec::isSupported() const {
+    return true;
+}
+
+class ADPCMEncoder : public Encoder, public AudioADPCMEncoder {
+public:
+    ADPCMEncoder(int numChannels) : AudioADPCMEncoder(numChannels) {
+        _encodedSize = AudioADPCM::getEncodedSize(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, numChannels);
+    }
+
+    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
+        encodedBuffer.resize(_encodedSize);
+        AudioADPCMEncoder::process((const int16_t*)decodedBuffer.constData(), (uint8_t*)encodedBuffer.data(),
+            AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+private:
+    int _encodedSize;
+};
+
+class ADPCMDecoder : public Decoder, public AudioADPCMDecoder {
+public:
+    ADPCMDecoder(int numChannels) : AudioADPCMDecoder(numChannels) {
+        _decodedSize = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * sizeof(int16_t) * numChannels;
+    }
+
+    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
+        decodedBuffer.resize(_decodedSize);
+        if (!AudioADPCMDecoder::process((const uint8_t*)encodedBuffer.constData(), encodedBuffer.size(),
+                (int16_t*)decodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL)) {
+            // not a frame of this codec, as lost
+            AudioADPCMDecoder::conceal((int16_t*)decodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        }
+    }
+
+    virtual void lostFrame(QByteArray& decodedBuffer) override {
+        decodedBuffer.resize(_decodedSize);
+        // this performs packet loss concealment
+        AudioADPCMDecoder::conceal((int16_t*)decodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    }
+private:
+    int _decodedSize;
+};
+
+Encoder* ADPCMCodec::createEncoder(int sampleRate, int numChannels) {
+    return new ADPCMEncoder(numChannels);
+}
+
+Decoder* ADPCMCodec::createDecoder(int sampleRate, int numChannels) {
+    return new ADPCMDecoder(numChannels);
+}
+
+void ADPCMCodec::releaseEncoder(Encoder* encoder) {
+    delete encoder;
+}
+
+void ADPCMCodec::releaseDecoder(Decoder* decoder) {
+    delete decoder;
+}
@@ -0,0 +1,48 @@
+//
+//  ADPCMCodecProvider.cpp
+//  plugins/adpcmCodec/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <mutex>
+
+#include <QtCore/QObject>
+#include <QtCore/QtPlugin>
+#include <QtCore/QStringList>
+
+#include <plugins/RuntimePlugin.h>
+#include <plugins/CodecPlugin.h>
+
+#include "ADPCMCodec.h"
+
+class ADPCMCodecProvider : public QObject, public CodecProvider {
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID CodecProvider_iid FILE "plugin.json")
+    Q_INTERFACES(CodecProvider)
+
+public:
+    ADPCMCodecProvider(QObject* parent = nullptr) : QObject(parent) {}
+    virtual ~ADPCMCodecProvider() {}
+
+    virtual CodecPluginList getCodecPlugins() override {
+        static std::once_flag once;
+        std::call_once(once, [&] {
+
+            CodecPluginPointer adpcmCodec(new ADPCMCodec());
+            if (adpcmCodec->isSupported()) {
+                _codecPlugins.push_back(adpcmCodec);
+            }
+
+        });
+        return _codecPlugins;
+    }
+
+private:
+    CodecPluginList _codecPlugins;
+};
+
+#include "ADPCMCodecProvider.moc"
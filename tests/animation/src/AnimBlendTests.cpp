@@ -0,0 +1,200 @@
+//
+//  AnimBlendTests.cpp
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimBlendTests.h"
+
+#include <random>
+
+#include <AnimBlendLinear.h>
+#include <AnimDefaultPose.h>
+#include <AnimOverlay.h>
+#include <AnimSkeleton.h>
+#include <AnimUtil.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include <test-utils/QTestExtensions.h>
+
+QTEST_MAIN(AnimBlendTests)
+
+const float TEST_EPSILON = 0.0001f;
+
+// odd size so both the blocked and the remainder paths are used
+const int NUM_TEST_JOINTS = 77;
+
+static std::mt19937 randomEngine(1234);
+
+static float randomFloat(float min, float max) {
+    return std::uniform_real_distribution<float>(min, max)(randomEngine);
+}
+
+static glm::quat randomRotation() {
+    glm::vec3 axis = glm::normalize(glm::vec3(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(0.1f, 1.0f)));
+    glm::quat rot = glm::angleAxis(randomFloat(-PI, PI), axis);
+    // exercise the hemisphere flip
+    return randomFloat(0.0f, 1.0f) < 0.5f ? rot : -rot;
+}
+
+static AnimPoseVec randomPoses(int numPoses) {
+    AnimPoseVec poses;
+    for (int i = 0; i < numPoses; i++) {
+        glm::vec3 scale(randomFloat(0.5f, 2.0f), randomFloat(0.5f, 2.0f), randomFloat(0.5f, 2.0f));
+        glm::vec3 trans(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f));
+        poses.push_back(AnimPose(scale, randomRotation(), trans));
+    }
+    return poses;
+}
+
+static void verifyPose(const AnimPose& actual, const AnimPose& expected) {
+    QCOMPARE_WITH_ABS_ERROR(actual.scale(), expected.scale(), TEST_EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(actual.trans(), expected.trans(), TEST_EPSILON);
+    QCOMPARE_QUATS(actual.rot(), expected.rot(), TEST_EPSILON);
+}
+
+// a humanoid-ish tree: a spine with limbs of five joints hanging off it
+static AnimSkeleton::Pointer makeSkeleton(int numJoints) {
+    std::vector<HFMJoint> joints;
+    HFMJoint joint;
+    joint.isSkeletonJoint = true;
+    joint.preTransform = glm::mat4();
+    joint.preRotation = glm::quat();
+    joint.postRotation = glm::quat();
+    joint.postTransform = glm::mat4();
+    for (int i = 0; i < numJoints; i++) {
+        const int SPINE_LENGTH = 8;
+        const int LIMB_LENGTH = 5;
+        if (i == 0) {
+            joint.parentIndex = -1;
+        } else if (i < SPINE_LENGTH) {
+            joint.parentIndex = i - 1;
+        } else if ((i - SPINE_LENGTH) % LIMB_LENGTH == 0) {
+            joint.parentIndex = (i / LIMB_LENGTH) % SPINE_LENGTH;
+        } else {
+            joint.parentIndex = i - 1;
+        }
+        joint.name = QString("joint%1").arg(i);
+        joint.translation = glm::vec3(0.0f, 0.1f, 0.0f);
+        joint.rotation = randomRotation();
+        joints.push_back(joint);
+    }
+    return std::make_shared<AnimSkeleton>(joints, QMap<int, glm::quat>());
+}
+
+void AnimBlendTests::testBlend() {
+    AnimPoseVec a = randomPoses(NUM_TEST_JOINTS);
+    AnimPoseVec b = randomPoses(NUM_TEST_JOINTS);
+    AnimPoseVec result(NUM_TEST_JOINTS);
+
+    const float alphas[] = { 0.0f, 0.25f, 0.5f, 1.0f };
+    for (float alpha : alphas) {
+        ::blend(NUM_TEST_JOINTS, &a[0], &b[0], alpha, &result[0]);
+        for (int i = 0; i < NUM_TEST_JOINTS; i++) {
+            AnimPose expected(lerp(a[i].scale(), b[i].scale(), alpha), safeLerp(a[i].rot(), b[i].rot(), alpha),
+                              lerp(a[i].trans(), b[i].trans(), alpha));
+            verifyPose(result[i], expected);
+        }
+    }
+
+    // in place, as used by the IK nodes
+    AnimPoseVec inPlace = a;
+    ::blend(NUM_TEST_JOINTS, &inPlace[0], &b[0], 0.5f, &inPlace[0]);
+    ::blend(NUM_TEST_JOINTS, &a[0], &b[0], 0.5f, &result[0]);
+    for (int i = 0; i < NUM_TEST_JOINTS; i++) {
+        verifyPose(inPlace[i], result[i]);
+    }
+}
+
+void AnimBlendTests::testBlendWeighted() {
+    AnimPoseVec a = randomPoses(NUM_TEST_JOINTS);
+    AnimPoseVec b = randomPoses(NUM_TEST_JOINTS);
+    std::vector<float> weights;
+    for (int i = 0; i < NUM_TEST_JOINTS; i++) {
+        weights.push_back(i % 3 == 0 ? 0.0f : randomFloat(0.0f, 1.0f));
+    }
+
+    const float ALPHA = 0.75f;
+    AnimPoseVec result(NUM_TEST_JOINTS);
+    ::blendWeighted(NUM_TEST_JOINTS, &a[0], &b[0], &weights[0], ALPHA, &result[0]);
+    for (int i = 0; i < NUM_TEST_JOINTS; i++) {
+        AnimPose expected;
+        ::blend(1, &a[i], &b[i], weights[i] * ALPHA, &expected);
+        verifyPose(result[i], expected);
+    }
+}
+
+void AnimBlendTests::testConvertRelativeRotationsToAbsolute() {
+    AnimSkeleton::Pointer skeleton = makeSkeleton(NUM_TEST_JOINTS);
+
+    std::vector<glm::quat> rotations;
+    for (int i = 0; i < NUM_TEST_JOINTS; i++) {
+        rotations.push_back(randomRotation());
+    }
+
+    std::vector<glm::quat> expected = rotations;
+    for (int i = 0; i < NUM_TEST_JOINTS; i++) {
+        int parentIndex = skeleton->getParentIndex(i);
+        if (parentIndex != -1) {
+            expected[i] = expected[parentIndex] * expected[i];
+        }
+    }
+
+    skeleton->convertRelativeRotationsToAbsolute(rotations);
+    for (int i = 0; i < NUM_TEST_JOINTS; i++) {
+        QCOMPARE_QUATS(rotations[i], expected[i], TEST_EPSILON);
+    }
+
+    // and back again
+    skeleton->convertAbsoluteRotationsToRelative(rotations);
+    skeleton->convertRelativeRotationsToAbsolute(rotations);
+    for (int i = 0; i < NUM_TEST_JOINTS; i++) {
+        QCOMPARE_QUATS(rotations[i], expected[i], TEST_EPSILON);
+    }
+}
+
+// Evaluates an overlay of a linear blend on top of a default pose, then converts the result to absolute
+// rotations, for many rigs.  This is the shape of the per-avatar work done by Rig::updateAnimations.
+void AnimBlendTests::benchmarkAnimGraph() {
+    const int NUM_RIGS = 200;
+    const int NUM_FRAMES = 10;
+    const int NUM_JOINTS = 120;
+    const float DT = 1.0f / 60.0f;
+
+    AnimSkeleton::Pointer skeleton = makeSkeleton(NUM_JOINTS);
+    std::vector<AnimNode::Pointer> graphs;
+    for (int i = 0; i < NUM_RIGS; i++) {
+        auto blend = std::make_shared<AnimBlendLinear>("blend", 0.5f, AnimBlendLinear::AnimBlendType_Normal);
+        blend->addChild(std::make_shared<AnimDefaultPose>("idle"));
+        blend->addChild(std::make_shared<AnimDefaultPose>("walk"));
+        auto overlay = std::make_shared<AnimOverlay>("overlay", AnimOverlay::FullBodyBoneSet, 0.5f);
+        overlay->addChild(blend);
+        overlay->addChild(std::make_shared<AnimDefaultPose>("base"));
+        overlay->setSkeleton(skeleton);
+        graphs.push_back(overlay);
+    }
+
+    AnimContext context(false, false, false, glm::mat4(), glm::mat4(), 0);
+    AnimVariantMap animVars;
+    AnimVariantMap triggers;
+    std::vector<glm::quat> rotations(NUM_JOINTS);
+
+    quint64 start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (auto& graph : graphs) {
+            const AnimPoseVec& poses = graph->evaluate(animVars, context, DT, triggers);
+            for (int j = 0; j < NUM_JOINTS; j++) {
+                rotations[j] = poses[j].rot();
+            }
+            skeleton->convertRelativeRotationsToAbsolute(rotations);
+        }
+    }
+    quint64 elapsed = usecTimestampNow() - start;
+    qDebug() << NUM_RIGS << "rigs of" << NUM_JOINTS << "joints:" << (float)elapsed / (float)(NUM_FRAMES * NUM_RIGS)
+             << "usecs per rig per frame";
+}
@@ -0,0 +1,24 @@
+//
+//  AnimBlendTests.h
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimBlendTests_h
+#define hifi_AnimBlendTests_h
+
+#include <QtTest/QtTest>
+
+class AnimBlendTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testBlend();
+    void testBlendWeighted();
+    void testConvertRelativeRotationsToAbsolute();
+    void benchmarkAnimGraph();
+};
+
+#endif // hifi_AnimBlendTests_h
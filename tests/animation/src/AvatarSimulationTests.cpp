@@ -0,0 +1,184 @@
+//
+//  AvatarSimulationTests.cpp
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarSimulationTests.h"
+
+#include <memory>
+#include <random>
+
+#include <glm/gtx/transform.hpp>
+
+#include <GLMHelpers.h>
+#include <JointData.h>
+#include <NumericalConstants.h>
+#include <PrioritySortUtil.h>
+#include <Rig.h>
+#include <SharedUtil.h>
+#include <SimulationBatcher.h>
+#include <TBBHelpers.h>
+
+#include <test-utils/QTestExtensions.h>
+
+QTEST_MAIN(AvatarSimulationTests)
+
+const float TEST_EPSILON = 0.0001f;
+
+const int NUM_JOINTS = 80;
+const int NUM_RECORDED_FRAMES = 90;
+
+static std::mt19937 randomEngine(4321);
+
+static float randomFloat(float min, float max) {
+    return std::uniform_real_distribution<float>(min, max)(randomEngine);
+}
+
+// a humanoid-ish tree: a spine with limbs of five joints hanging off it
+static void makeJoints(HFMModel& hfmModel, int numJoints) {
+    HFMJoint joint;
+    joint.isSkeletonJoint = true;
+    joint.preTransform = glm::mat4();
+    joint.preRotation = glm::quat();
+    joint.rotation = glm::quat();
+    joint.postRotation = glm::quat();
+    joint.postTransform = glm::mat4();
+    joint.inverseBindRotation = glm::quat();
+    for (int i = 0; i < numJoints; i++) {
+        const int SPINE_LENGTH = 8;
+        const int LIMB_LENGTH = 5;
+        if (i == 0) {
+            joint.parentIndex = -1;
+        } else if (i < SPINE_LENGTH) {
+            joint.parentIndex = i - 1;
+        } else if ((i - SPINE_LENGTH) % LIMB_LENGTH == 0) {
+            joint.parentIndex = (i / LIMB_LENGTH) % SPINE_LENGTH;
+        } else {
+            joint.parentIndex = i - 1;
+        }
+        joint.name = QString("joint%1").arg(i);
+        joint.translation = glm::vec3(0.0f, 0.1f, 0.0f);
+        joint.transform = (joint.parentIndex == -1 ? glm::mat4() : hfmModel.joints[joint.parentIndex].transform) *
+            glm::translate(joint.translation);
+        joint.bindTransform = joint.transform;
+        hfmModel.joints.push_back(joint);
+    }
+}
+
+// Stands in for a capture of the joint data an avatar mixer sends: every joint sways on its own phase, in the
+// absolute rig frame, with the odd joint left at its default pose as the wire format allows.
+static std::vector<QVector<JointData>> makeRecording(int numJoints, int numFrames) {
+    std::vector<glm::vec3> axes;
+    std::vector<float> phases;
+    for (int i = 0; i < numJoints; i++) {
+        axes.push_back(glm::normalize(glm::vec3(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(0.1f, 1.0f))));
+        phases.push_back(randomFloat(0.0f, TWO_PI));
+    }
+
+    std::vector<QVector<JointData>> recording;
+    for (int frame = 0; frame < numFrames; frame++) {
+        QVector<JointData> jointData(numJoints);
+        for (int i = 0; i < numJoints; i++) {
+            JointData& data = jointData[i];
+            data.rotationIsDefaultPose = (i % 7 == 3);
+            data.rotation = glm::angleAxis(0.5f * sinf(phases[i] + TWO_PI * (float)frame / (float)numFrames), axes[i]);
+            data.translationIsDefaultPose = (i != 0);
+            data.translation = glm::vec3(0.0f, 0.01f * (float)frame, 0.0f);
+        }
+        recording.push_back(jointData);
+    }
+    return recording;
+}
+
+static std::vector<std::unique_ptr<Rig>> makeRigs(int numRigs) {
+    HFMModel hfmModel;
+    makeJoints(hfmModel, NUM_JOINTS);
+    std::vector<std::unique_ptr<Rig>> rigs;
+    for (int i = 0; i < numRigs; i++) {
+        rigs.emplace_back(new Rig());
+        rigs.back()->initJointStates(hfmModel, glm::mat4());
+    }
+    return rigs;
+}
+
+// The part of OtherAvatar::simulate that AvatarManager hands to worker threads
+static void computeJointPoses(Rig& rig, const QVector<JointData>& jointData) {
+    rig.copyJointsFromJointData(jointData);
+    rig.computeExternalPoses(glm::mat4());
+}
+
+// Batches as AvatarManager::updateOtherAvatars does, with its batcher: rigs are taken in order, a batch at a time, until
+// the budget runs out.  Returns the number of rigs updated.
+static size_t simulateFrame(std::vector<std::unique_ptr<Rig>>& rigs, const std::vector<QVector<JointData>>& recording,
+                            int frame, bool concurrent, uint64_t budget, SimulationBatcher& batcher) {
+    return batcher.simulate(rigs.size(), usecTimestampNow() + budget, [&](size_t begin, size_t end) {
+        auto update = [&](size_t i) {
+            computeJointPoses(*rigs[i], recording[(frame + i) % recording.size()]);
+        };
+        if (concurrent) {
+            tbb::parallel_for(tbb::blocked_range<size_t>(begin, end), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); i++) {
+                    update(i);
+                }
+            });
+        } else {
+            for (size_t i = begin; i < end; i++) {
+                update(i);
+            }
+        }
+    });
+}
+
+void AvatarSimulationTests::testBatchedJointPoses() {
+    const int NUM_RIGS = 37;
+    auto recording = makeRecording(NUM_JOINTS, NUM_RECORDED_FRAMES);
+    auto serialRigs = makeRigs(NUM_RIGS);
+    auto concurrentRigs = makeRigs(NUM_RIGS);
+
+    const uint64_t UNLIMITED_BUDGET = USECS_PER_SECOND * 60;
+    SimulationBatcher serialBatcher;
+    SimulationBatcher concurrentBatcher;
+    for (int frame = 0; frame < 3; frame++) {
+        QCOMPARE(simulateFrame(serialRigs, recording, frame, false, UNLIMITED_BUDGET, serialBatcher), (size_t)NUM_RIGS);
+        QCOMPARE(simulateFrame(concurrentRigs, recording, frame, true, UNLIMITED_BUDGET, concurrentBatcher), (size_t)NUM_RIGS);
+    }
+    // nothing is simulated once the budget is spent
+    QCOMPARE(simulateFrame(concurrentRigs, recording, 0, true, 0, concurrentBatcher), (size_t)0);
+
+    for (int i = 0; i < NUM_RIGS; i++) {
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            AnimPose expected = serialRigs[i]->getJointPose(j);
+            AnimPose actual = concurrentRigs[i]->getJointPose(j);
+            QCOMPARE_QUATS(actual.rot(), expected.rot(), TEST_EPSILON);
+            QCOMPARE_WITH_ABS_ERROR(actual.trans(), expected.trans(), TEST_EPSILON);
+        }
+    }
+}
+
+// Replays recorded joint data into crowds of rigs under the other avatar time budget and reports the cost of a
+// frame and the fraction of the crowd that got a fresh pose, with and without the concurrent batches.
+void AvatarSimulationTests::benchmarkOtherAvatars() {
+    const int NUM_FRAMES = 120;
+    const int crowdSizes[] = { 25, 100, 400 };
+
+    auto recording = makeRecording(NUM_JOINTS, NUM_RECORDED_FRAMES);
+    for (int numAvatars : crowdSizes) {
+        for (bool concurrent : { false, true }) {
+            auto rigs = makeRigs(numAvatars);
+            SimulationBatcher batcher;
+            size_t numUpdated = 0;
+            uint64_t start = usecTimestampNow();
+            for (int frame = 0; frame < NUM_FRAMES; frame++) {
+                numUpdated += simulateFrame(rigs, recording, frame, concurrent, MAX_UPDATE_AVATARS_TIME_BUDGET, batcher);
+            }
+            uint64_t elapsed = usecTimestampNow() - start;
+            qDebug() << numAvatars << "avatars," << (concurrent ? "concurrent:" : "serial:")
+                     << (float)elapsed / (float)NUM_FRAMES << "usecs per frame,"
+                     << (float)numUpdated / (float)(NUM_FRAMES * numAvatars) << "of avatars updated per frame";
+        }
+    }
+}
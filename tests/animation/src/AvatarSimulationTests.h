@@ -0,0 +1,22 @@
+//
+//  AvatarSimulationTests.h
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarSimulationTests_h
+#define hifi_AvatarSimulationTests_h
+
+#include <QtTest/QtTest>
+
+class AvatarSimulationTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testBatchedJointPoses();
+    void benchmarkOtherAvatars();
+};
+
+#endif // hifi_AvatarSimulationTests_h
@@ -0,0 +1,220 @@
+//
+//  AudioADPCMTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioADPCMTests.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <AudioADPCM.h>
+#include <AudioConstants.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioADPCMTests)
+
+static const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+static const int NUM_CHANNELS = AudioConstants::STEREO;
+
+// stereo speech-like test audio: harmonics of a gliding pitch, a tone, and noise
+static std::vector<int16_t> makeTestAudio(int numNetworkFrames) {
+    std::vector<int16_t> samples(numNetworkFrames * NUM_FRAMES * NUM_CHANNELS);
+    std::mt19937 generator;
+    std::normal_distribution<float> noise(0.0f, 300.0f);
+    float phase = 0.0f;
+    for (int i = 0; i < numNetworkFrames * NUM_FRAMES; i++) {
+        float t = i / (float)AudioConstants::SAMPLE_RATE;
+        float pitch = 150.0f + 50.0f * sinf(TWO_PI * 0.5f * t);
+        phase += TWO_PI * pitch / AudioConstants::SAMPLE_RATE;
+        float voice = 0.0f;
+        for (int harmonic = 1; harmonic <= 8; harmonic++) {
+            voice += (4000.0f / harmonic) * sinf(harmonic * phase);
+        }
+        float tone = 2000.0f * sinf(TWO_PI * 1375.0f * t);
+        samples[i * NUM_CHANNELS + 0] = (int16_t)(voice + tone + noise(generator));
+        samples[i * NUM_CHANNELS + 1] = (int16_t)(0.5f * voice - tone + noise(generator));
+    }
+    return samples;
+}
+
+// the signal to noise ratio of decoded against its source, in dB
+static float signalToNoise(const int16_t* source, const int16_t* decoded, int numSamples) {
+    double signal = 0.0;
+    double noise = 0.0;
+    for (int i = 0; i < numSamples; i++) {
+        double error = (double)source[i] - decoded[i];
+        signal += (double)source[i] * source[i];
+        noise += error * error;
+    }
+    return (noise == 0.0) ? INFINITY : (float)(10.0 * log10(signal / noise));
+}
+
+void AudioADPCMTests::testRoundTrip() {
+    const int NUM_NETWORK_FRAMES = 100;
+    const float MIN_SIGNAL_TO_NOISE = 25.0f;
+
+    std::vector<int16_t> source = makeTestAudio(NUM_NETWORK_FRAMES);
+    std::vector<int16_t> decoded(source.size());
+    int encodedSize = AudioADPCM::getEncodedSize(NUM_FRAMES, NUM_CHANNELS);
+    QVERIFY(encodedSize * 3 < NUM_FRAMES * NUM_CHANNELS * (int)sizeof(int16_t));
+
+    AudioADPCMEncoder encoder(NUM_CHANNELS);
+    AudioADPCMDecoder decoder(NUM_CHANNELS);
+    std::vector<uint8_t> encoded(encodedSize);
+    for (int frame = 0; frame < NUM_NETWORK_FRAMES; frame++) {
+        int offset = frame * NUM_FRAMES * NUM_CHANNELS;
+        encoder.process(&source[offset], encoded.data(), NUM_FRAMES);
+        QVERIFY(decoder.process(encoded.data(), encodedSize, &decoded[offset], NUM_FRAMES));
+    }
+    QVERIFY(signalToNoise(source.data(), decoded.data(), (int)source.size()) > MIN_SIGNAL_TO_NOISE);
+
+    // frames decode on their own
+    AudioADPCMDecoder lateDecoder(NUM_CHANNELS);
+    std::vector<int16_t> lateDecoded(NUM_FRAMES * NUM_CHANNELS);
+    QVERIFY(lateDecoder.process(encoded.data(), encodedSize, lateDecoded.data(), NUM_FRAMES));
+    QCOMPARE(lateDecoded, std::vector<int16_t>(decoded.end() - NUM_FRAMES * NUM_CHANNELS, decoded.end()));
+
+    // frames of another size are not decoded
+    QVERIFY(!decoder.process(encoded.data(), encodedSize - 1, lateDecoded.data(), NUM_FRAMES));
+}
+
+void AudioADPCMTests::testExtremes() {
+    int encodedSize = AudioADPCM::getEncodedSize(NUM_FRAMES, NUM_CHANNELS);
+    std::vector<uint8_t> encoded(encodedSize);
+    std::vector<int16_t> source(NUM_FRAMES * NUM_CHANNELS, 0);
+    std::vector<int16_t> decoded(NUM_FRAMES * NUM_CHANNELS, 1);
+
+    // silence is exact
+    AudioADPCMEncoder encoder(NUM_CHANNELS);
+    AudioADPCMDecoder decoder(NUM_CHANNELS);
+    encoder.process(source.data(), encoded.data(), NUM_FRAMES);
+    QVERIFY(decoder.process(encoded.data(), encodedSize, decoded.data(), NUM_FRAMES));
+    QCOMPARE(decoded, source);
+
+    // full scale square waves, of opposite phase, stay in range and close
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        source[i * NUM_CHANNELS + 0] = ((i / 12) & 1) ? 32767 : -32768;
+        source[i * NUM_CHANNELS + 1] = ((i / 12) & 1) ? -32768 : 32767;
+    }
+    for (int frame = 0; frame < 2; frame++) {
+        encoder.process(source.data(), encoded.data(), NUM_FRAMES);
+        QVERIFY(decoder.process(encoded.data(), encodedSize, decoded.data(), NUM_FRAMES));
+    }
+    QVERIFY(signalToNoise(source.data(), decoded.data(), (int)source.size()) > 15.0f);
+}
+
+void AudioADPCMTests::testConcealment() {
+    const int NUM_NETWORK_FRAMES = 10;
+
+    std::vector<int16_t> source = makeTestAudio(NUM_NETWORK_FRAMES);
+    int encodedSize = AudioADPCM::getEncodedSize(NUM_FRAMES, NUM_CHANNELS);
+    std::vector<uint8_t> encoded(encodedSize);
+    std::vector<int16_t> decoded(NUM_FRAMES * NUM_CHANNELS);
+    AudioADPCMEncoder encoder(NUM_CHANNELS);
+    AudioADPCMDecoder decoder(NUM_CHANNELS);
+
+    auto getPeak = [](const std::vector<int16_t>& samples, int begin, int end) {
+        int peak = 0;
+        for (int i = begin; i < end; i++) {
+            peak = std::max(peak, std::abs((int)samples[i]));
+        }
+        return peak;
+    };
+
+    encoder.process(&source[0], encoded.data(), NUM_FRAMES);
+    QVERIFY(decoder.process(encoded.data(), encodedSize, decoded.data(), NUM_FRAMES));
+    int16_t lastLeft = decoded[(NUM_FRAMES - 1) * NUM_CHANNELS];
+
+    // a lost frame continues from where the last one ended, and fades to silence after CONCEALED_FRAMES
+    decoder.conceal(decoded.data(), NUM_FRAMES);
+    QVERIFY(std::abs(decoded[0] - lastLeft) < 1000);
+    int previousPeak = getPeak(decoded, 0, (int)decoded.size());
+    QVERIFY(previousPeak > 0);
+    for (int frame = 1; frame < AudioADPCMDecoder::CONCEALED_FRAMES; frame++) {
+        decoder.conceal(decoded.data(), NUM_FRAMES);
+        int peak = getPeak(decoded, 0, (int)decoded.size());
+        QVERIFY(peak < previousPeak);
+        previousPeak = peak;
+    }
+    decoder.conceal(decoded.data(), NUM_FRAMES);
+    QCOMPARE(getPeak(decoded, 0, (int)decoded.size()), 0);
+
+    // the next frame fades in from the concealment, and is decoded past that
+    std::vector<int16_t> expected(NUM_FRAMES * NUM_CHANNELS);
+    int offset = 5 * NUM_FRAMES * NUM_CHANNELS;
+    encoder.process(&source[offset], encoded.data(), NUM_FRAMES);
+    AudioADPCMDecoder(NUM_CHANNELS).process(encoded.data(), encodedSize, expected.data(), NUM_FRAMES);
+    QVERIFY(decoder.process(encoded.data(), encodedSize, decoded.data(), NUM_FRAMES));
+    QVERIFY(std::abs(decoded[0]) <= std::abs(expected[0]));
+    int crossfadeEnd = AudioADPCMDecoder::CROSSFADE_SAMPLES * NUM_CHANNELS;
+    QCOMPARE(std::vector<int16_t>(decoded.begin() + crossfadeEnd, decoded.end()),
+        std::vector<int16_t>(expected.begin() + crossfadeEnd, expected.end()));
+
+    // concealing before anything was decoded is silence
+    AudioADPCMDecoder newDecoder(NUM_CHANNELS);
+    newDecoder.conceal(decoded.data(), NUM_FRAMES);
+    QCOMPARE(getPeak(decoded, 0, (int)decoded.size()), 0);
+}
+
+// Times encoding and decoding a 10ms stereo frame, as the mixer does for each listener, with this codec and with
+// zlib, and compares the quality of each with the PCM they were given.
+void AudioADPCMTests::benchmarkCodecs() {
+    const int NUM_NETWORK_FRAMES = 1000;
+    const int FRAME_BYTES = NUM_FRAMES * NUM_CHANNELS * (int)sizeof(int16_t);
+
+    std::vector<int16_t> source = makeTestAudio(NUM_NETWORK_FRAMES);
+    std::vector<int16_t> decoded(source.size());
+
+    // ADPCM
+    {
+        AudioADPCMEncoder encoder(NUM_CHANNELS);
+        AudioADPCMDecoder decoder(NUM_CHANNELS);
+        int encodedSize = AudioADPCM::getEncodedSize(NUM_FRAMES, NUM_CHANNELS);
+        std::vector<uint8_t> encoded(encodedSize);
+        quint64 encodeUsecs = 0;
+        quint64 decodeUsecs = 0;
+        for (int frame = 0; frame < NUM_NETWORK_FRAMES; frame++) {
+            int offset = frame * NUM_FRAMES * NUM_CHANNELS;
+            quint64 start = usecTimestampNow();
+            encoder.process(&source[offset], encoded.data(), NUM_FRAMES);
+            quint64 split = usecTimestampNow();
+            decoder.process(encoded.data(), encodedSize, &decoded[offset], NUM_FRAMES);
+            decodeUsecs += usecTimestampNow() - split;
+            encodeUsecs += split - start;
+        }
+        float signalToNoiseRatio = signalToNoise(source.data(), decoded.data(), (int)source.size());
+        qDebug() << "adpcm:" << (float)encodeUsecs / NUM_NETWORK_FRAMES << "usecs to encode,"
+            << (float)decodeUsecs / NUM_NETWORK_FRAMES << "usecs to decode a frame," << encodedSize << "of" << FRAME_BYTES
+            << "bytes," << signalToNoiseRatio << "dB signal to noise";
+    }
+
+    // zlib, as the pcmCodec plugin does it
+    {
+        quint64 encodeUsecs = 0;
+        quint64 decodeUsecs = 0;
+        quint64 encodedBytes = 0;
+        for (int frame = 0; frame < NUM_NETWORK_FRAMES; frame++) {
+            int offset = frame * NUM_FRAMES * NUM_CHANNELS;
+            QByteArray pcm = QByteArray::fromRawData((const char*)&source[offset], FRAME_BYTES);
+            quint64 start = usecTimestampNow();
+            QByteArray compressed = qCompress(pcm);
+            quint64 split = usecTimestampNow();
+            QByteArray uncompressed = qUncompress(compressed);
+            decodeUsecs += usecTimestampNow() - split;
+            encodeUsecs += split - start;
+            encodedBytes += compressed.size();
+            QCOMPARE(uncompressed, pcm);
+        }
+        qDebug() << "zlib: " << (float)encodeUsecs / NUM_NETWORK_FRAMES << "usecs to encode,"
+            << (float)decodeUsecs / NUM_NETWORK_FRAMES << "usecs to decode a frame,"
+            << (float)encodedBytes / NUM_NETWORK_FRAMES << "of" << FRAME_BYTES << "bytes, lossless";
+    }
+}
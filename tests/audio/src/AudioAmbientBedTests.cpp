@@ -0,0 +1,256 @@
+//
+//  AudioAmbientBedTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioAmbientBedTests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <glm/gtx/norm.hpp>
+
+#include <AudioAmbientBed.h>
+#include <AudioHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioAmbientBedTests)
+
+static const int HRTF_DATASET_INDEX = 1;
+
+// a frame of a tone and noise
+static void makeFrame(int16_t* samples, float frequency, int frame, std::mt19937& generator) {
+    std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+    for (int i = 0; i < HRTF_BLOCK; i++) {
+        float t = (float)(frame * HRTF_BLOCK + i);
+        samples[i] = (int16_t)(8192.0f * (sinf(TWO_PI * frequency * t) + noise(generator)));
+    }
+}
+
+// as the mixer computes it
+static float computeAzimuth(const glm::quat& listenerOrientation, const glm::vec3& relativePosition) {
+    glm::vec3 rotatedSourcePosition = glm::inverse(listenerOrientation) * relativePosition;
+    rotatedSourcePosition.y = 0.0f;
+
+    float length2 = glm::length2(rotatedSourcePosition);
+    if (length2 > 1e-30f) {
+        glm::vec3 direction = rotatedSourcePosition * (1.0f / fastSqrtf(length2));
+        float angle = fastAcosf(glm::clamp(-direction.z, -1.0f, 1.0f));
+        return (direction.x < 0.0f) ? -angle : angle;
+    }
+    return 0.0f;
+}
+
+void AudioAmbientBedTests::testSingleSource() {
+    const glm::vec3 CENTER(10.0f, 0.0f, 10.0f);
+    const glm::vec3 SOURCE(13.0f, 1.0f, 8.0f);
+    const glm::vec3 LISTENER(9.0f, 0.0f, 12.0f);
+    const glm::quat ORIENTATION = glm::angleAxis(0.7f, glm::vec3(0.0f, 1.0f, 0.0f));
+    const float GAIN = 0.5f;
+
+    AudioAmbientBed bed(CENTER);
+    AudioAmbientBed::Listener listener;
+    AudioHRTF hrtf;
+
+    std::mt19937 generator;
+    int16_t samples[HRTF_BLOCK];
+    float bedOutput[2 * HRTF_BLOCK];
+    float hrtfOutput[2 * HRTF_BLOCK];
+
+    glm::vec3 relativePosition = SOURCE - LISTENER;
+    float azimuth = computeAzimuth(ORIENTATION, relativePosition);
+    float distance = glm::length(relativePosition);
+
+    // a lone source at unity gain is rendered as it would be on its own
+    for (int frame = 0; frame < 10; frame++) {
+        makeFrame(samples, 0.01f, frame, generator);
+
+        bed.clear();
+        bed.addSource(samples, SOURCE, 1.0f);
+        bed.finish();
+        QCOMPARE(bed.getNumSources(), 1);
+
+        memset(bedOutput, 0, sizeof(bedOutput));
+        memset(hrtfOutput, 0, sizeof(hrtfOutput));
+        QCOMPARE(bed.render(listener, LISTENER, ORIENTATION, HRTF_DATASET_INDEX, GAIN, bedOutput), 1);
+        hrtf.render(samples, hrtfOutput, HRTF_DATASET_INDEX, azimuth, distance, GAIN, HRTF_BLOCK);
+
+        for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+            QCOMPARE(bedOutput[i], hrtfOutput[i]);
+        }
+    }
+}
+
+void AudioAmbientBedTests::testSectors() {
+    const glm::vec3 CENTER(0.0f);
+    const glm::quat FORWARD;
+
+    AudioAmbientBed bed(CENTER);
+    AudioAmbientBed::Listener listener;
+
+    std::mt19937 generator;
+    int16_t samples[HRTF_BLOCK];
+    float output[2 * HRTF_BLOCK];
+
+    // sources to the left of the center share a sector, and are heard on the left
+    for (int frame = 0; frame < 10; frame++) {
+        bed.clear();
+        makeFrame(samples, 0.01f, frame, generator);
+        bed.addSource(samples, glm::vec3(-5.0f, 0.0f, 0.5f), 0.5f);
+        makeFrame(samples, 0.02f, frame, generator);
+        bed.addSource(samples, glm::vec3(-4.0f, 2.0f, -0.5f), 0.5f);
+        bed.finish();
+        QCOMPARE(bed.getNumSources(), 2);
+
+        memset(output, 0, sizeof(output));
+        QCOMPARE(bed.render(listener, CENTER, FORWARD, HRTF_DATASET_INDEX, 1.0f, output), 1);
+    }
+
+    float left = 0.0f;
+    float right = 0.0f;
+    for (int i = 0; i < HRTF_BLOCK; i++) {
+        left += output[2 * i + 0] * output[2 * i + 0];
+        right += output[2 * i + 1] * output[2 * i + 1];
+    }
+    QVERIFY(left > 2.0f * right);
+
+    // while sources around the center each take one
+    bed.clear();
+    for (int i = 0; i < AudioAmbientBed::NUM_SECTORS; i++) {
+        float angle = i * (TWO_PI / AudioAmbientBed::NUM_SECTORS);
+        makeFrame(samples, 0.01f * (i + 1), 0, generator);
+        bed.addSource(samples, glm::vec3(3.0f * sinf(angle), 0.0f, -3.0f * cosf(angle)), 0.25f);
+    }
+    bed.finish();
+
+    memset(output, 0, sizeof(output));
+    QCOMPARE(bed.render(listener, CENTER, FORWARD, HRTF_DATASET_INDEX, 1.0f, output), AudioAmbientBed::NUM_SECTORS);
+}
+
+void AudioAmbientBedTests::testSilentSector() {
+    const glm::vec3 CENTER(0.0f);
+    const glm::quat FORWARD;
+
+    AudioAmbientBed bed(CENTER);
+    AudioAmbientBed::Listener listener;
+
+    std::mt19937 generator;
+    int16_t samples[HRTF_BLOCK];
+    float output[2 * HRTF_BLOCK];
+
+    bed.clear();
+    makeFrame(samples, 0.01f, 0, generator);
+    bed.addSource(samples, glm::vec3(2.0f, 0.0f, -2.0f), 1.0f);
+    bed.finish();
+
+    memset(output, 0, sizeof(output));
+    QCOMPARE(bed.render(listener, CENTER, FORWARD, HRTF_DATASET_INDEX, 1.0f, output), 1);
+
+    // a sector that goes silent flushes the tail of its last frame, once
+    bed.clear();
+    bed.finish();
+    QVERIFY(bed.isEmpty());
+
+    memset(output, 0, sizeof(output));
+    QCOMPARE(bed.render(listener, CENTER, FORWARD, HRTF_DATASET_INDEX, 1.0f, output), 1);
+
+    bool hasTail = false;
+    for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+        hasTail |= (output[i] != 0.0f);
+    }
+    QVERIFY(hasTail);
+
+    memset(output, 0, sizeof(output));
+    QCOMPARE(bed.render(listener, CENTER, FORWARD, HRTF_DATASET_INDEX, 1.0f, output), 0);
+    for (int i = 0; i < 2 * HRTF_BLOCK; i++) {
+        QCOMPARE(output[i], 0.0f);
+    }
+}
+
+void AudioAmbientBedTests::benchmarkStaticInjectors() {
+    const int NUM_SOURCES = 200;
+    const int NUM_LISTENERS = 100;
+    const int NUM_FRAMES = 10;
+    const float ZONE_RADIUS = 20.0f;
+
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> position(-ZONE_RADIUS, ZONE_RADIUS);
+    std::uniform_real_distribution<float> angle(-PI, PI);
+
+    std::vector<glm::vec3> sourcePositions(NUM_SOURCES);
+    for (auto& sourcePosition : sourcePositions) {
+        sourcePosition = glm::vec3(position(generator), 0.0f, position(generator));
+    }
+    std::vector<glm::vec3> listenerPositions(NUM_LISTENERS);
+    std::vector<glm::quat> listenerOrientations(NUM_LISTENERS);
+    for (int i = 0; i < NUM_LISTENERS; i++) {
+        listenerPositions[i] = glm::vec3(position(generator), 1.5f, position(generator));
+        listenerOrientations[i] = glm::angleAxis(angle(generator), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    // the HRTF state of each source for each listener, as the mixer keeps it today
+    std::unique_ptr<AudioHRTF[]> hrtfs(new AudioHRTF[NUM_SOURCES * NUM_LISTENERS]);
+    std::unique_ptr<AudioAmbientBed::Listener[]> bedListeners(new AudioAmbientBed::Listener[NUM_LISTENERS]);
+    AudioAmbientBed bed(glm::vec3(0.0f));
+
+    std::vector<int16_t> samples(NUM_SOURCES * HRTF_BLOCK);
+    float output[2 * HRTF_BLOCK];
+
+    quint64 directUsecs = 0;
+    quint64 bedUsecs = 0;
+    int numDirectRenders = 0;
+    int numBedRenders = 0;
+
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int source = 0; source < NUM_SOURCES; source++) {
+            makeFrame(&samples[source * HRTF_BLOCK], 0.001f * (source + 1), frame, generator);
+        }
+
+        quint64 start = usecTimestampNow();
+        for (int listener = 0; listener < NUM_LISTENERS; listener++) {
+            memset(output, 0, sizeof(output));
+            for (int source = 0; source < NUM_SOURCES; source++) {
+                glm::vec3 relativePosition = sourcePositions[source] - listenerPositions[listener];
+                float azimuth = computeAzimuth(listenerOrientations[listener], relativePosition);
+                float distance = glm::max(glm::length(relativePosition), EPSILON);
+                hrtfs[listener * NUM_SOURCES + source].render(&samples[source * HRTF_BLOCK], output, HRTF_DATASET_INDEX,
+                                                              azimuth, distance, 1.0f / distance, HRTF_BLOCK);
+                ++numDirectRenders;
+            }
+        }
+        quint64 split = usecTimestampNow();
+
+        // summed once a frame, and rendered for each listener
+        bed.clear();
+        for (int source = 0; source < NUM_SOURCES; source++) {
+            float distance = glm::max(glm::length(sourcePositions[source]), 1.0f);
+            bed.addSource(&samples[source * HRTF_BLOCK], sourcePositions[source], 1.0f / distance);
+        }
+        bed.finish();
+        for (int listener = 0; listener < NUM_LISTENERS; listener++) {
+            memset(output, 0, sizeof(output));
+            numBedRenders += bed.render(bedListeners[listener], listenerPositions[listener],
+                                        listenerOrientations[listener], HRTF_DATASET_INDEX, 1.0f, output);
+        }
+
+        bedUsecs += usecTimestampNow() - split;
+        directUsecs += split - start;
+    }
+    QVERIFY(numBedRenders <= NUM_FRAMES * NUM_LISTENERS * AudioAmbientBed::NUM_SECTORS);
+
+    qDebug() << NUM_SOURCES << "static injectors," << NUM_LISTENERS << "listeners:";
+    qDebug() << "  direct:" << (float)directUsecs / NUM_FRAMES << "usecs a frame,"
+        << numDirectRenders / NUM_FRAMES << "HRTF renders";
+    qDebug() << "  bed:   " << (float)bedUsecs / NUM_FRAMES << "usecs a frame,"
+        << numBedRenders / NUM_FRAMES << "HRTF renders,"
+        << (float)directUsecs / std::max(bedUsecs, (quint64)1) << "times faster";
+}
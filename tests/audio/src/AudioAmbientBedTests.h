@@ -0,0 +1,26 @@
+//
+//  AudioAmbientBedTests.h
+//  tests/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioAmbientBedTests_h
+#define hifi_AudioAmbientBedTests_h
+
+#include <QtTest/QtTest>
+
+class AudioAmbientBedTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testSingleSource();
+    void testSectors();
+    void testSilentSector();
+    void benchmarkStaticInjectors();
+};
+
+#endif // hifi_AudioAmbientBedTests_h
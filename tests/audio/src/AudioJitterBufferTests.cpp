@@ -0,0 +1,543 @@
+//
+//  AudioJitterBufferTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioJitterBufferTests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <AudioConstants.h>
+#include <AudioJitterBuffer.h>
+#include <AudioRingBufferSPSC.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AudioJitterBufferTests)
+
+static const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+static const int NUM_CHANNELS = AudioConstants::STEREO;
+static const int SAMPLE_RATE = AudioConstants::SAMPLE_RATE;
+static const int READ_FRAMES = 256;     // a device period, that is not a multiple of the network frame
+static const double PACKET_USECS = NUM_FRAMES * (double)USECS_PER_SECOND / SAMPLE_RATE;
+static const double READ_USECS = READ_FRAMES * (double)USECS_PER_SECOND / SAMPLE_RATE;
+
+void AudioJitterBufferTests::testRingBuffer() {
+    const int CAPACITY = 1000;  // not a power of two
+
+    AudioRingBufferSPSC<int16_t> ringBuffer(CAPACITY);
+    std::vector<int16_t> source(CAPACITY);
+    std::vector<int16_t> destination(CAPACITY);
+    std::iota(source.begin(), source.end(), 0);
+
+    // wrap around the end of the buffer, at many offsets
+    for (int i = 0; i < 50; i++) {
+        int numSamples = 300 + (i * 37) % 500;
+        QCOMPARE(ringBuffer.writeSamples(source.data(), numSamples), numSamples);
+        QCOMPARE(ringBuffer.samplesAvailable(), numSamples);
+        QCOMPARE(ringBuffer.readSamples(destination.data(), CAPACITY), numSamples);
+        QVERIFY(std::equal(source.begin(), source.begin() + numSamples, destination.begin()));
+    }
+
+    // a write that does not fit is cut short, and counted, leaving what is unread alone
+    QCOMPARE(ringBuffer.writeSamples(source.data(), CAPACITY - 10), CAPACITY - 10);
+    QCOMPARE(ringBuffer.writeSamples(source.data(), 100), 10);
+    QCOMPARE(ringBuffer.getOverflowCount(), 1);
+    QCOMPARE(ringBuffer.spaceAvailable(), 0);
+    QCOMPARE(ringBuffer.readSamples(destination.data(), CAPACITY), CAPACITY);
+    QVERIFY(std::equal(source.begin(), source.end() - 10, destination.begin()));
+    QVERIFY(std::equal(source.begin(), source.begin() + 10, destination.end() - 10));
+
+    QCOMPARE(ringBuffer.addSilentSamples(50), 50);
+    QCOMPARE(ringBuffer.skipSamples(20), 20);
+    QCOMPARE(ringBuffer.readSamples(destination.data(), CAPACITY), 30);
+    QCOMPARE(destination[0], (int16_t)0);
+
+    ringBuffer.writeSamples(source.data(), 100);
+    ringBuffer.clear();
+    QCOMPARE(ringBuffer.samplesAvailable(), 0);
+    QCOMPARE(ringBuffer.spaceAvailable(), CAPACITY);
+}
+
+void AudioJitterBufferTests::testRingBufferThreads() {
+    const int NUM_SAMPLES = 4 * 1000 * 1000;
+    const int MAX_CHUNK_SAMPLES = 256;
+
+    AudioRingBufferSPSC<int16_t> ringBuffer(999);
+
+    std::thread producer([&] {
+        std::mt19937 generator(1);
+        std::vector<int16_t> chunk(MAX_CHUNK_SAMPLES);
+        int next = 0;
+        while (next < NUM_SAMPLES) {
+            int numSamples = std::min(1 + (int)(generator() % MAX_CHUNK_SAMPLES), NUM_SAMPLES - next);
+            for (int i = 0; i < numSamples; i++) {
+                chunk[i] = (int16_t)(next + i);
+            }
+            int numWritten = ringBuffer.writeSamples(chunk.data(), numSamples);
+            next += numWritten;
+            if (numWritten == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // every sample arrives once, in order
+    std::mt19937 generator(2);
+    std::vector<int16_t> chunk(MAX_CHUNK_SAMPLES);
+    int expected = 0;
+    bool isOrdered = true;
+    while (expected < NUM_SAMPLES && isOrdered) {
+        int numRead = ringBuffer.readSamples(chunk.data(), 1 + (int)(generator() % MAX_CHUNK_SAMPLES));
+        for (int i = 0; i < numRead; i++) {
+            isOrdered &= (chunk[i] == (int16_t)expected++);
+        }
+        if (numRead == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    QVERIFY(isOrdered);
+    QCOMPARE(expected, NUM_SAMPLES);
+    QCOMPARE(ringBuffer.samplesAvailable(), 0);
+}
+
+// a stereo tone, continued across calls
+class ToneSource {
+public:
+    void render(int16_t* output, int numFrames) {
+        for (int i = 0; i < numFrames; i++) {
+            float sample = 10000.0f * sinf(_phase);
+            output[i * NUM_CHANNELS + 0] = (int16_t)sample;
+            output[i * NUM_CHANNELS + 1] = (int16_t)-sample;
+            _phase = fmodf(_phase + TWO_PI * 100.0f / SAMPLE_RATE, TWO_PI);
+        }
+    }
+
+private:
+    float _phase { 0.0f };
+};
+
+// the largest step between consecutive samples of a channel, which a dropped or repeated chunk would show up in
+static int maxStep(const int16_t* samples, int numFrames, int16_t& lastSample) {
+    int step = 0;
+    for (int i = 0; i < numFrames; i++) {
+        step = std::max(step, std::abs(samples[i * NUM_CHANNELS] - lastSample));
+        lastSample = samples[i * NUM_CHANNELS];
+    }
+    return step;
+}
+
+void AudioJitterBufferTests::testStretch() {
+    // a 100Hz tone moves at most this much from one sample to the next, even stretched
+    const int MAX_TONE_STEP = 300;
+    const int NUM_READS = 2000;
+
+    // a sender whose clock runs slow or fast is followed without starves, adding at most the drift over the window
+    const float DRIFT = 0.005f;
+    const int DRIFT_FRAMES = (int)(DRIFT * AudioJitterBuffer::WINDOW_MSECS * SAMPLE_RATE / 1000);
+    for (float drift : { -DRIFT, DRIFT }) {
+        AudioJitterBuffer jitterBuffer(NUM_CHANNELS, SAMPLE_RATE);
+        ToneSource source;
+        std::vector<int16_t> input(2 * READ_FRAMES * NUM_CHANNELS);
+        std::vector<int16_t> output(READ_FRAMES * NUM_CHANNELS);
+
+        int numPrimingFrames = READ_FRAMES + AudioJitterBuffer::SAFETY_MSECS * SAMPLE_RATE / 1000;
+        source.render(input.data(), numPrimingFrames);
+        jitterBuffer.write(input.data(), numPrimingFrames);
+
+        int16_t lastSample = 0;
+        int step = 0;
+        int maxFramesAvailable = 0;
+        double sentFrames = 0.0;
+        int numSentFrames = 0;
+        for (int i = 0; i < NUM_READS; i++) {
+            QVERIFY(jitterBuffer.read(output.data(), READ_FRAMES));
+            if (i > 0) {
+                step = std::max(step, maxStep(output.data(), READ_FRAMES, lastSample));
+            } else {
+                lastSample = output[(READ_FRAMES - 1) * NUM_CHANNELS];
+            }
+
+            sentFrames += READ_FRAMES * (1.0 + drift);
+            int numFrames = (int)sentFrames - numSentFrames;
+            numSentFrames += numFrames;
+            source.render(input.data(), numFrames);
+            jitterBuffer.write(input.data(), numFrames);
+            maxFramesAvailable = std::max(maxFramesAvailable, jitterBuffer.getFramesAvailable());
+        }
+
+        QCOMPARE(jitterBuffer.getStarveCount(), 0);
+        QCOMPARE(jitterBuffer.getDroppedFrames(), 0);
+        QVERIFY(step < MAX_TONE_STEP);
+        QVERIFY(maxFramesAvailable < numPrimingFrames + READ_FRAMES + DRIFT_FRAMES);
+    }
+
+    // an excess of latency is compressed away, continuously
+    {
+        const int EXCESS_FRAMES = 100 * SAMPLE_RATE / 1000;
+
+        AudioJitterBuffer jitterBuffer(NUM_CHANNELS, SAMPLE_RATE);
+        ToneSource source;
+        std::vector<int16_t> input(EXCESS_FRAMES * NUM_CHANNELS);
+        std::vector<int16_t> output(READ_FRAMES * NUM_CHANNELS);
+        source.render(input.data(), EXCESS_FRAMES);
+        jitterBuffer.write(input.data(), EXCESS_FRAMES);
+
+        int16_t lastSample = 0;
+        int step = 0;
+        for (int i = 0; i < NUM_READS; i++) {
+            QVERIFY(jitterBuffer.read(output.data(), READ_FRAMES));
+            if (i > 0) {
+                step = std::max(step, maxStep(output.data(), READ_FRAMES, lastSample));
+            } else {
+                lastSample = output[(READ_FRAMES - 1) * NUM_CHANNELS];
+            }
+            source.render(input.data(), READ_FRAMES);
+            jitterBuffer.write(input.data(), READ_FRAMES);
+        }
+
+        QCOMPARE(jitterBuffer.getDroppedFrames(), 0);
+        QVERIFY(step < MAX_TONE_STEP);
+        QVERIFY(jitterBuffer.getFramesAvailable() < READ_FRAMES + 2 * AudioJitterBuffer::SAFETY_MSECS * SAMPLE_RATE / 1000);
+    }
+}
+
+//
+// Simulated networks
+//
+
+// the arrival time of each packet, in usecs, or a negative time if it is lost
+using Trace = std::vector<double>;
+
+struct Network {
+    float jitterMsecs;      // the average of an exponential delay
+    float lossRate;
+    float stallsPerSecond;  // a stall holds back what is sent during it, which then arrives at once
+    float stallMsecs;
+};
+
+static void appendTrace(Trace& trace, int numPackets, const Network& network, std::mt19937& generator) {
+    const double LATENCY_USECS = 30000.0;
+
+    std::exponential_distribution<double> jitter(1.0 / std::max(network.jitterMsecs, 0.001f));
+    std::uniform_real_distribution<double> uniform;
+    double stallEnd = 0.0;
+
+    int start = (int)trace.size();
+    for (int i = start; i < start + numPackets; i++) {
+        double sent = i * PACKET_USECS;
+        if (sent >= stallEnd && uniform(generator) < network.stallsPerSecond * PACKET_USECS / USECS_PER_SECOND) {
+            stallEnd = sent + network.stallMsecs * USECS_PER_MSEC;
+        }
+        double arrival = std::max(sent, stallEnd) + LATENCY_USECS + jitter(generator) * USECS_PER_MSEC;
+        trace.push_back((uniform(generator) < network.lossRate) ? -1.0 : arrival);
+    }
+}
+
+// the buffer of AudioJitterBuffer, where lost packets are concealed with silence
+class AdaptivePlayer {
+public:
+    AdaptivePlayer() : _jitterBuffer(NUM_CHANNELS, SAMPLE_RATE) {}
+
+    void packetArrived(double now) {}
+    void write(const int16_t* packet) { _jitterBuffer.write(packet, NUM_FRAMES); }
+    void conceal(int numPackets) { _jitterBuffer.writeSilence(numPackets * NUM_FRAMES); }
+    int read(int16_t* output, int numFrames, double now) { return _jitterBuffer.read(output, numFrames) ? numFrames : 0; }
+
+    int getFramesAvailable() const { return _jitterBuffer.getFramesAvailable(); }
+    int getStarveCount() const { return _jitterBuffer.getStarveCount(); }
+
+private:
+    AudioJitterBuffer _jitterBuffer;
+};
+
+//
+// The frame-count scheme of InboundAudioStream, replayed on simulated time: a desired count of network frames, that
+// grows to the largest packet gap of a long window once starves reach WINDOW_STARVE_THRESHOLD within it, shrinks to
+// that of a short window, and is refilled to before playing again after a starve.
+//
+class FrameWindowPlayer {
+public:
+    static const int MAX_FRAMES_OVER_DESIRED = 10;
+    static const int WINDOW_STARVE_THRESHOLD = 3;
+    static const int WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES = 50;
+    static const int WINDOW_SECONDS_FOR_DESIRED_REDUCTION = 10;
+    static const int NUM_INITIAL_PACKETS_DISCARD = 1000;
+
+    void packetArrived(double now) {
+        if (++_packetsReceived > NUM_INITIAL_PACKETS_DISCARD) {
+            _gaps.emplace_back(now, now - _lastPacketTime);
+            if (_firstGapTime < 0.0) {
+                _firstGapTime = now;
+            }
+        }
+        _lastPacketTime = now;
+
+        // the windows complete an interval each second
+        if (_firstGapTime >= 0.0 && now >= _nextIntervalTime) {
+            _nextIntervalTime = now + USECS_PER_SECOND;
+            _calculatedFrames = framesForMaxGap(now, WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES);
+            if (now - _firstGapTime >= WINDOW_SECONDS_FOR_DESIRED_REDUCTION * USECS_PER_SECOND) {
+                _desiredFrames = std::min(_desiredFrames, framesForMaxGap(now, WINDOW_SECONDS_FOR_DESIRED_REDUCTION));
+            }
+        }
+    }
+
+    void write(const int16_t* packet) {
+        _framesAvailable += NUM_FRAMES;
+        int networkFramesAvailable = _framesAvailable / NUM_FRAMES;
+        if (_isStarved && networkFramesAvailable >= _desiredFrames) {
+            _isStarved = false;
+        }
+        if (networkFramesAvailable > _desiredFrames + MAX_FRAMES_OVER_DESIRED) {
+            _framesAvailable -= (networkFramesAvailable - (_desiredFrames + 1)) * NUM_FRAMES;
+        }
+    }
+
+    void conceal(int numPackets) {
+        while (numPackets--) {
+            write(nullptr);
+        }
+    }
+
+    int read(int16_t* output, int numFrames, double now) {
+        if (_isStarved) {
+            return 0;
+        }
+        if (_framesAvailable > 0) {
+            int numPoppedFrames = std::min(_framesAvailable, numFrames);
+            _framesAvailable -= numPoppedFrames;
+            return numPoppedFrames;
+        }
+
+        _starveCount++;
+        _isStarved = true;
+        _starveHistory.push_back(now);
+        while (_starveHistory.front() < now - WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES * USECS_PER_SECOND) {
+            _starveHistory.pop_front();
+        }
+        if ((int)_starveHistory.size() >= WINDOW_STARVE_THRESHOLD) {
+            int framesSinceLastPacket = (int)ceil((now - _lastPacketTime) / PACKET_USECS);
+            _desiredFrames = std::max(_desiredFrames, std::max(_calculatedFrames, framesSinceLastPacket));
+        }
+
+        // a frame of packet loss concealment is played
+        _framesAvailable = NUM_FRAMES - std::min(NUM_FRAMES, numFrames);
+        return std::min(NUM_FRAMES, numFrames);
+    }
+
+    int getFramesAvailable() const { return _framesAvailable; }
+    int getStarveCount() const { return _starveCount; }
+
+private:
+    int framesForMaxGap(double now, int windowSeconds) {
+        while (_gaps.front().first < now - WINDOW_SECONDS_FOR_DESIRED_CALC_ON_TOO_MANY_STARVES * USECS_PER_SECOND) {
+            _gaps.pop_front();
+        }
+        double maxGap = 0.0;
+        for (auto& gap : _gaps) {
+            if (gap.first >= now - windowSeconds * USECS_PER_SECOND) {
+                maxGap = std::max(maxGap, gap.second);
+            }
+        }
+        return std::max(1, (int)ceil(maxGap / PACKET_USECS));
+    }
+
+    int _framesAvailable { 0 };
+    int _desiredFrames { 1 };
+    int _calculatedFrames { 0 };
+    bool _isStarved { true };
+    int _starveCount { 0 };
+    int _packetsReceived { 0 };
+    double _lastPacketTime { 0.0 };
+    double _firstGapTime { -1.0 };
+    double _nextIntervalTime { 0.0 };
+    std::deque<std::pair<double, double>> _gaps;
+    std::deque<double> _starveHistory;
+};
+
+struct Playout {
+    double averageMsecs;    // of latency added by the buffer, before each read
+    double maxMsecs;
+    int numStarves;
+    int numShortReads;      // that played some frames, but fewer than the device asked for
+};
+
+//
+// Play a trace through a player, as InboundAudioStream::parseData would write it: lost packets are concealed once a
+// later one arrives, and late ones are dropped.  Returns what was measured from fromSeconds to toSeconds.
+//
+template <typename Player>
+static Playout play(Player& player, const Trace& trace, int fromSeconds, int toSeconds) {
+    std::vector<int> arrivalOrder;
+    for (int i = 0; i < (int)trace.size(); i++) {
+        if (trace[i] >= 0.0) {
+            arrivalOrder.push_back(i);
+        }
+    }
+    std::stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&](int a, int b) { return trace[a] < trace[b]; });
+
+    std::vector<int16_t> packet(NUM_FRAMES * NUM_CHANNELS, 1000);
+    std::vector<int16_t> output(READ_FRAMES * NUM_CHANNELS);
+    int nextArrival = 0;
+    int expectedSequence = 0;
+
+    double totalMsecs = 0.0;
+    Playout playout { 0.0, 0.0, 0, 0 };
+    int numReads = 0;
+    int starvesBefore = -1;
+
+    for (int i = 0; ; i++) {
+        double now = i * READ_USECS;
+        if (now >= toSeconds * USECS_PER_SECOND) {
+            break;
+        }
+
+        while (nextArrival < (int)arrivalOrder.size() && trace[arrivalOrder[nextArrival]] <= now) {
+            int sequence = arrivalOrder[nextArrival++];
+            player.packetArrived(trace[sequence]);
+            if (sequence < expectedSequence) {
+                continue;
+            }
+            if (sequence > expectedSequence) {
+                player.conceal(sequence - expectedSequence);
+            }
+            player.write(packet.data());
+            expectedSequence = sequence + 1;
+        }
+
+        if (now >= fromSeconds * USECS_PER_SECOND) {
+            if (starvesBefore < 0) {
+                starvesBefore = player.getStarveCount();
+            }
+            double msecs = player.getFramesAvailable() * 1000.0 / SAMPLE_RATE;
+            totalMsecs += msecs;
+            playout.maxMsecs = std::max(playout.maxMsecs, msecs);
+            numReads++;
+        }
+        int numPlayedFrames = player.read(output.data(), READ_FRAMES, now);
+        if (now >= fromSeconds * USECS_PER_SECOND && numPlayedFrames > 0 && numPlayedFrames < READ_FRAMES) {
+            playout.numShortReads++;
+        }
+    }
+
+    playout.averageMsecs = totalMsecs / numReads;
+    playout.numStarves = player.getStarveCount() - starvesBefore;
+    return playout;
+}
+
+static Playout reportPlayout(const char* name, const Trace& trace, int fromSeconds, int toSeconds) {
+    AdaptivePlayer adaptivePlayer;
+    FrameWindowPlayer frameWindowPlayer;
+    Playout adaptive = play(adaptivePlayer, trace, fromSeconds, toSeconds);
+    Playout frameWindows = play(frameWindowPlayer, trace, fromSeconds, toSeconds);
+
+    qDebug() << name << "from" << fromSeconds << "to" << toSeconds << "seconds:";
+    qDebug() << "  adaptive:     " << adaptive.averageMsecs << "msecs average," << adaptive.maxMsecs << "msecs max,"
+        << adaptive.numStarves << "starves," << adaptive.numShortReads << "short reads";
+    qDebug() << "  frame windows:" << frameWindows.averageMsecs << "msecs average," << frameWindows.maxMsecs << "msecs max,"
+        << frameWindows.numStarves << "starves," << frameWindows.numShortReads << "short reads";
+    return adaptive;
+}
+
+static const int TRACE_SECONDS = 70;
+static const int WARMUP_SECONDS = 10;   // as InboundAudioStream discards the gaps of its first packets
+static const int TRACE_PACKETS = (int)(TRACE_SECONDS * USECS_PER_SECOND / PACKET_USECS);
+
+void AudioJitterBufferTests::testSafetyAndPeek() {
+    const int NUM_STATIC_PACKETS = 10;
+    const int STATIC_FRAMES = NUM_STATIC_PACKETS * NUM_FRAMES;  // as a static jitter buffer of 10 network frames
+
+    AudioJitterBuffer jitterBuffer(NUM_CHANNELS, SAMPLE_RATE);
+    jitterBuffer.setSafetyFrames(STATIC_FRAMES);
+    QCOMPARE(jitterBuffer.getSafetyFrames(), STATIC_FRAMES);
+
+    ToneSource source;
+    std::vector<int16_t> packet(NUM_FRAMES * NUM_CHANNELS);
+    std::vector<int16_t> peeked(NUM_FRAMES * NUM_CHANNELS);
+    std::vector<int16_t> output(NUM_FRAMES * NUM_CHANNELS);
+
+    // reads wait for a read and the safety to be buffered
+    for (int i = 0; i < NUM_STATIC_PACKETS; i++) {
+        source.render(packet.data(), NUM_FRAMES);
+        jitterBuffer.write(packet.data(), NUM_FRAMES);
+        QVERIFY(!jitterBuffer.read(output.data(), NUM_FRAMES));
+    }
+    QVERIFY(jitterBuffer.isStarved());
+
+    // and then start from what a peek sees
+    source.render(packet.data(), NUM_FRAMES);
+    jitterBuffer.write(packet.data(), NUM_FRAMES);
+    QCOMPARE(jitterBuffer.peek(peeked.data(), NUM_FRAMES), NUM_FRAMES);
+    QCOMPARE(jitterBuffer.getFramesAvailable(), STATIC_FRAMES + NUM_FRAMES);
+    QVERIFY(jitterBuffer.read(output.data(), NUM_FRAMES));
+    QVERIFY(peeked == output);
+
+    // a steady network keeps the safety buffered, which is what the buffer needs
+    for (int i = 0; i < 1000; i++) {
+        source.render(packet.data(), NUM_FRAMES);
+        jitterBuffer.write(packet.data(), NUM_FRAMES);
+        QVERIFY(jitterBuffer.read(output.data(), NUM_FRAMES));
+    }
+    QCOMPARE(jitterBuffer.getStarveCount(), 0);
+    QCOMPARE(jitterBuffer.getTargetFrames(), STATIC_FRAMES + NUM_FRAMES);
+}
+
+void AudioJitterBufferTests::testStableNetwork() {
+    std::mt19937 generator(1);
+    Trace trace;
+    appendTrace(trace, TRACE_PACKETS, { 0.5f, 0.0f, 0.0f, 0.0f }, generator);
+
+    // a read, the safety, and the frame it waits on
+    const double MAX_AVERAGE_MSECS = 1000.0 * READ_FRAMES / SAMPLE_RATE + AudioJitterBuffer::SAFETY_MSECS
+        + AudioConstants::NETWORK_FRAME_MSECS;
+
+    Playout adaptive = reportPlayout("stable network", trace, WARMUP_SECONDS, TRACE_SECONDS);
+    QCOMPARE(adaptive.numStarves, 0);
+    QVERIFY(adaptive.averageMsecs < MAX_AVERAGE_MSECS);
+}
+
+void AudioJitterBufferTests::testJitterAndLoss() {
+    std::mt19937 generator(2);
+
+    Trace jittery;
+    appendTrace(jittery, TRACE_PACKETS, { 4.0f, 0.0f, 0.2f, 60.0f }, generator);
+    Playout adaptive = reportPlayout("jitter and stalls", jittery, WARMUP_SECONDS, TRACE_SECONDS);
+    QVERIFY(adaptive.numStarves <= 3);
+    QVERIFY(adaptive.maxMsecs < AudioJitterBuffer::MAX_EXCESS_MSECS);
+
+    Trace lossy;
+    appendTrace(lossy, TRACE_PACKETS, { 2.0f, 0.05f, 0.0f, 0.0f }, generator);
+    adaptive = reportPlayout("5% loss", lossy, WARMUP_SECONDS, TRACE_SECONDS);
+    QVERIFY(adaptive.numStarves <= 3);
+}
+
+void AudioJitterBufferTests::testLatencyRecovery() {
+    const int JITTERY_SECONDS = 20;
+
+    // a network that settles down after a rough start
+    std::mt19937 generator(3);
+    Trace trace;
+    appendTrace(trace, JITTERY_SECONDS * TRACE_PACKETS / TRACE_SECONDS, { 6.0f, 0.01f, 0.5f, 80.0f }, generator);
+    appendTrace(trace, (TRACE_SECONDS - JITTERY_SECONDS) * TRACE_PACKETS / TRACE_SECONDS, { 0.5f, 0.0f, 0.0f, 0.0f },
+        generator);
+
+    Playout rough = reportPlayout("rough network", trace, WARMUP_SECONDS, JITTERY_SECONDS);
+    Playout settled = reportPlayout("once it settles", trace, TRACE_SECONDS - 10, TRACE_SECONDS);
+
+    // the latency needed through the rough part is released once the network no longer needs it
+    QCOMPARE(settled.numStarves, 0);
+    QVERIFY(settled.averageMsecs < rough.averageMsecs / 2.0);
+}
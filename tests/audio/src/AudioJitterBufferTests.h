@@ -0,0 +1,29 @@
+//
+//  AudioJitterBufferTests.h
+//  tests/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioJitterBufferTests_h
+#define hifi_AudioJitterBufferTests_h
+
+#include <QtTest/QtTest>
+
+class AudioJitterBufferTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRingBuffer();
+    void testRingBufferThreads();
+    void testStretch();
+    void testSafetyAndPeek();
+    void testStableNetwork();
+    void testJitterAndLoss();
+    void testLatencyRecovery();
+};
+
+#endif // hifi_AudioJitterBufferTests_h
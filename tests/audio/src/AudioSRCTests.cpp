@@ -0,0 +1,251 @@
+//
+//  AudioSRCTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSRCTests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <AudioSRC.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AudioSRCTests)
+
+// block sizes that do not line up with the input blocking of AudioSRC
+static const int BLOCK_FRAMES[] = { 240, 1, 97, 512, 33, 256, 1000 };
+static const int NUM_BLOCK_SIZES = sizeof(BLOCK_FRAMES) / sizeof(BLOCK_FRAMES[0]);
+
+// interleaved test audio for each stream: a tone of its own, and noise
+static std::vector<std::vector<float>> makeTestAudio(const std::vector<int>& numChannels, int numFrames) {
+    std::vector<std::vector<float>> streams(numChannels.size());
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+    for (size_t stream = 0; stream < streams.size(); stream++) {
+        streams[stream].resize(numFrames * numChannels[stream]);
+        float frequency = 0.001f + 0.37f * stream / streams.size();    // of the input rate
+        for (int i = 0; i < numFrames; i++) {
+            for (int ch = 0; ch < numChannels[stream]; ch++) {
+                streams[stream][i * numChannels[stream] + ch] = 0.5f * sinf(TWO_PI * frequency * i + ch) + noise(generator);
+            }
+        }
+    }
+    return streams;
+}
+
+// the greatest difference between the batch and single streams, rendering the same audio (or infinity, when the
+// number of frames differ)
+static float compareToSingleStreams(int inputSampleRate, int outputSampleRate, const std::vector<int>& numChannels,
+                                    AudioSRC::Quality quality) {
+    const int NUM_FRAMES = 3 * inputSampleRate / 2;
+    int numStreams = (int)numChannels.size();
+
+    std::vector<std::vector<float>> inputs = makeTestAudio(numChannels, NUM_FRAMES);
+
+    AudioSRCBatch batch(inputSampleRate, outputSampleRate, numChannels.data(), numStreams, quality);
+    std::vector<std::unique_ptr<AudioSRC>> singles;
+    for (int stream = 0; stream < numStreams; stream++) {
+        singles.emplace_back(new AudioSRC(inputSampleRate, outputSampleRate, numChannels[stream], quality));
+    }
+
+    int maxOutputFrames = batch.getMaxOutput(BLOCK_FRAMES[NUM_BLOCK_SIZES - 1]);
+    std::vector<std::vector<float>> batchOutputs(numStreams);
+    std::vector<float> singleOutput(maxOutputFrames * SRC_MAX_CHANNELS);
+    for (int stream = 0; stream < numStreams; stream++) {
+        batchOutputs[stream].resize(maxOutputFrames * numChannels[stream]);
+    }
+
+    std::vector<const float*> inputPointers(numStreams);
+    std::vector<float*> outputPointers(numStreams);
+
+    float maxError = 0.0f;
+    int block = 0;
+    for (int frame = 0; frame + BLOCK_FRAMES[block] <= NUM_FRAMES; block = (block + 1) % NUM_BLOCK_SIZES) {
+        int numFrames = BLOCK_FRAMES[block];
+
+        for (int stream = 0; stream < numStreams; stream++) {
+            inputPointers[stream] = &inputs[stream][frame * numChannels[stream]];
+            outputPointers[stream] = batchOutputs[stream].data();
+        }
+        int batchFrames = batch.render(inputPointers.data(), outputPointers.data(), numFrames);
+        if (batchFrames > batch.getMaxOutput(numFrames) || batchFrames < batch.getMinOutput(numFrames)) {
+            return INFINITY;
+        }
+
+        for (int stream = 0; stream < numStreams; stream++) {
+            int singleFrames = singles[stream]->render(inputPointers[stream], singleOutput.data(), numFrames);
+            if (singleFrames != batchFrames) {
+                return INFINITY;
+            }
+
+            for (int i = 0; i < singleFrames * numChannels[stream]; i++) {
+                maxError = std::max(maxError, fabsf(singleOutput[i] - batchOutputs[stream][i]));
+            }
+        }
+        frame += numFrames;
+    }
+    return maxError;
+}
+
+void AudioSRCTests::testBatchRational() {
+    // mono and stereo, over a number of lanes that is not a multiple of the SIMD width
+    std::vector<int> numChannels = { 1, 2, 1, 1, 2, 2, 1, 2, 1, 1, 1, 2, 1 };
+
+    // downsampled injector sounds, and upsampled local audio
+    float error = compareToSingleStreams(44100, 24000, numChannels, AudioSRC::MEDIUM_QUALITY);
+    QVERIFY(error < 1.0e-5f);
+    error = compareToSingleStreams(24000, 48000, numChannels, AudioSRC::LOW_QUALITY);
+    QVERIFY(error < 1.0e-5f);
+    error = compareToSingleStreams(48000, 44100, numChannels, AudioSRC::HIGH_QUALITY);
+    QVERIFY(error < 1.0e-5f);
+}
+
+void AudioSRCTests::testBatchIrrational() {
+    std::vector<int> numChannels(70, 1);
+    numChannels[3] = 2;
+
+    float error = compareToSingleStreams(48000, 44101, numChannels, AudioSRC::MEDIUM_QUALITY);
+    QVERIFY(error < 1.0e-5f);
+    error = compareToSingleStreams(44101, 24000, numChannels, AudioSRC::MEDIUM_QUALITY);
+    QVERIFY(error < 1.0e-5f);
+}
+
+void AudioSRCTests::testBatchInt16() {
+    const int NUM_FRAMES = 4800;
+    std::vector<int> numChannels = { 2, 1, 1, 2 };
+    int numStreams = (int)numChannels.size();
+
+    std::vector<std::vector<float>> audio = makeTestAudio(numChannels, NUM_FRAMES);
+    std::vector<std::vector<int16_t>> inputs(numStreams);
+    std::vector<std::vector<int16_t>> outputs(numStreams);
+    std::vector<const int16_t*> inputPointers(numStreams);
+    std::vector<int16_t*> outputPointers(numStreams);
+
+    AudioSRCBatch batch(48000, 24000, numChannels.data(), numStreams);
+    int maxOutputFrames = batch.getMaxOutput(NUM_FRAMES);
+
+    for (int stream = 0; stream < numStreams; stream++) {
+        for (float sample : audio[stream]) {
+            inputs[stream].push_back((int16_t)(sample * 32767.0f));
+        }
+        outputs[stream].resize(maxOutputFrames * numChannels[stream]);
+        inputPointers[stream] = inputs[stream].data();
+        outputPointers[stream] = outputs[stream].data();
+    }
+    int batchFrames = batch.render(inputPointers.data(), outputPointers.data(), NUM_FRAMES);
+
+    // the same but for dither
+    std::vector<int16_t> singleOutput(maxOutputFrames * SRC_MAX_CHANNELS);
+    for (int stream = 0; stream < numStreams; stream++) {
+        AudioSRC single(48000, 24000, numChannels[stream]);
+        int singleFrames = single.render(inputs[stream].data(), singleOutput.data(), NUM_FRAMES);
+        QCOMPARE(singleFrames, batchFrames);
+
+        int maxError = 0;
+        for (int i = 0; i < singleFrames * numChannels[stream]; i++) {
+            maxError = std::max(maxError, std::abs(singleOutput[i] - outputs[stream][i]));
+        }
+        QVERIFY(maxError <= 3);
+    }
+}
+
+void AudioSRCTests::testBatchClearStream() {
+    const int NUM_FRAMES = 480;
+    std::vector<int> numChannels = { 1, 2 };
+
+    std::vector<std::vector<float>> inputs = makeTestAudio(numChannels, NUM_FRAMES);
+    std::vector<std::vector<float>> outputs = { std::vector<float>(NUM_FRAMES), std::vector<float>(2 * NUM_FRAMES) };
+    const float* inputPointers[] = { inputs[0].data(), inputs[1].data() };
+    float* outputPointers[] = { outputs[0].data(), outputs[1].data() };
+
+    AudioSRCBatch batch(48000, 44100, numChannels.data(), 2);
+    AudioSRC single(48000, 44100, 2);
+    std::vector<float> singleOutput(2 * NUM_FRAMES);
+
+    batch.render(inputPointers, outputPointers, NUM_FRAMES);
+    single.render(inputs[1].data(), singleOutput.data(), NUM_FRAMES);
+
+    // a cleared stream, without input, renders exact silence at once
+    batch.clearStream(0);
+    inputPointers[0] = nullptr;
+    int numFrames = batch.render(inputPointers, outputPointers, NUM_FRAMES);
+    int singleFrames = single.render(inputs[1].data(), singleOutput.data(), NUM_FRAMES);
+    QCOMPARE(numFrames, singleFrames);
+
+    for (int i = 0; i < numFrames; i++) {
+        QCOMPARE(outputs[0][i], 0.0f);
+    }
+
+    // while the others carry on
+    float maxError = 0.0f;
+    for (int i = 0; i < 2 * numFrames; i++) {
+        maxError = std::max(maxError, fabsf(singleOutput[i] - outputs[1][i]));
+    }
+    QVERIFY(maxError < 1.0e-5f);
+}
+
+void AudioSRCTests::benchmarkInjectorStreams() {
+    const int NUM_STREAMS = 64;
+    const int INPUT_RATE = 44100;
+    const int OUTPUT_RATE = 24000;
+    const int NUM_FRAMES = INPUT_RATE / 100;    // 10 msecs a callback
+    const int NUM_CALLBACKS = 500;
+
+    std::vector<int> numChannels(NUM_STREAMS, 1);
+    std::vector<std::vector<float>> inputs = makeTestAudio(numChannels, NUM_FRAMES * NUM_CALLBACKS);
+
+    AudioSRCBatch batch(INPUT_RATE, OUTPUT_RATE, numChannels.data(), NUM_STREAMS);
+    std::vector<std::unique_ptr<AudioSRC>> singles;
+    for (int stream = 0; stream < NUM_STREAMS; stream++) {
+        singles.emplace_back(new AudioSRC(INPUT_RATE, OUTPUT_RATE, 1));
+    }
+
+    int maxOutputFrames = batch.getMaxOutput(NUM_FRAMES);
+    std::vector<std::vector<float>> batchOutputs(NUM_STREAMS, std::vector<float>(maxOutputFrames));
+    std::vector<std::vector<float>> singleOutputs(NUM_STREAMS, std::vector<float>(maxOutputFrames));
+    std::vector<const float*> inputPointers(NUM_STREAMS);
+    std::vector<float*> outputPointers(NUM_STREAMS);
+
+    quint64 batchUsecs = 0;
+    quint64 singleUsecs = 0;
+    float maxError = 0.0f;
+
+    for (int callback = 0; callback < NUM_CALLBACKS; callback++) {
+        for (int stream = 0; stream < NUM_STREAMS; stream++) {
+            inputPointers[stream] = &inputs[stream][callback * NUM_FRAMES];
+            outputPointers[stream] = batchOutputs[stream].data();
+        }
+
+        quint64 start = usecTimestampNow();
+        int batchFrames = batch.render(inputPointers.data(), outputPointers.data(), NUM_FRAMES);
+        quint64 split = usecTimestampNow();
+        for (int stream = 0; stream < NUM_STREAMS; stream++) {
+            int singleFrames = singles[stream]->render(inputPointers[stream], singleOutputs[stream].data(), NUM_FRAMES);
+            QCOMPARE(singleFrames, batchFrames);
+        }
+        singleUsecs += usecTimestampNow() - split;
+        batchUsecs += split - start;
+
+        for (int stream = 0; stream < NUM_STREAMS; stream++) {
+            for (int i = 0; i < batchFrames; i++) {
+                maxError = std::max(maxError, fabsf(singleOutputs[stream][i] - batchOutputs[stream][i]));
+            }
+        }
+    }
+    QVERIFY(maxError < 1.0e-5f);
+
+    qDebug() << NUM_STREAMS << "streams," << INPUT_RATE << "to" << OUTPUT_RATE << "Hz:";
+    qDebug() << "  batch: " << (float)batchUsecs / NUM_CALLBACKS << "usecs a callback";
+    qDebug() << "  single:" << (float)singleUsecs / NUM_CALLBACKS << "usecs a callback,"
+        << (float)singleUsecs / std::max(batchUsecs, (quint64)1) << "times the batch";
+}
@@ -0,0 +1,27 @@
+//
+//  AudioSRCTests.h
+//  tests/audio/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSRCTests_h
+#define hifi_AudioSRCTests_h
+
+#include <QtTest/QtTest>
+
+class AudioSRCTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testBatchRational();
+    void testBatchIrrational();
+    void testBatchInt16();
+    void testBatchClearStream();
+    void benchmarkInjectorStreams();
+};
+
+#endif // hifi_AudioSRCTests_h
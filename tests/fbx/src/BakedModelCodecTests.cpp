@@ -0,0 +1,232 @@
+//
+//  BakedModelCodecTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakedModelCodecTests.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include <FBXSerializer.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <model-baker/Baker.h>
+#include <model-baker/BakedModelCodec.h>
+
+#include <test-utils/QTestExtensions.h>
+
+QTEST_MAIN(BakedModelCodecTests)
+
+static const char* CORPUS_ENV_VARIABLE = "HIFI_FBX_CORPUS";
+
+// A grid of quads with a joint, a blendshape and a material, about what the serializers hand to the baker
+static HFMModel::Pointer makeModel(int gridSize) {
+    auto hfmModel = std::make_shared<HFMModel>();
+    hfmModel->originalURL = "file:///grid.fbx";
+    hfmModel->author = "tests";
+    hfmModel->applicationName = "BakedModelCodecTests";
+    hfmModel->hasSkeletonJoints = true;
+    hfmModel->offset = glm::mat4();
+    hfmModel->neckPivot = glm::vec3(0.0f, 1.0f, 0.0f);
+    hfmModel->scripts.push_back("file:///grid.js");
+
+    HFMJoint joint;
+    joint.parentIndex = -1;
+    joint.distanceToParent = 0.0f;
+    joint.translation = glm::vec3(0.0f);
+    joint.preTransform = joint.postTransform = joint.transform = glm::mat4();
+    joint.preRotation = joint.rotation = joint.postRotation = glm::quat();
+    joint.inverseDefaultRotation = joint.inverseBindRotation = glm::quat();
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.bindTransform = joint.geometricOffset = joint.localTransform = joint.globalTransform = glm::mat4();
+    joint.name = "Hips";
+    joint.isSkeletonJoint = true;
+    joint.bindTransformFoundInCluster = false;
+    hfmModel->joints.push_back(joint);
+    hfmModel->jointIndices.insert(joint.name, 1);
+    hfmModel->jointRotationOffsets.insert(0, glm::quat(0.5f, 0.5f, 0.5f, 0.5f));
+
+    HFMMaterial material(glm::vec3(0.8f, 0.2f, 0.1f), glm::vec3(0.02f), glm::vec3(0.0f), 10.0f, 0.5f);
+    material.materialID = "grid";
+    material.name = "Grid";
+    material.albedoTexture.name = "albedo";
+    material.albedoTexture.filename = "albedo.png";
+    material._material = std::make_shared<graphics::Material>();
+    material._material->setName("Grid");
+    material._material->setAlbedo(material.diffuseColor);
+    material._material->setOpacity(material.opacity);
+    material._material->setRoughness(0.75f);
+    material._material->setMetallic(0.25f);
+    hfmModel->materials.push_back(material);
+
+    HFMMesh mesh;
+    mesh.meshIndex = 0;
+    mesh.modelTransform = glm::mat4();
+    HFMMeshPart part;
+    for (int y = 0; y <= gridSize; y++) {
+        for (int x = 0; x <= gridSize; x++) {
+            mesh.vertices << glm::vec3(x, y, 0.0f);
+            mesh.normals << glm::vec3(0.0f, 0.0f, 1.0f);
+            mesh.texCoords << glm::vec2((float)x / gridSize, (float)y / gridSize);
+            mesh.meshExtents.addPoint(mesh.vertices.back());
+        }
+    }
+    for (int y = 0; y < gridSize; y++) {
+        for (int x = 0; x < gridSize; x++) {
+            int corner = y * (gridSize + 1) + x;
+            part.triangleIndices << corner << corner + 1 << corner + gridSize + 2;
+            part.triangleIndices << corner << corner + gridSize + 2 << corner + gridSize + 1;
+        }
+    }
+    mesh.parts.push_back(part);
+
+    HFMBlendshape blendshape;
+    for (int i = 0; i < mesh.vertices.size(); i += 3) {
+        blendshape.indices << i;
+        blendshape.vertices << glm::vec3(0.0f, 0.0f, 0.1f);
+        blendshape.normals << glm::vec3(0.0f, 0.1f, 0.0f);
+    }
+    mesh.blendshapes << blendshape;
+    hfmModel->blendshapeChannelNames << "JawOpen";
+    hfmModel->meshes.push_back(mesh);
+    hfmModel->meshIndicesToModelNames.insert(0, "Grid");
+
+    HFMShape shape;
+    shape.mesh = 0;
+    shape.meshPart = 0;
+    shape.material = 0;
+    shape.joint = 0;
+    hfmModel->shapes.push_back(shape);
+
+    hfmModel->flowData._physicsConfig.insert("leaf", QVariantMap({ { "stiffness", 0.5 } }));
+    return hfmModel;
+}
+
+static HFMModel::Pointer bake(const HFMModel::Pointer& hfmModel) {
+    baker::Baker modelBaker(hfmModel, hifi::VariantHash(), hifi::URL());
+    modelBaker.run();
+    return modelBaker.getHFMModel();
+}
+
+void BakedModelCodecTests::testRoundTrip() {
+    auto baked = bake(makeModel(16));
+    QVERIFY(baked);
+    hifi::ByteArray payload = baker::BakedModelCodec::encode(*baked);
+
+    auto decoded = baker::BakedModelCodec::decode(payload.constData(), payload.size());
+    QVERIFY(decoded);
+
+    // anything lost along the way would show up in the second encoding
+    QCOMPARE(baker::BakedModelCodec::encode(*decoded), payload);
+
+    QCOMPARE(decoded->meshes.size(), baked->meshes.size());
+    const auto& mesh = decoded->meshes[0];
+    const auto& bakedMesh = baked->meshes[0];
+    QCOMPARE(mesh.vertices, bakedMesh.vertices);
+    QCOMPARE(mesh.tangents, bakedMesh.tangents);
+    QCOMPARE(mesh.blendshapes[0].tangents, bakedMesh.blendshapes[0].tangents);
+    QCOMPARE(mesh.triangleListMesh.indices, bakedMesh.triangleListMesh.indices);
+
+    QVERIFY(mesh._mesh);
+    QCOMPARE(mesh._mesh->getNumVertices(), bakedMesh._mesh->getNumVertices());
+    QCOMPARE(mesh._mesh->getNumIndices(), bakedMesh._mesh->getNumIndices());
+    QCOMPARE(mesh._mesh->getNumParts(), bakedMesh._mesh->getNumParts());
+    QCOMPARE(mesh._mesh->getVertexFormat()->getAttributes().size(), bakedMesh._mesh->getVertexFormat()->getAttributes().size());
+    const auto& indexBuffer = mesh._mesh->getIndexBuffer();
+    QVERIFY(memcmp(indexBuffer._buffer->getData(), bakedMesh._mesh->getIndexBuffer()._buffer->getData(),
+                   indexBuffer._buffer->getSize()) == 0);
+
+    const auto& material = decoded->materials[0];
+    QVERIFY(material._material);
+    QVERIFY(material._material->getKey()._flags == baked->materials[0]._material->getKey()._flags);
+    QCOMPARE(material.albedoTexture.filename, baked->materials[0].albedoTexture.filename);
+
+    QCOMPARE(decoded->getJointIndex("Hips"), 0);
+    QCOMPARE(decoded->shapeVertices.size(), baked->shapeVertices.size());
+    QCOMPARE(decoded->flowData._physicsConfig, baked->flowData._physicsConfig);
+}
+
+void BakedModelCodecTests::testCorrupt() {
+    hifi::ByteArray payload = baker::BakedModelCodec::encode(*bake(makeModel(4)));
+
+    QVERIFY(!baker::BakedModelCodec::decode(payload.constData(), 0));
+    for (int length : { 8, payload.size() / 3, payload.size() / 2, payload.size() - 1 }) {
+        QVERIFY(!baker::BakedModelCodec::decode(payload.constData(), length));
+    }
+
+    hifi::ByteArray otherVersion = payload;
+    otherVersion[4] = (char)(otherVersion[4] + 1);
+    QVERIFY(!baker::BakedModelCodec::decode(otherVersion.constData(), otherVersion.size()));
+
+    hifi::ByteArray trailing = payload + hifi::ByteArray(4, '\0');
+    QVERIFY(!baker::BakedModelCodec::decode(trailing.constData(), trailing.size()));
+}
+
+template<class F>
+static quint64 measureBest(F load) {
+    const int NUM_LOADS = 5;
+    quint64 bestTime = std::numeric_limits<quint64>::max();
+    for (int i = 0; i < NUM_LOADS; i++) {
+        quint64 start = usecTimestampNow();
+        load();
+        bestTime = std::min(bestTime, usecTimestampNow() - start);
+    }
+    return bestTime;
+}
+
+// Compares what a reload costs without the disk cache (parse and bake) with what it costs with it (decode)
+void BakedModelCodecTests::benchmarkCorpus() {
+    QList<QPair<QString, std::function<HFMModel::Pointer()>>> models;
+    QString corpus = qgetenv(CORPUS_ENV_VARIABLE);
+    if (!corpus.isEmpty()) {
+        QDir dir(corpus);
+        foreach (const QString& filename, dir.entryList(QStringList("*.fbx"), QDir::Files, QDir::Name)) {
+            QFile file(dir.filePath(filename));
+            if (!file.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            hifi::ByteArray data = file.readAll();
+            QUrl url = QUrl::fromLocalFile(file.fileName());
+            models << qMakePair(filename, std::function<HFMModel::Pointer()>([data, url] {
+                return FBXSerializer().read(data, hifi::VariantHash(), url);
+            }));
+        }
+    }
+    if (models.isEmpty()) {
+        // roughly a dense avatar body
+        const int GRID_SIZE = 256;
+        models << qMakePair(QString("generated"), std::function<HFMModel::Pointer()>([] {
+            return makeModel(GRID_SIZE);
+        }));
+    }
+
+    foreach (const auto& model, models) {
+        auto hfmModel = model.second();
+        if (!hfmModel || hfmModel->meshes.empty()) {
+            continue;
+        }
+        hifi::ByteArray payload = baker::BakedModelCodec::encode(*bake(hfmModel));
+
+        quint64 coldTime = measureBest([&] {
+            bake(model.second());
+        });
+        quint64 cachedTime = measureBest([&] {
+            baker::BakedModelCodec::decode(payload.constData(), payload.size());
+        });
+        qDebug() << model.first << (float)payload.size() / MB_TO_BYTES(1) << "MB payload,"
+            << "parse and bake:" << (float)coldTime / USECS_PER_MSEC << "msecs,"
+            << "cached:" << (float)cachedTime / USECS_PER_MSEC << "msecs";
+    }
+}
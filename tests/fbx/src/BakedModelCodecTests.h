@@ -0,0 +1,24 @@
+//
+//  BakedModelCodecTests.h
+//  tests/fbx/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakedModelCodecTests_h
+#define hifi_BakedModelCodecTests_h
+
+#include <QtTest/QtTest>
+
+class BakedModelCodecTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRoundTrip();
+    void testCorrupt();
+    void benchmarkCorpus();
+};
+
+#endif // hifi_BakedModelCodecTests_h
@@ -0,0 +1,487 @@
+//
+//  FBXParserTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXParserTests.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QtEndian>
+
+#include <FBXSerializer.h>
+#include <FBXWriter.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include <test-utils/QTestExtensions.h>
+
+QTEST_MAIN(FBXParserTests)
+
+// Directory of .fbx files to check against the legacy parser, and to benchmark.  Without it the benchmark runs
+// over a generated document of comparable size.
+static const char* CORPUS_ENV_VARIABLE = "HIFI_FBX_CORPUS";
+
+//
+// The QDataStream based binary parser, as it was before the in place reader, kept as the reference.
+//
+namespace legacy {
+
+template<class T>
+QVariant readBinaryArray(QDataStream& in, int& position) {
+    quint32 arrayLength;
+    quint32 encoding;
+    quint32 compressedLength;
+
+    in >> arrayLength;
+    in >> encoding;
+    in >> compressedLength;
+    position += sizeof(quint32) * 3;
+
+    QVector<T> values;
+    values.resize(arrayLength);
+    hifi::ByteArray arrayData;
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        // preface encoded data with uncompressed length
+        hifi::ByteArray compressed(sizeof(quint32) + compressedLength, 0);
+        *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
+        in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
+        position += compressedLength;
+        arrayData = qUncompress(compressed);
+        if ((unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) {
+            throw QString("corrupt fbx file");
+        }
+    } else {
+        arrayData.resize(sizeof(T) * arrayLength);
+        position += sizeof(T) * arrayLength;
+        in.readRawData(arrayData.data(), arrayData.size());
+    }
+
+    if (arrayData.size() > 0) {
+        memcpy(&values[0], arrayData.constData(), arrayData.size());
+    }
+    return QVariant::fromValue(values);
+}
+
+QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
+    char ch;
+    in.device()->getChar(&ch);
+    position++;
+    switch (ch) {
+        case 'Y': {
+            qint16 value;
+            in >> value;
+            position += sizeof(qint16);
+            return QVariant::fromValue(value);
+        }
+        case 'C': {
+            bool value;
+            in >> value;
+            position++;
+            return QVariant::fromValue(value);
+        }
+        case 'I': {
+            qint32 value;
+            in >> value;
+            position += sizeof(qint32);
+            return QVariant::fromValue(value);
+        }
+        case 'F': {
+            float value;
+            in >> value;
+            position += sizeof(float);
+            return QVariant::fromValue(value);
+        }
+        case 'D': {
+            double value;
+            in >> value;
+            position += sizeof(double);
+            return QVariant::fromValue(value);
+        }
+        case 'L': {
+            qint64 value;
+            in >> value;
+            position += sizeof(qint64);
+            return QVariant::fromValue(value);
+        }
+        case 'f':
+            return readBinaryArray<float>(in, position);
+        case 'd':
+            return readBinaryArray<double>(in, position);
+        case 'l':
+            return readBinaryArray<qint64>(in, position);
+        case 'i':
+            return readBinaryArray<qint32>(in, position);
+        case 'b':
+            return readBinaryArray<bool>(in, position);
+        case 'S':
+        case 'R': {
+            quint32 length;
+            in >> length;
+            position += sizeof(quint32) + length;
+            return QVariant::fromValue(in.device()->read(length));
+        }
+        default:
+            throw QString("Unknown property type: ") + ch;
+    }
+}
+
+FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions) {
+    qint64 endOffset;
+    quint64 propertyCount;
+    quint64 propertyListLength;
+    quint8 nameLength;
+
+    if (has64BitPositions) {
+        in >> endOffset;
+        in >> propertyCount;
+        in >> propertyListLength;
+        position += sizeof(quint64) * 3;
+    } else {
+        qint32 tempEndOffset;
+        quint32 tempPropertyCount;
+        quint32 tempPropertyListLength;
+        in >> tempEndOffset;
+        in >> tempPropertyCount;
+        in >> tempPropertyListLength;
+        position += sizeof(quint32) * 3;
+        endOffset = tempEndOffset;
+        propertyCount = tempPropertyCount;
+        propertyListLength = tempPropertyListLength;
+    }
+    in >> nameLength;
+    position += sizeof(quint8);
+
+    FBXNode node;
+    const int MIN_VALID_OFFSET = 40;
+    if (endOffset < MIN_VALID_OFFSET || nameLength == 0) {
+        return node;
+    }
+    node.name = in.device()->read(nameLength);
+    position += nameLength;
+
+    for (quint32 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseBinaryFBXProperty(in, position));
+    }
+
+    while (endOffset > position) {
+        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+        if (!child.name.isNull()) {
+            node.children.append(child);
+        }
+    }
+
+    return node;
+}
+
+FBXNode parseFBX(const hifi::ByteArray& data) {
+    QBuffer buffer(const_cast<hifi::ByteArray*>(&data));
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream in(&buffer);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setVersion(QDataStream::Qt_4_5);
+
+    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
+    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
+    quint32 fileVersion;
+    in >> fileVersion;
+    position += sizeof(fileVersion);
+    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
+
+    FBXNode top;
+    while (buffer.bytesAvailable()) {
+        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
+        if (next.name.isNull()) {
+            return top;
+        }
+        top.children.append(next);
+    }
+    return top;
+}
+
+}
+
+template<class T>
+static bool compareArrays(const QVariant& a, const QVariant& b) {
+    return a.value<QVector<T>>() == b.value<QVector<T>>();
+}
+
+static bool compareProperties(const QVariant& a, const QVariant& b) {
+    if (a.userType() != b.userType()) {
+        return false;
+    }
+    int type = a.userType();
+    if (type == qMetaTypeId<QVector<float>>()) {
+        return compareArrays<float>(a, b);
+    } else if (type == qMetaTypeId<QVector<double>>()) {
+        return compareArrays<double>(a, b);
+    } else if (type == qMetaTypeId<QVector<qint64>>()) {
+        return compareArrays<qint64>(a, b);
+    } else if (type == qMetaTypeId<QVector<qint32>>()) {
+        return compareArrays<qint32>(a, b);
+    } else if (type == qMetaTypeId<QVector<bool>>()) {
+        return compareArrays<bool>(a, b);
+    }
+    return a == b;
+}
+
+static void compareNodes(const FBXNode& a, const FBXNode& b) {
+    QCOMPARE(a.name, b.name);
+    QCOMPARE(a.properties.size(), b.properties.size());
+    for (int i = 0; i < a.properties.size(); i++) {
+        QVERIFY2(compareProperties(a.properties.at(i), b.properties.at(i)), a.name.constData());
+    }
+    QCOMPARE(a.children.size(), b.children.size());
+    for (int i = 0; i < a.children.size(); i++) {
+        compareNodes(a.children.at(i), b.children.at(i));
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+    }
+}
+
+static void compareModels(const HFMModel& a, const HFMModel& b) {
+    QCOMPARE(a.joints.size(), b.joints.size());
+    for (size_t i = 0; i < a.joints.size(); i++) {
+        QCOMPARE(a.joints[i].name, b.joints[i].name);
+        QCOMPARE(a.joints[i].parentIndex, b.joints[i].parentIndex);
+        QVERIFY(a.joints[i].transform == b.joints[i].transform);
+    }
+    QCOMPARE(a.materials.size(), b.materials.size());
+    QCOMPARE(a.shapes.size(), b.shapes.size());
+    QCOMPARE(a.meshes.size(), b.meshes.size());
+    for (size_t i = 0; i < a.meshes.size(); i++) {
+        const auto& meshA = a.meshes[i];
+        const auto& meshB = b.meshes[i];
+        QVERIFY(meshA.vertices == meshB.vertices);
+        QVERIFY(meshA.normals == meshB.normals);
+        QVERIFY(meshA.texCoords == meshB.texCoords);
+        QVERIFY(meshA.clusterIndices == meshB.clusterIndices);
+        QVERIFY(meshA.clusterWeights == meshB.clusterWeights);
+        QCOMPARE(meshA.parts.size(), meshB.parts.size());
+        for (size_t j = 0; j < meshA.parts.size(); j++) {
+            QVERIFY(meshA.parts[j].triangleIndices == meshB.parts[j].triangleIndices);
+            QVERIFY(meshA.parts[j].quadIndices == meshB.parts[j].quadIndices);
+        }
+    }
+    QVERIFY(a.meshExtents.minimum == b.meshExtents.minimum);
+    QVERIFY(a.meshExtents.maximum == b.meshExtents.maximum);
+}
+
+// A document exercising every property type, with arrays large enough for FBXWriter to compress
+static FBXNode makeDocument(int numGeometries, int numVertices) {
+    FBXNode root;
+
+    FBXNode header;
+    header.name = "FBXHeaderExtension";
+    header.properties << QVariant::fromValue((qint16)-7) << QVariant::fromValue(true) << QVariant::fromValue((qint32)7400)
+        << QVariant::fromValue(0.5f) << QVariant::fromValue(0.25) << QVariant::fromValue((qint64)1 << 40)
+        << QVariant::fromValue(hifi::ByteArray("Model::Body\x00\x01Model", 18));
+    root.children << header;
+
+    FBXNode objects;
+    objects.name = "Objects";
+    for (int g = 0; g < numGeometries; g++) {
+        FBXNode geometry;
+        geometry.name = "Geometry";
+        geometry.properties << QVariant::fromValue((qint64)(1000 + g)) << QVariant::fromValue(hifi::ByteArray("Geometry::"))
+            << QVariant::fromValue(hifi::ByteArray("Mesh"));
+
+        QVector<double> vertices;
+        QVector<qint32> indices;
+        QVector<float> weights;
+        QVector<qint64> ids;
+        QVector<bool> flags;
+        for (int i = 0; i < numVertices; i++) {
+            vertices << (i % 100) * 0.25 << (i % 37) * -0.5 << (g + i % 11) * 0.125;
+            indices << ((i % 3 == 2) ? ~i : i);
+            weights << (i % 17) / 16.0f;
+            ids << (qint64)i * 3;
+            flags << (i % 5 == 0);
+        }
+
+        FBXNode child;
+        child.name = "Vertices";
+        child.properties << QVariant::fromValue(vertices);
+        geometry.children << child;
+        child.name = "PolygonVertexIndex";
+        child.properties = { QVariant::fromValue(indices) };
+        geometry.children << child;
+        child.name = "Weights";
+        child.properties = { QVariant::fromValue(weights) };
+        geometry.children << child;
+        child.name = "Ids";
+        child.properties = { QVariant::fromValue(ids) };
+        geometry.children << child;
+        child.name = "Flags";
+        child.properties = { QVariant::fromValue(flags) };
+        geometry.children << child;
+        child.name = "Empty";
+        child.properties = { QVariant::fromValue(QVector<double>()) };
+        geometry.children << child;
+        child.name = "Small";
+        child.properties = { QVariant::fromValue(QVector<qint32>({ 1, 2, 3 })) };
+        geometry.children << child;
+
+        objects.children << geometry;
+    }
+    root.children << objects;
+
+    return root;
+}
+
+static QStringList getCorpus() {
+    QString corpus = qgetenv(CORPUS_ENV_VARIABLE);
+    if (corpus.isEmpty()) {
+        return QStringList();
+    }
+    QDir dir(corpus);
+    QStringList files;
+    foreach (const QString& filename, dir.entryList(QStringList("*.fbx"), QDir::Files, QDir::Name)) {
+        files << dir.filePath(filename);
+    }
+    return files;
+}
+
+// Peak resident memory since the last reset, or -1 where the platform doesn't expose it
+static void resetPeakMemory() {
+#ifdef Q_OS_LINUX
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+#endif
+}
+
+static qint64 getMemoryStatus(const char* field) {
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        foreach (const QByteArray& line, status.readAll().split('\n')) {
+            if (line.startsWith(field)) {
+                return line.mid(strlen(field)).trimmed().split(' ').first().toLongLong() * 1024;
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+template<class F>
+static void measureParse(const char* label, const hifi::ByteArray& data, F parse) {
+    const int NUM_PARSES = 5;
+
+    qint64 baseline = getMemoryStatus("VmRSS:");
+    resetPeakMemory();
+    quint64 bestTime = std::numeric_limits<quint64>::max();
+    for (int i = 0; i < NUM_PARSES; i++) {
+        quint64 start = usecTimestampNow();
+        FBXNode root = parse(data);
+        bestTime = std::min(bestTime, usecTimestampNow() - start);
+    }
+    qint64 peak = getMemoryStatus("VmHWM:");
+
+    qDebug() << label << (float)bestTime / USECS_PER_MSEC << "msecs,"
+        << (peak < 0 || baseline < 0 ? QString("peak memory unavailable")
+                                     : QString("%1 MB peak over baseline").arg((float)(peak - baseline) / MB_TO_BYTES(1)));
+}
+
+void FBXParserTests::testBinaryMatchesLegacy() {
+    FBXNode document = makeDocument(4, 2000);
+    hifi::ByteArray data = FBXWriter::encodeFBX(document);
+
+    FBXNode parsed = FBXSerializer::parseFBX(data);
+    compareNodes(parsed, legacy::parseFBX(data));
+    compareNodes(parsed, document);
+
+    // the stream overload goes through the same reader
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    compareNodes(FBXSerializer::parseFBX(&buffer), parsed);
+
+    // parsing from a view of the data leaves nothing pointing at it
+    hifi::ByteArray copy = data;
+    FBXNode fromRawData = FBXSerializer::parseFBX(hifi::ByteArray::fromRawData(copy.constData(), copy.size()));
+    copy.fill(0);
+    compareNodes(fromRawData, parsed);
+}
+
+void FBXParserTests::testTruncated() {
+    hifi::ByteArray data = FBXWriter::encodeFBX(makeDocument(1, 2000));
+
+    // mid-way through the arrays of the only geometry
+    QVERIFY_EXCEPTION_THROWN(FBXSerializer::parseFBX(data.left(data.size() / 2)), QString);
+    QVERIFY_EXCEPTION_THROWN(FBXSerializer::parseFBX(data.left(FBX_HEADER_BYTES_BEFORE_VERSION + 2)), QString);
+}
+
+void FBXParserTests::testCorpusMatchesLegacy() {
+    QStringList files = getCorpus();
+    if (files.isEmpty()) {
+        QSKIP("Set HIFI_FBX_CORPUS to a directory of .fbx files to compare against the legacy parser");
+    }
+
+    foreach (const QString& path, files) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        uchar* mapped = file.map(0, file.size());
+        QVERIFY(mapped);
+        hifi::ByteArray data = hifi::ByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file.size());
+        if (!data.startsWith(FBX_BINARY_PROLOG)) {
+            continue;
+        }
+        qDebug() << "Comparing" << path;
+
+        FBXSerializer serializer;
+        HFMModel::Pointer model = serializer.read(data, hifi::VariantHash(), QUrl::fromLocalFile(path));
+        QVERIFY(model);
+
+        FBXSerializer legacySerializer;
+        legacySerializer._rootNode = legacy::parseFBX(data);
+        compareNodes(serializer._rootNode, legacySerializer._rootNode);
+        std::unique_ptr<HFMModel> legacyModel(legacySerializer.extractHFMModel(hifi::VariantHash(), QUrl::fromLocalFile(path).toString()));
+        compareModels(*model, *legacyModel);
+
+        file.unmap(mapped);
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+    }
+}
+
+void FBXParserTests::benchmarkCorpus() {
+    QList<QPair<QString, hifi::ByteArray>> documents;
+    foreach (const QString& path, getCorpus()) {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly)) {
+            hifi::ByteArray data = file.readAll();
+            if (data.startsWith(FBX_BINARY_PROLOG)) {
+                documents << qMakePair(QFileInfo(path).fileName(), data);
+            }
+        }
+    }
+    if (documents.isEmpty()) {
+        // roughly a dense avatar: a few meshes of some hundred thousand vertices
+        const int NUM_GEOMETRIES = 8;
+        const int NUM_VERTICES = 100000;
+        documents << qMakePair(QString("generated"), FBXWriter::encodeFBX(makeDocument(NUM_GEOMETRIES, NUM_VERTICES)));
+    }
+
+    foreach (const auto& document, documents) {
+        qDebug() << document.first << (float)document.second.size() / MB_TO_BYTES(1) << "MB";
+        measureParse("  legacy:", document.second, legacy::parseFBX);
+        measureParse("  in place:", document.second, [](const hifi::ByteArray& data) {
+            return FBXSerializer::parseFBX(data);
+        });
+    }
+}
@@ -0,0 +1,25 @@
+//
+//  FBXParserTests.h
+//  tests/fbx/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXParserTests_h
+#define hifi_FBXParserTests_h
+
+#include <QtTest/QtTest>
+
+class FBXParserTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testBinaryMatchesLegacy();
+    void testTruncated();
+    void testCorpusMatchesLegacy();
+    void benchmarkCorpus();
+};
+
+#endif // hifi_FBXParserTests_h
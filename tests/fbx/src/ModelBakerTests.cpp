@@ -0,0 +1,157 @@
+//
+//  ModelBakerTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ModelBakerTests.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QThread>
+
+#include <SharedUtil.h>
+#include <NumericalConstants.h>
+#include <model-baker/Baker.h>
+#include <model-baker/BakedModelCodec.h>
+
+#include <test-utils/QTestExtensions.h>
+
+QTEST_MAIN(ModelBakerTests)
+
+// An avatar-like model: several rippled grids, none with normals or tangents of their own, each with a set of
+// blendshapes moving a band of its vertices, so that every per-mesh and per-blendshape task has work to do
+static HFMModel::Pointer makeAvatar(int numMeshes, int gridSize, int numBlendshapes) {
+    auto hfmModel = std::make_shared<HFMModel>();
+    hfmModel->originalURL = "file:///avatar.fbx";
+    hfmModel->hasSkeletonJoints = false;
+
+    HFMJoint joint;
+    joint.parentIndex = -1;
+    joint.distanceToParent = 0.0f;
+    joint.translation = glm::vec3(0.0f);
+    joint.preTransform = joint.postTransform = joint.transform = glm::mat4();
+    joint.preRotation = joint.rotation = joint.postRotation = glm::quat();
+    joint.inverseDefaultRotation = joint.inverseBindRotation = glm::quat();
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.bindTransform = joint.geometricOffset = joint.localTransform = joint.globalTransform = glm::mat4();
+    joint.name = "Hips";
+    joint.isSkeletonJoint = false;
+    joint.bindTransformFoundInCluster = false;
+    hfmModel->joints.push_back(joint);
+    hfmModel->jointIndices.insert(joint.name, 1);
+
+    HFMMaterial material;
+    material.materialID = "skin";
+    hfmModel->materials.push_back(material);
+
+    int rowSize = gridSize + 1;
+    for (int m = 0; m < numMeshes; m++) {
+        HFMMesh mesh;
+        mesh.meshIndex = m;
+        mesh.modelTransform = glm::mat4();
+        for (int y = 0; y <= gridSize; y++) {
+            for (int x = 0; x <= gridSize; x++) {
+                float height = 0.1f * sinf(0.3f * x + 0.2f * y + m);
+                mesh.vertices << glm::vec3(x, y, height);
+                mesh.texCoords << glm::vec2((float)x / gridSize, (float)y / gridSize);
+                mesh.meshExtents.addPoint(mesh.vertices.back());
+            }
+        }
+        HFMMeshPart part;
+        for (int y = 0; y < gridSize; y++) {
+            for (int x = 0; x < gridSize; x++) {
+                int corner = y * rowSize + x;
+                part.triangleIndices << corner << corner + 1 << corner + rowSize + 1;
+                part.triangleIndices << corner << corner + rowSize + 1 << corner + rowSize;
+            }
+        }
+        mesh.parts.push_back(part);
+
+        for (int b = 0; b < numBlendshapes; b++) {
+            HFMBlendshape blendshape;
+            int firstRow = (b * gridSize) / numBlendshapes;
+            for (int i = firstRow * rowSize; i < std::min(firstRow + 4, rowSize) * rowSize; i++) {
+                blendshape.indices << i;
+                blendshape.vertices << mesh.vertices[i] + glm::vec3(0.0f, 0.0f, 0.05f * (b + 1));
+            }
+            mesh.blendshapes << blendshape;
+        }
+        hfmModel->meshes.push_back(mesh);
+
+        HFMShape shape;
+        shape.mesh = m;
+        shape.meshPart = 0;
+        shape.material = 0;
+        shape.joint = 0;
+        hfmModel->shapes.push_back(shape);
+    }
+    return hfmModel;
+}
+
+struct BakeResult {
+    hifi::ByteArray model;
+    std::vector<hifi::ByteArray> dracoMeshes;
+};
+
+static BakeResult bake(const HFMModel::Pointer& hfmModel, int maxConcurrency) {
+    baker::Baker modelBaker(hfmModel, hifi::VariantHash(), hifi::URL());
+    modelBaker.getConfiguration()->getJobConfig("BuildDracoMesh")->setEnabled(true);
+    modelBaker.setMaxConcurrency(maxConcurrency);
+    modelBaker.run();
+    return { baker::BakedModelCodec::encode(*modelBaker.getHFMModel()), modelBaker.getDracoMeshes() };
+}
+
+void ModelBakerTests::testConcurrentMatchesSerial() {
+    const int NUM_MESHES = 6;
+    const int GRID_SIZE = 24;
+    const int NUM_BLENDSHAPES = 8;
+
+    // the baker builds its output on the model it is given, so each run gets its own
+    BakeResult serial = bake(makeAvatar(NUM_MESHES, GRID_SIZE, NUM_BLENDSHAPES), 1);
+    QVERIFY(!serial.model.isEmpty());
+    QCOMPARE((int)serial.dracoMeshes.size(), NUM_MESHES);
+
+    for (int maxConcurrency : { 2, 4, (int)baker::BakeContext::AUTOMATIC_CONCURRENCY }) {
+        BakeResult concurrent = bake(makeAvatar(NUM_MESHES, GRID_SIZE, NUM_BLENDSHAPES), maxConcurrency);
+        QCOMPARE(concurrent.model, serial.model);
+        QVERIFY(concurrent.dracoMeshes == serial.dracoMeshes);
+    }
+}
+
+void ModelBakerTests::benchmarkConcurrency() {
+    // roughly a detailed avatar: dozens of meshes, the face ones carrying a full set of blendshapes
+    const int NUM_MESHES = 32;
+    const int GRID_SIZE = 96;
+    const int NUM_BLENDSHAPES = 52;
+    const int NUM_BAKES = 3;
+
+    qDebug() << NUM_MESHES << "meshes," << (GRID_SIZE + 1) * (GRID_SIZE + 1) << "vertices and"
+        << NUM_BLENDSHAPES << "blendshapes each," << QThread::idealThreadCount() << "hardware threads";
+
+    QList<int> concurrencies { 1, 2, 4, 8, (int)baker::BakeContext::AUTOMATIC_CONCURRENCY };
+    quint64 serialTime = 0;
+    foreach (int maxConcurrency, concurrencies) {
+        quint64 bestTime = std::numeric_limits<quint64>::max();
+        for (int i = 0; i < NUM_BAKES; i++) {
+            auto hfmModel = makeAvatar(NUM_MESHES, GRID_SIZE, NUM_BLENDSHAPES);
+            quint64 start = usecTimestampNow();
+            baker::Baker modelBaker(hfmModel, hifi::VariantHash(), hifi::URL());
+            modelBaker.getConfiguration()->getJobConfig("BuildDracoMesh")->setEnabled(true);
+            modelBaker.setMaxConcurrency(maxConcurrency);
+            modelBaker.run();
+            bestTime = std::min(bestTime, usecTimestampNow() - start);
+        }
+        if (maxConcurrency == 1) {
+            serialTime = bestTime;
+        }
+        qDebug() << "  max concurrency" << (maxConcurrency == baker::BakeContext::AUTOMATIC_CONCURRENCY ? QString("automatic") : QString::number(maxConcurrency))
+            << ":" << (float)bestTime / USECS_PER_MSEC << "msecs," << (float)serialTime / bestTime << "x";
+    }
+}
@@ -0,0 +1,23 @@
+//
+//  ModelBakerTests.h
+//  tests/fbx/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ModelBakerTests_h
+#define hifi_ModelBakerTests_h
+
+#include <QtTest/QtTest>
+
+class ModelBakerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testConcurrentMatchesSerial();
+    void benchmarkConcurrency();
+};
+
+#endif // hifi_ModelBakerTests_h
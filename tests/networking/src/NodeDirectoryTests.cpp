@@ -0,0 +1,270 @@
+//
+//  NodeDirectoryTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeDirectoryTests.h"
+
+#include <memory>
+#include <random>
+
+#include <NLPacketList.h>
+#include <Node.h>
+#include <NodeDirectory.h>
+#include <NodePermissions.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(NodeDirectoryTests)
+
+static QList<QUuid> changesSince(const NodeDirectory& directory, NodeDirectory::Version version) {
+    QList<QUuid> changes;
+    directory.forEachChangeSince(version, [&](const QUuid& nodeUUID) {
+        changes << nodeUUID;
+    });
+    return changes;
+}
+
+void NodeDirectoryTests::testChangesSince() {
+    NodeDirectory directory;
+    QVERIFY(!directory.hasChangesSince(NodeDirectory::NO_VERSION));
+
+    QUuid nodeA = QUuid::createUuid();
+    QUuid nodeB = QUuid::createUuid();
+    QUuid nodeC = QUuid::createUuid();
+    directory.nodeChanged(nodeA);
+    NodeDirectory::Version afterA = directory.getVersion();
+    directory.nodeChanged(nodeB);
+    directory.nodeChanged(nodeC);
+    QCOMPARE(changesSince(directory, afterA), QList<QUuid>({ nodeB, nodeC }));
+    QCOMPARE(changesSince(directory, NodeDirectory::NO_VERSION), QList<QUuid>({ nodeA, nodeB, nodeC }));
+
+    // only the last change of a node is kept, and removed nodes are forgotten
+    directory.nodeChanged(nodeB);
+    QCOMPARE(changesSince(directory, afterA), QList<QUuid>({ nodeC, nodeB }));
+    directory.nodeRemoved(nodeC, 3);
+    QCOMPARE(changesSince(directory, afterA), QList<QUuid>({ nodeB }));
+    QCOMPARE(directory.getNumNodes(), 2);
+
+    // a version from another run of the domain-server
+    QVERIFY(directory.hasChangesSince(afterA));
+    QVERIFY(!directory.hasChangesSince(directory.getVersion() + 1));
+
+    NodeDirectory::Version version = directory.newVersion();
+    QVERIFY(directory.hasChangesSince(version));
+    QVERIFY(changesSince(directory, version).isEmpty());
+
+    directory.invalidate();
+    QVERIFY(!directory.hasChangesSince(version));
+    QVERIFY(directory.hasChangesSince(directory.getVersion()));
+}
+
+void NodeDirectoryTests::testConnectionSecrets() {
+    NodeDirectory directory;
+    QUuid secretAB = directory.getConnectionSecret(1, 2);
+    QVERIFY(!secretAB.isNull());
+    QCOMPARE(directory.getConnectionSecret(2, 1), secretAB);
+
+    QUuid secretAC = directory.getConnectionSecret(1, 3);
+    QUuid secretBC = directory.getConnectionSecret(3, 2);
+    QVERIFY(secretAC != secretAB && secretBC != secretAB && secretBC != secretAC);
+    QCOMPARE(directory.getNumConnectionSecrets(), 3);
+
+    // a node coming back with the same local ID gets new secrets
+    directory.nodeRemoved(QUuid::createUuid(), 1);
+    QCOMPARE(directory.getNumConnectionSecrets(), 1);
+    QCOMPARE(directory.getConnectionSecret(2, 3), secretBC);
+    QVERIFY(directory.getConnectionSecret(1, 2) != secretAB);
+}
+
+// A domain of the assignment clients and a thousand agents checking in every second, with agents coming and going,
+// as the domain-server answers the check ins: with the full list each time, or with what changed since the list each
+// node acknowledged.  Counts the DomainList packets and the nodes written to them, the nodes visited to make the lists,
+// and times making them.
+void NodeDirectoryTests::benchmarkCheckIns() {
+    const int NUM_AGENTS = 1000;
+    const int NUM_SECONDS = 10;
+    const int AGENTS_JOINING_PER_SECOND = 10;
+
+    const NodeSet ASSIGNMENT_TYPES {
+        NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer,
+        NodeType::AssetServer, NodeType::MessagesMixer, NodeType::EntityScriptServer
+    };
+
+    class SimulatedNode {
+    public:
+        SharedNodePointer node;
+        NodeSet interestSet;
+        NodeDirectory::Version acknowledgedVersion { NodeDirectory::NO_VERSION };
+        QSet<QUuid> knownNodes;
+    };
+    using SimulatedNodePointer = std::shared_ptr<SimulatedNode>;
+
+    class Stats {
+    public:
+        uint64_t numPackets { 0 };
+        uint64_t numListedNodes { 0 };
+        uint64_t numVisitedNodes { 0 };
+        uint64_t usecs { 0 };
+    };
+
+    auto runDomain = [&](bool sendChanges, Stats& stats) {
+        NodeDirectory directory;
+        std::vector<SimulatedNodePointer> nodes;
+        QHash<QUuid, SimulatedNodePointer> nodesByUUID;
+        NetworkLocalID nextLocalID = 1;
+        quint32 domainListNumber = 0;
+        std::mt19937 generator;
+
+        auto isListed = [](const SimulatedNode& to, const SimulatedNode& other) {
+            return &other != &to && to.interestSet.contains(other.node->getType());
+        };
+
+        auto sendList = [&](SimulatedNode& to, bool newConnection) {
+            uint64_t start = usecTimestampNow();
+            std::vector<SimulatedNode*> listedNodes;
+            if (sendChanges && !newConnection && directory.hasChangesSince(to.acknowledgedVersion)) {
+                directory.forEachChangeSince(to.acknowledgedVersion, [&](const QUuid& otherNodeUUID) {
+                    ++stats.numVisitedNodes;
+                    auto other = nodesByUUID.value(otherNodeUUID);
+                    if (other && isListed(to, *other)) {
+                        listedNodes.push_back(other.get());
+                    }
+                });
+            } else {
+                for (auto& other : nodes) {
+                    ++stats.numVisitedNodes;
+                    if (isListed(to, *other)) {
+                        listedNodes.push_back(other.get());
+                    }
+                }
+            }
+
+            // the extended header of the domain-server's lists
+            QByteArray extendedHeader;
+            QDataStream headerStream(&extendedHeader, QIODevice::WriteOnly);
+            headerStream << QUuid::createUuid() << NetworkLocalID(0) << to.node->getUUID() << to.node->getLocalID();
+            headerStream << to.node->getPermissions() << true << quint64(0) << quint64(0) << quint64(0) << newConnection;
+            headerStream << directory.getVersion() << domainListNumber++ << quint32(listedNodes.size());
+
+            auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
+            QDataStream domainListStream(domainListPackets.get());
+            for (auto other : listedNodes) {
+                domainListPackets->startSegment();
+                domainListStream << *other->node;
+                domainListStream << directory.getConnectionSecret(to.node->getLocalID(), other->node->getLocalID());
+                domainListPackets->endSegment();
+            }
+            domainListPackets->closeCurrentPacket(true);
+            stats.usecs += usecTimestampNow() - start;
+
+            stats.numPackets += domainListPackets->getNumPackets();
+            stats.numListedNodes += listedNodes.size();
+            for (auto other : listedNodes) {
+                to.knownNodes.insert(other->node->getUUID());
+            }
+            to.acknowledgedVersion = directory.getVersion();
+        };
+
+        auto addNode = [&](NodeType_t type, const NodeSet& interestSet) {
+            auto simulated = std::make_shared<SimulatedNode>();
+            quint16 port = 40000 + nextLocalID;
+            simulated->node = SharedNodePointer::create(QUuid::createUuid(), type,
+                HifiSockAddr(QHostAddress::LocalHost, port), HifiSockAddr(QHostAddress::LocalHost, port));
+            simulated->node->setLocalID(nextLocalID++);
+            simulated->interestSet = interestSet;
+            nodes.push_back(simulated);
+            nodesByUUID.insert(simulated->node->getUUID(), simulated);
+
+            sendList(*simulated, true);
+
+            // as broadcastNewNode does
+            directory.nodeChanged(simulated->node->getUUID());
+            for (auto& other : nodes) {
+                if (isListed(*other, *simulated)) {
+                    ++stats.numPackets;
+                    other->knownNodes.insert(simulated->node->getUUID());
+                }
+            }
+        };
+
+        auto removeNode = [&](size_t index) {
+            SimulatedNodePointer removed = nodes[index];
+            nodes[index] = nodes.back();
+            nodes.pop_back();
+            nodesByUUID.remove(removed->node->getUUID());
+            directory.nodeRemoved(removed->node->getUUID(), removed->node->getLocalID());
+
+            // as broadcastNodeDisconnect does
+            for (auto& other : nodes) {
+                if (isListed(*other, *removed)) {
+                    ++stats.numPackets;
+                    other->knownNodes.remove(removed->node->getUUID());
+                }
+            }
+        };
+
+        for (auto type : ASSIGNMENT_TYPES) {
+            NodeSet interestSet { NodeType::Agent };
+            if (type == NodeType::EntityScriptServer) {
+                interestSet += ASSIGNMENT_TYPES;
+                interestSet.remove(type);
+            }
+            addNode(type, interestSet);
+        }
+        for (int i = 0; i < NUM_AGENTS; ++i) {
+            addNode(NodeType::Agent, ASSIGNMENT_TYPES);
+        }
+
+        // the connections are not what is measured
+        stats = Stats();
+
+        for (int second = 0; second < NUM_SECONDS; ++second) {
+            for (int i = 0; i < AGENTS_JOINING_PER_SECOND; ++i) {
+                std::uniform_int_distribution<size_t> agent(ASSIGNMENT_TYPES.size(), nodes.size() - 1);
+                removeNode(agent(generator));
+                addNode(NodeType::Agent, ASSIGNMENT_TYPES);
+            }
+            for (auto& node : nodes) {
+                sendList(*node, false);
+            }
+        }
+
+        // every node knows of exactly the nodes it is interested in
+        for (auto& node : nodes) {
+            int numListed = 0;
+            for (auto& other : nodes) {
+                if (isListed(*node, *other)) {
+                    ++numListed;
+                    QVERIFY(node->knownNodes.contains(other->node->getUUID()));
+                }
+            }
+            QCOMPARE(node->knownNodes.size(), numListed);
+        }
+    };
+
+    Stats full;
+    runDomain(false, full);
+    Stats changes;
+    runDomain(true, changes);
+
+    QVERIFY(changes.numListedNodes < full.numListedNodes);
+    QVERIFY(changes.numVisitedNodes < full.numVisitedNodes);
+
+    int numNodes = NUM_AGENTS + ASSIGNMENT_TYPES.size();
+    qDebug() << numNodes << "nodes checking in every second for" << NUM_SECONDS << "seconds,"
+        << AGENTS_JOINING_PER_SECOND << "agents leaving and joining per second";
+    auto report = [&](const char* name, const Stats& stats) {
+        qDebug() << "  " << name << ":" << (float)stats.numPackets / NUM_SECONDS << "packets,"
+            << (float)stats.numListedNodes / NUM_SECONDS << "nodes listed,"
+            << (float)stats.numVisitedNodes / NUM_SECONDS << "nodes visited,"
+            << (float)stats.usecs / NUM_SECONDS / USECS_PER_MSEC << "msecs making the lists, per second";
+    };
+    report("full lists", full);
+    report("changes   ", changes);
+}
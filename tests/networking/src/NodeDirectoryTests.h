@@ -0,0 +1,25 @@
+//
+//  NodeDirectoryTests.h
+//  tests/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeDirectoryTests_h
+#define hifi_NodeDirectoryTests_h
+
+#include <QtTest/QtTest>
+
+class NodeDirectoryTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testChangesSince();
+    void testConnectionSecrets();
+    void benchmarkCheckIns();
+};
+
+#endif // hifi_NodeDirectoryTests_h
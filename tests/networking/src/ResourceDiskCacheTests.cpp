@@ -0,0 +1,126 @@
+//
+//  ResourceDiskCacheTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceDiskCacheTests.h"
+
+#include <ResourceDiskCache.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_GUILESS_MAIN(ResourceDiskCacheTests)
+
+static const QString TEST_TYPE { "Test" };
+static const int TEST_VERSION { 1 };
+
+static ResourceDiskCachePointer makeDiskCache(const QString& location) {
+    auto result = std::make_shared<ResourceDiskCache>(location.toStdString());
+    result->initialize();
+    return result;
+}
+
+static QByteArray makePayload(int seed, int size) {
+    QByteArray payload(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        payload[i] = (char)(seed + i * 31);
+    }
+    return payload;
+}
+
+void ResourceDiskCacheTests::testRoundTrip() {
+    auto cache = makeDiskCache(_testDir.path() + "/roundTrip");
+    auto source = makePayload(1, 1024);
+    auto key = ResourceDiskCache::computeKey(TEST_TYPE, TEST_VERSION, source);
+
+    // the key changes with the type version, so stale formats are never read back
+    QVERIFY(key != ResourceDiskCache::computeKey(TEST_TYPE, TEST_VERSION + 1, source));
+
+    QVERIFY(!cache->readPayload(key));
+    QCOMPARE(cache->getNumMisses(), (size_t)1);
+
+    auto payload = makePayload(2, 4096);
+    QVERIFY(cache->writePayload(key, payload));
+
+    auto entry = cache->readPayload(key);
+    QVERIFY(entry);
+    QCOMPARE(cache->getNumHits(), (size_t)1);
+    QCOMPARE(QByteArray(entry->data(), (int)entry->size()), payload);
+}
+
+void ResourceDiskCacheTests::testPersistence() {
+    const QString location = _testDir.path() + "/persistence";
+    auto payload = makePayload(3, 4096);
+    auto key = ResourceDiskCache::computeKey(TEST_TYPE, TEST_VERSION, makePayload(4, 1024));
+    {
+        auto cache = makeDiskCache(location);
+        QVERIFY(cache->writePayload(key, payload));
+    }
+
+    // a new session should find the payload written by the previous one
+    auto cache = makeDiskCache(location);
+    auto entry = cache->readPayload(key);
+    QVERIFY(entry);
+    QCOMPARE(QByteArray(entry->data(), (int)entry->size()), payload);
+}
+
+void ResourceDiskCacheTests::testCorruptEntry() {
+    const QString location = _testDir.path() + "/corrupt";
+    auto key = ResourceDiskCache::computeKey(TEST_TYPE, TEST_VERSION, makePayload(5, 1024));
+    QString filepath;
+    {
+        auto cache = makeDiskCache(location);
+        QVERIFY(cache->writePayload(key, makePayload(6, 4096)));
+        filepath = QDir(location).filePath(QString::fromStdString(key + "." + ResourceDiskCache::DEFAULT_EXT));
+    }
+
+    // flip a byte in the payload while the cache is offline
+    {
+        QFile file(filepath);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        file.seek(file.size() - 1);
+        char last;
+        file.getChar(&last);
+        file.seek(file.size() - 1);
+        file.putChar(~last);
+    }
+
+    auto cache = makeDiskCache(location);
+    QVERIFY(!cache->readPayload(key));
+    QVERIFY(!cache->readPayload(key));
+    QVERIFY(!QFile::exists(filepath));
+}
+
+void ResourceDiskCacheTests::testWarmLoad() {
+    // stand-in for a decoded sound: 10 seconds of 24kHz stereo
+    const int PAYLOAD_SIZE = 10 * 24000 * 2 * 2;
+    const int NUM_ENTRIES = 20;
+    const QString location = _testDir.path() + "/warmLoad";
+
+    std::vector<cache::FileCache::Key> keys;
+    {
+        auto cache = makeDiskCache(location);
+        auto start = usecTimestampNow();
+        for (int i = 0; i < NUM_ENTRIES; ++i) {
+            keys.push_back(ResourceDiskCache::computeKey(TEST_TYPE, TEST_VERSION, makePayload(i, 1024)));
+            QVERIFY(cache->writePayload(keys.back(), makePayload(i, PAYLOAD_SIZE)));
+        }
+        qDebug() << "Wrote" << NUM_ENTRIES << "entries in" << (usecTimestampNow() - start) / USECS_PER_MSEC << "ms";
+    }
+
+    auto start = usecTimestampNow();
+    auto cache = makeDiskCache(location);
+    size_t totalBytes = 0;
+    for (const auto& key : keys) {
+        auto entry = cache->readPayload(key);
+        QVERIFY(entry);
+        totalBytes += entry->size();
+    }
+    qDebug() << "Warm load of" << totalBytes << "bytes took" << (usecTimestampNow() - start) / USECS_PER_MSEC << "ms";
+    QCOMPARE(cache->getNumHits(), (size_t)NUM_ENTRIES);
+}
@@ -0,0 +1,29 @@
+//
+//  ResourceDiskCacheTests.h
+//  tests/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceDiskCacheTests_h
+#define hifi_ResourceDiskCacheTests_h
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+
+class ResourceDiskCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRoundTrip();
+    void testPersistence();
+    void testCorruptEntry();
+    void testWarmLoad();
+
+private:
+    QTemporaryDir _testDir;
+};
+
+#endif // hifi_ResourceDiskCacheTests_h
@@ -0,0 +1,209 @@
+//
+//  ResourceSchedulerTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceSchedulerTests.h"
+
+#include <ResourceCache.h>
+#include <DependencyManager.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(ResourceSchedulerTests)
+
+// stands in for a local file server with a fixed transfer rate per request
+static const qint64 BYTES_PER_MSEC = 16 * 1024;
+
+class SchedulerTestCache : public ResourceCache {
+public:
+    static void complete(QWeakPointer<Resource> resource) { requestCompleted(resource); }
+
+protected:
+    QSharedPointer<Resource> createResource(const QUrl& url) override { return QSharedPointer<Resource>(); }
+    QSharedPointer<Resource> createResourceCopy(const QSharedPointer<Resource>& resource) override { return resource; }
+};
+
+class SimulatedResource : public Resource {
+public:
+    SimulatedResource(const QUrl& url, qint64 bytes) : Resource(url), _simulatedBytes(bytes) {
+        setEstimatedBytes(bytes);
+        _transfer.setSingleShot(true);
+        QObject::connect(&_transfer, &QTimer::timeout, this, &SimulatedResource::finish);
+    }
+
+    bool isPreemptible() const override { return _transfer.isActive(); }
+
+    void cancel() { _transfer.stop(); }
+
+    void receive(qint64 bytes) { _bytesReceived = bytes; }
+
+    void finish() {
+        _transfer.stop();
+        _bytesReceived = _bytesTotal = _simulatedBytes;
+        SchedulerTestCache::complete(_self);
+        finishedLoading(true);
+    }
+
+protected:
+    void makeRequest() override {
+        _bytesReceived = 0;
+        _bytesTotal = _simulatedBytes;
+        _transfer.start((int)(_simulatedBytes / BYTES_PER_MSEC));
+    }
+
+    void preempt() override { _transfer.stop(); }
+
+private:
+    const qint64 _simulatedBytes;
+    QTimer _transfer;
+};
+
+static SimulatedResource* simulated(const QSharedPointer<Resource>& resource) {
+    return static_cast<SimulatedResource*>(resource.data());
+}
+
+static QSharedPointer<Resource> makeResource(const QString& name, qint64 bytes, float priority, QObject* owner) {
+    QSharedPointer<Resource> resource(new SimulatedResource(QUrl("file:///" + name), bytes), &Resource::deleter);
+    resource->setSelf(resource);
+    resource->setLoadPriority(owner, priority);
+    return resource;
+}
+
+void ResourceSchedulerTests::initTestCase() {
+    DependencyManager::set<ResourceCacheSharedItems>();
+}
+
+void ResourceSchedulerTests::cleanupTestCase() {
+    DependencyManager::destroy<ResourceCacheSharedItems>();
+}
+
+void ResourceSchedulerTests::testSchedulingScore() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    auto small = makeResource("small", 64 * 1024, 1.0f, this);
+    auto large = makeResource("large", 64 * 1024 * 1024, 1.0f, this);
+    auto unknown = makeResource("unknown", 0, 1.0f, this);
+
+    QVERIFY(sharedItems->getSchedulingScore(small) > sharedItems->getSchedulingScore(large));
+    QCOMPARE(sharedItems->getSchedulingScore(unknown), 1.0f);
+
+    // priority still dominates when it is far apart
+    auto important = makeResource("important", 64 * 1024 * 1024, 10.0f, this);
+    QVERIFY(sharedItems->getSchedulingScore(important) > sharedItems->getSchedulingScore(small));
+
+    sharedItems->setByteCostWeight(0.0f);
+    QCOMPARE(sharedItems->getSchedulingScore(small), sharedItems->getSchedulingScore(large));
+}
+
+void ResourceSchedulerTests::testPreemption() {
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    sharedItems->clear();
+    sharedItems->setRequestLimit(1);
+    sharedItems->setByteCostWeight(0.05f);
+    sharedItems->setPreemptionEnabled(true);
+
+    // a transfer of unknown size is kept once it has received much, however unimportant
+    auto unknown = makeResource("unknown", 0, 0.1f, this);
+    unknown->ensureLoading();
+    simulated(unknown)->receive(1024 * 1024);
+
+    auto important = makeResource("important", 64 * 1024, 10.0f, this);
+    important->ensureLoading();
+    QVERIFY(sharedItems->getLoadingRequests().contains(unknown));
+    QVERIFY(sharedItems->getPendingRequests().contains(important));
+
+    // and preempted while it hasn't, going back to the queue
+    simulated(unknown)->receive(0);
+    QCOMPARE(sharedItems->takePreemptedRequest(important), unknown);
+    QMetaObject::invokeMethod(unknown.data(), "handlePreemption");
+    QVERIFY(!unknown->isPreemptible());
+    QVERIFY(sharedItems->getLoadingRequests().contains(important));
+    QVERIFY(sharedItems->getPendingRequests().contains(unknown));
+    simulated(important)->finish();
+
+    // a transfer that finishes before its preemption runs isn't queued again
+    sharedItems->clear();
+    auto finished = makeResource("finished", 0, 0.1f, this);
+    finished->ensureLoading();
+    important = makeResource("important", 64 * 1024, 10.0f, this);
+    important->ensureLoading();
+    QCOMPARE(sharedItems->getPendingRequestsCount(), 1u);
+    QCOMPARE(sharedItems->takePreemptedRequest(important), finished);
+    simulated(finished)->finish();
+    QMetaObject::invokeMethod(finished.data(), "handlePreemption");
+    QVERIFY(finished->isLoaded());
+    QCOMPARE(sharedItems->getPendingRequestsCount(), 0u);
+
+    for (const auto& resource : { unknown, important, finished }) {
+        simulated(resource)->cancel();
+    }
+    sharedItems->clear();
+}
+
+quint64 ResourceSchedulerTests::timeToLoadImportantResources(bool prioritizeBySize) {
+    const uint32_t REQUEST_LIMIT = 4;
+    const int NUM_LARGE = 8;
+    const int NUM_SMALL = 16;
+    const qint64 LARGE_BYTES = 8 * 1024 * 1024;
+    const qint64 SMALL_BYTES = 64 * 1024;
+    const float FAR_PRIORITY = 0.1f;
+    const float NEAR_PRIORITY = 1.4f;
+
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    sharedItems->clear();
+    sharedItems->setRequestLimit(REQUEST_LIMIT);
+    sharedItems->setByteCostWeight(prioritizeBySize ? 0.05f : 0.0f);
+    sharedItems->setPreemptionEnabled(prioritizeBySize);
+
+    // large far away models are requested first, as they are on domain entry, then nearby small textures
+    QList<QSharedPointer<Resource>> resources;
+    for (int i = 0; i < NUM_LARGE; ++i) {
+        resources.append(makeResource("large" + QString::number(i), LARGE_BYTES, FAR_PRIORITY, this));
+        resources.back()->ensureLoading();
+    }
+
+    QList<QSharedPointer<Resource>> important;
+    auto start = usecTimestampNow();
+    for (int i = 0; i < NUM_SMALL; ++i) {
+        important.append(makeResource("small" + QString::number(i), SMALL_BYTES, NEAR_PRIORITY, this));
+        important.back()->ensureLoading();
+    }
+
+    const quint64 TIMEOUT = 10 * USECS_PER_SECOND;
+    auto allLoaded = [&] {
+        foreach (const auto& resource, important) {
+            if (!resource->isLoaded()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    while (!allLoaded() && usecTimestampNow() - start < TIMEOUT) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+    }
+    auto elapsed = usecTimestampNow() - start;
+
+    qDebug() << (prioritizeBySize ? "Priority-per-byte with preemption:" : "Priority only:")
+        << "top" << NUM_SMALL << "resources loaded in" << elapsed / USECS_PER_MSEC << "ms,"
+        << sharedItems->getPreemptedRequestsCount() << "preemptions so far,"
+        << sharedItems->getPendingRequestsCount() << "still queued";
+
+    // make sure nothing from this run completes during the next one
+    foreach (const auto& resource, resources + important) {
+        simulated(resource)->cancel();
+    }
+    sharedItems->clear();
+    return elapsed;
+}
+
+void ResourceSchedulerTests::testImportantResourcesFirst() {
+    auto priorityOnly = timeToLoadImportantResources(false);
+    auto prioritizedBySize = timeToLoadImportantResources(true);
+    QVERIFY(prioritizedBySize < priorityOnly);
+    QVERIFY(DependencyManager::get<ResourceCacheSharedItems>()->getPreemptedRequestsCount() > 0);
+}
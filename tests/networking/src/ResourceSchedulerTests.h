@@ -0,0 +1,29 @@
+//
+//  ResourceSchedulerTests.h
+//  tests/networking/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceSchedulerTests_h
+#define hifi_ResourceSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class ResourceSchedulerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testSchedulingScore();
+    void testPreemption();
+    void testImportantResourcesFirst();
+    void cleanupTestCase();
+
+private:
+    quint64 timeToLoadImportantResources(bool prioritizeBySize);
+};
+
+#endif // hifi_ResourceSchedulerTests_h
@@ -0,0 +1,302 @@
+//
+//  EntitySimulationTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySimulationTests.h"
+
+#include <algorithm>
+#include <random>
+
+#include <QtCore/QThread>
+
+#include <AddEntityOperator.h>
+#include <DenseEntitySet.h>
+#include <EntityTree.h>
+#include <EntityTypes.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <SimpleEntitySimulation.h>
+
+QTEST_MAIN(EntitySimulationTests)
+
+static EntityItemPointer makeEntity(uint64_t created, float lifetime) {
+    EntityItemProperties properties;
+    auto entity = EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+    entity->setCreated(created);
+    entity->setLifetime(lifetime);
+    return entity;
+}
+
+// a kinematic entity in the tree, drifting without damping so that its motion does not depend on the steps it takes
+static EntityItemPointer addMovingEntity(const EntityTreePointer& tree, const glm::vec3& position, const glm::vec3& velocity) {
+    EntityItemProperties properties;
+    properties.setPosition(position);
+    properties.setVelocity(velocity);
+    properties.setDamping(0.0f);
+    auto entity = EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+    entity->updateQueryAACube();
+    AddEntityOperator addOperator(tree, entity);
+    tree->recurseTreeWithOperator(&addOperator);
+    return entity;
+}
+
+static SimpleEntitySimulationPointer makeSimulation(const EntityTreePointer& tree) {
+    auto simulation = std::make_shared<SimpleEntitySimulation>();
+    simulation->setEntityTree(tree);
+    return simulation;
+}
+
+void EntitySimulationTests::testExpiry() {
+    auto tree = std::make_shared<EntityTree>();
+    auto simulation = makeSimulation(tree);
+    uint64_t now = usecTimestampNow();
+
+    auto immortal = makeEntity(now, ENTITY_ITEM_IMMORTAL_LIFETIME);
+    auto expired = makeEntity(now - 2 * USECS_PER_SECOND, 1.0f);
+    auto mortal = makeEntity(now, 60.0f);
+    auto farFuture = makeEntity(now, 30.0f * 24.0f * 60.0f * 60.0f);
+    for (auto& entity : { immortal, expired, mortal, farFuture }) {
+        simulation->addEntity(entity);
+    }
+
+    simulation->updateEntities();
+    QVERIFY(expired->isDead());
+    QVERIFY(!expired->isSimulated());
+    QVERIFY(!immortal->isDead());
+    QVERIFY(!mortal->isDead());
+    QVERIFY(!farFuture->isDead());
+
+    // shortening a lifetime reschedules the entity
+    mortal->setLifetime(0.5f);
+    mortal->setCreated(now - USECS_PER_SECOND);
+    simulation->changeEntity(mortal);
+    simulation->processChangedEntities();
+    simulation->updateEntities();
+    QVERIFY(mortal->isDead());
+
+    // and making it immortal takes it out of the wheel
+    farFuture->setLifetime(ENTITY_ITEM_IMMORTAL_LIFETIME);
+    simulation->changeEntity(farFuture);
+    simulation->processChangedEntities();
+    farFuture->setLifetime(1.0f);
+    farFuture->setCreated(now - 2 * USECS_PER_SECOND);
+    farFuture->clearDirtyFlags();
+    simulation->updateEntities();
+    QVERIFY(!farFuture->isDead());
+
+    simulation->clearEntities();
+}
+
+void EntitySimulationTests::testDenseEntitySet() {
+    const int NUM_ENTITIES = 16;
+    std::vector<EntityItemPointer> entities;
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        entities.push_back(makeEntity(usecTimestampNow(), ENTITY_ITEM_IMMORTAL_LIFETIME));
+    }
+
+    DenseEntitySet set(EntityItem::SIMULATION_LIST_TO_UPDATE);
+    DenseEntitySet otherSet(EntityItem::SIMULATION_LIST_TO_SORT);
+    for (auto& entity : entities) {
+        QVERIFY(set.insert(entity));
+        QVERIFY(!set.insert(entity));
+    }
+    QVERIFY(otherSet.insert(entities[0]));
+    QCOMPARE((int)set.size(), NUM_ENTITIES);
+
+    for (int i = 0; i < NUM_ENTITIES; i += 3) {
+        QVERIFY(set.remove(entities[i]));
+        QVERIFY(!set.remove(entities[i]));
+    }
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        QCOMPARE(set.contains(entities[i]), i % 3 != 0);
+    }
+    for (size_t i = 0; i < set.size(); i++) {
+        QVERIFY(std::find(entities.begin(), entities.end(), set[i]) != entities.end());
+    }
+    // the lists are independent of each other
+    QVERIFY(otherSet.contains(entities[0]));
+
+    set.clear();
+    for (auto& entity : entities) {
+        QVERIFY(!set.contains(entity));
+    }
+    otherSet.clear();
+}
+
+// Keeps 50k mortal entities in the simulation, replacing them as they expire, and times updateEntities
+void EntitySimulationTests::benchmarkMortalChurn() {
+    const int NUM_ENTITIES = 50000;
+    const float MIN_LIFETIME = 0.05f;
+    const float MAX_LIFETIME = 2.0f;
+    const uint64_t CHURN_PERIOD = 3 * USECS_PER_SECOND;
+    const unsigned long FRAME_USECS = USECS_PER_SECOND / 60;
+
+    auto tree = std::make_shared<EntityTree>();
+    auto simulation = makeSimulation(tree);
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> lifetimes(MIN_LIFETIME, MAX_LIFETIME);
+
+    std::vector<EntityItemPointer> entities;
+    auto replenish = [&] {
+        uint64_t now = usecTimestampNow();
+        while (entities.size() < NUM_ENTITIES) {
+            entities.push_back(makeEntity(now, lifetimes(generator)));
+            simulation->addEntity(entities.back());
+        }
+    };
+    replenish();
+
+    int numFrames = 0;
+    size_t numExpired = 0;
+    uint64_t totalTime = 0;
+    uint64_t maxTime = 0;
+    uint64_t end = usecTimestampNow() + CHURN_PERIOD;
+    while (usecTimestampNow() < end) {
+        QThread::usleep(FRAME_USECS);
+
+        uint64_t start = usecTimestampNow();
+        simulation->updateEntities();
+        uint64_t elapsed = usecTimestampNow() - start;
+        totalTime += elapsed;
+        maxTime = std::max(maxTime, elapsed);
+        numFrames++;
+
+        size_t numBefore = entities.size();
+        entities.erase(std::remove_if(entities.begin(), entities.end(), [](const EntityItemPointer& entity) {
+            return entity->isDead();
+        }), entities.end());
+        numExpired += numBefore - entities.size();
+        replenish();
+    }
+    QVERIFY(numExpired > 0);
+
+    qDebug() << NUM_ENTITIES << "mortal entities," << numFrames << "frames," << numExpired << "expired and replaced";
+    qDebug() << "  updateEntities:" << (float)totalTime / numFrames / USECS_PER_MSEC << "msecs per frame,"
+        << (float)maxTime / USECS_PER_MSEC << "msecs at most";
+
+    simulation->clearEntities();
+}
+
+void EntitySimulationTests::testRegionThrottle() {
+    const int NUM_FRAMES = 40;
+    const unsigned long FRAME_USECS = USECS_PER_SECOND / 60;
+    const glm::vec3 VELOCITY(1.0f, 0.0f, 0.0f);
+
+    auto tree = std::make_shared<EntityTree>();
+    tree->getRoot();
+    auto simulation = makeSimulation(tree);
+    simulation->setRegionThrottleEnabled(true);
+    simulation->setAgentPositions({ glm::vec3(0.0f) });
+
+    auto nearEntity = addMovingEntity(tree, glm::vec3(1.0f, 0.0f, 0.0f), VELOCITY);
+    auto farEntity = addMovingEntity(tree, glm::vec3(2000.0f, 0.0f, 0.0f), VELOCITY);
+    simulation->addEntity(nearEntity);
+    simulation->addEntity(farEntity);
+    uint64_t farStart = farEntity->getLastSimulated();
+
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        QThread::usleep(FRAME_USECS);
+        simulation->updateEntities();
+    }
+
+    // the near entity steps every frame, the far one only now and then
+    uint64_t numSteps = simulation->getNumKinematicSteps();
+    uint64_t numHeldBack = simulation->getNumKinematicStepsHeldBack();
+    QVERIFY(numSteps + numHeldBack == 2 * NUM_FRAMES);
+    QVERIFY(numHeldBack > 0);
+    QVERIFY(numSteps > NUM_FRAMES);
+
+    // and whenever it steps it catches up with the time it was held back
+    const float EPSILON = 0.01f;
+    float farElapsed = (float)(farEntity->getLastSimulated() - farStart) / USECS_PER_SECOND;
+    QVERIFY(fabsf(farEntity->getWorldPosition().x - (2000.0f + farElapsed)) < EPSILON);
+
+    // an entity that stops moving loses its proxy, and gets one again when it moves again
+    QVERIFY(nearEntity->getSpaceIndex() != -1);
+    nearEntity->setVelocity(glm::vec3(0.0f));
+    for (int i = 0; i < 2; i++) {
+        QThread::usleep(FRAME_USECS);
+        simulation->updateEntities();
+    }
+    QVERIFY(nearEntity->getSpaceIndex() == -1);
+    QVERIFY(farEntity->getSpaceIndex() != -1);
+    nearEntity->setVelocity(VELOCITY);
+    simulation->changeEntity(nearEntity);
+    simulation->processChangedEntities();
+    QThread::usleep(FRAME_USECS);
+    simulation->updateEntities();
+    QVERIFY(nearEntity->getSpaceIndex() != -1);
+    numHeldBack = simulation->getNumKinematicStepsHeldBack();
+
+    // without the throttle everything steps again
+    simulation->setRegionThrottleEnabled(false);
+    QThread::usleep(FRAME_USECS);
+    simulation->updateEntities();
+    QVERIFY(simulation->getNumKinematicStepsHeldBack() == numHeldBack);
+    QVERIFY(farEntity->getLastSimulated() == nearEntity->getLastSimulated());
+    QVERIFY(farEntity->getSpaceIndex() == -1);
+
+    simulation->clearEntities();
+}
+
+// A sparse domain: moving entities scattered over a few kilometers and a few agents standing in it.  Times
+// updateEntities with every entity stepped every frame, as without the throttle, and with the ones nobody is near held
+// back by region.
+void EntitySimulationTests::benchmarkRegionThrottle() {
+    const int NUM_ENTITIES = 20000;
+    const int NUM_AGENTS = 16;
+    const float DOMAIN_EXTENT = 2048.0f;
+    const float MAX_SPEED = 2.0f;
+    const uint64_t RUN_PERIOD = 2 * USECS_PER_SECOND;
+    const unsigned long FRAME_USECS = USECS_PER_SECOND / 60;
+
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> position(-DOMAIN_EXTENT, DOMAIN_EXTENT);
+    std::uniform_real_distribution<float> speed(-MAX_SPEED, MAX_SPEED);
+    std::vector<glm::vec3> agentPositions;
+    for (int i = 0; i < NUM_AGENTS; i++) {
+        agentPositions.push_back(glm::vec3(position(generator), 0.0f, position(generator)));
+    }
+
+    for (bool throttled : { false, true }) {
+        auto tree = std::make_shared<EntityTree>();
+        tree->getRoot();
+        auto simulation = makeSimulation(tree);
+        simulation->setRegionThrottleEnabled(throttled);
+        simulation->setAgentPositions(agentPositions);
+        for (int i = 0; i < NUM_ENTITIES; i++) {
+            glm::vec3 entityPosition(position(generator), 0.5f * position(generator) / DOMAIN_EXTENT, position(generator));
+            glm::vec3 velocity(speed(generator), 0.0f, speed(generator));
+            simulation->addEntity(addMovingEntity(tree, entityPosition, velocity));
+        }
+
+        int numFrames = 0;
+        uint64_t totalTime = 0;
+        uint64_t maxTime = 0;
+        uint64_t end = usecTimestampNow() + RUN_PERIOD;
+        while (usecTimestampNow() < end) {
+            QThread::usleep(FRAME_USECS);
+            uint64_t start = usecTimestampNow();
+            simulation->updateEntities();
+            uint64_t elapsed = usecTimestampNow() - start;
+            totalTime += elapsed;
+            maxTime = std::max(maxTime, elapsed);
+            numFrames++;
+        }
+
+        qDebug() << NUM_ENTITIES << "moving entities," << NUM_AGENTS << "agents," << numFrames << "frames,"
+            << (throttled ? "throttled by region" : "unthrottled");
+        qDebug() << "  updateEntities:" << (float)totalTime / numFrames / USECS_PER_MSEC << "msecs per frame,"
+            << (float)maxTime / USECS_PER_MSEC << "msecs at most";
+        qDebug() << "  kinematic steps per frame:" << simulation->getNumKinematicSteps() / numFrames << "taken,"
+            << simulation->getNumKinematicStepsHeldBack() / numFrames << "held back";
+
+        simulation->clearEntities();
+    }
+}
@@ -0,0 +1,263 @@
+//
+//  EntitySpatialIndexTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySpatialIndexTests.h"
+
+#include <algorithm>
+#include <random>
+
+#include <AddEntityOperator.h>
+#include <EntitySpatialIndex.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <EntityTypes.h>
+#include <MovingEntitiesOperator.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntitySpatialIndexTests)
+
+const float WORLD_EXTENT = 512.0f;
+const float MIN_ENTITY_SCALE = 0.25f;
+const float MAX_ENTITY_SCALE = 4.0f;
+const float MIN_QUERY_RADIUS = 1.0f;
+const float MAX_QUERY_RADIUS = 32.0f;
+
+static std::mt19937 generator;
+
+static glm::vec3 randomPosition() {
+    std::uniform_real_distribution<float> position(-WORLD_EXTENT, WORLD_EXTENT);
+    return glm::vec3(position(generator), position(generator), position(generator));
+}
+
+static void placeEntity(const EntityItemPointer& entity, const glm::vec3& position) {
+    entity->setWorldPosition(position);
+    bool success;
+    entity->setQueryAACube(entity->getMaximumAACube(success));
+}
+
+static std::vector<EntityItemPointer> addEntities(const EntityTreePointer& tree, int numEntities) {
+    std::uniform_real_distribution<float> scale(MIN_ENTITY_SCALE, MAX_ENTITY_SCALE);
+    std::vector<EntityItemPointer> entities;
+    tree->getRoot();
+    for (int i = 0; i < numEntities; i++) {
+        EntityItemProperties properties;
+        auto entity = EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+        entity->setScaledDimensions(glm::vec3(scale(generator), scale(generator), scale(generator)));
+        placeEntity(entity, randomPosition());
+        AddEntityOperator addOperator(tree, entity);
+        tree->recurseTreeWithOperator(&addOperator);
+        tree->addEntityMapEntry(entity);
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
+static QVector<QUuid> sorted(QVector<QUuid> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+class RayHit {
+public:
+    EntityItemID entityID;
+    float distance { FLT_MAX };
+};
+
+static RayHit pick(const EntityTreePointer& tree, const glm::vec3& origin, const glm::vec3& direction) {
+    RayHit hit;
+    OctreeElementPointer element;
+    BoxFace face;
+    glm::vec3 surfaceNormal;
+    QVariantMap extraInfo;
+    hit.entityID = tree->evalRayIntersection(origin, direction, QVector<EntityItemID>(), QVector<EntityItemID>(),
+        PickFilter(), element, hit.distance, face, surfaceNormal, extraInfo, Octree::Lock);
+    return hit;
+}
+
+// runs the same queries over the index and over the octree, which must find the same entities
+static void compareQueries(const EntityTreePointer& tree, int numQueries) {
+    std::uniform_real_distribution<float> radius(MIN_QUERY_RADIUS, MAX_QUERY_RADIUS);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (int i = 0; i < numQueries; i++) {
+        glm::vec3 center = randomPosition();
+        float queryRadius = radius(generator);
+        AABox box(center - glm::vec3(queryRadius), glm::vec3(2.0f * queryRadius));
+        glm::vec3 direction = glm::normalize(glm::vec3(unit(generator), unit(generator), unit(generator)) + glm::vec3(0.0f, 0.0f, 0.01f));
+
+        QVector<QUuid> indexedSphere, indexedBox, octreeSphere, octreeBox;
+        QUuid indexedClosest, octreeClosest;
+        tree->setSpatialIndexEnabled(true);
+        tree->withReadLock([&] {
+            tree->evalEntitiesInSphere(center, queryRadius, PickFilter(), indexedSphere);
+            tree->evalEntitiesInBox(box, PickFilter(), indexedBox);
+            indexedClosest = tree->evalClosestEntity(center, queryRadius, PickFilter());
+        });
+        RayHit indexedHit = pick(tree, center, direction);
+
+        tree->setSpatialIndexEnabled(false);
+        tree->withReadLock([&] {
+            tree->evalEntitiesInSphere(center, queryRadius, PickFilter(), octreeSphere);
+            tree->evalEntitiesInBox(box, PickFilter(), octreeBox);
+            octreeClosest = tree->evalClosestEntity(center, queryRadius, PickFilter());
+        });
+        RayHit octreeHit = pick(tree, center, direction);
+
+        QCOMPARE(sorted(indexedSphere), sorted(octreeSphere));
+        QCOMPARE(sorted(indexedBox), sorted(octreeBox));
+        QCOMPARE(indexedClosest.isNull(), octreeClosest.isNull());
+        // the octree stops at the first element with a hit, the index returns the closest hit of all
+        QCOMPARE(indexedHit.entityID.isNull(), octreeHit.entityID.isNull());
+        QVERIFY(indexedHit.distance <= octreeHit.distance + EPSILON);
+    }
+}
+
+// runs queries over the index only, which must find what testing every entity finds
+static void compareQueriesWithAllEntities(const EntityTreePointer& tree, const std::vector<EntityItemPointer>& entities,
+                                          int numQueries) {
+    std::uniform_real_distribution<float> radius(MIN_QUERY_RADIUS, MAX_QUERY_RADIUS);
+    for (int i = 0; i < numQueries; i++) {
+        glm::vec3 center = randomPosition();
+        float queryRadius = radius(generator);
+        AABox box(center - glm::vec3(queryRadius), glm::vec3(2.0f * queryRadius));
+
+        QVector<QUuid> indexedSphere, indexedBox, allSphere, allBox;
+        tree->withReadLock([&] {
+            tree->evalEntitiesInSphere(center, queryRadius, PickFilter(), indexedSphere);
+            tree->evalEntitiesInBox(box, PickFilter(), indexedBox);
+        });
+        for (auto& entity : entities) {
+            if (!entity->getElement()) {
+                continue;
+            }
+            if (EntityTreeElement::isEntityInSphere(entity, center, queryRadius)) {
+                allSphere.push_back(entity->getID());
+            }
+            bool success;
+            if (entity->getAABox(success).touches(box) && success) {
+                allBox.push_back(entity->getID());
+            }
+        }
+        QCOMPARE(sorted(indexedSphere), sorted(allSphere));
+        QCOMPARE(sorted(indexedBox), sorted(allBox));
+    }
+}
+
+void EntitySpatialIndexTests::testQueriesMatchOctree() {
+    const int NUM_ENTITIES = 5000;
+    const int NUM_QUERIES = 200;
+
+    auto tree = std::make_shared<EntityTree>();
+    addEntities(tree, NUM_ENTITIES);
+    QCOMPARE((int)tree->getSpatialIndex().getNumEntities(), NUM_ENTITIES);
+    compareQueries(tree, NUM_QUERIES);
+}
+
+void EntitySpatialIndexTests::testIndexFollowsTree() {
+    const int NUM_ENTITIES = 5000;
+    const int NUM_FRAMES = 10;
+    const int NUM_QUERIES = 50;
+    const float MAX_STEP = 16.0f;
+
+    auto tree = std::make_shared<EntityTree>();
+    auto entities = addEntities(tree, NUM_ENTITIES);
+    tree->update(false);
+    QVERIFY(!tree->getSpatialIndex().needsMaintenance());
+
+    // move and delete entities without letting the index re-sort, then once it has
+    std::uniform_real_distribution<float> step(-MAX_STEP, MAX_STEP);
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        MovingEntitiesOperator moveOperator;
+        for (size_t i = frame; i < entities.size(); i += 7) {
+            auto& entity = entities[i];
+            if (!entity->getElement()) {
+                continue;
+            }
+            placeEntity(entity, entity->getWorldPosition() + glm::vec3(step(generator), step(generator), step(generator)));
+            moveOperator.addEntityToMoveList(entity, entity->getQueryAACube());
+        }
+        tree->recurseTreeWithOperator(&moveOperator);
+
+        auto& deleted = entities[frame * 13];
+        if (deleted->getElement()) {
+            tree->clearEntityMapEntry(deleted->getEntityItemID());
+            deleted->getElement()->removeEntityItem(deleted);
+        }
+        compareQueriesWithAllEntities(tree, entities, NUM_QUERIES);
+    }
+    QVERIFY(tree->getSpatialIndex().needsMaintenance());
+    tree->update(false);
+    QVERIFY(!tree->getSpatialIndex().needsMaintenance());
+    compareQueriesWithAllEntities(tree, entities, NUM_QUERIES);
+    compareQueries(tree, NUM_QUERIES);
+    QCOMPARE((int)tree->getSpatialIndex().getNumEntities(), NUM_ENTITIES - NUM_FRAMES);
+}
+
+// Times random sphere, box and ray queries over about 100k entities, against the index and against the octree
+void EntitySpatialIndexTests::benchmarkQueries() {
+    const int NUM_ENTITIES = 100000;
+    const int NUM_QUERIES = 2000;
+
+    auto tree = std::make_shared<EntityTree>();
+    addEntities(tree, NUM_ENTITIES);
+    tree->update(false);
+
+    std::vector<glm::vec3> centers;
+    std::vector<float> radii;
+    std::vector<glm::vec3> directions;
+    std::uniform_real_distribution<float> radius(MIN_QUERY_RADIUS, MAX_QUERY_RADIUS);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        centers.push_back(randomPosition());
+        radii.push_back(radius(generator));
+        directions.push_back(glm::normalize(glm::vec3(unit(generator), unit(generator), unit(generator)) + glm::vec3(0.0f, 0.0f, 0.01f)));
+    }
+
+    auto timeQueries = [&](const char* name) {
+        uint64_t sphereTime = 0;
+        uint64_t boxTime = 0;
+        uint64_t rayTime = 0;
+        size_t numFound = 0;
+        for (int i = 0; i < NUM_QUERIES; i++) {
+            QVector<QUuid> found;
+            uint64_t start = usecTimestampNow();
+            tree->withReadLock([&] {
+                tree->evalEntitiesInSphere(centers[i], radii[i], PickFilter(), found);
+            });
+            uint64_t sphereEnd = usecTimestampNow();
+            numFound += found.size();
+            tree->withReadLock([&] {
+                tree->evalEntitiesInBox(AABox(centers[i] - glm::vec3(radii[i]), glm::vec3(2.0f * radii[i])), PickFilter(), found);
+            });
+            uint64_t boxEnd = usecTimestampNow();
+            numFound += found.size();
+            pick(tree, centers[i], directions[i]);
+            uint64_t rayEnd = usecTimestampNow();
+
+            sphereTime += sphereEnd - start;
+            boxTime += boxEnd - sphereEnd;
+            rayTime += rayEnd - boxEnd;
+        }
+        qDebug() << "  " << name << ": sphere" << (float)sphereTime / NUM_QUERIES << "usecs, box"
+            << (float)boxTime / NUM_QUERIES << "usecs, ray" << (float)rayTime / NUM_QUERIES << "usecs,"
+            << numFound / NUM_QUERIES << "found per query";
+    };
+
+    qDebug() << NUM_ENTITIES << "entities," << NUM_QUERIES << "queries of radius" << MIN_QUERY_RADIUS << "to" << MAX_QUERY_RADIUS;
+    tree->setSpatialIndexEnabled(true);
+    timeQueries("index");
+    size_t indexMemory = tree->getSpatialIndex().getMemoryUsage();
+    tree->setSpatialIndexEnabled(false);
+    timeQueries("octree");
+    uint64_t numElements = tree->getOctreeElementsCount();
+
+    qDebug() << "  index memory:" << indexMemory / BYTES_PER_KILOBYTE << "KB, octree:" << numElements << "elements of"
+        << sizeof(EntityTreeElement) << "bytes," << numElements * sizeof(EntityTreeElement) / BYTES_PER_KILOBYTE << "KB";
+}
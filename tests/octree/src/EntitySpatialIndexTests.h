@@ -0,0 +1,25 @@
+//
+//  EntitySpatialIndexTests.h
+//  tests/octree/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySpatialIndexTests_h
+#define hifi_EntitySpatialIndexTests_h
+
+#include <QtTest/QtTest>
+
+class EntitySpatialIndexTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testQueriesMatchOctree();
+    void testIndexFollowsTree();
+    void benchmarkQueries();
+};
+
+#endif // hifi_EntitySpatialIndexTests_h
@@ -0,0 +1,130 @@
+//
+//  MovingEntitiesOperatorTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MovingEntitiesOperatorTests.h"
+
+#include <algorithm>
+#include <random>
+
+#include <AddEntityOperator.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <EntityTypes.h>
+#include <MovingEntitiesOperator.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(MovingEntitiesOperatorTests)
+
+// entities are a few meters across and wander within a city-sized block in the middle of the domain
+const float WORLD_EXTENT = 512.0f;
+const float MIN_ENTITY_SCALE = 0.25f;
+const float MAX_ENTITY_SCALE = 4.0f;
+const float MAX_STEP = 8.0f;
+
+class SyntheticTree {
+public:
+    SyntheticTree(int numEntities) : _tree(std::make_shared<EntityTree>()) {
+        _tree->getRoot();
+        std::uniform_real_distribution<float> position(-WORLD_EXTENT, WORLD_EXTENT);
+        std::uniform_real_distribution<float> scale(MIN_ENTITY_SCALE, MAX_ENTITY_SCALE);
+        for (int i = 0; i < numEntities; i++) {
+            EntityItemProperties properties;
+            auto entity = EntityTypes::constructEntityItem(EntityTypes::Box, EntityItemID(QUuid::createUuid()), properties);
+            entity->setQueryAACube(AACube(glm::vec3(position(_generator), position(_generator), position(_generator)),
+                                          scale(_generator)));
+            AddEntityOperator addOperator(_tree, entity);
+            _tree->recurseTreeWithOperator(&addOperator);
+            _entities.push_back(entity);
+        }
+    }
+
+    // moves count entities by a random step, without re-sorting them yet
+    void moveEntities(int count) {
+        std::uniform_real_distribution<float> step(-MAX_STEP, MAX_STEP);
+        std::uniform_int_distribution<size_t> pick(0, _entities.size() - 1);
+        _moveOperator.reset();
+        for (int i = 0; i < count; i++) {
+            auto& entity = _entities[pick(_generator)];
+            AACube cube = entity->getQueryAACube();
+            glm::vec3 corner = glm::clamp(cube.getCorner() + glm::vec3(step(_generator), step(_generator), step(_generator)),
+                                          glm::vec3(-WORLD_EXTENT), glm::vec3(WORLD_EXTENT));
+            entity->setQueryAACube(AACube(corner, cube.getScale()));
+            _moveOperator.addEntityToMoveList(entity, entity->getQueryAACube());
+        }
+    }
+
+    // re-sorts all the entities moved since the last call in one batch
+    const MovingEntitiesOperator& resort() {
+        if (_moveOperator.hasMovingEntities()) {
+            _tree->recurseTreeWithOperator(&_moveOperator);
+        }
+        return _moveOperator;
+    }
+
+    const std::vector<EntityItemPointer>& getEntities() const { return _entities; }
+
+private:
+    EntityTreePointer _tree;
+    std::vector<EntityItemPointer> _entities;
+    MovingEntitiesOperator _moveOperator;
+    std::mt19937 _generator;
+};
+
+void MovingEntitiesOperatorTests::testBatchLandsInBestFit() {
+    const int NUM_ENTITIES = 2000;
+    const int NUM_FRAMES = 10;
+
+    SyntheticTree tree(NUM_ENTITIES);
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        tree.moveEntities(NUM_ENTITIES / 2);
+        tree.resort();
+    }
+
+    for (auto& entity : tree.getEntities()) {
+        EntityTreeElementPointer element = entity->getElement();
+        QVERIFY(element);
+        QVERIFY(element->getAACube().contains(entity->getQueryAACube()));
+        QVERIFY(element->bestFitBounds(entity->getQueryAACube()));
+    }
+}
+
+void MovingEntitiesOperatorTests::benchmarkMoveBatch() {
+    const int NUM_ENTITIES = 50000;
+    const int NUM_MOVED_PER_FRAME = 10000;
+    const int NUM_FRAMES = 60;
+
+    SyntheticTree tree(NUM_ENTITIES);
+    uint64_t totalTime = 0;
+    uint64_t maxTime = 0;
+    uint64_t elementsVisited = 0;
+    uint64_t elementsCreated = 0;
+    uint64_t elementsPruned = 0;
+    uint64_t entitiesMoved = 0;
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        tree.moveEntities(NUM_MOVED_PER_FRAME);
+        uint64_t start = usecTimestampNow();
+        const MovingEntitiesOperator& moveOperator = tree.resort();
+        uint64_t elapsed = usecTimestampNow() - start;
+        totalTime += elapsed;
+        maxTime = std::max(maxTime, elapsed);
+        entitiesMoved += moveOperator.getNumEntitiesMoved();
+        elementsVisited += moveOperator.getNumElementsVisited();
+        elementsCreated += moveOperator.getNumElementsCreated();
+        elementsPruned += moveOperator.getNumElementsPruned();
+    }
+
+    qDebug() << NUM_ENTITIES << "entities," << NUM_MOVED_PER_FRAME << "moved per frame," << NUM_FRAMES << "frames";
+    qDebug() << "  re-sort:" << (float)totalTime / NUM_FRAMES / USECS_PER_MSEC << "msecs per frame,"
+        << (float)maxTime / USECS_PER_MSEC << "msecs at most";
+    qDebug() << "  per frame:" << entitiesMoved / NUM_FRAMES << "entities changed element,"
+        << elementsVisited / NUM_FRAMES << "elements visited," << elementsCreated / NUM_FRAMES << "created,"
+        << elementsPruned / NUM_FRAMES << "pruned";
+}
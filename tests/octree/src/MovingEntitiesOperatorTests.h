@@ -0,0 +1,24 @@
+//
+//  MovingEntitiesOperatorTests.h
+//  tests/octree/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MovingEntitiesOperatorTests_h
+#define hifi_MovingEntitiesOperatorTests_h
+
+#include <QtTest/QtTest>
+
+class MovingEntitiesOperatorTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testBatchLandsInBestFit();
+    void benchmarkMoveBatch();
+};
+
+#endif // hifi_MovingEntitiesOperatorTests_h
@@ -0,0 +1,160 @@
+//
+//  PhysicsEngineTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PhysicsEngineTests.h"
+
+#include <BulletUtil.h>
+#include <NumericalConstants.h>
+#include <ObjectMotionState.h>
+#include <PhysicsCollisionGroups.h>
+#include <PhysicsEngine.h>
+#include <ShapeManager.h>
+#include <SharedUtil.h>
+#include <ThreadSafeDynamicsWorld.h>
+
+QTEST_GUILESS_MAIN(PhysicsEngineTests)
+
+// Minimal MotionState: a body with fixed material properties that just records where bullet put it
+class TestMotionState : public ObjectMotionState {
+public:
+    TestMotionState(const btCollisionShape* shape, PhysicsMotionType type, const glm::vec3& position) :
+        ObjectMotionState(shape), _type(type), _position(position) {
+        _uuid = QUuid::createUuid();
+        setMass(1.0f);
+    }
+
+    uint32_t getIncomingDirtyFlags() const override { return 0; }
+    void clearIncomingDirtyFlags(uint32_t mask) override { }
+
+    PhysicsMotionType computePhysicsMotionType() const override { return _type; }
+    bool isMoving() const override { return _type == MOTION_TYPE_DYNAMIC; }
+
+    float getObjectRestitution() const override { return 0.5f; }
+    float getObjectFriction() const override { return 0.5f; }
+    float getObjectLinearDamping() const override { return 0.0f; }
+    float getObjectAngularDamping() const override { return 0.0f; }
+
+    glm::vec3 getObjectPosition() const override { return _position; }
+    glm::quat getObjectRotation() const override { return glm::quat(); }
+    glm::vec3 getObjectLinearVelocity() const override { return glm::vec3(0.0f); }
+    glm::vec3 getObjectAngularVelocity() const override { return glm::vec3(0.0f); }
+    glm::vec3 getObjectGravity() const override { return glm::vec3(0.0f, -9.8f, 0.0f); }
+
+    const QUuid getObjectID() const override { return _uuid; }
+    QUuid getSimulatorID() const override { return QUuid(); }
+    ShapeType getShapeType() const override { return _type == MOTION_TYPE_STATIC ? SHAPE_TYPE_BOX : SHAPE_TYPE_SPHERE; }
+
+    void computeCollisionGroupAndMask(int32_t& group, int32_t& mask) const override {
+        group = _type == MOTION_TYPE_STATIC ? BULLET_COLLISION_GROUP_STATIC : BULLET_COLLISION_GROUP_DYNAMIC;
+        mask = BULLET_COLLISION_MASK_DYNAMIC;
+    }
+
+    void getWorldTransform(btTransform& worldTrans) const override {
+        worldTrans.setOrigin(glmToBullet(_position));
+        worldTrans.setRotation(btQuaternion::getIdentity());
+    }
+    void setWorldTransform(const btTransform& worldTrans) override {
+        _position = bulletToGLM(worldTrans.getOrigin());
+    }
+
+private:
+    QUuid _uuid;
+    PhysicsMotionType _type;
+    glm::vec3 _position;
+};
+
+// Drops a loose lattice of spheres onto a floor and returns the average usecs per fixed step
+static quint64 simulatePile(uint32_t numThreads, int numBodies, int numSteps) {
+    const float FIXED_SUBSTEP = 1.0f / 90.0f;
+    const float RADIUS = 0.5f;
+    const int SIDE = (int)ceilf(cbrtf((float)numBodies));
+
+    PhysicsEngine::setNumSimulationThreads(numThreads);
+
+    ShapeManager shapeManager;
+    ObjectMotionState::setShapeManager(&shapeManager);
+    PhysicsEngine engine(glm::vec3(0.0f));
+    engine.init();
+
+    ShapeInfo floorInfo;
+    floorInfo.setBox(glm::vec3(2.0f * SIDE, 1.0f, 2.0f * SIDE));
+    ShapeInfo sphereInfo;
+    sphereInfo.setSphere(RADIUS);
+
+    VectorOfMotionStates objects;
+    objects.push_back(new TestMotionState(shapeManager.getShape(floorInfo), MOTION_TYPE_STATIC, glm::vec3(0.0f, -1.0f, 0.0f)));
+    for (int i = 0; i < numBodies; ++i) {
+        // slightly less than a diameter apart so neighbours collide from the first step
+        glm::vec3 position(i % SIDE, (i / SIDE) % SIDE, i / (SIDE * SIDE));
+        position *= 1.9f * RADIUS;
+        position.y += RADIUS;
+        objects.push_back(new TestMotionState(shapeManager.getShape(sphereInfo), MOTION_TYPE_DYNAMIC, position));
+    }
+    engine.addObjects(objects);
+
+    auto world = static_cast<ThreadSafeDynamicsWorld*>(engine.getDynamicsWorld());
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < numSteps; ++i) {
+        world->stepSimulationWithSubstepCallback(FIXED_SUBSTEP, 1, FIXED_SUBSTEP);
+        engine.getChangedMotionStates();
+    }
+    quint64 elapsed = usecTimestampNow() - start;
+
+    SetOfMotionStates toRemove;
+    for (auto object : objects) {
+        toRemove.insert(object);
+    }
+    engine.removeSetOfObjects(toRemove);
+    for (auto object : objects) {
+        delete object;
+    }
+    ObjectMotionState::setShapeManager(nullptr);
+    return elapsed / numSteps;
+}
+
+void PhysicsEngineTests::testSimulationThreads() {
+    uint32_t maxThreads = PhysicsEngine::getMaxNumSimulationThreads();
+    QVERIFY(maxThreads >= 1);
+
+    // requests are clamped to what the scheduler can provide
+    QCOMPARE(PhysicsEngine::setNumSimulationThreads(0), (uint32_t)1);
+    QCOMPARE(PhysicsEngine::setNumSimulationThreads(maxThreads + 1), maxThreads);
+    QCOMPARE(PhysicsEngine::getNumSimulationThreads(), maxThreads);
+
+    // a multithreaded step must run cleanly on a small pile
+    simulatePile(maxThreads, 64, 10);
+    PhysicsEngine::setNumSimulationThreads(1);
+
+    // the default, which init() sets when nothing else did, can be overridden from the environment
+    uint32_t defaultThreads = PhysicsEngine::getDefaultNumSimulationThreads();
+    QVERIFY(defaultThreads >= 1 && defaultThreads <= maxThreads);
+    qputenv("HIFI_PHYSICS_THREADS", "1");
+    QCOMPARE(PhysicsEngine::getDefaultNumSimulationThreads(), (uint32_t)1);
+    qputenv("HIFI_PHYSICS_THREADS", QByteArray::number(maxThreads + 1));
+    QCOMPARE(PhysicsEngine::getDefaultNumSimulationThreads(), maxThreads);
+    qunsetenv("HIFI_PHYSICS_THREADS");
+}
+
+void PhysicsEngineTests::benchmarkSimulationThreads() {
+    const int NUM_BODIES = 4096;
+    const int NUM_STEPS = 90;
+
+    uint32_t maxThreads = PhysicsEngine::getMaxNumSimulationThreads();
+    quint64 singleThreaded = 0;
+    for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        quint64 usecsPerStep = simulatePile(numThreads, NUM_BODIES, NUM_STEPS);
+        if (numThreads == 1) {
+            singleThreaded = usecsPerStep;
+        }
+        qDebug() << numThreads << "threads:" << NUM_BODIES << "bodies" << usecsPerStep << "usecs per step,"
+                 << "speedup" << (float)singleThreaded / (float)std::max(usecsPerStep, (quint64)1);
+    }
+    PhysicsEngine::setNumSimulationThreads(1);
+}
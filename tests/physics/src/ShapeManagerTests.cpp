@@ -13,12 +13,60 @@
 
 #include <iostream>
 
+#include <QtCore/QTemporaryDir>
+
+#include <BulletUtil.h>
 #include <ShapeManager.h>
 #include <StreamUtils.h>
 #include <Extents.h>
 
 QTEST_MAIN(ShapeManagerTests)
 
+// a row of tetrahedral hulls of increasing size
+static ShapeInfo makeCompoundInfo(int numHulls) {
+    const glm::vec3 tetrahedron[] = {
+        glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(1.0f, -1.0f, -1.0f),
+        glm::vec3(-1.0f, 1.0f, -1.0f), glm::vec3(-1.0f, -1.0f, 1.0f)
+    };
+    ShapeInfo::PointCollection pointCollection;
+    Extents extents;
+    for (int i = 0; i < numHulls; ++i) {
+        glm::vec3 offset((float)(i - numHulls / 2), 0.0f, 0.0f);
+        ShapeInfo::PointList pointList;
+        for (const auto& corner : tetrahedron) {
+            glm::vec3 point = (float)(i + 1) * corner + offset;
+            pointList.push_back(point);
+            extents.addPoint(point);
+        }
+        pointCollection.push_back(pointList);
+    }
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_COMPOUND, 0.5f * (extents.maximum - extents.minimum));
+    info.setPointCollection(pointCollection);
+    return info;
+}
+
+// a flat grid of triangles
+static ShapeInfo makeStaticMeshInfo(int side) {
+    ShapeInfo::PointList points;
+    for (int z = 0; z <= side; ++z) {
+        for (int x = 0; x <= side; ++x) {
+            points.push_back(glm::vec3((float)x, 0.1f * (float)((x + z) % 3), (float)z));
+        }
+    }
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_STATIC_MESH, glm::vec3(0.5f * side, 0.1f, 0.5f * side));
+    info.setPointCollection(ShapeInfo::PointCollection({ points }));
+    auto& indices = info.getTriangleIndices();
+    for (int z = 0; z < side; ++z) {
+        for (int x = 0; x < side; ++x) {
+            int32_t i = z * (side + 1) + x;
+            indices.insert(indices.end(), { i, i + side + 1, i + 1, i + 1, i + side + 1, i + side + 2 });
+        }
+    }
+    return info;
+}
+
 void ShapeManagerTests::testShapeAccounting() {
     ShapeManager shapeManager;
     ShapeInfo info;
@@ -244,3 +292,113 @@ void ShapeManagerTests::addCompoundShape() {
     QCOMPARE(shapeManager.getNumShapes(), 0);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 }
+
+void ShapeManagerTests::serializeShapes() {
+    // compound of hulls
+    ShapeInfo compoundInfo = makeCompoundInfo(5);
+    const btCollisionShape* compound = ShapeFactory::createShapeFromInfo(compoundInfo);
+    QByteArray buffer;
+    QVERIFY(ShapeFactory::serializeShape(compound, buffer));
+    const btCollisionShape* restored = ShapeFactory::deserializeShape(buffer.constData(), buffer.size());
+    QVERIFY(restored != nullptr);
+    QCOMPARE(restored->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    const btCompoundShape* original = static_cast<const btCompoundShape*>(compound);
+    const btCompoundShape* copy = static_cast<const btCompoundShape*>(restored);
+    QCOMPARE(copy->getNumChildShapes(), original->getNumChildShapes());
+    for (int i = 0; i < original->getNumChildShapes(); ++i) {
+        auto originalHull = static_cast<const btConvexHullShape*>(original->getChildShape(i));
+        auto copyHull = static_cast<const btConvexHullShape*>(copy->getChildShape(i));
+        QCOMPARE(copyHull->getNumPoints(), originalHull->getNumPoints());
+        QCOMPARE(copyHull->getMargin(), originalHull->getMargin());
+    }
+
+    // truncated data must not produce a shape
+    QVERIFY(ShapeFactory::deserializeShape(buffer.constData(), buffer.size() - 1) == nullptr);
+    ShapeFactory::deleteShape(restored);
+    ShapeFactory::deleteShape(compound);
+
+    // static mesh, including its bvh
+    ShapeInfo meshInfo = makeStaticMeshInfo(16);
+    const btCollisionShape* mesh = ShapeFactory::createShapeFromInfo(meshInfo);
+    QVERIFY(mesh != nullptr);
+    QVERIFY(ShapeFactory::serializeShape(mesh, buffer));
+    restored = ShapeFactory::deserializeShape(buffer.constData(), buffer.size());
+    QVERIFY(restored != nullptr);
+    QCOMPARE(restored->getShapeType(), (int)TRIANGLE_MESH_SHAPE_PROXYTYPE);
+    btVector3 originalMin, originalMax, copyMin, copyMax;
+    btTransform identity;
+    identity.setIdentity();
+    mesh->getAabb(identity, originalMin, originalMax);
+    restored->getAabb(identity, copyMin, copyMax);
+    QCOMPARE(bulletToGLM(copyMin), bulletToGLM(originalMin));
+    QCOMPARE(bulletToGLM(copyMax), bulletToGLM(originalMax));
+    ShapeFactory::deleteShape(restored);
+    ShapeFactory::deleteShape(mesh);
+
+    // primitives are not serialized
+    ShapeInfo boxInfo;
+    boxInfo.setBox(glm::vec3(1.0f));
+    const btCollisionShape* box = ShapeFactory::createShapeFromInfo(boxInfo);
+    QVERIFY(!ShapeFactory::serializeShape(box, buffer));
+    ShapeFactory::deleteShape(box);
+}
+
+void ShapeManagerTests::loadShapeFromDiskCache() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ShapeInfo info = makeCompoundInfo(3);
+
+    {
+        // first visit: the shape is built on a worker and written to the cache
+        ShapeManager shapeManager;
+        shapeManager.enableDiskCache(dir.path().toStdString());
+        uint32_t requestCount = shapeManager.getWorkRequestCount();
+        QVERIFY(shapeManager.getShape(info, true) == nullptr);
+        QCOMPARE(shapeManager.getWorkRequestCount(), requestCount + 1);
+        QTRY_COMPARE(shapeManager.getWorkDeliveryCount(), (uint32_t)1);
+
+        const btCollisionShape* shape = shapeManager.getShapeByKey(info.getHash());
+        QVERIFY(shape != nullptr);
+        QCOMPARE(shapeManager.getStats().numCacheMisses, (uint32_t)1);
+        QCOMPARE(shapeManager.getStats().stallTime, (uint64_t)0);
+        shapeManager.releaseShape(shape);
+    }
+
+    {
+        // second visit: the shape is loaded rather than rebuilt
+        ShapeManager shapeManager;
+        shapeManager.enableDiskCache(dir.path().toStdString());
+        const btCollisionShape* shape = shapeManager.getShape(info);
+        QVERIFY(shape != nullptr);
+        QCOMPARE(shape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+        QCOMPARE(static_cast<const btCompoundShape*>(shape)->getNumChildShapes(), 3);
+        QCOMPARE(shapeManager.getStats().numCacheHits, (uint32_t)1);
+        shapeManager.releaseShape(shape);
+    }
+}
+
+void ShapeManagerTests::diskCacheKeyCoversMesh() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ShapeCache cache(dir.path().toStdString());
+    cache.initialize();
+
+    // the same model, edited between sessions: only a vertex moved, which ShapeInfo::getHash() doesn't see
+    const QString URL = "http://localhost/mesh.fbx";
+    ShapeInfo info = makeStaticMeshInfo(8);
+    ShapeInfo editedInfo = makeStaticMeshInfo(8);
+    info.setParams(SHAPE_TYPE_STATIC_MESH, info.getHalfExtents(), URL);
+    editedInfo.setParams(SHAPE_TYPE_STATIC_MESH, editedInfo.getHalfExtents(), URL);
+    editedInfo.getPointCollection()[0][4].y += 0.05f;
+    QCOMPARE(editedInfo.getHash(), info.getHash());
+    QVERIFY(ShapeCache::computeKey(editedInfo) != ShapeCache::computeKey(info));
+
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(cache.saveShape(ShapeCache::computeKey(info), shape));
+    ShapeFactory::deleteShape(shape);
+
+    QVERIFY(cache.loadShape(ShapeCache::computeKey(editedInfo)) == nullptr);
+    const btCollisionShape* loaded = cache.loadShape(ShapeCache::computeKey(info));
+    QVERIFY(loaded != nullptr);
+    ShapeFactory::deleteShape(loaded);
+}
@@ -25,6 +25,9 @@ private slots:
     void addCylinderShape();
     void addCapsuleShape();
     void addCompoundShape();
+    void serializeShapes();
+    void loadShapeFromDiskCache();
+    void diskCacheKeyCoversMesh();
 };
 
 #endif // hifi_ShapeManagerTests_h
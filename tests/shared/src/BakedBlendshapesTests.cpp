@@ -0,0 +1,284 @@
+//
+//  BakedBlendshapesTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BakedBlendshapesTests.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <test-utils/QTestExtensions.h>
+
+#include <BakedBlendshapes.h>
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(BakedBlendshapesTests)
+
+const float TEST_EPSILON = 0.0001f;
+const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+
+static std::mt19937 randomEngine(2468);
+
+static float randomFloat(float min, float max) {
+    return std::uniform_real_distribution<float>(min, max)(randomEngine);
+}
+
+static int randomInt(int min, int max) {
+    return std::uniform_int_distribution<int>(min, max)(randomEngine);
+}
+
+static glm::vec3 randomVec3(float range) {
+    return glm::vec3(randomFloat(-range, range), randomFloat(-range, range), randomFloat(-range, range));
+}
+
+struct Blendshape {
+    std::vector<int> indices;
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec3> tangents;
+};
+
+struct UnpackedOffset {
+    glm::vec3 positionOffset;
+    glm::vec3 normalOffset;
+    glm::vec3 tangentOffset;
+};
+
+// Facial blendshapes each move a region of the face, mostly every vertex of it, plus a few stray vertices.
+static std::vector<Blendshape> makeHeadBlendshapes(int numVertices, int numBlendshapes) {
+    std::vector<Blendshape> blendshapes;
+    for (int i = 0; i < numBlendshapes; i++) {
+        Blendshape blendshape;
+        int regionSize = randomInt(numVertices / 50, numVertices / 8);
+        int regionStart = randomInt(0, numVertices - regionSize);
+        for (int index = regionStart; index < regionStart + regionSize; index++) {
+            if (randomFloat(0.0f, 1.0f) < 0.8f) {
+                blendshape.indices.push_back(index);
+            }
+        }
+        int numStrays = randomInt(0, 40);
+        for (int j = 0; j < numStrays; j++) {
+            blendshape.indices.push_back(randomInt(0, numVertices - 1));
+        }
+        bool hasTangents = (i % 5 != 0);
+        for (size_t j = 0; j < blendshape.indices.size(); j++) {
+            blendshape.vertices.push_back(randomVec3(0.02f));
+            blendshape.normals.push_back(randomVec3(1.0f));
+            if (hasTangents) {
+                blendshape.tangents.push_back(randomVec3(1.0f));
+            }
+        }
+        blendshapes.push_back(blendshape);
+    }
+    return blendshapes;
+}
+
+static BakedBlendshapes bake(int numVertices, const std::vector<Blendshape>& blendshapes) {
+    BakedBlendshapes baked(numVertices);
+    for (const auto& blendshape : blendshapes) {
+        baked.addBlendshape((int)blendshape.indices.size(), blendshape.indices.data(), blendshape.vertices.data(),
+                            blendshape.normals.data(), (int)blendshape.tangents.size(), blendshape.tangents.data());
+    }
+    return baked;
+}
+
+static std::vector<float> makeCoefficients(int numBlendshapes) {
+    std::vector<float> coefficients;
+    for (int i = 0; i < numBlendshapes; i++) {
+        // most of a face is at rest most of the time
+        coefficients.push_back(randomFloat(0.0f, 1.0f) < 0.6f ? 0.0f : randomFloat(0.0f, 1.0f));
+    }
+    return coefficients;
+}
+
+// The accumulation as Model's Blender did it before the blendshapes were baked
+static void accumulate_ref(const std::vector<Blendshape>& blendshapes, const std::vector<float>& coefficients,
+                           std::vector<UnpackedOffset>& offsets) {
+    memset(offsets.data(), 0, offsets.size() * sizeof(UnpackedOffset));
+    for (size_t i = 0, n = std::min(coefficients.size(), blendshapes.size()); i < n; i++) {
+        float vertexCoefficient = coefficients[i];
+        if (vertexCoefficient < BakedBlendshapes::MIN_COEFFICIENT) {
+            continue;
+        }
+        float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+        const Blendshape& blendshape = blendshapes[i];
+        for (size_t j = 0; j < blendshape.indices.size(); ++j) {
+            auto& offset = offsets[blendshape.indices[j]];
+            offset.positionOffset += blendshape.vertices[j] * vertexCoefficient;
+            offset.normalOffset += blendshape.normals[j] * normalCoefficient;
+            if (j < blendshape.tangents.size()) {
+                offset.tangentOffset += blendshape.tangents[j] * normalCoefficient;
+            }
+        }
+    }
+}
+
+static void pack_ref(const std::vector<UnpackedOffset>& offsets, std::vector<glm::uvec4>& packed) {
+    for (size_t i = 0; i < offsets.size(); i++) {
+        float len = glm::compMax(glm::abs(offsets[i].positionOffset));
+        glm::vec3 normalizedPos(offsets[i].positionOffset);
+        if (len > 0.0f) {
+            normalizedPos /= len;
+        } else {
+            len = 1.0f;
+        }
+        packed[i] = glm::uvec4(glm::floatBitsToUint(len),
+                               glm_packSnorm3x10_1x2(glm::vec4(normalizedPos, 0.0f)),
+                               glm_packSnorm3x10_1x2(glm::vec4(offsets[i].normalOffset, 0.0f)),
+                               glm_packSnorm3x10_1x2(glm::vec4(offsets[i].tangentOffset, 0.0f)));
+    }
+}
+
+static void comparePacked(const glm::uvec4& ref, const glm::uvec4& tst) {
+    // the length may be off by an ULP or so, due to rounding differences
+    QCOMPARE_WITH_ABS_ERROR(glm::uintBitsToFloat(tst[0]), glm::uintBitsToFloat(ref[0]), TEST_EPSILON);
+    for (int i = 1; i < 4; i++) {
+        for (int shift = 0; shift < 30; shift += 10) {
+            int refComponent = (int)((ref[i] >> shift) & 0x3ff);
+            int tstComponent = (int)((tst[i] >> shift) & 0x3ff);
+            // allow 1 ULP, which wraps around zero
+            int difference = abs(refComponent - tstComponent);
+            QVERIFY(difference <= 1 || difference == 0x3ff);
+        }
+    }
+}
+
+void BakedBlendshapesTests::testBake() {
+    const int NUM_VERTICES = 100;
+    std::vector<Blendshape> blendshapes(3);
+
+    // a full run of consecutive vertices is dense
+    for (int index = 10; index < 26; index++) {
+        blendshapes[0].indices.push_back(index);
+    }
+    // scattered vertices are sparse, padded up to a full block
+    blendshapes[1].indices = { 3, 40, 77, 99, 12, 58 };
+    // out of range indices are dropped, and repeats are merged
+    blendshapes[2].indices = { -1, 100, 5, 5, 5, 5, 5 };
+    for (auto& blendshape : blendshapes) {
+        blendshape.vertices.assign(blendshape.indices.size(), glm::vec3(1.0f));
+        blendshape.normals.assign(blendshape.indices.size(), glm::vec3(1.0f));
+    }
+
+    BakedBlendshapes baked = bake(NUM_VERTICES, blendshapes);
+    QCOMPARE(baked.getNumBlendshapes(), 3);
+    QCOMPARE(baked.getNumDenseBlocks(), 2);
+    QCOMPARE(baked.getNumSparseBlocks(), 2);
+    QVERIFY(baked.getStride() >= NUM_VERTICES + BakedBlendshapes::BLOCK_SIZE);
+
+    std::vector<float> offsets(BakedBlendshapes::NUM_COMPONENTS * baked.getStride());
+    std::vector<float> coefficients = { 0.0f, 0.0f, 0.5f };
+    QCOMPARE(baked.accumulate(coefficients.data(), (int)coefficients.size(), NORMAL_COEFFICIENT_SCALE, offsets.data()), 1);
+    QCOMPARE_WITH_ABS_ERROR(offsets[5], 2.5f, TEST_EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(offsets[3 * baked.getStride() + 5], 0.025f, TEST_EPSILON);
+    for (int i = 0; i < NUM_VERTICES; i++) {
+        if (i != 5) {
+            QCOMPARE(offsets[i], 0.0f);
+        }
+    }
+}
+
+void BakedBlendshapesTests::testAccumulate() {
+    const int NUM_BLENDSHAPES = 50;
+    for (int numVertices : { 1, 7, 8, 9, 100, 1237 }) {
+        auto blendshapes = makeHeadBlendshapes(numVertices, NUM_BLENDSHAPES);
+        BakedBlendshapes baked = bake(numVertices, blendshapes);
+        int stride = baked.getStride();
+
+        for (int trial = 0; trial < 4; trial++) {
+            auto coefficients = makeCoefficients(NUM_BLENDSHAPES);
+
+            std::vector<UnpackedOffset> expected(numVertices);
+            accumulate_ref(blendshapes, coefficients, expected);
+
+            std::vector<float> offsets(BakedBlendshapes::NUM_COMPONENTS * stride, 1.0f);
+            baked.accumulate(coefficients.data(), (int)coefficients.size(), NORMAL_COEFFICIENT_SCALE, offsets.data());
+            for (int i = 0; i < numVertices; i++) {
+                glm::vec3 position(offsets[i], offsets[stride + i], offsets[2 * stride + i]);
+                glm::vec3 normal(offsets[3 * stride + i], offsets[4 * stride + i], offsets[5 * stride + i]);
+                glm::vec3 tangent(offsets[6 * stride + i], offsets[7 * stride + i], offsets[8 * stride + i]);
+                QCOMPARE_WITH_ABS_ERROR(position, expected[i].positionOffset, TEST_EPSILON);
+                QCOMPARE_WITH_ABS_ERROR(normal, expected[i].normalOffset, TEST_EPSILON);
+                QCOMPARE_WITH_ABS_ERROR(tangent, expected[i].tangentOffset, TEST_EPSILON);
+            }
+        }
+    }
+}
+
+void BakedBlendshapesTests::testPack() {
+    for (int numVertices = 0; numVertices < 100; numVertices++) {
+        BakedBlendshapes baked(numVertices);
+        int stride = baked.getStride();
+
+        std::vector<UnpackedOffset> unpacked(numVertices);
+        std::vector<float> planes(BakedBlendshapes::NUM_COMPONENTS * stride, 0.0f);
+        for (int i = 0; i < numVertices; i++) {
+            // leave the first one at zero
+            unpacked[i] = { randomVec3(i > 0 ? 2.0f : 0.0f), randomVec3(i > 0 ? 2.0f : 0.0f), randomVec3(i > 0 ? 2.0f : 0.0f) };
+            for (int k = 0; k < 3; k++) {
+                planes[k * stride + i] = unpacked[i].positionOffset[k];
+                planes[(3 + k) * stride + i] = unpacked[i].normalOffset[k];
+                planes[(6 + k) * stride + i] = unpacked[i].tangentOffset[k];
+            }
+        }
+
+        std::vector<glm::uvec4> expected(numVertices);
+        pack_ref(unpacked, expected);
+
+        // one more than needed, to catch writes past the end
+        const glm::uvec4 CANARY(0xdeadbeef);
+        std::vector<glm::uvec4> packed(numVertices + 1, CANARY);
+        packBlendshapeOffsets(planes.data(), stride, (uint32_t(*)[4])packed.data(), numVertices);
+        for (int i = 0; i < numVertices; i++) {
+            comparePacked(expected[i], packed[i]);
+        }
+        QVERIFY(packed[numVertices] == CANARY);
+    }
+}
+
+// A head with 50 facial blendshapes, blended for a crowd
+void BakedBlendshapesTests::benchmarkHeadMesh() {
+    const int NUM_VERTICES = 12000;
+    const int NUM_BLENDSHAPES = 50;
+    const int NUM_BLENDS = 200;
+
+    auto blendshapes = makeHeadBlendshapes(NUM_VERTICES, NUM_BLENDSHAPES);
+    std::vector<std::vector<float>> coefficients;
+    for (int i = 0; i < NUM_BLENDS; i++) {
+        coefficients.push_back(makeCoefficients(NUM_BLENDSHAPES));
+    }
+
+    std::vector<UnpackedOffset> unpacked(NUM_VERTICES);
+    std::vector<glm::uvec4> packed(NUM_VERTICES);
+    quint64 start = usecTimestampNow();
+    for (int i = 0; i < NUM_BLENDS; i++) {
+        accumulate_ref(blendshapes, coefficients[i], unpacked);
+        pack_ref(unpacked, packed);
+    }
+    quint64 scalarTime = usecTimestampNow() - start;
+
+    start = usecTimestampNow();
+    BakedBlendshapes baked = bake(NUM_VERTICES, blendshapes);
+    quint64 bakeTime = usecTimestampNow() - start;
+
+    std::vector<float> planes(BakedBlendshapes::NUM_COMPONENTS * baked.getStride());
+    start = usecTimestampNow();
+    for (int i = 0; i < NUM_BLENDS; i++) {
+        baked.accumulate(coefficients[i].data(), NUM_BLENDSHAPES, NORMAL_COEFFICIENT_SCALE, planes.data());
+        packBlendshapeOffsets(planes.data(), baked.getStride(), (uint32_t(*)[4])packed.data(), NUM_VERTICES);
+    }
+    quint64 bakedTime = usecTimestampNow() - start;
+
+    qDebug() << NUM_BLENDSHAPES << "blendshapes over" << NUM_VERTICES << "vertices:"
+             << baked.getNumDenseBlocks() << "dense and" << baked.getNumSparseBlocks() << "sparse blocks, baked in" << bakeTime << "usecs";
+    qDebug() << "scalar:" << (float)scalarTime / (float)NUM_BLENDS << "usecs per blend, baked:"
+             << (float)bakedTime / (float)NUM_BLENDS << "usecs per blend";
+}
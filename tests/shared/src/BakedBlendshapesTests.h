@@ -0,0 +1,25 @@
+//
+//  BakedBlendshapesTests.h
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BakedBlendshapesTests_h
+#define hifi_BakedBlendshapesTests_h
+
+#include <QtTest/QtTest>
+
+class BakedBlendshapesTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testBake();
+    void testAccumulate();
+    void testPack();
+    void benchmarkHeadMesh();
+};
+
+#endif // hifi_BakedBlendshapesTests_h
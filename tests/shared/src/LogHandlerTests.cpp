@@ -0,0 +1,276 @@
+//
+//  LogHandlerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LogHandlerTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMutex>
+
+#include <LogHandler.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(LogHandlerTests)
+
+static FILE* outputFile = nullptr;
+static long outputOffset = 0;
+
+// the lines written since the last call
+static QStringList takeOutput() {
+    LogHandler::getInstance().flush();
+    QByteArray output;
+    char buffer[4096];
+    size_t numRead;
+    fseek(outputFile, outputOffset, SEEK_SET);
+    while ((numRead = fread(buffer, 1, sizeof(buffer), outputFile)) > 0) {
+        output.append(buffer, (int)numRead);
+    }
+    outputOffset = ftell(outputFile);
+    // the writer writes after what was read
+    fseek(outputFile, 0, SEEK_END);
+    return QString::fromLocal8Bit(output).split('\n', QString::SkipEmptyParts);
+}
+
+void LogHandlerTests::initTestCase() {
+    outputFile = std::tmpfile();
+    QVERIFY(outputFile);
+    LogHandler::getInstance().setOutputFile(outputFile);
+}
+
+void LogHandlerTests::cleanupTestCase() {
+    LogHandler::getInstance().setOutputFile(stdout);
+    fclose(outputFile);
+}
+
+void LogHandlerTests::testOrder() {
+    const int NUM_THREADS = 4;
+    const int NUM_MESSAGES = 50;
+
+    LogHandler::getInstance().setTargetName("test");
+    QString logMessage = LogHandler::getInstance().printMessage(LogWarning,
+        QMessageLogContext(__FILE__, __LINE__, __func__, "hifi.test"), "first\nsecond");
+    QVERIFY(logMessage.contains("[WARNING] [hifi.test] [test] first\n"));
+    QVERIFY(logMessage.endsWith(" [test] second\n"));
+    QCOMPARE(takeOutput().size(), 2);
+
+    // the messages of each thread are written in the order they were logged, each from a site of its own
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([i] {
+            for (int message = 0; message < NUM_MESSAGES; ++message) {
+                LogHandler::getInstance().printMessage(LogDebug, QMessageLogContext(__FILE__, message, __func__, "hifi.test"),
+                    QString("thread %1 message %2").arg(i).arg(message));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QStringList lines = takeOutput();
+    QCOMPARE(lines.size(), NUM_THREADS * NUM_MESSAGES);
+    std::vector<int> nextMessages(NUM_THREADS, 0);
+    QRegExp messageRegExp("thread (\\d+) message (\\d+)$");
+    for (auto& line : lines) {
+        QVERIFY(messageRegExp.indexIn(line) >= 0);
+        int& nextMessage = nextMessages[messageRegExp.cap(1).toInt()];
+        QCOMPARE(messageRegExp.cap(2).toInt(), nextMessage);
+        ++nextMessage;
+    }
+    LogHandler::getInstance().setTargetName(QString());
+}
+
+void LogHandlerTests::testRateLimiting() {
+    const int NUM_MESSAGES = 10 * LogHandler::MAX_MESSAGES_PER_SECOND_PER_SITE;
+
+    // a storm from one site, within a second
+    uint64_t numDroppedMessages = LogHandler::getInstance().getNumDroppedMessages();
+    quint64 start = usecTimestampNow();
+    int numPrinted = 0;
+    for (int i = 0; i < NUM_MESSAGES; ++i) {
+        if (!LogHandler::getInstance().printMessage(LogWarning, QMessageLogContext(__FILE__, __LINE__, __func__, "hifi.test"),
+                "storm").isEmpty()) {
+            ++numPrinted;
+        }
+    }
+    if (usecTimestampNow() - start > USECS_PER_SECOND / 2) {
+        QSKIP("Too slow to log within a second");
+    }
+    QVERIFY(numPrinted <= 2 * (int)LogHandler::MAX_MESSAGES_PER_SECOND_PER_SITE);
+    QCOMPARE(LogHandler::getInstance().getNumDroppedMessages() - numDroppedMessages, (uint64_t)(NUM_MESSAGES - numPrinted));
+
+    // the drops are reported after what was written
+    int numWritten = 0;
+    int numReportedDrops = 0;
+    QRegExp dropsRegExp("(\\d+) log entries were dropped");
+    for (auto& line : takeOutput()) {
+        if (line.contains("[SUPPRESS]")) {
+            QVERIFY(dropsRegExp.indexIn(line) >= 0);
+            numReportedDrops += dropsRegExp.cap(1).toInt();
+        } else {
+            ++numWritten;
+        }
+    }
+    QCOMPARE(numWritten, numPrinted);
+    QCOMPARE(numReportedDrops, NUM_MESSAGES - numPrinted);
+
+    // fatal messages are never dropped, and are written before they return
+    QVERIFY(!LogHandler::getInstance().printMessage(LogFatal, QMessageLogContext(__FILE__, __LINE__, __func__, "hifi.test"),
+        "fatal").isEmpty());
+    QStringList lines = takeOutput();
+    QCOMPARE(lines.size(), 1);
+    QVERIFY(lines[0].contains("[FATAL]"));
+}
+
+void LogHandlerTests::testRateLimitingWithoutContext() {
+    const int NUM_MESSAGES = 10 * LogHandler::MAX_MESSAGES_PER_SECOND_PER_SITE;
+
+    // as qDebug and qCWarning log built without QT_MESSAGELOGCONTEXT: the category, but neither file nor line
+    QMessageLogContext context(nullptr, 0, nullptr, "hifi.test");
+
+    // two sites of the same category storm within a second, the second once the first is limited
+    quint64 start = usecTimestampNow();
+    int numPrinted[2] = { 0, 0 };
+    for (int site = 0; site < 2; ++site) {
+        for (int i = 0; i < NUM_MESSAGES; ++i) {
+            QString message = site == 0 ? QString("storm %1 from the first site").arg(i)
+                : QString("storm from the second site, %1 of %2").arg(i).arg(NUM_MESSAGES);
+            if (!LogHandler::getInstance().printMessage(LogWarning, context, message).isEmpty()) {
+                ++numPrinted[site];
+            }
+        }
+    }
+    if (usecTimestampNow() - start > USECS_PER_SECOND / 2) {
+        QSKIP("Too slow to log within a second");
+    }
+    takeOutput();
+
+    // each is limited on its own, and the first does not silence the second
+    for (int site = 0; site < 2; ++site) {
+        QVERIFY(numPrinted[site] >= (int)LogHandler::MAX_MESSAGES_PER_SECOND_PER_SITE);
+        QVERIFY(numPrinted[site] <= 2 * (int)LogHandler::MAX_MESSAGES_PER_SECOND_PER_SITE);
+    }
+}
+
+void LogHandlerTests::testRateLimitingScripts() {
+    const int NUM_MESSAGES = 10 * LogHandler::MAX_MESSAGES_PER_SECOND_PER_SITE;
+
+    // as the print() of every script logs, from the one line of the script engine with the script name first
+    QMessageLogContext context(__FILE__, __LINE__, __func__, "hifi.scriptengine.script");
+
+    // two scripts storm within a second, the second once the first is limited
+    quint64 start = usecTimestampNow();
+    int numPrinted[2] = { 0, 0 };
+    for (int script = 0; script < 2; ++script) {
+        for (int i = 0; i < NUM_MESSAGES; ++i) {
+            QString message = QString("[script%1.js] storm %2").arg(script == 0 ? "A" : "B").arg(i);
+            if (!LogHandler::getInstance().printMessage(LogDebug, context, message).isEmpty()) {
+                ++numPrinted[script];
+            }
+        }
+    }
+    if (usecTimestampNow() - start > USECS_PER_SECOND / 2) {
+        QSKIP("Too slow to log within a second");
+    }
+    takeOutput();
+
+    // each script is limited on its own, and the first does not silence the second
+    for (int script = 0; script < 2; ++script) {
+        QVERIFY(numPrinted[script] >= (int)LogHandler::MAX_MESSAGES_PER_SECOND_PER_SITE);
+        QVERIFY(numPrinted[script] <= 2 * (int)LogHandler::MAX_MESSAGES_PER_SECOND_PER_SITE);
+    }
+}
+
+void LogHandlerTests::testRepeatedMessages() {
+    int messageID = LogHandler::getInstance().newRepeatedMessageID();
+    for (int i = 0; i < 5; ++i) {
+        LogHandler::getInstance().printRepeatedMessage(messageID, LogDebug,
+            QMessageLogContext(__FILE__, __LINE__, __func__, "hifi.test"), QString("repeated %1").arg(i));
+    }
+    QStringList lines = takeOutput();
+    QCOMPARE(lines.size(), 1);
+    QVERIFY(lines[0].endsWith("repeated 0"));
+
+    LogHandler::getInstance().flushRepeatedMessages();
+    lines = takeOutput();
+    QCOMPARE(lines.size(), 1);
+    QVERIFY(lines[0].endsWith("5 repeated log entries - Last entry: \"repeated 4\""));
+}
+
+// The log handler as it was, writing each message under a lock.
+static QMutex lockedMutex(QMutex::Recursive);
+
+static void printLockedMessage(const QMessageLogContext& context, const QString& message) {
+    QMutexLocker lock(&lockedMutex);
+    QString prefixString = QString("[%1] [%2] [%3]").arg(QDateTime::currentDateTime().toString("MM/dd hh:mm:ss"),
+        "DEBUG", context.category);
+    QString logMessage = QString("%1 %2\n").arg(prefixString, message.split('\n').join('\n' + prefixString + " "));
+    fprintf(outputFile, "%s", qPrintable(logMessage));
+    fflush(outputFile);
+}
+
+// Times logging from 1 and 8 threads at once, with the locked handler and with the queues of each thread, as the
+// average and the slowest call.  The messages come from enough sites that none of them are rate limited.
+void LogHandlerTests::benchmarkContention() {
+    const int NUM_MESSAGES = 2000;
+
+    auto timeMessages = [&](int numThreads, bool locked, quint64& slowestUsecs) {
+        std::atomic<uint64_t> usecs { 0 };
+        std::atomic<uint64_t> slowest { 0 };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i) {
+            threads.emplace_back([&, i] {
+                uint64_t threadSlowest = 0;
+                for (int message = 0; message < NUM_MESSAGES; ++message) {
+                    QMessageLogContext context(__FILE__, i * NUM_MESSAGES + message, __func__, "hifi.test");
+                    QString logString = QString("thread %1 message %2").arg(i).arg(message);
+                    auto start = usecTimestampNow();
+                    if (locked) {
+                        printLockedMessage(context, logString);
+                    } else {
+                        LogHandler::getInstance().printMessage(LogDebug, context, logString);
+                    }
+                    uint64_t elapsed = usecTimestampNow() - start;
+                    usecs += elapsed;
+                    threadSlowest = std::max(threadSlowest, elapsed);
+                }
+                uint64_t previous = slowest.load();
+                while (threadSlowest > previous && !slowest.compare_exchange_weak(previous, threadSlowest)) {
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        LogHandler::getInstance().flush();
+        slowestUsecs = slowest;
+        // nanoseconds per message
+        return (float)usecs * NSECS_PER_USEC / (numThreads * NUM_MESSAGES);
+    };
+
+    for (int numThreads : { 1, 8 }) {
+        quint64 lockedSlowest;
+        float locked = timeMessages(numThreads, true, lockedSlowest);
+        takeOutput();
+        quint64 queuedSlowest;
+        float queued = timeMessages(numThreads, false, queuedSlowest);
+        QStringList lines = takeOutput();
+
+        qDebug() << numThreads << "threads:" << locked << "nsecs per message locked, slowest" << lockedSlowest << "usecs,"
+            << queued << "nsecs queued, slowest" << queuedSlowest << "usecs";
+        QVERIFY(lines.size() >= numThreads * NUM_MESSAGES - (int)LogHandler::getInstance().getNumDroppedMessages());
+    }
+}
@@ -0,0 +1,30 @@
+//
+//  LogHandlerTests.h
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LogHandlerTests_h
+#define hifi_LogHandlerTests_h
+
+#include <QtTest/QtTest>
+
+class LogHandlerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void testOrder();
+    void testRateLimiting();
+    void testRateLimitingWithoutContext();
+    void testRateLimitingScripts();
+    void testRepeatedMessages();
+    void benchmarkContention();
+};
+
+#endif // hifi_LogHandlerTests_h
@@ -0,0 +1,294 @@
+//
+//  MetricsTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MetricsTests.h"
+
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QUuid>
+
+#include <Metrics.h>
+#include <NumericalConstants.h>
+#include <PortableHighResolutionClock.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(MetricsTests)
+
+using namespace metrics;
+
+void MetricsTests::testHistogramBuckets() {
+    // the buckets cover every value once, without gaps
+    QCOMPARE(Histogram::bucketLowerBound(0), (uint64_t)0);
+    for (int index = 0; index < Histogram::NUM_BUCKETS - 1; ++index) {
+        QCOMPARE(Histogram::bucketUpperBound(index) + 1, Histogram::bucketLowerBound(index + 1));
+        QCOMPARE(Histogram::bucketIndex(Histogram::bucketLowerBound(index)), index);
+        QCOMPARE(Histogram::bucketIndex(Histogram::bucketUpperBound(index)), index);
+    }
+    QCOMPARE(Histogram::bucketUpperBound(Histogram::NUM_BUCKETS - 1), std::numeric_limits<uint64_t>::max());
+    QCOMPARE(Histogram::bucketIndex(std::numeric_limits<uint64_t>::max()), Histogram::NUM_BUCKETS - 1);
+
+    // small values are exact, and large ones within the width of a sub bucket
+    for (uint64_t value = 0; value < 2 * Histogram::SUB_BUCKETS; ++value) {
+        QCOMPARE(Histogram::bucketLowerBound(Histogram::bucketIndex(value)), value);
+    }
+    for (uint64_t value : { (uint64_t)100, (uint64_t)12345, (uint64_t)1 << 40, ((uint64_t)1 << 50) + 7 }) {
+        int index = Histogram::bucketIndex(value);
+        uint64_t width = Histogram::bucketUpperBound(index) - Histogram::bucketLowerBound(index) + 1;
+        QVERIFY(Histogram::bucketLowerBound(index) <= value && value <= Histogram::bucketUpperBound(index));
+        QVERIFY(width <= value / Histogram::SUB_BUCKETS);
+    }
+}
+
+void MetricsTests::testQuantiles() {
+    MetricsRegistry registry;
+    Histogram& histogram = registry.histogram("test_usecs", "Test durations");
+    const uint64_t NUM_VALUES = 10000;
+    for (uint64_t value = 1; value <= NUM_VALUES; ++value) {
+        histogram.record(value);
+    }
+    QCOMPARE(histogram.getSum(), NUM_VALUES * (NUM_VALUES + 1) / 2);
+
+    Snapshot snapshot = registry.snapshot();
+    const Snapshot::Metric* metric = snapshot.find("test_usecs");
+    QVERIFY(metric);
+    QCOMPARE(metric->getHistogramCount(), NUM_VALUES);
+
+    const double MAX_ERROR = 1.0 / Histogram::SUB_BUCKETS;
+    for (double quantile : { 0.5, 0.9, 0.99, 0.999 }) {
+        double expected = quantile * NUM_VALUES;
+        double error = std::abs((double)metric->getQuantile(quantile) - expected) / expected;
+        QVERIFY(error <= MAX_ERROR);
+    }
+    QCOMPARE(metric->getQuantile(0.0), (uint64_t)1);
+}
+
+void MetricsTests::testSnapshots() {
+    MetricsRegistry registry;
+    Counter& counter = registry.counter("test_total", "Test counter");
+    QCOMPARE(&registry.counter("test_total", "Test counter"), &counter);
+    Gauge& gauge = registry.gauge("test_gauge", "Test gauge");
+    Histogram& histogram = registry.histogram("test_usecs", "Test durations");
+
+    // a metric asked for with another type still works, but is not reported
+    registry.gauge("test_total", "Mismatched").set(1.0);
+    QCOMPARE(registry.getNumMetrics(), 3);
+
+    counter.increment();
+    counter.increment(41);
+    gauge.set(2.5);
+    gauge.add(-1.0);
+    histogram.record(3);
+    histogram.record(1000);
+
+    Snapshot snapshot;
+    QVERIFY(snapshot.fromByteArray(registry.snapshot().toByteArray()));
+    QCOMPARE((int)snapshot.metrics.size(), 3);
+    QCOMPARE(snapshot.find("test_total")->count, (uint64_t)42);
+    QCOMPARE(snapshot.find("test_total")->type, Type::Counter);
+    QCOMPARE(snapshot.find("test_gauge")->value, 1.5);
+    QCOMPARE(snapshot.find("test_usecs")->sum, (uint64_t)1003);
+    QCOMPARE((int)snapshot.find("test_usecs")->buckets.size(), 2);
+    QCOMPARE(snapshot.find("test_usecs")->help, QString("Test durations"));
+
+    // a truncated snapshot is rejected
+    QByteArray data = registry.snapshot().toByteArray();
+    QVERIFY(!snapshot.fromByteArray(data.left(data.size() - 1)));
+    QVERIFY(!snapshot.fromByteArray(QByteArray()));
+
+    // the snapshots of several servers add up
+    Snapshot::Metric merged = *registry.snapshot().find("test_usecs");
+    histogram.record(3);
+    histogram.record(5);
+    merged.merge(*registry.snapshot().find("test_usecs"));
+    QCOMPARE(merged.getHistogramCount(), (uint64_t)6);
+    QCOMPARE(merged.sum, (uint64_t)(1003 + 1011));
+    QCOMPARE((int)merged.buckets.size(), 3);
+    QCOMPARE(merged.buckets[0], std::make_pair((uint16_t)3, (uint64_t)3));
+}
+
+void MetricsTests::testPrometheusText() {
+    MetricsRegistry first;
+    first.counter("packets_total", "Packets sent").increment(3);
+    first.histogram("mix_usecs", "Mix \"time\"").record(10);
+
+    MetricsRegistry second;
+    second.gauge("listeners", "Listeners").set(2.0);
+    second.counter("packets_total", "Packets sent").increment(5);
+
+    QByteArray text = toPrometheusText({
+        { "assignment=\"audio-mixer\"", first.snapshot() },
+        { "assignment=\"" + escapeLabelValue("a\"b") + "\"", second.snapshot() }
+    });
+
+    QByteArray expected =
+        "# HELP packets_total Packets sent\n"
+        "# TYPE packets_total counter\n"
+        "packets_total{assignment=\"audio-mixer\"} 3\n"
+        "packets_total{assignment=\"a\\\"b\"} 5\n"
+        "# HELP mix_usecs Mix \"time\"\n"
+        "# TYPE mix_usecs summary\n"
+        "mix_usecs{assignment=\"audio-mixer\",quantile=\"0.5\"} 10\n"
+        "mix_usecs{assignment=\"audio-mixer\",quantile=\"0.9\"} 10\n"
+        "mix_usecs{assignment=\"audio-mixer\",quantile=\"0.99\"} 10\n"
+        "mix_usecs{assignment=\"audio-mixer\",quantile=\"0.999\"} 10\n"
+        "mix_usecs_sum{assignment=\"audio-mixer\"} 10\n"
+        "mix_usecs_count{assignment=\"audio-mixer\"} 1\n"
+        "# HELP listeners Listeners\n"
+        "# TYPE listeners gauge\n"
+        "listeners{assignment=\"a\\\"b\"} 2\n";
+    QCOMPARE(text, expected);
+
+    // without labels
+    QCOMPARE(toPrometheusText({ { QByteArray(), second.snapshot() } }),
+        QByteArray("# HELP listeners Listeners\n# TYPE listeners gauge\nlisteners 2\n"
+                   "# HELP packets_total Packets sent\n# TYPE packets_total counter\npackets_total 5\n"));
+}
+
+// The audio mixer's slaves as they mix a frame for their listeners: a few streams added into the mix of each listener,
+// then the metrics of the listener recorded (a latency and a counter), as AudioMixerSlave::mix does.  Times the frames
+// with and without the metrics, on one slave and on eight.
+void MetricsTests::benchmarkMixerRecording() {
+    const int NUM_LISTENERS = 200;
+    const int STREAMS_PER_LISTENER = 8;
+    const int NUM_FRAMES = 100;
+    const int FRAME_SAMPLES = 480;
+
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+    std::vector<float> streams(STREAMS_PER_LISTENER * FRAME_SAMPLES);
+    for (auto& value : streams) {
+        value = sample(generator);
+    }
+
+    MetricsRegistry registry;
+    Histogram& mixUsecs = registry.histogram("audio_mixer_listener_mix_usecs", "Time to mix a listener");
+    Counter& mixedPackets = registry.counter("audio_mixer_mixed_packets_total", "Mixed audio packets");
+
+    std::atomic<int> numInvalidMixes { 0 };
+    auto timeFrames = [&](int numSlaves, bool withMetrics) {
+        std::atomic<uint64_t> usecs { 0 };
+        std::vector<std::thread> slaves;
+        for (int i = 0; i < numSlaves; ++i) {
+            slaves.emplace_back([&] {
+                std::vector<float> mix(FRAME_SAMPLES);
+                float checksum = 0.0f;
+                auto start = usecTimestampNow();
+                for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+                    for (int listener = 0; listener < NUM_LISTENERS / numSlaves; ++listener) {
+                        auto mixStart = p_high_resolution_clock::now();
+                        std::fill(mix.begin(), mix.end(), 0.0f);
+                        for (int stream = 0; stream < STREAMS_PER_LISTENER; ++stream) {
+                            float gain = 1.0f / (1 + stream + listener % 4);
+                            const float* input = &streams[stream * FRAME_SAMPLES];
+                            for (int j = 0; j < FRAME_SAMPLES; ++j) {
+                                mix[j] += gain * input[j];
+                            }
+                        }
+                        checksum += mix[listener % FRAME_SAMPLES];
+                        if (withMetrics) {
+                            mixedPackets.increment();
+                            auto mixTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                                p_high_resolution_clock::now() - mixStart);
+                            mixUsecs.record(mixTime.count());
+                        }
+                    }
+                }
+                usecs += usecTimestampNow() - start;
+                if (!std::isfinite(checksum)) {
+                    ++numInvalidMixes;
+                }
+            });
+        }
+        for (auto& slave : slaves) {
+            slave.join();
+        }
+        // nanoseconds per listener mix
+        return (float)usecs * NSECS_PER_USEC / (float)(NUM_FRAMES * (NUM_LISTENERS / numSlaves) * numSlaves);
+    };
+
+    for (int numSlaves : { 1, 8 }) {
+        float without = timeFrames(numSlaves, false);
+        float with = timeFrames(numSlaves, true);
+        qDebug() << numSlaves << "slaves:" << with << "nsecs per listener mix with metrics," << without << "without,"
+            << "overhead" << (with - without) << "nsecs";
+    }
+    QCOMPARE(numInvalidMixes.load(), 0);
+    QCOMPARE(mixedPackets.get(), (uint64_t)(NUM_FRAMES * NUM_LISTENERS * 2));
+}
+
+// Scrapes a registry of about the size of a mixer's, and compares with the nested stats objects a mixer sends
+// the domain-server as NodeJsonStats every second, with a hundred listeners.
+void MetricsTests::benchmarkScrape() {
+    const int NUM_COUNTERS = 40;
+    const int NUM_HISTOGRAMS = 10;
+    const int NUM_LISTENERS = 100;
+    const int NUM_SCRAPES = 100;
+
+    MetricsRegistry registry;
+    std::mt19937 generator;
+    std::exponential_distribution<double> latency(1.0 / 500.0);
+    for (int i = 0; i < NUM_COUNTERS; ++i) {
+        registry.counter(QString("test_counter_%1_total").arg(i), "Test counter").increment(i * 1000);
+        registry.gauge(QString("test_gauge_%1").arg(i), "Test gauge").set(i * 0.5);
+    }
+    for (int i = 0; i < NUM_HISTOGRAMS; ++i) {
+        Histogram& histogram = registry.histogram(QString("test_histogram_%1_usecs").arg(i), "Test histogram");
+        for (int j = 0; j < 100000; ++j) {
+            histogram.record((uint64_t)latency(generator));
+        }
+    }
+
+    uint64_t start = usecTimestampNow();
+    size_t textSize = 0;
+    size_t snapshotSize = 0;
+    for (int i = 0; i < NUM_SCRAPES; ++i) {
+        Snapshot snapshot = registry.snapshot();
+        snapshotSize = snapshot.toByteArray().size();
+        textSize = toPrometheusText({ { "assignment=\"audio-mixer\"", snapshot } }).size();
+    }
+    float scrapeUsecs = (float)(usecTimestampNow() - start) / NUM_SCRAPES;
+
+    // as AudioMixer::sendStatsPacket and NodeList::sendStats
+    start = usecTimestampNow();
+    size_t jsonSize = 0;
+    for (int i = 0; i < NUM_SCRAPES; ++i) {
+        QJsonObject statsObject;
+        QJsonObject timingStats;
+        QJsonObject mixStats;
+        for (int j = 0; j < NUM_COUNTERS / 2; ++j) {
+            timingStats[QString("us_per_timing_%1").arg(j)] = (qint64)j * 10;
+            mixStats[QString("mix_stat_%1").arg(j)] = j;
+        }
+        statsObject["avg_timing_stats"] = timingStats;
+        statsObject["mix_stats"] = mixStats;
+        QJsonObject listenerStats;
+        for (int j = 0; j < NUM_LISTENERS; ++j) {
+            QJsonObject nodeStats;
+            QJsonObject jitter;
+            for (int k = 0; k < 10; ++k) {
+                jitter[QString("jitter_stat_%1").arg(k)] = k * 1.5;
+            }
+            nodeStats["outbound_kbps"] = 64.0f;
+            nodeStats["jitter"] = jitter;
+            listenerStats[QUuid::createUuid().toString()] = nodeStats;
+        }
+        statsObject["z_listeners"] = listenerStats;
+        jsonSize = QJsonDocument(statsObject).toBinaryData().size();
+    }
+    float jsonUsecs = (float)(usecTimestampNow() - start) / NUM_SCRAPES;
+
+    qDebug() << registry.getNumMetrics() << "metrics:" << scrapeUsecs << "usecs per scrape," << snapshotSize
+        << "bytes of snapshot for the domain-server," << textSize << "bytes of Prometheus text";
+    qDebug() << "  stats objects with" << NUM_LISTENERS << "listeners:" << jsonUsecs << "usecs," << jsonSize << "bytes";
+}
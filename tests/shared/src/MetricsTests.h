@@ -0,0 +1,28 @@
+//
+//  MetricsTests.h
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MetricsTests_h
+#define hifi_MetricsTests_h
+
+#include <QtTest/QtTest>
+
+class MetricsTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testHistogramBuckets();
+    void testQuantiles();
+    void testSnapshots();
+    void testPrometheusText();
+    void benchmarkMixerRecording();
+    void benchmarkScrape();
+};
+
+#endif // hifi_MetricsTests_h
@@ -0,0 +1,212 @@
+//
+//  PerformanceTimerTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PerformanceTimerTests.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QThread>
+
+#include <NumericalConstants.h>
+#include <PerfStat.h>
+
+QTEST_MAIN(PerformanceTimerTests)
+
+void PerformanceTimerTests::testRecords() {
+    PerformanceTimer::setActive(true);
+    {
+        PerformanceTimer outerTimer("outer");
+        QCOMPARE(PerformanceTimer::getContextName(), QString("/outer"));
+        for (int i = 0; i < 3; ++i) {
+            PerformanceTimer innerTimer("inner");
+            QCOMPARE(PerformanceTimer::getContextName(), QString("/outer/inner"));
+        }
+        {
+            // the same name, registered without the per-thread cache
+            PerformanceTimer innerTimer(QString("inner"));
+        }
+        {
+            // names built at run time, as the task labels are, that may share a buffer
+            char name[16];
+            strcpy(name, "built");
+            PerformanceTimer builtTimer(name);
+            strcpy(name, "rebuilt");
+            PerformanceTimer rebuiltTimer(name);
+            QCOMPARE(PerformanceTimer::getContextName(), QString("/outer/built/rebuilt"));
+        }
+        static const PerformanceTimer::NameID OTHER_NAME_ID = PerformanceTimer::registerName("other");
+        PerformanceTimer otherTimer(OTHER_NAME_ID);
+        QCOMPARE(PerformanceTimer::getContextName(), QString("/outer/other"));
+    }
+    QCOMPARE(PerformanceTimer::getContextName(), QString());
+    PerformanceTimer::addTimerRecord("/physics/added", 10);
+
+    auto records = PerformanceTimer::getAllTimerRecords();
+    QCOMPARE(records.size(), 6);
+    QCOMPARE(records["/outer"].getNumAccumulations(), (quint64)1);
+    QCOMPARE(records["/outer/inner"].getNumAccumulations(), (quint64)4);
+    QCOMPARE(records["/outer/other"].getNumAccumulations(), (quint64)1);
+    QCOMPARE(records["/outer/built/rebuilt"].getNumAccumulations(), (quint64)1);
+    QCOMPARE(records["/physics/added"].getNumAccumulations(), (quint64)1);
+
+    // the counts are of what was timed since the last tally
+    PerformanceTimer::tallyAllTimerRecords();
+    QCOMPARE(PerformanceTimer::getAllTimerRecords()["/outer/inner"].getCount(), (quint64)1);
+    {
+        PerformanceTimer outerTimer("outer");
+    }
+    records = PerformanceTimer::getAllTimerRecords();
+    QCOMPARE(records["/outer"].getNumAccumulations(), (quint64)1);
+    QCOMPARE(records["/outer/inner"].getNumAccumulations(), (quint64)0);
+
+    // nothing timed while inactive is kept
+    PerformanceTimer::setActive(false);
+    {
+        PerformanceTimer outerTimer("outer");
+    }
+    QVERIFY(PerformanceTimer::getAllTimerRecords().isEmpty());
+    PerformanceTimer::setActive(true);
+    QVERIFY(PerformanceTimer::getAllTimerRecords().isEmpty());
+    PerformanceTimer::setActive(false);
+}
+
+void PerformanceTimerTests::testThreads() {
+    const int NUM_THREADS = 4;
+    const int NUM_SCOPES = 1000;
+
+    PerformanceTimer::setActive(true);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([i] {
+            PerformanceTimer threadTimer(i % 2 == 0 ? "even" : "odd");
+            for (int scope = 0; scope < NUM_SCOPES; ++scope) {
+                PerformanceTimer scopeTimer("scope");
+            }
+        });
+    }
+    // the threads are merged while they run and after they finished
+    PerformanceTimer::tallyAllTimerRecords();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto records = PerformanceTimer::getAllTimerRecords();
+    quint64 numEvenScopes = records["/even/scope"].getNumAccumulations();
+    quint64 numOddScopes = records["/odd/scope"].getNumAccumulations();
+    QVERIFY(numEvenScopes + numOddScopes <= (quint64)(NUM_THREADS * NUM_SCOPES));
+    PerformanceTimer::tallyAllTimerRecords();
+
+    // what was tallied is not counted again
+    records = PerformanceTimer::getAllTimerRecords();
+    QCOMPARE(records["/even/scope"].getNumAccumulations(), (quint64)0);
+    QCOMPARE(records["/odd/scope"].getNumAccumulations(), (quint64)0);
+    QCOMPARE(records["/even"].getNumAccumulations(), (quint64)0);
+    PerformanceTimer::setActive(false);
+
+    // every scope was merged once
+    PerformanceTimer::setActive(true);
+    threads.clear();
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([] {
+            for (int scope = 0; scope < NUM_SCOPES; ++scope) {
+                PerformanceTimer scopeTimer("scope");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    QCOMPARE(PerformanceTimer::getAllTimerRecords()["/scope"].getNumAccumulations(), (quint64)(NUM_THREADS * NUM_SCOPES));
+    PerformanceTimer::setActive(false);
+}
+
+// The timers as they were, with a lock and the full name of the timers of each thread kept in a string.
+class LockedTimer {
+public:
+    LockedTimer(const QString& name) : _name(name) {
+        {
+            std::lock_guard<std::mutex> guard(_mutex);
+            QString& fullName = _fullNames[QThread::currentThread()];
+            fullName.append("/");
+            fullName.append(_name);
+        }
+        _start = usecTimestampNow();
+    }
+
+    ~LockedTimer() {
+        quint64 elapsedUsec = (usecTimestampNow() - _start);
+        std::lock_guard<std::mutex> guard(_mutex);
+        QString& fullName = _fullNames[QThread::currentThread()];
+        _records[fullName].accumulateResult(elapsedUsec);
+        fullName.resize(fullName.size() - (_name.size() + 1));
+    }
+
+    static std::mutex _mutex;
+    static QHash<QThread*, QString> _fullNames;
+    static QMap<QString, PerformanceTimerRecord> _records;
+
+private:
+    quint64 _start;
+    QString _name;
+};
+
+std::mutex LockedTimer::_mutex;
+QHash<QThread*, QString> LockedTimer::_fullNames;
+QMap<QString, PerformanceTimerRecord> LockedTimer::_records;
+
+// Times a scope nested in another, as the timers of the render and physics threads are, from 1 and 8 threads at
+// once, with the locked timers and with the timers of the slots of each thread.
+void PerformanceTimerTests::benchmarkScopes() {
+    const int NUM_SCOPES = 100000;
+
+    auto timeScopes = [&](int numThreads, bool locked) {
+        std::atomic<uint64_t> usecs { 0 };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i) {
+            threads.emplace_back([&] {
+                auto start = usecTimestampNow();
+                if (locked) {
+                    LockedTimer outerTimer("outer");
+                    for (int scope = 0; scope < NUM_SCOPES; ++scope) {
+                        LockedTimer scopeTimer("scope");
+                    }
+                } else {
+                    PerformanceTimer outerTimer("outer");
+                    for (int scope = 0; scope < NUM_SCOPES; ++scope) {
+                        PerformanceTimer scopeTimer("scope");
+                    }
+                }
+                usecs += usecTimestampNow() - start;
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // nanoseconds per scope
+        return (float)usecs * NSECS_PER_USEC / (numThreads * NUM_SCOPES);
+    };
+
+    PerformanceTimer::setActive(true);
+    for (int numThreads : { 1, 8 }) {
+        float locked = timeScopes(numThreads, true);
+        float slots = timeScopes(numThreads, false);
+        qDebug() << numThreads << "threads:" << locked << "nsecs per scope locked," << slots << "nsecs in slots";
+
+        QCOMPARE(LockedTimer::_records["/outer/scope"].getNumAccumulations(), (quint64)(numThreads * NUM_SCOPES));
+        QCOMPARE(PerformanceTimer::getAllTimerRecords()["/outer/scope"].getNumAccumulations(), (quint64)(numThreads * NUM_SCOPES));
+        LockedTimer::_records.clear();
+        PerformanceTimer::tallyAllTimerRecords();
+    }
+    PerformanceTimer::setActive(false);
+}
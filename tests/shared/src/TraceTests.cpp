@@ -8,7 +8,12 @@
 
 #include "TraceTests.h"
 
+#include <thread>
+
 #include <QtTest/QtTest>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtGui/QDesktopServices>
 
 #include <Profile.h>
@@ -45,3 +50,150 @@ void TraceTests::testTraceSerialization() {
     qDebug() << "Done";
 }
 
+
+void TraceTests::testBinaryRoundTrip() {
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startTracing();
+    {
+        PROFILE_RANGE(test, "Range \"quoted\"")
+        PROFILE_COUNTER(test, "TestCounter", { { "value", 42 }, { "ratio", 0.5 } })
+        PROFILE_INSTANT(test, "TestInstant")
+    }
+    tracer->stopTracing();
+
+    tracing::TraceData traceData = tracer->takeTraceData();
+    QVERIFY(traceData.records.size() >= 4);
+
+    QByteArray json = traceData.toJson();
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(document.isArray());
+
+    int numFound = 0;
+    for (const auto& value : document.array()) {
+        QJsonObject event = value.toObject();
+        QString name = event["name"].toString();
+        if (name == "Range \"quoted\"") {
+            QCOMPARE(event["cat"].toString(), QString("trace.test"));
+            ++numFound;
+        } else if (name == "TestCounter") {
+            QCOMPARE(event["ph"].toString(), QString("C"));
+            QCOMPARE(event["args"].toObject()["value"].toInt(), 42);
+            QCOMPARE(event["args"].toObject()["ratio"].toDouble(), 0.5);
+            ++numFound;
+        } else if (name == "TestInstant") {
+            // extra fields go next to the fields of the event
+            QCOMPARE(event["s"].toString(), QString("t"));
+            ++numFound;
+        }
+    }
+    QCOMPARE(numFound, 4);
+
+    // the binary format holds the same trace, in less space
+    QByteArray binary = traceData.toBinary();
+    QVERIFY(binary.size() < json.size());
+    tracing::TraceData decoded;
+    QVERIFY(decoded.fromBinary(binary));
+    QCOMPARE(decoded.toJson(), json);
+
+    QVERIFY(!decoded.fromBinary(json));
+    QVERIFY(!decoded.fromBinary(binary.left(binary.size() / 2)));
+}
+
+// Samples events with IDs and arguments of their own, as requests do, well past what sampling keeps: the string table
+// stays bounded, and the events kept still name their own strings.
+void TraceTests::testSampledStrings() {
+    const int NUM_THREADS = 4;
+    const int NUM_BURSTS = 20;
+    const int EVENTS_PER_BURST = 4000;
+    const int PAUSE_MSECS = 2 * tracing::Tracer::FLUSH_INTERVAL_MSECS;
+
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+    tracer->startSampling(1.0f);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([&, i] {
+            for (int burst = 0; burst < NUM_BURSTS; ++burst) {
+                for (int event = 0; event < EVENTS_PER_BURST; ++event) {
+                    QString request = QString("request %1.%2.%3").arg(i).arg(burst).arg(event);
+                    tracing::traceEvent(trace_test, "Request", tracing::AsyncNestableInstant, request,
+                        { { "url", request } });
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_MSECS));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    tracer->stopTracing();
+
+    tracing::TraceData traceData = tracer->takeTraceData();
+    qDebug() << traceData.records.size() << "events kept," << traceData.strings.size() << "strings,"
+        << tracer->getNumDroppedEvents() << "dropped";
+    QVERIFY(traceData.records.size() <= tracing::Tracer::MAX_SAMPLED_RECORDS);
+    QVERIFY(traceData.strings.size() < 2 * tracing::Tracer::MAX_SAMPLED_RECORDS +
+        NUM_THREADS * tracing::Tracer::THREAD_BUFFER_SIZE);
+    for (const auto& record : traceData.records) {
+        if (traceData.strings[record.name] == "Request") {
+            QCOMPARE(record.numArgs, (uint8_t)1);
+            QCOMPARE(traceData.strings[record.args[0].key], QString("url"));
+            QCOMPARE(traceData.strings[record.args[0].string], traceData.strings[record.id]);
+            QVERIFY(traceData.strings[record.id].startsWith("request "));
+        }
+    }
+}
+
+// Times recording a range, a pair of events, from 1 and 8 threads at once, while recording and while not.  The threads
+// record in bursts that fit their buffers, with pauses for the flusher to drain them.
+void TraceTests::benchmarkEventOverhead() {
+    const int NUM_BURSTS = 5;
+    const int RANGES_PER_BURST = 1000;
+    const int PAUSE_MSECS = 2 * tracing::Tracer::FLUSH_INTERVAL_MSECS;
+
+    auto tracer = DependencyManager::set<tracing::Tracer>();
+
+    auto timeRanges = [&](int numThreads) {
+        std::atomic<uint64_t> usecs { 0 };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i) {
+            threads.emplace_back([&] {
+                for (int burst = 0; burst < NUM_BURSTS; ++burst) {
+                    auto start = usecTimestampNow();
+                    for (int range = 0; range < RANGES_PER_BURST; ++range) {
+                        PROFILE_RANGE(test, "BenchmarkRange")
+                    }
+                    usecs += usecTimestampNow() - start;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_MSECS));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // nanoseconds per event
+        return (float)usecs * NSECS_PER_USEC / (2.0f * numThreads * NUM_BURSTS * RANGES_PER_BURST);
+    };
+
+    for (int numThreads : { 1, 8 }) {
+        float notRecording = timeRanges(numThreads);
+
+        tracer->startTracing();
+        float recording = timeRanges(numThreads);
+        tracer->stopTracing();
+        size_t numRecords = tracer->takeTraceData().records.size();
+
+        qDebug() << numThreads << "threads:" << recording << "nsecs per event recording," << notRecording
+            << "nsecs not recording," << numRecords << "events recorded," << tracer->getNumDroppedEvents() << "dropped so far";
+        QVERIFY(numRecords + tracer->getNumDroppedEvents() >= (size_t)(2 * numThreads * NUM_BURSTS * RANGES_PER_BURST));
+    }
+
+    // sampling records in windows of the flush interval, for the given fraction of the time
+    tracer->startSampling(0.25f);
+    QVERIFY(tracer->isEnabled() && tracer->isSampling());
+    float sampling = timeRanges(4);
+    tracer->stopTracing();
+    qDebug() << "4 threads sampling a quarter of the time:" << sampling << "nsecs per event,"
+        << tracer->takeTraceData().records.size() << "events recorded";
+}
@@ -15,6 +15,9 @@ class TraceTests : public QObject {
     Q_OBJECT
 private slots:
     void testTraceSerialization();
+    void testBinaryRoundTrip();
+    void testSampledStrings();
+    void benchmarkEventOverhead();
 };
 
 #endif // hifi_TraceTests_h
@@ -0,0 +1,221 @@
+//
+//  WorkStealingRangesTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "WorkStealingRangesTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <WorkStealingRanges.h>
+
+QTEST_MAIN(WorkStealingRangesTests)
+
+void WorkStealingRangesTests::testOwnRange() {
+    WorkStealingRanges ranges;
+    ranges.reset(10, 3);
+    QCOMPARE(ranges.getNumWorkers(), 3);
+
+    // the middle range is [3, 6), claimed in order, and then the others are stolen from
+    int begin, end;
+    bool isStolen;
+    int next = 3;
+    while (ranges.claim(1, begin, end, isStolen) && !isStolen) {
+        QCOMPARE(begin, next);
+        QVERIFY(end > begin && end <= 6);
+        next = end;
+    }
+    QCOMPARE(next, 6);
+    QVERIFY(isStolen);
+
+    // an empty job
+    ranges.reset(0, 3);
+    QVERIFY(!ranges.claim(0, begin, end, isStolen));
+    QVERIFY(!ranges.claim(2, begin, end, isStolen));
+}
+
+void WorkStealingRangesTests::testStealing() {
+    const int NUM_ITEMS = 1000;
+    const int NUM_WORKERS = 8;
+
+    WorkStealingRanges ranges;
+    ranges.reset(NUM_ITEMS, NUM_WORKERS);
+
+    // one worker does it all, most of it stolen, and every item once
+    std::vector<int> counts(NUM_ITEMS, 0);
+    int numStolen = 0;
+    int numClaims = 0;
+    int begin, end;
+    bool isStolen;
+    while (ranges.claim(0, begin, end, isStolen)) {
+        for (int i = begin; i < end; ++i) {
+            ++counts[i];
+        }
+        if (isStolen) {
+            numStolen += end - begin;
+        }
+        ++numClaims;
+    }
+
+    for (int count : counts) {
+        QCOMPARE(count, 1);
+    }
+    QCOMPARE(numStolen, NUM_ITEMS - NUM_ITEMS / NUM_WORKERS);
+
+    // chunks shrink as ranges empty, so it takes more claims than ranges, but far fewer than items
+    QVERIFY(numClaims > NUM_WORKERS && numClaims < NUM_ITEMS / 4);
+}
+
+void WorkStealingRangesTests::testThreads() {
+    const int NUM_ITEMS = 5000;
+    const int NUM_WORKERS = 8;
+    const int NUM_JOBS = 100;
+
+    WorkStealingRanges ranges;
+    std::unique_ptr<std::atomic<int>[]> counts(new std::atomic<int>[NUM_ITEMS]);
+
+    for (int job = 0; job < NUM_JOBS; ++job) {
+        int numItems = NUM_ITEMS - job * 37;
+        for (int i = 0; i < numItems; ++i) {
+            counts[i] = 0;
+        }
+        ranges.reset(numItems, NUM_WORKERS);
+
+        std::vector<std::thread> threads;
+        for (int worker = 0; worker < NUM_WORKERS; ++worker) {
+            threads.emplace_back([&, worker] {
+                int begin, end;
+                bool isStolen;
+                while (ranges.claim(worker, begin, end, isStolen)) {
+                    for (int i = begin; i < end; ++i) {
+                        counts[i].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (int i = 0; i < numItems; ++i) {
+            QCOMPARE(counts[i].load(), 1);
+        }
+    }
+}
+
+using Clock = std::chrono::steady_clock;
+
+static void spin(int usecs) {
+    auto end = Clock::now() + std::chrono::microseconds(usecs);
+    while (Clock::now() < end) {
+    }
+}
+
+enum Scheduling {
+    EVEN_SPLIT,     // a fixed share of the nodes for each thread
+    SHARED_QUEUE,   // one node at a time, from a queue shared by the threads
+    WORK_STEALING,
+    NUM_SCHEDULINGS
+};
+
+// the time of a frame, in usecs, broadcasting to listeners of the given costs
+static float runFrame(Scheduling scheduling, int numThreads, const std::vector<int>& costs, WorkStealingRanges& ranges) {
+    int numNodes = (int)costs.size();
+    ranges.reset(numNodes, numThreads);
+    std::atomic<int> queueFront { 0 };
+
+    // the frame starts once every thread is ready
+    std::atomic<int> numReady { 0 };
+    Clock::time_point start;
+    std::vector<Clock::time_point> finishes(numThreads);
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < numThreads; ++thread) {
+        threads.emplace_back([&, thread] {
+            if (numReady.fetch_add(1) == numThreads - 1) {
+                start = Clock::now();
+                numReady.store(numThreads + 1);
+            }
+            while (numReady.load() != numThreads + 1) {
+            }
+
+            if (scheduling == EVEN_SPLIT) {
+                for (int i = numNodes * thread / numThreads; i < numNodes * (thread + 1) / numThreads; ++i) {
+                    spin(costs[i]);
+                }
+            } else if (scheduling == SHARED_QUEUE) {
+                for (int i = queueFront++; i < numNodes; i = queueFront++) {
+                    spin(costs[i]);
+                }
+            } else {
+                int begin, end;
+                bool isStolen;
+                while (ranges.claim(thread, begin, end, isStolen)) {
+                    for (int i = begin; i < end; ++i) {
+                        spin(costs[i]);
+                    }
+                }
+            }
+            finishes[thread] = Clock::now();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto finish = *std::max_element(finishes.begin(), finishes.end());
+    return (float)std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count();
+}
+
+static float percentile(std::vector<float> values, float fraction) {
+    std::sort(values.begin(), values.end());
+    return values[(int)(fraction * (values.size() - 1))];
+}
+
+void WorkStealingRangesTests::benchmarkBroadcastFrames() {
+    const int NUM_LISTENERS = 100;
+    const int NUM_FRAMES = 200;
+    const int LISTENER_USECS = 20;
+    const int LARGE_LISTENER_USECS = 400;   // with a large view set, or many traits to send
+    const int FIRST_LARGE_LISTENER = 10;
+    const int NUM_LARGE_LISTENERS = 5;      // that joined together, and so sit together in the node list
+
+    int numThreads = std::max(std::min((int)std::thread::hardware_concurrency(), 4), 2);
+
+    std::vector<int> costs(NUM_LISTENERS, LISTENER_USECS);
+    for (int i = FIRST_LARGE_LISTENER; i < FIRST_LARGE_LISTENER + NUM_LARGE_LISTENERS; ++i) {
+        costs[i] = LARGE_LISTENER_USECS;
+    }
+
+    WorkStealingRanges ranges;
+    std::vector<float> frameUsecs[NUM_SCHEDULINGS];
+    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+        for (int scheduling = 0; scheduling < NUM_SCHEDULINGS; ++scheduling) {
+            frameUsecs[scheduling].push_back(runFrame((Scheduling)scheduling, numThreads, costs, ranges));
+        }
+    }
+
+    const char* NAMES[NUM_SCHEDULINGS] = { "even split:   ", "shared queue: ", "work stealing:" };
+    qDebug() << NUM_LISTENERS << "listeners," << NUM_LARGE_LISTENERS << "of them large," << numThreads << "threads:";
+    for (int scheduling = 0; scheduling < NUM_SCHEDULINGS; ++scheduling) {
+        qDebug() << " " << NAMES[scheduling]
+            << "p50" << percentile(frameUsecs[scheduling], 0.50f)
+            << "p95" << percentile(frameUsecs[scheduling], 0.95f)
+            << "p99" << percentile(frameUsecs[scheduling], 0.99f) << "usecs a frame";
+    }
+
+    // stealing spreads the large listeners that an even split leaves on one thread, given the cores to run them
+    if ((int)std::thread::hardware_concurrency() >= numThreads) {
+        QVERIFY(percentile(frameUsecs[WORK_STEALING], 0.50f) < percentile(frameUsecs[EVEN_SPLIT], 0.50f));
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  WorkStealingRangesTests.h
+//  tests/shared/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_WorkStealingRangesTests_h
+#define hifi_WorkStealingRangesTests_h
+
+#include <QtTest/QtTest>
+
+class WorkStealingRangesTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testOwnRange();
+    void testStealing();
+    void testThreads();
+    void benchmarkBroadcastFrames();
+};
+
+#endif // hifi_WorkStealingRangesTests_h
@@ -0,0 +1,150 @@
+//
+//  RegionThrottleTests.cpp
+//  tests/workload/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "RegionThrottleTests.h"
+
+#include <random>
+
+#include <workload/RegionThrottle.h>
+#include <workload/Space.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(RegionThrottleTests)
+
+void RegionThrottleTests::testRegionsMatchSpace() {
+    const int NUM_PROXIES = 2000;
+    const float EXTENT = 400.0f;
+
+    workload::RegionThrottle throttle;
+    glm::vec3 agentPosition(10.0f, -20.0f, 30.0f);
+    workload::Views views;
+    throttle.evalViews({ agentPosition }, views);
+    QCOMPARE((int)views.size(), 1);
+    for (uint32_t k = 0; k < workload::Region::NUM_TRACKED_REGIONS; ++k) {
+        QVERIFY(glm::vec3(views[0].regions[k]) == agentPosition);
+        QVERIFY(views[0].regions[k].w == throttle.getRegionRadius(k));
+    }
+
+    workload::Space space;
+    space.setViews(views);
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> position(-EXTENT, EXTENT);
+    std::uniform_real_distribution<float> radius(0.1f, 10.0f);
+    std::vector<workload::Sphere> spheres;
+    workload::Transaction transaction;
+    for (int i = 0; i < NUM_PROXIES; ++i) {
+        spheres.emplace_back(position(generator), position(generator), position(generator), radius(generator));
+        transaction.reset(space.allocateID(), spheres.back(), workload::Owner());
+    }
+    space.enqueueTransaction(transaction);
+    space.enqueueFrame();
+    space.processTransactionQueue();
+    workload::Changes changes;
+    space.categorizeAndGetChanges(changes);
+
+    // a single agent classifies a sphere exactly as a Space with its view does
+    for (int i = 0; i < NUM_PROXIES; ++i) {
+        QCOMPARE(throttle.evalRegion(agentPosition, spheres[i]), space.getRegion(i));
+    }
+}
+
+void RegionThrottleTests::testIntervals() {
+    workload::RegionThrottle throttle;
+    const uint64_t R4_INTERVAL = throttle.getRegionInterval(workload::Region::R4);
+    QVERIFY(R4_INTERVAL > throttle.getRegionInterval(workload::Region::R3));
+    uint64_t lastRefresh = 10 * USECS_PER_SECOND;
+
+    QVERIFY(throttle.isDue(workload::Region::R1, lastRefresh, lastRefresh));
+    QVERIFY(throttle.isDue(workload::Region::R2, lastRefresh, lastRefresh));
+    QVERIFY(!throttle.isDue(workload::Region::R4, lastRefresh, lastRefresh + R4_INTERVAL - 1));
+    QVERIFY(throttle.isDue(workload::Region::R4, lastRefresh, lastRefresh + R4_INTERVAL));
+
+    // nothing is held back before it is categorized, nor when the clock goes backwards
+    QVERIFY(throttle.isDue(workload::Region::UNKNOWN, lastRefresh, lastRefresh));
+    QVERIFY(throttle.isDue(workload::Region::INVALID, lastRefresh, lastRefresh));
+    QVERIFY(throttle.isDue(workload::Region::R4, lastRefresh, lastRefresh - 1));
+
+    throttle.setRegionInterval(workload::Region::R4, 0);
+    QVERIFY(throttle.isDue(workload::Region::R4, lastRefresh, lastRefresh));
+}
+
+// A sparse domain as the avatar mixer sees it: small groups of agents scattered over a couple of kilometers.  Counts the
+// avatar updates the mixer would send every agent at 45 frames per second, by region or to everyone every frame as
+// it does without the throttle, and times the classification of every pair of agents.
+void RegionThrottleTests::benchmarkSparseDomainSends() {
+    const int NUM_GROUPS = 50;
+    const int AGENTS_PER_GROUP = 6;
+    const float DOMAIN_EXTENT = 1024.0f;
+    const float GROUP_EXTENT = 4.0f;
+    const float AVATAR_RADIUS = 1.0f;
+    const int FRAMES_PER_SECOND = 45;
+    const int NUM_FRAMES = 10 * FRAMES_PER_SECOND;
+    const uint64_t FRAME_USECS = USECS_PER_SECOND / FRAMES_PER_SECOND;
+    const uint64_t START_TIME = 60 * USECS_PER_SECOND; // like the clock of a mixer, well past the intervals
+
+    std::mt19937 generator;
+    std::uniform_real_distribution<float> domain(-DOMAIN_EXTENT, DOMAIN_EXTENT);
+    std::uniform_real_distribution<float> group(-GROUP_EXTENT, GROUP_EXTENT);
+    std::vector<glm::vec3> agents;
+    for (int i = 0; i < NUM_GROUPS; ++i) {
+        glm::vec3 center(domain(generator), 0.0f, domain(generator));
+        for (int j = 0; j < AGENTS_PER_GROUP; ++j) {
+            agents.push_back(center + glm::vec3(group(generator), 0.0f, group(generator)));
+        }
+    }
+    const int NUM_AGENTS = (int)agents.size();
+
+    workload::RegionThrottle throttle;
+    std::vector<uint64_t> lastSent(NUM_AGENTS * NUM_AGENTS, 0);
+    uint64_t numSent = 0;
+    uint64_t numSentInGroup = 0;
+    uint64_t numRegion[workload::Region::NUM_KNOWN_REGIONS] = {};
+    uint64_t classifyTime = 0;
+    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+        uint64_t now = START_TIME + (uint64_t)frame * FRAME_USECS;
+        uint64_t start = usecTimestampNow();
+        for (int listener = 0; listener < NUM_AGENTS; ++listener) {
+            for (int other = 0; other < NUM_AGENTS; ++other) {
+                if (other == listener) {
+                    continue;
+                }
+                uint8_t region = throttle.evalRegion(agents[listener], workload::Sphere(agents[other], AVATAR_RADIUS));
+                ++numRegion[region];
+                uint64_t& last = lastSent[listener * NUM_AGENTS + other];
+                if (throttle.isDue(region, last, now)) {
+                    last = now;
+                    ++numSent;
+                    if (listener / AGENTS_PER_GROUP == other / AGENTS_PER_GROUP) {
+                        ++numSentInGroup;
+                    }
+                }
+            }
+        }
+        classifyTime += usecTimestampNow() - start;
+    }
+
+    // the agents in a group still get each other every frame
+    uint64_t numPairsInGroups = (uint64_t)NUM_GROUPS * AGENTS_PER_GROUP * (AGENTS_PER_GROUP - 1);
+    QVERIFY(numSentInGroup == numPairsInGroups * NUM_FRAMES);
+    uint64_t numSentUnthrottled = (uint64_t)NUM_AGENTS * (NUM_AGENTS - 1) * NUM_FRAMES;
+    QVERIFY(numSent < numSentUnthrottled);
+
+    float seconds = (float)NUM_FRAMES / FRAMES_PER_SECOND;
+    uint64_t numPairFrames = (uint64_t)NUM_AGENTS * (NUM_AGENTS - 1) * NUM_FRAMES;
+    qDebug() << NUM_AGENTS << "agents in" << NUM_GROUPS << "groups," << NUM_FRAMES << "frames at" << FRAMES_PER_SECOND << "fps";
+    qDebug() << "  pairs by region R1..R4:" << (float)numRegion[0] / numPairFrames << (float)numRegion[1] / numPairFrames
+        << (float)numRegion[2] / numPairFrames << (float)numRegion[3] / numPairFrames;
+    qDebug() << "  avatar updates per agent per second:" << (float)numSentUnthrottled / NUM_AGENTS / seconds << "unthrottled,"
+        << (float)numSent / NUM_AGENTS / seconds << "throttled by region ("
+        << 100.0f * (float)numSent / (float)numSentUnthrottled << "% of the data bandwidth)";
+    qDebug() << "  classification:" << (float)classifyTime / NUM_FRAMES / USECS_PER_MSEC << "msecs per frame for"
+        << NUM_AGENTS * (NUM_AGENTS - 1) << "pairs";
+}
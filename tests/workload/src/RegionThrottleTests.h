@@ -0,0 +1,25 @@
+//
+//  RegionThrottleTests.h
+//  tests/workload/src
+//
+//  Copyright 2020 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_workload_RegionThrottleTests_h
+#define hifi_workload_RegionThrottleTests_h
+
+#include <QtTest/QtTest>
+
+class RegionThrottleTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRegionsMatchSpace();
+    void testIntervals();
+    void benchmarkSparseDomainSends();
+};
+
+#endif // hifi_workload_RegionThrottleTests_h
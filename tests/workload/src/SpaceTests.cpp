@@ -18,89 +18,105 @@
 #include <SharedUtil.h>
 
 
-const float INV_SQRT_3 = 1.0f / sqrtf(3.0f);
-
 QTEST_MAIN(SpaceTests)
 
+using Changes = std::vector<workload::Space::Change>;
+
+static void applyTransaction(workload::Space& space, const workload::Transaction& transaction) {
+    space.enqueueTransaction(transaction);
+    space.enqueueFrame();
+    space.processTransactionQueue();
+}
+
+static workload::View makeView(const glm::vec3& center, float near, float mid, float far) {
+    workload::View view;
+    view.origin = center;
+    view.regions[workload::Region::R1] = workload::Sphere(center, near);
+    view.regions[workload::Region::R2] = workload::Sphere(center, mid);
+    view.regions[workload::Region::R3] = workload::Sphere(center, far);
+    return view;
+}
+
 void SpaceTests::testOverlaps() {
     workload::Space space;
-    using Changes = std::vector<workload::Space::Change>;
-    using Views = std::vector<workload::Space::View>;
 
     glm::vec3 viewCenter(0.0f, 0.0f, 0.0f);
     float near = 1.0f;
     float mid = 2.0f;
     float far = 3.0f;
 
-    Views views;
-    views.push_back(workload::Space::View(viewCenter, near, mid, far));
+    workload::Views views;
+    views.push_back(makeView(viewCenter, near, mid, far));
     space.setViews(views);
 
     int32_t proxyId = 0;
     const float DELTA = 0.001f;
     float proxyRadius = 0.5f;
     glm::vec3 proxyPosition = viewCenter + glm::vec3(0.0f, 0.0f, far + proxyRadius + DELTA);
-    workload::Space::Sphere proxySphere(proxyPosition, proxyRadius);
+    workload::Sphere proxySphere(proxyPosition, proxyRadius);
 
     { // create very_far proxy
-        proxyId = space.createProxy(proxySphere);
+        proxyId = space.allocateID();
+        workload::Transaction transaction;
+        transaction.reset(proxyId, proxySphere, workload::Owner());
+        applyTransaction(space, transaction);
         QVERIFY(space.getNumObjects() == 1);
 
         Changes changes;
         space.categorizeAndGetChanges(changes);
-        QVERIFY(changes.size() == 0);
+        QVERIFY(changes.size() == 1);
+        QVERIFY(changes[0].proxyId == proxyId);
+        QVERIFY(changes[0].region == workload::Region::R4);
+        QVERIFY(changes[0].prevRegion == workload::Region::UNKNOWN);
     }
 
     { // move proxy far
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, far + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_FAR);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_UNKNOWN);
+        QVERIFY(changes[0].region == workload::Region::R3);
+        QVERIFY(changes[0].prevRegion == workload::Region::R4);
     }
 
     { // move proxy mid
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, mid + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_MIDDLE);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_FAR);
+        QVERIFY(changes[0].region == workload::Region::R2);
+        QVERIFY(changes[0].prevRegion == workload::Region::R3);
     }
 
     { // move proxy near
         float newRadius = 1.0f;
         glm::vec3 newPosition = viewCenter + glm::vec3(0.0f, 0.0f, near + newRadius - DELTA);
-        workload::Space::Sphere newSphere(newPosition, newRadius);
-        std::vector<workload::Space::ProxyUpdate> updates;
-        updates.push_back(workload::Space::ProxyUpdate(proxyId, newSphere));
-        space.updateProxies(updates);
+        workload::Transaction transaction;
+        transaction.update(proxyId, workload::Sphere(newPosition, newRadius));
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 1);
         QVERIFY(changes[0].proxyId == proxyId);
-        QVERIFY(changes[0].region == workload::Space::REGION_NEAR);
-        QVERIFY(changes[0].prevRegion == workload::Space::REGION_MIDDLE);
+        QVERIFY(changes[0].region == workload::Region::R1);
+        QVERIFY(changes[0].prevRegion == workload::Region::R2);
     }
 
     { // delete proxy
         // NOTE: atm deleting a proxy doesn't result in a "Change"
-        std::vector<int32_t> deadProxies;
-        deadProxies.push_back(proxyId);
-        space.deleteProxies(deadProxies);
+        workload::Transaction transaction;
+        transaction.remove(proxyId);
+        applyTransaction(space, transaction);
         Changes changes;
         space.categorizeAndGetChanges(changes);
         QVERIFY(changes.size() == 0);
@@ -108,8 +124,6 @@ void SpaceTests::testOverlaps() {
     }
 }
 
-#ifdef MANUAL_TEST
-
 const float WORLD_WIDTH = 1000.0f;
 const float MIN_RADIUS = 1.0f;
 const float MAX_RADIUS = 100.0f;
@@ -123,158 +137,110 @@ glm::vec3 randomVec3() {
     return v;
 }
 
-void generateSpheres(uint32_t numProxies, std::vector<workload::Space::Sphere>& spheres) {
-    spheres.reserve(numProxies);
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        workload::Space::Sphere sphere(
-                WORLD_WIDTH * randomFloat(),
-                WORLD_WIDTH * randomFloat(),
-                WORLD_WIDTH * randomFloat(),
-                (MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS)) * randomFloat());
-        spheres.push_back(sphere);
-    }
+workload::Sphere randomSphere() {
+    return workload::Sphere(WORLD_WIDTH * randomVec3(), MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * 0.5f * (randomFloat() + 1.0f));
 }
 
-void generatePositions(uint32_t numProxies, std::vector<glm::vec3>& positions) {
-    positions.reserve(numProxies);
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        positions.push_back(WORLD_WIDTH * randomVec3());
+workload::Views makeViews(uint32_t numViews) {
+    workload::Views views;
+    for (uint32_t i = 0; i < numViews; ++i) {
+        glm::vec3 center = 0.5f * WORLD_WIDTH * randomVec3();
+        views.push_back(makeView(center, 0.1f * WORLD_WIDTH, 0.2f * WORLD_WIDTH, 0.4f * WORLD_WIDTH));
     }
+    return views;
 }
 
-void generateRadiuses(uint32_t numRadiuses, std::vector<float>& radiuses) {
-    radiuses.reserve(numRadiuses);
-    for (uint32_t i = 0; i < numRadiuses; ++i) {
-        radiuses.push_back(MIN_RADIUS + (MAX_RADIUS - MIN_RADIUS) * randomFloat());
+// categorizes proxy the way the space did when it tested one proxy at a time
+uint8_t categorizeOne(const workload::Sphere& proxy, const workload::Views& views) {
+    uint8_t region = workload::Region::R4;
+    for (auto& view : views) {
+        for (uint8_t k = 0; k < region; ++k) {
+            glm::vec3 offset = glm::vec3(proxy) - glm::vec3(view.regions[k]);
+            float touchDistance = proxy.w + view.regions[k].w;
+            if (glm::dot(offset, offset) < touchDistance * touchDistance) {
+                region = k;
+                break;
+            }
+        }
     }
+    return region;
 }
 
-void SpaceTests::benchmark() {
-    uint32_t numProxies[] = { 100, 1000, 10000, 100000 };
-    uint32_t numTests = 4;
-    std::vector<uint64_t> timeToAddAll;
-    std::vector<uint64_t> timeToMoveView;
-    std::vector<uint64_t> timeToMoveProxies;
-    std::vector<uint64_t> timeToRemoveAll;
-    for (uint32_t i = 0; i < numTests; ++i) {
-
-        workload::Space space;
-
-        { // build the views
-            std::vector<glm::vec3> viewPositions;
-            viewPositions.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
-            viewPositions.push_back(glm::vec3(0.0f, 0.0f, 0.1f * WORLD_WIDTH));
-            float radius0 = 0.25f * WORLD_WIDTH;
-            float radius1 = 0.50f * WORLD_WIDTH;
-            float radius2 = 0.75f * WORLD_WIDTH;
-            std::vector<workload::Space::View> views;
-            views.push_back(workload::Space::View(viewPositions[0], radius0, radius1, radius2));
-            views.push_back(workload::Space::View(viewPositions[1], radius0, radius1, radius2));
-            space.setViews(views);
-        }
+void SpaceTests::testCategorizeManyProxies() {
+    // enough proxies for many blocks, and a count that doesn't fill the last batch
+    const uint32_t NUM_PROXIES = 20011;
+    const uint32_t NUM_VIEWS = 3;
 
-        // build the proxies
-        uint32_t n = numProxies[i];
-        std::vector<workload::Space::Sphere> proxySpheres;
-        generateSpheres(n, proxySpheres);
-        std::vector<int32_t> proxyKeys;
-        proxyKeys.reserve(n);
-
-        // measure time to put proxies in the space
-        uint64_t startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < n; ++j) {
-            int32_t key = space.createProxy(proxySpheres[j]);
-            proxyKeys.push_back(key);
-        }
-        uint64_t usec = usecTimestampNow() - startTime;
-        timeToAddAll.push_back(usec);
-
-        {
-            // build the views
-            std::vector<glm::vec3> viewPositions;
-            viewPositions.push_back(glm::vec3(1.0f, 2.0f, 3.0f));
-            viewPositions.push_back(glm::vec3(1.0f, 2.0f, 3.0f + 0.1f * WORLD_WIDTH));
-            float radius0 = 0.25f * WORLD_WIDTH;
-            float radius1 = 0.50f * WORLD_WIDTH;
-            float radius2 = 0.75f * WORLD_WIDTH;
-            std::vector<workload::Space::View> views;
-            views.push_back(workload::Space::View(viewPositions[0], radius0, radius1, radius2));
-            views.push_back(workload::Space::View(viewPositions[1], radius0, radius1, radius2));
-            space.setViews(views);
-        }
-
-        // measure time to categorizeAndGetChanges everything
-        std::vector<workload::Space::Change> changes;
-        startTime = usecTimestampNow();
-        space.categorizeAndGetChanges(changes);
-        usec = usecTimestampNow() - startTime;
-        timeToMoveView.push_back(usec);
-
-        // move every 10th proxy around
-        const float proxySpeed = 1.0f;
-        std::vector<workload::Space::Sphere> newSpheres;
-        uint32_t numMovingProxies = n / 10;
-        uint32_t jstep = n / numMovingProxies;
-        uint32_t maxJ = numMovingProxies * jstep - 1;
-        glm::vec3 direction;
-        for (uint32_t j = 0; j < maxJ - jstep; j += jstep) {
-            glm::vec3 position = (glm::vec3)proxySpheres[j];
-            glm::vec3 destination = (glm::vec3)proxySpheres[j + jstep];
-            direction = glm::normalize(destination - position);
-            glm::vec3 newPosition = position + proxySpeed * direction;
-            newSpheres.push_back(workload::Space::Sphere(newPosition, proxySpheres[j].w));
-        }
-        glm::vec3 position = (glm::vec3)proxySpheres[maxJ = jstep];
-        glm::vec3 destination = (glm::vec3)proxySpheres[0];
-        direction = glm::normalize(destination - position);
-        direction = position + proxySpeed * direction;
-        newSpheres.push_back(workload::Space::Sphere(direction, proxySpheres[0].w));
-        uint32_t k = 0;
-        startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < maxJ; j += jstep) {
-            space.updateProxy(proxyKeys[j], newSpheres[k++]);
-        }
-        changes.clear();
-        space.categorizeAndGetChanges(changes);
-        usec = usecTimestampNow() - startTime;
-        timeToMoveProxies.push_back(usec);
+    workload::Space space;
+    workload::Views views = makeViews(NUM_VIEWS);
+    space.setViews(views);
 
-        // measure time to remove proxies from space
-        startTime = usecTimestampNow();
-        for (uint32_t j = 0; j < n; ++j) {
-            space.deleteProxy(proxyKeys[j]);
-        }
-        usec = usecTimestampNow() - startTime;
-        timeToRemoveAll.push_back(usec);
+    std::vector<workload::Sphere> spheres;
+    workload::Transaction transaction;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        spheres.push_back(randomSphere());
+        transaction.reset(space.allocateID(), spheres.back(), workload::Owner());
     }
-
-    std::cout << "[numProxies, timeToAddAll] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToAddAll.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToAddAll[i] << std::endl;
+    applyTransaction(space, transaction);
+
+    Changes changes;
+    space.categorizeAndGetChanges(changes);
+    QCOMPARE((uint32_t)changes.size(), NUM_PROXIES);
+    std::vector<uint8_t> regions;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        regions.push_back(categorizeOne(spheres[i], views));
+        QCOMPARE(changes[i].proxyId, (int32_t)i);
+        QCOMPARE(changes[i].region, regions[i]);
+        QCOMPARE(space.getRegion(i), regions[i]);
     }
-    std::cout << "];" << std::endl;
 
-    std::cout << "[numProxies, timeToMoveView] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToMoveView.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToMoveView[i] << std::endl;
+    // move the views: exactly the proxies whose region changed are reported, still in order
+    views = makeViews(NUM_VIEWS);
+    space.setViews(views);
+    changes.clear();
+    space.categorizeAndGetChanges(changes);
+    uint32_t numExpected = 0;
+    for (uint32_t i = 0; i < NUM_PROXIES; ++i) {
+        uint8_t region = categorizeOne(spheres[i], views);
+        QCOMPARE(space.getRegion(i), region);
+        if (region != regions[i]) {
+            QVERIFY(numExpected < changes.size());
+            QCOMPARE(changes[numExpected].proxyId, (int32_t)i);
+            QCOMPARE(changes[numExpected].region, region);
+            QCOMPARE(changes[numExpected].prevRegion, regions[i]);
+            ++numExpected;
+        }
     }
-    std::cout << "];" << std::endl;
+    QCOMPARE((uint32_t)changes.size(), numExpected);
+}
 
-    std::cout << "[numProxies, timeToMoveProxies] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToMoveProxies.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << "/10, " << timeToMoveProxies[i] << std::endl;
-    }
-    std::cout << "];" << std::endl;
+// Times categorizeAndGetChanges for 10k to 500k proxies seen by four views, after the views move
+void SpaceTests::benchmarkCategorize() {
+    const uint32_t NUM_VIEWS = 4;
+    const uint32_t NUM_FRAMES = 20;
+    uint32_t numProxies[] = { 10000, 50000, 100000, 250000, 500000 };
+
+    std::cout << "[numProxies, usecsPerCategorize, changesPerFrame] = [" << std::endl;
+    for (uint32_t n : numProxies) {
+        workload::Space space;
+        workload::Transaction transaction;
+        for (uint32_t i = 0; i < n; ++i) {
+            transaction.reset(space.allocateID(), randomSphere(), workload::Owner());
+        }
+        applyTransaction(space, transaction);
 
-    std::cout << "[numProxies, timeToRemoveAll] = [" << std::endl;
-    for (uint32_t i = 0; i < timeToRemoveAll.size(); ++i) {
-        uint32_t n = numProxies[i];
-        std::cout << "    " << n << ", " << timeToRemoveAll[i] << std::endl;
+        uint64_t totalTime = 0;
+        size_t numChanges = 0;
+        Changes changes;
+        for (uint32_t frame = 0; frame < NUM_FRAMES; ++frame) {
+            space.setViews(makeViews(NUM_VIEWS));
+            changes.clear();
+            uint64_t startTime = usecTimestampNow();
+            space.categorizeAndGetChanges(changes);
+            totalTime += usecTimestampNow() - startTime;
+            numChanges += changes.size();
+        }
+        std::cout << "    " << n << ", " << totalTime / NUM_FRAMES << ", " << numChanges / NUM_FRAMES << std::endl;
     }
     std::cout << "];" << std::endl;
 }
-
-#endif // MANUAL_TEST